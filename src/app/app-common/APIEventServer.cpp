@@ -5,6 +5,7 @@
 // This program is open source; see the LICENSE file in the root of the
 // OpenKneeboard repository.
 #include <OpenKneeboard/APIEventServer.hpp>
+#include <OpenKneeboard/InputRecording.hpp>
 #include <OpenKneeboard/Win32.hpp>
 
 #include <OpenKneeboard/config.hpp>
@@ -137,7 +138,9 @@ task<bool> APIEventServer::RunSingle(
     co_return false;
   }
 
-  self->DispatchEvent({buffer.data(), bytesRead});
+  const std::string_view packet {buffer.data(), bytesRead};
+  InputRecording::Record(InputRecording::Stream::APIEvent, packet);
+  self->DispatchEvent(packet);
   co_return true;
 }
 
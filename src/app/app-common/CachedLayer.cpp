@@ -6,18 +6,135 @@
 // OpenKneeboard repository.
 #include <OpenKneeboard/CachedLayer.hpp>
 #include <OpenKneeboard/D3D11.hpp>
+#include <OpenKneeboard/Metrics.hpp>
 #include <OpenKneeboard/SHM.hpp>
+#include <OpenKneeboard/TexturePoolPolicy.hpp>
 
 #include <OpenKneeboard/audited_ptr.hpp>
 #include <OpenKneeboard/scope_exit.hpp>
 
+#include <algorithm>
+#include <tuple>
+#include <unordered_map>
+
 #include <DirectXColors.h>
 
 namespace OpenKneeboard {
 
-CachedLayer::CachedLayer(const audited_ptr<DXResources>& dxr) : mDXR(dxr) {}
+namespace {
+
+// SHM::SHARED_TEXTURE_PIXEL_FORMAT
+constexpr std::size_t BytesPerPixel = 4;
+
+// Shared by all `CachedLayer`s; `TexturePoolPolicy` decides what to keep
+class TexturePool final {
+ public:
+  using EntryID = TexturePoolPolicy::EntryID;
+
+  struct Texture {
+    winrt::com_ptr<ID3D11Texture2D> mTexture;
+    winrt::com_ptr<ID3D11ShaderResourceView> mShaderResourceView;
+  };
+
+  static TexturePool& Get() {
+    // Leaked so that layers in other static objects can still release
+    // entries
+    static auto instance = new TexturePool();
+    return *instance;
+  }
+
+  /// Returns nullptr if the texture has been evicted
+  std::shared_ptr<Texture> Find(EntryID id) {
+    const std::unique_lock lock(mMutex);
+    if (!mPolicy.Touch(id)) {
+      return nullptr;
+    }
+    return mTextures.at(id);
+  }
+
+  /// The texture may be larger than `size`, and its content is undefined
+  std::tuple<EntryID, std::shared_ptr<Texture>> Allocate(
+    ID3D11Device* device,
+    const PixelSize& size) {
+    const auto sizeClass
+      = TexturePoolPolicy::GetSizeClass(size.mWidth, size.mHeight);
+
+    const std::unique_lock lock(mMutex);
+    const auto allocation = mPolicy.Allocate(
+      sizeClass,
+      static_cast<std::size_t>(sizeClass.mWidth) * sizeClass.mHeight
+        * BytesPerPixel);
+    this->Destroy(allocation.mEvicted);
+    if (allocation.mIsReused) {
+      return {allocation.mID, mTextures.at(allocation.mID)};
+    }
+
+    auto texture = std::make_shared<Texture>();
+    try {
+      D3D11_TEXTURE2D_DESC textureDesc {
+        .Width = sizeClass.mWidth,
+        .Height = sizeClass.mHeight,
+        .MipLevels = 1,
+        .ArraySize = 1,
+        .Format = SHM::SHARED_TEXTURE_PIXEL_FORMAT,
+        .SampleDesc = {1, 0},
+        .Usage = D3D11_USAGE_DEFAULT,
+        .BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET,
+      };
+      winrt::check_hresult(device->CreateTexture2D(
+        &textureDesc, nullptr, texture->mTexture.put()));
+      winrt::check_hresult(device->CreateShaderResourceView(
+        texture->mTexture.get(),
+        nullptr,
+        texture->mShaderResourceView.put()));
+    } catch (...) {
+      mPolicy.Remove(allocation.mID);
+      throw;
+    }
+    mTextures.emplace(allocation.mID, texture);
+    return {allocation.mID, texture};
+  }
+
+  void Release(EntryID id) {
+    const std::unique_lock lock(mMutex);
+    mPolicy.Release(id);
+  }
+
+  void SetBudget(std::size_t bytes) {
+    const std::unique_lock lock(mMutex);
+    this->Destroy(mPolicy.SetBudget(bytes));
+  }
+
+ private:
+  std::mutex mMutex;
+  TexturePoolPolicy mPolicy {CachedLayer::DefaultVRAMBudget};
+  std::unordered_map<EntryID, std::shared_ptr<Texture>> mTextures;
+
+  TexturePool() = default;
+
+  void Destroy(const std::vector<EntryID>& ids) {
+    if (ids.empty()) {
+      return;
+    }
+    // Layers that are using these keep them alive until they're done
+    for (const auto id: ids) {
+      mTextures.erase(id);
+    }
+    OPENKNEEBOARD_MetricsCount("CachedLayer evictions", ids.size());
+  }
+};
+
+}// namespace
+
+CachedLayer::CachedLayer(
+  const audited_ptr<DXResources>& dxr,
+  std::size_t maxEntries)
+  : mDXR(dxr),
+    mMaxEntries(std::max<std::size_t>(maxEntries, 1)) {
+  mCacheRenderTarget = RenderTarget::Create(dxr, nullptr);
+}
 
-CachedLayer::~CachedLayer() {}
+CachedLayer::~CachedLayer() { this->Reset(); }
 
 task<void> CachedLayer::Render(
   const PixelRect& destRect,
@@ -35,58 +152,83 @@ task<void> CachedLayer::Render(
     co_return;
   }
 
-  if (mCacheDimensions != cacheDimensions || !mCache) {
-    mKey = ~Key {0};
-    mCache = nullptr;
-    mCacheDimensions = cacheDimensions;
-    D3D11_TEXTURE2D_DESC textureDesc {
-      .Width = cacheDimensions.mWidth,
-      .Height = cacheDimensions.mHeight,
-      .MipLevels = 1,
-      .ArraySize = 1,
-      .Format = SHM::SHARED_TEXTURE_PIXEL_FORMAT,
-      .SampleDesc = {1, 0},
-      .Usage = D3D11_USAGE_DEFAULT,
-      .BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET,
-    };
-    winrt::check_hresult(
-      mDXR->mD3D11Device->CreateTexture2D(&textureDesc, nullptr, mCache.put()));
-    winrt::check_hresult(mDXR->mD3D11Device->CreateShaderResourceView(
-      mCache.get(), nullptr, mCacheSRV.put()));
-    mCacheRenderTarget = RenderTarget::Create(mDXR, mCache);
+  auto& pool = TexturePool::Get();
+  std::shared_ptr<TexturePool::Texture> texture;
+
+  const auto it = std::ranges::find_if(mEntries, [&](const Entry& entry) {
+    return entry.mKey == cacheKey && entry.mSize == cacheDimensions;
+  });
+  if (it != mEntries.end()) {
+    texture = pool.Find(it->mTextureID);
+    if (texture) {
+      std::rotate(mEntries.begin(), it, it + 1);
+    } else {
+      // Evicted to make space for another layer
+      mEntries.erase(it);
+    }
   }
 
-  if (mKey != cacheKey) {
+  if (texture) {
+    OPENKNEEBOARD_MetricsCount("CachedLayer hits", 1);
+  } else {
+    OPENKNEEBOARD_MetricsCount("CachedLayer misses", 1);
+    if (mEntries.size() >= mMaxEntries) {
+      pool.Release(mEntries.back().mTextureID);
+      mEntries.pop_back();
+    }
+
+    const auto [id, allocated]
+      = pool.Allocate(mDXR->mD3D11Device.get(), cacheDimensions);
+    texture = allocated;
+
+    mCacheRenderTarget->SetD3DTexture(texture->mTexture);
     {
       auto d3d = mCacheRenderTarget->d3d();
       mDXR->mD3D11ImmediateContext->ClearRenderTargetView(
         d3d.rtv(), DirectX::Colors::Transparent);
     }
-    co_await impl(mCacheRenderTarget.get(), cacheDimensions);
-    mKey = cacheKey;
+    try {
+      co_await impl(mCacheRenderTarget.get(), cacheDimensions);
+    } catch (...) {
+      pool.Release(id);
+      throw;
+    }
+    mEntries.insert(
+      mEntries.begin(),
+      Entry {
+        .mKey = cacheKey,
+        .mSize = cacheDimensions,
+        .mTextureID = id,
+      });
   }
 
   auto d3d = rt->d3d();
 
   const PixelRect sourceRect {
     {0, 0},
-    mCacheDimensions,
+    cacheDimensions,
   };
 
   auto sb = mDXR->mSpriteBatch.get();
 
   sb->Begin(d3d.rtv(), rt->GetDimensions());
-  sb->Draw(mCacheSRV.get(), sourceRect, destRect);
+  sb->Draw(texture->mShaderResourceView.get(), sourceRect, destRect);
   sb->End();
 }
 
 void CachedLayer::Reset() {
   std::scoped_lock lock(mCacheMutex);
 
-  mKey = ~Key {0};
-  mCache = nullptr;
-  mCacheRenderTarget = nullptr;
-  mCacheSRV = nullptr;
+  auto& pool = TexturePool::Get();
+  for (const auto& entry: mEntries) {
+    pool.Release(entry.mTextureID);
+  }
+  mEntries.clear();
+  mCacheRenderTarget->SetD3DTexture(nullptr);
+}
+
+void CachedLayer::SetVRAMBudget(std::size_t bytes) {
+  TexturePool::Get().SetBudget(bytes);
 }
 
 }// namespace OpenKneeboard
@@ -0,0 +1,294 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/DCSMissionDigestCache.hpp>
+#include <OpenKneeboard/Filesystem.hpp>
+#include <OpenKneeboard/Lua.hpp>
+
+#include <OpenKneeboard/dprint.hpp>
+#include <OpenKneeboard/tracing.hpp>
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <vector>
+
+namespace OpenKneeboard {
+
+namespace {
+
+// Indexed by `DCSEvents::Coalition`
+constexpr std::array CoalitionKeys {"neutral", "red", "blue"};
+constexpr std::array PictureKeys {
+  "pictureFileNameN",
+  "pictureFileNameR",
+  "pictureFileNameB",
+};
+constexpr std::array TaskKeys {
+  "descriptionNeutralTask",
+  "descriptionRedTask",
+  "descriptionBlueTask",
+};
+
+std::string ReadFile(const std::filesystem::path& path) {
+  if (!std::filesystem::is_regular_file(path)) {
+    return {};
+  }
+  std::ifstream f(path, std::ios::binary);
+  return {
+    std::istreambuf_iterator<char> {f}, std::istreambuf_iterator<char> {}};
+}
+
+/** Run `getter`, returning nullopt if the value is missing or invalid.
+ *
+ * Each field is extracted separately, so that one missing field doesn't
+ * hide the others.
+ */
+template <class F>
+auto TryExtract(std::string_view what, F&& getter)
+  -> std::optional<std::invoke_result_t<F>> {
+  try {
+    return std::invoke(std::forward<F>(getter));
+  } catch (const LuaIndexError& e) {
+    dprint("LuaIndexError when loading mission {}: {}", what, e.what());
+  } catch (const LuaTypeError& e) {
+    dprint("LuaTypeError when loading mission {}: {}", what, e.what());
+  } catch (const LuaError& e) {
+    dprint("LuaError when loading mission {}: {}", what, e.what());
+  }
+  return std::nullopt;
+}
+
+/** DCS supports localised text being stored in a dictionary.
+ *
+ * In this case the string in mission Lua will start with DictKey_ and should
+ * be used as a key to reference in the dictionary. If it doesn't start with
+ * DictKey_ it can be used directly. This has only been observed in older
+ * files - DCS mission editor by default seems to put everything in the
+ * dictionary now.
+ */
+std::string GetMissionText(
+  const LuaRef& mission,
+  const LuaRef& dictionary,
+  const char* key) {
+  auto missionValue = mission[key].Get<std::string>();
+  if (missionValue.starts_with("DictKey_")) {
+    return dictionary[mission[key]].Get<std::string>();
+  }
+  return missionValue;
+}
+
+std::string GetCountries(const LuaRef& countries) {
+  std::string ret;
+  for (auto&& [i, country]: countries) {
+    if (!(country.contains("static") && country.contains("helicopter")
+          && country.contains("vehicle") && country.contains("plane"))) {
+      continue;
+    }
+    if (!ret.empty()) {
+      ret += ", ";
+    }
+    ret += country["name"].Get<std::string>();
+  }
+  return ret;
+}
+
+DCSMissionDigest::Wind GetWind(const LuaRef& data) {
+  return {
+    .mSpeed = data["speed"].Get<float>(),
+    .mDirection = data["dir"].Get<int32_t>(),
+  };
+}
+
+std::vector<std::string> GetImages(
+  const LuaRef& mission,
+  const LuaRef& mapResource,
+  const char* key) {
+  std::vector<std::string> ret;
+  for (auto&& [i, resourceName]: mission.at(key)) {
+    // `resourceName` will almost always be a string starting with `ResKey_`,
+    // which will be an entry in the `mapResource` dictionary created in
+    // `l10n\DEFAULT\mapResource`; this isn't required, and some missions
+    // just containing a raw filename instead.
+    ret.push_back(
+      mapResource.contains(resourceName)
+        ? mapResource[resourceName].Get<std::string>()
+        : resourceName.Get<std::string>());
+  }
+  return ret;
+}
+
+DCSMissionDigest Extract(
+  const LuaRef& mission,
+  const LuaRef& dictionary,
+  const LuaRef& mapResource) {
+  DCSMissionDigest ret;
+  ret.mTitle = TryExtract("title", [&] {
+    return GetMissionText(mission, dictionary, "sortie");
+  });
+  ret.mSituation = TryExtract("situation", [&] {
+    return GetMissionText(mission, dictionary, "descriptionText");
+  });
+  ret.mStartDate = TryExtract("date", [&] {
+    const auto date = mission.at("date");
+    return DCSMissionDigest::Date {
+      .mYear = date["Year"].Get<int32_t>(),
+      .mMonth = date["Month"].Get<uint32_t>(),
+      .mDay = date["Day"].Get<uint32_t>(),
+    };
+  });
+  ret.mStartTime = TryExtract(
+    "start time", [&] { return mission["start_time"].Get<uint32_t>(); });
+  ret.mWeather = TryExtract("weather", [&] {
+    const auto weather = mission["weather"];
+    const auto wind = weather["wind"];
+    return DCSMissionDigest::Weather {
+      .mTemperature = weather["season"]["temperature"].Get<int32_t>(),
+      .mQNH = weather["qnh"].Get<float>(),
+      .mCloudBase = weather["clouds"]["base"].Get<int32_t>(),
+      .mWindAtGround = GetWind(wind["atGround"]),
+      .mWindAt2000 = GetWind(wind["at2000"]),
+      .mWindAt8000 = GetWind(wind["at8000"]),
+    };
+  });
+
+  for (std::size_t i = 0; i < ret.mCoalitions.size(); ++i) {
+    auto& coalition = ret.mCoalitions.at(i);
+    const auto key = CoalitionKeys.at(i);
+    coalition.mCountries = TryExtract("countries", [&] {
+      return GetCountries(mission["coalition"][key]["country"]);
+    });
+    coalition.mTask = TryExtract("objective", [&] {
+      return GetMissionText(mission, dictionary, TaskKeys.at(i));
+    });
+    coalition.mBullseye = TryExtract("bullseye", [&] {
+      const auto bullseye = mission["coalition"][key]["bullseye"];
+      return DCSMissionDigest::Point {
+        .mX = bullseye["x"].Get<double>(),
+        .mY = bullseye["y"].Get<double>(),
+      };
+    });
+    coalition.mImages
+      = TryExtract("images", [&] {
+          return GetImages(mission, mapResource, PictureKeys.at(i));
+        }).value_or(std::vector<std::string> {});
+  }
+  return ret;
+}
+
+}// namespace
+
+DCSMissionDigestCache::DCSMissionDigestCache()
+  : mDirectory(
+      Filesystem::GetLocalAppDataDirectory() / "DCSMissionDigests"),
+    mWriter(
+      DebouncedFileWriter::Options {},
+      [](const auto& path, const auto& result) {
+        if (!result.mSucceeded) {
+          dprint.Warning(
+            "Failed to save mission digest to '{}': {}",
+            path.string(),
+            result.mError);
+        }
+      }) {}
+
+DCSMissionDigestCache::~DCSMissionDigestCache() = default;
+
+void DCSMissionDigestCache::Flush() {
+  OPENKNEEBOARD_TraceLoggingScope("DCSMissionDigestCache::Flush()");
+  mWriter.Flush();
+}
+
+std::shared_ptr<const DCSMissionDigest> DCSMissionDigestCache::Load(
+  const std::filesystem::path& extractedPath) {
+  OPENKNEEBOARD_TraceLoggingScope("DCSMissionDigestCache::Load()");
+  const auto missionPath = extractedPath / "mission";
+  if (!std::filesystem::is_regular_file(missionPath)) {
+    return nullptr;
+  }
+  const auto localized = extractedPath / "l10n" / "DEFAULT";
+  const auto dictionaryPath = localized / "dictionary";
+  const auto mapResourcePath = localized / "mapResource";
+
+  const auto hash = DCSMissionDigest::HashContent({
+    ReadFile(missionPath),
+    ReadFile(dictionaryPath),
+    ReadFile(mapResourcePath),
+  });
+  const auto cachePath = mDirectory / std::format("{:016x}.bin", hash);
+
+  {
+    const std::unique_lock lock(mMutex);
+    if (std::filesystem::is_regular_file(cachePath)) {
+      auto digest = DCSMissionDigest::Deserialize(ReadFile(cachePath));
+      if (digest) {
+        dprint("Loaded cached mission digest {:016x}", hash);
+        // Keep recently-used digests when pruning
+        std::error_code ec;
+        std::filesystem::last_write_time(
+          cachePath, std::filesystem::file_time_type::clock::now(), ec);
+        return std::make_shared<const DCSMissionDigest>(std::move(*digest));
+      }
+      dprint.Warning(
+        "Discarding invalid mission digest '{}'", cachePath.string());
+    }
+  }
+
+  std::shared_ptr<const DCSMissionDigest> ret;
+  try {
+    LuaState lua;
+    lua.DoFile(missionPath);
+    if (std::filesystem::exists(dictionaryPath)) {
+      lua.DoFile(dictionaryPath);
+    }
+    if (std::filesystem::exists(mapResourcePath)) {
+      lua.DoFile(mapResourcePath);
+    }
+
+    ret = std::make_shared<const DCSMissionDigest>(Extract(
+      lua.GetGlobal("mission"),
+      lua.GetGlobal("dictionary"),
+      lua.GetGlobal("mapResource")));
+  } catch (const LuaError& e) {
+    dprint.Warning("Failed to load mission Lua: {}", e.what());
+    return nullptr;
+  }
+
+  const std::unique_lock lock(mMutex);
+  this->Store(cachePath, *ret);
+  return ret;
+}
+
+void DCSMissionDigestCache::Store(
+  const std::filesystem::path& path,
+  const DCSMissionDigest& digest) {
+  std::error_code ec;
+  std::filesystem::create_directories(mDirectory, ec);
+
+  struct Existing {
+    std::filesystem::path mPath;
+    std::filesystem::file_time_type mLastWrite;
+  };
+  std::vector<Existing> existing;
+  for (const auto& entry:
+       std::filesystem::directory_iterator {mDirectory, ec}) {
+    if (entry.path().extension() != ".bin" || entry.path() == path) {
+      continue;
+    }
+    existing.push_back({entry.path(), entry.last_write_time(ec)});
+  }
+  if (existing.size() >= MaxEntries) {
+    std::ranges::sort(existing, {}, &Existing::mLastWrite);
+    for (const auto& [stale, lastWrite]:
+         existing | std::views::take(existing.size() + 1 - MaxEntries)) {
+      mWriter.Remove(stale);
+    }
+  }
+
+  mWriter.Write(path, digest.Serialize());
+}
+
+}// namespace OpenKneeboard
@@ -14,6 +14,7 @@
 #include <OpenKneeboard/InterprocessRenderer.hpp>
 #include <OpenKneeboard/KneeboardState.hpp>
 #include <OpenKneeboard/KneeboardView.hpp>
+#include <OpenKneeboard/Metrics.hpp>
 #include <OpenKneeboard/Spriting.hpp>
 #include <OpenKneeboard/TabView.hpp>
 #include <OpenKneeboard/ToolbarAction.hpp>
@@ -141,6 +142,7 @@ void InterprocessRenderer::InitializeCanvas(const PixelSize& size) {
   mCanvas =
     RenderTargetWithMultipleIdentities::Create(mDXR, texture, MaxViewCount);
   mCanvasSize = size;
+  mCanvasLayers.clear();
 
   // Let's force a clean start on the clients, including resetting the session
   // ID
@@ -170,7 +172,7 @@ void InterprocessRenderer::PostUserAction(UserAction action) {
     mPreviousFrameWasVisible = true;
   }
 
-  mKneeboard->SetRepaintNeeded();
+  mKneeboard->SetRepaintNeeded(RepaintReason::Visibility);
 }
 
 InterprocessRenderer::IPCTextureResources*
@@ -282,14 +284,11 @@ InterprocessRenderer::~InterprocessRenderer() {
   }
 }
 
-task<SHM::LayerConfig> InterprocessRenderer::RenderLayer(
+SHM::LayerConfig InterprocessRenderer::GetLayerConfig(
   const ViewRenderInfo& layer,
   const PixelRect& bounds) noexcept {
-  OPENKNEEBOARD_TraceLoggingScope("InterprocessRenderer::RenderLayer");
-  const auto view = layer.mView.get();
-
   SHM::LayerConfig ret {};
-  ret.mLayerID = view->GetRuntimeID().GetTemporaryValue();
+  ret.mLayerID = layer.mView->GetRuntimeID().GetTemporaryValue();
 
   if (layer.mVR) {
     ret.mVREnabled = true;
@@ -297,16 +296,24 @@ task<SHM::LayerConfig> InterprocessRenderer::RenderLayer(
     ret.mVR.mLocationOnTexture.mOffset.mX += bounds.mOffset.mX;
     ret.mVR.mLocationOnTexture.mOffset.mY += bounds.mOffset.mY;
   }
+  return ret;
+}
+
+task<SHM::LayerConfig> InterprocessRenderer::RenderLayer(
+  const ViewRenderInfo& layer,
+  const PixelRect& bounds) noexcept {
+  OPENKNEEBOARD_TraceLoggingScope("InterprocessRenderer::RenderLayer");
 
-  co_await view->RenderWithChrome(
+  co_await layer.mView->RenderWithChrome(
     mCanvas.get(),
     PixelRect {bounds.mOffset, layer.mFullSize},
     layer.mIsActiveForInput);
 
-  co_return ret;
+  co_return this->GetLayerConfig(layer, bounds);
 }
 
-task<void> InterprocessRenderer::RenderNow() noexcept {
+task<void> InterprocessRenderer::RenderNow(
+  const RepaintRequestBus::Frame& requests) noexcept {
   if (mRendering.test_and_set()) {
     dprint("Two renders in the same instance");
     OPENKNEEBOARD_BREAK;
@@ -317,6 +324,7 @@ task<void> InterprocessRenderer::RenderNow() noexcept {
 
   OPENKNEEBOARD_TraceLoggingScopedActivity(
     activity, "InterprocessRenderer::RenderNow()");
+  OPENKNEEBOARD_MetricsScopedTimer("InterprocessRenderer::RenderNow");
 
   const auto renderInfos = mKneeboard->GetViewRenderInfo();
   const auto layerCount = renderInfos.size();
@@ -335,6 +343,7 @@ task<void> InterprocessRenderer::RenderNow() noexcept {
       mSHM.SubmitEmptyFrame();
     }
     mPreviousFrameWasVisible = false;
+    mCanvasLayers.clear();
     co_return;
   }
   mPreviousFrameWasVisible = true;
@@ -345,24 +354,62 @@ task<void> InterprocessRenderer::RenderNow() noexcept {
   const std::unique_lock dxlock(*mDXR);
   TraceLoggingWriteTagged(activity, "AcquireDXLock/stop");
   this->InitializeCanvas(canvasSize);
-  mDXR->mD3D11ImmediateContext->ClearRenderTargetView(
-    mCanvas->d3d().rtv(), DirectX::Colors::Transparent);
+
+  std::vector<CanvasLayer> canvasLayers;
+  canvasLayers.reserve(layerCount);
+  for (auto&& it: renderInfos) {
+    canvasLayers.push_back({
+      .mView = it.mView->GetRuntimeID().GetTemporaryValue(),
+      .mFullSize = it.mFullSize,
+      .mIsActiveForInput = it.mIsActiveForInput,
+    });
+  }
+
+  // If the layout changed, the canvas doesn't have anything we can reuse;
+  // otherwise, views that weren't asked to repaint are already correct
+  const bool repaintAll = requests.mAllViews || canvasLayers != mCanvasLayers;
+  const auto ctx = mDXR->mD3D11ImmediateContext.get();
+  const auto rtv = mCanvas->d3d().rtv();
+  if (repaintAll) {
+    ctx->ClearRenderTargetView(rtv, DirectX::Colors::Transparent);
+  }
 
   std::vector<SHM::LayerConfig> shmLayers;
   shmLayers.reserve(layerCount);
   uint64_t inputLayerID = 0;
+  std::size_t repaintedCount = 0;
 
   for (uint8_t i = 0; i < layerCount; ++i) {
     const auto bounds = Spriting::GetRect(i, layerCount);
     const auto& renderInfo = renderInfos.at(i);
+    const auto viewID = canvasLayers.at(i).mView;
     if (renderInfo.mIsActiveForInput) {
-      inputLayerID = renderInfo.mView->GetRuntimeID().GetTemporaryValue();
+      inputLayerID = viewID;
+    }
+
+    if (!(repaintAll || requests.Includes(viewID))) {
+      shmLayers.push_back(this->GetLayerConfig(renderInfo, bounds));
+      continue;
+    }
+
+    if (!repaintAll) {
+      const D3D11_RECT rect = bounds;
+      ctx->ClearView(rtv, DirectX::Colors::Transparent, &rect, 1);
     }
 
     mCanvas->SetActiveIdentity(i);
 
     shmLayers.push_back(co_await this->RenderLayer(renderInfo, bounds));
+    ++repaintedCount;
   }
+  mCanvasLayers = std::move(canvasLayers);
+
+  TraceLoggingWriteTagged(
+    activity,
+    "RenderedLayers",
+    TraceLoggingValue(repaintAll, "RepaintAll"),
+    TraceLoggingValue(repaintedCount, "RepaintedCount"),
+    TraceLoggingValue(layerCount, "LayerCount"));
 
   this->SubmitFrame(shmLayers, inputLayerID);
 }
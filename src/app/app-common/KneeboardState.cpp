@@ -6,19 +6,24 @@
 // OpenKneeboard repository.
 #include <OpenKneeboard/APIEventServer.hpp>
 #include <OpenKneeboard/CursorEvent.hpp>
+#include <OpenKneeboard/DCSMissionDigestCache.hpp>
 #include <OpenKneeboard/DXResources.hpp>
 #include <OpenKneeboard/DirectInputAdapter.hpp>
+#include <OpenKneeboard/FolderPageSourceRegistry.hpp>
 #include <OpenKneeboard/ITab.hpp>
+#include <OpenKneeboard/InputRecording.hpp>
 #include <OpenKneeboard/InterprocessRenderer.hpp>
 #include <OpenKneeboard/KneeboardState.hpp>
 #include <OpenKneeboard/KneeboardView.hpp>
 #include <OpenKneeboard/OpenXRMode.hpp>
 #include <OpenKneeboard/PluginStore.hpp>
 #include <OpenKneeboard/SHM/ActiveConsumers.hpp>
+#include <OpenKneeboard/SettingsFiles.hpp>
 #include <OpenKneeboard/SteamVRKneeboard.hpp>
 #include <OpenKneeboard/TabView.hpp>
 #include <OpenKneeboard/TabletInputAdapter.hpp>
 #include <OpenKneeboard/TabsList.hpp>
+#include <OpenKneeboard/ThumbnailCache.hpp>
 #include <OpenKneeboard/TroubleshootingStore.hpp>
 #include <OpenKneeboard/UserAction.hpp>
 #include <OpenKneeboard/Win32.hpp>
@@ -27,9 +32,11 @@
 #include <OpenKneeboard/dprint.hpp>
 #include <OpenKneeboard/final_release_deleter.hpp>
 #include <OpenKneeboard/scope_exit.hpp>
+#include <OpenKneeboard/task/resume_after.hpp>
 
 #include <algorithm>
 #include <string>
+#include <utility>
 
 namespace OpenKneeboard {
 
@@ -53,7 +60,8 @@ std::shared_ptr<PluginStore> KneeboardState::GetPluginStore() const {
 
 KneeboardState::KneeboardState(HWND hwnd, const audited_ptr<DXResources>& dxr)
   : mHwnd(hwnd),
-    mDXResources(dxr) {
+    mDXResources(dxr),
+    mSettingsFiles(std::make_unique<SettingsFiles>()) {
   mQueueFlushedEvent = Win32::or_throw::CreateEventW(
     nullptr,
     /* bManualReset = */ TRUE,
@@ -74,15 +82,26 @@ task<void> KneeboardState::Init() {
     std::bind_front(&KneeboardState::AfterFrame, this));
 
   mPluginStore = std::make_shared<PluginStore>();
-  mTabsList = co_await TabsList::Create(mDXResources, this, mSettings.mTabs);
+  mFolderPageSources = FolderPageSourceRegistry::Create(mDXResources, this);
+  mDCSMissionDigestCache = std::make_unique<DCSMissionDigestCache>();
+  mThumbnailCache = std::make_unique<ThumbnailCache>();
+  mThumbnailCacheLoad = mThumbnailCache->Load();
+  mTabsList = TabsList::Create(mDXResources, this);
   AddEventListener(
     mTabsList->evSettingsChangedEvent,
     std::bind_front(&KneeboardState::SaveSettings, this));
   AddEventListener(mTabsList->evTabsChangedEvent, [this]() {
     const auto tabs = mTabsList->GetTabs();
 
-    for (auto& view: mViews) {
+    const auto& configs = mSettings.mViews.mViews;
+    for (std::size_t i = 0; i < mViews.size(); ++i) {
+      auto& view = mViews.at(i);
       view->SetTabs(tabs);
+      // Tabs are published as they finish loading, so the default tab may
+      // not have existed when the view was initialized
+      if (i < configs.size() && !view->HasSelectedTab()) {
+        this->SelectDefaultTab(*view, configs.at(i), tabs);
+      }
     }
     if (mAppWindowView) {
       mAppWindowView->SetTabs(tabs);
@@ -103,15 +122,23 @@ task<void> KneeboardState::Init() {
 
   AddEventListener(
     this->evSettingsChangedEvent,
-    std::bind_front(&KneeboardState::SetRepaintNeeded, this));
+    std::bind_front(
+      &KneeboardState::SetRepaintNeeded, this, RepaintReason::Settings));
 
   InitializeViews();
   AcquireExclusiveResources();
+
+  // After the views exist, so that tabs are shown as they finish loading
+  co_await mTabsList->LoadSettings(mSettings.mTabs);
 }
 
 KneeboardState::~KneeboardState() noexcept {
   OPENKNEEBOARD_TraceLoggingScope("KneeboardState::~KneeboardState()");
   dprint("~KneeboardState()");
+  mSettingsFiles->Flush();
+  if (mDCSMissionDigestCache) {
+    mDCSMissionDigestCache->Flush();
+  }
 }
 
 std::vector<std::shared_ptr<KneeboardView>>
@@ -213,7 +240,7 @@ void KneeboardState::SetActiveInGameView(KneeboardViewID runtimeID) {
       mViews.at(i)->GetPersistentGUID(),
       i);
     mInputViewIndex = felly::numeric_cast<uint8_t>(i);
-    this->SetRepaintNeeded();
+    this->SetRepaintNeeded(RepaintReason::ActiveView);
     evActiveViewChangedEvent.Emit();
     return;
   }
@@ -253,6 +280,8 @@ task<void> KneeboardState::DisposeAsync() noexcept {
   for (auto& child: children) {
     co_await std::move(child);
   }
+  // After the tabs, as they lease sources from it
+  co_await mFolderPageSources->DisposeAsync();
 
   // We don't particularly care about things that are still in the queue, but if
   // something has been started, we need to wait for it to finish
@@ -260,6 +289,14 @@ task<void> KneeboardState::DisposeAsync() noexcept {
     co_await winrt::resume_on_signal(mQueueFlushedEvent.get());
   }
 
+  mInputReplayStop.request_stop();
+  if (mInputReplay) {
+    co_await std::move(mInputReplay).value();
+  }
+  if (mThumbnailCacheLoad) {
+    co_await std::move(mThumbnailCacheLoad).value();
+  }
+
   RemoveAllEventListeners();
   co_await ReleaseExclusiveResources();
 }
@@ -286,13 +323,13 @@ task<void> KneeboardState::PostUserAction(UserAction action) {
       auto& forceZoom = this->mSettings.mVR.mForceZoom;
       forceZoom = !forceZoom;
       this->SaveSettings();
-      this->SetRepaintNeeded();
+      this->SetRepaintNeeded(RepaintReason::UserAction);
       co_return;
     }
     case UserAction::RECENTER_VR:
       dprint("Recentering");
       this->mSettings.mVR.mRecenterCount++;
-      this->SetRepaintNeeded();
+      this->SetRepaintNeeded(RepaintReason::UserAction);
       co_return;
     case UserAction::SWAP_FIRST_TWO_VIEWS:
       if (mViews.size() >= 2) {
@@ -337,7 +374,7 @@ task<void> KneeboardState::PostUserAction(UserAction action) {
       }
       this->mInputViewIndex = (this->mInputViewIndex + 1) % this->mViews.size();
       this->evActiveViewChangedEvent.Emit();
-      this->SetRepaintNeeded();
+      this->SetRepaintNeeded(RepaintReason::ActiveView);
       co_return;
     case UserAction::INCREASE_BRIGHTNESS: {
       auto& tint = this->mSettings.mUI.mTint;
@@ -356,7 +393,7 @@ task<void> KneeboardState::PostUserAction(UserAction action) {
       co_return;
     }
     case UserAction::REPAINT_NOW:
-      this->SetRepaintNeeded();
+      this->SetRepaintNeeded(RepaintReason::UserAction);
       co_return;
   }
   // Use `return` instead of `break` above
@@ -434,6 +471,88 @@ task<void> KneeboardState::FlushOrderedEventQueue(
     TraceLoggingValue(mOrderedEventQueue.size(), "Remaining"));
 }
 
+task<void> KneeboardState::PrerenderPages(
+  std::chrono::time_point<std::chrono::steady_clock> stopAt) {
+  auto views = mViews;
+  if (mAppWindowView) {
+    views.push_back(mAppWindowView);
+  }
+  for (const auto& view: views) {
+    if (std::chrono::steady_clock::now() >= stopAt) {
+      co_return;
+    }
+    co_await view->PrerenderPages(stopAt);
+  }
+}
+
+void KneeboardState::StartInputReplay(
+  std::filesystem::path path,
+  double speed) {
+  if (mInputReplay) {
+    dprint.Warning("Ignoring input replay request: already replaying");
+    return;
+  }
+  mInputReplay = this->ReplayInput(std::move(path), speed);
+}
+
+task<void> KneeboardState::ReplayInput(
+  std::filesystem::path path,
+  double speed) {
+  auto messages = InputRecording::Read(path);
+  if (!messages) {
+    dprint.Warning("Failed to read input recording `{}`", path.string());
+    co_return;
+  }
+  InputRecording::Player player {std::move(*messages), speed};
+  dprint(
+    "Replaying {} input messages from `{}` at {}x speed",
+    player.GetMessageCount(),
+    path.string(),
+    speed);
+
+  const auto stop = mInputReplayStop.get_token();
+  const auto start = std::chrono::steady_clock::now();
+  std::size_t sinceYield = 0;
+  while (!player.IsFinished()) {
+    const auto wait = (start + player.GetNextDueOffset())
+      - std::chrono::steady_clock::now();
+    if (wait > decltype(wait)::zero()) {
+      if (!co_await resume_after(wait, stop)) {
+        co_return;
+      }
+      co_await mUIThread;
+      sinceYield = 0;
+    } else if (++sinceYield >= 64) {
+      // Running behind, or as fast as possible; let the UI breathe
+      co_await winrt::resume_background();
+      co_await mUIThread;
+      sinceYield = 0;
+    }
+    if (stop.stop_requested()) {
+      co_return;
+    }
+
+    auto message = player.Pop();
+    switch (message.mStream) {
+      case InputRecording::Stream::APIEvent:
+        if (mAPIEventServer) {
+          mAPIEventServer->DispatchEvent(message.mPayload);
+        }
+        break;
+      case InputRecording::Stream::OTDIPC:
+        if (mTabletInput) {
+          mTabletInput->InjectOTDIPCMessage(std::move(message.mPayload));
+        }
+        break;
+    }
+  }
+
+  dprint(
+    "Finished replaying input in {}",
+    std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start));
+}
+
 task<void> KneeboardState::ProcessAPIEvent(APIEvent ev) noexcept {
   const auto tabs = mTabsList->GetTabs();
 
@@ -626,7 +745,7 @@ task<void> KneeboardState::SetViewsSettings(const ViewsSettings& view) {
   this->InitializeViews();
 
   this->SaveSettings();
-  this->SetRepaintNeeded();
+  this->SetRepaintNeeded(RepaintReason::ViewLayout);
   co_return;
 }
 
@@ -636,7 +755,7 @@ task<void> KneeboardState::SetUISettings(const UISettings& value) {
   mSettings.mUI = value;
   this->SaveSettings();
 
-  this->SetRepaintNeeded();
+  this->SetRepaintNeeded(RepaintReason::Settings);
 
   co_return;
 }
@@ -661,7 +780,7 @@ task<void> KneeboardState::SetVRSettings(const VRSettings& value) {
 
   mSettings.mVR = value;
   this->SaveSettings();
-  this->SetRepaintNeeded();
+  this->SetRepaintNeeded(RepaintReason::Settings);
 
   co_return;
 }
@@ -678,6 +797,22 @@ task<void> KneeboardState::SetAppSettings(const AppSettings& value) {
 
 TabsList* KneeboardState::GetTabsList() const { return mTabsList.get(); }
 
+FolderPageSourceRegistry* KneeboardState::GetFolderPageSourceRegistry() const {
+  return mFolderPageSources.get();
+}
+
+DCSMissionDigestCache* KneeboardState::GetDCSMissionDigestCache() const {
+  return mDCSMissionDigestCache.get();
+}
+
+ThumbnailCache* KneeboardState::GetThumbnailCache() const {
+  return mThumbnailCache.get();
+}
+
+SettingsFiles* KneeboardState::GetSettingsFiles() const {
+  return mSettingsFiles.get();
+}
+
 InterprocessRenderer* KneeboardState::GetInterprocessRenderer() const {
   return mInterprocessRenderer.get();
 }
@@ -730,8 +865,8 @@ task<void> KneeboardState::SetProfileSettings(
     co_return;
   }
 
-  const auto newSettings =
-    Settings::Load(mProfiles.mDefaultProfile, mProfiles.mActiveProfile);
+  const auto newSettings = Settings::Load(
+    *mSettingsFiles, mProfiles.mDefaultProfile, mProfiles.mActiveProfile);
   mSettings = newSettings;
 
   // Avoid partially overwriting the new profile with
@@ -747,7 +882,7 @@ task<void> KneeboardState::SetProfileSettings(
   co_await this->SetVRSettings(newSettings.mVR);
 
   this->evSettingsChangedEvent.Emit();
-  this->SetRepaintNeeded();
+  this->SetRepaintNeeded(RepaintReason::Settings);
 }
 
 void KneeboardState::SaveSettings() {
@@ -765,7 +900,8 @@ void KneeboardState::SaveSettings() {
     mSettings.mDirectInput = mDirectInput->GetSettings();
   }
 
-  mSettings.Save(mProfiles.mDefaultProfile, mProfiles.mActiveProfile);
+  mSettings.Save(
+    *mSettingsFiles, mProfiles.mDefaultProfile, mProfiles.mActiveProfile);
   evSettingsChangedEvent.Emit();
 }
 
@@ -913,14 +1049,41 @@ task<void> KneeboardState::SwitchProfile(Direction direction) {
   co_await this->SetProfileSettings(settings);
 }
 
-bool KneeboardState::IsRepaintNeeded() const { return mNeedsRepaint; }
+bool KneeboardState::IsRepaintNeeded() const {
+  return mRepaintRequests.HasPending();
+}
+
+void KneeboardState::RequestRepaint(const RepaintRequest& request) {
+  OPENKNEEBOARD_TraceLoggingWrite(
+    "KneeboardState::RequestRepaint()",
+    TraceLoggingValue(request.mView, "View"),
+    TraceLoggingValue(std::to_underlying(request.mPriority), "Priority"),
+    TraceLoggingValue(
+      GetRepaintReasonName(request.mReason).data(), "Reason"));
+  if (const auto raised = mRepaintRequests.Post(request)) {
+    evNeedsRepaintEvent.Emit(*raised);
+  }
+}
 
-void KneeboardState::SetRepaintNeeded() {
-  OPENKNEEBOARD_TraceLoggingWrite("KneeboardState::SetRepaintNeeded()");
-  mNeedsRepaint = true;
+void KneeboardState::SetRepaintNeeded(const RepaintReason reason) {
+  this->RequestRepaint({.mReason = reason});
 }
 
-void KneeboardState::Repainted() { mNeedsRepaint = false; }
+void KneeboardState::OnViewNeedsRepaint(
+  const KneeboardViewID view,
+  const RepaintReason reason) {
+  this->RequestRepaint({
+    .mView = view.GetTemporaryValue(),
+    .mPriority = (reason == RepaintReason::Cursor)
+      ? RepaintPriority::Interactive
+      : RepaintPriority::Normal,
+    .mReason = reason,
+  });
+}
+
+void KneeboardState::TakeRepaintRequests(RepaintRequestBus::Frame& frame) {
+  mRepaintRequests.TakeFrame(frame);
+}
 
 void KneeboardState::lock() {
   if (mUniqueLockThread != std::this_thread::get_id()) {
@@ -981,29 +1144,26 @@ void KneeboardState::InitializeViews() {
 
     view->SetTabs(tabs);
 
-    if (config.mDefaultTabID != winrt::guid {}) {
-      auto tabIt =
-        std::ranges::find(tabs, config.mDefaultTabID, &ITab::GetPersistentID);
-      if (tabIt != tabs.end()) {
-        dprint(
-          "Setting view '{}' ({}) to default tab '{}' ({})",
-          config.mName,
-          config.mGuid,
-          (*tabIt)->GetTitle(),
-          config.mDefaultTabID);
-        view->SetCurrentTabByRuntimeID((*tabIt)->GetRuntimeID());
-      } else {
-        dprint(
-          "Couldn't find default tab {} for view '{}' ({})",
-          config.mDefaultTabID,
-          config.mName,
-          config.mGuid);
-      }
+    if (!this->SelectDefaultTab(*view, config, tabs)) {
+      // We'll try again as tabs finish loading
+      dprint(
+        "Default tab {} for view '{}' ({}) isn't loaded yet",
+        config.mDefaultTabID,
+        config.mName,
+        config.mGuid);
     }
 
     AddEventListener(
       view->evNeedsRepaintEvent,
-      std::bind_front(&KneeboardState::SetRepaintNeeded, this));
+      std::bind_front(
+        &KneeboardState::OnViewNeedsRepaint, this, view->GetRuntimeID()));
+    AddEventListener(
+      view->evCursorEvent,
+      std::bind_front(
+        &KneeboardState::OnViewNeedsRepaint,
+        this,
+        view->GetRuntimeID(),
+        RepaintReason::Cursor));
   }
 
   bool viewChanged = false;
@@ -1028,7 +1188,17 @@ void KneeboardState::InitializeViews() {
         mAppWindowView->SetTabs(this->GetTabsList()->GetTabs());
         AddEventListener(
           mAppWindowView->evNeedsRepaintEvent,
-          std::bind_front(&KneeboardState::SetRepaintNeeded, this));
+          std::bind_front(
+            &KneeboardState::OnViewNeedsRepaint,
+            this,
+            mAppWindowView->GetRuntimeID()));
+        AddEventListener(
+          mAppWindowView->evCursorEvent,
+          std::bind_front(
+            &KneeboardState::OnViewNeedsRepaint,
+            this,
+            mAppWindowView->GetRuntimeID(),
+            RepaintReason::Cursor));
         viewChanged = true;
       }
   }
@@ -1036,7 +1206,29 @@ void KneeboardState::InitializeViews() {
   if (viewChanged) {
     evActiveViewChangedEvent.Emit();
   }
-  this->SetRepaintNeeded();
+  this->SetRepaintNeeded(RepaintReason::ViewLayout);
+}
+
+bool KneeboardState::SelectDefaultTab(
+  KneeboardView& view,
+  const ViewSettings& config,
+  const std::vector<std::shared_ptr<ITab>>& tabs) {
+  if (config.mDefaultTabID == winrt::guid {}) {
+    return true;
+  }
+  const auto it
+    = std::ranges::find(tabs, config.mDefaultTabID, &ITab::GetPersistentID);
+  if (it == tabs.end()) {
+    return false;
+  }
+  dprint(
+    "Setting view '{}' ({}) to default tab '{}' ({})",
+    config.mName,
+    config.mGuid,
+    (*it)->GetTitle(),
+    config.mDefaultTabID);
+  view.SetCurrentTabByRuntimeID((*it)->GetRuntimeID());
+  return true;
 }
 
 void KneeboardState::BeforeFrame() {
@@ -1047,7 +1239,11 @@ void KneeboardState::BeforeFrame() {
     return;
   }
   mLastNonVRPixelSize = px;
-  this->SetRepaintNeeded();
+  // We're about to render anyway, so there's no need to wake anything up
+  this->RequestRepaint({
+    .mPriority = RepaintPriority::Background,
+    .mReason = RepaintReason::ConsumerResize,
+  });
 }
 
 void KneeboardState::AfterFrame(FramePostEventKind) {
@@ -1074,7 +1270,7 @@ void KneeboardState::AfterFrame(FramePostEventKind) {
   task<void> KneeboardState::Reset##name##Settings() { \
     auto newSettings = mSettings; \
     newSettings.Reset##name##Section( \
-      mProfiles.mDefaultProfile, mProfiles.mActiveProfile); \
+      *mSettingsFiles, mProfiles.mDefaultProfile, mProfiles.mActiveProfile); \
     co_await this->Set##name##Settings(newSettings.m##name); \
   }
 OPENKNEEBOARD_SETTINGS_SECTIONS
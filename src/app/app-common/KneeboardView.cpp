@@ -52,10 +52,14 @@ KneeboardView::KneeboardView(
   this->UpdateUILayers();
 
   for (auto layer: mUILayers) {
-    AddEventListener(layer->evNeedsRepaintEvent, this->evNeedsRepaintEvent);
+    AddEventListener(layer->evNeedsRepaintEvent, [this] {
+      evNeedsRepaintEvent.Emit(RepaintReason::UILayer);
+    });
   }
-  AddEventListener(this->evCurrentTabChangedEvent, this->evNeedsRepaintEvent);
-  AddEventListener(this->evCursorEvent, this->evNeedsRepaintEvent);
+  AddEventListener(this->evCurrentTabChangedEvent, [this] {
+    evNeedsRepaintEvent.Emit(RepaintReason::TabContent);
+  });
+  // Cursor repaints are requested by `KneeboardState`, with a higher priority
   AddEventListener(
     kneeboard->evSettingsChangedEvent,
     std::bind_front(&KneeboardView::UpdateUILayers, this));
@@ -151,6 +155,7 @@ void KneeboardView::SetCurrentTabByIndex(
   if (index >= mTabViews.size()) {
     return;
   }
+  mHasSelectedTab = true;
   if (mCurrentTabView == mTabViews.at(index)) {
     return;
   }
@@ -189,6 +194,10 @@ void KneeboardView::SetCurrentTabByRuntimeID(
   }
 }
 
+bool KneeboardView::HasSelectedTab() const noexcept {
+  return mHasSelectedTab;
+}
+
 void KneeboardView::PreviousTab() {
   const auto count = mTabViews.size();
   if (count < 2) {
@@ -412,6 +421,23 @@ task<void> KneeboardView::RenderWithChrome(
   }
 }
 
+task<void> KneeboardView::PrerenderPages(
+  std::chrono::steady_clock::time_point stopAt) {
+  // Copy, as tabs may change while we're rendering
+  auto tabViews = mTabViews;
+  // Current tab first, so that other tabs can't use up all the time
+  if (const auto it = std::ranges::find(tabViews, mCurrentTabView);
+      it != tabViews.end()) {
+    std::rotate(tabViews.begin(), it, it + 1);
+  }
+  for (const auto& tabView: tabViews) {
+    if (std::chrono::steady_clock::now() >= stopAt) {
+      co_return;
+    }
+    co_await tabView->PrerenderPages(stopAt);
+  }
+}
+
 task<void> KneeboardView::PostUserAction(UserAction action) {
   switch (action) {
     case UserAction::PREVIOUS_TAB: {
@@ -768,6 +794,7 @@ void KneeboardView::SwapState(KneeboardView& other) {
   mTabViews = {};
   mCurrentTabView = {};
   this->SetTabViews(std::move(otherViews), otherCurrent);
+  std::swap(mHasSelectedTab, other.mHasSelectedTab);
 }
 
 void KneeboardView::SetTabViews(
@@ -791,7 +818,7 @@ void KneeboardView::SetTabViews(
       if (self->GetCurrentTabView() != tabView) {
         return;
       }
-      self->evNeedsRepaintEvent.Emit();
+      self->evNeedsRepaintEvent.Emit(RepaintReason::TabContent);
     } | bind_refs_front(this, tabView);
 
     mTabEvents.insert(
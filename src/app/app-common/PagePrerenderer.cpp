@@ -0,0 +1,178 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/D3D11.hpp>
+#include <OpenKneeboard/IPageSource.hpp>
+#include <OpenKneeboard/Metrics.hpp>
+#include <OpenKneeboard/PagePrerenderer.hpp>
+#include <OpenKneeboard/PageSourceWithDelegates.hpp>
+#include <OpenKneeboard/SHM.hpp>
+
+#include <OpenKneeboard/tracing.hpp>
+
+#include <ranges>
+
+#include <DirectXColors.h>
+
+namespace OpenKneeboard {
+
+namespace {
+// SHM::SHARED_TEXTURE_PIXEL_FORMAT
+constexpr std::size_t BytesPerPixel = 4;
+
+std::vector<PagePrerenderPolicy::PageKey> GetPageKeys(
+  std::span<const PageID> pages) {
+  return pages | std::views::transform([](const PageID& it) {
+           return it.GetTemporaryValue();
+         })
+    | std::ranges::to<std::vector>();
+}
+
+/** Whether the page can be rendered off-screen, without a view.
+ *
+ * Sources with internal caching - e.g. web pages and window captures - are
+ * live, and may render differently for each view.
+ */
+bool CanPrerender(IPageSource* source, PageID pageID) {
+  if (const auto delegates = dynamic_cast<PageSourceWithDelegates*>(source)) {
+    return !delegates->HasInternalCaching(pageID);
+  }
+  return !dynamic_cast<IPageSourceWithInternalCaching*>(source);
+}
+
+std::vector<PagePrerenderPolicy::PageKey> GetPrerenderablePageKeys(
+  IPageSource* source) {
+  const auto canPrerender
+    = [source](const PageID& it) { return CanPrerender(source, it); };
+  const auto pages = source->GetPageIDs() | std::views::filter(canPrerender)
+    | std::ranges::to<std::vector>();
+  return GetPageKeys(pages);
+}
+}// namespace
+
+PagePrerenderer::PagePrerenderer(const audited_ptr<DXResources>& dxr)
+  : mDXR(dxr) {
+  mRenderTarget = RenderTarget::Create(dxr, nullptr);
+}
+
+PagePrerenderer::~PagePrerenderer() = default;
+
+task<void> PagePrerenderer::Render(
+  RenderContext rc,
+  IPageSource* source,
+  PageID pageID,
+  PageIndex pageIndex,
+  PixelRect rect) {
+  if (rect.mSize != mSize) {
+    // Copies are only useful at the size they're shown at
+    this->Release();
+    mSize = rect.mSize;
+    mPolicy.SetSlotBytes(
+      static_cast<std::size_t>(mSize.mWidth) * mSize.mHeight * BytesPerPixel);
+  }
+
+  const auto lookup = mPolicy.ObserveForegroundRender(
+    pageID.GetTemporaryValue(),
+    pageIndex,
+    PagePrerenderPolicy::Clock::now());
+  if (lookup.mIsPageChange) {
+    if (lookup.mSlot) {
+      OPENKNEEBOARD_MetricsCount("PagePrerenderer hits", 1);
+    } else {
+      OPENKNEEBOARD_MetricsCount("PagePrerenderer misses", 1);
+    }
+  }
+
+  if (!lookup.mSlot) {
+    co_await source->RenderPage(rc, pageID, rect);
+    co_return;
+  }
+
+  const auto& slot = mSlots.at(*lookup.mSlot);
+  auto d3d = rc.d3d();
+  auto sb = mDXR->mSpriteBatch.get();
+  sb->Begin(d3d.rtv(), rc.GetRenderTarget()->GetDimensions());
+  sb->Draw(slot.mShaderResourceView.get(), PixelRect {{0, 0}, mSize}, rect);
+  sb->End();
+}
+
+void PagePrerenderer::Invalidate() {
+  mPolicy.Invalidate(PagePrerenderPolicy::Clock::now());
+}
+
+task<void> PagePrerenderer::RunIdleWork(
+  IPageSource* source,
+  std::span<const PageID> bookmarks,
+  PagePrerenderPolicy::TimePoint stopAt) {
+  const auto now = PagePrerenderPolicy::Clock::now();
+  if (mPolicy.ShouldRelease(now)) {
+    this->Release();
+    co_return;
+  }
+  if (mPolicy.GetSlotCount() == 0) {
+    co_return;
+  }
+
+  const auto work = mPolicy.GetNextWork(
+    GetPrerenderablePageKeys(source), GetPageKeys(bookmarks), now, stopAt);
+  if (!work) {
+    co_return;
+  }
+  OPENKNEEBOARD_TraceLoggingCoro("PagePrerenderer::RunIdleWork()");
+
+  const auto& slot = this->GetSlot(work->mSlot);
+  mRenderTarget->SetD3DTexture(slot.mTexture);
+  {
+    auto d3d = mRenderTarget->d3d();
+    mDXR->mD3D11ImmediateContext->ClearRenderTargetView(
+      d3d.rtv(), DirectX::Colors::Transparent);
+  }
+
+  const auto start = PagePrerenderPolicy::Clock::now();
+  {
+    OPENKNEEBOARD_MetricsScopedTimer("PagePrerenderer::RunIdleWork");
+    co_await source->RenderPage(
+      RenderContext {mRenderTarget.get(), nullptr},
+      PageID::FromTemporaryValue(work->mPage),
+      {{0, 0}, mSize});
+  }
+  const auto end = PagePrerenderPolicy::Clock::now();
+  // If this was invalidated while rendering, the policy discards the result
+  mPolicy.CompleteWork(*work, end - start, end);
+}
+
+void PagePrerenderer::Release() {
+  mPolicy.Clear();
+  mSize = {};
+  mSlots.clear();
+  mRenderTarget->SetD3DTexture(nullptr);
+}
+
+PagePrerenderer::Slot& PagePrerenderer::GetSlot(
+  PagePrerenderPolicy::SlotIndex index) {
+  if (index >= mSlots.size()) {
+    mSlots.resize(index + 1);
+  }
+  auto& slot = mSlots.at(index);
+  if (slot.mTexture) {
+    return slot;
+  }
+
+  D3D11_TEXTURE2D_DESC textureDesc {
+    .Width = mSize.mWidth,
+    .Height = mSize.mHeight,
+    .MipLevels = 1,
+    .ArraySize = 1,
+    .Format = SHM::SHARED_TEXTURE_PIXEL_FORMAT,
+    .SampleDesc = {1, 0},
+    .Usage = D3D11_USAGE_DEFAULT,
+    .BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET,
+  };
+  winrt::check_hresult(mDXR->mD3D11Device->CreateTexture2D(
+    &textureDesc, nullptr, slot.mTexture.put()));
+  winrt::check_hresult(mDXR->mD3D11Device->CreateShaderResourceView(
+    slot.mTexture.get(), nullptr, slot.mShaderResourceView.put()));
+  return slot;
+}
+
+}// namespace OpenKneeboard
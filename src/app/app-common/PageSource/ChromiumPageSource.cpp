@@ -173,6 +173,7 @@ ChromiumPageSource::RenderPage(RenderContext rc, PageID id, PixelRect rect) {
   }
 
   rh->RenderPage(rc, rect);
+  rh->UpdateFrameRate(client->GetBrowser());
 
   if (mDoodles) {
     mDoodles->Render(rc.GetRenderTarget(), id, rect);
@@ -448,6 +448,9 @@ void ChromiumPageSource::Client::PostCursorEvent(const CursorEvent& ev) {
   if (!this->GetBrowser()) {
     return;
   }
+  if (mRenderHandler) {
+    mRenderHandler->OnCursorEvent(this->GetBrowser());
+  }
 
   auto host = this->GetBrowser()->GetHost();
   if (!host) {
@@ -6,10 +6,15 @@
 // OpenKneeboard repository.
 #include "ChromiumPageSource_RenderHandler.hpp"
 
+#include <OpenKneeboard/Metrics.hpp>
+
 #include <OpenKneeboard/fatal.hpp>
 #include <OpenKneeboard/hresult.hpp>
 #include <OpenKneeboard/tracing.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 namespace OpenKneeboard {
 
 ChromiumPageSource::RenderHandler::RenderHandler(
@@ -92,27 +97,61 @@ void ChromiumPageSource::RenderHandler::OnPaint(
 }
 
 void ChromiumPageSource::RenderHandler::OnAcceleratedPaint(
-  CefRefPtr<CefBrowser>,
+  CefRefPtr<CefBrowser> browser,
   PaintElementType,
-  const RectList& /*dirtyRects*/,
+  const RectList& dirtyRects,
   const CefAcceleratedPaintInfo& info) {
   OPENKNEEBOARD_TraceLoggingScope(
-    "ChromiumPageSource::RenderHandler::OnAcceleratedPaint()");
+    "ChromiumPageSource::RenderHandler::OnAcceleratedPaint()",
+    TraceLoggingValue(dirtyRects.size(), "DirtyRectCount"));
   const FatalOnUncaughtExceptions exceptionBoundary;
   auto pageSource = mPageSource.lock();
   if (!pageSource) {
     return;
   }
-  auto dxr = pageSource->mDXResources.get();
-  const auto frameCount = mFrameCount + 1;
-  const auto frameIndex = frameCount % mFrames.size();
-  auto& frame = mFrames.at(frameIndex);
+  this->UpdateFrameRate(browser);
+  const scope_exit flushStatistics([this] { this->FlushStatistics(); });
 
   const PixelSize sourceSize {
     static_cast<uint32_t>(info.extra.visible_rect.width),
     static_cast<uint32_t>(info.extra.visible_rect.height),
   };
 
+  DirtyRegion dirty {sourceSize};
+  for (auto&& rect: dirtyRects) {
+    dirty.Add({
+      {static_cast<uint32_t>(std::max(rect.x, 0)),
+       static_cast<uint32_t>(std::max(rect.y, 0))},
+      {static_cast<uint32_t>(std::max(rect.width, 0)),
+       static_cast<uint32_t>(std::max(rect.height, 0))},
+    });
+  }
+
+  const auto previousSize = mFrames.at(mFrameCount % mFrames.size()).mSize;
+  if (
+    mFrameCount > 0 && dirty.IsEmpty() && previousSize == sourceSize
+    && !mHaveUncopiedChanges) {
+    // Nothing we show has changed; don't copy, and don't wake up the renderer
+    ++mStatistics.mSkippedFrames;
+    OPENKNEEBOARD_MetricsCount("Chromium skipped frames", 1);
+    return;
+  }
+
+  auto dxr = pageSource->mDXResources.get();
+  const auto frameCount = mFrameCount + 1;
+  const auto frameIndex = frameCount % mFrames.size();
+  auto& frame = mFrames.at(frameIndex);
+
+  // Every buffered frame needs these changes, not just the one we're about
+  // to update. Do this before anything that can fail, so that if we can't
+  // copy this frame, the changes are still picked up by the next one.
+  for (auto&& it: mFrames) {
+    if (it.mTexture && it.mSize == sourceSize) {
+      it.mDirty |= dirty;
+    }
+  }
+  mHaveUncopiedChanges = true;
+
   // CEF explicitly bans us from caching the texture for this HANDLE; we need
   // to re-open it every frame
   wil::com_ptr<ID3D11Texture2D> sourceTexture;
@@ -165,16 +204,20 @@ void ChromiumPageSource::RenderHandler::OnAcceleratedPaint(
       .mSize = sourceSize,
       .mTexture = std::move(texture),
       .mShaderResourceView = std::move(srv),
+      .mDirty = DirtyRegion {sourceSize},
     };
+    frame.mDirty.AddAll();
   }
 
   std::unique_lock lock(*dxr);
 
   auto ctx = dxr->mD3D11ImmediateContext.get();
-  ctx->CopySubresourceRegion(
-    frame.mTexture.get(), 0, 0, 0, 0, sourceTexture.get(), 0, nullptr);
+  this->CopyDirtyRegions(ctx, frame, sourceTexture.get());
   check_hresult(ctx->Signal(mFence.get(), frameCount));
   mFrameCount = frameCount;
+  mHaveUncopiedChanges = false;
+  ++mStatistics.mPublishedFrames;
+  OPENKNEEBOARD_MetricsCount("Chromium published frames", 1);
   pageSource->evNeedsRepaintEvent.Emit();
   if (frameCount == 1) {
     pageSource->evContentChangedEvent.Emit();
@@ -182,6 +225,110 @@ void ChromiumPageSource::RenderHandler::OnAcceleratedPaint(
   }
 }
 
+void ChromiumPageSource::RenderHandler::CopyDirtyRegions(
+  ID3D11DeviceContext* ctx,
+  Frame& frame,
+  ID3D11Texture2D* source) {
+  constexpr uint64_t BytesPerPixel = 4;
+  if (frame.mDirty.IsAll()) {
+    ctx->CopySubresourceRegion(
+      frame.mTexture.get(), 0, 0, 0, 0, source, 0, nullptr);
+  } else {
+    for (auto&& rect: frame.mDirty.GetRects()) {
+      const D3D11_BOX box {
+        .left = rect.Left(),
+        .top = rect.Top(),
+        .front = 0,
+        .right = rect.Right(),
+        .bottom = rect.Bottom(),
+        .back = 1,
+      };
+      ctx->CopySubresourceRegion(
+        frame.mTexture.get(),
+        0,
+        rect.Left(),
+        rect.Top(),
+        0,
+        source,
+        0,
+        &box);
+    }
+  }
+  const auto bytesCopied = frame.mDirty.GetArea() * BytesPerPixel;
+  mStatistics.mBytesCopied += bytesCopied;
+  OPENKNEEBOARD_MetricsCount("Chromium bytes copied", bytesCopied);
+  OPENKNEEBOARD_MetricsCount(
+    "Chromium regions copied", frame.mDirty.GetRects().size());
+  frame.mDirty.Clear();
+}
+
+void ChromiumPageSource::RenderHandler::FlushStatistics() {
+  const auto now = Clock::now();
+  const auto elapsed = now - mStatistics.mPeriodStart;
+  if (elapsed < std::chrono::seconds(1)) {
+    return;
+  }
+  const auto seconds = std::chrono::duration<double>(elapsed).count();
+  mContentFrameRate.store(
+    static_cast<int>(std::ceil(mStatistics.mPublishedFrames / seconds)));
+  TraceLoggingWrite(
+    gTraceProvider,
+    "ChromiumPageSource::RenderHandler/Statistics",
+    TraceLoggingValue(
+      static_cast<uint64_t>(mStatistics.mBytesCopied / seconds),
+      "BytesCopiedPerSecond"),
+    TraceLoggingValue(mStatistics.mPublishedFrames, "PublishedFrames"),
+    TraceLoggingValue(mStatistics.mSkippedFrames, "SkippedFrames"),
+    TraceLoggingValue(mFrameRate.load(), "FrameRate"),
+    TraceLoggingValue(mContentFrameRate.load(), "ContentFrameRate"),
+    TraceLoggingValue(seconds, "Seconds"));
+  mStatistics = {.mPeriodStart = now};
+}
+
+void ChromiumPageSource::RenderHandler::UpdateFrameRate(
+  CefRefPtr<CefBrowser> browser) {
+  if (!browser) {
+    return;
+  }
+  const auto frameRate = this->GetTargetFrameRate();
+  if (mFrameRate.exchange(frameRate) == frameRate) {
+    return;
+  }
+  TraceLoggingWrite(
+    gTraceProvider,
+    "ChromiumPageSource::RenderHandler::UpdateFrameRate()",
+    TraceLoggingValue(frameRate, "FrameRate"));
+  browser->GetHost()->SetWindowlessFrameRate(frameRate);
+}
+
+int ChromiumPageSource::RenderHandler::GetTargetFrameRate() const {
+  constexpr auto MaxFrameRate = static_cast<int>(Config::FramesPerSecond);
+
+  const auto now = Clock::now();
+  if (now - mLastRenderedAt.load() >= HiddenAfter) {
+    return HiddenFramesPerSecond;
+  }
+  if (now - mLastCursorEventAt.load() < InteractiveFor) {
+    return MaxFrameRate;
+  }
+
+  const auto contentFrameRate = mContentFrameRate.load();
+  // If the content changed on (nearly) every paint, it may be animating
+  // faster than we currently allow, so we can't tell how fast it wants to
+  // go: go straight back to the full rate instead of ramping up
+  if (contentFrameRate * 4 >= mFrameRate.load() * 3) {
+    return MaxFrameRate;
+  }
+  return std::clamp(
+    contentFrameRate * 2, MinVisibleFramesPerSecond, MaxFrameRate);
+}
+
+void ChromiumPageSource::RenderHandler::OnCursorEvent(
+  CefRefPtr<CefBrowser> browser) {
+  mLastCursorEventAt.store(Clock::now());
+  this->UpdateFrameRate(browser);
+}
+
 void ChromiumPageSource::RenderHandler::SetSize(const PixelSize& size) {
   mSize = size;
 }
@@ -200,6 +347,7 @@ void ChromiumPageSource::RenderHandler::RenderPage(
   if (!pageSource) {
     return;
   }
+  mLastRenderedAt.store(Clock::now());
 
   const auto& frame = mFrames.at(mFrameCount % mFrames.size());
   auto& spriteBatch = pageSource->mSpriteBatch;
@@ -7,9 +7,15 @@
 #pragma once
 
 #include <OpenKneeboard/ChromiumPageSource.hpp>
+#include <OpenKneeboard/DirtyRegion.hpp>
+
+#include <OpenKneeboard/config.hpp>
 
 #include <include/cef_base.h>
 
+#include <atomic>
+#include <chrono>
+
 namespace OpenKneeboard {
 class ChromiumPageSource::RenderHandler final : public CefRenderHandler {
  public:
@@ -17,8 +23,27 @@ class ChromiumPageSource::RenderHandler final : public CefRenderHandler {
     PixelSize mSize {};
     wil::com_ptr<ID3D11Texture2D> mTexture;
     wil::com_ptr<ID3D11ShaderResourceView> mShaderResourceView;
+    /// Changes since this frame's texture was last updated
+    DirtyRegion mDirty;
   };
 
+  /** Maximum paint rate while we're not being rendered.
+   *
+   * CEF won't paint a page that isn't changing anyway; this throttles
+   * animated pages that nobody is looking at.
+   */
+  static constexpr int HiddenFramesPerSecond = 5;
+  static constexpr auto HiddenAfter = std::chrono::seconds(1);
+  /** Minimum paint rate while visible.
+   *
+   * While visible, the paint rate follows how often the content actually
+   * changes, with headroom; this is the floor for static or slowly-changing
+   * pages, e.g. a clock.
+   */
+  static constexpr int MinVisibleFramesPerSecond = 10;
+  /// Use the full paint rate for this long after cursor input
+  static constexpr auto InteractiveFor = std::chrono::seconds(2);
+
   uint64_t mFrameCount = 0;
   wil::com_ptr<ID3D11Fence> mFence;
   std::array<Frame, 3> mFrames;
@@ -48,11 +73,42 @@ class ChromiumPageSource::RenderHandler final : public CefRenderHandler {
 
   void RenderPage(RenderContext rc, const PixelRect& rect);
 
+  /// Adapt the paint rate to visibility, input, and how often the content
+  /// changes
+  void UpdateFrameRate(CefRefPtr<CefBrowser>);
+  /// Restore the full paint rate, e.g. for scrolling
+  void OnCursorEvent(CefRefPtr<CefBrowser>);
+
  private:
   IMPLEMENT_REFCOUNTING(RenderHandler);
 
+  using Clock = std::chrono::steady_clock;
+
   std::weak_ptr<ChromiumPageSource> mPageSource;
   PixelSize mSize {};
+  // Set if CEF reported changes that we couldn't copy yet
+  bool mHaveUncopiedChanges {false};
+
+  std::atomic<Clock::time_point> mLastRenderedAt {Clock::now()};
+  std::atomic<Clock::time_point> mLastCursorEventAt {};
+  std::atomic<int> mFrameRate {Config::FramesPerSecond};
+  /// How often the content changed during the last statistics period
+  std::atomic<int> mContentFrameRate {Config::FramesPerSecond};
+
+  struct Statistics {
+    Clock::time_point mPeriodStart {Clock::now()};
+    uint64_t mBytesCopied {0};
+    uint64_t mPublishedFrames {0};
+    uint64_t mSkippedFrames {0};
+  };
+  Statistics mStatistics;
+
+  void CopyDirtyRegions(
+    ID3D11DeviceContext*,
+    Frame& frame,
+    ID3D11Texture2D* source);
+  void FlushStatistics();
+  int GetTargetFrameRate() const;
 };
 
 }// namespace OpenKneeboard
@@ -51,9 +51,11 @@ task<void> FolderPageSource::Reload() noexcept {
   }
 
   this->SubscribeToChanges();
-  this->OnFileModified(mPath);
+  co_await this->Rescan(mPath);
 }
 
+void FolderPageSource::Revalidate() { this->OnFileModified(mPath); }
+
 void FolderPageSource::SubscribeToChanges() {
   mWatcher = FilesystemWatcher::Create(mPath);
   AddEventListener(
@@ -66,6 +68,10 @@ void FolderPageSource::SubscribeToChanges() {
 
 OpenKneeboard::fire_and_forget FolderPageSource::OnFileModified(
   const std::filesystem::path directory) {
+  co_await this->Rescan(directory);
+}
+
+task<void> FolderPageSource::Rescan(const std::filesystem::path directory) {
   if (mDisposal.HasStarted()) {
     co_return;
   }
@@ -0,0 +1,224 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/FolderPageSource.hpp>
+#include <OpenKneeboard/FolderPageSourceRegistry.hpp>
+#include <OpenKneeboard/Metrics.hpp>
+#include <OpenKneeboard/PageSourceWithDelegates.hpp>
+
+#include <OpenKneeboard/dprint.hpp>
+#include <OpenKneeboard/task/resume_after.hpp>
+#include <OpenKneeboard/tracing.hpp>
+#include <OpenKneeboard/utf8.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <tuple>
+#include <vector>
+
+namespace OpenKneeboard {
+
+/** A user's reference to a shared `FolderPageSource`.
+ *
+ * The shared source is borrowed, so disposing the lease only releases it;
+ * the registry disposes the source once it has expired.
+ */
+class FolderPageSourceRegistry::Lease final : public PageSourceWithDelegates {
+ public:
+  static task<std::shared_ptr<Lease>> Create(
+    audited_ptr<DXResources> dxr,
+    KneeboardState* kbs,
+    std::weak_ptr<FolderPageSourceRegistry> registry,
+    Key key,
+    std::shared_ptr<FolderPageSource> source) {
+    std::shared_ptr<Lease> ret {
+      new Lease(dxr, kbs, std::move(registry), std::move(key))};
+    co_await ret->SetDelegates({source}, DelegateOwnership::Borrowed);
+    co_return ret;
+  }
+
+  ~Lease() { this->Release(); }
+
+  [[nodiscard]]
+  task<void> DisposeAsync() noexcept override {
+    co_await PageSourceWithDelegates::DisposeAsync();
+    this->Release();
+  }
+
+ private:
+  Lease(
+    const audited_ptr<DXResources>& dxr,
+    KneeboardState* kbs,
+    std::weak_ptr<FolderPageSourceRegistry> registry,
+    Key key)
+    : PageSourceWithDelegates(dxr, kbs),
+      mRegistry(std::move(registry)),
+      mKey(std::move(key)) {}
+
+  void Release() {
+    if (std::exchange(mReleased, true)) {
+      return;
+    }
+    if (auto registry = mRegistry.lock()) {
+      registry->Release(mKey);
+    }
+  }
+
+  std::weak_ptr<FolderPageSourceRegistry> mRegistry;
+  Key mKey;
+  bool mReleased {false};
+};
+
+std::shared_ptr<FolderPageSourceRegistry> FolderPageSourceRegistry::Create(
+  const audited_ptr<DXResources>& dxr,
+  KneeboardState* kbs) {
+  return std::shared_ptr<FolderPageSourceRegistry>(
+    new FolderPageSourceRegistry(dxr, kbs));
+}
+
+FolderPageSourceRegistry::FolderPageSourceRegistry(
+  const audited_ptr<DXResources>& dxr,
+  KneeboardState* kbs)
+  : mDXR(dxr),
+    mKneeboard(kbs) {}
+
+FolderPageSourceRegistry::~FolderPageSourceRegistry() = default;
+
+task<void> FolderPageSourceRegistry::DisposeAsync() noexcept {
+  OPENKNEEBOARD_TraceLoggingCoro("FolderPageSourceRegistry::DisposeAsync()");
+  const auto disposing = co_await mDisposal.StartOnce();
+  if (!disposing) {
+    co_return;
+  }
+  const auto keepAlive = shared_from_this();
+
+  mStopExpiring.request_stop();
+  std::ignore = mLeases.Clear();
+  auto sources = std::exchange(mSources, {});
+  for (auto& [key, source]: sources) {
+    co_await source->DisposeAsync();
+  }
+}
+
+task<std::shared_ptr<IPageSource>> FolderPageSourceRegistry::Acquire(
+  std::filesystem::path path) {
+  OPENKNEEBOARD_TraceLoggingCoro("FolderPageSourceRegistry::Acquire()");
+  const auto keepAlive = shared_from_this();
+  if (mDisposal.HasStarted()) {
+    co_return co_await FolderPageSource::Create(mDXR, mKneeboard, path);
+  }
+
+  std::error_code ec;
+  const auto canonical = std::filesystem::weakly_canonical(path, ec);
+  const auto key = to_utf8(ec ? path.lexically_normal() : canonical);
+
+  const auto [isNew, wasIdle] = mLeases.Acquire(key);
+  std::shared_ptr<FolderPageSource> source;
+
+  if (isNew) {
+    OPENKNEEBOARD_MetricsCount("FolderPageSourceRegistry misses", 1);
+    const auto start = Clock::now();
+    // Can't `co_await` in a `catch` block
+    std::exception_ptr error;
+    try {
+      // Register before loading, so that concurrent requests for the same
+      // folder share it
+      source = co_await FolderPageSource::Create(mDXR, mKneeboard);
+      mSources.emplace(key, source);
+
+      OPENKNEEBOARD_MetricsScopedTimer("FolderPageSourceRegistry::Load");
+      co_await source->SetPath(path);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    if (error) {
+      // Otherwise, later requests would share the broken source, and it
+      // would never expire as the lease was never returned to the caller
+      mLeases.Remove(key);
+      mSources.erase(key);
+      if (source) {
+        co_await source->DisposeAsync();
+      }
+      std::rethrow_exception(error);
+    }
+    dprint(
+      "Loaded folder '{}' in {}",
+      key,
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+        Clock::now() - start));
+  } else if (const auto it = mSources.find(key); it == mSources.end()) {
+    // Another request is still creating it; don't wait for that
+    mLeases.Release(key, Clock::now());
+    co_return co_await FolderPageSource::Create(mDXR, mKneeboard, path);
+  } else {
+    OPENKNEEBOARD_MetricsCount("FolderPageSourceRegistry hits", 1);
+    source = it->second;
+    if (wasIdle) {
+      OPENKNEEBOARD_MetricsCount("FolderPageSourceRegistry idle hits", 1);
+      // The filesystem watcher keeps the source up to date, but check anyway
+      // in case changes were missed while nothing was displaying it
+      source->Revalidate();
+    }
+    dprint("Reusing folder '{}'", key);
+  }
+
+  co_return co_await Lease::Create(
+    mDXR, mKneeboard, this->weak_from_this(), key, source);
+}
+
+void FolderPageSourceRegistry::Release(const Key& key) {
+  if (mDisposal.HasStarted()) {
+    return;
+  }
+  if (!mLeases.Release(key, Clock::now())) {
+    return;
+  }
+  if (mLeases.GetLeaseCount(key) == 0) {
+    this->ExpireIdleSources();
+  }
+}
+
+OpenKneeboard::fire_and_forget FolderPageSourceRegistry::ExpireIdleSources() {
+  if (std::exchange(mExpiring, true)) {
+    co_return;
+  }
+  const auto uiThread = mUIThread;
+  const auto weak = this->weak_from_this();
+  const auto stop = mStopExpiring.get_token();
+  auto self = this->shared_from_this();
+
+  while (const auto next = mLeases.GetNextExpiry()) {
+    // Don't keep the registry alive while waiting
+    self = {};
+    const auto wait = std::max<Clock::duration>(
+      *next - Clock::now(), std::chrono::milliseconds(1));
+    if (!co_await resume_after(wait, stop)) {
+      co_return;
+    }
+    co_await uiThread;
+    self = weak.lock();
+    if (!self) {
+      co_return;
+    }
+
+    // Remove them all before disposing any: `mSources` can change while
+    // we're waiting for a source to be disposed
+    std::vector<std::shared_ptr<FolderPageSource>> expired;
+    for (const auto& key: mLeases.Expire(Clock::now())) {
+      const auto it = mSources.find(key);
+      if (it == mSources.end()) {
+        continue;
+      }
+      dprint("Expiring unused folder '{}'", key);
+      OPENKNEEBOARD_MetricsCount("FolderPageSourceRegistry expirations", 1);
+      expired.push_back(std::move(it->second));
+      mSources.erase(it);
+    }
+    for (auto&& source: expired) {
+      co_await source->DisposeAsync();
+    }
+  }
+  mExpiring = false;
+}
+
+}// namespace OpenKneeboard
@@ -10,4 +10,14 @@ namespace OpenKneeboard {
 
 IPageSource::~IPageSource() = default;
 
+IPageSource::PersistentIDs IPageSource::GetPersistentIDsForAllPages() const {
+  PersistentIDs ret;
+  for (const auto pageID: this->GetPageIDs()) {
+    if (auto persistentID = this->GetPersistentIDForPage(pageID)) {
+      ret.emplace_back(pageID, std::move(*persistentID));
+    }
+  }
+  return ret;
+}
+
 }
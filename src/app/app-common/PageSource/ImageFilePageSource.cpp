@@ -142,6 +142,10 @@ void ImageFilePageSource::SetPaths(
   const std::vector<std::filesystem::path>& paths) {
   OPENKNEEBOARD_TraceLoggingScopedActivity(
     activity, "ImageFilePageSource::SetPaths()");
+  {
+    std::unique_lock lock(mMutex);
+    mGeometry.Clear();
+  }
   mPages.clear();
   mPages.reserve(paths.size());
   for (const auto& path: paths) {
@@ -173,6 +177,10 @@ void ImageFilePageSource::OnFileModified(const std::filesystem::path& path) {
   if (it == mPages.end()) {
     return;
   }
+  {
+    std::unique_lock lock(mMutex);
+    mGeometry.Erase(it->mID);
+  }
   if (std::filesystem::exists(path)) {
     it->mBitmap = {};
     it->mID = {};
@@ -273,14 +281,40 @@ std::vector<PageID> ImageFilePageSource::GetPageIDs() const {
 
 std::optional<PreferredSize> ImageFilePageSource::GetPreferredSize(
   PageID pageID) {
-  auto bitmap = GetPageBitmap(pageID);
-  if (!bitmap) {
+  std::unique_lock lock(mMutex);
+  return mGeometry.FindOrMeasure(
+    pageID, [this, pageID] { return this->MeasurePage(pageID); });
+}
+
+std::optional<PreferredSize> ImageFilePageSource::MeasurePage(PageID pageID) {
+  OPENKNEEBOARD_TraceLoggingScope("ImageFilePageSource::MeasurePage()");
+  const auto it = std::ranges::find(mPages, pageID, &Page::mID);
+  if (it == mPages.end()) {
     return std::nullopt;
   }
 
-  const auto size = bitmap->GetPixelSize();
+  if (it->mBitmap) {
+    const auto size = it->mBitmap->GetPixelSize();
+    return PreferredSize {{size.width, size.height}, ScalingKind::Bitmap};
+  }
 
-  return PreferredSize {{size.width, size.height}, ScalingKind::Bitmap};
+  // Only reads the image header; pixels aren't decoded until it's rendered
+  auto decoder =
+    ImageFilePageSource::GetDecoderFromFileName(mDXR->mWIC.get(), it->mPath);
+  if (!decoder) {
+    return std::nullopt;
+  }
+  winrt::com_ptr<IWICBitmapFrameDecode> frame;
+  decoder->GetFrame(0, frame.put());
+  if (!frame) {
+    return std::nullopt;
+  }
+  UINT width {};
+  UINT height {};
+  if (FAILED(frame->GetSize(&width, &height))) {
+    return std::nullopt;
+  }
+  return PreferredSize {{width, height}, ScalingKind::Bitmap};
 }
 
 task<void> ImageFilePageSource::RenderPage(
@@ -412,6 +446,11 @@ winrt::com_ptr<ID2D1Bitmap> ImageFilePageSource::GetPageBitmap(PageID pageID) {
     page.mBitmap->CopyFromBitmap(nullptr, sharedBitmap.get(), nullptr);
   }
 
+  const auto size = page.mBitmap->GetPixelSize();
+  mGeometry.Set(
+    page.mID,
+    PreferredSize {{size.width, size.height}, ScalingKind::Bitmap});
+
   return page.mBitmap;
 }
 
@@ -440,6 +479,16 @@ std::optional<std::string> ImageFilePageSource::GetPersistentIDForPage(
   return it->mPath.string();
 }
 
+IPageSource::PersistentIDs ImageFilePageSource::GetPersistentIDsForAllPages()
+  const {
+  PersistentIDs ret;
+  ret.reserve(mPages.size());
+  for (const auto& page: mPages) {
+    ret.emplace_back(page.mID, page.mPath.string());
+  }
+  return ret;
+}
+
 std::optional<PageID> ImageFilePageSource::GetPageIDFromPersistentID(
   const std::string_view persistentId) const {
   const std::filesystem::path path {persistentId};
@@ -16,6 +16,8 @@
 #include <OpenKneeboard/NavigationTab.hpp>
 #include <OpenKneeboard/PDFFilePageSource.hpp>
 #include <OpenKneeboard/PDFNavigation.hpp>
+#include <OpenKneeboard/PageGeometryTable.hpp>
+#include <OpenKneeboard/PersistentPageIndex.hpp>
 #include <OpenKneeboard/RuntimeFiles.hpp>
 
 #include <OpenKneeboard/config.hpp>
@@ -25,7 +27,6 @@
 #include <OpenKneeboard/scope_exit.hpp>
 #include <OpenKneeboard/utf8.hpp>
 
-#include <shims/nlohmann/json.hpp>
 #include <shims/winrt/base.h>
 
 #include <winrt/Microsoft.UI.Dispatching.h>
@@ -73,6 +74,8 @@ struct PDFFilePageSource::DocumentResources final {
 
   std::filesystem::path mPath;
   std::shared_ptr<Filesystem::TemporaryCopy> mCopy;
+  // Hashed once per load, for persistent page IDs
+  std::optional<uint64_t> mFileHash;
 
   std::shared_ptr<FilesystemWatcher> mWatcher;
 
@@ -86,6 +89,7 @@ struct PDFFilePageSource::DocumentResources final {
   std::unordered_map<RenderTargetID, std::unique_ptr<CachedLayer>> mCache;
 
   std::vector<PageID> mPageIDs;
+  PageGeometryTable<PageID> mGeometry;
 
   static auto Create(
     const std::filesystem::path& path,
@@ -373,8 +377,15 @@ task<void> PDFFilePageSource::Reload() try {
                     ++sCount,
                     doc->mPath.stem().wstring().substr(0, 16),
                     doc->mPath.extension());
-    doc->mCopy =
+    auto copy =
       std::make_shared<Filesystem::TemporaryCopy>(doc->mPath, tempPath);
+    const auto hash = PartialFileHash(doc->mPath);
+
+    const auto lock = wrap_lock(std::unique_lock {mMutex});
+    doc->mCopy = std::move(copy);
+    if (hash) {
+      doc->mFileHash = *hash;
+    }
   }
 
   co_await uiThread;
@@ -436,22 +447,27 @@ std::vector<PageID> PDFFilePageSource::GetPageIDs() const {
 }
 
 std::optional<PreferredSize> PDFFilePageSource::GetPreferredSize(PageID id) {
-  if (!mDocumentResources) {
-    return std::nullopt;
-  }
-
-  auto it = std::ranges::find(mDocumentResources->mPageIDs, id);
-  if (it == mDocumentResources->mPageIDs.end()) {
+  const auto lock = wrap_lock(std::unique_lock {mMutex});
+  const auto doc = mDocumentResources;
+  if (!doc) {
     return std::nullopt;
   }
-  const auto index =
-    felly::numeric_cast<PageIndex>(it - mDocumentResources->mPageIDs.begin());
-  auto size = mDocumentResources->mPDFDocument.GetPage(index).Size();
 
-  return PreferredSize {
-    {static_cast<UINT32>(size.Width), static_cast<UINT32>(size.Height)},
-    ScalingKind::Vector,
-  };
+  return doc->mGeometry.FindOrMeasure(
+    id, [&doc, id]() -> std::optional<PreferredSize> {
+      const auto it = std::ranges::find(doc->mPageIDs, id);
+      if (it == doc->mPageIDs.end()) {
+        return std::nullopt;
+      }
+      const auto index =
+        felly::numeric_cast<PageIndex>(it - doc->mPageIDs.begin());
+      const auto size = doc->mPDFDocument.GetPage(index).Size();
+
+      return PreferredSize {
+        {static_cast<UINT32>(size.Width), static_cast<UINT32>(size.Height)},
+        ScalingKind::Vector,
+      };
+    });
 }
 
 void PDFFilePageSource::RenderPageContent(
@@ -652,8 +668,20 @@ fire_and_forget PDFFilePageSource::OnFileModified(
   }
 }
 
+std::optional<uint64_t> PDFFilePageSource::GetFileHash() const {
+  const auto lock = wrap_lock(std::shared_lock {mMutex});
+  if (!mDocumentResources) {
+    return std::nullopt;
+  }
+  return mDocumentResources->mFileHash;
+}
+
 std::optional<std::string> PDFFilePageSource::GetPersistentIDForPage(
   PageID id) const {
+  const auto hash = this->GetFileHash();
+  if (!hash) {
+    return std::nullopt;
+  }
   const auto pageIDs = this->GetPageIDs();
   const auto it = std::ranges::find(pageIDs, id);
   if (it == pageIDs.end()) {
@@ -661,31 +689,38 @@ std::optional<std::string> PDFFilePageSource::GetPersistentIDForPage(
   }
   const auto pageIndex
     = static_cast<PageIndex>(std::distance(pageIDs.begin(), it));
-  const auto hash = PartialFileHash(this->GetPath());
+  return PersistentPageID {*hash, pageIndex}.Serialize();
+}
+
+IPageSource::PersistentIDs PDFFilePageSource::GetPersistentIDsForAllPages()
+  const {
+  const auto hash = this->GetFileHash();
   if (!hash) {
-    return std::nullopt;
+    return {};
+  }
+  const auto pageIDs = this->GetPageIDs();
+  PersistentIDs ret;
+  ret.reserve(pageIDs.size());
+  for (PageIndex i = 0; i < pageIDs.size(); ++i) {
+    ret.emplace_back(pageIDs.at(i), PersistentPageID {*hash, i}.Serialize());
   }
-  return nlohmann::json {{"PageIndex", pageIndex}, {"FileHash", *hash}}.dump();
+  return ret;
 }
 
 std::optional<PageID> PDFFilePageSource::GetPageIDFromPersistentID(
   std::string_view id) const {
-  const auto parsed = nlohmann::json::parse(id, nullptr, false);
-  if (parsed.is_discarded() || !parsed.contains("PageIndex")
-      || !parsed.contains("FileHash")) {
+  const auto parsed = PersistentPageID::Parse(id);
+  if (!parsed) {
     return std::nullopt;
   }
-  const auto storedHash = parsed.at("FileHash").get<uint64_t>();
-  const auto currentHash = PartialFileHash(this->GetPath());
-  if (!currentHash || *currentHash != storedHash) {
+  if (parsed->mFileHash != this->GetFileHash()) {
     return std::nullopt;
   }
-  const auto pageIndex = parsed.at("PageIndex").get<PageIndex>();
   const auto pageIDs = this->GetPageIDs();
-  if (pageIndex >= static_cast<PageIndex>(pageIDs.size())) {
+  if (parsed->mPageIndex >= pageIDs.size()) {
     return std::nullopt;
   }
-  return pageIDs[pageIndex];
+  return pageIDs[parsed->mPageIndex];
 }
 
 }// namespace OpenKneeboard
@@ -30,6 +30,7 @@ PageSourceWithDelegates::PageSourceWithDelegates(
       this->evContentChangedEvent,
       [this]() {
         this->mContentLayerCache.clear();
+        this->mPageDelegates.clear();
         std::unordered_set<PageID> keep;
         for (const auto pageID: this->GetPageIDs()) {
           keep.insert(pageID);
@@ -61,20 +62,23 @@ task<void> PageSourceWithDelegates::DisposeAsync() noexcept {
 }
 
 task<void> PageSourceWithDelegates::SetDelegates(
-  std::vector<std::shared_ptr<IPageSource>> delegates) {
+  std::vector<std::shared_ptr<IPageSource>> delegates,
+  DelegateOwnership ownership) {
   winrt::apartment_context thread;
   OPENKNEEBOARD_TraceLoggingCoro("PageSourceWithDelegates::SetDelegates()");
 
   auto keepAlive = shared_from_this();
 
-  auto disposers = mDelegates | std::views::transform([](auto it) {
-                     return std::dynamic_pointer_cast<IHasDisposeAsync>(it);
-                   })
-    | std::views::filter([](auto it) -> bool { return !!it; })
-    | std::views::transform([](auto it) { return it->DisposeAsync(); })
-    | std::ranges::to<std::vector>();
-  for (auto& it: disposers) {
-    co_await std::move(it);
+  if (mDelegateOwnership == DelegateOwnership::Owned) {
+    auto disposers = mDelegates | std::views::transform([](auto it) {
+                       return std::dynamic_pointer_cast<IHasDisposeAsync>(it);
+                     })
+      | std::views::filter([](auto it) -> bool { return !!it; })
+      | std::views::transform([](auto it) { return it->DisposeAsync(); })
+      | std::ranges::to<std::vector>();
+    for (auto& it: disposers) {
+      co_await std::move(it);
+    }
   }
 
   mPageDelegates.clear();
@@ -85,6 +89,7 @@ task<void> PageSourceWithDelegates::SetDelegates(
   }
   mDelegateEvents.clear();
   mDelegates = delegates;
+  mDelegateOwnership = ownership;
 
   for (auto& delegate: delegates) {
     std::ranges::copy(
@@ -130,21 +135,24 @@ std::shared_ptr<IPageSource> PageSourceWithDelegates::FindDelegate(
   if (!pageID) {
     return {nullptr};
   }
-  if (mPageDelegates.contains(pageID)) {
-    return mPageDelegates.at(pageID).lock();
+  if (const auto it = mPageDelegates.find(pageID);
+      it != mPageDelegates.end()) {
+    return it->second.lock();
   }
 
-  auto delegate =
-    std::ranges::find_if(mDelegates, [pageID](const auto& delegate) {
-      auto pageIDs = delegate->GetPageIDs();
-      auto it = std::ranges::find(pageIDs, pageID);
-      return it != pageIDs.end();
-    });
-  if (delegate == mDelegates.end()) {
-    return {nullptr};
+  // Index every page in one pass - instead of searching each delegate again
+  // for each page - so later lookups for any page are O(1)
+  for (const auto& delegate: mDelegates) {
+    for (const auto id: delegate->GetPageIDs()) {
+      mPageDelegates.try_emplace(id, delegate);
+    }
+  }
+
+  if (const auto it = mPageDelegates.find(pageID);
+      it != mPageDelegates.end()) {
+    return it->second.lock();
   }
-  mPageDelegates[pageID] = *delegate;
-  return *delegate;
+  return {nullptr};
 }
 
 std::optional<PreferredSize> PageSourceWithDelegates::GetPreferredSize(
@@ -204,6 +212,12 @@ task<void> PageSourceWithDelegates::RenderPageWithCache(
     } | bind_front(delegate, pageID));
 }
 
+bool PageSourceWithDelegates::HasInternalCaching(PageID pageID) const {
+  return std::dynamic_pointer_cast<IPageSourceWithInternalCaching>(
+           this->FindDelegate(pageID))
+    != nullptr;
+}
+
 bool PageSourceWithDelegates::CanClearUserInput() const {
   if (mDoodles->HaveDoodles()) {
     return true;
@@ -333,6 +347,26 @@ fire_and_forget PageSourceWithDelegates::OpenDeveloperToolsWindow(
   co_return;
 }
 
+std::vector<SearchResult> PageSourceWithDelegates::Search(
+  std::string_view query,
+  std::size_t maxResults) const {
+  std::vector<SearchResult> results;
+  for (const auto& delegate: mDelegates) {
+    if (results.size() >= maxResults) {
+      break;
+    }
+    const auto withSearch =
+      std::dynamic_pointer_cast<IPageSourceWithSearch>(delegate);
+    if (!withSearch) {
+      continue;
+    }
+    std::ranges::copy(
+      withSearch->Search(query, maxResults - results.size()),
+      std::back_inserter(results));
+  }
+  return results;
+}
+
 std::optional<std::string> PageSourceWithDelegates::GetPersistentIDForPage(
   PageID id) const {
   auto delegate = this->FindDelegate(id);
@@ -342,6 +376,15 @@ std::optional<std::string> PageSourceWithDelegates::GetPersistentIDForPage(
   return delegate->GetPersistentIDForPage(id);
 }
 
+IPageSource::PersistentIDs
+PageSourceWithDelegates::GetPersistentIDsForAllPages() const {
+  PersistentIDs ret;
+  for (const auto& delegate: mDelegates) {
+    ret.append_range(delegate->GetPersistentIDsForAllPages());
+  }
+  return ret;
+}
+
 std::optional<PageID> PageSourceWithDelegates::GetPageIDFromPersistentID(
   std::string_view id) const {
   for (const auto& delegate: mDelegates) {
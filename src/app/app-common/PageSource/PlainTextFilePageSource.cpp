@@ -5,19 +5,29 @@
 // This program is open source; see the LICENSE file in the root of the
 // OpenKneeboard repository.
 #include <OpenKneeboard/FileHash.hpp>
+#include <OpenKneeboard/Filesystem.hpp>
+#include <OpenKneeboard/PersistentPageIndex.hpp>
 #include <OpenKneeboard/PlainTextFilePageSource.hpp>
 #include <OpenKneeboard/PlainTextPageSource.hpp>
 
 #include <OpenKneeboard/scope_exit.hpp>
 
-#include <shims/nlohmann/json.hpp>
-
 #include <winrt/Windows.Foundation.h>
 
 #include <fstream>
 
 namespace OpenKneeboard {
 
+namespace {
+/* Larger files are laid out directly from a memory mapping instead of a copy;
+ * this is much faster and uses much less memory.
+ *
+ * Smaller files are copied, as Windows does not allow truncating a mapped
+ * file, which breaks saving in many editors.
+ */
+constexpr std::uintmax_t MinimumMappedFileSize = 4 * 1024 * 1024;
+}// namespace
+
 PlainTextFilePageSource::PlainTextFilePageSource(
   const audited_ptr<DXResources>& dxr,
   KneeboardState* kbs)
@@ -65,11 +75,12 @@ void PlainTextFilePageSource::Reload() {
   this->mWatcher = {nullptr};
 
   if (!std::filesystem::is_regular_file(mPath)) {
+    mFileHash.reset();
     mPageSource->ClearText();
     return;
   }
 
-  mPageSource->SetText(this->GetFileContent());
+  this->LoadFileContent();
   this->SubscribeToChanges();
 }
 
@@ -90,17 +101,41 @@ void PlainTextFilePageSource::OnFileModified(
   }
 
   if (!std::filesystem::is_regular_file(mPath)) {
+    mFileHash.reset();
     mPageSource->SetText({});
     mPageSource->SetPlaceholderText(_("[file deleted]"));
     this->evContentChangedEvent.Emit();
     return;
   }
 
-  mPageSource->SetText(this->GetFileContent());
+  this->LoadFileContent();
   mPageSource->SetPlaceholderText(_("[empty file]"));
   this->evContentChangedEvent.Emit();
 }
 
+void PlainTextFilePageSource::LoadFileContent() {
+  // Map before hashing: the mapping blocks other writers, so the hash matches
+  // the content we lay out
+  std::unique_ptr<Filesystem::MappedFile> mapped;
+  std::error_code ec;
+  if (std::filesystem::file_size(mPath, ec) >= MinimumMappedFileSize && !ec) {
+    mapped = Filesystem::MappedFile::Open(mPath);
+  }
+
+  if (const auto hash = PartialFileHash(mPath)) {
+    mFileHash = *hash;
+  } else {
+    mFileHash.reset();
+  }
+
+  if (mapped) {
+    mPageSource->SetMappedText(std::move(mapped));
+    return;
+  }
+  // Too small to be worth mapping, or being written to by another process
+  mPageSource->SetText(this->GetFileContent());
+}
+
 std::string PlainTextFilePageSource::GetFileContent() const {
   auto bytes = std::filesystem::file_size(mPath);
   if (bytes == 0) {
@@ -138,7 +173,7 @@ PageIndex PlainTextFilePageSource::GetPageCount() const {
 
 std::optional<std::string> PlainTextFilePageSource::GetPersistentIDForPage(
   PageID id) const {
-  if (mPath.empty()) {
+  if (mPath.empty() || !mFileHash) {
     return std::nullopt;
   }
   const auto pageIDs = this->GetPageIDs();
@@ -148,11 +183,22 @@ std::optional<std::string> PlainTextFilePageSource::GetPersistentIDForPage(
   }
   const auto pageIndex
     = static_cast<PageIndex>(std::distance(pageIDs.begin(), it));
-  const auto hash = PartialFileHash(mPath);
-  if (!hash) {
-    return std::nullopt;
+  return PersistentPageID {*mFileHash, pageIndex}.Serialize();
+}
+
+IPageSource::PersistentIDs
+PlainTextFilePageSource::GetPersistentIDsForAllPages() const {
+  if (mPath.empty() || !mFileHash) {
+    return {};
+  }
+  const auto pageIDs = this->GetPageIDs();
+  PersistentIDs ret;
+  ret.reserve(pageIDs.size());
+  for (PageIndex i = 0; i < pageIDs.size(); ++i) {
+    ret.emplace_back(
+      pageIDs.at(i), PersistentPageID {*mFileHash, i}.Serialize());
   }
-  return nlohmann::json {{"PageIndex", pageIndex}, {"FileHash", *hash}}.dump();
+  return ret;
 }
 
 std::optional<PageID> PlainTextFilePageSource::GetPageIDFromPersistentID(
@@ -160,17 +206,13 @@ std::optional<PageID> PlainTextFilePageSource::GetPageIDFromPersistentID(
   if (mPath.empty()) {
     return std::nullopt;
   }
-  const auto parsed = nlohmann::json::parse(id, nullptr, false);
-  if (parsed.is_discarded() || !parsed.contains("PageIndex")
-      || !parsed.contains("FileHash")) {
-    return std::nullopt;
-  }
-  const auto storedHash = parsed.at("FileHash").get<uint64_t>();
-  const auto currentHash = PartialFileHash(mPath);
-  if (!currentHash || *currentHash != storedHash) {
+  const auto parsed = PersistentPageID::Parse(id);
+  if (!(parsed && parsed->mFileHash == mFileHash)) {
     return std::nullopt;
   }
-  const auto pageIndex = parsed.at("PageIndex").get<PageIndex>();
+  const auto pageIndex = parsed->mPageIndex;
+  // Pages after the first are laid out in the background
+  mPageSource->LayOutThroughPage(pageIndex);
   const auto pageIDs = this->GetPageIDs();
   if (pageIndex >= static_cast<PageIndex>(pageIDs.size())) {
     return std::nullopt;
@@ -7,21 +7,21 @@
 
 #include <OpenKneeboard/D2DErrorRenderer.hpp>
 #include <OpenKneeboard/DXResources.hpp>
+#include <OpenKneeboard/Filesystem.hpp>
 #include <OpenKneeboard/PlainTextPageSource.hpp>
 #include <OpenKneeboard/Win32.hpp>
 
 #include <OpenKneeboard/config.hpp>
 #include <OpenKneeboard/dprint.hpp>
-#include <OpenKneeboard/scope_exit.hpp>
 
 #include <Unknwn.h>
 
 #include <felly/numeric_cast.hpp>
-#include <felly/overload.hpp>
 #include <felly/unique_ptr.hpp>
 
 #include <algorithm>
 #include <format>
+#include <span>
 
 #include <dwrite.h>
 #include <icu.h>
@@ -33,282 +33,71 @@ namespace {
 using unique_UText = felly::unique_ptr<UText, &utext_close>;
 using unique_UBreakIterator = felly::unique_ptr<UBreakIterator, &ubrk_close>;
 
-using SourceReference = PlainTextPageSource::SourceReference;
-// source is tracked separately as the content does not include trailing
-// separators, e.g.:
-// - \r\n or \n for lines
-// - \n\n for paragraphs
-// - \x1d (GROUP SEPARATOR) for groups
-// The source *should* include these separators
-struct WrappedLine {
-  std::string_view mContent;
-  SourceReference mSourceWithDelimiter;
-  SourceReference mSourceWithoutDelimiter;
-
-  operator std::string_view() const { return mContent; }
-};
-struct SourceLine {
-  std::string_view mContent;
-  std::vector<WrappedLine> mWrappedContent;
-  SourceReference mSourceWithDelimiter;
-  SourceReference mSourceWithoutDelimiter;
-
-  void ApplyWordWrap(const std::size_t columns) {
-    if (mContent.size() <= columns) {
-      mWrappedContent = {
-        WrappedLine {mContent, mSourceWithDelimiter, mSourceWithoutDelimiter}};
-      return;
-    }
-
+// Splits text into case-folded words for `TextSearchIndex`; indexed text and
+// queries must be tokenized the same way
+class SearchTokenizer final {
+ public:
+  SearchTokenizer() {
     UErrorCode status = U_ZERO_ERROR;
-    const unique_UText utext {
-      utext_openUTF8(nullptr, mContent.data(), mContent.size(), &status)};
-    const unique_UBreakIterator it {
-      ubrk_open(UBRK_CHARACTER, "", nullptr, 0, &status)};
-    ubrk_setUText(it.get(), utext.get(), &status);
-
-    mWrappedContent.clear();
-    ubrk_first(it.get());
-    while (ubrk_current(it.get()) < mContent.size()) {
-      const auto sourceLineOffset = ubrk_current(it.get());
-      const auto sourceOffset = sourceLineOffset + mSourceWithDelimiter.mOffset;
-
-      std::string_view outputLine {mContent.substr(sourceLineOffset)};
-      if (outputLine.size() <= columns) {
-        mWrappedContent.emplace_back(
-          outputLine,
-          SourceReference {
-            sourceOffset, mSourceWithDelimiter.mLength - sourceLineOffset},
-          SourceReference {
-            sourceOffset, mSourceWithoutDelimiter.mLength - sourceLineOffset});
-        break;
-      }
-      std::size_t graphemeCount {};
-      std::optional<std::size_t> lastWhitespace {};
-      while (ubrk_next(it.get()) != UBRK_DONE) {
-        ++graphemeCount;
-        if (graphemeCount > columns) {
-          break;
-        }
-        const auto offset = ubrk_current(it.get());
-        const auto cp = utext_next32From(utext.get(), offset);
-        if (cp == U_SENTINEL || u_isUWhiteSpace(cp)) {
-          lastWhitespace = offset;
-        }
-      }
-
-      if (graphemeCount > columns) {
-        if (lastWhitespace) {
-          // We *know* it's a boundary, but this functions as a `seek()`
-          std::ignore = ubrk_isBoundary(it.get(), *lastWhitespace);
-        } else {
-          ubrk_previous(it.get());
-        }
-        outputLine = mContent.substr(
-          sourceLineOffset, ubrk_current(it.get()) - sourceLineOffset);
-        if (lastWhitespace) {
-          ubrk_next(it.get());
-        }
-      }
-
-      mWrappedContent.emplace_back(
-        outputLine,
-        SourceReference {sourceOffset, outputLine.size()},
-        SourceReference {sourceOffset, outputLine.size()});
-    }
-
-    mWrappedContent.back().mSourceWithDelimiter.mLength +=
-      mSourceWithDelimiter.mLength - mSourceWithoutDelimiter.mLength;
+    mBreakIterator = unique_UBreakIterator {
+      ubrk_open(UBRK_WORD, "", nullptr, 0, &status)};
   }
-};
 
-struct SourceParagraph {
-  std::vector<SourceLine> mLines;
-  SourceReference mSourceWithDelimiter;
-  SourceReference mSourceWithoutDelimiter;
-  std::size_t mWrappedLineCount {};
-
-  void ApplyWordWrap(const std::size_t columns) {
-    mWrappedLineCount = 0;
-    for (auto&& line: mLines) {
-      line.ApplyWordWrap(columns);
-      mWrappedLineCount += line.mWrappedContent.size();
+  // Valid until the next call
+  std::span<const std::string_view> operator()(const std::string_view text) {
+    mTokens.clear();
+    if (!mBreakIterator) {
+      return {};
     }
-  }
-};
-
-struct SourceGroup {
-  std::vector<SourceParagraph> mParagraphs;
-  SourceReference mSourceWithDelimiter;
-  SourceReference mSourceWithoutDelimiter;
-
-  std::size_t mWrappedLineCount {};
-
-  void ApplyWordWrap(const std::size_t columns) {
-    mWrappedLineCount = 0;
-    for (auto&& paragraph: mParagraphs) {
-      paragraph.ApplyWordWrap(columns);
-      mWrappedLineCount += paragraph.mWrappedLineCount;
-    }
-  }
-};
-struct Source {
-  std::vector<SourceGroup> mGroups;
+    fold_utf8(text, mFolded);
 
-  void ApplyWordWrap(const std::size_t columns) {
-    for (auto&& group: mGroups) {
-      group.ApplyWordWrap(columns);
-    }
-  }
-};
-
-void PopulateSourceParagraph(
-  SourceParagraph& paragraph,
-  const std::string_view allContent) {
-  auto& lines = paragraph.mLines;
-  const auto [paraOffset, paraLength] = paragraph.mSourceWithoutDelimiter;
-
-  auto begin = paraOffset;
-  const auto end = begin + paraLength;
-  auto i = begin;
-  while (i < end) {
-    const auto remaining = allContent.substr(i);
-    if (remaining.starts_with("\n")) {
-      lines.push_back({
-        .mSourceWithDelimiter = {begin, (i - begin) + 1},
-        .mSourceWithoutDelimiter = {begin, (i - begin)},
-      });
-      i += 1;
-      begin = i;
-      continue;
-    }
-    if (remaining.starts_with("\r\n")) {
-      lines.push_back({
-        .mSourceWithDelimiter = {begin, (i - begin) + 2},
-        .mSourceWithoutDelimiter = {begin, (i - begin)},
-      });
-      i += 2;
-      begin = i;
-      continue;
+    UErrorCode status = U_ZERO_ERROR;
+    const unique_UText utext {
+      utext_openUTF8(nullptr, mFolded.data(), mFolded.size(), &status)};
+    const auto it = mBreakIterator.get();
+    ubrk_setUText(it, utext.get(), &status);
+    if (U_FAILURE(status)) {
+      return {};
     }
-    ++i;
-  }
-  if (begin < end) {
-    lines.push_back({
-      .mSourceWithDelimiter = {begin, (end - begin)},
-      .mSourceWithoutDelimiter = {begin, (end - begin)},
-    });
-  }
-
-  if (
-    paragraph.mSourceWithoutDelimiter.mLength
-    < paragraph.mSourceWithDelimiter.mLength) {
-    OPENKNEEBOARD_ASSERT(
-      paragraph.mSourceWithoutDelimiter.mOffset
-      == paragraph.mSourceWithDelimiter.mOffset);
-    const auto offset = paragraph.mSourceWithoutDelimiter.mOffset
-      + paragraph.mSourceWithoutDelimiter.mLength;
-    const auto length = paragraph.mSourceWithDelimiter.mLength
-      - paragraph.mSourceWithoutDelimiter.mLength;
-    lines.push_back({
-      .mSourceWithDelimiter = {offset, length},
-      .mSourceWithoutDelimiter = {offset, 0},
-    });
-  }
-  if (lines.empty()) {
-    return;
-  }
-
-  for (auto&& line: lines) {
-    const auto [lineOffset, lineLength] = line.mSourceWithoutDelimiter;
-    line.mContent =
-      std::string_view {allContent}.substr(lineOffset, lineLength);
-  }
-
-  lines.back().mSourceWithDelimiter.mLength +=
-    paragraph.mSourceWithDelimiter.mLength
-    - paragraph.mSourceWithoutDelimiter.mLength;
-}
 
-void PopulateSourceGroup(
-  SourceGroup& group,
-  const std::string_view allContent) {
-  auto& paragraphs = group.mParagraphs;
-  const auto [groupOffset, groupLength] = group.mSourceWithoutDelimiter;
-
-  auto begin = groupOffset;
-  const auto end = begin + groupLength;
-  auto i = begin;
-  while (i < end) {
-    const auto remaining = allContent.substr(i);
-    if (remaining.starts_with("\n\n")) {
-      paragraphs.push_back({
-        .mSourceWithDelimiter = {begin, (i - begin) + 2},
-        .mSourceWithoutDelimiter = {begin, (i - begin)},
-      });
-      i += 2;
-      begin = i;
-      continue;
-    }
-    if (remaining.starts_with("\r\n\r\n")) {
-      paragraphs.push_back({
-        .mSourceWithDelimiter = {begin, (i - begin) + 4},
-        .mSourceWithoutDelimiter = {begin, (i - begin)},
-      });
-      i += 4;
-      begin = i;
-      continue;
+    const std::string_view folded {mFolded};
+    for (auto begin = ubrk_first(it), end = ubrk_next(it); end != UBRK_DONE;
+         begin = std::exchange(end, ubrk_next(it))) {
+      // Skip whitespace and punctuation
+      if (ubrk_getRuleStatus(it) < UBRK_WORD_NONE_LIMIT) {
+        continue;
+      }
+      mTokens.push_back(folded.substr(begin, end - begin));
     }
-    ++i;
-  }
-  if (begin < end) {
-    paragraphs.push_back({
-      .mSourceWithDelimiter = {begin, (end - begin)},
-      .mSourceWithoutDelimiter = {begin, (end - begin)},
-    });
-  }
-  if (paragraphs.empty()) {
-    return;
+    return mTokens;
   }
 
-  for (auto&& paragraph: paragraphs) {
-    PopulateSourceParagraph(paragraph, allContent);
+  // True if the last call ended mid-word, e.g. while typing a query
+  [[nodiscard]]
+  bool EndedInWord() const {
+    return !mTokens.empty()
+      && (mTokens.back().data() + mTokens.back().size())
+      == (mFolded.data() + mFolded.size());
   }
 
-  paragraphs.back().mSourceWithDelimiter.mLength +=
-    group.mSourceWithDelimiter.mLength - group.mSourceWithoutDelimiter.mLength;
-}
-
-void PopulateSource(
-  Source& source,
-  const std::string_view allContent,
-  const std::size_t offset) {
-  static constexpr auto GroupSeparator = '\x1d';
-  auto& groups = source.mGroups;
-  std::size_t begin = offset;
-  std::size_t sep = begin;
-  do {
-    sep = allContent.find(GroupSeparator, begin);
-    if (sep == allContent.npos) {
-      break;
-    }
-    groups.push_back({
-      .mSourceWithDelimiter = {begin, (sep - begin) + 1},
-      .mSourceWithoutDelimiter = {begin, (sep - begin)},
-    });
-    begin = sep + 1;
-  } while (sep != allContent.npos);
+ private:
+  unique_UBreakIterator mBreakIterator;
+  std::string mFolded;
+  std::vector<std::string_view> mTokens;
+};
 
-  if (begin < allContent.size()) {
-    groups.push_back({
-      .mSourceWithDelimiter = {begin, allContent.size() - begin},
-      .mSourceWithoutDelimiter = {begin, allContent.size() - begin},
-    });
-  }
+// Lay out enough synchronously for the first page, and for small changes - such
+// as new messages - to be complete immediately
+constexpr std::size_t SynchronousLayoutBytes = 256 * 1024;
+constexpr std::size_t BackgroundLayoutBytesPerLock = 16 * 1024;
+constexpr std::size_t BackgroundLayoutBytesPerUpdate = 1024 * 1024;
 
-  for (auto&& group: groups) {
-    PopulateSourceGroup(group, allContent);
+TextSearchIndex::Location GetEndLocation(const PlainTextLayout& layout) {
+  const auto& pages = layout.GetPages();
+  if (pages.empty()) {
+    return {};
   }
+  return {pages.size() - 1, pages.back().mLines.size()};
 }
 
 }// namespace
@@ -360,6 +149,10 @@ void PlainTextPageSource::UpdateLayoutLimits() {
   mRows =
     static_cast<int>((size.mHeight - (2 * mPadding)) / metrics.height) - 2;
   mColumns = static_cast<int>((size.mWidth - (2 * mPadding)) / metrics.width);
+
+  mLayout.emplace(
+    static_cast<std::size_t>(std::max(mColumns, 2)),
+    static_cast<std::size_t>(std::max(mRows, 2)));
 }
 
 PlainTextPageSource::~PlainTextPageSource() { this->RemoveAllEventListeners(); }
@@ -371,39 +164,48 @@ void PlainTextPageSource::OnSettingsChanged() {
     return;
   }
 
-  mFontSize = newFontSize;
+  {
+    std::unique_lock lock(mMutex);
+    mFontSize = newFontSize;
 
-  auto dwf = mDXR->mDWriteFactory;
+    auto dwf = mDXR->mDWriteFactory;
 
-  mTextFormat = nullptr;
+    mTextFormat = nullptr;
 
-  dwf->CreateTextFormat(
-    FixedWidthContentFont,
-    nullptr,
-    DWRITE_FONT_WEIGHT_NORMAL,
-    DWRITE_FONT_STYLE_NORMAL,
-    DWRITE_FONT_STRETCH_NORMAL,
-    newFontSize,
-    L"",
-    mTextFormat.put());
+    dwf->CreateTextFormat(
+      FixedWidthContentFont,
+      nullptr,
+      DWRITE_FONT_WEIGHT_NORMAL,
+      DWRITE_FONT_STYLE_NORMAL,
+      DWRITE_FONT_STRETCH_NORMAL,
+      newFontSize,
+      L"",
+      mTextFormat.put());
 
-  UpdateLayoutLimits();
+    UpdateLayoutLimits();
 
-  // With a font/size change, may no longer correlate
-  mPageIDs.clear();
-  mPages.clear();
+    // With a font/size change, may no longer correlate
+    mPageIDs.clear();
+    mSearchIndex.Clear();
+    mSearchIndexEnd = {};
+    mFirstModifiedOffset = 0;
 
-  UpdateLayout();
+    UpdateLayout();
+  }
+  evContentChangedEvent.Emit();
 }
 
 PageIndex PlainTextPageSource::GetPageCount() const {
-  if (mPages.empty()) {
+  std::unique_lock lock(mMutex);
+  const auto& pages = mLayout->GetPages();
+  if (pages.empty()) {
     return mPlaceholderText.empty() ? 0 : 1;
   }
-  return mPages.size();
+  return pages.size();
 }
 
 std::vector<PageID> PlainTextPageSource::GetPageIDs() const {
+  std::unique_lock lock(mMutex);
   mPageIDs.resize(GetPageCount());
   return mPageIDs;
 }
@@ -417,6 +219,7 @@ std::optional<PreferredSize> PlainTextPageSource::GetPreferredSize(PageID) {
 
 std::optional<PageIndex> PlainTextPageSource::FindPageIndex(
   PageID pageID) const {
+  std::unique_lock lock(mMutex);
   auto it = std::ranges::find(mPageIDs, pageID);
   if (it == mPageIDs.end()) {
     return {};
@@ -463,7 +266,8 @@ task<void> PlainTextPageSource::RenderPage(
 
   auto textFormat = mTextFormat.get();
   textFormat->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_LEADING);
-  if (mPages.empty()) {
+  const auto& pages = mLayout->GetPages();
+  if (pages.empty()) {
     if (mPlaceholderText.empty()) {
       co_return;
     }
@@ -487,10 +291,18 @@ task<void> PlainTextPageSource::RenderPage(
     co_return;
   }
 
-  const auto& lines = mPages.at(*pageIndex).mLines;
+  const auto content = this->GetContent();
+  const auto& lines = pages.at(*pageIndex).mLines;
 
   D2D_POINT_2F point {mPadding, mPadding};
-  for (const auto& line: lines) {
+  for (const auto& [offset, length]: lines) {
+    const auto line = [utf8 = content.substr(offset, length)] {
+      try {
+        return Win32::UTF8::or_throw::to_wide(utf8);
+      } catch (const winrt::hresult_error& ex) {
+        return std::format(L"⚠️ UTF-8 error: {}", ex.message());
+      }
+    }();
     ctx->DrawTextW(
       line.data(),
       static_cast<UINT32>(line.size()),
@@ -518,10 +330,10 @@ task<void> PlainTextPageSource::RenderPage(
   }
 
   {
-    auto text = std::format(
-      _(L"Page {} of {}"),
-      *pageIndex + 1,
-      std::max<PageIndex>(*pageIndex + 1, GetPageCount()));
+    const auto pageCount = std::max<PageIndex>(*pageIndex + 1, GetPageCount());
+    auto text = mLayout->IsComplete(content)
+      ? std::format(_(L"Page {} of {}"), *pageIndex + 1, pageCount)
+      : std::format(_(L"Page {} of {}+"), *pageIndex + 1, pageCount);
 
     textFormat->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_CENTER);
     ctx->DrawTextW(
@@ -555,19 +367,46 @@ std::optional<PageID> PlainTextPageSource::GetPageIDFromPersistentID(
   return std::nullopt;
 }
 
+std::vector<SearchResult> PlainTextPageSource::Search(
+  std::string_view query,
+  std::size_t maxResults) const {
+  SearchTokenizer tokenize;
+  const auto terms = tokenize(query);
+  if (terms.empty()) {
+    return {};
+  }
+  const auto lastTerm = tokenize.EndedInWord()
+    ? TextSearchIndex::LastTerm::Prefix
+    : TextSearchIndex::LastTerm::Exact;
+
+  std::unique_lock lock(mMutex);
+  mPageIDs.resize(GetPageCount());
+  return mSearchIndex.Find(terms, lastTerm, maxResults)
+    | std::views::transform([this](const auto& location) {
+           return SearchResult {mPageIDs.at(location.mPage), location.mLine};
+         })
+    | std::ranges::to<std::vector>();
+}
+
 bool PlainTextPageSource::IsEmpty() const {
   std::unique_lock lock(mMutex);
-  return mPages.empty() || mPages.front().mLines.empty();
+  const auto& pages = mLayout->GetPages();
+  return pages.empty() || pages.front().mLines.empty();
 }
 
 void PlainTextPageSource::ClearText() {
   {
     std::unique_lock lock(mMutex);
-    if (IsEmpty()) {
+    if (IsEmpty() && GetContent().empty()) {
       return;
     }
-    mPages.clear();
+    mContent.clear();
+    mMappedContent = {};
+    mFirstModifiedOffset = std::nullopt;
+    mLayout->Clear();
     mPageIDs.clear();
+    mSearchIndex.Clear();
+    mSearchIndexEnd = {};
   }
   this->evContentChangedEvent.Emit();
 }
@@ -575,13 +414,26 @@ void PlainTextPageSource::ClearText() {
 void PlainTextPageSource::SetText(std::string_view text) {
   {
     std::unique_lock lock(mMutex);
-    if (mContent == text) {
+    if (GetContent() == text) {
       return;
     }
-    mContent = text;
-    mFirstModifiedOffset = unknown_offset;
+    this->ReplaceContent(text);
+    this->UpdateLayout();
+  }
+  evContentChangedEvent.Emit();
+}
+
+void PlainTextPageSource::SetMappedText(
+  std::unique_ptr<Filesystem::MappedFile> file) {
+  {
+    std::unique_lock lock(mMutex);
+    mContent = {};
+    mMappedContent = std::move(file);
+    // The previous content may be a view of the same file, so we can't
+    // compare them
+    mFirstModifiedOffset = 0;
+    this->UpdateLayout();
   }
-  this->UpdateLayout();
   evContentChangedEvent.Emit();
 }
 
@@ -612,213 +464,199 @@ void PlainTextPageSource::PushMessage(std::string_view message) {
     sMessage.replace(pos, 1, "    ");
   }
 
-  if (mContent.empty()) {
+  if (GetContent().empty()) {
     SetText(sMessage);
-  } else {
-    SetText(std::format("{}\x1d{}", mContent, sMessage));
+    return;
   }
+
+  // Append rather than `SetText()`, so that `UpdateLayout()` knows that only
+  // the new content needs to be laid out and indexed
+  this->AppendContent(std::format("\x1d{}", sMessage));
+  this->UpdateLayout();
+  evContentChangedEvent.Emit();
 }
 
 void PlainTextPageSource::EnsureNewPage() {
   std::unique_lock lock(mMutex);
-  if (mPages.empty()) {
-    return;
+  const auto pageCount = mLayout->GetPages().size();
+  mLayout->EnsureNewPage(this->GetContent());
+  if (mLayout->GetPages().size() > pageCount) {
+    this->evPageAppendedEvent.Emit(SuggestedPageAppendAction::SwitchToNewPage);
   }
-  if (!mPages.back().mLines.empty()) {
-    this->PushPage();
+}
+
+void PlainTextPageSource::LayOutThroughPage(const PageIndex index) {
+  std::unique_lock lock(mMutex);
+  if (mLayout->LayOutUntil(this->GetContent(), index + 1) > 0) {
+    this->UpdateSearchIndex();
   }
 }
 
-void PlainTextPageSource::PushPage() {
-  const auto offset = mPages.empty()
-    ? 0
-    : (mPages.back().mSource.mOffset + mPages.back().mSource.mLength);
-  mPages.push_back({});
-  mPages.back().mSource.mOffset = offset;
-  this->evPageAppendedEvent.Emit(SuggestedPageAppendAction::SwitchToNewPage);
+std::string_view PlainTextPageSource::GetContent() const {
+  if (mMappedContent) {
+    return mMappedContent->GetContent();
+  }
+  return mContent;
 }
 
 void PlainTextPageSource::AppendContent(const std::string_view append) {
+  if (mMappedContent) {
+    mContent = mMappedContent->GetContent();
+    mMappedContent = {};
+  }
   const auto previousSize = mContent.size();
   mContent += append;
-  using first_offset_t = decltype(mFirstModifiedOffset);
-  mFirstModifiedOffset = std::visit<first_offset_t>(
-    felly::overload {
-      [=](std::monostate) { return previousSize; },
-      [=](const std::size_t previousOffset) {
-        OPENKNEEBOARD_ASSERT(previousOffset <= previousSize);
-        return previousOffset;
-      },
-      [](unknown_offset_t) { return unknown_offset; },
-    },
-    mFirstModifiedOffset);
+  mFirstModifiedOffset
+    = std::min(mFirstModifiedOffset.value_or(previousSize), previousSize);
 }
 
 void PlainTextPageSource::ReplaceContent(const std::string_view replacement) {
+  const auto previous = this->GetContent();
+  const auto firstModified = static_cast<std::size_t>(std::distance(
+    previous.begin(), std::ranges::mismatch(previous, replacement).in1));
   mContent = replacement;
-  mFirstModifiedOffset = unknown_offset;
+  mMappedContent = {};
+  mFirstModifiedOffset
+    = std::min(mFirstModifiedOffset.value_or(firstModified), firstModified);
 }
 
 void PlainTextPageSource::PushFullWidthSeparator() {
   std::unique_lock lock(mMutex);
-  if (mColumns <= 0 || mPages.empty() || mPages.back().mLines.empty()) {
+  const auto& pages = mLayout->GetPages();
+  if (mColumns <= 0 || pages.empty() || pages.back().mLines.empty()) {
     return;
   }
   this->PushMessage(std::string(mColumns, '-'));
 }
 
 void PlainTextPageSource::UpdateLayout() {
-  if (mContent == mLastLayoutContent) {
-    return;
+  std::unique_lock lock(mMutex);
+  const auto content = this->GetContent();
+  const auto& pages = mLayout->GetPages();
+
+  if (const auto offset = std::exchange(mFirstModifiedOffset, std::nullopt)) {
+    // Pages before the modification keep their IDs; this includes the last
+    // page when appending
+    const auto firstModifiedPage
+      = std::ranges::find_if(pages, [offset](const auto& page) {
+          return page.mSource.mOffset + page.mSource.mLength > *offset;
+        });
+    mPageIDs.resize(std::min(
+      mPageIDs.size(),
+      static_cast<std::size_t>(
+        std::distance(pages.begin(), firstModifiedPage))));
+
+    mLayout->Invalidate(*offset);
+    const auto layoutEnd = GetEndLocation(*mLayout);
+    if (layoutEnd < mSearchIndexEnd) {
+      mSearchIndex.Truncate(layoutEnd);
+      mSearchIndexEnd = layoutEnd;
+    }
   }
 
-  ///// 1. Find where modifications start /////
-  const auto firstModifiedOffset = std::visit<std::size_t>(
-    felly::overload {
-      [=](std::monostate) -> std::size_t {
-        fatal("Have differing text without a first modified offset");
-      },
-      [=](const std::size_t offset) { return offset; },
-      [this](unknown_offset_t) {
-        const auto it =
-          std::mismatch(
-            mContent.begin(),
-            mContent.begin()
-              + std::min(mContent.size(), mLastLayoutContent.size()),
-            mLastLayoutContent.begin())
-            .first;
-        return std::distance(mContent.begin(), it);
-      },
-    },
-    std::exchange(mFirstModifiedOffset, {}));
-  mLastLayoutContent = mContent;
-  const auto firstDifferingPage =
-    std::ranges::find_if(mPages, [firstModifiedOffset](const auto& page) {
-      return page.mSource.mOffset + page.mSource.mLength > firstModifiedOffset;
-    });
-  mPages.erase(firstDifferingPage, mPages.end());
-  mPageIDs.resize(mPages.size());
-  if (firstModifiedOffset == mContent.size()) {
-    return;
+  const auto pageCount = pages.size();
+  auto laidOut = mLayout->LayOutUntil(content, 1);
+  while (laidOut < SynchronousLayoutBytes) {
+    const auto it = mLayout->LayOutNext(content);
+    if (it == 0) {
+      break;
+    }
+    laidOut += it;
   }
+  this->UpdateSearchIndex();
 
-  ///// 2. Split the input into groups, paragraphs, and lines /////
-  OPENKNEEBOARD_ASSERT(mRows > 1 && mColumns > 1);
-  const auto repaintAtEnd =
-    scope_exit {[this] { evContentChangedEvent.Emit(); }};
-  Source source {};
-  if (mPages.empty()) {
-    PopulateSource(source, mContent, 0);
-  } else {
-    const auto& [offset, length] = mPages.back().mSource;
-    PopulateSource(source, mContent, offset + length);
+  if (pages.size() > pageCount) {
+    evPageAppendedEvent.Emit(SuggestedPageAppendAction::SwitchToNewPage);
   }
 
-  source.ApplyWordWrap(mColumns);
+  if (mLayout->IsComplete(content) || mHaveBackgroundLayout) {
+    return;
+  }
+  auto weak = weak_from_this();
+  if (weak.expired()) [[unlikely]] {
+    // Not owned by a shared_ptr, so we can't safely continue later
+    while (mLayout->LayOutNext(content)) {
+    }
+    this->UpdateSearchIndex();
+    return;
+  }
+  mHaveBackgroundLayout = true;
+  ContinueLayout(std::move(weak));
+}
 
-  ///// 3. Add to pages /////
-  bool haveNewPage = false;
-  const auto emitNewPage = scope_exit([&, this] {
-    if (haveNewPage) {
-      evPageAppendedEvent.Emit(SuggestedPageAppendAction::SwitchToNewPage);
+void PlainTextPageSource::UpdateSearchIndex() {
+  const auto& pages = mLayout->GetPages();
+  if (pages.empty()) {
+    return;
+  }
+  const auto content = this->GetContent();
+  SearchTokenizer tokenize;
+  auto& [pageIndex, lineIndex] = mSearchIndexEnd;
+  while (true) {
+    const auto& lines = pages.at(pageIndex).mLines;
+    for (; lineIndex < lines.size(); ++lineIndex) {
+      const auto [offset, length] = lines.at(lineIndex);
+      mSearchIndex.AddLine(
+        pageIndex, lineIndex, tokenize(content.substr(offset, length)));
     }
-  });
-  if (mPages.empty()) {
-    mPages.emplace_back();
-    haveNewPage = true;
-  }
-  auto remainingRows = mRows - mPages.back().mLines.size();
-  const auto appendLinesToCurrentPage = [&, this](auto&& sourceLines) {
-    if (sourceLines.empty()) {
-      return;
+    if (pageIndex + 1 >= pages.size()) {
+      break;
     }
+    ++pageIndex;
+    lineIndex = 0;
+  }
+}
 
-    auto& page = mPages.back();
-    const auto wrappedLines = sourceLines
-      | std::views::transform(&SourceLine::mWrappedContent) | std::views::join;
-    page.mLines.append_range(
-      wrappedLines | std::views::transform([](const auto& utf8) {
-        try {
-          return Win32::UTF8::or_throw::to_wide(utf8);
-        } catch (const winrt::hresult_error& ex) {
-          return std::format(L"⚠️ UTF-8 error: {}", ex.message());
-        }
-      }));
-    const auto [lastStart, lastLength] =
-      sourceLines.back().mSourceWithDelimiter;
-    const auto end = lastStart + lastLength;
-    page.mSource.mLength = end - page.mSource.mOffset;
-    remainingRows -= std::ranges::distance(wrappedLines);
-  };
-
-  const auto pushPage = [&, this](const std::size_t offset) {
-    mPages.emplace_back();
-    mPages.back().mSource = {offset, 0};
-    remainingRows = mRows;
-    haveNewPage = true;
-  };
-
-  for (auto&& group: source.mGroups) {
-    if (remainingRows == 0) {
-      pushPage(group.mSourceWithDelimiter.mOffset);
+fire_and_forget PlainTextPageSource::ContinueLayout(
+  std::weak_ptr<PlainTextPageSource> weak) {
+  bool complete = false;
+  while (!complete) {
+    co_await winrt::resume_background();
+    auto self = weak.lock();
+    if (!self) {
+      co_return;
     }
 
-    if (group.mWrappedLineCount <= mRows) {
-      if (group.mWrappedLineCount > remainingRows) {
-        pushPage(group.mSourceWithDelimiter.mOffset);
+    PageIndex pageCount {};
+    std::size_t laidOut = 0;
+    // Take the lock in small steps, so that we don't block rendering
+    while (laidOut < BackgroundLayoutBytesPerUpdate && !complete) {
+      std::unique_lock lock(self->mMutex);
+      const auto content = self->GetContent();
+      const auto& layout = *self->mLayout;
+      if (laidOut == 0) {
+        pageCount = layout.GetPages().size();
       }
-      appendLinesToCurrentPage(
-        group.mParagraphs | std::views::transform(&SourceParagraph::mLines)
-        | std::views::join);
-      continue;
-    }
-
-    for (auto&& paragraph: group.mParagraphs) {
-      if (paragraph.mWrappedLineCount <= mRows) {
-        if (paragraph.mWrappedLineCount > remainingRows) {
-          pushPage(paragraph.mSourceWithDelimiter.mOffset);
+      for (std::size_t i = 0; i < BackgroundLayoutBytesPerLock;) {
+        const auto it = self->mLayout->LayOutNext(content);
+        if (it == 0) {
+          break;
         }
-        appendLinesToCurrentPage(paragraph.mLines);
-        continue;
+        i += it;
+        laidOut += it;
       }
-
-      for (auto&& line: paragraph.mLines) {
-        const auto wrappedLines = line.mWrappedContent.size();
-        if (wrappedLines <= mRows) {
-          if (wrappedLines > remainingRows) {
-            pushPage(line.mSourceWithDelimiter.mOffset);
-          }
-          appendLinesToCurrentPage(std::views::single(line));
-          continue;
-        }
-        auto remaining = std::span {line.mWrappedContent};
-        while (!remaining.empty()) {
-          if (remainingRows == 0) {
-            pushPage(remaining.front().mSourceWithDelimiter.mOffset);
-          }
-
-          const auto count = std::min(remainingRows, remaining.size());
-          const auto chunk =
-            remaining.first(count) | std::ranges::to<std::vector>();
-          const auto& back = chunk.back();
-          const auto offset = chunk.front().mSourceWithDelimiter.mOffset;
-          const SourceLine it {
-            .mWrappedContent =
-              remaining.first(count) | std::ranges::to<std::vector>(),
-            .mSourceWithDelimiter =
-              {offset,
-               back.mSourceWithDelimiter.mOffset
-                 + back.mSourceWithDelimiter.mLength - offset},
-            .mSourceWithoutDelimiter =
-              {offset,
-               back.mSourceWithoutDelimiter.mOffset
-                 + back.mSourceWithoutDelimiter.mLength - offset},
-          };
-          appendLinesToCurrentPage(std::views::single(it));
-          remaining = remaining.subspan(count);
-        }
+      self->UpdateSearchIndex();
+      complete = layout.IsComplete(content);
+      if (complete) {
+        self->mHaveBackgroundLayout = false;
       }
     }
+
+    co_await self->mUIThread;
+    const auto appended = [&self, pageCount] {
+      std::unique_lock lock(self->mMutex);
+      return self->mLayout->GetPages().size() > pageCount;
+    }();
+    // Laying out more pages doesn't change the existing ones, so only notify
+    // listeners that there's more pages; `evContentChangedEvent` makes them
+    // drop their caches, so only emit it once we're done
+    if (appended) {
+      self->evPageAppendedEvent.Emit(
+        SuggestedPageAppendAction::KeepOnCurrentPage);
+    }
+    if (complete) {
+      self->evContentChangedEvent.Emit();
+    }
   }
 }
 
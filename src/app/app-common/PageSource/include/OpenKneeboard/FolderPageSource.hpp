@@ -37,10 +37,14 @@ class FolderPageSource final : public PageSourceWithDelegates {
 
   [[nodiscard]]
   task<void> Reload() noexcept;
+  /// Check for changes without waiting for the filesystem watcher
+  void Revalidate();
 
  private:
   void SubscribeToChanges();
   OpenKneeboard::fire_and_forget OnFileModified(std::filesystem::path);
+  /// Create delegates for new files, and drop those for removed files
+  task<void> Rescan(std::filesystem::path);
 
   winrt::apartment_context mUIThread;
   std::shared_ptr<FilesystemWatcher> mWatcher;
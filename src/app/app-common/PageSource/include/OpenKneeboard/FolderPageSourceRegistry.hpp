@@ -0,0 +1,85 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <OpenKneeboard/DXResources.hpp>
+#include <OpenKneeboard/IHasDisposeAsync.hpp>
+#include <OpenKneeboard/LeaseTracker.hpp>
+
+#include <OpenKneeboard/audited_ptr.hpp>
+#include <OpenKneeboard/task.hpp>
+
+#include <shims/winrt/base.h>
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <stop_token>
+#include <unordered_map>
+
+namespace OpenKneeboard {
+
+class FolderPageSource;
+class IPageSource;
+class KneeboardState;
+
+/** `FolderPageSource`s shared between tabs, keyed by canonical path.
+ *
+ * The DCS tabs pick their folders again whenever the aircraft, terrain, or
+ * mission changes - including on every respawn. Sharing the sources means
+ * that re-selecting a folder doesn't reload every file in it.
+ *
+ * Sources are kept for `GracePeriod` after their last user goes away; if
+ * they're reused during that time, they're rescanned for changes rather
+ * than rebuilt.
+ *
+ * All members must be called from the UI thread.
+ */
+class FolderPageSourceRegistry final
+  : public IHasDisposeAsync,
+    public std::enable_shared_from_this<FolderPageSourceRegistry> {
+ public:
+  static constexpr auto GracePeriod = std::chrono::seconds(60);
+
+  FolderPageSourceRegistry() = delete;
+  static std::shared_ptr<FolderPageSourceRegistry> Create(
+    const audited_ptr<DXResources>&,
+    KneeboardState*);
+  ~FolderPageSourceRegistry();
+
+  [[nodiscard]]
+  task<void> DisposeAsync() noexcept override;
+
+  /** Get a page source for the folder at `path`.
+   *
+   * The returned source is a lease on the shared source; it should be
+   * disposed or destroyed when it's no longer needed, but never disposes
+   * the shared source itself.
+   */
+  [[nodiscard]]
+  task<std::shared_ptr<IPageSource>> Acquire(std::filesystem::path path);
+
+ private:
+  class Lease;
+  using Clock = LeaseTracker::Clock;
+  using Key = LeaseTracker::Key;
+
+  FolderPageSourceRegistry(const audited_ptr<DXResources>&, KneeboardState*);
+
+  void Release(const Key&);
+  OpenKneeboard::fire_and_forget ExpireIdleSources();
+
+  winrt::apartment_context mUIThread;
+  DisposalState mDisposal;
+
+  audited_ptr<DXResources> mDXR;
+  KneeboardState* mKneeboard {nullptr};
+
+  LeaseTracker mLeases {GracePeriod};
+  std::unordered_map<Key, std::shared_ptr<FolderPageSource>> mSources;
+
+  bool mExpiring {false};
+  std::stop_source mStopExpiring;
+};
+
+}// namespace OpenKneeboard
@@ -20,6 +20,8 @@
 #include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 #include <d2d1_1.h>
 
@@ -51,6 +53,16 @@ class IPageSource {
   // support persistent bookmarks.
   virtual std::optional<std::string> GetPersistentIDForPage(PageID) const = 0;
 
+  using PersistentIDs = std::vector<std::pair<PageID, std::string>>;
+  /** The persistent IDs of every page that has one, in page order.
+   *
+   * The default implementation calls `GetPersistentIDForPage()` for each
+   * page; sources where that searches the pages should override this to do
+   * a single pass, as should anything that overrides
+   * `GetPersistentIDForPage()` on top of an implementation of this.
+   */
+  virtual PersistentIDs GetPersistentIDsForAllPages() const;
+
   // Resolves a previously returned persistent ID back to a live PageID.
   // Returns nullopt if the page is not found or if the underlying content has
   // changed since the identifier was created.
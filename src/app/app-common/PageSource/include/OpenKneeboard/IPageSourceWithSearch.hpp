@@ -0,0 +1,32 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <OpenKneeboard/IPageSource.hpp>
+#include <OpenKneeboard/UniqueID.hpp>
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace OpenKneeboard {
+
+struct SearchResult {
+  PageID mPageID;
+  /// Line within the page, as laid out
+  std::size_t mLine {};
+};
+
+class IPageSourceWithSearch : public virtual IPageSource {
+ public:
+  /** Find lines matching `query`, in page order.
+   *
+   * Matching is case-insensitive, and words must appear in order; the last
+   * word matches as a prefix unless the query ends with a space.
+   */
+  virtual std::vector<SearchResult> Search(
+    std::string_view query,
+    std::size_t maxResults) const = 0;
+};
+
+}// namespace OpenKneeboard
@@ -11,6 +11,7 @@
 #include <OpenKneeboard/FilesystemWatcher.hpp>
 #include <OpenKneeboard/IPageSource.hpp>
 #include <OpenKneeboard/IPageSourceWithNavigation.hpp>
+#include <OpenKneeboard/PageGeometryTable.hpp>
 
 #include <OpenKneeboard/audited_ptr.hpp>
 
@@ -47,6 +48,7 @@ class ImageFilePageSource final
 
   virtual std::optional<std::string> GetPersistentIDForPage(
     PageID) const override;
+  virtual PersistentIDs GetPersistentIDsForAllPages() const override;
   virtual std::optional<PageID> GetPageIDFromPersistentID(
     std::string_view) const override;
 
@@ -80,8 +82,11 @@ class ImageFilePageSource final
 
   std::mutex mMutex;
   std::vector<Page> mPages = {};
+  PageGeometryTable<PageID> mGeometry;
 
   winrt::com_ptr<ID2D1Bitmap> GetPageBitmap(PageID);
+  /// Requires `mMutex`
+  std::optional<PreferredSize> MeasurePage(PageID);
 
   static winrt::com_ptr<IWICBitmapDecoder> GetDecoderFromFileName(
     IWICImagingFactory*,
@@ -68,6 +68,7 @@ class PDFFilePageSource final
 
   virtual std::optional<std::string> GetPersistentIDForPage(
     PageID) const override;
+  virtual PersistentIDs GetPersistentIDsForAllPages() const override;
   virtual std::optional<PageID> GetPageIDFromPersistentID(
     std::string_view) const override;
 
@@ -100,6 +101,7 @@ class PDFFilePageSource final
   RenderOverDoodles(ID2D1DeviceContext*, PageID pageIndex, const D2D1_RECT_F&);
 
   PageID GetPageIDForIndex(PageIndex index) const;
+  std::optional<uint64_t> GetFileHash() const;
 };
 
 }// namespace OpenKneeboard
@@ -13,6 +13,7 @@
 #include <OpenKneeboard/IPageSourceWithCursorEvents.hpp>
 #include <OpenKneeboard/IPageSourceWithDeveloperTools.hpp>
 #include <OpenKneeboard/IPageSourceWithNavigation.hpp>
+#include <OpenKneeboard/IPageSourceWithSearch.hpp>
 #include <OpenKneeboard/KneeboardState.hpp>
 #include <OpenKneeboard/PageSourceWithDelegates.hpp>
 
@@ -35,6 +36,7 @@ class PageSourceWithDelegates
     public virtual IPageSourceWithCursorEvents,
     public virtual IPageSourceWithNavigation,
     public virtual IPageSourceWithDeveloperTools,
+    public virtual IPageSourceWithSearch,
     public IHasDisposeAsync,
     public virtual EventReceiver,
     public enable_shared_from_this<PageSourceWithDelegates> {
@@ -51,6 +53,14 @@ class PageSourceWithDelegates
   virtual std::optional<PreferredSize> GetPreferredSize(PageID) override;
   task<void> RenderPage(RenderContext, PageID, PixelRect rect) override;
 
+  /** Whether the page is rendered by an `IPageSourceWithInternalCaching`.
+   *
+   * These delegates must not be cached by wrappers, and may need a
+   * `KneeboardView` in the `RenderContext`.
+   */
+  [[nodiscard]]
+  bool HasInternalCaching(PageID) const;
+
   virtual void PostCursorEvent(KneeboardViewID, const CursorEvent&, PageID)
     override;
   virtual bool CanClearUserInput(PageID) const override;
@@ -65,20 +75,35 @@ class PageSourceWithDelegates
   bool HasDeveloperTools(PageID) const override;
   fire_and_forget OpenDeveloperToolsWindow(KneeboardViewID, PageID) override;
 
+  virtual std::vector<SearchResult> Search(
+    std::string_view query,
+    std::size_t maxResults) const override;
+
   virtual std::optional<std::string> GetPersistentIDForPage(
     PageID) const override;
+  virtual PersistentIDs GetPersistentIDsForAllPages() const override;
   virtual std::optional<PageID> GetPageIDFromPersistentID(
     std::string_view) const override;
 
  protected:
   DisposalState mDisposal;
 
+  /// Whether `SetDelegates()` disposes the delegates it replaces
+  enum class DelegateOwnership {
+    Owned,
+    /// Shared with other sources, which may still be using them
+    Borrowed,
+  };
+
   [[nodiscard]]
-  task<void> SetDelegates(std::vector<std::shared_ptr<IPageSource>>);
+  task<void> SetDelegates(
+    std::vector<std::shared_ptr<IPageSource>>,
+    DelegateOwnership = DelegateOwnership::Owned);
 
  private:
   audited_ptr<DXResources> mDXResources;
   std::vector<std::shared_ptr<IPageSource>> mDelegates;
+  DelegateOwnership mDelegateOwnership {DelegateOwnership::Owned};
   std::vector<EventHandlerToken> mDelegateEvents;
   std::vector<EventHandlerToken> mFixedEvents;
 
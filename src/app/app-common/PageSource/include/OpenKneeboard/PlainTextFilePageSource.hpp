@@ -17,6 +17,7 @@
 
 #include <filesystem>
 #include <memory>
+#include <optional>
 
 namespace OpenKneeboard {
 
@@ -41,6 +42,7 @@ class PlainTextFilePageSource final : public PageSourceWithDelegates {
 
   virtual std::optional<std::string> GetPersistentIDForPage(
     PageID) const override;
+  virtual PersistentIDs GetPersistentIDsForAllPages() const override;
   virtual std::optional<PageID> GetPageIDFromPersistentID(
     std::string_view) const override;
 
@@ -49,8 +51,11 @@ class PlainTextFilePageSource final : public PageSourceWithDelegates {
  private:
   winrt::apartment_context mUIThread;
   std::filesystem::path mPath;
+  // Hashed when the content is loaded, for persistent page IDs
+  std::optional<uint64_t> mFileHash;
   std::shared_ptr<PlainTextPageSource> mPageSource;
 
+  void LoadFileContent();
   std::string GetFileContent() const;
 
   std::shared_ptr<FilesystemWatcher> mWatcher;
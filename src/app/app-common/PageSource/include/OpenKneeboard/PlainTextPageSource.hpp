@@ -7,10 +7,13 @@
 #pragma once
 
 #include "IPageSource.hpp"
+#include "IPageSourceWithSearch.hpp"
 
 #include <OpenKneeboard/DXResources.hpp>
 #include <OpenKneeboard/Events.hpp>
 #include <OpenKneeboard/KneeboardState.hpp>
+#include <OpenKneeboard/PlainTextLayout.hpp>
+#include <OpenKneeboard/TextSearchIndex.hpp>
 
 #include <OpenKneeboard/audited_ptr.hpp>
 #include <OpenKneeboard/utf8.hpp>
@@ -24,13 +27,16 @@ namespace OpenKneeboard {
 
 struct DXResources;
 
-class PlainTextPageSource final : public IPageSource,
-                                  public virtual EventReceiver {
+namespace Filesystem {
+class MappedFile;
+}
+
+class PlainTextPageSource final
+  : public virtual IPageSource,
+    public virtual IPageSourceWithSearch,
+    public virtual EventReceiver,
+    public std::enable_shared_from_this<PlainTextPageSource> {
  public:
-  struct SourceReference {
-    std::size_t mOffset {};
-    std::size_t mLength {};
-  };
   PlainTextPageSource() = delete;
   PlainTextPageSource(
     const audited_ptr<DXResources>&,
@@ -41,11 +47,20 @@ class PlainTextPageSource final : public IPageSource,
   bool IsEmpty() const;
   void ClearText();
   void SetText(std::string_view text);
+  /// Use the file directly instead of copying its content
+  void SetMappedText(std::unique_ptr<Filesystem::MappedFile>);
   void SetPlaceholderText(std::string_view text);
   void PushMessage(std::string_view message);
   void PushFullWidthSeparator();
   void EnsureNewPage();
 
+  /** Synchronously lay out pages up to and including `index`.
+   *
+   * Layout is usually only done as far as needed for the first page, with the
+   * rest done in the background.
+   */
+  void LayOutThroughPage(PageIndex index);
+
   virtual PageIndex GetPageCount() const override;
   virtual std::vector<PageID> GetPageIDs() const override;
   virtual std::optional<PreferredSize> GetPreferredSize(PageID) override;
@@ -56,21 +71,12 @@ class PlainTextPageSource final : public IPageSource,
   virtual std::optional<PageID> GetPageIDFromPersistentID(
     std::string_view) const override;
 
- private:
-  using RenderedLine = std::wstring;
-  struct RenderedPage {
-    SourceReference mSource {};
-
-    std::vector<RenderedLine> mLines;
-
-    [[nodiscard]]
-    bool IsEmpty() const {
-      return mLines.empty();
-    }
-  };
-  struct unknown_offset_t {};
-  static constexpr unknown_offset_t unknown_offset {};
+  virtual std::vector<SearchResult> Search(
+    std::string_view query,
+    std::size_t maxResults) const override;
 
+ private:
+  winrt::apartment_context mUIThread;
   audited_ptr<DXResources> mDXR;
   KneeboardState* mKneeboard;
   std::string mPlaceholderText;
@@ -80,13 +86,17 @@ class PlainTextPageSource final : public IPageSource,
 
   // All content as UTF-8; newlines may be \r\n or \n
   std::string mContent;
-  std::string mLastLayoutContent;
-  // First offset that is modified in mContent compared to mLastRenderedContent;
-  // use `dynamic_offset` to indicate unknown
-  std::variant<std::monostate, std::size_t, unknown_offset_t>
-    mFirstModifiedOffset;
-
-  std::vector<RenderedPage> mPages;
+  // If set, used instead of `mContent`
+  std::unique_ptr<Filesystem::MappedFile> mMappedContent;
+  // First offset that is modified in the content since the last layout
+  std::optional<std::size_t> mFirstModifiedOffset;
+
+  std::optional<PlainTextLayout> mLayout;
+  bool mHaveBackgroundLayout {false};
+  // Kept in sync with `mLayout` by `UpdateSearchIndex()`
+  TextSearchIndex mSearchIndex;
+  // The first line that is not yet in `mSearchIndex`
+  TextSearchIndex::Location mSearchIndexEnd;
 
   float mPadding = -1.0f;
   float mRowHeight = -1.0f;
@@ -96,14 +106,17 @@ class PlainTextPageSource final : public IPageSource,
 
   winrt::com_ptr<IDWriteTextFormat> mTextFormat;
 
+  std::string_view GetContent() const;
   std::optional<PageIndex> FindPageIndex(PageID) const;
   void ReplaceContent(std::string_view);
   void AppendContent(std::string_view);
 
   void UpdateLayoutLimits();
-  void PushPage();
 
   void UpdateLayout();
+  void UpdateSearchIndex();
+  /// Lay out the rest of the content on a background thread
+  static fire_and_forget ContinueLayout(std::weak_ptr<PlainTextPageSource>);
 };
 
 }// namespace OpenKneeboard
@@ -7,11 +7,13 @@
 #include <OpenKneeboard/Filesystem.hpp>
 #include <OpenKneeboard/ProfileSettings.hpp>
 #include <OpenKneeboard/Settings.hpp>
+#include <OpenKneeboard/SettingsFiles.hpp>
 
 #include <OpenKneeboard/json/VRSettings.hpp>
 
 #include <OpenKneeboard/dprint.hpp>
 #include <OpenKneeboard/json.hpp>
+#include <OpenKneeboard/tracing.hpp>
 #include <OpenKneeboard/utf8.hpp>
 
 #include <shims/winrt/base.h>
@@ -23,22 +25,30 @@
 
 namespace OpenKneeboard {
 
+namespace {
+
+std::filesystem::path GetFullPath(const std::filesystem::path& path) {
+  return path.is_absolute() ? path : Filesystem::GetSettingsDirectory() / path;
+}
+
+}// namespace
+
 template <class T>
-static void MaybeSetFromJSON(T& out, const std::filesystem::path& path) {
-  const auto fullPath =
-    path.is_absolute() ? path : Filesystem::GetSettingsDirectory() / path;
-  if (!std::filesystem::exists(fullPath)) {
+static void MaybeSetFromJSON(
+  SettingsFiles& files,
+  T& out,
+  const std::filesystem::path& path) {
+  const auto fullPath = GetFullPath(path);
+  const auto json = files.Read(fullPath);
+  if (!json || json->is_null()) {
     return;
   }
 
   try {
-    std::ifstream f(fullPath.c_str());
-    nlohmann::json json;
-    f >> json;
     if constexpr (std::same_as<T, nlohmann::json>) {
-      out = json;
+      out = *json;
     } else {
-      OpenKneeboard::from_json(json, out);
+      OpenKneeboard::from_json(*json, out);
     }
   } catch (const nlohmann::json::exception& e) {
     dprint(
@@ -49,90 +59,65 @@ static void MaybeSetFromJSON(T& out, const std::filesystem::path& path) {
 
 template <class T>
 static void MaybeSaveJSON(
+  SettingsFiles& files,
   const T& parentValue,
   const T& value,
   const std::filesystem::path& path) {
-  const auto fullPath =
-    path.is_absolute() ? path : Filesystem::GetSettingsDirectory() / path;
+  const auto fullPath = GetFullPath(path);
 
-  nlohmann::json j;
   // If a profile already modified a setting, keep that setting even if it
   // matches the parent now
-  if (std::filesystem::exists(fullPath)) {
-    std::ifstream f(fullPath);
-    try {
-      f >> j;
-    } catch (const nlohmann::json::exception& e) {
-      dprint(
-        "Error reading JSON from file '{}': {}", fullPath.string(), e.what());
-    }
-  }
-
-  const auto parentPath = fullPath.parent_path();
-  if (!std::filesystem::exists(parentPath)) {
-    std::filesystem::create_directories(parentPath);
-  }
+  auto j = files.Read(fullPath).value_or(nlohmann::json {});
 
   to_json_with_default(j, parentValue, value);
   if (j.is_object() && j.size() > 0) {
-    std::ofstream f(fullPath);
-    f << std::setw(2) << j << std::endl;
+    files.Write(fullPath, j);
     return;
   }
 
-  if (std::filesystem::exists(fullPath)) {
-    std::filesystem::remove(fullPath);
-  }
+  files.Remove(fullPath);
 }
 
 /** Used for GamesList and TabsList, where we don't want to merge configs -
  * either inherit, or overwrite */
 template <>
 void MaybeSaveJSON<nlohmann::json>(
+  SettingsFiles& files,
   const nlohmann::json& parentValue,
   const nlohmann::json& value,
   const std::filesystem::path& path) {
-  const auto fullPath =
-    path.is_absolute() ? path : Filesystem::GetSettingsDirectory() / path;
+  const auto fullPath = GetFullPath(path);
 
-  if (value == parentValue && std::filesystem::exists(fullPath)) {
-    std::filesystem::remove(fullPath);
+  if (value == parentValue) {
+    files.Remove(fullPath);
     return;
   }
 
-  const auto parentPath = fullPath.parent_path();
-  if (!std::filesystem::exists(parentPath)) {
-    std::filesystem::create_directories(parentPath);
-  }
-
-  std::ofstream f(fullPath);
-  f << std::setw(2) << value << std::endl;
+  files.Write(fullPath, value);
 }
 
 void Settings::Save(
+  SettingsFiles& files,
   const winrt::guid defaultProfile,
   const winrt::guid activeProfile) const {
-  const Settings previousSettings =
-    Settings::Load(defaultProfile, activeProfile);
-
-  if (previousSettings == *this) {
-    return;
-  }
-
+  OPENKNEEBOARD_TraceLoggingScope("Settings::Save()");
+  // Unchanged sections are skipped by `MaybeSaveJSON()`, and changed ones are
+  // written in the background
   Settings parentSettings;
   if (activeProfile != defaultProfile) {
-    parentSettings = Settings::Load(defaultProfile, defaultProfile);
+    parentSettings = Settings::Load(files, defaultProfile, defaultProfile);
   }
 
   const auto profileDir = std::filesystem::path {"Profiles"}
     / ProfileSettings::Profile::GetDirectoryName(activeProfile);
 
 #define IT(cpptype, x) \
-  MaybeSaveJSON(parentSettings.m##x, this->m##x, profileDir / #x ".json");
+  MaybeSaveJSON( \
+    files, parentSettings.m##x, this->m##x, profileDir / #x ".json");
   OPENKNEEBOARD_PER_PROFILE_SETTINGS_SECTIONS
 #undef IT
 #define IT(cpptype, x) \
-  MaybeSaveJSON(parentSettings.m##x, this->m##x, #x ".json");
+  MaybeSaveJSON(files, parentSettings.m##x, this->m##x, #x ".json");
   OPENKNEEBOARD_GLOBAL_SETTINGS_SECTIONS
 #undef IT
 }
@@ -162,16 +147,15 @@ OPENKNEEBOARD_DEFINE_SPARSE_JSON(
 
 #define RESET_IT(cpptype, name, path_suffix) \
   void Settings::Reset##name##Section( \
-    const winrt::guid defaultProfile, const winrt::guid activeProfile) { \
+    SettingsFiles& files, \
+    const winrt::guid defaultProfile, \
+    const winrt::guid activeProfile) { \
     if (defaultProfile == activeProfile) { \
       m##name = {}; \
     } else { \
-      m##name = Settings::Load(defaultProfile, defaultProfile).m##name; \
-    } \
-    const auto path = Filesystem::GetSettingsDirectory() / path_suffix; \
-    if (std::filesystem::exists(path)) { \
-      std::filesystem::remove(path); \
+      m##name = Settings::Load(files, defaultProfile, defaultProfile).m##name; \
     } \
+    files.Remove(Filesystem::GetSettingsDirectory() / path_suffix); \
   }
 #define IT(cpptype, name) \
   RESET_IT( \
@@ -188,6 +172,7 @@ OPENKNEEBOARD_GLOBAL_SETTINGS_SECTIONS
 
 // v1.2 -> v1.3
 static void MigrateToProfiles(
+  SettingsFiles& files,
   Settings& settings,
   const winrt::guid defaultProfile,
   const winrt::guid activeProfile) {
@@ -202,14 +187,14 @@ static void MigrateToProfiles(
 
   auto legacySettingsFile =
     Filesystem::GetSettingsDirectory() / "Settings.json";
-  if (!std::filesystem::exists(legacySettingsFile)) {
+  if (!files.Exists(legacySettingsFile)) {
     return;
   }
 
   dprint("Migrating from legacy Settings.json");
-  MaybeSetFromJSON(settings, legacySettingsFile);
-  std::filesystem::remove(legacySettingsFile);
-  settings.Save(defaultProfile, defaultProfile);
+  MaybeSetFromJSON(files, settings, legacySettingsFile);
+  files.Remove(legacySettingsFile);
+  settings.Save(files, defaultProfile, defaultProfile);
 }
 
 // v1.7 introduced 'ViewsSettings'
@@ -246,30 +231,32 @@ static void MigrateToViewsSettings(Settings& settings) {
 }
 
 Settings Settings::Load(
+  SettingsFiles& files,
   const winrt::guid defaultProfile,
   const winrt::guid activeProfile) try {
   dprint("Reading profile '{}' from disk", activeProfile);
   std::optional<Settings> parentSettings;
   Settings settings;
 
-  MigrateToProfiles(settings, defaultProfile, activeProfile);
+  MigrateToProfiles(files, settings, defaultProfile, activeProfile);
 
   if (activeProfile != defaultProfile) {
     dprint(
       "Recursing to profile {}'s parent profile {}",
       activeProfile,
       defaultProfile);
-    settings = Settings::Load(defaultProfile, defaultProfile);
+    settings = Settings::Load(files, defaultProfile, defaultProfile);
     parentSettings = settings;
   }
 
   const auto profileDir = Filesystem::GetSettingsDirectory() / "Profiles"
     / ProfileSettings::Profile::GetDirectoryName(activeProfile);
 
-#define IT(cpptype, x) MaybeSetFromJSON(settings.m##x, profileDir / #x ".json");
+#define IT(cpptype, x) \
+  MaybeSetFromJSON(files, settings.m##x, profileDir / #x ".json");
   OPENKNEEBOARD_PER_PROFILE_SETTINGS_SECTIONS
 #undef IT
-#define IT(cpptype, x) MaybeSetFromJSON(settings.m##x, #x ".json");
+#define IT(cpptype, x) MaybeSetFromJSON(files, settings.m##x, #x ".json");
   OPENKNEEBOARD_GLOBAL_SETTINGS_SECTIONS
 #undef IT
 
@@ -277,18 +264,18 @@ Settings Settings::Load(
     parentSettings
     && settings.mApp.mDeprecated.mDualKneeboards
       != parentSettings->mApp.mDeprecated.mDualKneeboards
-    && (!std::filesystem::exists(profileDir / "Views.json"))) {
+    && (!files.Exists(profileDir / "Views.json"))) {
     MigrateToViewsSettings(settings);
   }
 
   // Split up and moved out of profiles in v1.9 (#547)
   const auto perProfileAppSettings = profileDir / "App.json";
-  if (std::filesystem::exists(perProfileAppSettings)) {
-    if (!std::filesystem::exists(profileDir / "UI.json")) {
-      MaybeSetFromJSON(settings.mUI, perProfileAppSettings);
+  if (files.Exists(perProfileAppSettings)) {
+    if (!files.Exists(profileDir / "UI.json")) {
+      MaybeSetFromJSON(files, settings.mUI, perProfileAppSettings);
     }
-    MaybeSetFromJSON(settings.mApp, perProfileAppSettings);
-    std::filesystem::remove(perProfileAppSettings);
+    MaybeSetFromJSON(files, settings.mApp, perProfileAppSettings);
+    files.Remove(perProfileAppSettings);
   }
 
   return settings;
@@ -0,0 +1,136 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/SettingsFiles.hpp>
+
+#include <OpenKneeboard/dprint.hpp>
+#include <OpenKneeboard/tracing.hpp>
+
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <functional>
+
+namespace OpenKneeboard {
+
+namespace {
+
+std::optional<std::filesystem::file_time_type> GetLastWriteTime(
+  const std::filesystem::path& path) {
+  std::error_code ec;
+  const auto ret = std::filesystem::last_write_time(path, ec);
+  if (ec) {
+    return std::nullopt;
+  }
+  return ret;
+}
+
+}// namespace
+
+SettingsFiles::SettingsFiles()
+  : mWriter(
+      DebouncedFileWriter::Options {},
+      std::bind_front(&SettingsFiles::OnWritten, this)) {}
+
+SettingsFiles::~SettingsFiles() = default;
+
+std::optional<nlohmann::json> SettingsFiles::Read(
+  const std::filesystem::path& path) {
+  std::unique_lock lock(mMutex);
+  return this->ReadLocked(path);
+}
+
+bool SettingsFiles::Exists(const std::filesystem::path& path) {
+  return this->Read(path).has_value();
+}
+
+void SettingsFiles::Write(
+  const std::filesystem::path& path,
+  const nlohmann::json& json) {
+  std::unique_lock lock(mMutex);
+  auto& known = mFiles[path].mJSON;
+  if (known == json) {
+    return;
+  }
+  known = json;
+  mWriter.Write(path, std::format("{}\n", json.dump(2)));
+}
+
+void SettingsFiles::Remove(const std::filesystem::path& path) {
+  std::unique_lock lock(mMutex);
+  if (!this->ReadLocked(path)) {
+    return;
+  }
+  mFiles[path].mJSON = std::nullopt;
+  mWriter.Remove(path);
+}
+
+void SettingsFiles::Flush() { mWriter.Flush(); }
+
+void SettingsFiles::OnWritten(
+  const std::filesystem::path& path,
+  const DebouncedFileWriter::WriteResult& result) {
+  TraceLoggingWrite(
+    gTraceProvider,
+    "SettingsFiles/Written",
+    TraceLoggingValue(path.c_str(), "Path"),
+    TraceLoggingValue(result.mSucceeded, "Succeeded"),
+    TraceLoggingValue(result.mBytes, "Bytes"),
+    TraceLoggingValue(
+      std::chrono::duration_cast<std::chrono::microseconds>(result.mLatency)
+        .count(),
+      "LatencyMicroseconds"),
+    TraceLoggingValue(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+        result.mWriteDuration)
+        .count(),
+      "WriteMicroseconds"));
+  if (!result.mSucceeded) {
+    dprint.Warning(
+      "Failed to save settings file '{}': {}", path.string(), result.mError);
+    return;
+  }
+
+  // The file on disk now matches what we wrote, so don't re-read it just
+  // because its last write time changed. If there's a newer write pending,
+  // it's still pending, so `ReadLocked()` keeps using `mJSON`.
+  std::unique_lock lock(mMutex);
+  if (const auto it = mFiles.find(path); it != mFiles.end()) {
+    it->second.mLastWriteTime = GetLastWriteTime(path);
+  }
+}
+
+std::optional<nlohmann::json> SettingsFiles::ReadLocked(
+  const std::filesystem::path& path) {
+  const auto lastWriteTime = GetLastWriteTime(path);
+  if (const auto it = mFiles.find(path); it != mFiles.end()) {
+    // If we have a write pending or in progress, what we have is newer than
+    // the file
+    if (
+      it->second.mLastWriteTime == lastWriteTime || mWriter.IsPending(path)) {
+      return it->second.mJSON;
+    }
+  }
+
+  auto& file = mFiles[path];
+  file = {.mLastWriteTime = lastWriteTime};
+  auto& known = file.mJSON;
+  if (!lastWriteTime) {
+    return known;
+  }
+
+  // If the file is unreadable, we still need to know it exists, so that
+  // it gets replaced or removed
+  known = nlohmann::json {};
+  try {
+    std::ifstream f(path.c_str());
+    f >> *known;
+  } catch (const nlohmann::json::exception& e) {
+    dprint("Error reading JSON from file '{}': {}", path.string(), e.what());
+    OPENKNEEBOARD_BREAK;
+    *known = {};
+  }
+  return known;
+}
+
+}// namespace OpenKneeboard
@@ -10,6 +10,7 @@ target_link_libraries(
   OpenKneeboard-D3D11
   OpenKneeboard-SHM-Client-D3D11
   OpenKneeboard-VRKneeboard
+  OpenKneeboard-VROverlayChangeTracker
   OpenKneeboard-config
   ThirdParty::DirectXTK
   ThirdParty::OpenVR
@@ -20,6 +21,7 @@ target_link_libraries(
   PRIVATE
   OpenKneeboard-dprint
   OpenKneeboard-EnumerateProcesses
+  OpenKneeboard-Metrics
 )
 target_include_directories(
   OpenKneeboard-SteamVRKneeboard
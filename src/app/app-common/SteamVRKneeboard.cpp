@@ -7,6 +7,7 @@
 #include <OpenKneeboard/D3D11.hpp>
 #include <OpenKneeboard/DXResources.hpp>
 #include <OpenKneeboard/EnumerateProcesses.hpp>
+#include <OpenKneeboard/Metrics.hpp>
 #include <OpenKneeboard/RayIntersectsRect.hpp>
 #include <OpenKneeboard/SHM.hpp>
 #include <OpenKneeboard/SHM/ActiveConsumers.hpp>
@@ -24,6 +25,7 @@
 #include <directxtk/SimpleMath.h>
 #include <felly/numeric_cast.hpp>
 
+#include <bit>
 #include <filesystem>
 #include <source_location>
 #include <thread>
@@ -97,6 +99,7 @@ void SteamVRKneeboard::Reset() {
 
   dprint(__FUNCTION__);
 
+  mChangeTracker.Invalidate();
   vr::VR_Shutdown();
   mIVRSystem = {};
   mIVROverlay = {};
@@ -184,6 +187,7 @@ static bool IsOtherVRActive() {
 
 void SteamVRKneeboard::Tick() {
   OPENKNEEBOARD_TraceLoggingScope("SteamVRKneeboard::Tick()");
+  const auto startTime = SHM::ConsumerTelemetry::Clock::now();
   vr::VREvent_t event;
   for (const auto& layerState: mLayers) {
     if (!layerState.mOverlay) {
@@ -226,16 +230,73 @@ void SteamVRKneeboard::Tick() {
     this->GetLayers(frame->mConfig, frame->mLayers, hmdPose);
 
   auto ctx = mDXR.mD3D11ImmediateContext.get();
-  std::vector<size_t> activeLayers;
 
   const auto baseTint = frame->mConfig.mTint;
+  const VROverlayChangeTracker::FrameID frameID {
+    .mTexture = reinterpret_cast<uintptr_t>(frame->mTexture),
+    .mFenceValue = frame->mFenceIn,
+  };
+
+  struct PendingUpdate {
+    VROverlayChangeTracker::LayerUpdate mUpdate;
+    VROverlayChangeTracker::LayerPlacement mPlacement;
+  };
+  std::array<PendingUpdate, MaxViewCount> pendingUpdates {};
+  uint64_t textureUpdates = 0;
 
   for (size_t layerIndex = 0; layerIndex < vrLayers.size(); ++layerIndex) {
     this->InitializeLayer(layerIndex);
+    if (!mIVROverlay) {
+      return;
+    }
     const auto [layer, renderParams] = vrLayers.at(layerIndex);
     auto& layerState = mLayers.at(layerIndex);
 
-    activeLayers.push_back(layerIndex);
+    const DirectX::XMVECTORF32 layerTint {
+      baseTint[0] * renderParams.mKneeboardOpacity,
+      baseTint[1] * renderParams.mKneeboardOpacity,
+      baseTint[2] * renderParams.mKneeboardOpacity,
+      baseTint[3] * renderParams.mKneeboardOpacity,
+    };
+
+    // Transpose to fit OpenVR's in-memory layout
+    // clang-format off
+    const auto transform = (
+      Matrix::CreateFromQuaternion(renderParams.mKneeboardPose.mOrientation)
+      * Matrix::CreateTranslation(renderParams.mKneeboardPose.mPosition)
+    ).Transpose();
+    // clang-format on
+
+    const auto& sourceRect = layer->mVR.mLocationOnTexture;
+    auto& pending = pendingUpdates.at(layerIndex);
+    pending.mPlacement = {
+      .mTransform = std::bit_cast<std::array<float, 12>>(
+        *reinterpret_cast<const vr::HmdMatrix34_t*>(&transform)),
+      .mWidthInMeters = renderParams.mKneeboardSize.x,
+    };
+    pending.mUpdate = mChangeTracker.Update(
+      layerIndex,
+      frameID,
+      {
+        .mSourceRect = {
+          sourceRect.mOffset.mX,
+          sourceRect.mOffset.mY,
+          sourceRect.mSize.mWidth,
+          sourceRect.mSize.mHeight,
+        },
+        .mTint = {
+          layerTint.f[0],
+          layerTint.f[1],
+          layerTint.f[2],
+          layerTint.f[3],
+        },
+      },
+      pending.mPlacement);
+    if (!pending.mUpdate.mTexture) {
+      // The OpenVR texture already has this frame, with these parameters
+      continue;
+    }
+    ++textureUpdates;
 
     // Copy the texture as for interoperability with other systems
     // (e.g. DirectX12) we use SHARED_NTHANDLE, but SteamVR doesn't
@@ -249,21 +310,14 @@ void SteamVRKneeboard::Tick() {
     ctx->ClearRenderTargetView(
       mRenderTargetView.get(), DirectX::Colors::Transparent);
 
-    const DirectX::XMVECTORF32 layerTint {
-      baseTint[0] * renderParams.mKneeboardOpacity,
-      baseTint[1] * renderParams.mKneeboardOpacity,
-      baseTint[2] * renderParams.mKneeboardOpacity,
-      baseTint[3] * renderParams.mKneeboardOpacity,
-    };
-
-    const auto& imageSize = layer->mVR.mLocationOnTexture.mSize;
+    const auto& imageSize = sourceRect.mSize;
     mSpriteBatch->Begin(mRenderTargetView.get(), MaxViewRenderSize);
     mSpriteBatch->Draw(
       frame->mShaderResourceView,
-      layer->mVR.mLocationOnTexture,
+      sourceRect,
       {
         {0, 0},
-        layer->mVR.mLocationOnTexture.mSize,
+        imageSize,
       },
       layerTint);
     mSpriteBatch->End();
@@ -286,15 +340,13 @@ void SteamVRKneeboard::Tick() {
       mBufferTexture.get(),
       0,
       &sourceBox);
-
-    layerState.mFenceValue = ++mFenceValue;
-    winrt::check_hresult(ctx->Signal(mFence.get(), layerState.mFenceValue));
   }
 
-  for (const auto& layerIndex: activeLayers) {
-    const auto& [layer, renderParams] = vrLayers.at(layerIndex);
-    auto& layerState = mLayers.at(layerIndex);
+  OPENKNEEBOARD_MetricsCount("SteamVR texture updates", textureUpdates);
+  OPENKNEEBOARD_MetricsCount(
+    "SteamVR skipped texture updates", vrLayers.size() - textureUpdates);
 
+  if (textureUpdates > 0) {
     // SteamVR has no synchronization support, so an explicit CPU/GPU sync is
     // needed.
     //
@@ -302,8 +354,9 @@ void SteamVRKneeboard::Tick() {
     // when there are not regular page dirty events. For example:
     // - disable/hide the clock/footer
     // - remove any window capture or browser tabs
-    winrt::check_hresult(mFence->SetEventOnCompletion(
-      layerState.mFenceValue, mGPUFlushEvent.get()));
+    winrt::check_hresult(ctx->Signal(mFence.get(), ++mFenceValue));
+    winrt::check_hresult(
+      mFence->SetEventOnCompletion(mFenceValue, mGPUFlushEvent.get()));
     {
       OPENKNEEBOARD_TraceLoggingScopedActivity(
         waitActivity, "SteamVRKneeboard::Tick()/WaitForSingleObject");
@@ -319,35 +372,38 @@ void SteamVRKneeboard::Tick() {
         OPENKNEEBOARD_BREAK;
       }
     }
+  }
 
-    OVERLAY_CHECK(
-      SetOverlayWidthInMeters,
-      layerState.mOverlay,
-      renderParams.mKneeboardSize.x);
-
-    // Transpose to fit OpenVR's in-memory layout
-    // clang-format off
-    const auto transform = (
-      Matrix::CreateFromQuaternion(renderParams.mKneeboardPose.mOrientation)
-      * Matrix::CreateTranslation(renderParams.mKneeboardPose.mPosition)
-    ).Transpose();
-    // clang-format on
-
-    OVERLAY_CHECK(
-      SetOverlayTransformAbsolute,
-      layerState.mOverlay,
-      vr::TrackingUniverseStanding,
-      reinterpret_cast<const vr::HmdMatrix34_t*>(&transform));
-
-    const auto& imageSize = layer->mVR.mLocationOnTexture.mSize;
-    vr::VRTextureBounds_t textureBounds {
-      0.0f,
-      0.0f,
-      static_cast<float>(imageSize.mWidth) / MaxViewRenderSize.mWidth,
-      static_cast<float>(imageSize.mHeight) / MaxViewRenderSize.mHeight,
-    };
+  for (size_t layerIndex = 0; layerIndex < vrLayers.size(); ++layerIndex) {
+    const auto& [update, placement] = pendingUpdates.at(layerIndex);
+    const auto& layerState = mLayers.at(layerIndex);
+
+    if (update.mPlacement) {
+      OVERLAY_CHECK(
+        SetOverlayWidthInMeters,
+        layerState.mOverlay,
+        placement.mWidthInMeters);
+      OVERLAY_CHECK(
+        SetOverlayTransformAbsolute,
+        layerState.mOverlay,
+        vr::TrackingUniverseStanding,
+        reinterpret_cast<const vr::HmdMatrix34_t*>(
+          placement.mTransform.data()));
+    }
 
-    OVERLAY_CHECK(SetOverlayTextureBounds, layerState.mOverlay, &textureBounds);
+    if (update.mTexture) {
+      const auto& imageSize
+        = vrLayers.at(layerIndex).mLayerConfig->mVR.mLocationOnTexture.mSize;
+      vr::VRTextureBounds_t textureBounds {
+        0.0f,
+        0.0f,
+        static_cast<float>(imageSize.mWidth) / MaxViewRenderSize.mWidth,
+        static_cast<float>(imageSize.mHeight) / MaxViewRenderSize.mHeight,
+      };
+
+      OVERLAY_CHECK(
+        SetOverlayTextureBounds, layerState.mOverlay, &textureBounds);
+    }
   }
   for (uint8_t i = 0; i < MaxViewCount; ++i) {
     if (!mLayers.at(i).mOverlay) {
@@ -375,6 +431,22 @@ void SteamVRKneeboard::Tick() {
       continue;
     }
   }
+
+  uint32_t visibleLayers {};
+  for (size_t layerIndex = 0; layerIndex < vrLayers.size(); ++layerIndex) {
+    if (mLayers.at(layerIndex).mVisible) {
+      visibleLayers |= 1ui32
+        << (vrLayers.at(layerIndex).mLayerConfig - frame->mLayers.data());
+    }
+  }
+  SHM::ActiveConsumers::RecordFrame(
+    SHM::ConsumerKind::OpenVR,
+    {
+      .mStartTime = startTime,
+      .mEndTime = SHM::ConsumerTelemetry::Clock::now(),
+      .mSHMFrameNumber = frame->mFrameNumber,
+      .mVisibleLayers = visibleLayers,
+    });
 }
 
 void SteamVRKneeboard::HideAllOverlays() {
@@ -504,6 +576,7 @@ void SteamVRKneeboard::InitializeLayer(size_t layerIndex) {
   auto name = std::format("OpenKneeboard {}", layerIndex + 1);
 
   OVERLAY_CHECK(CreateOverlay, key.c_str(), name.c_str(), &layerState.mOverlay);
+  mChangeTracker.InvalidateLayer(layerIndex);
 
   dprint("Created OpenVR overlay {}", layerIndex);
 
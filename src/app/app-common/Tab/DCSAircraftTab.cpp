@@ -8,7 +8,7 @@
 #include <OpenKneeboard/DCSAircraftTab.hpp>
 #include <OpenKneeboard/DCSEvents.hpp>
 #include <OpenKneeboard/Filesystem.hpp>
-#include <OpenKneeboard/FolderPageSource.hpp>
+#include <OpenKneeboard/FolderPageSourceRegistry.hpp>
 
 #include <OpenKneeboard/dprint.hpp>
 #include <OpenKneeboard/format/filesystem.hpp>
@@ -168,8 +168,7 @@ OpenKneeboard::fire_and_forget DCSAircraftTab::OnAPIEvent(
   std::vector<std::shared_ptr<IPageSource>> delegates;
   for (auto& path: paths) {
     delegates.push_back(
-      std::static_pointer_cast<IPageSource>(
-        co_await FolderPageSource::Create(mDXR, mKneeboard, path)));
+      co_await mKneeboard->GetFolderPageSourceRegistry()->Acquire(path));
   }
   co_await this->SetDelegates(delegates);
 }
@@ -9,8 +9,8 @@
 #include <OpenKneeboard/DCSBriefingTab.hpp>
 #include <OpenKneeboard/DCSEvents.hpp>
 #include <OpenKneeboard/DCSExtractedMission.hpp>
+#include <OpenKneeboard/DCSMissionDigestCache.hpp>
 #include <OpenKneeboard/ImageFilePageSource.hpp>
-#include <OpenKneeboard/Lua.hpp>
 #include <OpenKneeboard/NavigationTab.hpp>
 #include <OpenKneeboard/PlainTextPageSource.hpp>
 
@@ -72,72 +72,20 @@ task<void> DCSBriefingTab::Reload() noexcept {
   }
 
   const auto root = mMission->GetExtractedPath();
-  if (!std::filesystem::exists(root / "mission")) {
-    co_return;
-  }
-
-  const auto localized = root / "l10n" / "DEFAULT";
-
-  LuaState lua;
-  lua.DoFile(root / "mission");
-  if (std::filesystem::exists(localized / "dictionary")) {
-    lua.DoFile(localized / "dictionary");
+  if (mDigestMission != mMission) {
+    mDigest = mKneeboard->GetDCSMissionDigestCache()->Load(root);
+    mDigestMission = mMission;
   }
-  if (std::filesystem::exists(localized / "mapResource")) {
-    lua.DoFile(localized / "MapResource");
+  if (!mDigest) {
+    co_return;
   }
 
-  const auto mission = lua.GetGlobal("mission");
-  const auto dictionary = lua.GetGlobal("dictionary");
-  const auto mapResource = lua.GetGlobal("mapResource");
-
-  std::vector<std::pair<std::string_view, std::function<void()>>>
-    sectionLoaders {
-      {
-        "SetMissionImages",
-        std::bind_front(
-          &DCSBriefingTab::SetMissionImages,
-          this,
-          mission,
-          mapResource,
-          localized),
-      },
-      {
-        "PushMissionOverview",
-        std::bind_front(
-          &DCSBriefingTab::PushMissionOverview, this, mission, dictionary),
-      },
-      {
-        "PushMissionSituation",
-        std::bind_front(
-          &DCSBriefingTab::PushMissionSituation, this, mission, dictionary),
-      },
-      {
-        "PushMissionObjective",
-        std::bind_front(
-          &DCSBriefingTab::PushMissionObjective, this, mission, dictionary),
-      },
-      {
-        "PushMissionWeather",
-        std::bind_front(&DCSBriefingTab::PushMissionWeather, this, mission),
-      },
-      {
-        "PushBullseyeData",
-        std::bind_front(&DCSBriefingTab::PushBullseyeData, this, mission),
-      },
-    };
-
-  for (const auto& [name, loader]: sectionLoaders) {
-    try {
-      loader();
-    } catch (const LuaIndexError& e) {
-      dprint("LuaIndexError in {}: {}", name, e.what());
-    } catch (const LuaTypeError& e) {
-      dprint("LuaTypeError in {}: {}", name, e.what());
-    } catch (const LuaError& e) {
-      dprint("LuaError in {}: {}", name, e.what());
-    }
-  }
+  this->SetMissionImages(*mDigest, root / "l10n" / "DEFAULT");
+  this->PushMissionOverview(*mDigest);
+  this->PushMissionSituation(*mDigest);
+  this->PushMissionObjective(*mDigest);
+  this->PushMissionWeather(*mDigest);
+  this->PushBullseyeData(*mDigest);
 
   this->evContentChangedEvent.Emit();
 }
@@ -235,4 +183,9 @@ std::optional<std::string> DCSBriefingTab::GetPersistentIDForPage(
   return std::nullopt;
 }
 
+IPageSource::PersistentIDs DCSBriefingTab::GetPersistentIDsForAllPages() const {
+  // As above
+  return {};
+}
+
 }// namespace OpenKneeboard
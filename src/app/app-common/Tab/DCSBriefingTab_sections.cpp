@@ -13,7 +13,6 @@
 #include <OpenKneeboard/DCSGrid.hpp>
 #include <OpenKneeboard/DCSMagneticModel.hpp>
 #include <OpenKneeboard/ImageFilePageSource.hpp>
-#include <OpenKneeboard/Lua.hpp>
 #include <OpenKneeboard/PlainTextPageSource.hpp>
 
 #include <OpenKneeboard/dprint.hpp>
@@ -29,25 +28,10 @@ using namespace OpenKneeboard::Coordinates;
 
 namespace OpenKneeboard {
 
-static std::string GetCountries(const LuaRef& countries) {
-  std::string ret;
-  for (auto&& [i, country]: countries) {
-    if (!(country.contains("static") && country.contains("helicopter")
-          && country.contains("vehicle") && country.contains("plane"))) {
-      continue;
-    }
-    if (!ret.empty()) {
-      ret += ", ";
-    }
-    ret += country["name"].Get<std::string>();
-  }
-  return ret;
-}
-
 struct DCSBriefingWind {
-  DCSBriefingWind(const LuaRef& data) {
-    mSpeed = data["speed"];
-    mDirection = data["dir"];
+  DCSBriefingWind(const DCSMissionDigest::Wind& data) {
+    mSpeed = data.mSpeed;
+    mDirection = data.mDirection;
     mStandardDirection = (180 + mDirection) % 360;
     if (mDirection == 0) {
       mDirection = 360;
@@ -65,56 +49,36 @@ struct DCSBriefingWind {
 };
 
 void DCSBriefingTab::SetMissionImages(
-  const LuaRef& mission,
-  const LuaRef& mapResource,
-  const std::filesystem::path& resourcePath) try {
+  const DCSMissionDigest& digest,
+  const std::filesystem::path& resourcePath) {
   std::vector<std::filesystem::path> images;
-
-  const auto force = mission.at(
-    CoalitionKey("pictureFileNameN", "pictureFileNameR", "pictureFileNameB"));
-  for (auto&& [i, resourceName]: force) {
-    // `resourceName` will almost always be a string starting with `ResKey_`,
-    // which will be an entry in the `mapResource` dictionary created in
-    // `l10n\DEFAULT\mapResource`; this isn't required, and some missions
-    // just containing a raw filename instead.
-    const auto fileName = mapResource.contains(resourceName)
-      ? mapResource[resourceName].Get<std::string>()
-      : resourceName.Get<std::string>();
+  for (const auto& fileName: this->GetCoalition(digest).mImages) {
     const auto path = resourcePath / fileName;
     if (std::filesystem::is_regular_file(path)) {
       images.push_back(path);
     }
   }
   mImagePages->SetPaths(images);
-} catch (const LuaIndexError& e) {
-  dprint("LuaIndexError when loading images: {}", e.what());
 }
 
-void DCSBriefingTab::PushMissionOverview(
-  const LuaRef& mission,
-  const LuaRef& dictionary) try {
-  const std::string title = GetMissionText(mission, dictionary, "sortie");
+void DCSBriefingTab::PushMissionOverview(const DCSMissionDigest& digest) {
+  const auto& title = digest.mTitle;
+  const auto& startDate = digest.mStartDate;
+  const auto& startSecondsSinceMidnight = digest.mStartTime;
+  if (!(title && startDate && startSecondsSinceMidnight)) {
+    return;
+  }
 
-  const auto startDate = mission["date"];
-  const auto startSecondsSinceMidnight = mission["start_time"];
   const auto startDateTime = std::format(
     "{:04d}-{:02d}-{:02d} {:%T}",
-    startDate["Year"].Get<uint16_t>(),
-    startDate["Month"].Get<uint16_t>(),
-    startDate["Day"].Get<uint16_t>(),
-    std::chrono::seconds {
-      startSecondsSinceMidnight.Get<unsigned int>(),
-    });
+    startDate->mYear,
+    startDate->mMonth,
+    startDate->mDay,
+    std::chrono::seconds {*startSecondsSinceMidnight});
 
-  std::string redCountries = _("Unknown.");
-  try {
-    redCountries = GetCountries(mission["coalition"]["red"]["country"]);
-  } catch (const LuaIndexError&) {}
-
-  std::string blueCountries = _("Unknown.");
-  try {
-    blueCountries = GetCountries(mission["coalition"]["blue"]["country"]);
-  } catch (const LuaIndexError&) {}
+  const auto& [neutral, red, blue] = digest.mCoalitions;
+  const std::string redCountries = red.mCountries.value_or(_("Unknown."));
+  const std::string blueCountries = blue.mCountries.value_or(_("Unknown."));
 
   std::string_view alliedCountries;
   std::string_view enemyCountries;
@@ -138,24 +102,24 @@ void DCSBriefingTab::PushMissionOverview(
         "Start at: {}\n"
         "My side:  {}\n"
         "Enemies:  {}"),
-      title,
+      *title,
       startDateTime,
       alliedCountries,
       enemyCountries));
-} catch (const LuaIndexError& e) {
-  dprint("LuaIndexError when loading mission overview: {}", e.what());
 }
 
-void DCSBriefingTab::PushMissionWeather(const LuaRef& mission) try {
-  const auto weather = mission["weather"];
-  const auto temperature = weather["season"]["temperature"].Get<int>();
-  const auto qnhMmHg = weather["qnh"].Get<float>();
+void DCSBriefingTab::PushMissionWeather(const DCSMissionDigest& digest) {
+  const auto& weather = digest.mWeather;
+  if (!weather) {
+    return;
+  }
+  const auto temperature = weather->mTemperature;
+  const auto qnhMmHg = weather->mQNH;
   const auto qnhInHg = qnhMmHg / 25.4;
-  const auto cloudBase = weather["clouds"]["base"].Get<int>();
-  const auto wind = weather["wind"];
-  DCSBriefingWind windAtGround {wind["atGround"]};
-  DCSBriefingWind windAt2000 {wind["at2000"]};
-  DCSBriefingWind windAt8000 {wind["at8000"]};
+  const auto cloudBase = weather->mCloudBase;
+  DCSBriefingWind windAtGround {weather->mWindAtGround};
+  DCSBriefingWind windAt2000 {weather->mWindAt2000};
+  DCSBriefingWind windAt8000 {weather->mWindAt8000};
 
   mTextPages->PushMessage(
     std::format(
@@ -181,37 +145,36 @@ void DCSBriefingTab::PushMissionWeather(const LuaRef& mission) try {
       windAt8000.mSpeed,
       windAt8000.mDirection,
       windAt8000.mStandardDirection));
-
-} catch (const LuaIndexError& e) {
-  dprint("LuaIndexError when loading mission weather: {}", e.what());
 }
 
-void DCSBriefingTab::PushBullseyeData(const LuaRef& mission) try {
+void DCSBriefingTab::PushBullseyeData(const DCSMissionDigest& digest) {
   if (!mDCSState.mOrigin) {
     return;
   }
   if (mDCSState.mCoalition == DCSEvents::Coalition::Neutral) {
     return;
   }
+  const auto& startDate = digest.mStartDate;
+  const auto& xyBulls = this->GetCoalition(digest).mBullseye;
+  if (!(startDate && xyBulls)) {
+    return;
+  }
 
   double magVar = 0.0f;
 
   const auto& origin = mDCSState.mOrigin;
   DCSGrid grid(origin->mLat, origin->mLong);
 
-  const auto key = CoalitionKey("neutral", "red", "blue");
-  const auto startDate = mission.at("date");
-  const auto xyBulls = mission["coalition"][key]["bullseye"];
   const auto [bullsLat, bullsLong] = grid.LatLongFromXY(
-    xyBulls["x"].Get<DCSEvents::GeoReal>(),
-    xyBulls["y"].Get<DCSEvents::GeoReal>());
+    static_cast<DCSEvents::GeoReal>(xyBulls->mX),
+    static_cast<DCSEvents::GeoReal>(xyBulls->mY));
 
   DCSMagneticModel magModel(mInstallationPath);
   magVar = magModel.GetMagneticVariation(
     std::chrono::year_month_day {
-      std::chrono::year {startDate["Year"].Get<int>()},
-      std::chrono::month {startDate["Month"].Get<unsigned>()},
-      std::chrono::day {startDate["Day"].Get<unsigned>()},
+      std::chrono::year {startDate->mYear},
+      std::chrono::month {startDate->mMonth},
+      std::chrono::day {startDate->mDay},
     },
     static_cast<float>(bullsLat),
     static_cast<float>(bullsLong));
@@ -234,16 +197,15 @@ void DCSBriefingTab::PushBullseyeData(const LuaRef& mission) try {
       MGRSFormat(bullsLat, bullsLong),
       magVar));
 
-  if (!mDCSState.mAircraft.starts_with("A-10C")) {
+  const auto& weather = digest.mWeather;
+  if (!(weather && mDCSState.mAircraft.starts_with("A-10C"))) {
     return;
   }
 
-  const auto weather = mission["weather"];
-  const auto wind = weather["wind"];
-  const auto temperature = weather["season"]["temperature"].Get<int>();
-  DCSBriefingWind windAtGround {wind["atGround"]};
-  DCSBriefingWind windAt2000 {wind["at2000"]};
-  DCSBriefingWind windAt8000 {wind["at8000"]};
+  const auto temperature = weather->mTemperature;
+  DCSBriefingWind windAtGround {weather->mWindAtGround};
+  DCSBriefingWind windAt2000 {weather->mWindAt2000};
+  DCSBriefingWind windAt8000 {weather->mWindAt8000};
 
   mTextPages->PushMessage(
     std::format(
@@ -278,52 +240,31 @@ void DCSBriefingTab::PushBullseyeData(const LuaRef& mission) try {
       windAt8000.mStandardDirection - magVar,
       windAt8000.mSpeedInKnots,
       temperature - (2 * 26)));
-} catch (const LuaIndexError& e) {
-  dprint("LuaIndexError when loading mission bullseye data: {}", e.what());
 }
 
-std::string DCSBriefingTab::GetMissionText(
-  const LuaRef& mission,
-  const LuaRef& dictionary,
-  const char* key) {
-  auto mission_value = mission[key].Get<std::string>();
-  if (mission_value.starts_with("DictKey_")) {
-    return dictionary[mission[key]].Get<std::string>();
-  } else {
-    return mission_value;
+void DCSBriefingTab::PushMissionSituation(const DCSMissionDigest& digest) {
+  if (!digest.mSituation) {
+    return;
   }
-}
-
-void DCSBriefingTab::PushMissionSituation(
-  const LuaRef& mission,
-  const LuaRef& dictionary) try {
   mTextPages->PushMessage(
     std::format(
       _("SITUATION\n"
         "\n"
         "{}"),
-      GetMissionText(mission, dictionary, "descriptionText")));
-} catch (const LuaIndexError& e) {
-  dprint("LuaIndexError when loading mission situation: {}", e.what());
+      *digest.mSituation));
 }
 
-void DCSBriefingTab::PushMissionObjective(
-  const LuaRef& mission,
-  const LuaRef& dictionary) try {
+void DCSBriefingTab::PushMissionObjective(const DCSMissionDigest& digest) {
+  const auto& task = this->GetCoalition(digest).mTask;
+  if (!task) {
+    return;
+  }
   mTextPages->PushMessage(
     std::format(
       _("OBJECTIVE\n"
         "\n"
         "{}"),
-      GetMissionText(
-        mission,
-        dictionary,
-        CoalitionKey(
-          "descriptionNeutralTask",
-          "descriptionRedTask",
-          "descriptionBlueTask"))));
-} catch (const LuaIndexError& e) {
-  dprint("LuaIndexError when loading mission objective: {}", e.what());
+      *task));
 }
 
 }// namespace OpenKneeboard
@@ -8,7 +8,7 @@
 #include <OpenKneeboard/DCSEvents.hpp>
 #include <OpenKneeboard/DCSExtractedMission.hpp>
 #include <OpenKneeboard/DCSMissionTab.hpp>
-#include <OpenKneeboard/FolderPageSource.hpp>
+#include <OpenKneeboard/FolderPageSourceRegistry.hpp>
 
 #include <OpenKneeboard/dprint.hpp>
 
@@ -67,7 +67,8 @@ task<void> DCSMissionTab::Reload() {
   for (const auto& path: paths) {
     if (std::filesystem::exists(root / path)) {
       sources.push_back(
-        co_await FolderPageSource::Create(mDXR, mKneeboard, root / path));
+        co_await mKneeboard->GetFolderPageSourceRegistry()->Acquire(
+          root / path));
       mDebugInformation += std::format("\u2714 miz:\\{}\n", to_utf8(path));
     } else {
       mDebugInformation += std::format("\u274c miz:\\{}\n", to_utf8(path));
@@ -96,6 +97,11 @@ std::optional<std::string> DCSMissionTab::GetPersistentIDForPage(PageID) const {
   return std::nullopt;
 }
 
+IPageSource::PersistentIDs DCSMissionTab::GetPersistentIDsForAllPages() const {
+  // As above
+  return {};
+}
+
 OpenKneeboard::fire_and_forget DCSMissionTab::OnAPIEvent(
   APIEvent event,
   [[maybe_unused]] std::filesystem::path installPath,
@@ -102,6 +102,10 @@ std::optional<std::string> DCSRadioLogTab::GetPersistentIDForPage(
   return std::nullopt;
 }
 
+IPageSource::PersistentIDs DCSRadioLogTab::GetPersistentIDsForAllPages() const {
+  return {};
+}
+
 std::string DCSRadioLogTab::GetGlyph() const { return GetStaticGlyph(); }
 
 std::string DCSRadioLogTab::GetStaticGlyph() { return "\uF12E"; }
@@ -7,7 +7,7 @@
 #include <OpenKneeboard/APIEvent.hpp>
 #include <OpenKneeboard/DCSEvents.hpp>
 #include <OpenKneeboard/DCSTerrainTab.hpp>
-#include <OpenKneeboard/FolderPageSource.hpp>
+#include <OpenKneeboard/FolderPageSourceRegistry.hpp>
 
 #include <OpenKneeboard/dprint.hpp>
 
@@ -108,8 +108,7 @@ OpenKneeboard::fire_and_forget DCSTerrainTab::OnAPIEvent(
   std::vector<std::shared_ptr<IPageSource>> delegates;
   for (auto& path: paths) {
     delegates.push_back(
-      std::static_pointer_cast<IPageSource>(
-        co_await FolderPageSource::Create(mDXR, mKneeboard, path)));
+      co_await mKneeboard->GetFolderPageSourceRegistry()->Acquire(path));
   }
   co_await this->SetDelegates(delegates);
 }
@@ -6,15 +6,19 @@
 // OpenKneeboard repository.
 
 #include <OpenKneeboard/NavigationTab.hpp>
+#include <OpenKneeboard/SHM.hpp>
 
 #include <OpenKneeboard/config.hpp>
 #include <OpenKneeboard/dprint.hpp>
 #include <OpenKneeboard/scope_exit.hpp>
+#include <OpenKneeboard/task/resume_after.hpp>
 
 #include <felly/numeric_cast.hpp>
 
 #include <cstring>
 
+#include <DirectXColors.h>
+
 using felly::numeric_cast;
 
 namespace OpenKneeboard {
@@ -26,13 +30,16 @@ bool NavigationTab::Button::operator==(
 
 NavigationTab::NavigationTab(
   const audited_ptr<DXResources>& dxr,
+  ThumbnailCache* thumbnailCache,
   const std::shared_ptr<ITab>& rootTab,
   const std::vector<NavigationEntry>& entries)
   : TabBase(winrt::guid {}, rootTab->GetTitle()),
     mDXR(dxr),
+    mThumbnailCache(thumbnailCache),
     mRootTab(rootTab),
     mPreferredSize(ErrorPixelSize) {
   OPENKNEEBOARD_TraceLoggingScope("NavigationTab::NavigationTab()");
+  mThumbnailRenderTarget = RenderTarget::Create(dxr, nullptr);
   const auto columns = entries.size() >= 10
     ? std::max(
         1ui32,
@@ -233,9 +240,12 @@ task<void> NavigationTab::RenderPage(
     mPreviewCache.emplace(rtid, std::make_unique<CachedLayer>(mDXR));
   }
 
+  // Re-render the layer when more thumbnails are available
+  const auto cacheKey = pageID.GetTemporaryValue()
+    ^ (static_cast<CachedLayer::Key>(mThumbnailGeneration) << 48);
   co_await mPreviewCache.at(rtid)->Render(
     canvasRect,
-    pageID.GetTemporaryValue(),
+    cacheKey,
     rc.GetRenderTarget(),
     std::bind_front(&NavigationTab::RenderPreviewLayer, this, pageID));
 
@@ -301,8 +311,13 @@ void NavigationTab::CalculatePreviewMetrics(PageID pageID) {
   const auto buttons = mButtonTrackers.at(pageID)->GetButtons();
 
   m.mRects.resize(buttons.size());
+  m.mThumbnails.resize(buttons.size());
   const auto& first = buttons.front();
 
+  const auto rootTabID
+    = winrt::to_string(winrt::to_hstring(mRootTab->GetPersistentID()));
+  const auto rootPageIDs = mRootTab->GetPageIDs();
+
   // just a little less than the padding
   m.mBleed = (first.mRect.bottom - first.mRect.top) * PaddingRatio * 0.1f;
   // arbitrary LGTM value
@@ -325,6 +340,18 @@ void NavigationTab::CalculatePreviewMetrics(PageID pageID) {
         numeric_cast<float>(nativeSize.mWidth) * contentScale, height)
         .Rounded<uint32_t>(),
     };
+
+    // The persistent ID includes whatever the source needs to detect changed
+    // content, e.g. a file hash
+    const auto persistentID = mRootTab->GetPersistentIDForPage(button.mPageID);
+    const auto rootPage = std::ranges::find(rootPageIDs, button.mPageID);
+    if (persistentID && rootPage != rootPageIDs.end()) {
+      m.mThumbnails.at(i).mKey = ThumbnailCache::Key {
+        .mPage = std::format(
+          "{}/{}", rootTabID, std::distance(rootPageIDs.begin(), rootPage)),
+        .mContentHash = ThumbnailStore::HashContent(*persistentID),
+      };
+    }
   }
 
   mPreviewMetrics.emplace(pageID, std::move(m));
@@ -335,7 +362,7 @@ task<void> NavigationTab::RenderPreviewLayer(
   RenderTarget* rt,
   const PixelSize& size) {
   OPENKNEEBOARD_TraceLoggingScope("NavigationTab::RenderPreviewLayer()");
-  const auto& m = mPreviewMetrics.at(pageID);
+  auto& m = mPreviewMetrics.at(pageID);
   const auto buttons = mButtonTrackers.at(pageID)->GetButtons();
 
   const auto scale =
@@ -343,13 +370,168 @@ task<void> NavigationTab::RenderPreviewLayer(
 
   const RenderContext rc {rt, nullptr};
 
+  bool haveMissingThumbnails = false;
   for (auto i = 0; i < buttons.size(); ++i) {
     const auto& button = buttons.at(i);
     const auto& rect = m.mRects.at(i);
-    const auto scaled = rect.StaticCast<float>() * scale;
-    co_await mRootTab->RenderPage(
-      rc, button.mPageID, scaled.Rounded<uint32_t>());
+    const auto scaled = (rect.StaticCast<float>() * scale).Rounded<uint32_t>();
+
+    auto& thumbnail = m.mThumbnails.at(i);
+    // Doodles aren't part of the key, and aren't saved between runs
+    if (!thumbnail.mKey || mRootTab->CanClearUserInput(button.mPageID)) {
+      co_await mRootTab->RenderPage(rc, button.mPageID, scaled);
+      continue;
+    }
+
+    auto& key = *thumbnail.mKey;
+    if (key.mWidth != scaled.mSize.mWidth
+        || key.mHeight != scaled.mSize.mHeight) {
+      key.mWidth = scaled.mSize.mWidth;
+      key.mHeight = scaled.mSize.mHeight;
+      thumbnail.mBitmap = nullptr;
+    }
+    if (!thumbnail.mBitmap) {
+      if (const auto bytes = mThumbnailCache->Find(key)) {
+        thumbnail.mBitmap = ThumbnailCache::Decode(*mDXR, *bytes);
+      }
+    }
+    if (!thumbnail.mBitmap) {
+      // Leave it blank for now, instead of stalling on rendering every page
+      if (!thumbnail.mIsQueued) {
+        thumbnail.mIsQueued = true;
+        mThumbnailQueue.push_back({pageID, static_cast<std::size_t>(i)});
+      }
+      haveMissingThumbnails = true;
+      continue;
+    }
+
+    auto d2d = rt->d2d();
+    d2d->DrawBitmap(
+      thumbnail.mBitmap.get(), scaled, 1.0f, D2D1_INTERPOLATION_MODE_LINEAR);
+  }
+
+  if (haveMissingThumbnails) {
+    this->GenerateThumbnails();
+  }
+}
+
+fire_and_forget NavigationTab::GenerateThumbnails() {
+  if (mGeneratingThumbnails) {
+    co_return;
+  }
+  mGeneratingThumbnails = true;
+
+  auto weak = weak_from_this();
+  while (true) {
+    co_await resume_after(ThumbnailGenerationInterval);
+    auto self = weak.lock();
+    if (!self) {
+      co_return;
+    }
+    if (mThumbnailQueue.empty()) {
+      break;
+    }
+    const auto request = mThumbnailQueue.front();
+    mThumbnailQueue.pop_front();
+    co_await this->GenerateThumbnail(request);
   }
+
+  mGeneratingThumbnails = false;
+  mThumbnailCache->Save();
+}
+
+NavigationTab::Thumbnail* NavigationTab::FindThumbnail(
+  const ThumbnailRequest& request) {
+  const auto it = mPreviewMetrics.find(request.mPageID);
+  if (it == mPreviewMetrics.end()) {
+    return nullptr;
+  }
+  auto& thumbnails = it->second.mThumbnails;
+  if (request.mButtonIndex >= thumbnails.size()) {
+    return nullptr;
+  }
+  return &thumbnails.at(request.mButtonIndex);
+}
+
+task<void> NavigationTab::GenerateThumbnail(ThumbnailRequest request) {
+  OPENKNEEBOARD_TraceLoggingCoro("NavigationTab::GenerateThumbnail()");
+  auto& thumbnail = mPreviewMetrics.at(request.mPageID)
+                      .mThumbnails.at(request.mButtonIndex);
+  thumbnail.mIsQueued = false;
+  if (!thumbnail.mKey || thumbnail.mBitmap) {
+    co_return;
+  }
+  const auto key = *thumbnail.mKey;
+  const auto rootPageID = mButtonTrackers.at(request.mPageID)
+                            ->GetButtons()
+                            .at(request.mButtonIndex)
+                            .mPageID;
+  // Rendered directly instead
+  if (mRootTab->CanClearUserInput(rootPageID)) {
+    co_return;
+  }
+
+  ThumbnailCache::Bytes bytes;
+  try {
+    winrt::com_ptr<ID3D11Texture2D> texture;
+    {
+      const std::unique_lock lock(*mDXR);
+      D3D11_TEXTURE2D_DESC textureDesc {
+        .Width = key.mWidth,
+        .Height = key.mHeight,
+        .MipLevels = 1,
+        .ArraySize = 1,
+        .Format = SHM::SHARED_TEXTURE_PIXEL_FORMAT,
+        .SampleDesc = {1, 0},
+        .Usage = D3D11_USAGE_DEFAULT,
+        .BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET,
+      };
+      winrt::check_hresult(mDXR->mD3D11Device->CreateTexture2D(
+        &textureDesc, nullptr, texture.put()));
+
+      mThumbnailRenderTarget->SetD3DTexture(texture);
+      const scope_exit releaseTexture(
+        [this]() { mThumbnailRenderTarget->SetD3DTexture(nullptr); });
+      {
+        auto d3d = mThumbnailRenderTarget->d3d();
+        mDXR->mD3D11ImmediateContext->ClearRenderTargetView(
+          d3d.rtv(), DirectX::Colors::Transparent);
+      }
+      co_await mRootTab->RenderPage(
+        RenderContext {mThumbnailRenderTarget.get(), nullptr},
+        rootPageID,
+        {{0, 0}, {key.mWidth, key.mHeight}});
+    }
+    // Waits for the GPU without holding the lock
+    bytes = co_await ThumbnailCache::Encode(mDXR, std::move(texture));
+  } catch (const winrt::hresult_error& e) {
+    dprint.Warning(
+      "Failed to create thumbnail for '{}': {}",
+      key.mPage,
+      winrt::to_string(e.message()));
+  }
+
+  // The metrics may have been replaced, or the page doodled on, while we
+  // were encoding
+  const auto current = this->FindThumbnail(request);
+  if (current && current->mKey != key) {
+    co_return;
+  }
+  if (bytes.empty()) {
+    // Render it directly instead
+    if (current) {
+      current->mKey = std::nullopt;
+    }
+  } else if (!mRootTab->CanClearUserInput(rootPageID)) {
+    if (current) {
+      const std::unique_lock lock(*mDXR);
+      current->mBitmap = ThumbnailCache::Decode(*mDXR, bytes);
+    }
+    mThumbnailCache->Insert(key, std::move(bytes));
+  }
+
+  ++mThumbnailGeneration;
+  evNeedsRepaintEvent.Emit();
 }
 
 task<void> NavigationTab::Reload() { co_return; }
@@ -70,7 +70,8 @@ void TabBase::SetBookmarks(const std::vector<Bookmark>& bookmarks) {
 
 void TabBase::SetPersistentBookmarks(
   std::vector<PersistentBookmark> persistent) {
-  if (this->GetPageIDs().empty()) {
+  const auto pageIDs = this->GetPageIDs();
+  if (pageIDs.empty()) {
     this->SetBookmarks({});
     mPendingBookmarks = std::move(persistent);
     return;
@@ -80,19 +81,7 @@ void TabBase::SetPersistentBookmarks(
   // Content already loaded (e.g. folder scan completed before we were
   // called): apply immediately instead of waiting for evContentChangedEvent.
   std::vector<Bookmark> restored;
-  for (auto&& [persistentID, title]: persistent) {
-    if (persistentID == FirstPageFallbackBookmarkPersistentId) {
-      restored.emplace_back(mRuntimeID, this->GetPageIDs().front(), title);
-      continue;
-    }
-
-    const auto pageID = this->GetPageIDFromPersistentID(persistentID);
-    if (pageID) {
-      restored.emplace_back(mRuntimeID, *pageID, title);
-    } else {
-      mPendingBookmarks.emplace_back(persistentID, title);
-    }
-  }
+  this->RestoreBookmarks(pageIDs, std::move(persistent), restored);
   // Event listeners are not set up yet at this point, so emitting events
   // here is safe and harmless.
   this->SetBookmarks(restored);
@@ -106,9 +95,9 @@ std::vector<ITab::PersistentBookmark> TabBase::GetPersistentBookmarks() const {
   std::vector<PersistentBookmark> ret;
   ret.reserve(mBookmarks.size() + mPendingBookmarks.size());
   for (const auto& bookmark: mBookmarks) {
-    const auto persistentID = this->GetPersistentIDForPage(bookmark.mPageID);
+    auto persistentID = this->FindPersistentID(bookmark.mPageID);
     if (persistentID) {
-      ret.emplace_back(*persistentID, bookmark.mTitle);
+      ret.emplace_back(std::move(*persistentID), bookmark.mTitle);
       continue;
     }
 
@@ -121,7 +110,102 @@ std::vector<ITab::PersistentBookmark> TabBase::GetPersistentBookmarks() const {
   return ret;
 }
 
+PersistentPageIndex<PageID>& TabBase::GetPersistentPageIndex() const {
+  if (mPersistentPageIndex) {
+    return *mPersistentPageIndex;
+  }
+
+  auto& index = mPersistentPageIndex.emplace();
+  // A single pass; looking up each page separately is a search per page for
+  // most sources
+  for (auto&& [pageID, persistentID]: this->GetPersistentIDsForAllPages()) {
+    index.Insert(pageID, std::move(persistentID));
+  }
+  return index;
+}
+
+std::optional<std::string> TabBase::FindPersistentID(PageID pageID) const {
+  auto& index = this->GetPersistentPageIndex();
+  if (const auto persistentID = index.FindPersistentID(pageID)) {
+    return std::string {*persistentID};
+  }
+
+  // Pages can be appended without changing the content, e.g. while laying
+  // out text
+  auto persistentID = this->GetPersistentIDForPage(pageID);
+  if (persistentID) {
+    index.Insert(pageID, *persistentID);
+  }
+  return persistentID;
+}
+
+std::optional<PageID> TabBase::FindPageID(std::string_view persistentID) const {
+  auto& index = this->GetPersistentPageIndex();
+  if (const auto pageID = index.FindPageID(persistentID)) {
+    return pageID;
+  }
+
+  // May lay out more pages, or otherwise find pages that weren't in the
+  // index yet
+  const auto pageID = this->GetPageIDFromPersistentID(persistentID);
+  if (pageID) {
+    index.Insert(*pageID, std::string {persistentID});
+  }
+  return pageID;
+}
+
+bool TabBase::RestoreBookmarks(
+  std::span<const PageID> pageIDs,
+  std::vector<PersistentBookmark> persistent,
+  std::vector<Bookmark>& restored) {
+  std::unordered_set<PageID> seenPages;
+  for (const auto& bookmark: restored) {
+    seenPages.insert(bookmark.mPageID);
+  }
+
+  // Only one bookmark per page, but identical files in a folder have the
+  // same persistent IDs, so use the first matching page that's still free
+  const auto findFreePage
+    = [&, this](std::string_view persistentID) -> std::optional<PageID> {
+    if (persistentID == FirstPageFallbackBookmarkPersistentId) {
+      if (seenPages.contains(pageIDs.front())) {
+        return std::nullopt;
+      }
+      return pageIDs.front();
+    }
+    // Also adds it to the index if it wasn't there yet
+    if (!this->FindPageID(persistentID)) {
+      return std::nullopt;
+    }
+    for (const auto pageID:
+         this->GetPersistentPageIndex().FindPageIDs(persistentID)) {
+      if (!seenPages.contains(pageID)) {
+        return pageID;
+      }
+    }
+    return std::nullopt;
+  };
+
+  bool modified = false;
+  for (auto&& [persistentID, title]: persistent) {
+    const auto pageID = findFreePage(persistentID);
+    if (!pageID) {
+      // Keep it so it's still saved, and restored if a matching page
+      // appears later
+      mPendingBookmarks.emplace_back(std::move(persistentID), std::move(title));
+      continue;
+    }
+
+    seenPages.insert(*pageID);
+    modified = true;
+    restored.emplace_back(mRuntimeID, *pageID, std::move(title));
+  }
+  return modified;
+}
+
 void TabBase::OnContentChanged() {
+  mPersistentPageIndex.reset();
+
   const auto pageIDs = this->GetPageIDs();
   if (pageIDs.empty()) {
     mBookmarks.clear();
@@ -139,22 +223,9 @@ void TabBase::OnContentChanged() {
   }
   bool modified = restored.size() != mBookmarks.size();
 
-  for (auto it = mPendingBookmarks.begin(); it != mPendingBookmarks.end();) {
-    const auto& [persistentID, title] = *it;
-    const auto runtimeID = this->GetPageIDFromPersistentID(persistentID);
-    if (!runtimeID) {
-      ++it;
-      continue;
-    }
-
-    if (std::ranges::contains(restored, *runtimeID, &Bookmark::mPageID)) {
-      it = mPendingBookmarks.erase(it);
-      continue;
-    }
-
+  if (this->RestoreBookmarks(
+        pageIDs, std::exchange(mPendingBookmarks, {}), restored)) {
     modified = true;
-    restored.emplace_back(mRuntimeID, *runtimeID, title);
-    it = mPendingBookmarks.erase(it);
   }
 
   if (modified) {
@@ -10,13 +10,15 @@
 #include "TabBase.hpp"
 
 #include <OpenKneeboard/DCSEvents.hpp>
+#include <OpenKneeboard/DCSMissionDigest.hpp>
 #include <OpenKneeboard/PageSourceWithDelegates.hpp>
 
 #include <OpenKneeboard/audited_ptr.hpp>
 
+#include <utility>
+
 namespace OpenKneeboard {
 
-class LuaRef;
 class DCSExtractedMission;
 class ImageFilePageSource;
 class PlainTextPageSource;
@@ -46,6 +48,7 @@ class DCSBriefingTab final : public TabBase,
   std::vector<NavigationEntry> GetNavigationEntries() const override;
 
   std::optional<std::string> GetPersistentIDForPage(PageID) const override;
+  PersistentIDs GetPersistentIDsForAllPages() const override;
 
  protected:
   virtual OpenKneeboard::fire_and_forget
@@ -60,6 +63,9 @@ class DCSBriefingTab final : public TabBase,
   KneeboardState* mKneeboard {nullptr};
 
   std::shared_ptr<DCSExtractedMission> mMission;
+  /// Only depends on the mission, not on `mDCSState`
+  std::shared_ptr<const DCSMissionDigest> mDigest;
+  std::shared_ptr<DCSExtractedMission> mDigestMission;
   std::shared_ptr<ImageFilePageSource> mImagePages;
   std::shared_ptr<PlainTextPageSource> mTextPages;
   std::filesystem::path mInstallationPath;
@@ -81,48 +87,20 @@ class DCSBriefingTab final : public TabBase,
   };
   DCSState mDCSState;
 
-  inline const char* CoalitionKey(
-    const char* neutralKey,
-    const char* redforKey,
-    const char* blueforKey) {
-    switch (mDCSState.mCoalition) {
-      case DCSEvents::Coalition::Neutral:
-        return neutralKey;
-      case DCSEvents::Coalition::Red:
-        return redforKey;
-      case DCSEvents::Coalition::Blue:
-        return blueforKey;
-    }
-    throw std::logic_error("Invalid coalition");
+  inline const DCSMissionDigest::Coalition& GetCoalition(
+    const DCSMissionDigest& digest) const {
+    return digest.mCoalitions.at(std::to_underlying(mDCSState.mCoalition));
   }
 
-  /** DCS supports localised text being stored in a dictionary.
-   *
-   * In this case the string in mission Lua will start with DictKey_ and should
-   * be used as a key to reference in the dictionary. If it doesn't start with
-   * DictKey_ it can be used directly. This has only been observed in older
-   * files - DCS mission editor by default seems to put everything in the
-   * dictionary now.
-   *
-   * @param mission mission lua object
-   * @param dictionary dictionary lua object
-   * @param key key to lookup
-   */
-  std::string GetMissionText(
-    const LuaRef& mission,
-    const LuaRef& dictionary,
-    const char* key);
-
   void SetMissionImages(
-    const LuaRef& mission,
-    const LuaRef& mapResource,
+    const DCSMissionDigest&,
     const std::filesystem::path& localizedResourcePath);
 
-  void PushMissionOverview(const LuaRef& mission, const LuaRef& dictionary);
-  void PushMissionSituation(const LuaRef& mission, const LuaRef& dictionary);
-  void PushMissionObjective(const LuaRef& mission, const LuaRef& dictionary);
-  void PushMissionWeather(const LuaRef& mission);
-  void PushBullseyeData(const LuaRef& mission);
+  void PushMissionOverview(const DCSMissionDigest&);
+  void PushMissionSituation(const DCSMissionDigest&);
+  void PushMissionObjective(const DCSMissionDigest&);
+  void PushMissionWeather(const DCSMissionDigest&);
+  void PushBullseyeData(const DCSMissionDigest&);
 };
 
 }// namespace OpenKneeboard
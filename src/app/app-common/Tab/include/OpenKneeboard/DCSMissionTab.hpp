@@ -40,6 +40,7 @@ class DCSMissionTab final : public TabBase,
   virtual std::string GetDebugInformation() const override;
 
   std::optional<std::string> GetPersistentIDForPage(PageID) const override;
+  PersistentIDs GetPersistentIDsForAllPages() const override;
 
  protected:
   virtual OpenKneeboard::fire_and_forget
@@ -60,6 +60,7 @@ class DCSRadioLogTab final : public TabBase,
   void SetTimestampsEnabled(bool);
 
   std::optional<std::string> GetPersistentIDForPage(PageID) const override;
+  PersistentIDs GetPersistentIDsForAllPages() const override;
 
  protected:
   explicit DCSRadioLogTab(
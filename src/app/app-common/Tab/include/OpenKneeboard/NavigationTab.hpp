@@ -15,23 +15,28 @@
 #include <OpenKneeboard/Events.hpp>
 #include <OpenKneeboard/IPageSourceWithCursorEvents.hpp>
 #include <OpenKneeboard/IPageSourceWithNavigation.hpp>
+#include <OpenKneeboard/ThumbnailCache.hpp>
 
 #include <OpenKneeboard/audited_ptr.hpp>
 
+#include <deque>
 #include <limits>
 #include <memory>
 
 namespace OpenKneeboard {
 
-class NavigationTab final : public TabBase,
-                            public IPageSourceWithCursorEvents,
-                            public virtual EventReceiver {
+class NavigationTab final
+  : public TabBase,
+    public IPageSourceWithCursorEvents,
+    public virtual EventReceiver,
+    public std::enable_shared_from_this<NavigationTab> {
  public:
   using Entry = NavigationEntry;
 
   NavigationTab() = delete;
   NavigationTab(
     const audited_ptr<DXResources>&,
+    ThumbnailCache*,
     const std::shared_ptr<ITab>& rootTab,
     const std::vector<NavigationEntry>& entries);
   ~NavigationTab();
@@ -59,10 +64,13 @@ class NavigationTab final : public TabBase,
 
  private:
   audited_ptr<DXResources> mDXR;
+  ThumbnailCache* mThumbnailCache {nullptr};
   std::shared_ptr<ITab> mRootTab;
   PixelSize mPreferredSize;
   std::unordered_map<RenderTargetID, std::unique_ptr<CachedLayer>>
     mPreviewCache;
+  /// Kept for the lifetime of the tab, as sources cache by its ID
+  std::shared_ptr<RenderTarget> mThumbnailRenderTarget;
 
   uint16_t mRenderColumns;
 
@@ -77,13 +85,30 @@ class NavigationTab final : public TabBase,
   using ButtonTracker = CursorClickableRegions<Button>;
   std::vector<PageID> mPageIDs;
   std::unordered_map<PageID, std::shared_ptr<ButtonTracker>> mButtonTrackers;
+  struct Thumbnail {
+    /// nullopt if the page can't be identified between runs
+    std::optional<ThumbnailCache::Key> mKey;
+    winrt::com_ptr<ID2D1Bitmap> mBitmap;
+    bool mIsQueued {false};
+  };
   struct PreviewMetrics {
     float mBleed;
     float mStroke;
     std::vector<PixelRect> mRects;
+    /// Same indices as `mRects`
+    std::vector<Thumbnail> mThumbnails;
   };
   std::unordered_map<PageID, PreviewMetrics> mPreviewMetrics;
 
+  struct ThumbnailRequest {
+    PageID mPageID;
+    std::size_t mButtonIndex {};
+  };
+  std::deque<ThumbnailRequest> mThumbnailQueue;
+  bool mGeneratingThumbnails {false};
+  /// Incremented when a thumbnail becomes available
+  uint64_t mThumbnailGeneration {};
+
   winrt::com_ptr<IDWriteTextFormat> mTextFormat;
   winrt::com_ptr<IDWriteTextFormat> mPageNumberTextFormat;
   winrt::com_ptr<ID2D1SolidColorBrush> mBackgroundBrush;
@@ -97,7 +122,16 @@ class NavigationTab final : public TabBase,
   [[nodiscard]] task<void>
   RenderPreviewLayer(PageID, RenderTarget*, const PixelSize& size);
 
+  fire_and_forget GenerateThumbnails();
+  /// nullptr if the metrics have been replaced since the request was queued
+  Thumbnail* FindThumbnail(const ThumbnailRequest&);
+  [[nodiscard]]
+  task<void> GenerateThumbnail(ThumbnailRequest);
+
   static constexpr auto PaddingRatio = 1.5f;
+  // Leave time for frames and input between thumbnails
+  static constexpr auto ThumbnailGenerationInterval
+    = std::chrono::milliseconds(15);
 };
 
 }// namespace OpenKneeboard
@@ -9,9 +9,12 @@
 #include "ITab.hpp"
 
 #include <OpenKneeboard/Bookmark.hpp>
+#include <OpenKneeboard/PersistentPageIndex.hpp>
 
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace OpenKneeboard {
@@ -44,6 +47,24 @@ class TabBase : public virtual ITab, public virtual EventReceiver {
   std::vector<Bookmark> mBookmarks;
   std::vector<PersistentBookmark> mPendingBookmarks;
 
+  // Built on first use; reset whenever the content changes
+  mutable std::optional<PersistentPageIndex<PageID>> mPersistentPageIndex;
+
+  PersistentPageIndex<PageID>& GetPersistentPageIndex() const;
+  std::optional<std::string> FindPersistentID(PageID) const;
+  std::optional<PageID> FindPageID(std::string_view persistentID) const;
+
+  /* Resolve `persistent` against the current content, appending to
+   * `restored`; bookmarks that are unresolved, or whose pages all have
+   * bookmarks already, are added to `mPendingBookmarks`.
+   *
+   * Returns true if `restored` was modified.
+   */
+  bool RestoreBookmarks(
+    std::span<const PageID> pageIDs,
+    std::vector<PersistentBookmark> persistent,
+    std::vector<Bookmark>& restored);
+
   void OnContentChanged();
 };
 
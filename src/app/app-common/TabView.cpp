@@ -4,18 +4,22 @@
 //
 // This program is open source; see the LICENSE file in the root of the
 // OpenKneeboard repository.
+#include <OpenKneeboard/Bookmark.hpp>
 #include <OpenKneeboard/CursorEvent.hpp>
 #include <OpenKneeboard/IPageSourceWithCursorEvents.hpp>
 #include <OpenKneeboard/IPageSourceWithNavigation.hpp>
 #include <OpenKneeboard/ITab.hpp>
 #include <OpenKneeboard/KneeboardState.hpp>
 #include <OpenKneeboard/NavigationTab.hpp>
+#include <OpenKneeboard/PagePrerenderer.hpp>
 #include <OpenKneeboard/TabView.hpp>
 
 #include <OpenKneeboard/config.hpp>
 #include <OpenKneeboard/dprint.hpp>
 #include <OpenKneeboard/scope_exit.hpp>
 
+#include <ranges>
+
 namespace OpenKneeboard {
 
 TabView::TabView(
@@ -26,13 +30,16 @@ TabView::TabView(
   : mDXR(dxr),
     mKneeboard(kneeboard),
     mRootTab(tab),
-    mKneeboardViewID(id) {
+    mKneeboardViewID(id),
+    mPrerenderer(std::make_unique<PagePrerenderer>(dxr)) {
   const auto rootPageIDs = tab->GetPageIDs();
   if (!rootPageIDs.empty()) {
     mRootTabPage = {rootPageIDs.front(), 0};
   }
 
   AddEventListener(tab->evNeedsRepaintEvent, this->evNeedsRepaintEvent);
+  AddEventListener(
+    tab->evNeedsRepaintEvent, [this] { mPrerenderer->Invalidate(); });
   AddEventListener(
     tab->evContentChangedEvent,
     std::bind_front(&TabView::OnTabContentChanged, this));
@@ -134,6 +141,13 @@ void TabView::SetPageID(PageID page) {
 }
 
 void TabView::OnTabContentChanged() {
+  mPrerenderer->Invalidate();
+  {
+    const std::unique_lock lock(mKnownPageMutex);
+    mKnownPage = {nullptr};
+    ++mKnownPageGeneration;
+  }
+
   const scope_exit updateOnExit([this] {
     this->evContentChangedEvent.Emit();
     if (!mActiveSubTab) {
@@ -218,12 +232,55 @@ std::optional<PreferredSize> TabView::GetPreferredSize() const {
     return std::nullopt;
   }
   const auto currentPage = this->GetPageID();
-  if (!std::ranges::contains(tab->GetPageIDs(), currentPage)) {
-    return std::nullopt;
+  // Compare IDs rather than addresses, as a new tab could reuse an address
+  const auto tabID = tab->GetRuntimeID();
+  bool known = false;
+  uint64_t generation {};
+  {
+    const std::unique_lock lock(mKnownPageMutex);
+    known = (tabID == mKnownPageTab && currentPage == mKnownPage);
+    generation = mKnownPageGeneration;
+  }
+  if (!known) {
+    // Not under the lock, as this can be slow
+    if (!std::ranges::contains(tab->GetPageIDs(), currentPage)) {
+      return std::nullopt;
+    }
+    const std::unique_lock lock(mKnownPageMutex);
+    if (generation == mKnownPageGeneration) {
+      mKnownPageTab = tabID;
+      mKnownPage = currentPage;
+    }
   }
   return tab->GetPreferredSize(currentPage);
 }
 
+task<void> TabView::RenderPage(RenderContext rc, PixelRect rect) {
+  const auto tab = this->GetTab().lock();
+  if (!tab) {
+    co_return;
+  }
+  const auto pageID = this->GetPageID();
+  if (mActiveSubTab || !mRootTabPage || pageID != mRootTabPage->mID) {
+    co_await tab->RenderPage(rc, pageID, rect);
+    co_return;
+  }
+  co_await mPrerenderer->Render(
+    rc, tab.get(), pageID, mRootTabPage->mIndex, rect);
+}
+
+task<void> TabView::PrerenderPages(
+  std::chrono::steady_clock::time_point stopAt) {
+  const auto tab = mRootTab.lock();
+  if (!tab) {
+    co_return;
+  }
+  const auto bookmarks = tab->GetBookmarks()
+    | std::views::transform(&Bookmark::mPageID)
+    | std::ranges::to<std::vector>();
+  co_await mPrerenderer->RunIdleWork(tab.get(), bookmarks, stopAt);
+}
+
 TabMode TabView::GetTabMode() const { return mTabMode; }
 
 bool TabView::SupportsTabMode(TabMode mode) const {
@@ -271,6 +328,7 @@ bool TabView::SetTabMode(TabMode mode) {
       }
       mActiveSubTab = std::make_shared<NavigationTab>(
         mDXR,
+        mKneeboard->GetThumbnailCache(),
         tab,
         std::dynamic_pointer_cast<IPageSourceWithNavigation>(tab)
           ->GetNavigationEntries());
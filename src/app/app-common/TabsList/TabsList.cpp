@@ -13,34 +13,42 @@
 #include <OpenKneeboard/PluginTab.hpp>
 #include <OpenKneeboard/RuntimeFiles.hpp>
 #include <OpenKneeboard/TabBase.hpp>
+#include <OpenKneeboard/TabLoadScheduler.hpp>
 #include <OpenKneeboard/TabTypes.hpp>
 #include <OpenKneeboard/TabView.hpp>
 #include <OpenKneeboard/TabsList.hpp>
+#include <OpenKneeboard/TroubleshootingStore.hpp>
 
 #include <OpenKneeboard/dprint.hpp>
+#include <OpenKneeboard/scope_exit.hpp>
 
 #include <shims/nlohmann/json.hpp>
 
 #include <algorithm>
 #include <cstdint>
 #include <fstream>
+#include <ranges>
 #include <vector>
 
 namespace OpenKneeboard {
 
+struct TabsList::PendingLoad {
+  std::vector<nlohmann::json> mConfig;
+  TabLoadScheduler mScheduler;
+  /// Indexed like `mConfig`; null unless loaded
+  std::vector<std::shared_ptr<ITab>> mTabs;
+};
+
 TabsList::TabsList(
   const audited_ptr<DXResources>& dxr,
   KneeboardState* kneeboard)
   : mDXR(dxr),
     mKneeboard(kneeboard) {}
 
-task<std::shared_ptr<TabsList>> TabsList::Create(
+std::shared_ptr<TabsList> TabsList::Create(
   const audited_ptr<DXResources>& dxr,
-  KneeboardState* kneeboard,
-  const nlohmann::json& config) {
-  std::unique_ptr<TabsList> ret {new TabsList(dxr, kneeboard)};
-  co_await ret->LoadSettings(config);
-  co_return ret;
+  KneeboardState* kneeboard) {
+  return std::shared_ptr<TabsList>(new TabsList(dxr, kneeboard));
 }
 
 TabsList::~TabsList() { this->RemoveAllEventListeners(); }
@@ -154,25 +162,117 @@ task<std::shared_ptr<ITab>> TabsList::LoadTabFromJSON(
 
 task<void> TabsList::LoadSettings(nlohmann::json config) {
   if (config.is_null()) {
+    mPendingLoad = nullptr;
     co_await LoadDefaultSettings();
     co_return;
   }
-  const std::vector<nlohmann::json> jsonTabs = config;
+  std::vector<nlohmann::json> jsonTabs = config;
+
+  std::vector<TabLoadScheduler::Entry> entries;
+  for (const auto& tab: jsonTabs) {
+    entries.push_back({
+      .mTitle = tab.value<std::string>("Title", {}),
+      .mType = tab.value<std::string>("Type", {}),
+    });
+  }
+
+  const auto tabCount = jsonTabs.size();
+  const auto load = std::make_shared<PendingLoad>(
+    std::move(jsonTabs),
+    TabLoadScheduler {
+      std::move(entries),
+      MaxConcurrentTabLoads,
+      TabLoadScheduler::Clock::now(),
+    },
+    std::vector<std::shared_ptr<ITab>>(tabCount));
+  mPendingLoad = load;
+
+  // Tasks start immediately, so these run concurrently
+  std::vector<task<void>> workers;
+  for (std::size_t i = 0; i < std::min(tabCount, MaxConcurrentTabLoads);
+       ++i) {
+    workers.push_back(this->LoadTabsWorker(load));
+  }
+  for (auto&& it: workers) {
+    co_await std::move(it);
+  }
 
-  std::vector<task<std::shared_ptr<ITab>>> awaitables;
-  for (auto&& tab: jsonTabs) {
-    awaitables.push_back(this->LoadTabFromJSON(tab));
+  TroubleshootingStore::Get()->OnTabsLoaded(load->mScheduler);
+  if (mPendingLoad != load) {
+    // Superseded by another `LoadSettings()` call
+    co_return;
   }
 
-  decltype(mTabs) tabs;
-  for (auto&& it: awaitables) {
-    auto tab = co_await std::move(it);
-    if (tab) {
-      tabs.push_back(std::move(tab));
+  // If we have no tabs, nothing was published by the workers
+  co_await this->PublishLoadedTabs();
+  mPendingLoad = nullptr;
+  evSettingsChangedEvent.Emit();
+}
+
+task<void> TabsList::LoadTabsWorker(std::shared_ptr<PendingLoad> load) {
+  auto& scheduler = load->mScheduler;
+  while (mPendingLoad == load) {
+    const auto index = scheduler.StartNext(TabLoadScheduler::Clock::now());
+    if (!index) {
+      co_return;
+    }
+
+    // A tab that fails to load shouldn't stop the others
+    std::shared_ptr<ITab> tab;
+    std::string error;
+    try {
+      tab = co_await this->LoadTabFromJSON(load->mConfig.at(*index));
+      if (!tab) {
+        error = "unsupported tab type";
+      }
+    } catch (const std::exception& e) {
+      error = e.what();
+    } catch (const winrt::hresult_error& e) {
+      error = winrt::to_string(e.message());
     }
+
+    const auto now = TabLoadScheduler::Clock::now();
+    if (!tab) {
+      scheduler.MarkFailed(*index, now, error);
+      continue;
+    }
+    scheduler.MarkLoaded(*index, now);
+
+    if (mPendingLoad != load) {
+      if (auto p = std::dynamic_pointer_cast<IHasDisposeAsync>(tab)) {
+        co_await p->DisposeAsync();
+      }
+      co_return;
+    }
+
+    load->mTabs.at(*index) = std::move(tab);
+    co_await this->PublishLoadedTabs();
   }
+}
 
-  co_await this->SetTabs(tabs);
+task<void> TabsList::PublishLoadedTabs() {
+  // Only one publisher at a time, as `ReplaceTabs()` can suspend; it picks up
+  // any tabs that finished loading in the meantime
+  if (mPublishing) {
+    mPublishPending = true;
+    co_return;
+  }
+  mPublishing = true;
+  const scope_exit publishingDone([this]() { mPublishing = false; });
+
+  do {
+    mPublishPending = false;
+    const auto load = mPendingLoad;
+    if (!load) {
+      co_return;
+    }
+    auto tabs = load->mScheduler.GetLoaded()
+      | std::views::transform([&load](const auto index) {
+                  return load->mTabs.at(index);
+                })
+      | std::ranges::to<std::vector>();
+    co_await this->ReplaceTabs(std::move(tabs));
+  } while (mPublishPending);
 }
 
 task<void> TabsList::LoadDefaultSettings() {
@@ -199,47 +299,76 @@ task<void> TabsList::LoadDefaultSettings() {
   });
 }
 
-nlohmann::json TabsList::GetSettings() const {
-  std::vector<nlohmann::json> ret;
-
-  for (const auto& tab: mTabs) {
-    std::string type;
+static std::optional<nlohmann::json> SerializeTab(
+  const std::shared_ptr<ITab>& tab) {
+  std::string type;
 #define IT(_, it) \
   if (type.empty() && std::dynamic_pointer_cast<it##Tab>(tab)) { \
     type = #it; \
   }
-    OPENKNEEBOARD_TAB_TYPES
+  OPENKNEEBOARD_TAB_TYPES
 #undef IT
-    if (type.empty() && std::dynamic_pointer_cast<PluginTab>(tab)) {
-      type = "Plugin";
-    }
-    if (type.empty()) {
-      dprint("Unknown type for tab {}", tab->GetTitle());
-      OPENKNEEBOARD_BREAK;
-      continue;
+  if (type.empty() && std::dynamic_pointer_cast<PluginTab>(tab)) {
+    type = "Plugin";
+  }
+  if (type.empty()) {
+    dprint("Unknown type for tab {}", tab->GetTitle());
+    OPENKNEEBOARD_BREAK;
+    return std::nullopt;
+  }
+
+  nlohmann::json savedTab {
+    {"Type", type},
+    {"Title", tab->GetTitle()},
+    {"ID", winrt::to_string(winrt::to_hstring(tab->GetPersistentID()))},
+  };
+
+  auto withSettings = std::dynamic_pointer_cast<ITabWithSettings>(tab);
+  if (withSettings) {
+    auto settings = withSettings->GetSettings();
+    if (!settings.is_null()) {
+      savedTab.emplace("Settings", settings);
     }
+  }
+
+  auto bmArray = SerializeTabBookmarks(*tab);
+  if (!bmArray.empty()) {
+    savedTab.emplace("Bookmarks", std::move(bmArray));
+  }
 
-    nlohmann::json savedTab {
-      {"Type", type},
-      {"Title", tab->GetTitle()},
-      {"ID", winrt::to_string(winrt::to_hstring(tab->GetPersistentID()))},
-    };
-
-    auto withSettings = std::dynamic_pointer_cast<ITabWithSettings>(tab);
-    if (withSettings) {
-      auto settings = withSettings->GetSettings();
-      if (!settings.is_null()) {
-        savedTab.emplace("Settings", settings);
+  return savedTab;
+}
+
+nlohmann::json TabsList::GetSettings() const {
+  std::vector<nlohmann::json> ret;
+
+  if (mPendingLoad) {
+    // Don't drop tabs that haven't finished loading yet
+    const auto& load = *mPendingLoad;
+    const auto entries = load.mScheduler.GetEntries();
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+      using enum TabLoadScheduler::State;
+      switch (entries[i].mState) {
+        case Queued:
+        case Loading:
+          ret.push_back(load.mConfig.at(i));
+          break;
+        case Loaded:
+          if (auto tab = SerializeTab(load.mTabs.at(i))) {
+            ret.push_back(std::move(*tab));
+          }
+          break;
+        case Failed:
+          break;
       }
     }
+    return ret;
+  }
 
-    auto bmArray = SerializeTabBookmarks(*tab);
-    if (!bmArray.empty()) {
-      savedTab.emplace("Bookmarks", std::move(bmArray));
+  for (const auto& tab: mTabs) {
+    if (auto saved = SerializeTab(tab)) {
+      ret.push_back(std::move(*saved));
     }
-
-    ret.push_back(savedTab);
-    continue;
   }
 
   return ret;
@@ -248,8 +377,14 @@ nlohmann::json TabsList::GetSettings() const {
 std::vector<std::shared_ptr<ITab>> TabsList::GetTabs() const { return mTabs; }
 
 task<void> TabsList::SetTabs(std::vector<std::shared_ptr<ITab>> tabs) {
+  if (co_await this->ReplaceTabs(std::move(tabs))) {
+    evSettingsChangedEvent.Emit();
+  }
+}
+
+task<bool> TabsList::ReplaceTabs(std::vector<std::shared_ptr<ITab>> tabs) {
   if (std::ranges::equal(tabs, mTabs)) {
-    co_return;
+    co_return false;
   }
 
   {
@@ -280,7 +415,7 @@ task<void> TabsList::SetTabs(std::vector<std::shared_ptr<ITab>> tabs) {
   }
 
   evTabsChangedEvent.Emit();
-  evSettingsChangedEvent.Emit();
+  co_return true;
 }
 
 task<void> TabsList::InsertTab(TabIndex index, std::shared_ptr<ITab> tab) {
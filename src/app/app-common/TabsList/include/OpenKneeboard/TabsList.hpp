@@ -23,10 +23,10 @@ class TabsList final : private EventReceiver {
   TabsList() = delete;
   ~TabsList();
 
-  static task<std::shared_ptr<TabsList>> Create(
+  /// Call `LoadSettings()` to add the configured tabs
+  static std::shared_ptr<TabsList> Create(
     const audited_ptr<DXResources>&,
-    KneeboardState* kneeboard,
-    const nlohmann::json& config);
+    KneeboardState* kneeboard);
 
   std::vector<std::shared_ptr<ITab>> GetTabs() const;
 
@@ -36,6 +36,12 @@ class TabsList final : private EventReceiver {
   task<void> SetTabs(std::vector<std::shared_ptr<ITab>> tabs);
 
   nlohmann::json GetSettings() const;
+  /** Replace all tabs with the configured tabs.
+   *
+   * Tabs are loaded concurrently, and `evTabsChangedEvent` is emitted as each
+   * one finishes, keeping the configured order; `evSettingsChangedEvent` is
+   * only emitted when they've all finished.
+   */
   [[nodiscard]]
   task<void> LoadSettings(nlohmann::json);
 
@@ -43,6 +49,10 @@ class TabsList final : private EventReceiver {
   Event<> evTabsChangedEvent;
 
  private:
+  // Enough to overlap slow tabs (e.g. large folders, web dashboards) without
+  // starving the UI thread
+  static constexpr std::size_t MaxConcurrentTabLoads = 4;
+
   TabsList(const audited_ptr<DXResources>&, KneeboardState* kneeboard);
 
   audited_ptr<DXResources> mDXR;
@@ -50,7 +60,20 @@ class TabsList final : private EventReceiver {
   std::vector<std::shared_ptr<ITab>> mTabs;
   std::vector<EventHandlerToken> mTabEvents;
 
+  struct PendingLoad;
+  /// The most recent `LoadSettings()` call, if it hasn't finished
+  std::shared_ptr<PendingLoad> mPendingLoad;
+  bool mPublishing {false};
+  bool mPublishPending {false};
+
   task<std::shared_ptr<ITab>> LoadTabFromJSON(nlohmann::json tab);
+  [[nodiscard]]
+  task<void> LoadTabsWorker(std::shared_ptr<PendingLoad>);
+  [[nodiscard]]
+  task<void> PublishLoadedTabs();
+  /// Returns false if the tabs were unchanged
+  [[nodiscard]]
+  task<bool> ReplaceTabs(std::vector<std::shared_ptr<ITab>> tabs);
 
   [[nodiscard]]
   task<void> LoadDefaultSettings();
@@ -0,0 +1,237 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/DXResources.hpp>
+#include <OpenKneeboard/Filesystem.hpp>
+#include <OpenKneeboard/ThumbnailCache.hpp>
+
+#include <OpenKneeboard/dprint.hpp>
+#include <OpenKneeboard/scope_exit.hpp>
+#include <OpenKneeboard/task/resume_after.hpp>
+#include <OpenKneeboard/tracing.hpp>
+
+#include <fstream>
+#include <iterator>
+
+#include <wincodec.h>
+
+namespace OpenKneeboard {
+
+ThumbnailCache::ThumbnailCache()
+  : mPath(Filesystem::GetLocalAppDataDirectory() / "Thumbnails.bin"),
+    mWriter(
+      DebouncedFileWriter::Options {
+        .mDebounce = std::chrono::seconds(2),
+        .mMaxDelay = std::chrono::seconds(10),
+      },
+      [](const auto& path, const auto& result) {
+        if (!result.mSucceeded) {
+          dprint.Warning(
+            "Failed to save thumbnails to '{}': {}",
+            path.string(),
+            result.mError);
+        }
+      }) {}
+
+ThumbnailCache::~ThumbnailCache() = default;
+
+task<void> ThumbnailCache::Load() {
+  OPENKNEEBOARD_TraceLoggingCoro("ThumbnailCache::Load()");
+  // Up to `BudgetBytes` to read and parse; don't delay startup
+  co_await winrt::resume_background();
+
+  ThumbnailStore loaded {BudgetBytes};
+  std::error_code ec;
+  if (std::filesystem::exists(mPath, ec)) {
+    std::ifstream f(mPath, std::ios::binary);
+    const std::string data {
+      std::istreambuf_iterator<char> {f}, std::istreambuf_iterator<char> {}};
+    if (loaded.Deserialize(data)) {
+      const auto stats = loaded.GetStats();
+      dprint(
+        "Loaded {} thumbnails ({} bytes) from '{}'",
+        stats.mEntryCount,
+        stats.mBytes,
+        mPath.string());
+    } else {
+      dprint.Warning("Discarding invalid thumbnail cache '{}'", mPath.string());
+    }
+  }
+
+  const std::unique_lock lock(mMutex);
+  mStore = std::move(loaded);
+  mSavedGeneration = mStore.GetGeneration();
+  mLoaded = true;
+  // Newer than anything on disk
+  for (auto&& [key, bytes]: std::exchange(mInsertedBeforeLoad, {})) {
+    mStore.Insert(std::move(key), std::move(bytes));
+  }
+  this->SaveLocked();
+}
+
+std::shared_ptr<const ThumbnailCache::Bytes> ThumbnailCache::Find(
+  const Key& key) {
+  const std::unique_lock lock(mMutex);
+  return mStore.Find(key);
+}
+
+void ThumbnailCache::Insert(Key key, Bytes bytes) {
+  const std::unique_lock lock(mMutex);
+  if (!mLoaded) {
+    mInsertedBeforeLoad.emplace_back(key, bytes);
+  }
+  mStore.Insert(std::move(key), std::move(bytes));
+}
+
+void ThumbnailCache::Save() {
+  const std::unique_lock lock(mMutex);
+  this->SaveLocked();
+}
+
+void ThumbnailCache::SaveLocked() {
+  OPENKNEEBOARD_TraceLoggingScope("ThumbnailCache::SaveLocked()");
+  if (!mLoaded) {
+    // Don't replace the saved thumbnails with a partial set
+    return;
+  }
+  // Lookups of stale thumbnails also change the store
+  const auto generation = mStore.GetGeneration();
+  if (generation == mSavedGeneration) {
+    return;
+  }
+  mSavedGeneration = generation;
+  mWriter.Write(mPath, mStore.Serialize());
+}
+
+task<ThumbnailCache::Bytes> ThumbnailCache::Encode(
+  audited_ptr<DXResources> dxr,
+  winrt::com_ptr<ID3D11Texture2D> texture) {
+  OPENKNEEBOARD_TraceLoggingCoro("ThumbnailCache::Encode()");
+  D3D11_TEXTURE2D_DESC desc {};
+  texture->GetDesc(&desc);
+  desc.Usage = D3D11_USAGE_STAGING;
+  desc.BindFlags = 0;
+  desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+  desc.MiscFlags = 0;
+
+  winrt::com_ptr<ID3D11Texture2D> staging;
+  auto ctx = dxr->mD3D11ImmediateContext.get();
+  {
+    const std::unique_lock lock(*dxr);
+    winrt::check_hresult(
+      dxr->mD3D11Device->CreateTexture2D(&desc, nullptr, staging.put()));
+    ctx->CopyResource(staging.get(), texture.get());
+  }
+
+  auto wic = dxr->mWIC.get();
+  winrt::com_ptr<IWICBitmap> bitmap;
+  while (true) {
+    {
+      const std::unique_lock lock(*dxr);
+      D3D11_MAPPED_SUBRESOURCE mapped {};
+      const auto result = ctx->Map(
+        staging.get(),
+        0,
+        D3D11_MAP_READ,
+        D3D11_MAP_FLAG_DO_NOT_WAIT,
+        &mapped);
+      if (result != DXGI_ERROR_WAS_STILL_DRAWING) {
+        winrt::check_hresult(result);
+        const scope_exit unmap([&]() { ctx->Unmap(staging.get(), 0); });
+        // Copies the pixels
+        winrt::check_hresult(wic->CreateBitmapFromMemory(
+          desc.Width,
+          desc.Height,
+          GUID_WICPixelFormat32bppPBGRA,
+          mapped.RowPitch,
+          mapped.RowPitch * desc.Height,
+          static_cast<BYTE*>(mapped.pData),
+          bitmap.put()));
+        break;
+      }
+    }
+    // Don't stall the calling thread - usually the UI thread - on the GPU
+    co_await resume_after(ReadbackPollInterval);
+  }
+
+  co_await winrt::resume_background();
+
+  winrt::com_ptr<IStream> stream;
+  winrt::check_hresult(CreateStreamOnHGlobal(nullptr, TRUE, stream.put()));
+  winrt::com_ptr<IWICBitmapEncoder> encoder;
+  winrt::check_hresult(
+    wic->CreateEncoder(GUID_ContainerFormatPng, nullptr, encoder.put()));
+  winrt::check_hresult(
+    encoder->Initialize(stream.get(), WICBitmapEncoderNoCache));
+
+  winrt::com_ptr<IWICBitmapFrameEncode> frame;
+  winrt::check_hresult(encoder->CreateNewFrame(frame.put(), nullptr));
+  winrt::check_hresult(frame->Initialize(nullptr));
+  winrt::check_hresult(frame->SetSize(desc.Width, desc.Height));
+  // PNG doesn't support premultiplied alpha; `WriteSource()` converts
+  WICPixelFormatGUID format = GUID_WICPixelFormat32bppBGRA;
+  winrt::check_hresult(frame->SetPixelFormat(&format));
+  winrt::check_hresult(frame->WriteSource(bitmap.get(), nullptr));
+  winrt::check_hresult(frame->Commit());
+  winrt::check_hresult(encoder->Commit());
+
+  STATSTG stat {};
+  winrt::check_hresult(stream->Stat(&stat, STATFLAG_NONAME));
+  Bytes ret(static_cast<std::size_t>(stat.cbSize.QuadPart));
+  winrt::check_hresult(stream->Seek({}, STREAM_SEEK_SET, nullptr));
+  ULONG read {};
+  winrt::check_hresult(
+    stream->Read(ret.data(), static_cast<ULONG>(ret.size()), &read));
+  ret.resize(read);
+  co_return ret;
+}
+
+winrt::com_ptr<ID2D1Bitmap> ThumbnailCache::Decode(
+  DXResources& dxr,
+  std::span<const std::byte> bytes) {
+  OPENKNEEBOARD_TraceLoggingScope("ThumbnailCache::Decode()");
+  auto wic = dxr.mWIC.get();
+
+  winrt::com_ptr<IWICStream> stream;
+  if (
+    FAILED(wic->CreateStream(stream.put()))
+    || FAILED(stream->InitializeFromMemory(
+      reinterpret_cast<BYTE*>(const_cast<std::byte*>(bytes.data())),
+      static_cast<DWORD>(bytes.size())))) {
+    return nullptr;
+  }
+
+  winrt::com_ptr<IWICBitmapDecoder> decoder;
+  winrt::com_ptr<IWICBitmapFrameDecode> frame;
+  winrt::com_ptr<IWICFormatConverter> converter;
+  if (
+    FAILED(wic->CreateDecoderFromStream(
+      stream.get(), nullptr, WICDecodeMetadataCacheOnLoad, decoder.put()))
+    || FAILED(decoder->GetFrame(0, frame.put()))
+    || FAILED(wic->CreateFormatConverter(converter.put()))
+    || FAILED(converter->Initialize(
+      frame.get(),
+      GUID_WICPixelFormat32bppPBGRA,
+      WICBitmapDitherTypeNone,
+      nullptr,
+      0.0f,
+      WICBitmapPaletteTypeMedianCut))) {
+    return nullptr;
+  }
+
+  // Copy the pixels, so the bitmap doesn't refer to `bytes`
+  winrt::com_ptr<IWICBitmap> decoded;
+  if (FAILED(wic->CreateBitmapFromSource(
+        converter.get(), WICBitmapCacheOnLoad, decoded.put()))) {
+    return nullptr;
+  }
+
+  winrt::com_ptr<ID2D1Bitmap> ret;
+  if (FAILED(dxr.mD2DDeviceContext->CreateBitmapFromWicBitmap(
+        decoded.get(), nullptr, ret.put()))) {
+    return nullptr;
+  }
+  return ret;
+}
+
+}// namespace OpenKneeboard
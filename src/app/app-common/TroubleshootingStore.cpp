@@ -33,6 +33,11 @@ std::shared_ptr<TroubleshootingStore> TroubleshootingStore::Get() {
     dprint.SetHistoryProvider([weak = std::weak_ptr {shared}]() {
       return weak.lock()->GetDPrintDebugLogAsString();
     });
+    dprint.SetLogFileFlusher([weak = std::weak_ptr {shared}]() {
+      if (auto self = weak.lock()) {
+        self->FlushLogFile();
+      }
+    });
   }
 
   return shared;
@@ -41,12 +46,10 @@ std::shared_ptr<TroubleshootingStore> TroubleshootingStore::Get() {
 class TroubleshootingStore::DPrintReceiver final
   : public OpenKneeboard::DPrintReceiver {
  public:
-  DPrintReceiver() = default;
+  DPrintReceiver(LogRing&);
   ~DPrintReceiver();
 
-  std::vector<DPrintEntry> GetMessages();
-
-  Event<DPrintEntry> evMessageReceived;
+  Event<LogRing::Sequence> evMessageReceived;
 
   DPrintReceiver(const DPrintReceiver&) = delete;
   DPrintReceiver(DPrintReceiver&&) = delete;
@@ -57,12 +60,11 @@ class TroubleshootingStore::DPrintReceiver final
   void OnMessage(const DPrintMessage& message) override;
 
  private:
-  std::vector<DPrintEntry> mMessages;
-  std::recursive_mutex mMutex;
+  LogRing& mLog;
 };
 
 TroubleshootingStore::TroubleshootingStore() {
-  mDPrint = std::make_unique<DPrintReceiver>();
+  mDPrint = std::make_unique<DPrintReceiver>(mDPrintLog);
   mDPrintThread = std::jthread {[this](std::stop_token stopToken) {
     SetThreadDescription(
       GetCurrentThread(), L"TroubleshootingStore DPrintReceiver");
@@ -120,9 +122,22 @@ void TroubleshootingStore::InitializeLogFile() {
                   GetCurrentProcessId());
   mLogFile = std::ofstream(file, std::ios::binary);
 
-  AddEventListener(
-    this->evDPrintMessageReceived,
-    std::bind_front(&TroubleshootingStore::WriteDPrintMessageToLogFile, this));
+  // Write in batches rather than per-message, as chatty clients can log a lot
+  mLogFileThread = std::jthread {[this] {
+    SetThreadDescription(
+      GetCurrentThread(), L"TroubleshootingStore Log File Writer");
+    while (true) {
+      {
+        std::unique_lock lock(mLogFileWakeMutex);
+        mLogFileWake.wait_for(
+          lock, LogFileFlushInterval, [this] { return mLogFileStopping; });
+        if (mLogFileStopping) {
+          return;
+        }
+      }
+      this->FlushLogFile();
+    }
+  }};
 
   if (existingFiles.size() < maxLogFiles) {
     return;
@@ -139,24 +154,79 @@ void TroubleshootingStore::InitializeLogFile() {
 TroubleshootingStore::~TroubleshootingStore() {
   dprint("{}()", __FUNCTION__);
   this->RemoveAllEventListeners();
+  if (mLogFileThread.joinable()) {
+    {
+      std::unique_lock lock(mLogFileWakeMutex);
+      mLogFileStopping = true;
+    }
+    mLogFileWake.notify_all();
+    mLogFileThread.join();
+  }
+  this->FlushLogFile();
 }
 
-void TroubleshootingStore::WriteDPrintMessageToLogFile(
-  const DPrintEntry& entry) {
-  if (!mLogFile) {
-    return;
+static std::string FormatDPrintEntry(
+  const TroubleshootingStore::DPrintEntry& entry,
+  const LogRing::Source& source) {
+  std::string_view exe {source.mExecutable};
+  if (const auto dirSep = exe.find_last_of("\\/");
+      dirSep != exe.npos && dirSep + 1 < exe.size()) {
+    exe.remove_prefix(dirSep + 1);
   }
 
-  *mLogFile << std::format(
-    "[{:%F %T} {} ({})] {}: {}",
+  return std::format(
+    "[{:%F %T} {} ({})] {}: {}\n",
     std::chrono::zoned_time(
       std::chrono::current_zone(),
       std::chrono::time_point_cast<std::chrono::seconds>(entry.mWhen)),
-    std::filesystem::path(entry.mExecutable).filename().string(),
+    exe,
     entry.mProcessID,
-    winrt::to_string(entry.mPrefix),
-    winrt::to_string(entry.mMessage))
-            << std::endl;
+    source.mPrefix,
+    entry.mMessage);
+}
+
+void TroubleshootingStore::FlushLogFile() {
+  if (!mLogFile) {
+    return;
+  }
+  // This is also called from the fatal error handler; if we crashed while
+  // writing, give up rather than deadlocking
+  std::unique_lock lock(mLogFileMutex, std::defer_lock);
+  if (!lock.try_lock_for(LogFileFlushInterval)) {
+    return;
+  }
+  this->WriteLogFile();
+}
+
+void TroubleshootingStore::WriteLogFile() {
+  std::string buffer;
+  auto expected = mLogFileSequence + 1;
+  const auto append
+    = [&](const DPrintEntry& entry, const LogRing::Source& source) {
+        if (entry.mSequence > expected) {
+          buffer += std::format(
+            "[{} messages were dropped before they could be written]\n",
+            entry.mSequence - expected);
+        }
+        expected = entry.mSequence + 1;
+        buffer += FormatDPrintEntry(entry, source);
+      };
+  while (true) {
+    const auto previous = mLogFileSequence;
+    // On timeout, keep what we have; the next flush will retry the rest
+    mLogFileSequence
+      = mDPrintLog.VisitSince(previous, DPrintReadBatchSize, append)
+          .value_or(previous);
+    if (mLogFileSequence == previous) {
+      break;
+    }
+  }
+  if (buffer.empty()) {
+    return;
+  }
+
+  mLogFile->write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+  mLogFile->flush();
 }
 
 void TroubleshootingStore::OnAPIEvent(const APIEvent& ev) {
@@ -178,6 +248,13 @@ void TroubleshootingStore::OnAPIEvent(const APIEvent& ev) {
   evAPIEventReceived.Emit(entry);
 }
 
+void TroubleshootingStore::OnTabsLoaded(const TabLoadScheduler& scheduler) {
+  mTabLoadTimelines.push_back({std::chrono::system_clock::now(), scheduler});
+  while (mTabLoadTimelines.size() > MaxTabLoadTimelines) {
+    mTabLoadTimelines.pop_front();
+  }
+}
+
 template <class C, class T>
 static auto ReadableTime(const std::chrono::time_point<C, T>& time) {
   return std::chrono::zoned_time(
@@ -212,59 +289,182 @@ std::string TroubleshootingStore::GetAPIEventsDebugLogAsString() const {
         "No events as of {}", ReadableTime(std::chrono::system_clock::now())));
 }
 
-TroubleshootingStore::DPrintReceiver::~DPrintReceiver() {}
+static std::string FormatTabLoadTimeline(
+  std::chrono::system_clock::time_point recordedAt,
+  const TabLoadScheduler& scheduler) {
+  using namespace std::chrono;
+  const auto start = scheduler.GetCreatedAt();
+  const auto sinceStart = [start](TabLoadScheduler::TimePoint it) {
+    return duration_cast<milliseconds>(it - start);
+  };
 
-std::vector<TroubleshootingStore::DPrintEntry>
-TroubleshootingStore::DPrintReceiver::GetMessages() {
-  std::unique_lock lock(mMutex);
-  return mMessages;
+  const auto entries = scheduler.GetEntries();
+  std::string ret = std::format(
+    "{} tabs, up to {} at a time; finished {} after {}",
+    entries.size(),
+    scheduler.GetMaxConcurrency(),
+    ReadableTime(recordedAt),
+    sinceStart(scheduler.GetCompletedAt().value_or(start)));
+
+  for (const auto& entry: entries) {
+    using enum TabLoadScheduler::State;
+    switch (entry.mState) {
+      case Queued:
+        ret += std::format("\n  never started: '{}'", entry.mTitle);
+        continue;
+      case Loading:
+        ret += std::format(
+          "\n  {:>6} - unfinished: '{}' ({})",
+          sinceStart(entry.mStartedAt),
+          entry.mTitle,
+          entry.mType);
+        continue;
+      case Loaded:
+      case Failed:
+        break;
+    }
+    ret += std::format(
+      "\n  {:>6} - {:>6}: '{}' ({})",
+      sinceStart(entry.mStartedAt),
+      sinceStart(entry.mFinishedAt),
+      entry.mTitle,
+      entry.mType);
+    if (entry.mState == Failed) {
+      ret += std::format(" FAILED: {}", entry.mError);
+    }
+  }
+  return ret;
 }
 
+std::string TroubleshootingStore::GetTabLoadTimelinesAsString() const {
+  const auto timelines = mTabLoadTimelines
+    | std::views::transform([](const auto& it) {
+                           return FormatTabLoadTimeline(
+                             it.mRecordedAt, it.mScheduler);
+                         });
+  return std::ranges::fold_left_first(
+           timelines,
+           [](const auto& acc, const auto& it) {
+             return std::format("{}\n\n{}", acc, it);
+           })
+    .value_or("No tabs loaded");
+}
+
+TroubleshootingStore::DPrintReceiver::DPrintReceiver(LogRing& log)
+  : mLog(log) {}
+
+TroubleshootingStore::DPrintReceiver::~DPrintReceiver() {}
+
 void TroubleshootingStore::DPrintReceiver::OnMessage(
   const DPrintMessage& message) {
-  const DPrintEntry entry {
-    .mWhen = std::chrono::system_clock::now(),
-    .mProcessID = message.mHeader.mProcessID,
-    .mExecutable = message.mHeader.mExecutable,
-    .mPrefix = message.mHeader.mPrefix,
-    .mMessage = std::wstring {message.mMessage, message.mMessageLength},
-  };
-  {
-    std::unique_lock lock(mMutex);
-    mMessages.push_back(entry);
+  const std::wstring_view text {message.mMessage, message.mMessageLength};
+
+  // Matches the prefixes added by `dprint.Warning()` and `dprint.Error()`
+  auto level = LogRing::Level::Verbose;
+  if (text.starts_with(L"⚠️ ERROR: ")) {
+    level = LogRing::Level::Error;
+  } else if (text.starts_with(L"⚠️ WARNING: ")) {
+    level = LogRing::Level::Warning;
   }
-  evMessageReceived.Emit(entry);
+
+  const auto sequence = mLog.Push(
+    std::chrono::system_clock::now(),
+    message.mHeader.mProcessID,
+    winrt::to_string(message.mHeader.mExecutable),
+    winrt::to_string(message.mHeader.mPrefix),
+    level,
+    winrt::to_string(text));
+  evMessageReceived.Emit(sequence);
+}
+
+std::vector<TroubleshootingStore::DPrintEntry>
+TroubleshootingStore::GetDPrintEntriesSince(
+  LogRing::Sequence after,
+  const LogRing::Filter& filter) const {
+  return mDPrintLog.GetSince(after, filter);
+}
+
+LogRing::Source TroubleshootingStore::GetDPrintSource(
+  LogRing::SourceID id) const {
+  return mDPrintLog.GetSource(id);
+}
+
+std::vector<LogRing::Source> TroubleshootingStore::GetDPrintSources() const {
+  return mDPrintLog.GetSources();
 }
 
 std::string TroubleshootingStore::GetDPrintDebugLogAsString() const {
-  const auto messages = mDPrint->GetMessages();
+  // As this is called by the fatal error handler, every read here uses the
+  // ring's timed lock; if we crashed in `Push()`, we get nothing rather
+  // than a deadlock
+  const auto stats = mDPrintLog.GetStatistics();
+  if (stats.mEntries == 0) {
+    return "No log messages (?!), or timed out waiting for the log";
+  }
 
-  if (messages.empty()) {
-    return "No log messages (?!)";
+  std::string ret;
+  // Formatting adds a timestamp, executable, and prefix to each message
+  ret.reserve(stats.mBytes + (stats.mEntries * 96));
+  if (stats.mDropped) {
+    ret += std::format(
+      "[{} older messages were dropped to limit memory usage]\n",
+      stats.mDropped);
   }
 
-  std::wstring ret;
-  for (const auto& entry: messages) {
-    auto exe = std::wstring_view(entry.mExecutable);
-    {
-      auto dirSep = exe.find_last_of(L'\\');
-      if (dirSep != exe.npos && dirSep + 1 < exe.size()) {
-        exe.remove_prefix(dirSep + 1);
-      }
+  using enum LogRing::Level;
+  // Errors are usually what we're looking for, and rare enough to copy.
+  // Fetched before the sources, so every entry's source is in the list.
+  const auto errors = this->GetDPrintEntriesSince(0, {.mLevel = Error});
+  const auto sources = this->GetDPrintSources();
+
+  // Summarize from the indices, so it's cheap even for a full ring
+  ret += std::format(
+    "{} messages: {} errors, {} warnings\n",
+    stats.mEntries,
+    mDPrintLog.GetCount({.mLevel = Error}),
+    mDPrintLog.GetCount({.mLevel = Warning}));
+  for (LogRing::SourceID id = 0; id < sources.size(); ++id) {
+    const auto count = mDPrintLog.GetCount({.mSource = id});
+    if (count == 0) {
+      continue;
     }
-
     ret += std::format(
-      L"[{:%F %T} {} ({})] {}: {}\n",
-      std::chrono::zoned_time(
-        std::chrono::current_zone(),
-        std::chrono::time_point_cast<std::chrono::seconds>(entry.mWhen)),
-      exe,
-      entry.mProcessID,
-      entry.mPrefix,
-      entry.mMessage);
+      "  {} ({}): {} messages\n",
+      sources.at(id).mExecutable,
+      sources.at(id).mPrefix,
+      count);
+  }
+
+  if (!errors.empty()) {
+    ret += "\nErrors:\n";
+    for (auto&& entry: errors) {
+      ret += FormatDPrintEntry(entry, sources.at(entry.mSource));
+    }
+  }
+  ret += "\nAll messages:\n";
+
+  // Format straight from the ring in batches, rather than copying the whole
+  // ring first, or blocking new messages until we're done
+  LogRing::Sequence sequence {0};
+  while (true) {
+    const auto previous = sequence;
+    const auto next = mDPrintLog.VisitSince(
+      previous,
+      DPrintReadBatchSize,
+      [&ret](const DPrintEntry& entry, const LogRing::Source& source) {
+        ret += FormatDPrintEntry(entry, source);
+      });
+    if (!next) {
+      ret += "[timed out waiting for the log; later messages are missing]\n";
+      break;
+    }
+    if (*next == previous) {
+      break;
+    }
+    sequence = *next;
   }
 
-  return winrt::to_string(ret);
+  return ret;
 }
 
 }// namespace OpenKneeboard
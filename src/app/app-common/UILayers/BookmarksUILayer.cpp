@@ -10,6 +10,8 @@
 
 #include <OpenKneeboard/config.hpp>
 
+#include <format>
+
 namespace OpenKneeboard {
 
 std::shared_ptr<BookmarksUILayer> BookmarksUILayer::Create(
@@ -54,6 +56,7 @@ void BookmarksUILayer::Init() {
       weak_from_this(),
       [](auto self) {
         self->mButtons = {};
+        ++self->mBookmarksGeneration;
         self->evNeedsRepaintEvent.Emit();
       },
     });
@@ -166,38 +169,17 @@ task<void> BookmarksUILayer::Render(
     },
   };
 
-  auto d2d = rc.d2d();
-  d2d->FillRectangle(bookmarksArea, mBackgroundBrush.get());
-
   auto [hoverButton, buttons] = this->LayoutButtons()->GetState();
 
-  const auto height = metrics.mPreferredSize.mPixelSize.mHeight;
   const auto width = metrics.mNextArea.Left();
 
-  if (width == 0) {
+  if (width == 0 || bookmarksArea.Width() == 0) {
     co_await first->Render(rc, rest, context, rect);
     co_return;
   }
 
-  FLOAT dpix {}, dpiy {};
-  d2d->GetDpi(&dpix, &dpiy);
-  const auto textHeight = width * scale * 0.75;
-  winrt::com_ptr<IDWriteTextFormat> textFormat;
-  winrt::check_hresult(mDXResources->mDWriteFactory->CreateTextFormat(
-    FixedWidthUIFont,
-    nullptr,
-    DWRITE_FONT_WEIGHT_REGULAR,
-    DWRITE_FONT_STYLE_NORMAL,
-    DWRITE_FONT_STRETCH_NORMAL,
-    felly::numeric_cast<float>((textHeight * 96) / (2 * dpiy)),
-    L"",
-    textFormat.put()));
-  textFormat->SetReadingDirection(DWRITE_READING_DIRECTION_TOP_TO_BOTTOM);
-  textFormat->SetFlowDirection(DWRITE_FLOW_DIRECTION_LEFT_TO_RIGHT);
-  textFormat->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_CENTER);
-  textFormat->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_CENTER);
-
-  size_t buttonNumber = 0;
+  auto d2d = rc.d2d();
+
   const auto currentTabView = mKneeboardView->GetCurrentTabView();
   const auto currentTab = currentTabView->GetTab().lock();
   if (!currentTab) {
@@ -206,41 +188,43 @@ task<void> BookmarksUILayer::Render(
 
   const auto currentTabID = currentTab->GetRuntimeID();
   const auto currentPageID = currentTabView->GetPageID();
-  for (const auto& button: buttons) {
-    const D2D1_RECT_F buttonRect {
-      bookmarksArea.Left<FLOAT>(),
-      std::floor(rect.Top() + (button.mRect.top * height * scale)),
-      bookmarksArea.Right<FLOAT>(),
-      std::floor(rect.Top() + (button.mRect.bottom * height * scale)),
-    };
-    buttonNumber++;
-    const auto text = winrt::to_hstring(
-      button.mBookmark.mTitle.empty() ? std::format(_("#{}"), buttonNumber)
-                                      : button.mBookmark.mTitle);
-
-    auto textBrush = (button == hoverButton) ? mHoverBrush : mTextBrush;
-
-    d2d->DrawTextW(
-      text.data(), text.size(), textFormat.get(), buttonRect, textBrush.get());
+  Snapshot::PaintState paintState;
+  for (std::size_t i = 0; i < buttons.size(); ++i) {
+    const auto& button = buttons.at(i);
+    if (button == hoverButton) {
+      paintState.mHoverButton = i;
+    }
     if (
       button.mBookmark.mTabID == currentTabID
-      && button.mBookmark.mPageID == currentPageID) {
-      d2d->DrawLine(
-        {buttonRect.right - 5, buttonRect.top + 1},
-        {buttonRect.right - 5, buttonRect.bottom},
-        mCurrentPageStrokeBrush.get(),
-        4.0f,
-        mCurrentPageStrokeStyle.get());
-    }
-    if (buttonNumber != 1) {
-      d2d->DrawLine(
-        {buttonRect.left, buttonRect.top},
-        {buttonRect.right, buttonRect.top},
-        mTextBrush.get(),
-        2.0f);
+      && button.mBookmark.mPageID == currentPageID
+      && !paintState.mCurrentPageButton) {
+      paintState.mCurrentPageButton = i;
     }
   }
 
+  FLOAT dpix {}, dpiy {};
+  d2d->GetDpi(&dpix, &dpiy);
+  const Snapshot::Key key {
+    .mBookmarksGeneration = mBookmarksGeneration,
+    .mDPI = dpiy,
+    .mWidth = bookmarksArea.Width(),
+    .mHeight = bookmarksArea.Height(),
+  };
+
+  auto& snapshot = mSnapshots[rc.GetRenderTarget()->GetID()];
+  if (!(snapshot && snapshot->GetKey() == key)) {
+    snapshot = this->BuildSnapshot(key, buttons);
+  }
+
+  d2d->FillRectangle(bookmarksArea, mBackgroundBrush.get());
+  const D2D1_POINT_2F origin {
+    bookmarksArea.Left<float>(),
+    bookmarksArea.Top<float>(),
+  };
+  for (std::size_t i = 0; i < snapshot->GetButtons().size(); ++i) {
+    this->PaintButton(d2d, origin, *snapshot, i, paintState);
+  }
+
   d2d.Release();
   co_await first->Render(rc, rest, context, nextArea);
   d2d.Reacquire();
@@ -263,7 +247,7 @@ bool BookmarksUILayer::IsEnabled() const {
 
 bool BookmarksUILayer::Button::operator==(const Button& other) const noexcept {
   return (memcmp(&mRect, &other.mRect, sizeof(mRect)) == 0)
-    && (mBookmark == mBookmark);
+    && (mBookmark == other.mBookmark);
 }
 
 BookmarksUILayer::Buttons BookmarksUILayer::LayoutButtons() {
@@ -295,6 +279,87 @@ BookmarksUILayer::Buttons BookmarksUILayer::LayoutButtons() {
   return clickableButtons;
 }
 
+std::shared_ptr<const BookmarksUILayer::Snapshot>
+BookmarksUILayer::BuildSnapshot(
+  const Snapshot::Key& key,
+  const std::vector<Button>& buttons) {
+  OPENKNEEBOARD_TraceLoggingScope("BookmarksUILayer::BuildSnapshot()");
+  const auto dwrite = mDXResources->mDWriteFactory.get();
+
+  winrt::com_ptr<IDWriteTextFormat> textFormat;
+  return Snapshot::Build(
+    key,
+    buttons.size(),
+    [&](std::size_t index, const Snapshot::Rect& rect, float fontSize) {
+      if (!textFormat) {
+        winrt::check_hresult(dwrite->CreateTextFormat(
+          FixedWidthUIFont,
+          nullptr,
+          DWRITE_FONT_WEIGHT_REGULAR,
+          DWRITE_FONT_STYLE_NORMAL,
+          DWRITE_FONT_STRETCH_NORMAL,
+          fontSize,
+          L"",
+          textFormat.put()));
+        textFormat->SetReadingDirection(
+          DWRITE_READING_DIRECTION_TOP_TO_BOTTOM);
+        textFormat->SetFlowDirection(DWRITE_FLOW_DIRECTION_LEFT_TO_RIGHT);
+        textFormat->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_CENTER);
+        textFormat->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_CENTER);
+      }
+
+      const auto& title = buttons.at(index).mBookmark.mTitle;
+      const auto text = winrt::to_hstring(
+        title.empty() ? std::format(_("#{}"), index + 1) : title);
+
+      winrt::com_ptr<IDWriteTextLayout> layout;
+      winrt::check_hresult(dwrite->CreateTextLayout(
+        text.data(),
+        text.size(),
+        textFormat.get(),
+        rect.mRight - rect.mLeft,
+        rect.mBottom - rect.mTop,
+        layout.put()));
+      return layout;
+    });
+}
+
+void BookmarksUILayer::PaintButton(
+  ID2D1DeviceContext* ctx,
+  const D2D1_POINT_2F& origin,
+  const Snapshot& snapshot,
+  std::size_t index,
+  const Snapshot::PaintState& state) {
+  const auto& button = snapshot.GetButtons()[index];
+  const D2D1_RECT_F rect {
+    origin.x + button.mRect.mLeft,
+    origin.y + button.mRect.mTop,
+    origin.x + button.mRect.mRight,
+    origin.y + button.mRect.mBottom,
+  };
+
+  if (button.mLabel) {
+    const auto textBrush
+      = (index == state.mHoverButton) ? mHoverBrush : mTextBrush;
+    ctx->DrawTextLayout(
+      {rect.left, rect.top}, button.mLabel.get(), textBrush.get());
+  }
+
+  if (index == state.mCurrentPageButton) {
+    ctx->DrawLine(
+      {rect.right - 5, rect.top + 1},
+      {rect.right - 5, rect.bottom},
+      mCurrentPageStrokeBrush.get(),
+      4.0f,
+      mCurrentPageStrokeStyle.get());
+  }
+
+  if (index != 0) {
+    ctx->DrawLine(
+      {rect.left, rect.top}, {rect.right, rect.top}, mTextBrush.get(), 2.0f);
+  }
+}
+
 void BookmarksUILayer::OnClick(const Button& button) {
   const auto tab = mKneeboardView->GetCurrentTabView()->GetRootTab().lock();
   if ((!tab) || (tab->GetRuntimeID() != button.mBookmark.mTabID)) {
@@ -102,7 +102,7 @@ task<void> TabViewUILayer::Render(
     co_return;
   }
 
-  co_await tab->RenderPage(rc, tabView->GetPageID(), rect);
+  co_await tabView->RenderPage(rc, rect);
 }
 
 void TabViewUILayer::RenderError(
@@ -7,8 +7,10 @@
 #pragma once
 
 #include <OpenKneeboard/Bookmark.hpp>
+#include <OpenKneeboard/BookmarksBarSnapshot.hpp>
 #include <OpenKneeboard/CursorClickableRegions.hpp>
 #include <OpenKneeboard/DXResources.hpp>
+#include <OpenKneeboard/RenderTargetID.hpp>
 #include <OpenKneeboard/UILayerBase.hpp>
 
 #include <OpenKneeboard/audited_ptr.hpp>
@@ -16,6 +18,7 @@
 #include <shims/winrt/base.h>
 
 #include <memory>
+#include <unordered_map>
 
 namespace OpenKneeboard {
 
@@ -75,6 +78,23 @@ class BookmarksUILayer final
   Buttons mButtons;
   Buttons LayoutButtons();
 
+  using Snapshot = BookmarksBarSnapshot<winrt::com_ptr<IDWriteTextLayout>>;
+
+  /// Render targets can have different sizes, so each has its own
+  std::unordered_map<RenderTargetID, std::shared_ptr<const Snapshot>>
+    mSnapshots;
+  uint64_t mBookmarksGeneration {};
+
+  std::shared_ptr<const Snapshot> BuildSnapshot(
+    const Snapshot::Key&,
+    const std::vector<Button>&);
+  void PaintButton(
+    ID2D1DeviceContext*,
+    const D2D1_POINT_2F& origin,
+    const Snapshot&,
+    std::size_t index,
+    const Snapshot::PaintState&);
+
   bool IsEnabled() const;
   void OnClick(const Button&);
 };
@@ -6,6 +6,7 @@
 // OpenKneeboard repository.
 
 #include <OpenKneeboard/Filesystem.hpp>
+#include <OpenKneeboard/InputRecording.hpp>
 #include <OpenKneeboard/OTDIPCClient.hpp>
 #include <OpenKneeboard/Win32.hpp>
 
@@ -566,10 +567,28 @@ task<void> OTDIPCClient::RunSingle() {
       co_return;
     }
 
-    this->EnqueueMessage({buffer, header->size});
+    const std::string_view message {buffer, header->size};
+    InputRecording::Record(InputRecording::Stream::OTDIPC, message);
+    this->EnqueueMessage(std::string {message});
   }
 }
 
+void OTDIPCClient::InjectMessage(std::string message) {
+  if (message.size() < sizeof(Header)) {
+    dprint.Warning("Injected OTD-IPC message is smaller than header size");
+    return;
+  }
+  const auto header = reinterpret_cast<const Header*>(message.data());
+  if (header->size != message.size()) {
+    dprint.Warning(
+      "Injected OTD-IPC message size {} does not match header size {}",
+      message.size(),
+      header->size);
+    return;
+  }
+  this->EnqueueMessage(std::move(message));
+}
+
 OpenKneeboard::fire_and_forget OTDIPCClient::EnqueueMessage(
   const std::string message) {
   const auto weakThis = weak_from_this();
@@ -342,4 +342,10 @@ std::vector<TabletInfo> TabletInputAdapter::GetTabletInfo() const {
   return {};
 }
 
+void TabletInputAdapter::InjectOTDIPCMessage(std::string message) {
+  if (mOTDIPC) {
+    mOTDIPC->InjectMessage(std::move(message));
+  }
+}
+
 }// namespace OpenKneeboard
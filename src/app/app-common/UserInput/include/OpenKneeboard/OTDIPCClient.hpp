@@ -43,6 +43,9 @@ class OTDIPCClient final : public std::enable_shared_from_this<OTDIPCClient>,
   Event<TabletInfo> evDeviceInfoReceivedEvent;
   Event<std::string, TabletState> evTabletInputEvent;
 
+  /// Handle a complete message, including header, e.g. from a recording
+  void InjectMessage(std::string message);
+
  private:
   DisposalState mDisposal;
   ProcessShutdownBlock mShutdownBlock;
@@ -14,6 +14,7 @@
 #include <Windows.h>
 
 #include <memory>
+#include <string>
 #include <tuple>
 #include <vector>
 
@@ -52,6 +53,9 @@ class TabletInputAdapter final
   std::vector<std::shared_ptr<UserInputDevice>> GetDevices() const;
   std::vector<TabletInfo> GetTabletInfo() const;
 
+  /// Replay a recorded OTD-IPC message, as if it came from the server
+  void InjectOTDIPCMessage(std::string message);
+
   Event<UserAction> evUserActionEvent;
   Event<std::shared_ptr<UserInputDevice>> evDeviceConnectedEvent;
 
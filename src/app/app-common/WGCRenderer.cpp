@@ -9,6 +9,7 @@
 #include <OpenKneeboard/Filesystem.hpp>
 #include <OpenKneeboard/KneeboardState.hpp>
 #include <OpenKneeboard/RuntimeFiles.hpp>
+#include <OpenKneeboard/Shaders/TileHash/DXBC.hpp>
 #include <OpenKneeboard/WGCRenderer.hpp>
 #include <OpenKneeboard/WindowCaptureControl.hpp>
 
@@ -45,6 +46,49 @@ namespace WGDX = winrt::Windows::Graphics::DirectX;
 
 namespace OpenKneeboard {
 
+namespace {
+
+/* Textures are reused while the new surface fits, as windows are often
+ * resized back and forth, and we only use the content rect anyway.
+ *
+ * They're only shrunk once they're much bigger than needed, so that a big
+ * window that's then made small doesn't hold on to its VRAM forever.
+ */
+bool ShouldRecreateTexture(
+  const D3D11_TEXTURE2D_DESC& existing,
+  const D3D11_TEXTURE2D_DESC& wanted) {
+  if (existing.Format != wanted.Format) {
+    return true;
+  }
+  if (wanted.Width > existing.Width || wanted.Height > existing.Height) {
+    return true;
+  }
+  constexpr uint64_t ShrinkRatio = 4;
+  const auto existingArea = uint64_t {existing.Width} * existing.Height;
+  const auto wantedArea = uint64_t {wanted.Width} * wanted.Height;
+  return wantedArea * ShrinkRatio < existingArea;
+}
+
+UINT GetByteWidth(ID3D11Buffer* buffer) {
+  if (!buffer) {
+    return 0;
+  }
+  D3D11_BUFFER_DESC desc {};
+  buffer->GetDesc(&desc);
+  return desc.ByteWidth;
+}
+
+// Matches `TileHashInfo` in TileHash.hlsl
+struct TileHashConstants {
+  uint32_t mWidth {};
+  uint32_t mHeight {};
+  uint32_t mColumns {};
+  uint32_t mPadding {};
+};
+static_assert(sizeof(TileHashConstants) % 16 == 0);
+
+}// namespace
+
 task<void> WGCRenderer::Init() {
   const auto keepAlive = shared_from_this();
 
@@ -75,6 +119,17 @@ task<void> WGCRenderer::Init() {
     supportsSecondaryWindows = false;
   }
 
+  // Requires Windows 11 24H2
+  bool supportsDirtyRegions = false;
+  try {
+    supportsDirtyRegions =
+      winrt::Windows::Foundation::Metadata::ApiInformation::IsPropertyPresent(
+        RuntimeClass_Windows_Graphics_Capture_GraphicsCaptureSession,
+        L"DirtyRegionMode");
+  } catch (const winrt::hresult_class_not_registered&) {
+    supportsDirtyRegions = false;
+  }
+
   co_await mUIThread;
   const std::unique_lock d2dlock(*mDXR);
 
@@ -121,6 +176,13 @@ task<void> WGCRenderer::Init() {
   if (supportsSecondaryWindows) {
     mCaptureSession.IncludeSecondaryWindows(true);
   }
+
+  if (supportsDirtyRegions) {
+    // Still render the full frame, but tell us what changed
+    mCaptureSession.DirtyRegionMode(
+      WGC::GraphicsCaptureDirtyRegionMode::ReportOnly);
+    mHaveWGCDirtyRegions = true;
+  }
   mCaptureSession.StartCapture();
 
   mCaptureItem = item;
@@ -161,6 +223,13 @@ task<void> WGCRenderer::DisposeAsync() noexcept {
     std::move(mCaptureItem), std::move(mCaptureSession), std::move(mFramePool));
 
   mTexture = nullptr;
+  mReadbacks = {};
+  mFirstPendingReadback = 0;
+  mPendingReadbackCount = 0;
+  mTileHashesUAV = nullptr;
+  mTileHashes = nullptr;
+  mTileHashConstants = nullptr;
+  mTileHashShader = nullptr;
 }
 
 bool WGCRenderer::HaveCaptureItem() const {
@@ -243,6 +312,7 @@ void WGCRenderer::OnWGCFrame(
       TraceLoggingValue(swapchainDimensions.mHeight, "Height"));
     std::unique_lock lock(*mDXR);
     mSwapchainDimensions = swapchainDimensions;
+    mTextureIsStale = true;
     mFramePool.Recreate(
       mWinRTD3DDevice,
       this->GetPixelFormat(),
@@ -261,7 +331,7 @@ void WGCRenderer::OnWGCFrame(
   if (mTexture) {
     D3D11_TEXTURE2D_DESC desc {};
     mTexture->GetDesc(&desc);
-    if (surfaceDesc.Width != desc.Width || surfaceDesc.Height != desc.Height) {
+    if (ShouldRecreateTexture(desc, surfaceDesc)) {
       TraceLoggingWriteTagged(
         activity, "WGCRenderer::OnWGCFrame()/ResettingTexture");
       mTexture = nullptr;
@@ -280,12 +350,17 @@ void WGCRenderer::OnWGCFrame(
     mShaderResourceView = nullptr;
     winrt::check_hresult(mDXR->mD3D11Device->CreateShaderResourceView(
       mTexture.get(), nullptr, mShaderResourceView.put()));
+    mTextureIsStale = true;
   }
 
-  mCaptureSize = {
+  const PixelSize newCaptureSize {
     static_cast<uint32_t>(captureSize.Width),
     static_cast<uint32_t>(captureSize.Height),
   };
+  if (newCaptureSize != mCaptureSize) {
+    mTextureIsStale = true;
+    mCaptureSize = newCaptureSize;
+  }
 
   TraceLoggingWriteTagged(
     activity,
@@ -293,11 +368,252 @@ void WGCRenderer::OnWGCFrame(
     TraceLoggingValue(captureSize.Width, "Width"),
     TraceLoggingValue(captureSize.Height, "Height"));
 
-  mDXR->mD3D11ImmediateContext->CopySubresourceRegion(
-    mTexture.get(), 0, 0, 0, 0, d3dSurface.get(), 0, nullptr);
+  if (!mHaveWGCDirtyRegions) {
+    // We find out what changed by hashing the frame on the GPU and reading
+    // back the hashes, which takes a frame or two to complete; copy the whole
+    // frame now, and only repaint once we know it changed. The copy stays on
+    // the GPU, so it's much cheaper than the repaint we might avoid.
+    this->PollReadbacks();
+    bool queued = false;
+    {
+      std::unique_lock lock(*mDXR);
+      this->CopyToTexture(d3dSurface.get(), {{0, 0}, mCaptureSize});
+      queued = this->QueueReadback(mCaptureSize);
+    }
+    // If we couldn't queue it, we'll never know if it changed, so assume it
+    // did
+    if (mTextureIsStale || !queued) {
+      mTextureIsStale = false;
+      this->PublishFrame();
+    }
+    return;
+  }
+
+  const auto dirty = this->GetWGCDirtyRegion(frame, mCaptureSize);
+  if (dirty.IsEmpty()) {
+    ++mSkippedFrames;
+    TraceLoggingWriteTagged(
+      activity,
+      "WGCRenderer::OnWGCFrame()/Unchanged",
+      TraceLoggingValue(mSkippedFrames, "SkippedFrames"),
+      TraceLoggingValue(mPublishedFrames, "PublishedFrames"));
+    return;
+  }
+
+  {
+    std::unique_lock lock(*mDXR);
+    for (auto&& rect: dirty.GetRects()) {
+      this->CopyToTexture(d3dSurface.get(), rect);
+    }
+  }
+  mTextureIsStale = false;
+  TraceLoggingWriteTagged(
+    activity,
+    "WGCRenderer::OnWGCFrame()/Dirty",
+    TraceLoggingValue(dirty.GetRects().size(), "DirtyRectCount"),
+    TraceLoggingValue(dirty.GetArea(), "DirtyArea"));
+  this->PublishFrame();
+}
+
+void WGCRenderer::PublishFrame() {
+  ++mPublishedFrames;
+  TraceLoggingWrite(
+    gTraceProvider,
+    "WGCRenderer::PublishFrame()",
+    TraceLoggingValue(mPublishedFrames, "PublishedFrames"),
+    TraceLoggingValue(mSkippedFrames, "SkippedFrames"));
   this->evNeedsRepaintEvent.Emit();
 }
 
+void WGCRenderer::CopyToTexture(
+  ID3D11Texture2D* surface,
+  const PixelRect& rect) {
+  const D3D11_BOX box {
+    .left = rect.Left(),
+    .top = rect.Top(),
+    .front = 0,
+    .right = rect.Right(),
+    .bottom = rect.Bottom(),
+    .back = 1,
+  };
+  mDXR->mD3D11ImmediateContext->CopySubresourceRegion(
+    mTexture.get(), 0, rect.Left(), rect.Top(), 0, surface, 0, &box);
+}
+
+DirtyRegion WGCRenderer::GetWGCDirtyRegion(
+  const WGC::Direct3D11CaptureFrame& frame,
+  const PixelSize& captureSize) {
+  DirtyRegion ret {captureSize};
+  if (mTextureIsStale) {
+    ret.AddAll();
+    return ret;
+  }
+
+  for (auto&& rect: frame.DirtyRegions()) {
+    ret.Add({
+      {
+        static_cast<uint32_t>(std::max(rect.X, 0)),
+        static_cast<uint32_t>(std::max(rect.Y, 0)),
+      },
+      {
+        static_cast<uint32_t>(std::max(rect.Width, 0)),
+        static_cast<uint32_t>(std::max(rect.Height, 0)),
+      },
+    });
+  }
+  return ret;
+}
+
+bool WGCRenderer::QueueReadback(const PixelSize& captureSize) {
+  if (mPendingReadbackCount == mReadbacks.size()) {
+    // The GPU is behind; we'll catch up with a later frame
+    return false;
+  }
+  auto& readback = mReadbacks.at(
+    (mFirstPendingReadback + mPendingReadbackCount) % mReadbacks.size());
+
+  auto device = mDXR->mD3D11Device.get();
+  auto ctx = mDXR->mD3D11ImmediateContext.get();
+
+  if (!mTileHashShader) {
+    namespace Shaders = OpenKneeboard::Shaders::TileHash::DXBC;
+    winrt::check_hresult(device->CreateComputeShader(
+      Shaders::CS.data(), Shaders::CS.size(), nullptr, mTileHashShader.put()));
+    const D3D11_BUFFER_DESC desc {
+      .ByteWidth = sizeof(TileHashConstants),
+      .Usage = D3D11_USAGE_DYNAMIC,
+      .BindFlags = D3D11_BIND_CONSTANT_BUFFER,
+      .CPUAccessFlags = D3D11_CPU_ACCESS_WRITE,
+    };
+    winrt::check_hresult(
+      device->CreateBuffer(&desc, nullptr, mTileHashConstants.put()));
+  }
+
+  const auto grid = TileHashChangeDetector::GetTileGrid(captureSize);
+  const auto byteWidth
+    = static_cast<UINT>(grid.mWidth * grid.mHeight * sizeof(uint64_t));
+  if (byteWidth == 0) {
+    return false;
+  }
+
+  // Hashes are a few bytes per 64x64 tile, so these only ever grow
+  if (GetByteWidth(mTileHashes.get()) < byteWidth) {
+    mTileHashesUAV = nullptr;
+    mTileHashes = nullptr;
+    const D3D11_BUFFER_DESC desc {
+      .ByteWidth = byteWidth,
+      .Usage = D3D11_USAGE_DEFAULT,
+      .BindFlags = D3D11_BIND_UNORDERED_ACCESS,
+      .MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED,
+      .StructureByteStride = sizeof(uint64_t),
+    };
+    winrt::check_hresult(
+      device->CreateBuffer(&desc, nullptr, mTileHashes.put()));
+    winrt::check_hresult(device->CreateUnorderedAccessView(
+      mTileHashes.get(), nullptr, mTileHashesUAV.put()));
+  }
+  if (GetByteWidth(readback.mBuffer.get()) < byteWidth) {
+    readback.mBuffer = nullptr;
+    const D3D11_BUFFER_DESC desc {
+      .ByteWidth = byteWidth,
+      .Usage = D3D11_USAGE_STAGING,
+      .CPUAccessFlags = D3D11_CPU_ACCESS_READ,
+    };
+    winrt::check_hresult(
+      device->CreateBuffer(&desc, nullptr, readback.mBuffer.put()));
+  }
+
+  {
+    D3D11_MAPPED_SUBRESOURCE mapped {};
+    winrt::check_hresult(ctx->Map(
+      mTileHashConstants.get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped));
+    *static_cast<TileHashConstants*>(mapped.pData) = {
+      .mWidth = captureSize.mWidth,
+      .mHeight = captureSize.mHeight,
+      .mColumns = grid.mWidth,
+    };
+    ctx->Unmap(mTileHashConstants.get(), 0);
+  }
+
+  {
+    const auto constants = mTileHashConstants.get();
+    const auto srv = mShaderResourceView.get();
+    const auto uav = mTileHashesUAV.get();
+    ctx->CSSetShader(mTileHashShader.get(), nullptr, 0);
+    ctx->CSSetConstantBuffers(0, 1, &constants);
+    ctx->CSSetShaderResources(0, 1, &srv);
+    ctx->CSSetUnorderedAccessViews(0, 1, &uav, nullptr);
+    ctx->Dispatch(grid.mWidth, grid.mHeight, 1);
+
+    ID3D11Buffer* const nullBuffer {nullptr};
+    ID3D11ShaderResourceView* const nullSRV {nullptr};
+    ID3D11UnorderedAccessView* const nullUAV {nullptr};
+    ctx->CSSetShader(nullptr, nullptr, 0);
+    ctx->CSSetConstantBuffers(0, 1, &nullBuffer);
+    ctx->CSSetShaderResources(0, 1, &nullSRV);
+    ctx->CSSetUnorderedAccessViews(0, 1, &nullUAV, nullptr);
+  }
+
+  const D3D11_BOX box {
+    .left = 0,
+    .top = 0,
+    .front = 0,
+    .right = byteWidth,
+    .bottom = 1,
+    .back = 1,
+  };
+  ctx->CopySubresourceRegion(
+    readback.mBuffer.get(), 0, 0, 0, 0, mTileHashes.get(), 0, &box);
+  readback.mSize = captureSize;
+  ++mPendingReadbackCount;
+  return true;
+}
+
+void WGCRenderer::PollReadbacks() {
+  if (mPendingReadbackCount == 0) {
+    return;
+  }
+  OPENKNEEBOARD_TraceLoggingScope("WGCRenderer::PollReadbacks()");
+
+  auto ctx = mDXR->mD3D11ImmediateContext.get();
+  std::size_t completed = 0;
+  bool changed = false;
+  {
+    const std::unique_lock lock(*mDXR);
+    // Oldest first, as each frame is compared to the previous one
+    while (mPendingReadbackCount > 0) {
+      auto& readback = mReadbacks.at(mFirstPendingReadback);
+      auto buffer = readback.mBuffer.get();
+
+      D3D11_MAPPED_SUBRESOURCE mapped {};
+      const auto result = ctx->Map(
+        buffer, 0, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped);
+      if (result == DXGI_ERROR_WAS_STILL_DRAWING) {
+        break;
+      }
+      winrt::check_hresult(result);
+      const scope_exit unmap([&]() { ctx->Unmap(buffer, 0); });
+
+      const auto grid = TileHashChangeDetector::GetTileGrid(readback.mSize);
+      const auto dirty = mChangeDetector.Update(
+        {static_cast<const uint64_t*>(mapped.pData),
+         static_cast<std::size_t>(grid.mWidth) * grid.mHeight},
+        readback.mSize);
+      changed = changed || !dirty.IsEmpty();
+
+      ++completed;
+      mFirstPendingReadback = (mFirstPendingReadback + 1) % mReadbacks.size();
+      --mPendingReadbackCount;
+    }
+  }
+
+  if (changed) {
+    this->PublishFrame();
+  } else if (completed > 0) {
+    mSkippedFrames += completed;
+  }
+}
+
 void WGCRenderer::PreOKBFrame() {
   if (!mFramePool) {
     return;
@@ -306,7 +622,11 @@ void WGCRenderer::PreOKBFrame() {
   auto frame = mFramePool.TryGetNextFrame();
   if (frame) {
     this->OnWGCFrame(std::move(frame));
+    return;
   }
+  // WGC only sends frames when something changed, so the last readback may
+  // still be pending
+  this->PollReadbacks();
 }
 
 OpenKneeboard::fire_and_forget WGCRenderer::ForceResize(PixelSize size) {
@@ -29,6 +29,9 @@ class APIEventServer final
 
   Event<APIEvent> evAPIEvent;
 
+  /// Handle a serialized event; also used to replay recorded input
+  OpenKneeboard::fire_and_forget DispatchEvent(std::string_view);
+
  private:
   ProcessShutdownBlock mShutdownBlock;
   APIEventServer();
@@ -41,7 +44,6 @@ class APIEventServer final
   task<void> Run();
   static task<bool>
   RunSingle(std::weak_ptr<APIEventServer>, HANDLE event, HANDLE mailslot);
-  OpenKneeboard::fire_and_forget DispatchEvent(std::string_view);
 };
 
 }// namespace OpenKneeboard
@@ -17,6 +17,7 @@
 
 #include <functional>
 #include <mutex>
+#include <vector>
 
 #include <d2d1_2.h>
 
@@ -24,11 +25,23 @@ namespace OpenKneeboard {
 
 struct DXResources;
 
+/** Cache rendered content, e.g. a page, in a texture.
+ *
+ * Each layer keeps up to `maxEntries` entries (e.g. pages, or sizes), so
+ * switching between them doesn't re-render. Textures come from a
+ * process-wide pool with a shared VRAM budget; when the pool is over budget,
+ * the least-recently-used textures are evicted from any layer.
+ */
 class CachedLayer final {
  public:
   using Key = size_t;
+  static constexpr std::size_t DefaultMaxEntries = 4;
+  static constexpr std::size_t DefaultVRAMBudget = 512 * 1024 * 1024;
+
   CachedLayer() = delete;
-  CachedLayer(const audited_ptr<DXResources>&);
+  CachedLayer(
+    const audited_ptr<DXResources>&,
+    std::size_t maxEntries = DefaultMaxEntries);
   ~CachedLayer();
 
   [[nodiscard]]
@@ -40,15 +53,25 @@ class CachedLayer final {
     const std::optional<PixelSize>& cacheDimensions = {});
   void Reset();
 
+  /// Set the budget for all `CachedLayer`s in the process
+  static void SetVRAMBudget(std::size_t bytes);
+
  private:
-  Key mKey = ~Key {0};
+  struct Entry {
+    Key mKey {};
+    PixelSize mSize;
+    /// May have been evicted from the pool
+    uint64_t mTextureID {};
+  };
+
   audited_ptr<DXResources> mDXR;
+  std::size_t mMaxEntries {};
 
-  PixelSize mCacheDimensions;
   std::mutex mCacheMutex;
+  /// Kept for the lifetime of the layer, as content may cache by its ID
   std::shared_ptr<RenderTarget> mCacheRenderTarget;
-  winrt::com_ptr<ID3D11Texture2D> mCache;
-  winrt::com_ptr<ID3D11ShaderResourceView> mCacheSRV;
+  /// Most-recently-used first
+  std::vector<Entry> mEntries;
 };
 
 }// namespace OpenKneeboard
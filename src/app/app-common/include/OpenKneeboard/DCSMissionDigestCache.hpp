@@ -0,0 +1,56 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <OpenKneeboard/DCSMissionDigest.hpp>
+#include <OpenKneeboard/DebouncedFileWriter.hpp>
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+
+namespace OpenKneeboard {
+
+/** `DCSMissionDigest`s for extracted missions, cached on disk.
+ *
+ * Digests are keyed by a hash of the mission's Lua files, so a mission that
+ * has been seen before - in this session or a previous one - is loaded
+ * without executing any Lua.
+ *
+ * Owned by `KneeboardState`, which flushes it on shutdown.
+ */
+class DCSMissionDigestCache final {
+ public:
+  /// The least-recently-used digests beyond this are removed
+  static constexpr std::size_t MaxEntries = 64;
+
+  DCSMissionDigestCache();
+  /// Flushes pending writes
+  ~DCSMissionDigestCache();
+
+  DCSMissionDigestCache(const DCSMissionDigestCache&) = delete;
+  DCSMissionDigestCache(DCSMissionDigestCache&&) = delete;
+  DCSMissionDigestCache& operator=(const DCSMissionDigestCache&) = delete;
+  DCSMissionDigestCache& operator=(DCSMissionDigestCache&&) = delete;
+
+  /** Get the digest for the mission extracted to `extractedPath`.
+   *
+   * Returns nullptr if there is no mission, or its Lua can't be executed.
+   */
+  [[nodiscard]]
+  std::shared_ptr<const DCSMissionDigest> Load(
+    const std::filesystem::path& extractedPath);
+
+  /// Write any pending changes, and wait for them to finish
+  void Flush();
+
+ private:
+  const std::filesystem::path mDirectory;
+
+  std::mutex mMutex;
+  DebouncedFileWriter mWriter;
+
+  void Store(const std::filesystem::path&, const DCSMissionDigest&);
+};
+
+}// namespace OpenKneeboard
@@ -10,6 +10,7 @@
 #include <OpenKneeboard/Events.hpp>
 #include <OpenKneeboard/KneeboardState.hpp>
 #include <OpenKneeboard/KneeboardView.hpp>
+#include <OpenKneeboard/RepaintRequests.hpp>
 #include <OpenKneeboard/SHM.hpp>
 
 #include <OpenKneeboard/audited_ptr.hpp>
@@ -23,6 +24,7 @@
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <vector>
 
 #include <d2d1.h>
 #include <d2d1_1.h>
@@ -49,7 +51,13 @@ class InterprocessRenderer final
     KneeboardState*);
 
   void PostUserAction(UserAction);
-  [[nodiscard]] task<void> RenderNow() noexcept;
+  /** Render the views, and publish them to the SHM.
+   *
+   * Views that aren't included in `requests` are left as they were on the
+   * canvas, unless the canvas or the layout of views has changed.
+   */
+  [[nodiscard]] task<void> RenderNow(
+    const RepaintRequestBus::Frame& requests) noexcept;
 
   [[nodiscard]]
   uint64_t GetFrameCountForMetricsOnly() const;
@@ -96,8 +104,22 @@ class InterprocessRenderer final
   std::shared_ptr<RenderTargetWithMultipleIdentities> mCanvas;
   PixelSize mCanvasSize;
 
+  /// What a view on the canvas was rendered with
+  struct CanvasLayer {
+    uint64_t mView {};
+    PixelSize mFullSize {};
+    bool mIsActiveForInput {false};
+
+    constexpr bool operator==(const CanvasLayer&) const noexcept = default;
+  };
+  /// Empty if the canvas has nothing worth keeping
+  std::vector<CanvasLayer> mCanvasLayers;
+
   void InitializeCanvas(const PixelSize&);
 
+  SHM::LayerConfig GetLayerConfig(
+    const ViewRenderInfo&,
+    const PixelRect& bounds) noexcept;
   task<SHM::LayerConfig> RenderLayer(
     const ViewRenderInfo&,
     const PixelRect& bounds) noexcept;
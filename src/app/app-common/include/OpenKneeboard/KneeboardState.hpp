@@ -12,6 +12,7 @@
 #include <OpenKneeboard/IHasDisposeAsync.hpp>
 #include <OpenKneeboard/KneeboardView.hpp>
 #include <OpenKneeboard/ProfileSettings.hpp>
+#include <OpenKneeboard/RepaintRequests.hpp>
 #include <OpenKneeboard/RunnerThread.hpp>
 #include <OpenKneeboard/SHM.hpp>
 #include <OpenKneeboard/Settings.hpp>
@@ -25,23 +26,29 @@
 
 #include <winrt/Windows.Foundation.h>
 
+#include <filesystem>
 #include <memory>
 #include <queue>
 #include <shared_mutex>
+#include <stop_token>
 #include <thread>
 #include <vector>
 
 namespace OpenKneeboard {
 
 enum class UserAction;
+class DCSMissionDigestCache;
 class DirectInputAdapter;
+class FolderPageSourceRegistry;
 class PluginStore;
+class SettingsFiles;
 class KneeboardView;
 class InterprocessRenderer;
 class KneeboardView;
 class ITab;
 class TabletInputAdapter;
 class TabsList;
+class ThumbnailCache;
 class UserInputDevice;
 struct BaseSetTabEvent;
 class APIEventServer;
@@ -87,6 +94,11 @@ class KneeboardState final
   std::vector<ViewRenderInfo> GetViewRenderInfo() const;
 
   Event<> evFrameTimerPreEvent;
+  /** Emitted when a repaint request raises the pending priority.
+   *
+   * This includes the first request after `TakeRepaintRequests()`.
+   */
+  Event<RepaintPriority> evNeedsRepaintEvent;
   Event<FramePostEventKind> evFrameTimerPostEvent;
   Event<> evSettingsChangedEvent;
   Event<> evProfileSettingsChangedEvent;
@@ -114,6 +126,10 @@ class KneeboardState final
   void NotifyAppWindowIsForeground(bool isForeground);
 
   TabsList* GetTabsList() const;
+  FolderPageSourceRegistry* GetFolderPageSourceRegistry() const;
+  DCSMissionDigestCache* GetDCSMissionDigestCache() const;
+  ThumbnailCache* GetThumbnailCache() const;
+  SettingsFiles* GetSettingsFiles() const;
   InterprocessRenderer* GetInterprocessRenderer() const;
 
   task<void> ReleaseExclusiveResources();
@@ -132,8 +148,11 @@ class KneeboardState final
   [[nodiscard]] task<void> PostUserAction(UserAction action);
 
   bool IsRepaintNeeded() const;
-  void SetRepaintNeeded();
-  void Repainted();
+  void RequestRepaint(const RepaintRequest&);
+  /// Request a repaint of every view
+  void SetRepaintNeeded(RepaintReason);
+  /// Take the merged requests; call this immediately before repainting
+  void TakeRepaintRequests(RepaintRequestBus::Frame&);
 
   /** Implement `Lockable`; use `std::unique_lock`.
    *
@@ -154,10 +173,23 @@ class KneeboardState final
 
   auto GetDXResources() const noexcept { return mDXResources; }
 
+  /** Replay input recorded with `InputRecording`.
+   *
+   * @param speed 1 for the original speed, 0 for as fast as possible
+   */
+  void StartInputReplay(std::filesystem::path, double speed);
+
   task<void> FlushOrderedEventQueue(
     std::chrono::time_point<std::chrono::steady_clock> stopAt);
   void EnqueueOrderedEvent(std::function<task<void>()>);
 
+  /** Render pages that are likely to be shown next, if there's time.
+   *
+   * Callers must hold the DXResources lock.
+   */
+  task<void> PrerenderPages(
+    std::chrono::time_point<std::chrono::steady_clock> stopAt);
+
  private:
   KneeboardState(HWND mainWindow, const audited_ptr<DXResources>&);
   [[nodiscard]] task<void> Init();
@@ -171,13 +203,21 @@ class KneeboardState final
   std::optional<std::thread::id> mUniqueLockThread {};
   std::size_t mUniqueLockDepth = 0;
 
-  bool mNeedsRepaint;
+  RepaintRequestBus mRepaintRequests;
   winrt::apartment_context mUIThread;
   HWND mHwnd;
   audited_ptr<DXResources> mDXResources;
+  // Before `mSettings`, which is loaded through it
+  std::unique_ptr<SettingsFiles> mSettingsFiles;
   ProfileSettings mProfiles {ProfileSettings::Load()};
-  Settings mSettings {
-    Settings::Load(mProfiles.mDefaultProfile, mProfiles.mActiveProfile)};
+  Settings mSettings {Settings::Load(
+    *mSettingsFiles,
+    mProfiles.mDefaultProfile,
+    mProfiles.mActiveProfile)};
+
+  // Before `mViews`, so that it outlives the navigation tabs that use it
+  std::unique_ptr<ThumbnailCache> mThumbnailCache;
+  std::optional<task<void>> mThumbnailCacheLoad;
 
   uint8_t mInputViewIndex = 0;
   std::vector<std::shared_ptr<KneeboardView>> mViews;
@@ -187,6 +227,9 @@ class KneeboardState final
 
   PixelSize mLastNonVRPixelSize {};
 
+  std::shared_ptr<FolderPageSourceRegistry> mFolderPageSources;
+  // Before `mTabsList`, so that it outlives the tabs that use it
+  std::unique_ptr<DCSMissionDigestCache> mDCSMissionDigestCache;
   std::shared_ptr<TabsList> mTabsList;
   std::shared_ptr<InterprocessRenderer> mInterprocessRenderer;
   // Initalization and destruction order must match as they both use
@@ -197,6 +240,8 @@ class KneeboardState final
   std::shared_ptr<PluginStore> mPluginStore;
 
   std::shared_ptr<APIEventServer> mAPIEventServer;
+  std::stop_source mInputReplayStop;
+  std::optional<task<void>> mInputReplay;
   RunnerThread mOpenVRThread;
   std::optional<GameProcess> mCurrentGame;
   std::optional<GameProcess> mMostRecentGame;
@@ -210,6 +255,7 @@ class KneeboardState final
   void OnGameChangedEvent(DWORD processID, const std::filesystem::path&);
   void OnAPIEvent(APIEvent) noexcept;
   task<void> ProcessAPIEvent(APIEvent) noexcept;
+  task<void> ReplayInput(std::filesystem::path, double speed);
 
   void BeforeFrame();
   void AfterFrame(FramePostEventKind);
@@ -228,6 +274,12 @@ class KneeboardState final
   [[nodiscard]] task<void> SwitchProfile(Direction);
 
   void InitializeViews();
+  /// Returns false if the default tab isn't in `tabs`
+  bool SelectDefaultTab(
+    KneeboardView&,
+    const ViewSettings&,
+    const std::vector<std::shared_ptr<ITab>>& tabs);
+  void OnViewNeedsRepaint(KneeboardViewID, RepaintReason);
 };
 
 }// namespace OpenKneeboard
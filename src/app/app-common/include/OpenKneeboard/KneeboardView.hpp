@@ -11,11 +11,13 @@
 #include <OpenKneeboard/Events.hpp>
 #include <OpenKneeboard/ITab.hpp>
 #include <OpenKneeboard/KneeboardViewID.hpp>
+#include <OpenKneeboard/RepaintRequests.hpp>
 #include <OpenKneeboard/ThreadGuard.hpp>
 
 #include <OpenKneeboard/audited_ptr.hpp>
 #include <OpenKneeboard/inttypes.hpp>
 
+#include <chrono>
 #include <memory>
 #include <source_location>
 #include <vector>
@@ -62,6 +64,11 @@ class KneeboardView final : private EventReceiver,
   void SetCurrentTabByRuntimeID(
     ITab::RuntimeID,
     const std::source_location& loc = std::source_location::current());
+  /** Whether a tab has been selected with `SetCurrentTab*()`.
+   *
+   * If not, the current tab is just the first available tab.
+   */
+  bool HasSelectedTab() const noexcept;
 
   void PreviousTab();
   void NextTab();
@@ -83,6 +90,9 @@ class KneeboardView final : private EventReceiver,
     RenderTarget*,
     const PixelRect& rect,
     bool isActiveForInput) noexcept;
+  /// Render pages that are likely to be shown next; see `TabView`
+  [[nodiscard]] task<void> PrerenderPages(
+    std::chrono::steady_clock::time_point stopAt);
   std::optional<D2D1_POINT_2F> GetCursorCanvasPoint() const;
   std::optional<D2D1_POINT_2F> GetCursorContentPoint() const;
   D2D1_POINT_2F GetCursorCanvasPoint(const D2D1_POINT_2F& contentPoint) const;
@@ -108,7 +118,7 @@ class KneeboardView final : private EventReceiver,
 
   Event<TabIndex> evCurrentTabChangedEvent;
   // TODO - cursor and repaint?
-  Event<> evNeedsRepaintEvent;
+  Event<RepaintReason> evNeedsRepaintEvent;
   Event<CursorEvent> evCursorEvent;
   Event<> evLayoutChangedEvent;
   Event<> evBookmarksChangedEvent;
@@ -139,6 +149,7 @@ class KneeboardView final : private EventReceiver,
   KneeboardState* mKneeboard;
   std::vector<std::shared_ptr<TabView>> mTabViews;
   std::shared_ptr<TabView> mCurrentTabView;
+  bool mHasSelectedTab {false};
 
   std::optional<D2D1_POINT_2F> mCursorCanvasPoint;
 
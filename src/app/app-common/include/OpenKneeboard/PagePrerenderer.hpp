@@ -0,0 +1,81 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <OpenKneeboard/PagePrerenderPolicy.hpp>
+#include <OpenKneeboard/Pixels.hpp>
+#include <OpenKneeboard/RenderTarget.hpp>
+#include <OpenKneeboard/UniqueID.hpp>
+
+#include <OpenKneeboard/audited_ptr.hpp>
+#include <OpenKneeboard/inttypes.hpp>
+#include <OpenKneeboard/task.hpp>
+
+#include <shims/winrt/base.h>
+
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <d3d11.h>
+
+namespace OpenKneeboard {
+
+struct DXResources;
+class IPageSource;
+
+/** Off-screen copies of the pages that are likely to be shown next.
+ *
+ * Pages are rendered ahead of time in `RunIdleWork()`, and used by `Render()`
+ * if they're still valid; `PagePrerenderPolicy` decides which pages are kept.
+ * Pages from an `IPageSourceWithInternalCaching` are never rendered ahead of
+ * time.
+ *
+ * Callers must hold the DXResources lock.
+ */
+class PagePrerenderer final {
+ public:
+  PagePrerenderer() = delete;
+  explicit PagePrerenderer(const audited_ptr<DXResources>&);
+  ~PagePrerenderer();
+
+  /// Render from an off-screen copy if possible, otherwise from the source
+  [[nodiscard]]
+  task<void> Render(
+    RenderContext,
+    IPageSource*,
+    PageID,
+    PageIndex,
+    PixelRect);
+
+  /// Discard all off-screen copies, e.g. because the content changed
+  void Invalidate();
+
+  /** Render at most one page ahead of time, if it's likely to be finished by
+   * `stopAt`.
+   */
+  [[nodiscard]]
+  task<void> RunIdleWork(
+    IPageSource*,
+    std::span<const PageID> bookmarks,
+    PagePrerenderPolicy::TimePoint stopAt);
+
+ private:
+  struct Slot {
+    winrt::com_ptr<ID3D11Texture2D> mTexture;
+    winrt::com_ptr<ID3D11ShaderResourceView> mShaderResourceView;
+  };
+
+  audited_ptr<DXResources> mDXR;
+  PagePrerenderPolicy mPolicy;
+
+  PixelSize mSize;
+  std::vector<Slot> mSlots;
+  /// Kept for the lifetime of this object, as sources cache by its ID
+  std::shared_ptr<RenderTarget> mRenderTarget;
+
+  void Release();
+  Slot& GetSlot(PagePrerenderPolicy::SlotIndex);
+};
+
+}// namespace OpenKneeboard
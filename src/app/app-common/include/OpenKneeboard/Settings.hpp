@@ -19,6 +19,8 @@
 
 namespace OpenKneeboard {
 
+class SettingsFiles;
+
 #define OPENKNEEBOARD_GLOBAL_SETTINGS_SECTIONS IT(AppSettings, App)
 
 #define OPENKNEEBOARD_PER_PROFILE_SETTINGS_SECTIONS \
@@ -40,11 +42,22 @@ struct Settings final {
   OPENKNEEBOARD_SETTINGS_SECTIONS
 #undef IT
 
-  static Settings Load(winrt::guid defaultProfile, winrt::guid activeProfile);
-  void Save(winrt::guid defaultProfile, winrt::guid activeProfile) const;
+  static Settings Load(
+    SettingsFiles&,
+    winrt::guid defaultProfile,
+    winrt::guid activeProfile);
+  /** Save sections that differ from what's on disk.
+   *
+   * Writes are debounced and happen on a background thread; use
+   * `SettingsFiles::Flush()` if they need to be on disk now.
+   */
+  void Save(
+    SettingsFiles&,
+    winrt::guid defaultProfile,
+    winrt::guid activeProfile) const;
 #define IT(cpptype, name) \
   void Reset##name##Section( \
-    winrt::guid defaultProfile, winrt::guid activeProfile);
+    SettingsFiles&, winrt::guid defaultProfile, winrt::guid activeProfile);
   OPENKNEEBOARD_SETTINGS_SECTIONS
 #undef IT
 
@@ -0,0 +1,66 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <OpenKneeboard/DebouncedFileWriter.hpp>
+
+#include <OpenKneeboard/json.hpp>
+
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+
+namespace OpenKneeboard {
+
+/** The settings files as we last read or wrote them.
+ *
+ * This lets us save without re-reading every file, skip sections that
+ * haven't changed, and hand the actual writes to a background thread.
+ *
+ * Entries are re-read if the file's last write time changes, e.g. if it's
+ * edited by hand, unless we have a write of our own pending.
+ *
+ * Owned by `KneeboardState`, which flushes it on shutdown.
+ */
+class SettingsFiles final {
+ public:
+  SettingsFiles();
+  /// Flushes pending writes
+  ~SettingsFiles();
+
+  SettingsFiles(const SettingsFiles&) = delete;
+  SettingsFiles(SettingsFiles&&) = delete;
+  SettingsFiles& operator=(const SettingsFiles&) = delete;
+  SettingsFiles& operator=(SettingsFiles&&) = delete;
+
+  std::optional<nlohmann::json> Read(const std::filesystem::path&);
+  bool Exists(const std::filesystem::path&);
+
+  void Write(const std::filesystem::path&, const nlohmann::json&);
+  void Remove(const std::filesystem::path&);
+
+  /// Write any pending changes, and wait for them to finish
+  void Flush();
+
+ private:
+  struct File {
+    /// `std::nullopt` if the file doesn't exist
+    std::optional<nlohmann::json> mJSON;
+    /// As of when `mJSON` was read or written; `std::nullopt` if it didn't
+    /// exist
+    std::optional<std::filesystem::file_time_type> mLastWriteTime;
+  };
+
+  std::mutex mMutex;
+  std::map<std::filesystem::path, File> mFiles;
+  // Last, so that it's flushed before the other members are destroyed
+  DebouncedFileWriter mWriter;
+
+  std::optional<nlohmann::json> ReadLocked(const std::filesystem::path&);
+  void OnWritten(
+    const std::filesystem::path&,
+    const DebouncedFileWriter::WriteResult&);
+};
+
+}// namespace OpenKneeboard
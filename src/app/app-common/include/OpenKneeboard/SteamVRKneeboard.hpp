@@ -11,6 +11,7 @@
 #include <OpenKneeboard/SHM.hpp>
 #include <OpenKneeboard/SHM/D3D11.hpp>
 #include <OpenKneeboard/VRKneeboard.hpp>
+#include <OpenKneeboard/VROverlayChangeTracker.hpp>
 
 #include <OpenKneeboard/config.hpp>
 #include <OpenKneeboard/task.hpp>
@@ -69,11 +70,12 @@ class SteamVRKneeboard final : private VRKneeboard {
     bool mVisible = false;
     winrt::com_ptr<ID3D11Texture2D> mOpenVRTexture;
     vr::VROverlayHandle_t mOverlay {};
-    uint64_t mFenceValue {};
     // *NOT* an NT handle. Do not use CloseHandle() or winrt::Handle
     HANDLE mSharedHandle {};
   };
   std::array<LayerState, MaxViewCount> mLayers;
+  /// Skip copies and overlay updates when the frame and layer are unchanged
+  VROverlayChangeTracker mChangeTracker {MaxViewCount};
 
   void InitializeLayer(size_t index);
 };
@@ -9,13 +9,17 @@
 #include <OpenKneeboard/DXResources.hpp>
 #include <OpenKneeboard/Events.hpp>
 #include <OpenKneeboard/IPageSource.hpp>
+#include <OpenKneeboard/ITab.hpp>
 #include <OpenKneeboard/KneeboardViewID.hpp>
 #include <OpenKneeboard/ThreadGuard.hpp>
 
 #include <OpenKneeboard/audited_ptr.hpp>
 #include <OpenKneeboard/inttypes.hpp>
+#include <OpenKneeboard/task.hpp>
 
+#include <chrono>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include <d2d1.h>
@@ -25,6 +29,7 @@ namespace OpenKneeboard {
 struct CursorEvent;
 class ITab;
 class KneeboardState;
+class PagePrerenderer;
 
 enum class TabMode {
   Normal,
@@ -54,6 +59,17 @@ class TabView final : private EventReceiver {
 
   std::optional<PreferredSize> GetPreferredSize() const;
 
+  /// Render the current page of the current tab
+  [[nodiscard]]
+  task<void> RenderPage(RenderContext, PixelRect);
+  /** Render pages that are likely to be shown next, if there's time.
+   *
+   * Call this when there is nothing else to do; it may do nothing. Callers
+   * must hold the DXResources lock.
+   */
+  [[nodiscard]]
+  task<void> PrerenderPages(std::chrono::steady_clock::time_point stopAt);
+
   void PostCursorEvent(const CursorEvent&);
 
   TabMode GetTabMode() const;
@@ -99,6 +115,20 @@ class TabView final : private EventReceiver {
 
   TabMode mTabMode = TabMode::Normal;
 
+  // Only used for the root tab
+  std::unique_ptr<PagePrerenderer> mPrerenderer;
+
+  // `GetPreferredSize()` is called for every frame, so remember the last page
+  // it found in the tab instead of searching all of the tab's pages each time.
+  // Reset when the content changes.
+  //
+  // `GetPreferredSize()` is called from both the UI and render threads.
+  mutable std::mutex mKnownPageMutex;
+  mutable ITab::RuntimeID mKnownPageTab {nullptr};
+  mutable PageID mKnownPage {nullptr};
+  // Incremented on reset, so a search that raced with it isn't remembered
+  uint64_t mKnownPageGeneration {};
+
   void OnTabContentChanged();
   void OnTabPageAppended(SuggestedPageAppendAction);
 
@@ -0,0 +1,97 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <OpenKneeboard/DebouncedFileWriter.hpp>
+#include <OpenKneeboard/ThumbnailStore.hpp>
+#include <OpenKneeboard/audited_ptr.hpp>
+#include <OpenKneeboard/task.hpp>
+
+#include <shims/winrt/base.h>
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <d2d1.h>
+#include <d3d11.h>
+
+namespace OpenKneeboard {
+
+struct DXResources;
+
+/** A `ThumbnailStore`, persisted between runs.
+ *
+ * Thumbnails are stored as PNGs.
+ *
+ * Owned by `KneeboardState`, which starts `Load()`ing it at startup.
+ */
+class ThumbnailCache final {
+ public:
+  using Key = ThumbnailStore::Key;
+  using Bytes = ThumbnailStore::Bytes;
+
+  static constexpr std::size_t BudgetBytes = 32 * 1024 * 1024;
+
+  ThumbnailCache();
+  ~ThumbnailCache();
+
+  ThumbnailCache(const ThumbnailCache&) = delete;
+  ThumbnailCache(ThumbnailCache&&) = delete;
+  ThumbnailCache& operator=(const ThumbnailCache&) = delete;
+  ThumbnailCache& operator=(ThumbnailCache&&) = delete;
+
+  /** Load thumbnails saved by a previous run, on a background thread.
+   *
+   * Until this completes, `Save()` does nothing, so that the saved thumbnails
+   * aren't overwritten; thumbnails inserted in the meantime are kept.
+   */
+  [[nodiscard]]
+  task<void> Load();
+
+  [[nodiscard]]
+  std::shared_ptr<const Bytes> Find(const Key&);
+  void Insert(Key, Bytes);
+  /// Write to disk in the background, if anything has changed
+  void Save();
+
+  /** Encode a B8G8R8A8 texture.
+   *
+   * The caller must not hold the DXResources lock: this polls for the GPU
+   * copy instead of waiting for it, and encodes on a background thread.
+   */
+  [[nodiscard]]
+  static task<Bytes> Encode(
+    audited_ptr<DXResources>,
+    winrt::com_ptr<ID3D11Texture2D>);
+  /** Decode to a bitmap for the shared D2D device context.
+   *
+   * The caller must hold the DXResources lock. Returns nullptr if the data
+   * can't be decoded.
+   */
+  [[nodiscard]]
+  static winrt::com_ptr<ID2D1Bitmap> Decode(
+    DXResources&,
+    std::span<const std::byte>);
+
+ private:
+  static constexpr auto ReadbackPollInterval = std::chrono::milliseconds(5);
+
+  const std::filesystem::path mPath;
+
+  std::mutex mMutex;
+  ThumbnailStore mStore {BudgetBytes};
+  uint64_t mSavedGeneration {};
+  bool mLoaded {false};
+  /// Inserted before `Load()` completed; re-inserted once it does
+  std::vector<std::pair<Key, Bytes>> mInsertedBeforeLoad;
+  DebouncedFileWriter mWriter;
+
+  void SaveLocked();
+};
+
+}// namespace OpenKneeboard
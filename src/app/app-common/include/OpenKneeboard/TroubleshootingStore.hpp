@@ -7,11 +7,16 @@
 #pragma once
 
 #include <OpenKneeboard/Events.hpp>
+#include <OpenKneeboard/LogRing.hpp>
+#include <OpenKneeboard/TabLoadScheduler.hpp>
 
 #include <OpenKneeboard/dprint.hpp>
 
 #include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
@@ -36,31 +41,72 @@ class TroubleshootingStore final : private EventReceiver {
     std::string mValue;
   };
 
-  struct DPrintEntry {
-    std::chrono::system_clock::time_point mWhen;
-    DWORD mProcessID {};
-    std::wstring mExecutable;
-    std::wstring mPrefix;
-    std::wstring mMessage;
-  };
+  using DPrintEntry = LogRing::Entry;
 
   void OnAPIEvent(const APIEvent&);
+  /// Record a per-tab timeline of a `TabsList::LoadSettings()` call
+  void OnTabsLoaded(const TabLoadScheduler&);
 
   std::string GetAPIEventsDebugLogAsString() const;
   std::string GetDPrintDebugLogAsString() const;
+  std::string GetTabLoadTimelinesAsString() const;
+
+  /** Fetch only messages newer than `after`.
+   *
+   * Pass the sequence number of the last entry you've seen, or 0 for
+   * everything that's still stored.
+   */
+  std::vector<DPrintEntry> GetDPrintEntriesSince(
+    LogRing::Sequence after,
+    const LogRing::Filter& = {}) const;
+  LogRing::Source GetDPrintSource(LogRing::SourceID) const;
+  std::vector<LogRing::Source> GetDPrintSources() const;
+
+  /// Write any buffered messages to the log file before returning
+  void FlushLogFile();
 
   Event<APIEventEntry> evAPIEventReceived;
-  Event<DPrintEntry> evDPrintMessageReceived;
+  /// Emitted with the new entry's sequence number
+  Event<LogRing::Sequence> evDPrintMessageReceived;
 
  private:
+  // Roughly a few hours of a busy session; enough for troubleshooting, while
+  // bounding memory usage for long sessions
+  static constexpr LogRing::Limits DPrintLimits {
+    .mMaxEntries = 50000,
+    .mMaxBytes = 16 * 1024 * 1024,
+  };
+  static constexpr auto LogFileFlushInterval = std::chrono::seconds(1);
+  // Don't hold the ring's lock for too long while reading it
+  static constexpr std::size_t DPrintReadBatchSize = 1024;
+  // Startup, plus a few profile switches
+  static constexpr std::size_t MaxTabLoadTimelines = 8;
+
+  struct TabLoadTimeline {
+    std::chrono::system_clock::time_point mRecordedAt;
+    TabLoadScheduler mScheduler;
+  };
+
   class DPrintReceiver;
+  LogRing mDPrintLog {DPrintLimits};
   std::unique_ptr<DPrintReceiver> mDPrint;
   std::jthread mDPrintThread;
   std::map<std::string, APIEventEntry> mAPIEvents;
+  std::deque<TabLoadTimeline> mTabLoadTimelines;
+
   std::optional<std::ofstream> mLogFile;
+  // Guards the log file and `mLogFileSequence`; timed so that the fatal error
+  // handler can't deadlock if we crash while writing
+  std::timed_mutex mLogFileMutex;
+  LogRing::Sequence mLogFileSequence {0};
+  // Wakes the writer thread; guarded by `mLogFileWakeMutex`
+  std::mutex mLogFileWakeMutex;
+  std::condition_variable_any mLogFileWake;
+  bool mLogFileStopping {false};
+  std::jthread mLogFileThread;
 
   void InitializeLogFile();
-  void WriteDPrintMessageToLogFile(const DPrintEntry&);
+  void WriteLogFile();
 
   TroubleshootingStore();
 };
@@ -7,12 +7,14 @@
 #pragma once
 
 #include <OpenKneeboard/DXResources.hpp>
+#include <OpenKneeboard/DirtyRegion.hpp>
 #include <OpenKneeboard/Events.hpp>
 #include <OpenKneeboard/IHasDisposeAsync.hpp>
 #include <OpenKneeboard/PreferredSize.hpp>
 #include <OpenKneeboard/ProcessShutdownBlock.hpp>
 #include <OpenKneeboard/RenderTarget.hpp>
 #include <OpenKneeboard/ThreadGuard.hpp>
+#include <OpenKneeboard/TileHashChangeDetector.hpp>
 
 #include <OpenKneeboard/audited_ptr.hpp>
 #include <OpenKneeboard/enable_shared_from_this.hpp>
@@ -23,6 +25,7 @@
 #include <winrt/Windows.Graphics.Capture.h>
 #include <winrt/Windows.System.h>
 
+#include <array>
 #include <memory>
 
 namespace OpenKneeboard {
@@ -84,6 +87,27 @@ class WGCRenderer : public virtual EventReceiver,
   void PreOKBFrame();
   void OnWGCFrame(winrt::Windows::Graphics::Capture::Direct3D11CaptureFrame);
 
+  void PublishFrame();
+  /// Caller must hold the DX lock
+  void CopyToTexture(ID3D11Texture2D* surface, const PixelRect&);
+
+  /// Regions of the frame that differ from what's already in `mTexture`
+  DirtyRegion GetWGCDirtyRegion(
+    const winrt::Windows::Graphics::Capture::Direct3D11CaptureFrame&,
+    const PixelSize& captureSize);
+
+  /** Start hashing the tiles of `mTexture` on the GPU, and copying the
+   * hashes to a staging buffer for change detection.
+   *
+   * Returns false if every staging buffer is still in use.
+   *
+   * Caller must hold the DX lock.
+   */
+  bool QueueReadback(const PixelSize& captureSize);
+  /// Compare any tile hashes that have been read back, and repaint if they
+  /// changed
+  void PollReadbacks();
+
   DisposalState mDisposal;
   winrt::apartment_context mUIThread;
   audited_ptr<DXResources> mDXR;
@@ -104,6 +128,29 @@ class WGCRenderer : public virtual EventReceiver,
   PixelSize mCaptureSize {};
   winrt::com_ptr<ID3D11Texture2D> mTexture;
   winrt::com_ptr<ID3D11ShaderResourceView> mShaderResourceView;
+  // If true, `mTexture` needs a full update, regardless of what WGC says
+  bool mTextureIsStale {true};
+
+  // If WGC can't tell us what changed, we hash each tile of the frame on the
+  // GPU, and read back the hashes. Readbacks are asynchronous so that we
+  // never wait for the GPU; this is a FIFO ring of them.
+  struct Readback {
+    winrt::com_ptr<ID3D11Buffer> mBuffer;
+    PixelSize mSize {};
+  };
+  static constexpr std::size_t ReadbackRingLength = 3;
+  bool mHaveWGCDirtyRegions {false};
+  TileHashChangeDetector mChangeDetector;
+  winrt::com_ptr<ID3D11ComputeShader> mTileHashShader;
+  winrt::com_ptr<ID3D11Buffer> mTileHashConstants;
+  winrt::com_ptr<ID3D11Buffer> mTileHashes;
+  winrt::com_ptr<ID3D11UnorderedAccessView> mTileHashesUAV;
+  std::array<Readback, ReadbackRingLength> mReadbacks {};
+  std::size_t mFirstPendingReadback {0};
+  std::size_t mPendingReadbackCount {0};
+
+  uint64_t mPublishedFrames {0};
+  uint64_t mSkippedFrames {0};
 };
 
 }// namespace OpenKneeboard
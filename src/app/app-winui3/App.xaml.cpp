@@ -13,12 +13,14 @@
 #include "MainWindow.xaml.h"
 
 #include <OpenKneeboard/APIEvent.hpp>
+#include <OpenKneeboard/CachedLayer.hpp>
 #include <OpenKneeboard/ChromiumApp.hpp>
 #include <OpenKneeboard/ChromiumWorker.hpp>
 #include <OpenKneeboard/DebugPrivileges.hpp>
 #include <OpenKneeboard/Elevation.hpp>
 #include <OpenKneeboard/Filesystem.hpp>
 #include <OpenKneeboard/GetMainHWND.hpp>
+#include <OpenKneeboard/InputRecording.hpp>
 #include <OpenKneeboard/KneeboardState.hpp>
 #include <OpenKneeboard/OpenXRMode.hpp>
 #include <OpenKneeboard/ProcessShutdownBlock.hpp>
@@ -633,6 +635,29 @@ static void OptOutOfPowerSaving() {
   dprint("✅ opted out of power saving event timers");
 }
 
+static void StartInputRecordingIfEnabled() {
+  for (auto hkey: {HKEY_CURRENT_USER, HKEY_LOCAL_MACHINE}) {
+    const auto enabled = wil::reg::try_get_value_dword(
+      hkey, Config::RegistrySubKey, L"RecordInput");
+    if (!enabled) {
+      continue;
+    }
+    if (!*enabled) {
+      return;
+    }
+    const auto timestamp = std::chrono::floor<std::chrono::seconds>(
+      std::chrono::system_clock::now());
+    const auto path = Filesystem::GetLogsDirectory()
+      / std::format("input-{:%Y%m%dT%H%M%SZ}.okinput", timestamp);
+    if (InputRecording::StartRecording(path)) {
+      dprint("Recording API events and tablet input to `{}`", path);
+    } else {
+      dprint.Warning("Failed to start recording input to `{}`", path);
+    }
+    return;
+  }
+}
+
 [[nodiscard]]
 static int AppMain(
   const HINSTANCE instance,
@@ -666,6 +691,18 @@ static int AppMain(
       .value_or(0);
   SetDumpType(fullDumps ? DumpType::FullDump : DumpType::MiniDump);
 
+  EnableBinaryTraceFromRegistry();
+
+  for (auto hkey: {HKEY_CURRENT_USER, HKEY_LOCAL_MACHINE}) {
+    const auto budgetMiB = wil::reg::try_get_value_dword(
+      hkey, Config::RegistrySubKey, L"CachedLayerVRAMBudgetMiB");
+    if (budgetMiB) {
+      CachedLayer::SetVRAMBudget(
+        static_cast<std::size_t>(*budgetMiB) * 1024 * 1024);
+      break;
+    }
+  }
+
   // CreateMutex can set ERROR_ALREADY_EXISTS on success, so we need to
   // have a known-succeeding initial state.
   SetLastError(ERROR_SUCCESS);
@@ -738,6 +775,7 @@ static int AppMain(
   }
   LogInstallationInformation();
   SetRegistryValues();
+  StartInputRecordingIfEnabled();
 
   dprint("Cleaning up temporary directories...");
   Filesystem::CleanupTemporaryDirectories();
@@ -14,11 +14,14 @@
 #include "FilePicker.h"
 #include "Globals.h"
 
+#include <OpenKneeboard/BinaryTrace.hpp>
 #include <OpenKneeboard/Filesystem.hpp>
 #include <OpenKneeboard/KneeboardState.hpp>
 #include <OpenKneeboard/LaunchURI.hpp>
+#include <OpenKneeboard/Metrics.hpp>
 #include <OpenKneeboard/RuntimeFiles.hpp>
 #include <OpenKneeboard/SHM/ActiveConsumers.hpp>
+#include <OpenKneeboard/SHM/Metrics.hpp>
 #include <OpenKneeboard/Settings.hpp>
 #include <OpenKneeboard/TroubleshootingStore.hpp>
 
@@ -39,9 +42,11 @@
 
 #include <felly/unique_any.hpp>
 
+#include <deque>
 #include <expected>
 #include <format>
 #include <fstream>
+#include <sstream>
 #include <string>
 
 #include <shobjidl.h>
@@ -148,6 +153,44 @@ void HelpPage::OnCopyVersionDataClick(
   SetClipboardText(mVersionClipboardData);
 }
 
+void HelpPage::OnMetricsExpanding(
+  const IInspectable&,
+  const Controls::ExpanderExpandingEventArgs&) noexcept {
+  this->PopulateMetrics();
+}
+
+void HelpPage::OnRefreshMetricsClick(
+  const IInspectable&,
+  const RoutedEventArgs&) noexcept {
+  this->PopulateMetrics();
+}
+
+void HelpPage::OnCopyMetricsClick(
+  const IInspectable&,
+  const RoutedEventArgs&) noexcept {
+  this->PopulateMetrics();
+  SetClipboardText(MetricsText().Text());
+}
+
+void HelpPage::PopulateMetrics() noexcept {
+  MetricsText().Text(winrt::to_hstring(GetMetrics()));
+}
+
+std::string HelpPage::GetMetrics() noexcept {
+  auto ret = std::format(
+    "OpenKneeboard (PID {})\n\n{}",
+    GetCurrentProcessId(),
+    Metrics::FormatSnapshot(Metrics::Registry::Get().GetSnapshot()));
+  for (auto&& process: SHM::Metrics::GetPublished()) {
+    ret += std::format(
+      "\n{} (PID {})\n\n{}",
+      process.mExecutable,
+      process.mProcessID,
+      Metrics::FormatSnapshot(process.mSnapshot));
+  }
+  return ret;
+}
+
 template <class C, class T>
 auto ReadableTime(const std::chrono::time_point<C, T>& time) {
   return std::chrono::zoned_time(
@@ -190,14 +233,16 @@ OpenKneeboard::fire_and_forget HelpPage::OnExportClick(
   using unique_zip = felly::unique_any<zip_t*, &zip_close>;
 
   int ze;
-  std::vector<std::string> retainedBuffers;
+  // Must outlive `zip`, which reads the buffers when it's closed; a deque
+  // doesn't move existing elements, so `data()` stays valid even for strings
+  // using the small-string optimization
+  std::deque<std::string> retainedBuffers;
   unique_zip zip {
     zip_open(zipPathUtf8.c_str(), ZIP_CREATE | ZIP_TRUNCATE, &ze)};
 
   auto AddFile = [zip = zip.get(), &retainedBuffers](
                    const char* name, std::string_view buffer) {
-    retainedBuffers.push_back(std::string(buffer));
-    const auto& copy = retainedBuffers.back();
+    const auto& copy = retainedBuffers.emplace_back(buffer);
     zip_file_add(
       zip,
       name,
@@ -220,11 +265,19 @@ OpenKneeboard::fire_and_forget HelpPage::OnExportClick(
 
   AddFile("debug-log.txt", ts->GetDPrintDebugLogAsString());
   AddFile("api-events.txt", ts->GetAPIEventsDebugLogAsString());
+  AddFile("tab-loading.txt", ts->GetTabLoadTimelinesAsString());
   AddFile("openxr.txt", GetOpenXRInfo());
   AddFile("update-history.txt", GetUpdateLog());
   AddFile("renderers.txt", GetActiveConsumers());
   AddFile("version.txt", mVersionClipboardData);
   AddFile("vram.txt", GetVRAMInfo());
+  AddFile("metrics.txt", GetMetrics());
+
+  if (BinaryTrace::IsEnabled()) {
+    std::ostringstream trace;
+    BinaryTrace::Dump(trace);
+    AddFile("trace.oktrace", trace.view());
+  }
 
   const auto settingsDir = Filesystem::GetSettingsDirectory();
   for (const auto entry:
@@ -286,7 +339,7 @@ OpenKneeboard::fire_and_forget HelpPage::OnExportClick(
       continue;
     }
 
-    if (path.extension() != ".txt") {
+    if (path.extension() != ".txt" && path.extension() != ".oktrace") {
       OPENKNEEBOARD_BREAK;
       continue;
     }
@@ -419,22 +472,50 @@ std::string HelpPage::GetActiveConsumers() noexcept {
   const auto now = SHM::ActiveConsumers::Clock::now();
   const SHM::ActiveConsumers::T null {};
 
-  const auto log = [&](const auto name, const auto& value) {
-    if (value == null) {
-      ret += std::format("{}: inactive\n", name);
-      return;
-    }
-    ret += std::format(
-      "{}: {}\n",
-      name,
-      std::chrono::duration_cast<std::chrono::milliseconds>(now - value));
+  const auto us = [](const auto ns) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::nanoseconds {ns});
   };
 
-  log("OpenVR", consumers.mOpenVR);
-  log("OpenXR/XR_KHR_D3D11_enable", consumers.mOpenXR_D3D11);
-  log("OpenXR/XR_KHR_D3D12_enable", consumers.mOpenXR_D3D12);
-  log("OpenXR/XR_KHR_vulkan_enable2", consumers.mOpenXR_Vulkan2);
-  log("Viewer", consumers.mViewer);
+  const auto log =
+    [&](const auto name, const auto& value, const SHM::ConsumerKind kind) {
+      if (value == null) {
+        ret += std::format("{}: inactive\n", name);
+        return;
+      }
+      ret += std::format(
+        "{}: {}\n",
+        name,
+        std::chrono::duration_cast<std::chrono::milliseconds>(now - value));
+
+      const auto telemetry = SHM::ActiveConsumers::GetTelemetry(kind);
+      if (!telemetry) {
+        return;
+      }
+      const auto& processing = telemetry->mProcessingTime;
+      ret += std::format(
+        "  PID {}: {} frames ({} new, {} reused); interval {}; "
+        "last SHM frame #{}; visible layers {:#x}; "
+        "processing p50 {}, p99 {}, max {}\n",
+        telemetry->mProcessID,
+        telemetry->mFrameCount,
+        telemetry->mFetchedFrameCount,
+        telemetry->mReusedFrameCount,
+        us(telemetry->mFrameInterval.count()),
+        telemetry->mLastSHMFrameNumber,
+        telemetry->mVisibleLayers,
+        us(processing.mP50),
+        us(processing.mP99),
+        us(processing.mMax));
+    };
+
+  using enum SHM::ConsumerKind;
+  log("OpenVR", consumers.mOpenVR, OpenVR);
+  log("OpenXR/XR_KHR_D3D11_enable", consumers.mOpenXR_D3D11, OpenXR_D3D11);
+  log("OpenXR/XR_KHR_D3D12_enable", consumers.mOpenXR_D3D12, OpenXR_D3D12);
+  log(
+    "OpenXR/XR_KHR_vulkan_enable2", consumers.mOpenXR_Vulkan2, OpenXR_Vulkan2);
+  log("Viewer", consumers.mViewer, Viewer);
 
   ret += std::format(
     "\nNon-VR canvas: {}x{}\n\n",
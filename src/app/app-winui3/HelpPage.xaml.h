@@ -31,6 +31,15 @@ struct HelpPage : HelpPageT<HelpPage>,
     const IInspectable&,
     const RoutedEventArgs&) noexcept;
   void OnAgreeClick(const IInspectable&, const RoutedEventArgs&) noexcept;
+  void OnMetricsExpanding(
+    const IInspectable&,
+    const Controls::ExpanderExpandingEventArgs&) noexcept;
+  void OnRefreshMetricsClick(
+    const IInspectable&,
+    const RoutedEventArgs&) noexcept;
+  void OnCopyMetricsClick(
+    const IInspectable&,
+    const RoutedEventArgs&) noexcept;
   OpenKneeboard::fire_and_forget OnExportClick(
     IInspectable,
     RoutedEventArgs) noexcept;
@@ -48,11 +57,13 @@ struct HelpPage : HelpPageT<HelpPage>,
 
   void PopulateVersion();
   void PopulateLicenses() noexcept;
+  void PopulateMetrics() noexcept;
 
   static std::string GetUpdateLog() noexcept;
   static std::string GetOpenXRInfo() noexcept;
   static std::string GetActiveConsumers() noexcept;
   static std::string GetVRAMInfo() noexcept;
+  static std::string GetMetrics() noexcept;
 
   void DisplayLicense(const std::string& header, const std::filesystem::path&);
 
@@ -29,6 +29,7 @@
 #include <OpenKneeboard/KneeboardState.hpp>
 #include <OpenKneeboard/KneeboardView.hpp>
 #include <OpenKneeboard/LaunchURI.hpp>
+#include <OpenKneeboard/Metrics.hpp>
 #include <OpenKneeboard/SHM/ActiveConsumers.hpp>
 #include <OpenKneeboard/TabView.hpp>
 #include <OpenKneeboard/TabletInputAdapter.hpp>
@@ -222,40 +223,41 @@ task<void> MainWindow::FrameLoop() {
   co_await this_task::fatal_on_uncaught_exception();
 
   const auto stop = mFrameLoopStopSource.get_token();
-  constexpr auto NanosPerFrame =
-    std::chrono::nanoseconds(static_cast<int64_t>(1e9) / FramesPerSecond);
-  using HighResolutionTimerTick =
-    std::chrono::duration<int64_t, std::ratio<1, 1'0'000'000>>;
 
-  const wil::unique_event timer {CreateWaitableTimerExW(
-    nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS)};
+  mFrameTimer.reset(CreateWaitableTimerExW(
+    nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS));
+  AddEventListener(
+    mKneeboard->evNeedsRepaintEvent,
+    std::bind_front(&MainWindow::OnRepaintNeeded, this));
 
   while (!stop.stop_requested()) {
     const auto start = std::chrono::steady_clock::now();
-    const auto nextGoal = start + NanosPerFrame;
+    bool haveConsumers {false};
+    std::chrono::steady_clock::time_point nextGoal;
+    {
+      const std::unique_lock lock(mFrameSchedulerMutex);
+      this->ObserveFrameConsumers();
+      haveConsumers = mFrameScheduler.HasActiveConsumer(start);
+      nextGoal = mFrameScheduler.ScheduleNextWake(start);
+    }
 
-    co_await this->FrameTick(nextGoal);
+    co_await this->FrameTick(haveConsumers, nextGoal);
 
-    const auto wait = nextGoal - std::chrono::steady_clock::now();
-    if (wait <= decltype(wait)::zero()) {
-      TraceLoggingWrite(
-        gTraceProvider, "MainWindow::FrameLoop()/FrameDurationExceeded");
-      continue;
-    }
-    const LARGE_INTEGER waitTime {
-      .QuadPart =
-        -std::chrono::duration_cast<HighResolutionTimerTick>(wait).count()};
-    if (!SetWaitableTimer(timer.get(), &waitTime, 0, nullptr, nullptr, 0)) {
-      dprint.Error(
-        "Failed to set frame timer: {}",
-        winrt::hresult(HRESULT_FROM_WIN32(GetLastError())));
-      co_return;
+    {
+      const std::unique_lock lock(mFrameSchedulerMutex);
+      // A repaint request during the tick may have brought this forward
+      nextGoal = mFrameScheduler.GetScheduledWake();
+      if (nextGoal <= std::chrono::steady_clock::now()) {
+        TraceLoggingWrite(
+          gTraceProvider, "MainWindow::FrameLoop()/FrameDurationExceeded");
+        continue;
+      }
+      if (!this->SetFrameTimer(nextGoal)) {
+        co_return;
+      }
     }
-    TraceLoggingWrite(
-      gTraceProvider,
-      "MainWindow::FrameLoop()/WaitStart",
-      TraceLoggingValue(waitTime.QuadPart, "interval"));
-    if (!co_await OpenKneeboard::resume_on_signal(timer.get(), stop)) {
+    TraceLoggingWrite(gTraceProvider, "MainWindow::FrameLoop()/WaitStart");
+    if (!co_await OpenKneeboard::resume_on_signal(mFrameTimer.get(), stop)) {
       co_return;
     }
     TraceLoggingWrite(gTraceProvider, "MainWindow::FrameLoop()/WaitComplete");
@@ -263,6 +265,61 @@ task<void> MainWindow::FrameLoop() {
   co_return;
 }
 
+void MainWindow::ObserveFrameConsumers() {
+  const auto consumers = SHM::ActiveConsumers::Get();
+  using enum SHM::ConsumerKind;
+  for (auto&& [kind, frameTime]: {
+         std::pair {OpenVR, consumers.mOpenVR},
+         std::pair {OpenXR_D3D11, consumers.mOpenXR_D3D11},
+         std::pair {OpenXR_D3D12, consumers.mOpenXR_D3D12},
+         std::pair {OpenXR_Vulkan2, consumers.mOpenXR_Vulkan2},
+         std::pair {Viewer, consumers.mViewer},
+       }) {
+    mFrameScheduler.ObserveConsumerFrame(std::to_underlying(kind), frameTime);
+  }
+  // We don't know the app window's refresh rate, and don't need to sync with
+  // it; just render it at the default rate when it's visible
+  mFrameScheduler.SetFreeRunningConsumerActive(
+    IsWindowVisible(mHwnd) && !IsIconic(mHwnd));
+}
+
+void MainWindow::OnRepaintNeeded(const RepaintPriority priority) {
+  if (priority == RepaintPriority::Background) {
+    // Leave it for the next scheduled frame; this also avoids marking the
+    // scheduler as busy, which would speed up the frame loop
+    return;
+  }
+  const std::unique_lock lock(mFrameSchedulerMutex);
+  const auto wakeAt
+    = mFrameScheduler.NotifyRepaintNeeded(std::chrono::steady_clock::now());
+  if (wakeAt && mFrameTimer) {
+    this->SetFrameTimer(*wakeAt);
+  }
+}
+
+bool MainWindow::SetFrameTimer(std::chrono::steady_clock::time_point wakeAt) {
+  using HighResolutionTimerTick =
+    std::chrono::duration<int64_t, std::ratio<1, 1'0'000'000>>;
+  const auto wait = std::max(
+    std::chrono::steady_clock::duration::zero(),
+    wakeAt - std::chrono::steady_clock::now());
+  // Negative: relative to now
+  const LARGE_INTEGER waitTime {
+    .QuadPart =
+      -std::chrono::duration_cast<HighResolutionTimerTick>(wait).count()};
+  if (!SetWaitableTimer(mFrameTimer.get(), &waitTime, 0, nullptr, nullptr, 0)) {
+    dprint.Error(
+      "Failed to set frame timer: {}",
+      winrt::hresult(HRESULT_FROM_WIN32(GetLastError())));
+    return false;
+  }
+  TraceLoggingWrite(
+    gTraceProvider,
+    "MainWindow::SetFrameTimer()",
+    TraceLoggingValue(waitTime.QuadPart, "interval"));
+  return true;
+}
+
 void MainWindow::CheckForElevatedConsumer() {
   if (IsElevated()) {
     return;
@@ -332,6 +389,7 @@ OpenKneeboard::fire_and_forget MainWindow::ShowWarningIfElevated(DWORD pid) {
 }
 
 task<void> MainWindow::FrameTick(
+  bool haveConsumers,
   std::chrono::steady_clock::time_point nextFrameAt) {
   TraceLoggingActivity<gTraceProvider> activity;
   // Including the build number just to make sure it's in every trace
@@ -346,6 +404,10 @@ task<void> MainWindow::FrameTick(
   if (!recursiveFrameLock) {
     co_return;
   }
+  OPENKNEEBOARD_MetricsInterval("MainWindow::FrameTick interval");
+  static const auto sFrameTickHistogram
+    = Metrics::Registry::Get().GetHistogram("MainWindow::FrameTick");
+  Metrics::ScopedTimer frameTickTimer {sFrameTickHistogram};
 
   std::shared_lock kbLock(*mKneeboard, std::try_to_lock);
   if (!kbLock.owns_lock()) {
@@ -362,18 +424,34 @@ task<void> MainWindow::FrameTick(
   mKneeboard->evFrameTimerPreEvent.Emit();
   TraceLoggingWriteTagged(activity, "Prepared to render");
   bool repainted = false;
-  if (mKneeboard->IsRepaintNeeded()) {
+  // If nothing's going to look at the result, leave the repaint pending
+  // until something does
+  if (haveConsumers && mKneeboard->IsRepaintNeeded()) {
+    const auto paintStart = std::chrono::steady_clock::now();
     const std::unique_lock dxLock(*mDXR);
     TraceLoggingWriteTagged(activity, "DX locked");
     OPENKNEEBOARD_TraceLoggingCoro("Paint");
+    // Take the requests before painting, so that any that arrive while we're
+    // painting are left for the next frame
+    mKneeboard->TakeRepaintRequests(mRepaintRequests);
+    TraceLoggingWriteTagged(
+      activity,
+      "Took repaint requests",
+      TraceLoggingValue(mRepaintRequests.mAllViews, "AllViews"),
+      TraceLoggingValue(mRepaintRequests.mViews.size(), "ViewCount"),
+      TraceLoggingValue(mRepaintRequests.mReasons, "Reasons"));
     if (auto ipc = mKneeboard->GetInterprocessRenderer()) {
-      co_await ipc->RenderNow();
+      co_await ipc->RenderNow(mRepaintRequests);
     }
     if (auto tab = Frame().Content().try_as<TabPage_WinRT>()) {
       co_await get_self<TabPage_Implementation>(tab)->PaintNow();
     }
-    mKneeboard->Repainted();
     repainted = true;
+    OPENKNEEBOARD_MetricsCount("MainWindow::FrameTick repaints", 1);
+
+    const std::unique_lock lock(mFrameSchedulerMutex);
+    mFrameScheduler.ObserveRenderDuration(
+      std::chrono::steady_clock::now() - paintStart);
   }
 
   TraceLoggingWriteStop(
@@ -385,10 +463,18 @@ task<void> MainWindow::FrameTick(
                 : FramePostEventKind::WithoutRepaint);
   }
   kbLock.unlock();
+  // Exclude the wait for the next frame
+  frameTickTimer.Stop();
 
   // Finish any pending UI stuff
   co_await wil::resume_foreground(this->DispatcherQueue());
   co_await mKneeboard->FlushOrderedEventQueue(nextFrameAt);
+
+  // Use any time that's left to render pages that may be shown next
+  if (haveConsumers && kbLock.try_lock()) {
+    const std::unique_lock dxLock(*mDXR);
+    co_await mKneeboard->PrerenderPages(nextFrameAt);
+  }
 }
 
 OpenKneeboard::fire_and_forget MainWindow::OnLoaded() {
@@ -421,12 +507,37 @@ OpenKneeboard::fire_and_forget MainWindow::OnLoaded() {
   }
   if (mKneeboard) {
     co_await InstallPlugin(mKneeboard, xamlRoot, GetCommandLineW());
+    this->StartInputReplayFromCommandLine();
   }
 
   co_await CheckAllDCSHooks(xamlRoot);
   co_await PromptForViewMode();
 }
 
+void MainWindow::StartInputReplayFromCommandLine() {
+  int argc {};
+  const wil::unique_hlocal_ptr<PWSTR[]> argv {
+    CommandLineToArgvW(GetCommandLineW(), &argc)};
+
+  std::optional<std::filesystem::path> path;
+  // 1 = original speed, 0 = as fast as possible
+  double speed = 1;
+  for (int i = 0; i < argc - 1; ++i) {
+    const std::wstring_view arg {argv[i]};
+    if (arg == L"--replay-input") {
+      path = argv[++i];
+      continue;
+    }
+    if (arg == L"--replay-speed") {
+      speed = std::wcstod(argv[++i], nullptr);
+      continue;
+    }
+  }
+  if (path) {
+    mKneeboard->StartInputReplay(*path, speed);
+  }
+}
+
 void MainWindow::WinEventProc(
   HWINEVENTHOOK,
   DWORD event,
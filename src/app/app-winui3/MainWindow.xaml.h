@@ -12,12 +12,16 @@
 #include <OpenKneeboard/APIEvent.hpp>
 #include <OpenKneeboard/Bookmark.hpp>
 #include <OpenKneeboard/Events.hpp>
+#include <OpenKneeboard/FrameScheduler.hpp>
 #include <OpenKneeboard/KneeboardView.hpp>
+#include <OpenKneeboard/RepaintRequests.hpp>
 
 #include <OpenKneeboard/audited_ptr.hpp>
+#include <OpenKneeboard/config.hpp>
 #include <OpenKneeboard/single_threaded_lockable.hpp>
 
 #include <memory>
+#include <mutex>
 #include <thread>
 
 using namespace winrt::Microsoft::UI::Dispatching;
@@ -99,8 +103,25 @@ struct MainWindow : MainWindowT<MainWindow>,
   // avoids building up a massive backlog of overdue scheduled
   // events.
   task<void> FrameLoop();
-  task<void> FrameTick(std::chrono::steady_clock::time_point nextFrameAt);
+  task<void> FrameTick(
+    bool haveConsumers,
+    std::chrono::steady_clock::time_point nextFrameAt);
   single_threaded_lockable mFrameInProgress;
+  // Only used by `FrameTick()`; kept to reuse its storage
+  RepaintRequestBus::Frame mRepaintRequests;
+
+  // Repaint requests can come from any thread
+  std::mutex mFrameSchedulerMutex;
+  FrameScheduler mFrameScheduler {FrameScheduler::Options {
+    .mDefaultPeriod = std::chrono::nanoseconds(1'000'000'000) / FramesPerSecond,
+  }};
+  wil::unique_event mFrameTimer;
+  void ObserveFrameConsumers();
+
+  /// Handle `--replay-input PATH` and `--replay-speed MULTIPLIER`
+  void StartInputReplayFromCommandLine();
+  void OnRepaintNeeded(RepaintPriority);
+  bool SetFrameTimer(std::chrono::steady_clock::time_point wakeAt);
 
   std::vector<EventHandlerToken> mTabsEvents;
 
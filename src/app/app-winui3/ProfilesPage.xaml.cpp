@@ -135,10 +135,15 @@ OpenKneeboard::fire_and_forget ProfilesPage::RemoveProfile(
   }
 
   // Actually erase the settings
+  auto& settingsFiles = *mKneeboard->GetSettingsFiles();
   const auto parentSettings = Settings::Load(
-    profileSettings.mDefaultProfile, profileSettings.mDefaultProfile);
+    settingsFiles,
+    profileSettings.mDefaultProfile,
+    profileSettings.mDefaultProfile);
   parentSettings.Save(
-    profileSettings.mDefaultProfile, profileSettings.mActiveProfile);
+    settingsFiles,
+    profileSettings.mDefaultProfile,
+    profileSettings.mActiveProfile);
   // ... and remove from the list
   profileSettings.mProfiles.erase(
     std::ranges::find(profileSettings.mProfiles, id, &Profile::mGuid));
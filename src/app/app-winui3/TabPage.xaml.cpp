@@ -530,7 +530,13 @@ void TabPage::InitializeSwapChain() {
 void TabPage::PaintLater() {
   TraceLoggingWrite(gTraceProvider, "TabPage::PaintLater()");
   mNeedsFrame = true;
-  mKneeboard->SetRepaintNeeded();
+  // Only our view: this is often a tab or cursor change that doesn't affect
+  // other views, so don't make the interprocess renderer redraw them
+  mKneeboard->RequestRepaint({
+    .mView = mKneeboardView ? mKneeboardView->GetRuntimeID().GetTemporaryValue()
+                            : RepaintRequest::AllViews,
+    .mReason = RepaintReason::AppWindow,
+  });
 }
 
 task<void> TabPage::PaintNow(std::source_location loc) noexcept {
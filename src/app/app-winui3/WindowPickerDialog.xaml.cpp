@@ -36,6 +36,13 @@ WindowPickerDialog::WindowPickerDialog() {
     uiData.Icon(iconFactory.CreateXamlBitmapSource(
       spec.mExecutableLastSeenPath.wstring()));
     winrtWindows.push_back(uiData);
+
+    mSearchIndex.Add({
+      winrt::to_string(uiData.Title()),
+      winrt::to_string(uiData.Path()),
+    });
+    mSortKeys.push_back(
+      fold_utf8(winrt::to_string(uiData.GetStringRepresentation())));
   }
 
   mWindows = winrtWindows;
@@ -79,15 +86,16 @@ void WindowPickerDialog::OnAutoSuggestTextChanged(
     return;
   }
 
-  auto matching = this->GetFilteredWindows(queryText);
-
-  std::ranges::sort(matching, {}, [](const auto& inspectable) {
-    return fold_utf8(
-      to_string(inspectable.as<OpenKneeboardApp::WindowPickerUIData>()
-                  .GetStringRepresentation()));
+  auto matching = mSearchIndex.Filter(to_utf8(queryText))
+    | std::ranges::to<std::vector>();
+  std::ranges::sort(matching, {}, [this](const auto i) -> std::string_view {
+    return mSortKeys.at(i);
   });
 
-  box.ItemsSource(single_threaded_vector(std::move(matching)));
+  box.ItemsSource(single_threaded_vector(
+    matching
+    | std::views::transform([this](const auto i) { return mWindows.at(i); })
+    | std::ranges::to<std::vector>()));
 }
 
 std::vector<IInspectable> WindowPickerDialog::GetFilteredWindows(
@@ -96,36 +104,9 @@ std::vector<IInspectable> WindowPickerDialog::GetFilteredWindows(
     return mWindows;
   }
 
-  const auto folded = fold_utf8(to_utf8(queryText));
-  auto words = std::string_view {folded}
-    | std::views::split(std::string_view {" "})
-    | std::views::transform([](auto subRange) {
-                 return std::string_view {subRange.begin(), subRange.end()};
-               });
-
-  std::vector<IInspectable> ret;
-  for (auto rawData: mWindows) {
-    auto window = rawData.as<OpenKneeboardApp::WindowPickerUIData>();
-    const auto title = fold_utf8(winrt::to_string(window.Title()));
-    const auto path = fold_utf8(winrt::to_string(window.Path()));
-
-    bool matchedAllWords = true;
-    for (auto word: words) {
-      if (title.find(word) != title.npos) {
-        continue;
-      }
-      if (path.find(word) != path.npos) {
-        continue;
-      }
-      matchedAllWords = false;
-      break;
-    }
-    if (matchedAllWords) {
-      ret.push_back(window);
-    }
-  }
-
-  return ret;
+  return mSearchIndex.Filter(to_utf8(queryText))
+    | std::views::transform([this](const auto i) { return mWindows.at(i); })
+    | std::ranges::to<std::vector>();
 }
 
 void WindowPickerDialog::OnAutoSuggestQuerySubmitted(
@@ -11,6 +11,8 @@
 #include "WindowPickerUIData.g.h"
 // clang-format on
 
+#include <OpenKneeboard/FoldedStringIndex.hpp>
+
 using namespace winrt::Microsoft::UI::Xaml;
 using namespace winrt::Microsoft::UI::Xaml::Controls;
 using namespace winrt::Microsoft::UI::Xaml::Data;
@@ -39,6 +41,10 @@ struct WindowPickerDialog : WindowPickerDialogT<WindowPickerDialog> {
  private:
   uint64_t mHwnd {};
   std::vector<IInspectable> mWindows;
+  // Title and path of each window in `mWindows`
+  OpenKneeboard::FoldedStringIndex mSearchIndex;
+  // Folded `GetStringRepresentation()` of each window in `mWindows`
+  std::vector<std::string> mSortKeys;
   bool mFiltered {false};
 
   std::vector<IInspectable> GetFilteredWindows(std::wstring_view queryText);
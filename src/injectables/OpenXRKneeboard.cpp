@@ -13,6 +13,9 @@
 #include "OpenXRVulkanKneeboard.hpp"
 
 #include <OpenKneeboard/Elevation.hpp>
+#include <OpenKneeboard/Metrics.hpp>
+#include <OpenKneeboard/SHM/ActiveConsumers.hpp>
+#include <OpenKneeboard/SHM/Metrics.hpp>
 #include <OpenKneeboard/Spriting.hpp>
 #include <OpenKneeboard/StateMachine.hpp>
 
@@ -136,6 +139,8 @@ OpenXRKneeboard::OpenXRKneeboard(
   : mOpenXR(next) {
   dprint("{}", __FUNCTION__);
   OPENKNEEBOARD_TraceLoggingScope("OpenXRKneeboard::OpenXRKneeboard()");
+  // Must be before any metrics are recorded
+  SHM::Metrics::Publish();
 
   XrSystemProperties systemProperties {
     .type = XR_TYPE_SYSTEM_PROPERTIES,
@@ -204,6 +209,9 @@ XrResult OpenXRKneeboard::xrEndFrame(
   const XrFrameEndInfo* frameEndInfo) {
   OPENKNEEBOARD_TraceLoggingScopedActivity(
     activity, "OpenXRKneeboard::xrEndFrame()");
+  OPENKNEEBOARD_MetricsInterval("OpenXRKneeboard::xrEndFrame interval");
+  OPENKNEEBOARD_MetricsScopedTimer("OpenXRKneeboard::xrEndFrame");
+  const auto startTime = SHM::ConsumerTelemetry::Clock::now();
   if (frameEndInfo->layerCount == 0) {
     TraceLoggingWriteTagged(activity, "No game layers.");
     return mOpenXR->xrEndFrame(session, frameEndInfo);
@@ -283,8 +291,12 @@ XrResult OpenXRKneeboard::xrEndFrame(
   layerSprites.reserve(layerCount);
   addedXRLayers.reserve(layerCount);
 
+  const auto shmFrameNumber = frame->mFrameNumber;
+  uint32_t visibleLayers {};
+
   for (size_t layerIndex = 0; layerIndex < layerCount; ++layerIndex) {
     const auto [layer, params] = vrLayers.at(layerIndex);
+    visibleLayers |= 1ui32 << (layer - frame->mLayers.data());
     OPENKNEEBOARD_TraceLoggingScopedActivity(
       layerActivity,
       "OpenXRKneeboard::xrEndFrame()/LayerSprites",
@@ -394,6 +406,15 @@ XrResult OpenXRKneeboard::xrEndFrame(
     check_xrresult(mOpenXR->xrReleaseSwapchainImage(mSwapchain, nullptr));
   }
 
+  SHM::ActiveConsumers::RecordFrame(
+    shm.GetConsumerKind(),
+    {
+      .mStartTime = startTime,
+      .mEndTime = SHM::ConsumerTelemetry::Clock::now(),
+      .mSHMFrameNumber = shmFrameNumber,
+      .mVisibleLayers = visibleLayers,
+    });
+
   XrFrameEndInfo nextFrameEndInfo {*frameEndInfo};
   nextFrameEndInfo.layers = nextLayers.data();
   nextFrameEndInfo.layerCount = static_cast<uint32_t>(nextLayers.size());
@@ -896,6 +917,8 @@ OpenKneeboard_xrNegotiateLoaderApiLayerInterface(
   const char* layerName,
   XrNegotiateApiLayerRequest* apiLayerRequest) {
   dprint("{}", __FUNCTION__);
+  // Not in `DllMain()`, as that's called with the loader lock held
+  EnableBinaryTraceFromRegistry();
 
   if (layerName != OpenXRApiLayerName) {
     dprint("Layer name mismatch:\n -{}\n +{}", OpenXRApiLayerName, layerName);
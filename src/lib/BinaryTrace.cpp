@@ -0,0 +1,314 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/BinaryTrace.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+#include <utility>
+
+namespace OpenKneeboard::BinaryTrace {
+
+namespace {
+
+constexpr char FileMagic[8] {'O', 'K', 'B', 'T', 'R', 'A', 'C', 'E'};
+constexpr uint32_t FileVersion = 1;
+
+// Buffers of exited threads are kept so their records are still dumped, but
+// there's no point keeping them forever if threads are created repeatedly
+constexpr std::size_t MaxRetiredBuffers = 32;
+
+// Sanity limits for `Read()`
+constexpr uint32_t MaxNameLength = 4096;
+constexpr uint64_t MaxRecordsPerThread = 1ull << 28;
+
+struct ThreadBuffer {
+  ThreadBuffer(uint64_t threadID, std::size_t capacity)
+    : mThreadID(threadID),
+      mMask(capacity - 1),
+      mWords(std::make_unique<std::atomic<uint64_t>[]>(capacity * 2)) {}
+
+  const uint64_t mThreadID {};
+  const std::size_t mMask {};
+  // Two words per record, so that readers racing with the owning thread
+  // read stale or new values rather than invoking undefined behavior
+  const std::unique_ptr<std::atomic<uint64_t>[]> mWords;
+  std::atomic<uint64_t> mWritten {0};
+  std::atomic<bool> mRetired {false};
+
+  std::size_t GetCapacity() const noexcept { return mMask + 1; }
+};
+
+struct Registry {
+  std::mutex mMutex;
+  std::size_t mRecordsPerThread {DefaultRecordsPerThread};
+  // Incremented by `Enable()` so threads drop their old buffers
+  std::atomic<uint64_t> mGeneration {0};
+  uint64_t mNextThreadID {1};
+  std::vector<std::shared_ptr<ThreadBuffer>> mBuffers;
+
+  std::vector<std::string> mNames;
+  std::unordered_map<std::string, NameID> mNameIDs;
+};
+
+Registry& GetRegistry() {
+  // Intentionally leaked, so it's usable from other static destructors and
+  // crash handlers
+  static auto registry = new Registry();
+  return *registry;
+}
+
+struct ThreadState {
+  std::shared_ptr<ThreadBuffer> mBuffer;
+  uint64_t mGeneration {};
+
+  ~ThreadState() {
+    if (mBuffer) {
+      mBuffer->mRetired.store(true, std::memory_order_relaxed);
+    }
+  }
+};
+thread_local ThreadState tThreadState;
+
+uint64_t Now() noexcept {
+  return static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch())
+      .count());
+}
+
+bool AcquireBuffer(ThreadState& state) noexcept try {
+  auto& registry = GetRegistry();
+  std::unique_lock lock(registry.mMutex);
+
+  auto& buffers = registry.mBuffers;
+  const auto retiredCount = std::ranges::count_if(buffers, [](auto& it) {
+    return it->mRetired.load(std::memory_order_relaxed);
+  });
+  if (std::cmp_greater_equal(retiredCount, MaxRetiredBuffers)) {
+    const auto it = std::ranges::find_if(buffers, [](auto& it) {
+      return it->mRetired.load(std::memory_order_relaxed);
+    });
+    buffers.erase(it);
+  }
+
+  state.mBuffer = std::make_shared<ThreadBuffer>(
+    registry.mNextThreadID++, registry.mRecordsPerThread);
+  state.mGeneration = registry.mGeneration.load(std::memory_order_relaxed);
+  buffers.push_back(state.mBuffer);
+  return true;
+} catch (...) {
+  // Most likely `std::bad_alloc`; tracing must never take down the process
+  return false;
+}
+
+template <class T>
+void WritePOD(std::ostream& out, const T& value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <class T>
+bool ReadPOD(std::istream& in, T& value) {
+  return static_cast<bool>(
+    in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+ThreadRecords Snapshot(const ThreadBuffer& buffer) {
+  const auto capacity = buffer.GetCapacity();
+  const auto end = buffer.mWritten.load(std::memory_order_acquire);
+  const auto begin = end > capacity ? end - capacity : 0;
+
+  ThreadRecords ret {.mThreadID = buffer.mThreadID};
+  ret.mRecords.reserve(static_cast<std::size_t>(end - begin));
+  for (auto i = begin; i < end; ++i) {
+    const auto words = &buffer.mWords[(i & buffer.mMask) * 2];
+    const auto word1 = words[1].load(std::memory_order_relaxed);
+    ret.mRecords.push_back({
+      .mTimestampNS = words[0].load(std::memory_order_relaxed),
+      .mName = static_cast<NameID>(word1 & 0xffffffff),
+      .mKind = static_cast<RecordKind>(word1 >> 32),
+    });
+  }
+
+  // If the owning thread kept writing while we copied, the oldest records
+  // may have been overwritten
+  const auto after = buffer.mWritten.load(std::memory_order_acquire);
+  if (after > capacity && after - capacity > begin) {
+    const auto overwritten = std::min<uint64_t>(
+      after - capacity - begin, static_cast<uint64_t>(ret.mRecords.size()));
+    ret.mRecords.erase(
+      ret.mRecords.begin(),
+      ret.mRecords.begin() + static_cast<std::ptrdiff_t>(overwritten));
+  }
+  return ret;
+}
+
+void DumpLocked(const Registry& registry, std::ostream& out) {
+  out.write(FileMagic, sizeof(FileMagic));
+  WritePOD(out, FileVersion);
+
+  WritePOD(out, static_cast<uint32_t>(registry.mNames.size()));
+  for (auto&& name: registry.mNames) {
+    WritePOD(out, static_cast<uint32_t>(name.size()));
+    out.write(name.data(), static_cast<std::streamsize>(name.size()));
+  }
+
+  WritePOD(out, static_cast<uint32_t>(registry.mBuffers.size()));
+  for (auto&& buffer: registry.mBuffers) {
+    const auto snapshot = Snapshot(*buffer);
+    WritePOD(out, snapshot.mThreadID);
+    WritePOD(out, static_cast<uint64_t>(snapshot.mRecords.size()));
+    out.write(
+      reinterpret_cast<const char*>(snapshot.mRecords.data()),
+      static_cast<std::streamsize>(
+        snapshot.mRecords.size() * sizeof(Record)));
+  }
+  out.flush();
+}
+
+}// namespace
+
+namespace detail {
+
+std::atomic<bool> gEnabled {false};
+
+void Write(NameID name, RecordKind kind) noexcept {
+  auto& state = tThreadState;
+  const auto generation
+    = GetRegistry().mGeneration.load(std::memory_order_acquire);
+  if ((!state.mBuffer) || state.mGeneration != generation) [[unlikely]] {
+    if (!AcquireBuffer(state)) {
+      return;
+    }
+  }
+
+  auto& buffer = *state.mBuffer;
+  const auto index = buffer.mWritten.load(std::memory_order_relaxed);
+  const auto words = &buffer.mWords[(index & buffer.mMask) * 2];
+  words[0].store(Now(), std::memory_order_relaxed);
+  words[1].store(
+    static_cast<uint64_t>(name) | (static_cast<uint64_t>(kind) << 32),
+    std::memory_order_relaxed);
+  buffer.mWritten.store(index + 1, std::memory_order_release);
+}
+
+}// namespace detail
+
+void Enable(std::size_t recordsPerThread) {
+  auto& registry = GetRegistry();
+  {
+    std::unique_lock lock(registry.mMutex);
+    registry.mRecordsPerThread
+      = std::bit_ceil(std::max<std::size_t>(recordsPerThread, 64));
+    registry.mBuffers.clear();
+    registry.mGeneration.fetch_add(1, std::memory_order_release);
+  }
+  detail::gEnabled.store(true, std::memory_order_relaxed);
+}
+
+void Disable() { detail::gEnabled.store(false, std::memory_order_relaxed); }
+
+NameID Intern(std::string_view name) {
+  auto& registry = GetRegistry();
+  std::unique_lock lock(registry.mMutex);
+  std::string key {name};
+  if (const auto it = registry.mNameIDs.find(key);
+      it != registry.mNameIDs.end()) {
+    return it->second;
+  }
+  const auto id = static_cast<NameID>(registry.mNames.size());
+  registry.mNames.push_back(key);
+  registry.mNameIDs.emplace(std::move(key), id);
+  return id;
+}
+
+void Dump(std::ostream& out) {
+  auto& registry = GetRegistry();
+  std::unique_lock lock(registry.mMutex);
+  DumpLocked(registry, out);
+}
+
+bool DumpToFile(const std::filesystem::path& path) noexcept try {
+  auto& registry = GetRegistry();
+  std::unique_lock lock(registry.mMutex, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    return false;
+  }
+  std::ofstream f(path, std::ios::binary | std::ios::trunc);
+  DumpLocked(registry, f);
+  return static_cast<bool>(f);
+} catch (...) {
+  return false;
+}
+
+std::optional<Trace> Read(std::istream& in) {
+  char magic[sizeof(FileMagic)] {};
+  uint32_t version {};
+  if (!in.read(magic, sizeof(magic))) {
+    return std::nullopt;
+  }
+  if (
+    std::memcmp(magic, FileMagic, sizeof(magic)) != 0
+    || !ReadPOD(in, version) || version != FileVersion) {
+    return std::nullopt;
+  }
+
+  Trace ret;
+  uint32_t nameCount {};
+  if (!ReadPOD(in, nameCount)) {
+    return std::nullopt;
+  }
+  for (uint32_t i = 0; i < nameCount; ++i) {
+    uint32_t length {};
+    if (!ReadPOD(in, length) || length > MaxNameLength) {
+      return std::nullopt;
+    }
+    std::string name(length, '\0');
+    if (!in.read(name.data(), length)) {
+      return std::nullopt;
+    }
+    ret.mNames.push_back(std::move(name));
+  }
+
+  uint32_t threadCount {};
+  if (!ReadPOD(in, threadCount)) {
+    return std::nullopt;
+  }
+  for (uint32_t i = 0; i < threadCount; ++i) {
+    ThreadRecords thread;
+    uint64_t recordCount {};
+    if (!(ReadPOD(in, thread.mThreadID) && ReadPOD(in, recordCount))) {
+      ret.mTruncated = true;
+      return ret;
+    }
+    if (recordCount > MaxRecordsPerThread) {
+      return std::nullopt;
+    }
+    thread.mRecords.resize(static_cast<std::size_t>(recordCount));
+    in.read(
+      reinterpret_cast<char*>(thread.mRecords.data()),
+      static_cast<std::streamsize>(recordCount * sizeof(Record)));
+    // Keep the complete records; drop a partial one
+    const auto complete
+      = static_cast<std::size_t>(in.gcount()) / sizeof(Record);
+    if (complete < thread.mRecords.size()) {
+      thread.mRecords.resize(complete);
+      ret.mThreads.push_back(std::move(thread));
+      ret.mTruncated = true;
+      return ret;
+    }
+    ret.mThreads.push_back(std::move(thread));
+  }
+
+  return ret;
+}
+
+}// namespace OpenKneeboard::BinaryTrace
@@ -15,11 +15,19 @@
 
 #include <dwrite.h>
 
+#include <string>
+
 namespace OpenKneeboard {
 
 struct D2DErrorRenderer::Impl final {
   winrt::com_ptr<IDWriteFactory> mDWrite;
   winrt::com_ptr<ID2D1SolidColorBrush> mTextBrush;
+
+  // Errors are usually shown for many frames in a row, so keep the last
+  // layout rather than shaping the same text every frame
+  std::string mText;
+  D2D1_SIZE_F mCanvasSize {};
+  winrt::com_ptr<IDWriteTextLayout> mTextLayout;
 };
 
 D2DErrorRenderer::D2DErrorRenderer(const audited_ptr<DXResources>& dxr)
@@ -47,32 +55,40 @@ void D2DErrorRenderer::Render(
   const auto canvasWidth = where.right - where.left,
              canvasHeight = where.bottom - where.top;
 
-  auto text = winrt::to_hstring(utf8);
-
-  winrt::com_ptr<IDWriteTextFormat> textFormat;
-
-  check_hresult(p->mDWrite->CreateTextFormat(
-    VariableWidthUIFont,
-    nullptr,
-    DWRITE_FONT_WEIGHT_NORMAL,
-    DWRITE_FONT_STYLE_NORMAL,
-    DWRITE_FONT_STRETCH_NORMAL,
-    canvasHeight * 0.05f,
-    L"",
-    textFormat.put()));
-
-  winrt::com_ptr<IDWriteTextLayout> textLayout;
-  check_hresult(p->mDWrite->CreateTextLayout(
-    text.data(),
-    static_cast<UINT32>(text.size()),
-    textFormat.get(),
-    canvasWidth,
-    canvasHeight,
-    textLayout.put()));
-  textLayout->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_CENTER);
-  textLayout->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_CENTER);
-
-  ctx->DrawTextLayout({where.left, where.top}, textLayout.get(), brush);
+  if (!(p->mTextLayout && p->mText == utf8
+        && p->mCanvasSize.width == canvasWidth
+        && p->mCanvasSize.height == canvasHeight)) {
+    auto text = winrt::to_hstring(utf8);
+
+    winrt::com_ptr<IDWriteTextFormat> textFormat;
+
+    check_hresult(p->mDWrite->CreateTextFormat(
+      VariableWidthUIFont,
+      nullptr,
+      DWRITE_FONT_WEIGHT_NORMAL,
+      DWRITE_FONT_STYLE_NORMAL,
+      DWRITE_FONT_STRETCH_NORMAL,
+      canvasHeight * 0.05f,
+      L"",
+      textFormat.put()));
+
+    winrt::com_ptr<IDWriteTextLayout> textLayout;
+    check_hresult(p->mDWrite->CreateTextLayout(
+      text.data(),
+      static_cast<UINT32>(text.size()),
+      textFormat.get(),
+      canvasWidth,
+      canvasHeight,
+      textLayout.put()));
+    textLayout->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_CENTER);
+    textLayout->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_CENTER);
+
+    p->mText = utf8;
+    p->mCanvasSize = {canvasWidth, canvasHeight};
+    p->mTextLayout = std::move(textLayout);
+  }
+
+  ctx->DrawTextLayout({where.left, where.top}, p->mTextLayout.get(), brush);
 }
 
 }// namespace OpenKneeboard
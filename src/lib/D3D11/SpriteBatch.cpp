@@ -35,37 +35,34 @@ SpriteBatch::SpriteBatch(ID3D11Device* device) {
   winrt::check_hresult(
     device->CreateBuffer(&uniformDesc, nullptr, mUniformBuffer.put()));
 
+  // Each sprite is an instance; the vertex shader expands it to two triangles
   std::array vertexMembers {
     D3D11_INPUT_ELEMENT_DESC {
-      .SemanticName = "SV_Position",
+      .SemanticName = "SOURCE_RECT",
       .Format = DXGI_FORMAT_R32G32B32A32_FLOAT,
-      .InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA,
+      .InputSlotClass = D3D11_INPUT_PER_INSTANCE_DATA,
+      .InstanceDataStepRate = 1,
     },
     D3D11_INPUT_ELEMENT_DESC {
-      .SemanticName = "COLOR",
+      .SemanticName = "DEST_RECT",
       .Format = DXGI_FORMAT_R32G32B32A32_FLOAT,
       .AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT,
-      .InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA,
+      .InputSlotClass = D3D11_INPUT_PER_INSTANCE_DATA,
+      .InstanceDataStepRate = 1,
     },
     D3D11_INPUT_ELEMENT_DESC {
-      .SemanticName = "TEXCOORD",
-      .Format = DXGI_FORMAT_R32G32_FLOAT,
-      .AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT,
-      .InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA,
-    },
-    D3D11_INPUT_ELEMENT_DESC {
-      .SemanticName = "TEXCOORD",
-      .SemanticIndex = 1,
-      .Format = DXGI_FORMAT_R32G32_FLOAT,
+      .SemanticName = "COLOR",
+      .Format = DXGI_FORMAT_R32G32B32A32_FLOAT,
       .AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT,
-      .InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA,
+      .InputSlotClass = D3D11_INPUT_PER_INSTANCE_DATA,
+      .InstanceDataStepRate = 1,
     },
     D3D11_INPUT_ELEMENT_DESC {
-      .SemanticName = "TEXCOORD",
-      .SemanticIndex = 2,
-      .Format = DXGI_FORMAT_R32G32_FLOAT,
+      .SemanticName = "SOURCE_CLAMP",
+      .Format = DXGI_FORMAT_R32G32B32A32_FLOAT,
       .AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT,
-      .InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA,
+      .InputSlotClass = D3D11_INPUT_PER_INSTANCE_DATA,
+      .InstanceDataStepRate = 1,
     },
   };
   winrt::check_hresult(device->CreateInputLayout(
@@ -75,16 +72,26 @@ SpriteBatch::SpriteBatch(ID3D11Device* device) {
     Sprite::VS.size(),
     mInputLayout.put()));
 
+  this->CreateVertexBuffer(MinVertexBufferSprites);
+}
+
+void SpriteBatch::CreateVertexBuffer(size_t spriteCount) {
+  OPENKNEEBOARD_TraceLoggingScope(
+    "D3D11::SpriteBatch::CreateVertexBuffer()",
+    TraceLoggingValue(spriteCount, "SpriteCount"));
   D3D11_BUFFER_DESC vertexDesc {
-    .ByteWidth = sizeof(ShaderData::Vertex) * MaxVertices,// Two triangles
+    .ByteWidth = static_cast<UINT>(sizeof(ShaderData::Instance) * spriteCount),
     .Usage = D3D11_USAGE_DYNAMIC,
     .BindFlags = D3D11_BIND_VERTEX_BUFFER,
     .CPUAccessFlags = D3D11_CPU_ACCESS_WRITE,
   };
+  mVertexBuffer = nullptr;
   winrt::check_hresult(
-    device->CreateBuffer(&vertexDesc, nullptr, mVertexBuffer.put()));
-
-  mPendingVertices.reserve(MaxVertices);
+    mDevice->CreateBuffer(&vertexDesc, nullptr, mVertexBuffer.put()));
+  mVertexBufferSprites = spriteCount;
+  mInstances.reserve(spriteCount);
+  // The new buffer is empty, so we can't reuse the previous contents
+  mBatch.InvalidatePreviousBatch();
 }
 
 SpriteBatch::~SpriteBatch() {
@@ -121,7 +128,7 @@ void SpriteBatch::Begin(ID3D11RenderTargetView* rtv, const PixelSize& rtvSize) {
   ID3D11Buffer* uniformBuffers[] {mUniformBuffer.get()};
 
   ID3D11Buffer* vertexBuffers[] {mVertexBuffer.get()};
-  UINT vertexStrides[] = {sizeof(ShaderData::Vertex)};
+  UINT vertexStrides[] = {sizeof(ShaderData::Instance)};
   UINT vertexOffsets[] = {0};
 
   static_assert(std::size(vertexBuffers) == std::size(vertexStrides));
@@ -173,66 +180,23 @@ void SpriteBatch::Draw(
     fatal("target not set, call BeginFrame()");
   }
 
-  auto& desc = mPendingSourceDesc;
-
-  if (source != mPendingSource) {
-    this->DrawPendingVertices();
-    mPendingSource = source;
+  if (source != mLastSource) {
     winrt::com_ptr<ID3D11Resource> resource;
     source->GetResource(resource.put());
     winrt::com_ptr<ID3D11Texture2D> texture;
     winrt::check_hresult(resource->QueryInterface(texture.put()));
+    D3D11_TEXTURE2D_DESC desc {};
     texture->GetDesc(&desc);
+    mLastSource = source;
+    mLastSourceSize = {desc.Width, desc.Height};
   }
 
-  using TexCoord = decltype(ShaderData::Vertex::mTexCoord);
-
-  const TexCoord texClampTL {
-    (sourceRect.Left() + 0.5f) / desc.Width,
-    (sourceRect.Top() + 0.5f) / desc.Height,
-  };
-
-  const TexCoord texClampBR {
-    (sourceRect.Right() - 0.5f) / desc.Width,
-    (sourceRect.Bottom() - 0.5f) / desc.Height,
-  };
-
-  using TexCoord = decltype(ShaderData::Vertex::mTexCoord);
-  const TexCoord srcTL = sourceRect.TopLeft().StaticCast<float, TexCoord>();
-  const TexCoord srcBR = sourceRect.BottomRight().StaticCast<float, TexCoord>();
-  const TexCoord srcBL {srcTL[0], srcBR[1]};
-  const TexCoord srcTR {srcBR[0], srcTL[1]};
-
-  using Position = decltype(ShaderData::Vertex::mPosition);
-  const Position dstTL {destRect.Left<float>(), destRect.Top<float>(), 0, 1};
-  const Position dstBR {
-    destRect.Right<float>(), destRect.Bottom<float>(), 0, 1};
-  const Position dstBL {destRect.Left<float>(), destRect.Bottom<float>(), 0, 1};
-  const Position dstTR {destRect.Right<float>(), destRect.Top<float>(), 0, 1};
-
-  const auto makeVertex = [=](const auto& src, const auto& dst) {
-    return ShaderData::Vertex {
-      .mPosition = dst,
-      .mColor = tint,
-      .mTexCoord = src,
-      .mTexClampTL = texClampTL,
-      .mTexClampBR = texClampBR,
-    };
-  };
-
-  std::ranges::copy(
-
-    std::array {
-      // First triangle: excludes top right
-      makeVertex(srcBL, dstBL),
-      makeVertex(srcTL, dstTL),
-      makeVertex(srcBR, dstBR),
-      // Second triangle: excludes bottom left
-      makeVertex(srcTL, dstTL),
-      makeVertex(srcTR, dstTR),
-      makeVertex(srcBR, dstBR),
-    },
-    std::back_inserter(mPendingVertices));
+  mBatch.Draw(
+    source,
+    mLastSourceSize,
+    sourceRect,
+    destRect,
+    std::bit_cast<std::array<float, 4>>(tint));
 }
 
 void SpriteBatch::End() {
@@ -241,62 +205,98 @@ void SpriteBatch::End() {
     fatal("target not set; double-End() or Begin() not called?");
   }
 
-  this->DrawPendingVertices();
+  this->DrawBatch();
+  mBatch.EndBatch();
+  // The pointer may be reused for a different texture next frame
+  mLastSource = nullptr;
 
   ID3D11RenderTargetView* nullrtv {nullptr};
   mDeviceContext->OMSetRenderTargets(1, &nullrtv, nullptr);
   mTarget = nullptr;
 }
 
-void SpriteBatch::DrawPendingVertices() {
+void SpriteBatch::DrawBatch() {
   OPENKNEEBOARD_TraceLoggingScope(
-    "D3D11::SpriteBatch::DrawPendingVertices()",
-    TraceLoggingValue(mPendingVertices.size(), "Count"));
-  if (mPendingVertices.empty()) {
+    "D3D11::SpriteBatch::DrawBatch()",
+    TraceLoggingValue(mBatch.GetInstances().size(), "Count"));
+  if (mBatch.IsEmpty()) {
     return;
   }
 
-#pragma region Uniform buffer
-  {
-    D3D11_MAPPED_SUBRESOURCE mapping {};
-    winrt::check_hresult(mDeviceContext->Map(
-      mUniformBuffer.get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapping));
-    const auto uniform = reinterpret_cast<ShaderData::Uniform*>(mapping.pData);
-
-    *uniform = ShaderData::Uniform {
-      .mSourceDimensions =
-        {
-          static_cast<float>(mPendingSourceDesc.Width),
-          static_cast<float>(mPendingSourceDesc.Height),
-        },
-      .mDestDimensions = {mTargetDimensions[0], mTargetDimensions[1]},
-    };
-
-    mDeviceContext->Unmap(mUniformBuffer.get(), 0);
-  }
-#pragma endregion// Uniform buffer
+  const auto instances = mBatch.GetInstances();
+  const auto sources = mBatch.GetSources();
 
 #pragma region Vertex buffer
-  {
+  if (!mBatch.IsSameAsPreviousBatch()) {
+    if (instances.size() > mVertexBufferSprites) {
+      this->CreateVertexBuffer(
+        std::max(instances.size(), mVertexBufferSprites * 2));
+      ID3D11Buffer* vertexBuffers[] {mVertexBuffer.get()};
+      UINT vertexStrides[] = {sizeof(ShaderData::Instance)};
+      UINT vertexOffsets[] = {0};
+      mDeviceContext->IASetVertexBuffers(
+        0,
+        std::size(vertexBuffers),
+        vertexBuffers,
+        vertexStrides,
+        vertexOffsets);
+    }
+
+    mInstances.clear();
+    for (auto&& instance: instances) {
+      const auto& source = sources[instance.mSourceIndex];
+      mInstances.push_back({
+        .mSourceRect = instance.mSourceRect,
+        .mDestRect = instance.mDestRect,
+        .mColor = instance.mColor,
+        .mSourceClamp
+        = SpriteBatchVertices::GetSourceClamp(source.mSize, source.mRect),
+      });
+    }
+
     D3D11_MAPPED_SUBRESOURCE mapping {};
     winrt::check_hresult(mDeviceContext->Map(
       mVertexBuffer.get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapping));
     memcpy(
       mapping.pData,
-      mPendingVertices.data(),
-      sizeof(decltype(mPendingVertices)::value_type) * mPendingVertices.size());
+      mInstances.data(),
+      sizeof(decltype(mInstances)::value_type) * mInstances.size());
     mDeviceContext->Unmap(mVertexBuffer.get(), 0);
   }
 #pragma endregion// Vertex buffer
 
-  ID3D11ShaderResourceView* resources[] {mPendingSource};
-  mDeviceContext->PSSetShaderResources(0, std::size(resources), resources);
-  mDeviceContext->Draw(mPendingVertices.size(), 0);
+  // D3D11 doesn't support descriptor indexing, so we need a draw call per
+  // source texture
+  mBatch.ForEachSourceRun([this](
+                            const auto& source,
+                            const std::size_t firstSprite,
+                            const std::size_t spriteCount) {
+#pragma region Uniform buffer
+    const ShaderData::Uniform uniform {
+      .mSourceDimensions = {
+        source.mSize.template Width<float>(),
+        source.mSize.template Height<float>(),
+      },
+      .mDestDimensions = {mTargetDimensions[0], mTargetDimensions[1]},
+    };
+    if (uniform != mUniform) {
+      D3D11_MAPPED_SUBRESOURCE mapping {};
+      winrt::check_hresult(mDeviceContext->Map(
+        mUniformBuffer.get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapping));
+      *reinterpret_cast<ShaderData::Uniform*>(mapping.pData) = uniform;
+      mDeviceContext->Unmap(mUniformBuffer.get(), 0);
+      mUniform = uniform;
+    }
+#pragma endregion// Uniform buffer
 
-#pragma region Cleanup
-  mPendingSource = nullptr;
-  mPendingVertices.clear();
-#pragma endregion// cleanup
+    ID3D11ShaderResourceView* resources[] {source.mSource};
+    mDeviceContext->PSSetShaderResources(0, std::size(resources), resources);
+    mDeviceContext->DrawInstanced(
+      VerticesPerSprite,
+      static_cast<UINT>(spriteCount),
+      0,
+      static_cast<UINT>(firstSprite));
+  });
 }
 
 }// namespace OpenKneeboard::D3D11
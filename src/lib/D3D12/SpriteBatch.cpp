@@ -100,42 +100,43 @@ SpriteBatch::SpriteBatch(
   check_hresult(mRootSignature->SetName(
     L"OpenKneeboard::D3D12::SpriteBatch::RootSignature"));
 
+  // Each sprite is an instance; the vertex shader expands it to two triangles
   constexpr auto inputElements = std::array {
     D3D12_INPUT_ELEMENT_DESC {
-      "SV_Position",
+      "SOURCE_RECT",
       0,
       DXGI_FORMAT_R32G32B32A32_FLOAT,
       0,
-      offsetof(Shaders::SpriteBatch::Vertex, mPosition),
-      D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,
-      0,
+      offsetof(Instance, mSourceRect),
+      D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA,
+      1,
     },
     D3D12_INPUT_ELEMENT_DESC {
-      "COLOR",
+      "DEST_RECT",
       0,
       DXGI_FORMAT_R32G32B32A32_FLOAT,
       0,
-      offsetof(Shaders::SpriteBatch::Vertex, mColor),
-      D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,
-      0,
+      offsetof(Instance, mDestRect),
+      D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA,
+      1,
     },
     D3D12_INPUT_ELEMENT_DESC {
-      "TEXCOORD",
-      0,
-      DXGI_FORMAT_R32G32_FLOAT,
+      "COLOR",
       0,
-      offsetof(Shaders::SpriteBatch::Vertex, mTexCoord),
-      D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,
+      DXGI_FORMAT_R32G32B32A32_FLOAT,
       0,
+      offsetof(Instance, mColor),
+      D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA,
+      1,
     },
     D3D12_INPUT_ELEMENT_DESC {
       "TEXTURE_INDEX",
       0,
       DXGI_FORMAT_R32_UINT,
       0,
-      offsetof(Shaders::SpriteBatch::Vertex, mTextureIndex),
-      D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,
-      0,
+      offsetof(Instance, mSourceIndex),
+      D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA,
+      1,
     },
   };
 
@@ -246,14 +247,12 @@ void SpriteBatch::Draw(
     fatal("target not set, call Begin()");
   }
 
-  mNextFrame->mSprites.push_back(
-    Sprite {
-      .mSource = source,
-      .mSourceSize = sourceSize,
-      .mSourceRect = sourceRect,
-      .mDestRect = destRect,
-      .mTint = tint,
-    });
+  mBatch.Draw(
+    source,
+    sourceSize,
+    sourceRect,
+    destRect,
+    std::bit_cast<SpriteBatchCore<ID3D12Resource*>::Color>(tint));
 }
 
 void SpriteBatch::End() {
@@ -261,96 +260,49 @@ void SpriteBatch::End() {
   if (!mNextFrame) [[unlikely]] {
     fatal("target not set; double-End() or Begin() not called?");
   }
-  if (mNextFrame->mSprites.empty()) [[unlikely]] {
+  if (mBatch.IsEmpty()) [[unlikely]] {
     fatal("no sprites");
   }
-  const scope_exit clearNext {[this]() { this->mNextFrame = std::nullopt; }};
-
-  const auto& targetSize = mNextFrame->mRenderTargetViewSize;
-  CBuffer constantData {
-    .mTargetDimensions =
-      {targetSize.Width<float>(), targetSize.Height<float>()},
-  };
-
-  std::vector<Vertex> vertices;
-  vertices.reserve(mNextFrame->mSprites.size() * VerticesPerSprite);
+  const scope_exit clearNext {[this]() {
+    this->mNextFrame = std::nullopt;
+    this->mBatch.EndBatch();
+  }};
+
+  // Sprites sharing a source texture and source rect share a descriptor
+  const auto sources = mBatch.GetSources();
+  if (sources.size() > MaxSpritesPerBatch) [[unlikely]] {
+    fatal(
+      "Too many distinct sources in one batch: {} > {}",
+      sources.size(),
+      MaxSpritesPerBatch);
+  }
 
   const auto heapOffset =
     (mDrawCount++ % MaxInflightFrames) * MaxSpritesPerBatch;
-
-  for (uint32_t i = 0; i < mNextFrame->mSprites.size(); i++) {
-    const auto& sprite = mNextFrame->mSprites[i];
-
+  for (uint32_t i = 0; i < sources.size(); i++) {
     mDevice->CreateShaderResourceView(
-      sprite.mSource,
+      sources[i].mSource,
       nullptr,
       mShaderResourceViewHeap->GetCpuHandle(
         numeric_cast<std::size_t>(heapOffset + i)));
+  }
 
-    constantData.mSourceDimensions[i] = {
-      sprite.mSourceSize.Width<float>(),
-      sprite.mSourceSize.Height<float>(),
-    };
-
-    constantData.mSourceClamp[i] = {
-      (sprite.mSourceRect.Left<float>() + 0.5f) / sprite.mSourceSize.Width(),
-      (sprite.mSourceRect.Top<float>() + 0.5f) / sprite.mSourceSize.Height(),
-      (sprite.mSourceRect.Right<float>() - 0.5f) / sprite.mSourceSize.Width(),
-      (sprite.mSourceRect.Bottom<float>() - 0.5f) / sprite.mSourceSize.Height(),
-    };
-
-    using TexCoord = std::array<float, 2>;
-
-    const TexCoord srcTL =
-      sprite.mSourceRect.TopLeft().StaticCast<float, TexCoord>();
-    const TexCoord srcBR =
-      sprite.mSourceRect.BottomRight().StaticCast<float, TexCoord>();
-    const TexCoord srcBL {srcTL[0], srcBR[1]};
-    const TexCoord srcTR {srcBR[0], srcTL[1]};
-
-    using Position = Vertex::Position;
-
-    // Destination coordinates in real 3d coordinates
-    const Position dstTL =
-      sprite.mDestRect.TopLeft().StaticCast<float, Position>();
-    const Position dstBR =
-      sprite.mDestRect.BottomRight().StaticCast<float, Position>();
-    const Position dstTR {dstBR[0], dstTL[1]};
-    const Position dstBL {dstTL[0], dstBR[1]};
-
-    auto makeVertex = [=](const TexCoord& tc, const Position& pos) {
-      return Vertex {
-        .mPosition = pos,
-        .mColor = std::bit_cast<decltype(Vertex::mColor)>(sprite.mTint),
-        .mTexCoord = tc,
-        .mTextureIndex = i,
-      };
-    };
-
-    // A rectangle is two triangles
+  const auto constantData = SpriteBatchVertices::GetUniformBuffer(
+    mBatch, mNextFrame->mRenderTargetViewSize);
 
-    // First triangle: excludes top right
-    vertices.push_back(makeVertex(srcBL, dstBL));
-    vertices.push_back(makeVertex(srcTL, dstTL));
-    vertices.push_back(makeVertex(srcBR, dstBR));
-
-    // Second triangle: excludes bottom left
-    vertices.push_back(makeVertex(srcTL, dstTL));
-    vertices.push_back(makeVertex(srcTR, dstTR));
-    vertices.push_back(makeVertex(srcBR, dstBR));
-  }
+  // The instances are uploaded as-is; no per-vertex data
+  const auto instances = mBatch.GetInstances();
+  const auto instancesByteSize = sizeof(Instance) * instances.size();
 
   auto& graphicsMemory = DirectX::DX12::GraphicsMemory::Get(mDevice);
   const auto constantBuffer = graphicsMemory.AllocateConstant(constantData);
-  const auto vertexBuffer =
-    graphicsMemory.Allocate(sizeof(Vertex) * vertices.size());
-  memcpy(
-    vertexBuffer.Memory(), vertices.data(), sizeof(Vertex) * vertices.size());
-
-  const D3D12_VERTEX_BUFFER_VIEW vertexBufferView {
-    .BufferLocation = vertexBuffer.GpuAddress(),
-    .SizeInBytes = static_cast<UINT>(vertexBuffer.Size()),
-    .StrideInBytes = sizeof(Vertex),
+  const auto instanceBuffer = graphicsMemory.Allocate(instancesByteSize);
+  memcpy(instanceBuffer.Memory(), instances.data(), instancesByteSize);
+
+  const D3D12_VERTEX_BUFFER_VIEW instanceBufferView {
+    .BufferLocation = instanceBuffer.GpuAddress(),
+    .SizeInBytes = static_cast<UINT>(instanceBuffer.Size()),
+    .StrideInBytes = sizeof(Instance),
   };
 
   const auto commandList = mNextFrame->mCommandList;
@@ -363,8 +315,9 @@ void SpriteBatch::End() {
     1,
     mShaderResourceViewHeap->GetGpuHandle(
       numeric_cast<std::size_t>(heapOffset)));
-  commandList->IASetVertexBuffers(0, 1, &vertexBufferView);
-  commandList->DrawInstanced(vertices.size(), 1, 0, 0);
+  commandList->IASetVertexBuffers(0, 1, &instanceBufferView);
+  commandList->DrawInstanced(
+    VerticesPerSprite, static_cast<UINT>(instances.size()), 0, 0);
 }
 
 }// namespace OpenKneeboard::D3D12
@@ -0,0 +1,172 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/DCSMissionDigest.hpp>
+
+#include <bit>
+#include <cstring>
+#include <type_traits>
+
+namespace OpenKneeboard {
+
+namespace {
+
+// "OKMD"
+constexpr uint32_t Magic = 0x444d4b4f;
+// Increment on any format change, or any change to how digests are
+// extracted; old data is discarded
+constexpr uint32_t Version = 1;
+
+static_assert(
+  std::endian::native == std::endian::little,
+  "The serialized format is little-endian");
+
+template <class T>
+  requires std::is_trivially_copyable_v<T>
+void Append(std::string& out, T value) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void Append(std::string& out, std::string_view value) {
+  Append(out, static_cast<uint32_t>(value.size()));
+  out.append(value);
+}
+
+template <class T>
+void Append(std::string& out, const std::optional<T>& value) {
+  Append(out, static_cast<uint8_t>(value.has_value()));
+  if (value) {
+    Append(out, *value);
+  }
+}
+
+class Reader {
+ public:
+  explicit Reader(std::string_view data) : mData(data) {}
+
+  template <class T>
+    requires std::is_trivially_copyable_v<T>
+  bool Read(T& out) {
+    if (mData.size() < sizeof(T)) {
+      return false;
+    }
+    std::memcpy(&out, mData.data(), sizeof(T));
+    mData.remove_prefix(sizeof(T));
+    return true;
+  }
+
+  bool Read(std::string& out) {
+    uint32_t size {};
+    if (!(this->Read(size) && mData.size() >= size)) {
+      return false;
+    }
+    out = mData.substr(0, size);
+    mData.remove_prefix(size);
+    return true;
+  }
+
+  template <class T>
+  bool Read(std::optional<T>& out) {
+    uint8_t hasValue {};
+    if (!this->Read(hasValue) || hasValue > 1) {
+      return false;
+    }
+    if (!hasValue) {
+      out.reset();
+      return true;
+    }
+    return this->Read(out.emplace());
+  }
+
+  bool IsEmpty() const {
+    return mData.empty();
+  }
+
+ private:
+  std::string_view mData;
+};
+
+}// namespace
+
+uint64_t DCSMissionDigest::HashContent(
+  std::initializer_list<std::string_view> files) {
+  // FNV-1a, including the sizes so that moving bytes between files changes
+  // the hash
+  uint64_t hash = 0xcbf29ce484222325;
+  const auto add = [&hash](std::string_view bytes) {
+    for (const auto c: bytes) {
+      hash ^= static_cast<uint8_t>(c);
+      hash *= 0x100000001b3;
+    }
+  };
+  for (const auto file: files) {
+    const auto size = static_cast<uint64_t>(file.size());
+    add({reinterpret_cast<const char*>(&size), sizeof(size)});
+    add(file);
+  }
+  return hash;
+}
+
+std::string DCSMissionDigest::Serialize() const {
+  std::string ret;
+  Append(ret, Magic);
+  Append(ret, Version);
+
+  Append(ret, mTitle);
+  Append(ret, mSituation);
+  Append(ret, mStartDate);
+  Append(ret, mStartTime);
+  Append(ret, mWeather);
+  for (const auto& coalition: mCoalitions) {
+    Append(ret, coalition.mCountries);
+    Append(ret, coalition.mTask);
+    Append(ret, static_cast<uint32_t>(coalition.mImages.size()));
+    for (const auto& image: coalition.mImages) {
+      Append(ret, std::string_view {image});
+    }
+    Append(ret, coalition.mBullseye);
+  }
+  return ret;
+}
+
+std::optional<DCSMissionDigest> DCSMissionDigest::Deserialize(
+  std::string_view data) {
+  Reader reader {data};
+  uint32_t magic {};
+  uint32_t version {};
+  if (!(reader.Read(magic) && reader.Read(version))) {
+    return std::nullopt;
+  }
+  if (magic != Magic || version != Version) {
+    return std::nullopt;
+  }
+
+  DCSMissionDigest ret;
+  if (!(reader.Read(ret.mTitle) && reader.Read(ret.mSituation)
+        && reader.Read(ret.mStartDate) && reader.Read(ret.mStartTime)
+        && reader.Read(ret.mWeather))) {
+    return std::nullopt;
+  }
+  for (auto& coalition: ret.mCoalitions) {
+    uint32_t imageCount {};
+    if (!(reader.Read(coalition.mCountries) && reader.Read(coalition.mTask)
+          && reader.Read(imageCount))) {
+      return std::nullopt;
+    }
+    for (uint32_t i = 0; i < imageCount; ++i) {
+      if (!reader.Read(coalition.mImages.emplace_back())) {
+        return std::nullopt;
+      }
+    }
+    if (!reader.Read(coalition.mBullseye)) {
+      return std::nullopt;
+    }
+  }
+
+  if (!reader.IsEmpty()) {
+    return std::nullopt;
+  }
+  return ret;
+}
+
+}// namespace OpenKneeboard
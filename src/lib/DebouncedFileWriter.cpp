@@ -0,0 +1,299 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/DebouncedFileWriter.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif
+
+namespace OpenKneeboard {
+
+DebouncedFileWriter::DebouncedFileWriter()
+  : DebouncedFileWriter(Options {}) {}
+
+DebouncedFileWriter::DebouncedFileWriter(
+  const Options& options,
+  WriteCallback writeCallback)
+  : mOptions(options),
+    mWriteCallback(std::move(writeCallback)) {
+  mThread = std::jthread {
+    [this](std::stop_token stopToken) { this->Run(stopToken); }};
+}
+
+DebouncedFileWriter::~DebouncedFileWriter() {
+  this->Flush();
+  mThread.request_stop();
+  mThread.join();
+}
+
+void DebouncedFileWriter::Write(
+  const std::filesystem::path& path,
+  std::string contents) {
+  this->Enqueue(path, std::move(contents));
+}
+
+void DebouncedFileWriter::Remove(const std::filesystem::path& path) {
+  this->Enqueue(path, std::nullopt);
+}
+
+void DebouncedFileWriter::Enqueue(
+  const std::filesystem::path& path,
+  std::optional<std::string> contents) {
+  const auto now = Clock::now();
+  {
+    std::unique_lock lock(mMutex);
+    ++mQueuedGeneration;
+    auto it = mPending.find(path);
+    if (it == mPending.end()) {
+      mPending.emplace(
+        path,
+        Pending {
+          .mContents = std::move(contents),
+          .mFirstQueuedAt = now,
+          .mLastQueuedAt = now,
+        });
+    } else {
+      ++mStatistics.mCoalesced;
+      it->second.mContents = std::move(contents);
+      it->second.mLastQueuedAt = now;
+    }
+  }
+  mWakeWorker.notify_one();
+}
+
+void DebouncedFileWriter::Flush() {
+  std::unique_lock lock(mMutex);
+  const auto generation = mQueuedGeneration;
+  if (mWrittenGeneration >= generation) {
+    return;
+  }
+  mFlushRequested = true;
+  mWakeWorker.notify_one();
+  mWroteBatch.wait(
+    lock, [&]() { return mWrittenGeneration >= generation; });
+}
+
+bool DebouncedFileWriter::IsPending(const std::filesystem::path& path) const {
+  std::unique_lock lock(mMutex);
+  return mPending.contains(path) || mInFlight.contains(path);
+}
+
+DebouncedFileWriter::Statistics DebouncedFileWriter::GetStatistics() const {
+  std::unique_lock lock(mMutex);
+  return mStatistics;
+}
+
+void DebouncedFileWriter::Run(std::stop_token stopToken) {
+  std::unique_lock lock(mMutex);
+  while (!stopToken.stop_requested()) {
+    if (mPending.empty()) {
+      mWakeWorker.wait(
+        lock, stopToken, [this]() { return !mPending.empty(); });
+      continue;
+    }
+
+    // Find the earliest time something is due
+    auto due = Clock::time_point::max();
+    for (auto&& [path, pending]: mPending) {
+      due = std::min(
+        {
+          due,
+          pending.mLastQueuedAt + mOptions.mDebounce,
+          pending.mFirstQueuedAt + mOptions.mMaxDelay,
+        });
+    }
+
+    if (!mFlushRequested && Clock::now() < due) {
+      mWakeWorker.wait_until(
+        lock, stopToken, due, [this]() { return mFlushRequested; });
+      continue;
+    }
+
+    // On flush, write everything; otherwise, just what's due
+    const auto now = Clock::now();
+    std::vector<std::pair<std::filesystem::path, Pending>> batch;
+    for (auto it = mPending.begin(); it != mPending.end();) {
+      const auto& pending = it->second;
+      const auto isDue = mFlushRequested
+        || pending.mLastQueuedAt + mOptions.mDebounce <= now
+        || pending.mFirstQueuedAt + mOptions.mMaxDelay <= now;
+      if (!isDue) {
+        ++it;
+        continue;
+      }
+      mInFlight.insert(it->first);
+      batch.emplace_back(it->first, std::move(it->second));
+      it = mPending.erase(it);
+    }
+    const auto generation = mPending.empty() ? mQueuedGeneration : 0;
+    mFlushRequested = false;
+
+    lock.unlock();
+    for (auto&& [path, pending]: batch) {
+      this->WriteOne(path, pending);
+    }
+    lock.lock();
+    for (auto&& [path, pending]: batch) {
+      mInFlight.erase(path);
+    }
+
+    // Generations are only meaningful once nothing is left queued; partial
+    // batches leave `mWrittenGeneration` alone so `Flush()` keeps waiting
+    if (generation) {
+      mWrittenGeneration = std::max(mWrittenGeneration, generation);
+    }
+    mWroteBatch.notify_all();
+  }
+}
+
+void DebouncedFileWriter::WriteOne(
+  const std::filesystem::path& path,
+  const Pending& pending) {
+  const auto startedAt = Clock::now();
+  WriteResult result {
+    .mSucceeded = true,
+    .mBytes = pending.mContents ? pending.mContents->size() : 0,
+  };
+  try {
+    if (pending.mContents) {
+      WriteAtomically(path, *pending.mContents);
+    } else {
+      std::filesystem::remove(path);
+    }
+  } catch (const std::filesystem::filesystem_error& e) {
+    result.mSucceeded = false;
+    result.mError = e.what();
+  }
+  const auto finishedAt = Clock::now();
+  result.mLatency = finishedAt - pending.mFirstQueuedAt;
+  result.mWriteDuration = finishedAt - startedAt;
+
+  {
+    std::unique_lock lock(mMutex);
+    auto& stats = mStatistics;
+    if (!result.mSucceeded) {
+      ++stats.mFailures;
+    } else if (pending.mContents) {
+      ++stats.mWrites;
+      stats.mBytesWritten += result.mBytes;
+    } else {
+      ++stats.mRemovals;
+    }
+    stats.mLastLatency = result.mLatency;
+    stats.mMaxLatency = std::max(stats.mMaxLatency, result.mLatency);
+    stats.mLastWriteDuration = result.mWriteDuration;
+    stats.mMaxWriteDuration
+      = std::max(stats.mMaxWriteDuration, result.mWriteDuration);
+  }
+
+  if (mWriteCallback) {
+    mWriteCallback(path, result);
+  }
+}
+
+void DebouncedFileWriter::WriteAtomically(
+  const std::filesystem::path& path,
+  std::string_view contents) {
+  const auto parent = path.parent_path();
+  if (!parent.empty() && !std::filesystem::exists(parent)) {
+    std::filesystem::create_directories(parent);
+  }
+
+  // Same directory, so the rename can't cross filesystems
+  auto temporary = path;
+  temporary += ".tmp";
+
+  {
+    std::ofstream f(temporary, std::ios::binary | std::ios::trunc);
+    f.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    f.flush();
+    if (!f) {
+      std::error_code ec;
+      std::filesystem::remove(temporary, ec);
+      throw std::filesystem::filesystem_error(
+        "Failed to write temporary file",
+        temporary,
+        std::make_error_code(std::errc::io_error));
+    }
+  }
+
+#ifdef _WIN32
+  const auto throwLastError = [](const char* what, const auto& errorPath) {
+    throw std::filesystem::filesystem_error(
+      what,
+      errorPath,
+      std::error_code(
+        static_cast<int>(GetLastError()), std::system_category()));
+  };
+
+  // The contents must be on disk before the rename is, or a power loss can
+  // leave an empty file in place of the previous contents
+  {
+    const auto handle = CreateFileW(
+      temporary.c_str(),
+      GENERIC_WRITE,
+      0,
+      nullptr,
+      OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL,
+      nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+      throwLastError("Failed to open temporary file", temporary);
+    }
+    const auto flushed = FlushFileBuffers(handle);
+    const auto error = GetLastError();
+    CloseHandle(handle);
+    if (!flushed) {
+      SetLastError(error);
+      throwLastError("Failed to flush temporary file", temporary);
+    }
+  }
+
+  // Replaces the target atomically on NTFS, and doesn't return until the
+  // rename is on disk
+  if (!MoveFileExW(
+        temporary.c_str(),
+        path.c_str(),
+        MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+    throwLastError("Failed to replace file", path);
+  }
+#else
+  const auto throwErrno = [](const char* what, const auto& errorPath) {
+    throw std::filesystem::filesystem_error(
+      what, errorPath, std::error_code(errno, std::generic_category()));
+  };
+  const auto sync = [&](const std::filesystem::path& syncPath, int flags) {
+    const auto fd = open(syncPath.c_str(), flags);
+    if (fd == -1) {
+      throwErrno("Failed to open for fsync", syncPath);
+    }
+    const auto synced = fsync(fd) == 0;
+    const auto error = errno;
+    close(fd);
+    if (!synced) {
+      errno = error;
+      throwErrno("Failed to fsync", syncPath);
+    }
+  };
+
+  // As on Windows, the contents must be on disk before the rename
+  sync(temporary, O_WRONLY);
+  // Replaces the target if it exists; atomic on POSIX filesystems
+  std::filesystem::rename(temporary, path);
+  // ... and the rename isn't durable until the directory entry is
+  sync(parent.empty() ? "." : parent, O_RDONLY | O_DIRECTORY);
+#endif
+}
+
+}// namespace OpenKneeboard
@@ -0,0 +1,167 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/DirtyRegion.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace OpenKneeboard {
+
+namespace {
+
+constexpr int64_t Area(const PixelRect& rect) noexcept {
+  return rect.Width<int64_t>() * rect.Height<int64_t>();
+}
+
+constexpr PixelRect Union(const PixelRect& a, const PixelRect& b) noexcept {
+  const auto left = std::min(a.Left(), b.Left());
+  const auto top = std::min(a.Top(), b.Top());
+  const auto right = std::max(a.Right(), b.Right());
+  const auto bottom = std::max(a.Bottom(), b.Bottom());
+  return {{left, top}, {right - left, bottom - top}};
+}
+
+constexpr bool Contains(const PixelRect& outer, const PixelRect& inner) noexcept {
+  return outer.Left() <= inner.Left() && outer.Top() <= inner.Top()
+    && outer.Right() >= inner.Right() && outer.Bottom() >= inner.Bottom();
+}
+
+/** How many pixels would be needlessly copied if we merged these.
+ *
+ * Negative if the rects overlap by more than the union adds.
+ */
+constexpr int64_t MergeCost(const PixelRect& a, const PixelRect& b) noexcept {
+  return Area(Union(a, b)) - (Area(a) + Area(b));
+}
+
+/// Merge if no more than 1/4 of the merged rect would be clean
+constexpr bool ShouldMerge(const PixelRect& a, const PixelRect& b) noexcept {
+  return MergeCost(a, b) * 4 <= Area(Union(a, b));
+}
+
+}// namespace
+
+DirtyRegion::DirtyRegion(const PixelSize& bounds) : mBounds(bounds) {}
+
+void DirtyRegion::SetBounds(const PixelSize& bounds) {
+  if (bounds == mBounds) {
+    return;
+  }
+  mBounds = bounds;
+  this->AddAll();
+}
+
+bool DirtyRegion::IsAll() const noexcept {
+  return mCount == 1 && mRects.front() == PixelRect {{0, 0}, mBounds};
+}
+
+uint64_t DirtyRegion::GetArea() const noexcept {
+  uint64_t ret = 0;
+  for (auto&& rect: this->GetRects()) {
+    ret += static_cast<uint64_t>(Area(rect));
+  }
+  return ret;
+}
+
+void DirtyRegion::AddAll() {
+  mCount = 0;
+  if (!mBounds) {
+    return;
+  }
+  mRects[0] = {{0, 0}, mBounds};
+  mCount = 1;
+}
+
+void DirtyRegion::Add(const DirtyRegion& other) {
+  if (other.mBounds != mBounds) {
+    this->AddAll();
+    return;
+  }
+  for (auto&& rect: other.GetRects()) {
+    this->Add(rect);
+  }
+}
+
+void DirtyRegion::Add(const PixelRect& unclamped) {
+  if (this->IsAll()) {
+    return;
+  }
+  const auto rect = unclamped.Clamped(mBounds);
+  if (!rect) {
+    return;
+  }
+
+  for (auto&& existing: this->GetRects()) {
+    if (Contains(existing, rect)) {
+      return;
+    }
+  }
+
+  for (std::size_t i = 0; i < mCount;) {
+    if (Contains(rect, mRects[i])) {
+      this->Erase(i);
+      continue;
+    }
+    ++i;
+  }
+
+  mRects[mCount++] = rect;
+  this->MergeAdjacent();
+  while (mCount > MaxRects) {
+    this->MergeCheapestPair();
+  }
+
+  const auto boundsArea
+    = static_cast<uint64_t>(mBounds.mWidth) * mBounds.mHeight;
+  if (this->GetArea() * 4 >= boundsArea * 3) {
+    this->AddAll();
+  }
+}
+
+void DirtyRegion::Erase(std::size_t index) noexcept {
+  mRects[index] = mRects[mCount - 1];
+  --mCount;
+}
+
+void DirtyRegion::MergeAdjacent() noexcept {
+  // Merging can make a rect that should be merged with one we've already
+  // checked, so keep going until we reach a fixed point. `mCount` is tiny, so
+  // the quadratic-ish loop is cheaper than anything clever.
+  bool merged = true;
+  while (merged) {
+    merged = false;
+    for (std::size_t i = 0; i < mCount && !merged; ++i) {
+      for (std::size_t j = i + 1; j < mCount; ++j) {
+        if (!ShouldMerge(mRects[i], mRects[j])) {
+          continue;
+        }
+        mRects[i] = Union(mRects[i], mRects[j]);
+        this->Erase(j);
+        merged = true;
+        break;
+      }
+    }
+  }
+}
+
+void DirtyRegion::MergeCheapestPair() noexcept {
+  std::size_t bestI = 0;
+  std::size_t bestJ = 1;
+  auto bestCost = std::numeric_limits<int64_t>::max();
+  for (std::size_t i = 0; i < mCount; ++i) {
+    for (std::size_t j = i + 1; j < mCount; ++j) {
+      const auto cost = MergeCost(mRects[i], mRects[j]);
+      if (cost < bestCost) {
+        bestCost = cost;
+        bestI = i;
+        bestJ = j;
+      }
+    }
+  }
+  mRects[bestI] = Union(mRects[bestI], mRects[bestJ]);
+  this->Erase(bestJ);
+  this->MergeAdjacent();
+}
+
+}// namespace OpenKneeboard
@@ -7,6 +7,7 @@
 #include <OpenKneeboard/Filesystem.hpp>
 #include <OpenKneeboard/LazyOnceValue.hpp>
 #include <OpenKneeboard/StateMachine.hpp>
+#include <OpenKneeboard/Win32.hpp>
 
 #include <OpenKneeboard/dprint.hpp>
 #include <OpenKneeboard/format/filesystem.hpp>
@@ -350,4 +351,72 @@ TemporaryCopy::TemporaryCopy(
 TemporaryCopy::~TemporaryCopy() noexcept { std::filesystem::remove(mCopy); }
 
 std::filesystem::path TemporaryCopy::GetPath() const noexcept { return mCopy; }
+
+struct MappedFile::Impl {
+  winrt::file_handle mFile;
+  winrt::handle mMapping;
+  const char* mView {nullptr};
+  std::size_t mSize {};
+
+  ~Impl() {
+    if (mView) {
+      UnmapViewOfFile(mView);
+    }
+  }
+};
+
+std::unique_ptr<MappedFile> MappedFile::Open(
+  const std::filesystem::path& path) {
+  auto p = std::make_unique<Impl>();
+  p->mFile = Win32::or_default::CreateFile(
+    path.c_str(),
+    GENERIC_READ,
+    // No FILE_SHARE_WRITE: views must not change underneath readers
+    FILE_SHARE_READ | FILE_SHARE_DELETE,
+    nullptr,
+    OPEN_EXISTING,
+    FILE_ATTRIBUTE_NORMAL,
+    NULL);
+  if (!p->mFile) {
+    dprint("Failed to open `{}` for mapping", path);
+    return nullptr;
+  }
+
+  LARGE_INTEGER size {};
+  if (!GetFileSizeEx(p->mFile.get(), &size)) {
+    dprint("Failed to get size of `{}`", path);
+    return nullptr;
+  }
+  p->mSize = static_cast<std::size_t>(size.QuadPart);
+  if (p->mSize == 0) {
+    // Empty files can't be mapped
+    return std::unique_ptr<MappedFile> {new MappedFile(std::move(p))};
+  }
+
+  p->mMapping = Win32::or_default::CreateFileMapping(
+    p->mFile.get(), nullptr, PAGE_READONLY, 0, 0);
+  if (!p->mMapping) {
+    dprint("Failed to create file mapping of `{}`", path);
+    return nullptr;
+  }
+  p->mView = static_cast<const char*>(
+    MapViewOfFile(p->mMapping.get(), FILE_MAP_READ, 0, 0, 0));
+  if (!p->mView) {
+    dprint("Failed to map view of `{}`", path);
+    return nullptr;
+  }
+
+  return std::unique_ptr<MappedFile> {new MappedFile(std::move(p))};
+}
+
+MappedFile::MappedFile(std::unique_ptr<Impl> impl) : p(std::move(impl)) {}
+
+MappedFile::~MappedFile() noexcept = default;
+
+std::string_view MappedFile::GetContent() const noexcept {
+  if (!p->mView) {
+    return {};
+  }
+  return {p->mView, p->mSize};
+}
 };// namespace OpenKneeboard::Filesystem
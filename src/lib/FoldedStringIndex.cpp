@@ -0,0 +1,78 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/FoldedStringIndex.hpp>
+
+#include <OpenKneeboard/utf8.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <ranges>
+
+namespace OpenKneeboard {
+
+FoldedStringIndex::EntryIndex FoldedStringIndex::Add(
+  std::initializer_list<std::string_view> fields) {
+  Entry entry;
+  for (const auto field: fields) {
+    if (!entry.mFolded.empty()) {
+      entry.mFolded += '\0';
+    }
+    entry.mFolded += fold_utf8(field, mFoldBuffer);
+  }
+  mEntries.push_back(std::move(entry));
+  mLastQuery.reset();
+  return mEntries.size() - 1;
+}
+
+void FoldedStringIndex::Clear() {
+  mEntries.clear();
+  mLastQuery.reset();
+  mMatches.clear();
+}
+
+std::size_t FoldedStringIndex::GetEntryCount() const {
+  return mEntries.size();
+}
+
+void FoldedStringIndex::ResetMatches() {
+  mMatches.resize(mEntries.size());
+  std::iota(mMatches.begin(), mMatches.end(), EntryIndex {0});
+}
+
+std::span<const FoldedStringIndex::EntryIndex> FoldedStringIndex::Filter(
+  const std::string_view query) {
+  const auto folded = fold_utf8(query, mFoldBuffer);
+  if (mLastQuery && folded == *mLastQuery) {
+    return mMatches;
+  }
+
+  // Words before the last space of the previous query are unchanged, and
+  // all current matches contain them
+  auto remaining = folded;
+  if (mLastQuery && folded.starts_with(*mLastQuery)) {
+    if (const auto lastSpace = mLastQuery->rfind(' ');
+        lastSpace != std::string::npos) {
+      remaining.remove_prefix(lastSpace + 1);
+    }
+  } else {
+    this->ResetMatches();
+  }
+
+  auto words = remaining | std::views::split(' ')
+    | std::views::transform([](auto&& word) {
+                       return std::string_view {word.begin(), word.end()};
+                     })
+    | std::views::filter([](const auto word) { return !word.empty(); });
+  std::erase_if(mMatches, [&](const EntryIndex index) {
+    const std::string_view haystack {mEntries.at(index).mFolded};
+    return !std::ranges::all_of(words, [haystack](const auto word) {
+      return haystack.contains(word);
+    });
+  });
+
+  mLastQuery = std::string {folded};
+  return mMatches;
+}
+
+}// namespace OpenKneeboard
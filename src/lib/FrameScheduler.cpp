@@ -0,0 +1,219 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/FrameScheduler.hpp>
+
+#include <algorithm>
+#include <utility>
+
+namespace OpenKneeboard {
+
+FrameScheduler::FrameScheduler() : FrameScheduler(Options {}) {}
+
+FrameScheduler::FrameScheduler(const Options& options) : mOptions(options) {}
+
+void FrameScheduler::ObserveConsumerFrame(
+  ConsumerID id,
+  TimePoint frameTime) {
+  if (frameTime == TimePoint {}) {
+    return;
+  }
+  auto& consumer = mConsumers[id];
+  if (frameTime <= consumer.mLastFrame) {
+    return;
+  }
+
+  const auto previous = std::exchange(consumer.mLastFrame, frameTime);
+  if (previous == TimePoint {}) {
+    return;
+  }
+
+  const auto interval = frameTime - previous;
+  if (interval > mOptions.mMaxConsumerPeriod) {
+    // Paused, e.g. a loading screen; the phase is still useful, but the
+    // cadence may have changed
+    consumer.mIntervalCount = 0;
+    consumer.mNextInterval = 0;
+    consumer.mPeriod = {};
+    return;
+  }
+
+  consumer.mIntervals[consumer.mNextInterval] = interval;
+  consumer.mNextInterval = (consumer.mNextInterval + 1) % MaxIntervalSamples;
+  consumer.mIntervalCount
+    = std::min(consumer.mIntervalCount + 1, MaxIntervalSamples);
+  consumer.mPeriod = EstimatePeriod(consumer);
+}
+
+std::optional<FrameScheduler::Duration> FrameScheduler::EstimatePeriod(
+  const Consumer& consumer) {
+  if (consumer.mIntervalCount < MinIntervalSamples) {
+    return std::nullopt;
+  }
+  const auto begin = consumer.mIntervals.begin();
+  const auto end = begin + consumer.mIntervalCount;
+
+  // We only see the latest frame time when we wake, so intervals are often
+  // multiples of the period. Use the previous estimate as the unit, unless
+  // the consumer has clearly sped up; otherwise, the shortest interval is
+  // our best first guess...
+  const auto shortest = *std::min_element(begin, end);
+  if (shortest <= Duration::zero()) {
+    return std::nullopt;
+  }
+  auto unit = shortest;
+  if (consumer.mPeriod && shortest > (*consumer.mPeriod * 3) / 4) {
+    unit = *consumer.mPeriod;
+  }
+
+  // ... then average out jitter, taking multiples into account
+  Duration sum {};
+  int64_t frames = 0;
+  for (auto it = begin; it != end; ++it) {
+    const auto multiple = std::max<int64_t>(
+      1, (it->count() + (unit.count() / 2)) / unit.count());
+    sum += *it;
+    frames += multiple;
+  }
+  return sum / frames;
+}
+
+void FrameScheduler::SetFreeRunningConsumerActive(bool active) {
+  mFreeRunningConsumerActive = active;
+}
+
+void FrameScheduler::ObserveRenderDuration(Duration duration) {
+  // Grow immediately, shrink slowly: rendering late is worse than waking
+  // slightly early
+  if (duration > mRenderEstimate) {
+    mRenderEstimate = duration;
+    return;
+  }
+  mRenderEstimate = ((mRenderEstimate * 15) + duration) / 16;
+}
+
+std::optional<FrameScheduler::TimePoint> FrameScheduler::NotifyRepaintNeeded(
+  TimePoint now) {
+  mLatestDemand = std::max(mLatestDemand.value_or(now), now);
+  if (!this->HasActiveConsumer(now)) {
+    return std::nullopt;
+  }
+
+  const auto plan = this->GetPlan(now, /* busy = */ true);
+  if (plan.mWake >= mScheduledWake) {
+    return std::nullopt;
+  }
+  mScheduledWake = plan.mWake;
+  mScheduledTargetFrame = plan.mTargetFrame;
+  return plan.mWake;
+}
+
+bool FrameScheduler::IsActive(const Consumer& consumer, TimePoint now) const {
+  return consumer.mLastFrame != TimePoint {}
+    && (now - consumer.mLastFrame) < mOptions.mConsumerTimeout;
+}
+
+bool FrameScheduler::IsBusy(TimePoint now) const {
+  return mLatestDemand && (now - *mLatestDemand) < mOptions.mBusyWindow;
+}
+
+bool FrameScheduler::HasActiveConsumer(TimePoint now) const {
+  if (mFreeRunningConsumerActive) {
+    return true;
+  }
+  return std::ranges::any_of(mConsumers, [this, now](const auto& it) {
+    return this->IsActive(it.second, now);
+  });
+}
+
+bool FrameScheduler::IsLearning(TimePoint now) const {
+  // Consumers that render sporadically never get an interval sample, so
+  // don't keep us sampling quickly
+  return std::ranges::any_of(mConsumers, [this, now](const auto& it) {
+    const auto& consumer = it.second;
+    return consumer.mIntervalCount > 0 && !consumer.mPeriod
+      && (now - consumer.mLastFrame) < mOptions.mMaxConsumerPeriod;
+  });
+}
+
+std::optional<FrameScheduler::Pacing> FrameScheduler::GetPacing(
+  TimePoint now) const {
+  std::optional<Pacing> ret;
+  for (auto&& [id, consumer]: mConsumers) {
+    if (!(consumer.mPeriod && this->IsActive(consumer, now))) {
+      continue;
+    }
+    const auto period
+      = std::max(*consumer.mPeriod, mOptions.mMinConsumerPeriod);
+    if (ret && ret->mPeriod <= period) {
+      continue;
+    }
+    ret = Pacing {consumer.mLastFrame, period};
+  }
+  return ret;
+}
+
+FrameScheduler::Plan FrameScheduler::GetPlan(TimePoint now, bool busy) const {
+  if (!this->HasActiveConsumer(now)) {
+    return {now + mOptions.mIdlePeriod};
+  }
+
+  if (this->IsLearning(now)) {
+    // Sample quickly so that the shortest interval we see is a single frame
+    return {now + mOptions.mMinConsumerPeriod};
+  }
+
+  const auto pacing = this->GetPacing(now);
+  if (!pacing) {
+    return {now + (busy ? mOptions.mDefaultPeriod : mOptions.mQuietPeriod)};
+  }
+
+  const auto [lastFrame, period] = *pacing;
+  // Never lead by more than half a frame: if rendering is that slow, there's
+  // no good phase, and we'd rather not skip every other frame
+  const auto lead
+    = std::min<Duration>(mRenderEstimate + mOptions.mRenderMargin, period / 2);
+
+  // We want the first predicted consumer frame that we can still render for,
+  // that we haven't already rendered for.
+  auto earliestFrame = now + lead;
+  if (!busy && mOptions.mQuietPeriod > period) {
+    earliestFrame += mOptions.mQuietPeriod - period;
+  }
+  if (mLatestTargetFrame) {
+    earliestFrame = std::max(earliestFrame, *mLatestTargetFrame + (period / 2));
+  }
+
+  const auto frames
+    = std::max<int64_t>(1, ((earliestFrame - lastFrame) / period) + 1);
+  const auto targetFrame = lastFrame + (frames * period);
+  return {targetFrame - lead, targetFrame};
+}
+
+FrameScheduler::TimePoint FrameScheduler::ScheduleNextWake(TimePoint now) {
+  if (mScheduledTargetFrame && now >= mScheduledWake) {
+    // We're handling the frame we planned for last time; don't plan for it
+    // again
+    mLatestTargetFrame = mScheduledTargetFrame;
+  }
+
+  const auto plan = this->GetPlan(now, this->IsBusy(now));
+  mScheduledWake = plan.mWake;
+  mScheduledTargetFrame = plan.mTargetFrame;
+  return plan.mWake;
+}
+
+FrameScheduler::TimePoint FrameScheduler::GetScheduledWake() const {
+  return mScheduledWake;
+}
+
+std::optional<FrameScheduler::Duration> FrameScheduler::GetConsumerPeriod(
+  ConsumerID id) const {
+  const auto it = mConsumers.find(id);
+  if (it == mConsumers.end()) {
+    return std::nullopt;
+  }
+  return it->second.mPeriod;
+}
+
+}// namespace OpenKneeboard
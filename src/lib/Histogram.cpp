@@ -0,0 +1,63 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/Histogram.hpp>
+
+#include <algorithm>
+
+namespace OpenKneeboard {
+
+Histogram::Summary Histogram::GetSummary() const noexcept {
+  // Take a copy so that the count and percentiles are consistent with each
+  // other, even if other threads are recording
+  std::array<uint32_t, BucketCount> buckets {};
+  uint64_t count = 0;
+  for (std::size_t i = 0; i < BucketCount; ++i) {
+    buckets[i] = mBuckets[i].load(std::memory_order_relaxed);
+    count += buckets[i];
+  }
+  if (count == 0) {
+    return {};
+  }
+
+  // Min and max are updated after the buckets, so may lag behind
+  const auto minPlusOne = mMinPlusOne.load(std::memory_order_relaxed);
+  const auto min = minPlusOne ? (minPlusOne - 1) : 0;
+  const auto max = std::max(min, mMax.load(std::memory_order_relaxed));
+
+  const auto percentile = [&](uint64_t perMille) {
+    // Nearest-rank; the smallest value with at least `perMille`/1000 of the
+    // values less than or equal to it
+    const auto rank = std::max<uint64_t>(1, ((count * perMille) + 999) / 1000);
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < BucketCount; ++i) {
+      seen += buckets[i];
+      if (seen >= rank) {
+        return std::clamp(GetBucketMidpoint(i), min, max);
+      }
+    }
+    return max;
+  };
+
+  return {
+    .mCount = count,
+    .mMin = min,
+    .mMax = max,
+    .mMean = mSum.load(std::memory_order_relaxed) / count,
+    .mP50 = percentile(500),
+    .mP90 = percentile(900),
+    .mP99 = percentile(990),
+    .mP999 = percentile(999),
+  };
+}
+
+void Histogram::Reset() noexcept {
+  for (auto& bucket: mBuckets) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  mSum.store(0, std::memory_order_relaxed);
+  mMinPlusOne.store(0, std::memory_order_relaxed);
+  mMax.store(0, std::memory_order_relaxed);
+}
+
+}// namespace OpenKneeboard
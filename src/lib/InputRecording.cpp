@@ -0,0 +1,234 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/InputRecording.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <thread>
+
+namespace OpenKneeboard::InputRecording {
+
+namespace detail {
+std::atomic<bool> gRecording {false};
+}// namespace detail
+
+namespace {
+
+constexpr char FileMagic[8] {'O', 'K', 'I', 'N', 'P', 'U', 'T', '\0'};
+constexpr uint32_t FileVersion = 1;
+
+// Sanity limit for `Read()`; API events are limited by the mailslot size,
+// and OTD-IPC messages are much smaller
+constexpr uint64_t MaxPayloadSize = 1024 * 1024;
+
+using Clock = std::chrono::steady_clock;
+
+struct RecorderState {
+  std::mutex mMutex;
+  std::ofstream mFile;
+  Clock::time_point mStart {};
+  std::chrono::nanoseconds mPreviousOffset {};
+};
+
+RecorderState& GetRecorderState() {
+  // Intentionally leaked, so that late messages during shutdown are safe
+  static auto state = new RecorderState();
+  return *state;
+}
+
+// Unsigned LEB128
+void WriteVarint(std::ostream& out, uint64_t value) {
+  char buf[10];
+  std::size_t length = 0;
+  do {
+    auto byte = static_cast<uint8_t>(value & 0x7f);
+    value >>= 7;
+    if (value) {
+      byte |= 0x80;
+    }
+    buf[length++] = static_cast<char>(byte);
+  } while (value);
+  out.write(buf, static_cast<std::streamsize>(length));
+}
+
+bool ReadVarint(std::istream& in, uint64_t& value) {
+  value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    const auto c = in.get();
+    if (c == std::istream::traits_type::eof()) {
+      return false;
+    }
+    const auto byte = static_cast<uint8_t>(c);
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <class T>
+void WritePOD(std::ostream& out, const T& value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T>
+bool ReadPOD(std::istream& in, T& value) {
+  return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+}// namespace
+
+void detail::Record(Stream stream, std::string_view payload) noexcept {
+  const auto now = Clock::now();
+  auto& state = GetRecorderState();
+  const std::unique_lock lock(state.mMutex);
+  if (!state.mFile.is_open()) {
+    return;
+  }
+  // `now` may be slightly out of order with other threads' messages
+  const auto offset = std::max(
+    state.mPreviousOffset,
+    std::chrono::duration_cast<std::chrono::nanoseconds>(now - state.mStart));
+  try {
+    WriteMessage(
+      state.mFile,
+      {stream, offset, std::string {payload}},
+      state.mPreviousOffset);
+    // Flushed per message so that recordings survive crashes
+    state.mFile.flush();
+  } catch (...) {
+    // noexcept: losing a message is better than crashing the caller
+  }
+  state.mPreviousOffset = offset;
+}
+
+bool StartRecording(const std::filesystem::path& path) {
+  auto& state = GetRecorderState();
+  const std::unique_lock lock(state.mMutex);
+  state.mFile = std::ofstream {path, std::ios::binary | std::ios::trunc};
+  if (!state.mFile) {
+    state.mFile = {};
+    detail::gRecording.store(false);
+    return false;
+  }
+  WriteHeader(state.mFile);
+  state.mStart = Clock::now();
+  state.mPreviousOffset = {};
+  detail::gRecording.store(true);
+  return true;
+}
+
+void StopRecording() {
+  auto& state = GetRecorderState();
+  const std::unique_lock lock(state.mMutex);
+  detail::gRecording.store(false);
+  state.mFile = {};
+}
+
+void WriteHeader(std::ostream& out) {
+  out.write(FileMagic, sizeof(FileMagic));
+  WritePOD(out, FileVersion);
+}
+
+void WriteMessage(
+  std::ostream& out,
+  const Message& message,
+  std::chrono::nanoseconds previousOffset) {
+  WritePOD(out, message.mStream);
+  WriteVarint(
+    out,
+    static_cast<uint64_t>(
+      std::max<std::chrono::nanoseconds>(message.mOffset - previousOffset, {})
+        .count()));
+  WriteVarint(out, message.mPayload.size());
+  out.write(
+    message.mPayload.data(),
+    static_cast<std::streamsize>(message.mPayload.size()));
+}
+
+std::optional<std::vector<Message>> Read(std::istream& in) {
+  char magic[sizeof(FileMagic)] {};
+  uint32_t version {};
+  if (!in.read(magic, sizeof(magic))) {
+    return std::nullopt;
+  }
+  if (
+    std::memcmp(magic, FileMagic, sizeof(magic)) != 0
+    || !ReadPOD(in, version) || version != FileVersion) {
+    return std::nullopt;
+  }
+
+  std::vector<Message> ret;
+  std::chrono::nanoseconds offset {};
+  while (in.peek() != std::istream::traits_type::eof()) {
+    Stream stream {};
+    uint64_t delta {};
+    uint64_t size {};
+    if (!(
+          ReadPOD(in, stream) && ReadVarint(in, delta)
+          && ReadVarint(in, size))) {
+      // Truncated, e.g. by a crash while recording; keep what we have
+      break;
+    }
+    if (size > MaxPayloadSize) {
+      return std::nullopt;
+    }
+    offset += std::chrono::nanoseconds {delta};
+    Message message {stream, offset, std::string(size, '\0')};
+    if (!in.read(
+          message.mPayload.data(), static_cast<std::streamsize>(size))) {
+      break;
+    }
+    ret.push_back(std::move(message));
+  }
+  return ret;
+}
+
+std::optional<std::vector<Message>> Read(const std::filesystem::path& path) {
+  std::ifstream in {path, std::ios::binary};
+  if (!in) {
+    return std::nullopt;
+  }
+  return Read(in);
+}
+
+Player::Player(std::vector<Message> messages, double speed)
+  : mMessages(std::move(messages)), mSpeed(std::max(speed, 0.0)) {}
+
+bool Player::IsFinished() const noexcept {
+  return mNext >= mMessages.size();
+}
+
+std::chrono::nanoseconds Player::GetNextDueOffset() const {
+  if (this->IsFinished() || mSpeed == 0) {
+    return {};
+  }
+  return std::chrono::nanoseconds {static_cast<int64_t>(
+    static_cast<double>(mMessages.at(mNext).mOffset.count()) / mSpeed)};
+}
+
+Message Player::Pop() {
+  return std::move(mMessages.at(mNext++));
+}
+
+std::size_t Player::GetMessageCount() const noexcept {
+  return mMessages.size();
+}
+
+void PlayBlocking(
+  Player& player,
+  const std::function<void(const Message&)>& dispatch) {
+  const auto start = Clock::now();
+  while (!player.IsFinished()) {
+    std::this_thread::sleep_until(start + player.GetNextDueOffset());
+    dispatch(player.Pop());
+  }
+}
+
+}// namespace OpenKneeboard::InputRecording
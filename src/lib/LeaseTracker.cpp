@@ -0,0 +1,110 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/LeaseTracker.hpp>
+
+namespace OpenKneeboard {
+
+LeaseTracker::LeaseTracker(Clock::duration gracePeriod)
+  : mGracePeriod(gracePeriod) {}
+
+LeaseTracker::Acquisition LeaseTracker::Acquire(const Key& key) {
+  const auto [it, isNew] = mEntries.try_emplace(key);
+  auto& entry = it->second;
+
+  Acquisition ret {.mIsNew = isNew};
+  if (isNew) {
+    ++mStats.mMisses;
+    ++mStats.mEntryCount;
+  } else {
+    ++mStats.mHits;
+    if (entry.mIdleSince) {
+      ret.mWasIdle = true;
+      ++mStats.mIdleHits;
+      --mStats.mIdleCount;
+      entry.mIdleSince.reset();
+    }
+  }
+  ++entry.mLeases;
+  return ret;
+}
+
+bool LeaseTracker::Release(const Key& key, Clock::time_point now) {
+  const auto it = mEntries.find(key);
+  if (it == mEntries.end() || it->second.mLeases == 0) {
+    return false;
+  }
+  auto& entry = it->second;
+  if (--entry.mLeases == 0) {
+    entry.mIdleSince = now;
+    ++mStats.mIdleCount;
+  }
+  return true;
+}
+
+std::vector<LeaseTracker::Key> LeaseTracker::Expire(Clock::time_point now) {
+  std::vector<Key> ret;
+  for (auto it = mEntries.begin(); it != mEntries.end();) {
+    const auto& idleSince = it->second.mIdleSince;
+    if (!(idleSince && (now - *idleSince) >= mGracePeriod)) {
+      ++it;
+      continue;
+    }
+    ret.push_back(it->first);
+    it = mEntries.erase(it);
+    --mStats.mEntryCount;
+    --mStats.mIdleCount;
+    ++mStats.mExpirations;
+  }
+  return ret;
+}
+
+std::optional<LeaseTracker::Clock::time_point> LeaseTracker::GetNextExpiry()
+  const {
+  std::optional<Clock::time_point> ret;
+  for (const auto& [key, entry]: mEntries) {
+    if (!entry.mIdleSince) {
+      continue;
+    }
+    const auto expiry = *entry.mIdleSince + mGracePeriod;
+    if (!ret || expiry < *ret) {
+      ret = expiry;
+    }
+  }
+  return ret;
+}
+
+void LeaseTracker::Remove(const Key& key) {
+  const auto it = mEntries.find(key);
+  if (it == mEntries.end()) {
+    return;
+  }
+  if (it->second.mIdleSince) {
+    --mStats.mIdleCount;
+  }
+  --mStats.mEntryCount;
+  mEntries.erase(it);
+}
+
+std::vector<LeaseTracker::Key> LeaseTracker::Clear() {
+  std::vector<Key> ret;
+  ret.reserve(mEntries.size());
+  for (const auto& [key, entry]: mEntries) {
+    ret.push_back(key);
+  }
+  mEntries.clear();
+  mStats.mEntryCount = 0;
+  mStats.mIdleCount = 0;
+  return ret;
+}
+
+std::size_t LeaseTracker::GetLeaseCount(const Key& key) const {
+  const auto it = mEntries.find(key);
+  return (it == mEntries.end()) ? 0 : it->second.mLeases;
+}
+
+LeaseTracker::Stats LeaseTracker::GetStats() const {
+  return mStats;
+}
+
+}// namespace OpenKneeboard
@@ -0,0 +1,239 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/LogRing.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <tuple>
+
+namespace OpenKneeboard {
+
+namespace {
+
+std::string_view TruncateUTF8(std::string_view in, std::size_t maxBytes) {
+  if (in.size() <= maxBytes) {
+    return in;
+  }
+  // Don't split a multi-byte sequence: back up over continuation bytes
+  auto size = maxBytes;
+  while (size > 0 && (static_cast<uint8_t>(in[size]) & 0xC0) == 0x80) {
+    --size;
+  }
+  return in.substr(0, size);
+}
+
+template <class T>
+void PopIfFront(std::deque<T>& index, const T& value) {
+  if ((!index.empty()) && index.front() == value) {
+    index.pop_front();
+  }
+}
+
+}// namespace
+
+LogRing::LogRing() : LogRing(Limits {}) {}
+
+LogRing::LogRing(const Limits& limits) : mLimits(limits) {
+  mEntries.resize(std::max<std::size_t>(mLimits.mMaxEntries, 1));
+}
+
+LogRing::Sequence LogRing::Push(
+  Clock::time_point when,
+  uint32_t processID,
+  std::string_view executable,
+  std::string_view prefix,
+  Level level,
+  std::string_view message) {
+  const auto truncated = TruncateUTF8(
+    message, std::min(mLimits.mMaxMessageBytes, mLimits.mMaxBytes));
+
+  std::unique_lock lock(mMutex);
+  if (truncated.size() != message.size()) {
+    ++mTruncated;
+  }
+
+  while (mCount > 0
+         && (mCount == mEntries.size()
+             || mBytes + truncated.size() > mLimits.mMaxBytes)) {
+    this->DropOldest();
+  }
+
+  const auto source = this->GetOrCreateSourceID(executable, prefix);
+  const auto sequence = mNextSequence++;
+
+  auto& entry = mEntries.at((mHead + mCount) % mEntries.size());
+  entry.mSequence = sequence;
+  entry.mWhen = when;
+  entry.mProcessID = processID;
+  entry.mSource = source;
+  entry.mLevel = level;
+  // Reuses the previous entry's allocation if it's big enough
+  entry.mMessage.assign(truncated);
+  ++mCount;
+  mBytes += truncated.size();
+
+  mSourceIndex.at(source).push_back(sequence);
+  mLevelIndex.at(static_cast<std::size_t>(level)).push_back(sequence);
+
+  return sequence;
+}
+
+void LogRing::DropOldest() {
+  auto& entry = mEntries.at(mHead);
+  PopIfFront(mSourceIndex.at(entry.mSource), entry.mSequence);
+  PopIfFront(
+    mLevelIndex.at(static_cast<std::size_t>(entry.mLevel)), entry.mSequence);
+  mBytes -= entry.mMessage.size();
+  // Keep the capacity for reuse, unless it's unusually large
+  if (entry.mMessage.capacity() > 1024) {
+    entry.mMessage = {};
+  } else {
+    entry.mMessage.clear();
+  }
+  mHead = (mHead + 1) % mEntries.size();
+  --mCount;
+  ++mDropped;
+}
+
+LogRing::SourceID LogRing::GetOrCreateSourceID(
+  std::string_view executable,
+  std::string_view prefix) {
+  auto key = std::make_pair(std::string {executable}, std::string {prefix});
+  if (const auto it = mSourceIDs.find(key); it != mSourceIDs.end()) {
+    return it->second;
+  }
+  const auto id = static_cast<SourceID>(mSources.size());
+  mSources.push_back({key.first, key.second});
+  mSourceIndex.emplace_back();
+  mSourceIDs.emplace(std::move(key), id);
+  return id;
+}
+
+std::shared_lock<std::shared_timed_mutex> LogRing::TryLockShared() const {
+  std::shared_lock lock(mMutex, std::defer_lock);
+  std::ignore = lock.try_lock_for(ReadLockTimeout);
+  return lock;
+}
+
+const LogRing::Entry* LogRing::Find(Sequence sequence) const {
+  if (mCount == 0) {
+    return nullptr;
+  }
+  const auto oldest = mEntries.at(mHead).mSequence;
+  if (sequence < oldest || sequence >= oldest + mCount) {
+    return nullptr;
+  }
+  // Sequence numbers are contiguous within the ring
+  return &mEntries.at((mHead + (sequence - oldest)) % mEntries.size());
+}
+
+const std::deque<LogRing::Sequence>* LogRing::GetSmallestIndex(
+  const Filter& filter) const {
+  static const std::deque<Sequence> empty;
+
+  const std::deque<Sequence>* index = nullptr;
+  if (filter.mSource) {
+    if (*filter.mSource >= mSourceIndex.size()) {
+      return &empty;
+    }
+    index = &mSourceIndex.at(*filter.mSource);
+  }
+  if (filter.mLevel) {
+    const auto levelIndex
+      = &mLevelIndex.at(static_cast<std::size_t>(*filter.mLevel));
+    if (!index || levelIndex->size() < index->size()) {
+      index = levelIndex;
+    }
+  }
+  return index;
+}
+
+std::vector<LogRing::Entry> LogRing::GetSince(
+  Sequence after,
+  const Filter& filter) const {
+  std::vector<Entry> ret;
+  const auto lock = this->TryLockShared();
+  if (!(lock && mCount > 0)) {
+    return ret;
+  }
+
+  if (const auto index = this->GetSmallestIndex(filter)) {
+    const auto begin = std::ranges::upper_bound(*index, after);
+    ret.reserve(static_cast<std::size_t>(std::distance(begin, index->end())));
+    for (auto it = begin; it != index->end(); ++it) {
+      const auto entry = this->Find(*it);
+      if (entry && Matches(filter, *entry)) {
+        ret.push_back(*entry);
+      }
+    }
+    return ret;
+  }
+
+  const auto oldest = mEntries.at(mHead).mSequence;
+  const auto first = std::max(after + 1, oldest);
+  const auto end = oldest + mCount;
+  if (first >= end) {
+    return ret;
+  }
+  ret.reserve(static_cast<std::size_t>(end - first));
+  for (auto sequence = first; sequence < end; ++sequence) {
+    ret.push_back(*this->Find(sequence));
+  }
+  return ret;
+}
+
+std::size_t LogRing::GetCount(const Filter& filter) const {
+  const auto lock = this->TryLockShared();
+  if (!lock) {
+    return 0;
+  }
+  if (!(filter.mSource && filter.mLevel)) {
+    const auto index = this->GetSmallestIndex(filter);
+    return index ? index->size() : mCount;
+  }
+  return static_cast<std::size_t>(std::ranges::count_if(
+    *this->GetSmallestIndex(filter), [this, &filter](const auto sequence) {
+      const auto entry = this->Find(sequence);
+      return entry && Matches(filter, *entry);
+    }));
+}
+
+LogRing::Sequence LogRing::GetLatestSequence() const {
+  const auto lock = this->TryLockShared();
+  if (!lock) {
+    return 0;
+  }
+  return mNextSequence - 1;
+}
+
+std::vector<LogRing::Source> LogRing::GetSources() const {
+  const auto lock = this->TryLockShared();
+  if (!lock) {
+    return {};
+  }
+  return mSources;
+}
+
+LogRing::Source LogRing::GetSource(SourceID id) const {
+  const auto lock = this->TryLockShared();
+  if (!(lock && id < mSources.size())) {
+    return {};
+  }
+  return mSources.at(id);
+}
+
+LogRing::Statistics LogRing::GetStatistics() const {
+  const auto lock = this->TryLockShared();
+  if (!lock) {
+    return {};
+  }
+  return {
+    .mEntries = mCount,
+    .mBytes = mBytes,
+    .mDropped = mDropped,
+    .mTruncated = mTruncated,
+  };
+}
+
+}// namespace OpenKneeboard
@@ -0,0 +1,178 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/Metrics.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+
+namespace OpenKneeboard::Metrics {
+
+namespace {
+
+std::string_view GetName(const Block::Name& name) {
+  return {name.data(), strnlen(name.data(), name.size())};
+}
+
+void SetName(Block::Name& name, std::string_view value) {
+  const auto length = std::min(value.size(), Block::MaxNameLength);
+  std::ranges::copy(value.substr(0, length), name.begin());
+  name[length] = '\0';
+}
+
+template <class T>
+T* FindOrAdd(
+  std::string_view name,
+  std::atomic<uint32_t>& count,
+  auto& entries,
+  auto getValue) {
+  name = name.substr(0, Block::MaxNameLength);
+  const auto existing = count.load(std::memory_order_relaxed);
+  for (uint32_t i = 0; i < existing; ++i) {
+    if (GetName(entries[i].mName) == name) {
+      return &getValue(entries[i]);
+    }
+  }
+  if (existing >= entries.size()) {
+    return nullptr;
+  }
+  SetName(entries[existing].mName, name);
+  // Publish the name to readers in other processes
+  count.store(existing + 1, std::memory_order_release);
+  return &getValue(entries[existing]);
+}
+
+std::string FormatDuration(uint64_t ns) {
+  if (ns < 1000) {
+    return std::format("{}ns", ns);
+  }
+  if (ns < 1000 * 1000) {
+    return std::format("{:.1f}µs", ns / 1000.0);
+  }
+  return std::format("{:.2f}ms", ns / (1000.0 * 1000.0));
+}
+
+}// namespace
+
+void Block::Reset() noexcept {
+  mHistogramCount.store(0, std::memory_order_relaxed);
+  mCounterCount.store(0, std::memory_order_relaxed);
+  for (auto& it: mHistograms) {
+    it.mName = {};
+    it.mHistogram.Reset();
+  }
+  for (auto& it: mCounters) {
+    it.mName = {};
+    it.mValue.store(0, std::memory_order_relaxed);
+  }
+}
+
+Snapshot Block::GetSnapshot() const {
+  Snapshot ret;
+  const auto histogramCount = std::min<std::size_t>(
+    mHistogramCount.load(std::memory_order_acquire), MaxHistograms);
+  for (std::size_t i = 0; i < histogramCount; ++i) {
+    const auto& it = mHistograms[i];
+    ret.mHistograms.push_back({
+      .mName = std::string {GetName(it.mName)},
+      .mSummary = it.mHistogram.GetSummary(),
+    });
+  }
+
+  const auto counterCount = std::min<std::size_t>(
+    mCounterCount.load(std::memory_order_acquire), MaxCounters);
+  for (std::size_t i = 0; i < counterCount; ++i) {
+    const auto& it = mCounters[i];
+    ret.mCounters.push_back({
+      .mName = std::string {GetName(it.mName)},
+      .mValue = it.mValue.load(std::memory_order_relaxed),
+    });
+  }
+  return ret;
+}
+
+Registry& Registry::Get() {
+  // Leaked so it outlives other static destructors that might record metrics
+  static auto instance = new Registry();
+  return *instance;
+}
+
+Registry::Registry()
+  : mOwnedBlock(std::make_unique<Block>()), mBlock(mOwnedBlock.get()) {}
+
+bool Registry::SetStorage(Block* storage) {
+  std::unique_lock lock(mMutex);
+  if (mHaveRegistrations) {
+    return false;
+  }
+  mBlock = storage;
+  mOwnedBlock.reset();
+  return true;
+}
+
+Histogram* Registry::GetHistogram(std::string_view name) {
+  std::unique_lock lock(mMutex);
+  mHaveRegistrations = true;
+  return FindOrAdd<Histogram>(
+    name, mBlock->mHistogramCount, mBlock->mHistograms, [](auto& it) -> auto& {
+      return it.mHistogram;
+    });
+}
+
+Counter* Registry::GetCounter(std::string_view name) {
+  std::unique_lock lock(mMutex);
+  mHaveRegistrations = true;
+  return FindOrAdd<Counter>(
+    name, mBlock->mCounterCount, mBlock->mCounters, [](auto& it) -> auto& {
+      return it.mValue;
+    });
+}
+
+Snapshot Registry::GetSnapshot() const {
+  std::unique_lock lock(mMutex);
+  return mBlock->GetSnapshot();
+}
+
+std::string FormatSnapshot(const Snapshot& snapshot) {
+  std::string ret;
+  if (!snapshot.mHistograms.empty()) {
+    ret += std::format(
+      "{:<40} {:>8} {:>9} {:>9} {:>9} {:>9} {:>9} {:>9}\n",
+      "Timing",
+      "Count",
+      "Min",
+      "Mean",
+      "p50",
+      "p90",
+      "p99",
+      "Max");
+    for (auto&& [name, summary]: snapshot.mHistograms) {
+      ret += std::format(
+        "{:<40} {:>8} {:>9} {:>9} {:>9} {:>9} {:>9} {:>9}\n",
+        name,
+        summary.mCount,
+        FormatDuration(summary.mMin),
+        FormatDuration(summary.mMean),
+        FormatDuration(summary.mP50),
+        FormatDuration(summary.mP90),
+        FormatDuration(summary.mP99),
+        FormatDuration(summary.mMax));
+    }
+  }
+  if (!snapshot.mCounters.empty()) {
+    if (!ret.empty()) {
+      ret += "\n";
+    }
+    ret += std::format("{:<40} {:>8}\n", "Counter", "Value");
+    for (auto&& [name, value]: snapshot.mCounters) {
+      ret += std::format("{:<40} {:>8}\n", name, value);
+    }
+  }
+  if (ret.empty()) {
+    return "No metrics recorded.\n";
+  }
+  return ret;
+}
+
+}// namespace OpenKneeboard::Metrics
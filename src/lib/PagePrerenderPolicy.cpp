@@ -0,0 +1,219 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/PagePrerenderPolicy.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <ranges>
+#include <utility>
+
+namespace OpenKneeboard {
+
+PagePrerenderPolicy::PagePrerenderPolicy()
+  : PagePrerenderPolicy(Options {}) {}
+
+PagePrerenderPolicy::PagePrerenderPolicy(const Options& options)
+  : mOptions(options) {}
+
+void PagePrerenderPolicy::SetSlotBytes(std::size_t bytes) {
+  if (bytes == mSlotBytes) {
+    return;
+  }
+  mSlotBytes = bytes;
+  ++mGeneration;
+  mSlots.clear();
+  if (bytes > 0) {
+    mSlots.resize(mOptions.mBudgetBytes / bytes);
+  }
+}
+
+std::size_t PagePrerenderPolicy::GetSlotCount() const {
+  return mSlots.size();
+}
+
+PagePrerenderPolicy::Lookup PagePrerenderPolicy::ObserveForegroundRender(
+  PageKey page,
+  std::size_t pageIndex,
+  TimePoint now) {
+  mLastForeground = now;
+
+  Lookup ret;
+  if (page != mCurrentPage) {
+    if (mCurrentPage && pageIndex != mCurrentPageIndex) {
+      mDirection = (pageIndex > mCurrentPageIndex) ? 1 : -1;
+    }
+    mCurrentPage = page;
+    mCurrentPageIndex = pageIndex;
+    mLastActivity = now;
+    ret.mIsPageChange = true;
+  }
+
+  ret.mSlot = this->FindSlot(page);
+  if (ret.mSlot) {
+    mSlots.at(*ret.mSlot).mLastUsed = now;
+  }
+  if (ret.mIsPageChange) {
+    ++(ret.mSlot ? mStats.mHits : mStats.mMisses);
+  }
+  return ret;
+}
+
+void PagePrerenderPolicy::Invalidate(TimePoint now) {
+  mLastActivity = now;
+  ++mGeneration;
+  std::ranges::fill(mSlots, Slot {});
+}
+
+void PagePrerenderPolicy::Clear() {
+  ++mGeneration;
+  mSlotBytes = 0;
+  mSlots.clear();
+}
+
+bool PagePrerenderPolicy::ShouldRelease(TimePoint now) const {
+  return !mSlots.empty() && (now - mLastForeground) > mOptions.mReleaseAfter;
+}
+
+std::optional<PagePrerenderPolicy::Work> PagePrerenderPolicy::GetNextWork(
+  std::span<const PageKey> pages,
+  std::span<const PageKey> bookmarks,
+  TimePoint now,
+  TimePoint stopAt) {
+  if (mHaveWorkInProgress || mSlots.empty() || !mCurrentPage) {
+    return std::nullopt;
+  }
+  if ((now - mLastActivity) < mOptions.mQuietPeriod) {
+    return std::nullopt;
+  }
+  if (this->ShouldRelease(now)) {
+    return std::nullopt;
+  }
+  if (now + mWorkDuration.value_or(Duration::zero()) >= stopAt) {
+    return std::nullopt;
+  }
+
+  const auto wanted = this->GetWantedPages(pages, bookmarks);
+  const auto isWanted = [&wanted, this](const Slot& slot) {
+    return slot.mPage
+      && (slot.mPage == mCurrentPage
+          || std::ranges::contains(wanted, *slot.mPage));
+  };
+
+  for (const auto page: wanted) {
+    if (this->FindSlot(page)) {
+      continue;
+    }
+
+    // Prefer empty slots, then the least-recently-used unwanted slot
+    auto slot = std::ranges::find_if(
+      mSlots, [](const Slot& it) { return !it.mPage.has_value(); });
+    if (slot == mSlots.end()) {
+      for (auto it = mSlots.begin(); it != mSlots.end(); ++it) {
+        if (isWanted(*it)) {
+          continue;
+        }
+        if (slot == mSlots.end() || it->mLastUsed < slot->mLastUsed) {
+          slot = it;
+        }
+      }
+    }
+    if (slot == mSlots.end()) {
+      return std::nullopt;
+    }
+
+    *slot = {};
+    mHaveWorkInProgress = true;
+    return Work {
+      .mPage = page,
+      .mSlot = static_cast<SlotIndex>(std::distance(mSlots.begin(), slot)),
+      .mGeneration = mGeneration,
+    };
+  }
+  return std::nullopt;
+}
+
+bool PagePrerenderPolicy::CompleteWork(
+  const Work& work,
+  Duration elapsed,
+  TimePoint now) {
+  mHaveWorkInProgress = false;
+  mWorkDuration
+    = mWorkDuration ? (((*mWorkDuration) * 3) + elapsed) / 4 : elapsed;
+
+  if (work.mGeneration != mGeneration || work.mSlot >= mSlots.size()) {
+    ++mStats.mDiscarded;
+    return false;
+  }
+  mSlots.at(work.mSlot) = {work.mPage, now};
+  ++mStats.mCompleted;
+  return true;
+}
+
+PagePrerenderPolicy::Stats PagePrerenderPolicy::GetStats() const {
+  return mStats;
+}
+
+std::vector<PagePrerenderPolicy::PageKey> PagePrerenderPolicy::GetWantedPages(
+  std::span<const PageKey> pages,
+  std::span<const PageKey> bookmarks) const {
+  const auto current = std::ranges::find(pages, *mCurrentPage);
+  if (current == pages.end()) {
+    return {};
+  }
+  const auto index = std::distance(pages.begin(), current);
+  const auto pageCount = std::ssize(pages);
+
+  std::vector<PageKey> ret;
+  const auto addOffset = [&](std::ptrdiff_t offset) {
+    const auto it = index + (offset * mDirection);
+    if (it >= 0 && it < pageCount) {
+      ret.push_back(pages[it]);
+    }
+  };
+  addOffset(1);
+  addOffset(-1);
+  addOffset(2);
+
+  struct Bookmark {
+    std::size_t mDistance {};
+    PageKey mPage {};
+  };
+  std::vector<Bookmark> marked;
+  for (const auto page: bookmarks) {
+    const auto it = std::ranges::find(pages, page);
+    if (
+      it == pages.end() || it == current || std::ranges::contains(ret, page)
+      || std::ranges::contains(marked, page, &Bookmark::mPage)) {
+      continue;
+    }
+    const auto distance = std::distance(pages.begin(), it) - index;
+    marked.push_back({static_cast<std::size_t>(std::abs(distance)), page});
+  }
+  std::ranges::stable_sort(marked, {}, &Bookmark::mDistance);
+  for (const auto& [distance, page]:
+       marked | std::views::take(mOptions.mMaxBookmarks)) {
+    ret.push_back(page);
+  }
+
+  // The current page is shown directly if it isn't already in a slot, so it
+  // only needs a slot if it already has one
+  const auto slotCount
+    = mSlots.size() - (this->FindSlot(*mCurrentPage) ? 1 : 0);
+  if (ret.size() > slotCount) {
+    ret.resize(slotCount);
+  }
+  return ret;
+}
+
+std::optional<PagePrerenderPolicy::SlotIndex> PagePrerenderPolicy::FindSlot(
+  PageKey page) const {
+  const auto it = std::ranges::find(mSlots, page, &Slot::mPage);
+  if (it == mSlots.end()) {
+    return std::nullopt;
+  }
+  return static_cast<SlotIndex>(std::distance(mSlots.begin(), it));
+}
+
+}// namespace OpenKneeboard
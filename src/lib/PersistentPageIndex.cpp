@@ -0,0 +1,92 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/PersistentPageIndex.hpp>
+
+#include <shims/nlohmann/json.hpp>
+
+#include <charconv>
+#include <format>
+#include <limits>
+
+namespace OpenKneeboard {
+
+namespace {
+
+constexpr std::string_view FileHashKey {"FileHash"};
+constexpr std::string_view PageIndexKey {"PageIndex"};
+
+template <class T>
+bool ConsumeInteger(std::string_view& in, T& out) {
+  const auto [end, ec] = std::from_chars(in.data(), in.data() + in.size(), out);
+  if (ec != std::errc {}) {
+    return false;
+  }
+  in.remove_prefix(end - in.data());
+  return true;
+}
+
+bool ConsumeLiteral(std::string_view& in, std::string_view literal) {
+  if (!in.starts_with(literal)) {
+    return false;
+  }
+  in.remove_prefix(literal.size());
+  return true;
+}
+
+bool ConsumeKey(std::string_view& in, std::string_view key) {
+  return ConsumeLiteral(in, "\"") && ConsumeLiteral(in, key)
+    && ConsumeLiteral(in, "\":");
+}
+
+// Only `{"FileHash":N,"PageIndex":N}`, as written by `Serialize()`
+std::optional<PersistentPageID> ParseCanonical(std::string_view in) {
+  PersistentPageID ret;
+  if (
+    ConsumeLiteral(in, "{") && ConsumeKey(in, FileHashKey)
+    && ConsumeInteger(in, ret.mFileHash) && ConsumeLiteral(in, ",")
+    && ConsumeKey(in, PageIndexKey) && ConsumeInteger(in, ret.mPageIndex)
+    && in == "}") {
+    return ret;
+  }
+  return std::nullopt;
+}
+
+std::optional<PersistentPageID> ParseJSON(std::string_view in) {
+  const auto parsed = nlohmann::json::parse(in, nullptr, false);
+  if (!parsed.is_object()) {
+    return std::nullopt;
+  }
+  const auto hash = parsed.find(FileHashKey);
+  const auto index = parsed.find(PageIndexKey);
+  if (hash == parsed.end() || index == parsed.end()) {
+    return std::nullopt;
+  }
+  if (!(hash->is_number_unsigned() && index->is_number_unsigned())) {
+    return std::nullopt;
+  }
+  const auto pageIndex = index->get<uint64_t>();
+  if (pageIndex > std::numeric_limits<PageIndex>::max()) {
+    return std::nullopt;
+  }
+  return PersistentPageID {
+    .mFileHash = hash->get<uint64_t>(),
+    .mPageIndex = static_cast<PageIndex>(pageIndex),
+  };
+}
+
+}// namespace
+
+std::string PersistentPageID::Serialize() const {
+  return std::format(
+    R"({{"{}":{},"{}":{}}})", FileHashKey, mFileHash, PageIndexKey, mPageIndex);
+}
+
+std::optional<PersistentPageID> PersistentPageID::Parse(std::string_view in) {
+  if (auto ret = ParseCanonical(in)) {
+    return ret;
+  }
+  return ParseJSON(in);
+}
+
+}// namespace OpenKneeboard
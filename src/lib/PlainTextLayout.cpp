@@ -0,0 +1,747 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/PlainTextLayout.hpp>
+
+#include <OpenKneeboard/fatal.hpp>
+
+#include <felly/unique_ptr.hpp>
+
+#include <algorithm>
+#include <optional>
+#include <ranges>
+#include <span>
+
+#include <icu.h>
+
+namespace OpenKneeboard {
+
+namespace {
+
+using unique_UText = felly::unique_ptr<UText, &utext_close>;
+using unique_UBreakIterator = felly::unique_ptr<UBreakIterator, &ubrk_close>;
+
+using SourceReference = PlainTextLayout::SourceReference;
+
+/** Reusable ICU state for word wrapping.
+ *
+ * Opening a break iterator is far more expensive than pointing an existing
+ * one at new text, so there's one per thread rather than one per line.
+ */
+class GraphemeBreaker final {
+ public:
+  static GraphemeBreaker& Get() {
+    thread_local GraphemeBreaker instance;
+    return instance;
+  }
+
+  /// Valid until the next call on this thread
+  UBreakIterator* Reset(const std::string_view text) {
+    UErrorCode status = U_ZERO_ERROR;
+    // Passing in an existing UText re-initializes it without allocating
+    utext_openUTF8(mText.get(), text.data(), text.size(), &status);
+    ubrk_setUText(mIterator.get(), mText.get(), &status);
+    return mIterator.get();
+  }
+
+  UChar32 GetCodePointAt(const std::size_t offset) {
+    return utext_next32From(mText.get(), offset);
+  }
+
+ private:
+  GraphemeBreaker() {
+    UErrorCode status = U_ZERO_ERROR;
+    mText.reset(utext_openUTF8(nullptr, "", 0, &status));
+    mIterator.reset(ubrk_open(UBRK_CHARACTER, "", nullptr, 0, &status));
+  }
+
+  unique_UText mText;
+  unique_UBreakIterator mIterator;
+};
+
+bool IsASCII(const std::string_view text) {
+  return std::ranges::all_of(
+    text, [](const char c) { return static_cast<unsigned char>(c) < 0x80; });
+}
+
+// The ASCII characters with the Unicode White_Space property, i.e. those
+// that `u_isUWhiteSpace()` matches
+constexpr std::string_view ASCIIWhitespace {"\t\n\v\f\r "};
+
+// source is tracked separately as the content does not include trailing
+// separators, e.g.:
+// - \r\n or \n for lines
+// - \n\n for paragraphs
+// - \x1d (GROUP SEPARATOR) for groups
+// The source *should* include these separators
+struct WrappedLine {
+  std::string_view mContent;
+  SourceReference mSourceWithDelimiter;
+  SourceReference mSourceWithoutDelimiter;
+
+  operator std::string_view() const { return mContent; }
+};
+struct SourceLine {
+  std::string_view mContent {};
+  std::vector<WrappedLine> mWrappedContent {};
+  SourceReference mSourceWithDelimiter;
+  SourceReference mSourceWithoutDelimiter;
+
+  void ApplyWordWrap(const std::size_t columns) {
+    if (mContent.size() <= columns) {
+      mWrappedContent = {
+        WrappedLine {mContent, mSourceWithDelimiter, mSourceWithoutDelimiter}};
+      return;
+    }
+
+    mWrappedContent.clear();
+    // Only set up ICU if we need it; most text is entirely ASCII
+    UBreakIterator* it = nullptr;
+    std::size_t offset = 0;
+    while (offset < mContent.size()) {
+      if (mContent.size() - offset <= columns) {
+        this->PushWrapped(offset, mContent.size() - offset);
+        break;
+      }
+      // Includes the byte after the last possible break, as a combining
+      // mark there would change where the grapheme clusters end
+      if (IsASCII(mContent.substr(offset, columns + 2))) {
+        offset = this->WrapNextASCII(offset, columns);
+        continue;
+      }
+      if (!it) {
+        it = GraphemeBreaker::Get().Reset(mContent);
+      }
+      offset = this->WrapNextUnicode(it, offset, columns);
+    }
+
+    mWrappedContent.back().mSourceWithDelimiter.mLength +=
+      mSourceWithDelimiter.mLength - mSourceWithoutDelimiter.mLength;
+  }
+
+ private:
+  void PushWrapped(const std::size_t offset, const std::size_t length) {
+    const SourceReference source {
+      offset + mSourceWithDelimiter.mOffset, length};
+    mWrappedContent.emplace_back(
+      mContent.substr(offset, length), source, source);
+  }
+
+  /** Equivalent to `WrapNextUnicode()`, without ICU.
+   *
+   * Every ASCII character is a grapheme cluster by itself, except for CRLF,
+   * which can't appear within a line.
+   *
+   * Returns the offset of the next wrapped line.
+   */
+  std::size_t WrapNextASCII(
+    const std::size_t offset,
+    const std::size_t columns) {
+    // Break before the last whitespace after the first character, and skip
+    // the whitespace
+    const auto whitespace
+      = mContent.substr(offset + 1, columns).find_last_of(ASCIIWhitespace);
+    if (whitespace == std::string_view::npos) {
+      this->PushWrapped(offset, columns);
+      return offset + columns;
+    }
+    this->PushWrapped(offset, whitespace + 1);
+    return offset + whitespace + 2;
+  }
+
+  /// Returns the offset of the next wrapped line
+  std::size_t WrapNextUnicode(
+    UBreakIterator* const it,
+    const std::size_t offset,
+    const std::size_t columns) {
+    // We *know* it's a boundary, but this functions as a `seek()`
+    std::ignore = ubrk_isBoundary(it, offset);
+
+    std::size_t graphemeCount {};
+    std::optional<std::size_t> lastWhitespace {};
+    while (ubrk_next(it) != UBRK_DONE) {
+      ++graphemeCount;
+      if (graphemeCount > columns) {
+        break;
+      }
+      const auto next = ubrk_current(it);
+      const auto cp = GraphemeBreaker::Get().GetCodePointAt(next);
+      if (cp == U_SENTINEL || u_isUWhiteSpace(cp)) {
+        lastWhitespace = next;
+      }
+    }
+
+    if (graphemeCount <= columns) {
+      // Fewer graphemes than bytes; the rest fits
+      this->PushWrapped(offset, mContent.size() - offset);
+      return mContent.size();
+    }
+
+    if (!lastWhitespace) {
+      const std::size_t end = ubrk_previous(it);
+      this->PushWrapped(offset, end - offset);
+      return end;
+    }
+
+    this->PushWrapped(offset, *lastWhitespace - offset);
+    std::ignore = ubrk_isBoundary(it, *lastWhitespace);
+    return ubrk_next(it);
+  }
+};
+
+struct SourceParagraph {
+  std::vector<SourceLine> mLines {};
+  SourceReference mSourceWithDelimiter;
+  SourceReference mSourceWithoutDelimiter;
+  std::size_t mWrappedLineCount {};
+
+  void ApplyWordWrap(const std::size_t columns) {
+    mWrappedLineCount = 0;
+    for (auto&& line: mLines) {
+      line.ApplyWordWrap(columns);
+      mWrappedLineCount += line.mWrappedContent.size();
+    }
+  }
+};
+
+struct SourceGroup {
+  std::vector<SourceParagraph> mParagraphs {};
+  SourceReference mSourceWithDelimiter;
+  SourceReference mSourceWithoutDelimiter;
+
+  std::size_t mWrappedLineCount {};
+
+  void ApplyWordWrap(const std::size_t columns) {
+    mWrappedLineCount = 0;
+    for (auto&& paragraph: mParagraphs) {
+      paragraph.ApplyWordWrap(columns);
+      mWrappedLineCount += paragraph.mWrappedLineCount;
+    }
+  }
+};
+
+void PopulateSourceParagraph(
+  SourceParagraph& paragraph,
+  const std::string_view allContent) {
+  auto& lines = paragraph.mLines;
+  const auto [paraOffset, paraLength] = paragraph.mSourceWithoutDelimiter;
+
+  auto begin = paraOffset;
+  const auto end = begin + paraLength;
+  auto i = begin;
+  while (i < end) {
+    const auto remaining = allContent.substr(i);
+    if (remaining.starts_with("\n")) {
+      lines.push_back({
+        .mSourceWithDelimiter = {begin, (i - begin) + 1},
+        .mSourceWithoutDelimiter = {begin, (i - begin)},
+      });
+      i += 1;
+      begin = i;
+      continue;
+    }
+    if (remaining.starts_with("\r\n")) {
+      lines.push_back({
+        .mSourceWithDelimiter = {begin, (i - begin) + 2},
+        .mSourceWithoutDelimiter = {begin, (i - begin)},
+      });
+      i += 2;
+      begin = i;
+      continue;
+    }
+    ++i;
+  }
+  if (begin < end) {
+    lines.push_back({
+      .mSourceWithDelimiter = {begin, (end - begin)},
+      .mSourceWithoutDelimiter = {begin, (end - begin)},
+    });
+  }
+
+  if (
+    paragraph.mSourceWithoutDelimiter.mLength
+    < paragraph.mSourceWithDelimiter.mLength) {
+    OPENKNEEBOARD_ASSERT(
+      paragraph.mSourceWithoutDelimiter.mOffset
+      == paragraph.mSourceWithDelimiter.mOffset);
+    const auto offset = paragraph.mSourceWithoutDelimiter.mOffset
+      + paragraph.mSourceWithoutDelimiter.mLength;
+    const auto length = paragraph.mSourceWithDelimiter.mLength
+      - paragraph.mSourceWithoutDelimiter.mLength;
+    lines.push_back({
+      .mSourceWithDelimiter = {offset, length},
+      .mSourceWithoutDelimiter = {offset, 0},
+    });
+  }
+  if (lines.empty()) {
+    return;
+  }
+
+  for (auto&& line: lines) {
+    const auto [lineOffset, lineLength] = line.mSourceWithoutDelimiter;
+    line.mContent =
+      std::string_view {allContent}.substr(lineOffset, lineLength);
+  }
+  // The paragraph delimiter is already included in the trailing empty line
+}
+
+void PopulateSourceGroup(
+  SourceGroup& group,
+  const std::string_view allContent) {
+  auto& paragraphs = group.mParagraphs;
+  const auto [groupOffset, groupLength] = group.mSourceWithoutDelimiter;
+
+  auto begin = groupOffset;
+  const auto end = begin + groupLength;
+  auto i = begin;
+  while (i < end) {
+    const auto remaining = allContent.substr(i);
+    if (remaining.starts_with("\n\n")) {
+      paragraphs.push_back({
+        .mSourceWithDelimiter = {begin, (i - begin) + 2},
+        .mSourceWithoutDelimiter = {begin, (i - begin)},
+      });
+      i += 2;
+      begin = i;
+      continue;
+    }
+    if (remaining.starts_with("\r\n\r\n")) {
+      paragraphs.push_back({
+        .mSourceWithDelimiter = {begin, (i - begin) + 4},
+        .mSourceWithoutDelimiter = {begin, (i - begin)},
+      });
+      i += 4;
+      begin = i;
+      continue;
+    }
+    ++i;
+  }
+  if (begin < end) {
+    paragraphs.push_back({
+      .mSourceWithDelimiter = {begin, (end - begin)},
+      .mSourceWithoutDelimiter = {begin, (end - begin)},
+    });
+  }
+  if (paragraphs.empty()) {
+    return;
+  }
+
+  for (auto&& paragraph: paragraphs) {
+    PopulateSourceParagraph(paragraph, allContent);
+  }
+
+  paragraphs.back().mSourceWithDelimiter.mLength +=
+    group.mSourceWithDelimiter.mLength - group.mSourceWithoutDelimiter.mLength;
+}
+
+constexpr char GroupSeparator = '\x1d';
+
+struct ParagraphBreak {
+  std::size_t mOffset {};
+  std::size_t mLength {};
+  bool mIsGroupSeparator {false};
+};
+
+/** Find the first paragraph break or group separator starting before
+ * `limit`.
+ *
+ * This matches the order of the checks in `PopulateSourceGroup()`.
+ */
+std::optional<ParagraphBreak> FindParagraphBreak(
+  const std::string_view text,
+  const std::size_t begin,
+  const std::size_t limit) {
+  auto i = begin;
+  while (i < limit) {
+    const auto it = text.find_first_of("\n\x1d", i);
+    if (it == text.npos || it >= limit) {
+      return std::nullopt;
+    }
+    if (text[it] == GroupSeparator) {
+      return ParagraphBreak {it, 1, true};
+    }
+    if (it > begin && text.substr(it - 1).starts_with("\r\n\r\n")) {
+      return ParagraphBreak {it - 1, 4};
+    }
+    if (text.substr(it).starts_with("\n\n")) {
+      return ParagraphBreak {it, 2};
+    }
+    i = it + 1;
+  }
+  return std::nullopt;
+}
+
+}// namespace
+
+PlainTextLayout::PlainTextLayout(std::size_t columns, std::size_t rows)
+  : mColumns(columns),
+    mRows(rows) {
+  OPENKNEEBOARD_ASSERT(mRows > 1 && mColumns > 1);
+}
+
+void PlainTextLayout::Clear() {
+  this->Reset();
+  mPageBreaks.clear();
+}
+
+void PlainTextLayout::Reset() {
+  mPages.clear();
+  mOffset = 0;
+  mState = State::Group;
+  mStateDependsOnTextUntil = 0;
+  mCheckpoints.clear();
+  mAppliedPageBreaks = 0;
+}
+
+void PlainTextLayout::Invalidate(const std::size_t offset) {
+  mPageBreaks.erase(
+    std::ranges::upper_bound(mPageBreaks, offset), mPageBreaks.end());
+  mAppliedPageBreaks = std::min(mAppliedPageBreaks, mPageBreaks.size());
+
+  auto it = std::ranges::upper_bound(
+    mCheckpoints, offset, std::less {}, &Checkpoint::mOffset);
+  while (it != mCheckpoints.begin()
+         && (it - 1)->mDependsOnTextUntil > offset) {
+    --it;
+  }
+  if (it == mCheckpoints.begin()) {
+    this->Reset();
+    return;
+  }
+  const auto checkpoint = *(it - 1);
+  if (checkpoint.mOffset == mOffset) {
+    return;
+  }
+  mCheckpoints.erase(it, mCheckpoints.end());
+
+  mPages.resize(checkpoint.mPageCount);
+  if (!mPages.empty()) {
+    auto& page = mPages.back();
+    page.mLines.resize(checkpoint.mLastPageLineCount);
+    page.mSource.mLength = checkpoint.mOffset - page.mSource.mOffset;
+  }
+  mOffset = checkpoint.mOffset;
+  mState = checkpoint.mState;
+  mStateDependsOnTextUntil = checkpoint.mDependsOnTextUntil;
+  // Page breaks are applied at the start of the next unit, i.e. after the
+  // checkpoint
+  mAppliedPageBreaks = static_cast<std::size_t>(std::distance(
+    mPageBreaks.begin(),
+    std::ranges::lower_bound(mPageBreaks, checkpoint.mOffset)));
+}
+
+bool PlainTextLayout::IsComplete(std::string_view text) const {
+  return mOffset >= text.size();
+}
+
+const std::vector<PlainTextLayout::Page>& PlainTextLayout::GetPages() const {
+  return mPages;
+}
+
+void PlainTextLayout::EnsureNewPage(const std::string_view text) {
+  mPageBreaks.push_back(text.size());
+  if (this->IsComplete(text)) {
+    // Apply it now so that the new page is visible immediately
+    this->ApplyPageBreaks(text.size());
+  }
+}
+
+void PlainTextLayout::ApplyPageBreaks(const std::size_t offset) {
+  while (mAppliedPageBreaks < mPageBreaks.size()
+         && mPageBreaks[mAppliedPageBreaks] <= offset) {
+    if (!(mPages.empty() || mPages.back().mLines.empty())) {
+      this->PushPage(offset);
+    }
+    ++mAppliedPageBreaks;
+  }
+}
+
+std::size_t PlainTextLayout::GetRemainingRows() const {
+  if (mPages.empty()) {
+    return 0;
+  }
+  return mRows - mPages.back().mLines.size();
+}
+
+void PlainTextLayout::PushPage(const std::size_t offset) {
+  mPages.push_back({.mSource = {offset, 0}});
+}
+
+template <class T>
+void PlainTextLayout::AppendLines(T&& sourceLines) {
+  if (std::ranges::empty(sourceLines)) {
+    return;
+  }
+  auto& page = mPages.back();
+  const SourceLine* last = nullptr;
+  for (const SourceLine& line: sourceLines) {
+    for (const auto& wrapped: line.mWrappedContent) {
+      page.mLines.push_back({
+        wrapped.mSourceWithoutDelimiter.mOffset,
+        wrapped.mContent.size(),
+      });
+    }
+    last = &line;
+  }
+  const auto [lastStart, lastLength] = last->mSourceWithDelimiter;
+  page.mSource.mLength = (lastStart + lastLength) - page.mSource.mOffset;
+}
+
+template <class T>
+void PlainTextLayout::AppendWrappedLines(const T& wrappedLines) {
+  auto& page = mPages.back();
+  for (const auto& wrapped: wrappedLines) {
+    page.mLines.push_back({
+      wrapped.mSourceWithoutDelimiter.mOffset,
+      wrapped.mContent.size(),
+    });
+  }
+  const auto [lastStart, lastLength] = wrappedLines.back().mSourceWithDelimiter;
+  page.mSource.mLength = (lastStart + lastLength) - page.mSource.mOffset;
+}
+
+void PlainTextLayout::AddCheckpoint(const std::string_view text) {
+  if (mState == State::Group) {
+    mStateDependsOnTextUntil = mOffset;
+  }
+  if (mStateDependsOnTextUntil > text.size()) {
+    // Not enough lookahead yet; appending text may change the layout
+    return;
+  }
+  mCheckpoints.push_back({
+    .mOffset = mOffset,
+    .mState = mState,
+    .mDependsOnTextUntil = mStateDependsOnTextUntil,
+    .mPageCount = mPages.size(),
+    .mLastPageLineCount = mPages.empty() ? 0 : mPages.back().mLines.size(),
+  });
+}
+
+template <class T>
+void PlainTextLayout::LayOutParagraph(const T& paragraph) {
+  if (paragraph.mWrappedLineCount <= mRows) {
+    if (paragraph.mWrappedLineCount > this->GetRemainingRows()) {
+      this->PushPage(paragraph.mSourceWithDelimiter.mOffset);
+    }
+    this->AppendLines(paragraph.mLines);
+    return;
+  }
+
+  for (auto&& line: paragraph.mLines) {
+    this->LayOutLine(line);
+  }
+}
+
+template <class T>
+void PlainTextLayout::LayOutLine(const T& line) {
+  const auto wrappedLines = line.mWrappedContent.size();
+  if (wrappedLines <= mRows) {
+    if (wrappedLines > this->GetRemainingRows()) {
+      this->PushPage(line.mSourceWithDelimiter.mOffset);
+    }
+    this->AppendLines(std::span {&line, 1});
+    return;
+  }
+
+  auto remaining = std::span {line.mWrappedContent};
+  while (!remaining.empty()) {
+    if (this->GetRemainingRows() == 0) {
+      this->PushPage(remaining.front().mSourceWithDelimiter.mOffset);
+    }
+
+    const auto count = std::min(this->GetRemainingRows(), remaining.size());
+    this->AppendWrappedLines(remaining.first(count));
+    remaining = remaining.subspan(count);
+  }
+}
+
+std::size_t PlainTextLayout::LayOutUntil(
+  const std::string_view text,
+  const std::size_t pageCount) {
+  std::size_t consumed = 0;
+  // Layout only ever appends to the last page, so when there's another page
+  // after it, the page we want is complete
+  while (mPages.size() <= pageCount) {
+    const auto it = this->LayOutNext(text);
+    if (it == 0) {
+      break;
+    }
+    consumed += it;
+  }
+  return consumed;
+}
+
+std::size_t PlainTextLayout::LayOutNext(const std::string_view text) {
+  const auto begin = mOffset;
+  if (begin >= text.size()) {
+    return 0;
+  }
+  this->ApplyPageBreaks(begin);
+
+  if (mState == State::Group) {
+    const auto separator
+      = text.substr(begin, MaxUnitBytes).find(GroupSeparator);
+    if (separator != text.npos) {
+      this->LayOutGroup(text, begin + separator, begin + separator + 1);
+      this->AddCheckpoint(text);
+      return mOffset - begin;
+    }
+    if (text.size() - begin <= MaxUnitBytes) {
+      this->LayOutGroup(text, text.size(), text.size());
+      return mOffset - begin;
+    }
+    mState = State::Paragraph;
+    mStateDependsOnTextUntil
+      = begin + MaxUnitBytes + DelimiterLookaheadBytes;
+  }
+
+  if (mState == State::Paragraph) {
+    const auto limit = std::min(text.size(), begin + MaxUnitBytes);
+    const auto paragraphBreak = FindParagraphBreak(text, begin, limit);
+    if (paragraphBreak) {
+      const auto [offset, length, isGroupSeparator] = *paragraphBreak;
+      if (isGroupSeparator) {
+        this->LayOutParagraphs(text, offset, offset + 1);
+        mState = State::Group;
+      } else {
+        // Include the break in the 'group', so that it's treated as a
+        // paragraph break rather than a group break
+        this->LayOutParagraphs(text, offset + length, offset + length);
+      }
+      this->AddCheckpoint(text);
+      return mOffset - begin;
+    }
+    if (limit == text.size()) {
+      this->LayOutParagraphs(text, text.size(), text.size());
+      return mOffset - begin;
+    }
+    mState = State::Line;
+    mStateDependsOnTextUntil
+      = begin + MaxUnitBytes + DelimiterLookaheadBytes;
+  }
+
+  this->LayOutNextLine(text);
+  return mOffset - begin;
+}
+
+void PlainTextLayout::LayOutGroup(
+  const std::string_view text,
+  const std::size_t end,
+  const std::size_t next) {
+  const auto begin = mOffset;
+  SourceGroup group {
+    .mSourceWithDelimiter = {begin, next - begin},
+    .mSourceWithoutDelimiter = {begin, end - begin},
+  };
+  PopulateSourceGroup(group, text);
+  group.ApplyWordWrap(mColumns);
+
+  mOffset = next;
+
+  if (group.mWrappedLineCount > 0) {
+    if (group.mWrappedLineCount <= mRows) {
+      if (group.mWrappedLineCount > this->GetRemainingRows()) {
+        this->PushPage(begin);
+      }
+      this->AppendLines(
+        group.mParagraphs | std::views::transform(&SourceParagraph::mLines)
+        | std::views::join);
+    } else {
+      for (auto&& paragraph: group.mParagraphs) {
+        this->LayOutParagraph(paragraph);
+      }
+    }
+  }
+}
+
+void PlainTextLayout::LayOutParagraphs(
+  const std::string_view text,
+  const std::size_t end,
+  const std::size_t next) {
+  const auto begin = mOffset;
+  SourceGroup group {
+    .mSourceWithDelimiter = {begin, next - begin},
+    .mSourceWithoutDelimiter = {begin, end - begin},
+  };
+  PopulateSourceGroup(group, text);
+  group.ApplyWordWrap(mColumns);
+
+  mOffset = next;
+  for (auto&& paragraph: group.mParagraphs) {
+    this->LayOutParagraph(paragraph);
+  }
+}
+
+void PlainTextLayout::LayOutNextLine(const std::string_view text) {
+  // Equivalent to `PopulateSourceParagraph()`, but one line at a time
+  const auto begin = mOffset;
+  const auto layOutLine = [&, this](
+                            const SourceReference withDelimiter,
+                            const SourceReference withoutDelimiter) {
+    SourceLine line {
+      .mContent
+      = text.substr(withoutDelimiter.mOffset, withoutDelimiter.mLength),
+      .mSourceWithDelimiter = withDelimiter,
+      .mSourceWithoutDelimiter = withoutDelimiter,
+    };
+    line.ApplyWordWrap(mColumns);
+    this->LayOutLine(line);
+  };
+  const auto it = text.find_first_of("\n\x1d", begin);
+  if (it == text.npos) {
+    const SourceReference line {begin, text.size() - begin};
+    layOutLine(line, line);
+    mOffset = text.size();
+    return;
+  }
+
+  if (text[it] == GroupSeparator) {
+    if (begin < it) {
+      const SourceReference line {begin, it - begin};
+      layOutLine(line, line);
+    }
+    mOffset = it + 1;
+    mState = State::Group;
+    this->AddCheckpoint(text);
+    return;
+  }
+
+  const bool afterCR = (it > begin && text[it - 1] == '\r');
+  std::optional<ParagraphBreak> paragraphBreak;
+  if (afterCR && text.substr(it - 1).starts_with("\r\n\r\n")) {
+    paragraphBreak = {it - 1, 4};
+    if (begin < it - 1) {
+      const SourceReference line {begin, (it - 1) - begin};
+      layOutLine(line, line);
+    }
+  } else if (text.substr(it).starts_with("\n\n")) {
+    paragraphBreak = {it, 2};
+    if (afterCR) {
+      layOutLine({begin, (it + 1) - begin}, {begin, (it - 1) - begin});
+    } else if (begin < it) {
+      const SourceReference line {begin, it - begin};
+      layOutLine(line, line);
+    }
+  }
+
+  if (paragraphBreak) {
+    const auto [offset, length, isGroupSeparator] = *paragraphBreak;
+    layOutLine({offset, length}, {offset, 0});
+    mOffset = offset + length;
+    mState = State::Paragraph;
+    this->AddCheckpoint(text);
+    return;
+  }
+
+  if (afterCR) {
+    layOutLine({begin, (it + 1) - begin}, {begin, (it - 1) - begin});
+  } else {
+    layOutLine({begin, (it + 1) - begin}, {begin, it - begin});
+  }
+  mOffset = it + 1;
+  mStateDependsOnTextUntil = std::max(
+    mStateDependsOnTextUntil, mOffset + DelimiterLookaheadBytes);
+  this->AddCheckpoint(text);
+}
+
+}// namespace OpenKneeboard
@@ -0,0 +1,160 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/RepaintRequests.hpp>
+
+#include <algorithm>
+#include <format>
+
+namespace OpenKneeboard {
+
+namespace {
+
+constexpr PixelRect Union(const PixelRect& a, const PixelRect& b) noexcept {
+  const auto left = std::min(a.Left(), b.Left());
+  const auto top = std::min(a.Top(), b.Top());
+  const auto right = std::max(a.Right(), b.Right());
+  const auto bottom = std::max(a.Bottom(), b.Bottom());
+  return {{left, top}, {right - left, bottom - top}};
+}
+
+// `std::nullopt` is the whole view, so it absorbs everything
+constexpr std::optional<PixelRect> Union(
+  const std::optional<PixelRect>& a,
+  const std::optional<PixelRect>& b) noexcept {
+  if (!(a && b)) {
+    return std::nullopt;
+  }
+  return Union(*a, *b);
+}
+
+void Increment(Metrics::Counter* counter) noexcept {
+  if (counter) {
+    counter->fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+}// namespace
+
+std::string_view GetRepaintReasonName(const RepaintReason reason) noexcept {
+  switch (reason) {
+    case RepaintReason::Other:
+      return "Other";
+    case RepaintReason::Settings:
+      return "Settings";
+    case RepaintReason::ViewLayout:
+      return "ViewLayout";
+    case RepaintReason::ActiveView:
+      return "ActiveView";
+    case RepaintReason::UserAction:
+      return "UserAction";
+    case RepaintReason::Visibility:
+      return "Visibility";
+    case RepaintReason::ConsumerResize:
+      return "ConsumerResize";
+    case RepaintReason::TabContent:
+      return "TabContent";
+    case RepaintReason::UILayer:
+      return "UILayer";
+    case RepaintReason::Cursor:
+      return "Cursor";
+    case RepaintReason::AppWindow:
+      return "AppWindow";
+  }
+  return "Invalid";
+}
+
+const RepaintRequestBus::ViewRepaint* RepaintRequestBus::Frame::Find(
+  const uint64_t view) const noexcept {
+  // There's only a handful of views, so a linear search beats a map
+  const auto it = std::ranges::find(mViews, view, &ViewRepaint::mView);
+  if (it == mViews.end()) {
+    return nullptr;
+  }
+  return &*it;
+}
+
+std::optional<RepaintPriority> RepaintRequestBus::Post(
+  const RepaintRequest& request) {
+  const auto reasonBit = GetReasonBit(request.mReason);
+  const auto region
+    = (request.mRegion && *request.mRegion) ? request.mRegion : std::nullopt;
+
+  const std::unique_lock lock(mMutex);
+  auto& metrics = this->GetMetrics(request.mReason);
+  Increment(metrics.mRequests);
+
+  bool coalesced = mPending.mAllViews;
+  if (request.mView == RepaintRequest::AllViews) {
+    mPending.mAllViews = true;
+  } else {
+    auto it = std::ranges::find(
+      mPending.mViews, request.mView, &ViewRepaint::mView);
+    if (it == mPending.mViews.end()) {
+      mPending.mViews.push_back({
+        .mView = request.mView,
+        .mRegion = region,
+        .mPriority = request.mPriority,
+        .mReasons = reasonBit,
+      });
+    } else {
+      coalesced = true;
+      it->mRegion = Union(it->mRegion, region);
+      it->mPriority = std::max(it->mPriority, request.mPriority);
+      it->mReasons |= reasonBit;
+    }
+  }
+  if (coalesced) {
+    Increment(metrics.mCoalesced);
+  }
+
+  mPending.mReasons |= reasonBit;
+  if (mPending.mPriority && *mPending.mPriority >= request.mPriority) {
+    return std::nullopt;
+  }
+  mPending.mPriority = request.mPriority;
+  return request.mPriority;
+}
+
+bool RepaintRequestBus::HasPending() const {
+  const std::unique_lock lock(mMutex);
+  return !mPending.IsEmpty();
+}
+
+void RepaintRequestBus::TakeFrame(Frame& frame) {
+  auto storage = std::move(frame.mViews);
+  storage.clear();
+
+  const std::unique_lock lock(mMutex);
+  frame = std::move(mPending);
+  mPending = {};
+  mPending.mViews = std::move(storage);
+
+  for (std::size_t i = 0; i < RepaintReasonCount; ++i) {
+    const auto reason = static_cast<RepaintReason>(i);
+    if (frame.mReasons & GetReasonBit(reason)) {
+      Increment(this->GetMetrics(reason).mFrames);
+    }
+  }
+}
+
+RepaintRequestBus::ReasonMetrics& RepaintRequestBus::GetMetrics(
+  const RepaintReason reason) {
+  auto& ret = mMetrics.at(static_cast<std::size_t>(reason));
+  if (ret.mRegistered) {
+    return ret;
+  }
+  // Registered on first use, so that reasons that never happen don't take
+  // up metrics slots
+  auto& registry = Metrics::Registry::Get();
+  const auto name = GetRepaintReasonName(reason);
+  ret.mRequests
+    = registry.GetCounter(std::format("Repaint requests: {}", name));
+  ret.mCoalesced
+    = registry.GetCounter(std::format("Repaint coalesced: {}", name));
+  ret.mFrames = registry.GetCounter(std::format("Repaint frames: {}", name));
+  ret.mRegistered = true;
+  return ret;
+}
+
+}// namespace OpenKneeboard
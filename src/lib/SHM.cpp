@@ -8,6 +8,7 @@
 #include "SHM/WriterState.hpp"
 
 #include <OpenKneeboard/LazyOnceValue.hpp>
+#include <OpenKneeboard/Metrics.hpp>
 #include <OpenKneeboard/SHM.hpp>
 #include <OpenKneeboard/SHM/ActiveConsumers.hpp>
 #include <OpenKneeboard/StateMachine.hpp>
@@ -500,9 +501,9 @@ std::expected<Frame, Frame::Error> Reader::MaybeGet() {
 
   ActiveConsumers::Set(p->mConsumerKind);
 
-  const auto index = p->mHeader->mFrameNumber % SHMSwapchainLength;
-  const auto& [texture, fence] = p->mSessionResources.mFrameHandles.at(
-    p->mHeader->mFrameNumber % SHMSwapchainLength);
+  const auto frameNumber = p->mHeader->mFrameNumber;
+  const auto index = frameNumber % SHMSwapchainLength;
+  const auto& [texture, fence] = p->mSessionResources.mFrameHandles.at(index);
   if (!(texture && fence)) {
     return std::unexpected {Frame::Error::UnusableHandles};
   }
@@ -519,6 +520,7 @@ std::expected<Frame, Frame::Error> Reader::MaybeGet() {
     .mFence = fence,
     .mFenceIn = frame.mReadyReadFenceValue,
     .mIndex = static_cast<uint8_t>(index),
+    .mFrameNumber = frameNumber,
   };
 }
 
@@ -531,6 +533,7 @@ void Writer::SubmitFrame(
   if (!p) {
     throw std::logic_error("Attempted to update invalid SHM");
   }
+  OPENKNEEBOARD_MetricsScopedTimer("SHM::Writer::SubmitFrame");
 
   const auto transitions = make_scoped_state_transitions<
     State::FrameInProgress,
@@ -573,4 +576,6 @@ uint64_t Reader::GetFrameCountForMetricsOnly() const {
   return p->mHeader->mFrameNumber;
 }
 
+ConsumerKind Reader::GetConsumerKind() const { return p->mConsumerKind; }
+
 }// namespace OpenKneeboard::SHM
@@ -15,11 +15,42 @@
 #include <Windows.h>
 
 #include <algorithm>
+#include <array>
 #include <format>
 #include <string>
 
 namespace OpenKneeboard::SHM {
 
+namespace {
+
+// `ActiveConsumers` is copied out by `Get()`, so the atomics live alongside it
+// rather than inside it
+struct Segment {
+  ActiveConsumers mConsumers {};
+  std::array<ConsumerTelemetry, 5> mTelemetry {};
+};
+static_assert(std::is_standard_layout_v<Segment>);
+// `ConsumerTelemetry::FrameSample::mVisibleLayers` is a bitmask
+static_assert(MaxViewCount <= 32);
+
+constexpr std::size_t GetTelemetryIndex(const ConsumerKind kind) {
+  switch (kind) {
+    case ConsumerKind::OpenVR:
+      return 0;
+    case ConsumerKind::OpenXR_D3D11:
+      return 1;
+    case ConsumerKind::OpenXR_D3D12:
+      return 2;
+    case ConsumerKind::OpenXR_Vulkan2:
+      return 3;
+    case ConsumerKind::Viewer:
+      return 4;
+  }
+  std::unreachable();
+}
+
+}// namespace
+
 class ActiveConsumers::Impl {
  public:
   Impl() {
@@ -29,20 +60,23 @@ class ActiveConsumers::Impl {
       NULL,
       PAGE_READWRITE,
       0,
-      static_cast<DWORD>(sizeof(ActiveConsumers)),
+      static_cast<DWORD>(sizeof(Segment)),
       GetSHMPath().c_str())};
     if (!mFileHandle) {
       return;
     }
     const auto created = (GetLastError() != ERROR_ALREADY_EXISTS);
-    mView = reinterpret_cast<ActiveConsumers*>(MapViewOfFile(
-      mFileHandle.get(), FILE_MAP_WRITE, 0, 0, sizeof(ActiveConsumers)));
+    mView = reinterpret_cast<Segment*>(MapViewOfFile(
+      mFileHandle.get(), FILE_MAP_WRITE, 0, 0, sizeof(Segment)));
     if (!mView) {
       mFileHandle = {};
       return;
     }
     if (created) {
-      *mView = {};
+      mView->mConsumers = {};
+      for (auto& it: mView->mTelemetry) {
+        it.Reset();
+      }
     }
   }
 
@@ -54,7 +88,7 @@ class ActiveConsumers::Impl {
     }
   }
 
-  static ActiveConsumers* Get() {
+  static Segment* Get() {
     static Impl sImpl;
     return sImpl.mView;
   }
@@ -66,7 +100,7 @@ class ActiveConsumers::Impl {
 
  private:
   winrt::file_handle mFileHandle;
-  ActiveConsumers* mView {nullptr};
+  Segment* mView {nullptr};
   static std::wstring GetSHMPath() {
     static std::wstring sCache;
     if (!sCache.empty()) [[likely]] {
@@ -79,31 +113,36 @@ class ActiveConsumers::Impl {
       Version::Minor,
       Version::Patch,
       Version::Build,
-      sizeof(ActiveConsumers));
+      sizeof(Segment));
     return sCache;
   }
 };
 
 void ActiveConsumers::Clear() {
-  auto p = Impl::Get();
-  if (p) {
-    *p = {};
+  auto segment = Impl::Get();
+  if (!segment) {
+    return;
+  }
+  segment->mConsumers = {};
+  for (auto& it: segment->mTelemetry) {
+    it.Reset();
   }
 }
 
 ActiveConsumers ActiveConsumers::Get() {
-  auto p = Impl::Get();
-  if (p) {
-    return *p;
+  auto segment = Impl::Get();
+  if (segment) {
+    return segment->mConsumers;
   }
   return {};
 }
 
 void ActiveConsumers::Set(ConsumerKind consumer) {
-  auto p = Impl::Get();
-  if (!p) {
+  auto segment = Impl::Get();
+  if (!segment) {
     return;
   }
+  auto p = &segment->mConsumers;
 
   static bool sHaveCheckedElevation {false};
   if (!sHaveCheckedElevation) {
@@ -122,7 +161,7 @@ void ActiveConsumers::Set(ConsumerKind consumer) {
       p->mOpenXR_D3D11 = now;
       break;
     case ConsumerKind::OpenXR_D3D12:
-      p->mOpenXR_D3D11 = now;
+      p->mOpenXR_D3D12 = now;
       break;
     case ConsumerKind::OpenXR_Vulkan2:
       p->mOpenXR_Vulkan2 = now;
@@ -134,21 +173,43 @@ void ActiveConsumers::Set(ConsumerKind consumer) {
 }
 
 void ActiveConsumers::SetNonVRPixelSize(PixelSize px) {
-  auto p = Impl::Get();
-  if (!p) {
+  auto segment = Impl::Get();
+  if (!segment) {
     return;
   }
 
-  p->mNonVRPixelSize = px;
+  segment->mConsumers.mNonVRPixelSize = px;
 }
 
 void ActiveConsumers::SetActiveInGameViewID(uint64_t id) {
-  auto p = Impl::Get();
-  if (!p) {
+  auto segment = Impl::Get();
+  if (!segment) {
+    return;
+  }
+
+  segment->mConsumers.mActiveInGameViewID = id;
+}
+
+void ActiveConsumers::RecordFrame(
+  ConsumerKind consumer,
+  const ConsumerTelemetry::FrameSample& sample) {
+  auto segment = Impl::Get();
+  if (!segment) {
     return;
   }
 
-  p->mActiveInGameViewID = id;
+  segment->mTelemetry.at(GetTelemetryIndex(consumer))
+    .RecordFrame(GetCurrentProcessId(), sample);
+}
+
+std::optional<ConsumerTelemetry::Snapshot> ActiveConsumers::GetTelemetry(
+  ConsumerKind consumer) {
+  auto segment = Impl::Get();
+  if (!segment) {
+    return std::nullopt;
+  }
+
+  return segment->mTelemetry.at(GetTelemetryIndex(consumer)).GetSnapshot();
 }
 
 ActiveConsumers::T ActiveConsumers::Any() const {
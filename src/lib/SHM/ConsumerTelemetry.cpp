@@ -0,0 +1,165 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/SHM/ConsumerTelemetry.hpp>
+
+#include <algorithm>
+
+namespace OpenKneeboard::SHM {
+
+namespace {
+
+constexpr auto Relaxed = std::memory_order_relaxed;
+
+// The newest interval's weight in the moving average is 1/IntervalSmoothing
+constexpr int64_t IntervalSmoothing = 16;
+
+// Readers give up rather than spinning forever if a writer is stuck, e.g.
+// because its process crashed mid-update
+constexpr std::size_t MaxReadAttempts = 64;
+
+int64_t ToNanoseconds(ConsumerTelemetry::Clock::duration duration) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(duration)
+    .count();
+}
+
+int64_t ToNanoseconds(ConsumerTelemetry::Clock::time_point time) {
+  return ToNanoseconds(time.time_since_epoch());
+}
+
+ConsumerTelemetry::Clock::time_point FromNanoseconds(int64_t time) {
+  return ConsumerTelemetry::Clock::time_point {
+    std::chrono::duration_cast<ConsumerTelemetry::Clock::duration>(
+      std::chrono::nanoseconds {time})};
+}
+
+}// namespace
+
+bool ConsumerTelemetry::RecordFrame(
+  const uint32_t processID,
+  const FrameSample& sample) noexcept {
+  const auto startTime = ToNanoseconds(sample.mStartTime);
+
+  auto owner = mProcessID.load(std::memory_order_acquire);
+  const bool takeOver = (owner != processID);
+  if (takeOver) {
+    const auto idle = startTime - mLastFrameTime.load(Relaxed);
+    if (owner != 0 && idle < ToNanoseconds(StaleAfter)) {
+      return false;
+    }
+    if (!mProcessID.compare_exchange_strong(
+          owner, processID, std::memory_order_acq_rel)) {
+      return false;
+    }
+  }
+
+  auto sequence = mSequence.load(Relaxed);
+  if ((sequence & 1) && takeOver) {
+    // The previous owner stopped mid-update; it'll never finish
+    if (mSequence.compare_exchange_strong(sequence, sequence + 1, Relaxed)) {
+      ++sequence;
+    }
+  }
+  if (
+    (sequence & 1)
+    || !mSequence.compare_exchange_strong(sequence, sequence + 1, Relaxed)) {
+    return false;
+  }
+  // Readers that see any of the stores below must also see the odd sequence
+  std::atomic_thread_fence(std::memory_order_release);
+
+  if (takeOver) {
+    mFrameCount.store(0, Relaxed);
+    mLastFrameTime.store(0, Relaxed);
+    mFrameInterval.store(0, Relaxed);
+    mLastSHMFrameNumber.store(0, Relaxed);
+    mFetchedFrameCount.store(0, Relaxed);
+    mReusedFrameCount.store(0, Relaxed);
+    mProcessingTime.Reset();
+  }
+
+  // We're the only writer, so read-modify-write doesn't need to be atomic
+  const auto frameCount = mFrameCount.load(Relaxed);
+  if (frameCount > 0) {
+    const auto interval = startTime - mLastFrameTime.load(Relaxed);
+    if (interval > 0 && interval < ToNanoseconds(StaleAfter)) {
+      const auto average = mFrameInterval.load(Relaxed);
+      mFrameInterval.store(
+        (average == 0) ? interval
+                       : average + ((interval - average) / IntervalSmoothing),
+        Relaxed);
+    }
+  }
+
+  if (
+    frameCount == 0
+    || sample.mSHMFrameNumber != mLastSHMFrameNumber.load(Relaxed)) {
+    mFetchedFrameCount.store(mFetchedFrameCount.load(Relaxed) + 1, Relaxed);
+  } else {
+    mReusedFrameCount.store(mReusedFrameCount.load(Relaxed) + 1, Relaxed);
+  }
+
+  mFrameCount.store(frameCount + 1, Relaxed);
+  mLastFrameTime.store(startTime, Relaxed);
+  mLastSHMFrameNumber.store(sample.mSHMFrameNumber, Relaxed);
+  mVisibleLayers.store(sample.mVisibleLayers, Relaxed);
+  mVersion.store(Version, Relaxed);
+
+  mSequence.store(sequence + 2, std::memory_order_release);
+
+  const auto processingTime
+    = ToNanoseconds(sample.mEndTime - sample.mStartTime);
+  mProcessingTime.Record(
+    static_cast<uint64_t>(std::max<int64_t>(processingTime, 0)));
+  return true;
+}
+
+std::optional<ConsumerTelemetry::Snapshot> ConsumerTelemetry::GetSnapshot()
+  const noexcept {
+  for (std::size_t attempt = 0; attempt < MaxReadAttempts; ++attempt) {
+    const auto sequence = mSequence.load(std::memory_order_acquire);
+    if (sequence & 1) {
+      continue;
+    }
+
+    const auto version = mVersion.load(Relaxed);
+    Snapshot ret {
+      .mProcessID = mProcessID.load(Relaxed),
+      .mFrameCount = mFrameCount.load(Relaxed),
+      .mLastFrameTime = FromNanoseconds(mLastFrameTime.load(Relaxed)),
+      .mFrameInterval = std::chrono::nanoseconds {mFrameInterval.load(Relaxed)},
+      .mLastSHMFrameNumber = mLastSHMFrameNumber.load(Relaxed),
+      .mFetchedFrameCount = mFetchedFrameCount.load(Relaxed),
+      .mReusedFrameCount = mReusedFrameCount.load(Relaxed),
+      .mVisibleLayers = mVisibleLayers.load(Relaxed),
+    };
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (mSequence.load(Relaxed) != sequence) {
+      continue;
+    }
+
+    if (version != Version || ret.mFrameCount == 0) {
+      return std::nullopt;
+    }
+    ret.mProcessingTime = mProcessingTime.GetSummary();
+    return ret;
+  }
+  return std::nullopt;
+}
+
+void ConsumerTelemetry::Reset() noexcept {
+  mVersion.store(0, Relaxed);
+  mProcessID.store(0, Relaxed);
+  mFrameCount.store(0, Relaxed);
+  mLastFrameTime.store(0, Relaxed);
+  mFrameInterval.store(0, Relaxed);
+  mLastSHMFrameNumber.store(0, Relaxed);
+  mFetchedFrameCount.store(0, Relaxed);
+  mReusedFrameCount.store(0, Relaxed);
+  mVisibleLayers.store(0, Relaxed);
+  mProcessingTime.Reset();
+  mSequence.store(0, std::memory_order_release);
+}
+
+}// namespace OpenKneeboard::SHM
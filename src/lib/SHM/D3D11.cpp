@@ -64,6 +64,7 @@ Frame Reader::Map(SHM::Frame raw) {
     .mShaderResourceView = com.mShaderResourceView.get(),
     .mFence = com.mFence.get(),
     .mFenceIn = std::bit_cast<uint64_t>(raw.mFenceIn),
+    .mFrameNumber = raw.mFrameNumber,
   };
 }
 std::expected<Frame, Frame::Error> Reader::MaybeGetMapped() {
@@ -98,6 +98,7 @@ Frame Reader::Map(SHM::Frame raw) {
     .mShaderResourceViewGPUHandle = com.mShaderResourceViewGPUHandle,
     .mFence = com.mFence.get(),
     .mFenceIn = std::bit_cast<uint64_t>(raw.mFenceIn),
+    .mFrameNumber = raw.mFrameNumber,
   };
 }
 
@@ -0,0 +1,173 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/SHM/Metrics.hpp>
+
+#include <OpenKneeboard/config.hpp>
+#include <OpenKneeboard/dprint.hpp>
+#include <OpenKneeboard/version.hpp>
+
+#include <shims/winrt/base.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <filesystem>
+#include <format>
+
+namespace OpenKneeboard::SHM::Metrics {
+
+namespace {
+
+constexpr std::size_t MaxProcesses = 4;
+constexpr std::size_t MaxExecutableLength = 63;
+
+struct Slot {
+  std::atomic<DWORD> mProcessID {0};
+  std::array<char, MaxExecutableLength + 1> mExecutable {};
+  OpenKneeboard::Metrics::Block mBlock;
+};
+
+struct Segment {
+  std::array<Slot, MaxProcesses> mSlots;
+};
+static_assert(std::is_standard_layout_v<Segment>);
+static_assert(std::atomic<DWORD>::is_always_lock_free);
+
+class Mapping final {
+ public:
+  Mapping() {
+    mFileHandle = winrt::file_handle {CreateFileMappingW(
+      INVALID_HANDLE_VALUE,
+      NULL,
+      PAGE_READWRITE,
+      0,
+      static_cast<DWORD>(sizeof(Segment)),
+      GetSHMPath().c_str())};
+    if (!mFileHandle) {
+      return;
+    }
+    // New mappings are zero-filled, which is a valid empty `Segment`
+    mView = reinterpret_cast<Segment*>(MapViewOfFile(
+      mFileHandle.get(), FILE_MAP_WRITE, 0, 0, sizeof(Segment)));
+    if (!mView) {
+      mFileHandle = {};
+    }
+  }
+
+  // Intentionally leaked: metrics may be recorded until the process exits
+  static Segment* Get() {
+    static auto sInstance = new Mapping();
+    return sInstance->mView;
+  }
+
+  Mapping(const Mapping&) = delete;
+  Mapping(Mapping&&) = delete;
+  Mapping& operator=(const Mapping&) = delete;
+  Mapping& operator=(Mapping&&) = delete;
+
+ private:
+  winrt::file_handle mFileHandle;
+  Segment* mView {nullptr};
+
+  static std::wstring GetSHMPath() {
+    return std::format(
+      L"{}/{}.{}.{}.{}/Metrics-v{}-s{:x}",
+      ProjectReverseDomainW,
+      Version::Major,
+      Version::Minor,
+      Version::Patch,
+      Version::Build,
+      OpenKneeboard::Metrics::Block::LayoutVersion,
+      sizeof(Segment));
+  }
+};
+
+bool IsProcessAlive(DWORD processID) {
+  const winrt::handle process {
+    OpenProcess(SYNCHRONIZE, FALSE, processID)};
+  if (!process) {
+    // e.g. an elevated game, when we're not elevated
+    return GetLastError() == ERROR_ACCESS_DENIED;
+  }
+  return WaitForSingleObject(process.get(), 0) == WAIT_TIMEOUT;
+}
+
+std::string GetExecutableName() {
+  wchar_t buf[MAX_PATH];
+  const auto length = GetModuleFileNameW(nullptr, buf, MAX_PATH);
+  return winrt::to_string(
+    std::filesystem::path {std::wstring_view {buf, length}}
+      .filename()
+      .wstring());
+}
+
+}// namespace
+
+bool Publish() {
+  static std::atomic_flag sPublished;
+  if (sPublished.test()) {
+    return true;
+  }
+
+  auto segment = Mapping::Get();
+  if (!segment) {
+    dprint.Warning("Failed to map metrics shared memory");
+    return false;
+  }
+
+  const auto processID = GetCurrentProcessId();
+  for (auto& slot: segment->mSlots) {
+    auto owner = slot.mProcessID.load();
+    if (owner != 0 && owner != processID && IsProcessAlive(owner)) {
+      continue;
+    }
+    if (!slot.mProcessID.compare_exchange_strong(owner, processID)) {
+      continue;
+    }
+
+    slot.mBlock.Reset();
+    const auto executable = GetExecutableName();
+    const auto length = std::min(executable.size(), MaxExecutableLength);
+    std::ranges::copy(
+      std::string_view {executable}.substr(0, length),
+      slot.mExecutable.begin());
+    slot.mExecutable[length] = '\0';
+
+    if (!OpenKneeboard::Metrics::Registry::Get().SetStorage(&slot.mBlock)) {
+      dprint.Warning("Metrics were recorded before publishing to SHM");
+      slot.mProcessID.store(0);
+      return false;
+    }
+    sPublished.test_and_set();
+    return true;
+  }
+
+  dprint("No free metrics SHM slots");
+  return false;
+}
+
+std::vector<ProcessMetrics> GetPublished() {
+  std::vector<ProcessMetrics> ret;
+  auto segment = Mapping::Get();
+  if (!segment) {
+    return ret;
+  }
+
+  for (const auto& slot: segment->mSlots) {
+    const auto processID = slot.mProcessID.load();
+    if (processID == 0 || !IsProcessAlive(processID)) {
+      continue;
+    }
+    ret.push_back({
+      .mProcessID = processID,
+      .mExecutable = std::string {
+        slot.mExecutable.data(),
+        strnlen(slot.mExecutable.data(), slot.mExecutable.size())},
+      .mSnapshot = slot.mBlock.GetSnapshot(),
+    });
+  }
+  return ret;
+}
+
+}// namespace OpenKneeboard::SHM::Metrics
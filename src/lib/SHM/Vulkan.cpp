@@ -221,6 +221,7 @@ Frame Reader::Map(SHM::Frame raw) {
     .mDimensions = vk.mDimensions,
     .mSemaphore = vk.mSemaphore.get(),
     .mSemaphoreIn = std::bit_cast<uint64_t>(raw.mFenceIn),
+    .mFrameNumber = raw.mFrameNumber,
   };
 }
 
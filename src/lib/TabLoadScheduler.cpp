@@ -0,0 +1,93 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/TabLoadScheduler.hpp>
+
+#include <algorithm>
+
+namespace OpenKneeboard {
+
+TabLoadScheduler::TabLoadScheduler(
+  std::vector<Entry> tabs,
+  std::size_t maxConcurrency,
+  TimePoint now)
+  : mEntries(std::move(tabs)),
+    mMaxConcurrency(std::max<std::size_t>(maxConcurrency, 1)),
+    mCreatedAt(now) {}
+
+std::optional<TabLoadScheduler::Index> TabLoadScheduler::StartNext(
+  TimePoint now) {
+  if (mNextIndex >= mEntries.size() || mLoadingCount >= mMaxConcurrency) {
+    return std::nullopt;
+  }
+
+  auto& entry = mEntries.at(mNextIndex);
+  entry.mState = State::Loading;
+  entry.mStartedAt = now;
+  ++mLoadingCount;
+  return mNextIndex++;
+}
+
+void TabLoadScheduler::MarkLoaded(Index index, TimePoint now) {
+  this->Finish(index, now, State::Loaded);
+}
+
+void TabLoadScheduler::MarkFailed(
+  Index index,
+  TimePoint now,
+  std::string error) {
+  this->Finish(index, now, State::Failed).mError = std::move(error);
+}
+
+bool TabLoadScheduler::IsComplete() const {
+  return mFinishedCount == mEntries.size();
+}
+
+std::vector<TabLoadScheduler::Index> TabLoadScheduler::GetLoaded() const {
+  std::vector<Index> ret;
+  for (Index i = 0; i < mEntries.size(); ++i) {
+    if (mEntries.at(i).mState == State::Loaded) {
+      ret.push_back(i);
+    }
+  }
+  return ret;
+}
+
+std::span<const TabLoadScheduler::Entry> TabLoadScheduler::GetEntries()
+  const {
+  return mEntries;
+}
+
+std::size_t TabLoadScheduler::GetMaxConcurrency() const {
+  return mMaxConcurrency;
+}
+
+TabLoadScheduler::TimePoint TabLoadScheduler::GetCreatedAt() const {
+  return mCreatedAt;
+}
+
+std::optional<TabLoadScheduler::TimePoint> TabLoadScheduler::GetCompletedAt()
+  const {
+  if (!this->IsComplete()) {
+    return std::nullopt;
+  }
+  if (mEntries.empty()) {
+    return mCreatedAt;
+  }
+  return std::ranges::max(mEntries, {}, &Entry::mFinishedAt).mFinishedAt;
+}
+
+TabLoadScheduler::Entry&
+TabLoadScheduler::Finish(Index index, TimePoint now, State state) {
+  auto& entry = mEntries.at(index);
+  if (entry.mState != State::Loading) {
+    return entry;
+  }
+  entry.mState = state;
+  entry.mFinishedAt = now;
+  --mLoadingCount;
+  ++mFinishedCount;
+  return entry;
+}
+
+}// namespace OpenKneeboard
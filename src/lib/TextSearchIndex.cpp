@@ -0,0 +1,223 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/TextSearchIndex.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <queue>
+#include <tuple>
+
+namespace OpenKneeboard {
+
+TextSearchIndex::TokenID TextSearchIndex::GetOrAddToken(
+  std::string_view token) {
+  if (const auto it = mTokenIDs.find(token); it != mTokenIDs.end()) {
+    return it->second;
+  }
+  const auto id = static_cast<TokenID>(mTokenNames.size());
+  const std::string_view name
+    = mTokenIDs.emplace(std::string {token}, id).first->first;
+  mVocabulary.emplace(name, id);
+  mTokenNames.push_back(name);
+  mPostings.emplace_back();
+  return id;
+}
+
+void TextSearchIndex::AddLine(
+  std::size_t page,
+  std::size_t line,
+  std::span<const std::string_view> tokens) {
+  if (tokens.empty()) {
+    return;
+  }
+  mLines.push_back({
+    .mPage = page,
+    .mLine = line,
+    .mFirstOccurrence = static_cast<OccurrenceID>(mOccurrences.size()),
+  });
+  for (auto&& token: tokens) {
+    const auto id = this->GetOrAddToken(token);
+    mPostings[id].push_back(static_cast<OccurrenceID>(mOccurrences.size()));
+    mOccurrences.push_back(id);
+  }
+}
+
+void TextSearchIndex::Truncate(const Location& first) {
+  if (first == Location {}) {
+    this->Clear();
+    return;
+  }
+  const auto firstLine
+    = std::ranges::lower_bound(mLines, first, std::less {}, [](const Line& it) {
+        return Location {it.mPage, it.mLine};
+      });
+  if (firstLine == mLines.end()) {
+    return;
+  }
+  const auto firstOccurrence = firstLine->mFirstOccurrence;
+  // Postings are in document order, so removed occurrences are always at the
+  // end of each list
+  for (auto i = mOccurrences.size(); i > firstOccurrence; --i) {
+    mPostings[mOccurrences[i - 1]].pop_back();
+  }
+  mOccurrences.resize(firstOccurrence);
+  mLines.erase(firstLine, mLines.end());
+  // Keep the vocabulary: it's likely to be reused by the replacement text
+}
+
+void TextSearchIndex::Clear() {
+  mVocabulary.clear();
+  mTokenIDs.clear();
+  mTokenNames.clear();
+  mPostings.clear();
+  mOccurrences.clear();
+  mLines.clear();
+}
+
+TextSearchIndex::LineIterator TextSearchIndex::FindLine(
+  OccurrenceID occurrence,
+  LineIterator hint) const {
+  // Gallop forward to bound the search, then binary search within that
+  auto begin = hint;
+  std::ptrdiff_t step = 1;
+  while (
+    std::distance(begin, mLines.end()) > step
+    && (begin + step)->mFirstOccurrence <= occurrence) {
+    begin += step;
+    step *= 2;
+  }
+  const auto end = begin + std::min(step, std::distance(begin, mLines.end()));
+  return std::ranges::upper_bound(
+           begin, end, occurrence, std::less {}, &Line::mFirstOccurrence)
+    - 1;
+}
+
+TextSearchIndex::OccurrenceID TextSearchIndex::GetLineEnd(
+  LineIterator line) const {
+  const auto next = line + 1;
+  if (next == mLines.end()) {
+    return static_cast<OccurrenceID>(mOccurrences.size());
+  }
+  return next->mFirstOccurrence;
+}
+
+std::vector<TextSearchIndex::Location> TextSearchIndex::Find(
+  std::span<const std::string_view> terms,
+  LastTerm lastTerm,
+  std::size_t maxResults) const {
+  if (terms.empty() || maxResults == 0) {
+    return {};
+  }
+  if (terms.size() == 1 && lastTerm == LastTerm::Prefix) {
+    return this->FindPrefix(terms.front(), maxResults);
+  }
+  return this->FindPhrase(terms, lastTerm, maxResults);
+}
+
+std::vector<TextSearchIndex::Location> TextSearchIndex::FindPrefix(
+  std::string_view prefix,
+  std::size_t maxResults) const {
+  // Merge the postings of every matching token; this stops as soon as we
+  // have enough results, so short prefixes with many matches are still cheap
+  using Cursor = std::tuple<OccurrenceID, TokenID, std::size_t>;
+  std::priority_queue<Cursor, std::vector<Cursor>, std::greater<>> queue;
+  for (auto it = mVocabulary.lower_bound(prefix);
+       it != mVocabulary.end() && it->first.starts_with(prefix);
+       ++it) {
+    const auto& postings = mPostings[it->second];
+    if (!postings.empty()) {
+      queue.emplace(postings.front(), it->second, 0);
+    }
+  }
+
+  std::vector<Location> ret;
+  auto line = mLines.begin();
+  std::optional<LineIterator> previousLine;
+  while (!queue.empty()) {
+    const auto [occurrence, token, index] = queue.top();
+    queue.pop();
+
+    line = this->FindLine(occurrence, line);
+    if (line != previousLine) {
+      previousLine = line;
+      ret.push_back({line->mPage, line->mLine});
+      if (ret.size() == maxResults) {
+        break;
+      }
+    }
+
+    const auto& postings = mPostings[token];
+    if (index + 1 < postings.size()) {
+      queue.emplace(postings[index + 1], token, index + 1);
+    }
+  }
+  return ret;
+}
+
+std::vector<TextSearchIndex::Location> TextSearchIndex::FindPhrase(
+  std::span<const std::string_view> terms,
+  LastTerm lastTerm,
+  std::size_t maxResults) const {
+  const auto exactCount
+    = (lastTerm == LastTerm::Prefix) ? terms.size() - 1 : terms.size();
+
+  std::vector<TokenID> ids;
+  ids.reserve(exactCount);
+  for (std::size_t i = 0; i < exactCount; ++i) {
+    const auto it = mVocabulary.find(terms[i]);
+    if (it == mVocabulary.end()) {
+      return {};
+    }
+    ids.push_back(it->second);
+  }
+
+  // Walk the rarest term's postings, and check the neighbouring occurrences
+  const auto anchor = static_cast<std::size_t>(std::distance(
+    ids.begin(), std::ranges::min_element(ids, {}, [this](const auto id) {
+      return mPostings[id].size();
+    })));
+
+  std::vector<Location> ret;
+  auto line = mLines.begin();
+  std::optional<LineIterator> previousLine;
+  for (const auto occurrence: mPostings[ids[anchor]]) {
+    if (occurrence < anchor) {
+      continue;
+    }
+    const std::size_t first = occurrence - anchor;
+    if (first + terms.size() > mOccurrences.size()) {
+      break;
+    }
+
+    // Compare tokens first, as they're cheaper than finding the line
+    bool match = true;
+    for (std::size_t i = 0; i < exactCount && match; ++i) {
+      match = (mOccurrences[first + i] == ids[i]);
+    }
+    if (match && lastTerm == LastTerm::Prefix) {
+      match = mTokenNames[mOccurrences[first + exactCount]].starts_with(
+        terms.back());
+    }
+    if (!match) {
+      continue;
+    }
+
+    line = this->FindLine(occurrence, line);
+    if (
+      line == previousLine || first < line->mFirstOccurrence
+      || first + terms.size() > this->GetLineEnd(line)) {
+      continue;
+    }
+
+    previousLine = line;
+    ret.push_back({line->mPage, line->mLine});
+    if (ret.size() == maxResults) {
+      break;
+    }
+  }
+  return ret;
+}
+
+}// namespace OpenKneeboard
@@ -0,0 +1,128 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/TexturePoolPolicy.hpp>
+
+#include <algorithm>
+#include <iterator>
+
+namespace OpenKneeboard {
+
+namespace {
+uint32_t RoundUpToSizeClass(uint32_t value) {
+  constexpr auto granularity = TexturePoolPolicy::SizeClassGranularity;
+  return std::max<uint32_t>(
+    granularity, ((value + granularity - 1) / granularity) * granularity);
+}
+}// namespace
+
+TexturePoolPolicy::SizeClass TexturePoolPolicy::GetSizeClass(
+  uint32_t width,
+  uint32_t height) {
+  return {RoundUpToSizeClass(width), RoundUpToSizeClass(height)};
+}
+
+TexturePoolPolicy::TexturePoolPolicy(std::size_t budgetBytes)
+  : mBudget(budgetBytes) {}
+
+std::vector<TexturePoolPolicy::EntryID> TexturePoolPolicy::SetBudget(
+  std::size_t bytes) {
+  mBudget = bytes;
+  return this->EvictOverBudget({});
+}
+
+std::size_t TexturePoolPolicy::GetBudget() const {
+  return mBudget;
+}
+
+TexturePoolPolicy::Allocation TexturePoolPolicy::Allocate(
+  SizeClass sizeClass,
+  std::size_t bytes) {
+  ++mStats.mMisses;
+
+  Allocation ret;
+  const auto freeEnd = std::ranges::find(mEntries, false, &Entry::mIsFree);
+  const auto reusable = std::ranges::find(
+    mEntries.begin(), freeEnd, sizeClass, &Entry::mSizeClass);
+  if (reusable != freeEnd) {
+    ++mStats.mReuses;
+    reusable->mIsFree = false;
+    mStats.mFreeBytes -= reusable->mBytes;
+    mEntries.splice(mEntries.end(), mEntries, reusable);
+    ret.mID = reusable->mID;
+    ret.mIsReused = true;
+    return ret;
+  }
+
+  ret.mID = mNextID++;
+  mEntries.push_back({
+    .mID = ret.mID,
+    .mSizeClass = sizeClass,
+    .mBytes = bytes,
+  });
+  mEntriesByID.emplace(ret.mID, std::prev(mEntries.end()));
+  ++mStats.mEntryCount;
+  mStats.mUsedBytes += bytes;
+
+  ret.mEvicted = this->EvictOverBudget(ret.mID);
+  return ret;
+}
+
+bool TexturePoolPolicy::Touch(EntryID id) {
+  const auto it = mEntriesByID.find(id);
+  if (it == mEntriesByID.end() || it->second->mIsFree) {
+    return false;
+  }
+  ++mStats.mHits;
+  mEntries.splice(mEntries.end(), mEntries, it->second);
+  return true;
+}
+
+void TexturePoolPolicy::Release(EntryID id) {
+  const auto it = mEntriesByID.find(id);
+  if (it == mEntriesByID.end() || it->second->mIsFree) {
+    return;
+  }
+  it->second->mIsFree = true;
+  mStats.mFreeBytes += it->second->mBytes;
+  mEntries.splice(mEntries.begin(), mEntries, it->second);
+}
+
+void TexturePoolPolicy::Remove(EntryID id) {
+  const auto it = mEntriesByID.find(id);
+  if (it == mEntriesByID.end()) {
+    return;
+  }
+  const auto& entry = *it->second;
+  --mStats.mEntryCount;
+  mStats.mUsedBytes -= entry.mBytes;
+  if (entry.mIsFree) {
+    mStats.mFreeBytes -= entry.mBytes;
+  }
+  mEntries.erase(it->second);
+  mEntriesByID.erase(it);
+}
+
+TexturePoolPolicy::Stats TexturePoolPolicy::GetStats() const {
+  return mStats;
+}
+
+std::vector<TexturePoolPolicy::EntryID> TexturePoolPolicy::EvictOverBudget(
+  EntryID keep) {
+  std::vector<EntryID> ret;
+  auto it = mEntries.begin();
+  while (mStats.mUsedBytes > mBudget && it != mEntries.end()) {
+    if (it->mID == keep) {
+      ++it;
+      continue;
+    }
+    const auto id = it->mID;
+    ++it;
+    this->Remove(id);
+    ret.push_back(id);
+    ++mStats.mEvictions;
+  }
+  return ret;
+}
+
+}// namespace OpenKneeboard
@@ -0,0 +1,217 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/ThumbnailStore.hpp>
+
+#include <bit>
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <type_traits>
+
+namespace OpenKneeboard {
+
+namespace {
+
+// "OKTN"
+constexpr uint32_t Magic = 0x4e544b4f;
+// Increment on any format change; old data is discarded
+constexpr uint32_t Version = 1;
+
+static_assert(
+  std::endian::native == std::endian::little,
+  "The serialized format is little-endian");
+
+template <class T>
+void Append(std::string& out, T value) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void AppendBytes(std::string& out, const void* data, std::size_t size) {
+  Append(out, static_cast<uint32_t>(size));
+  out.append(static_cast<const char*>(data), size);
+}
+
+class Reader {
+ public:
+  explicit Reader(std::string_view data) : mData(data) {}
+
+  template <class T>
+  std::optional<T> Read() {
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (mData.size() < sizeof(T)) {
+      return std::nullopt;
+    }
+    T ret {};
+    std::memcpy(&ret, mData.data(), sizeof(T));
+    mData.remove_prefix(sizeof(T));
+    return ret;
+  }
+
+  std::optional<std::string_view> ReadBytes() {
+    const auto size = this->Read<uint32_t>();
+    if (!size || mData.size() < *size) {
+      return std::nullopt;
+    }
+    const auto ret = mData.substr(0, *size);
+    mData.remove_prefix(*size);
+    return ret;
+  }
+
+  bool IsEmpty() const {
+    return mData.empty();
+  }
+
+ private:
+  std::string_view mData;
+};
+
+}// namespace
+
+std::size_t ThumbnailStore::SlotHash::operator()(
+  const Slot& slot) const noexcept {
+  const auto size = (static_cast<uint64_t>(slot.mWidth) << 32) | slot.mHeight;
+  return std::hash<std::string> {}(slot.mPage) ^ std::hash<uint64_t> {}(size);
+}
+
+ThumbnailStore::ThumbnailStore(std::size_t budgetBytes)
+  : mBudget(budgetBytes) {}
+
+uint64_t ThumbnailStore::HashContent(std::string_view content) {
+  // FNV-1a
+  uint64_t hash = 0xcbf29ce484222325;
+  for (const auto c: content) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
+
+std::shared_ptr<const ThumbnailStore::Bytes> ThumbnailStore::Find(
+  const Key& key) {
+  const auto it = mIndex.find({key.mPage, key.mWidth, key.mHeight});
+  if (it == mIndex.end()) {
+    ++mStats.mMisses;
+    return nullptr;
+  }
+
+  const auto entry = it->second;
+  if (entry->mContentHash != key.mContentHash) {
+    ++mStats.mMisses;
+    ++mStats.mStale;
+    this->Erase(entry);
+    return nullptr;
+  }
+
+  ++mStats.mHits;
+  mEntries.splice(mEntries.end(), mEntries, entry);
+  return entry->mBytes;
+}
+
+void ThumbnailStore::Insert(Key key, Bytes bytes) {
+  Slot slot {std::move(key.mPage), key.mWidth, key.mHeight};
+  if (const auto it = mIndex.find(slot); it != mIndex.end()) {
+    this->Erase(it->second);
+  }
+
+  mStats.mBytes += bytes.size();
+  ++mStats.mEntryCount;
+  mEntries.push_back({
+    .mSlot = slot,
+    .mContentHash = key.mContentHash,
+    .mBytes = std::make_shared<const Bytes>(std::move(bytes)),
+  });
+  mIndex.emplace(std::move(slot), std::prev(mEntries.end()));
+  ++mGeneration;
+
+  this->EvictOverBudget();
+}
+
+void ThumbnailStore::Clear() {
+  mEntries.clear();
+  mIndex.clear();
+  mStats.mEntryCount = 0;
+  mStats.mBytes = 0;
+  ++mGeneration;
+}
+
+ThumbnailStore::Stats ThumbnailStore::GetStats() const {
+  return mStats;
+}
+
+uint64_t ThumbnailStore::GetGeneration() const {
+  return mGeneration;
+}
+
+std::string ThumbnailStore::Serialize() const {
+  std::string ret;
+  ret.reserve(mStats.mBytes + (mEntries.size() * 64) + 12);
+  Append(ret, Magic);
+  Append(ret, Version);
+  Append(ret, static_cast<uint32_t>(mEntries.size()));
+  // Least-recently-used first, so that the order survives a round trip
+  for (const auto& entry: mEntries) {
+    AppendBytes(ret, entry.mSlot.mPage.data(), entry.mSlot.mPage.size());
+    Append(ret, entry.mContentHash);
+    Append(ret, entry.mSlot.mWidth);
+    Append(ret, entry.mSlot.mHeight);
+    AppendBytes(ret, entry.mBytes->data(), entry.mBytes->size());
+  }
+  return ret;
+}
+
+bool ThumbnailStore::Deserialize(std::string_view data) {
+  this->Clear();
+
+  Reader reader {data};
+  if (reader.Read<uint32_t>() != Magic || reader.Read<uint32_t>() != Version) {
+    return false;
+  }
+  const auto count = reader.Read<uint32_t>();
+  if (!count) {
+    return false;
+  }
+
+  for (uint32_t i = 0; i < *count; ++i) {
+    const auto page = reader.ReadBytes();
+    const auto contentHash = reader.Read<uint64_t>();
+    const auto width = reader.Read<uint32_t>();
+    const auto height = reader.Read<uint32_t>();
+    const auto bytes = reader.ReadBytes();
+    if (!(page && contentHash && width && height && bytes)) {
+      this->Clear();
+      return false;
+    }
+
+    const auto begin = reinterpret_cast<const std::byte*>(bytes->data());
+    this->Insert(
+      {std::string {*page}, *contentHash, *width, *height},
+      Bytes {begin, begin + bytes->size()});
+  }
+
+  if (!reader.IsEmpty()) {
+    this->Clear();
+    return false;
+  }
+  // Loading doesn't count as a change that needs to be saved
+  mGeneration = 0;
+  return true;
+}
+
+void ThumbnailStore::Erase(std::list<Entry>::iterator it) {
+  mStats.mBytes -= it->mBytes->size();
+  --mStats.mEntryCount;
+  mIndex.erase(it->mSlot);
+  mEntries.erase(it);
+  ++mGeneration;
+}
+
+void ThumbnailStore::EvictOverBudget() {
+  while (mStats.mBytes > mBudget && mEntries.size() > 1) {
+    this->Erase(mEntries.begin());
+    ++mStats.mEvictions;
+  }
+}
+
+}// namespace OpenKneeboard
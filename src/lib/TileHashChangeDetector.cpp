@@ -0,0 +1,52 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/TileHashChangeDetector.hpp>
+
+#include <algorithm>
+
+namespace OpenKneeboard {
+
+void TileHashChangeDetector::Reset() {
+  mSize = {};
+  mHashes.clear();
+}
+
+DirtyRegion TileHashChangeDetector::Update(
+  std::span<const uint64_t> hashes,
+  const PixelSize& size) {
+  DirtyRegion dirty {size};
+
+  const auto grid = GetTileGrid(size);
+  const auto tileCount = static_cast<std::size_t>(grid.mWidth) * grid.mHeight;
+  if (hashes.size() != tileCount) [[unlikely]] {
+    dirty.AddAll();
+    this->Reset();
+    return dirty;
+  }
+
+  if (size != mSize || mHashes.size() != tileCount) {
+    dirty.AddAll();
+    mSize = size;
+    mHashes.assign(hashes.begin(), hashes.end());
+    return dirty;
+  }
+
+  for (uint32_t row = 0; row < grid.mHeight; ++row) {
+    for (uint32_t column = 0; column < grid.mWidth; ++column) {
+      const auto index = (static_cast<std::size_t>(row) * grid.mWidth) + column;
+      if (mHashes[index] == hashes[index]) {
+        continue;
+      }
+      dirty.Add({
+        {column * TileSize, row * TileSize},
+        {TileSize, TileSize},
+      });
+    }
+  }
+
+  std::ranges::copy(hashes, mHashes.begin());
+  return dirty;
+}
+
+}// namespace OpenKneeboard
@@ -0,0 +1,46 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include <OpenKneeboard/VROverlayChangeTracker.hpp>
+
+#include <algorithm>
+
+namespace OpenKneeboard {
+
+VROverlayChangeTracker::VROverlayChangeTracker(std::size_t layerCount)
+  : mLayers(layerCount) {}
+
+VROverlayChangeTracker::LayerUpdate VROverlayChangeTracker::Update(
+  std::size_t layerIndex,
+  const FrameID& frame,
+  const LayerContent& content,
+  const LayerPlacement& placement) {
+  auto& submitted = mLayers.at(layerIndex);
+
+  LayerUpdate ret {.mTexture = true, .mPlacement = true};
+  if (submitted) {
+    ret.mTexture
+      = (submitted->mFrame != frame) || (submitted->mContent != content);
+    ret.mPlacement = (submitted->mPlacement != placement);
+  }
+  ++(ret.mTexture ? mStats.mTextureUpdates : mStats.mSkippedTextureUpdates);
+  ++(ret.mPlacement ? mStats.mPlacementUpdates
+                    : mStats.mSkippedPlacementUpdates);
+
+  submitted = Submitted {frame, content, placement};
+  return ret;
+}
+
+void VROverlayChangeTracker::InvalidateLayer(std::size_t layerIndex) {
+  mLayers.at(layerIndex).reset();
+}
+
+void VROverlayChangeTracker::Invalidate() {
+  std::ranges::fill(mLayers, std::nullopt);
+}
+
+VROverlayChangeTracker::Stats VROverlayChangeTracker::GetStats() const {
+  return mStats;
+}
+
+}// namespace OpenKneeboard
@@ -226,8 +226,9 @@ SpriteBatch::Buffer<T> SpriteBatch::CreateBuffer(
 }
 
 void SpriteBatch::CreateVertexBuffer() {
-  mVertexBuffer = this->CreateBuffer<Vertex>(
-    VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, sizeof(Vertex) * MaxVerticesPerBatch);
+  // Per-instance data; the vertex shader expands each instance to a quad
+  mVertexBuffer = this->CreateBuffer<Instance>(
+    VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, sizeof(Instance) * MaxSpritesPerBatch);
 }
 
 void SpriteBatch::CreateUniformBuffer() {
@@ -268,13 +269,7 @@ void SpriteBatch::Draw(
     fatal(loc, "Calling Draw() without Begin()");
   }
 
-  mSprites.push_back({
-    source,
-    sourceSize,
-    sourceRect,
-    destRect,
-    color,
-  });
+  mBatch.Draw(source, sourceSize, sourceRect, destRect, color);
 }
 
 void SpriteBatch::Clear(Color color, const std::source_location& caller) {
@@ -292,92 +287,43 @@ void SpriteBatch::End(const std::source_location& loc) {
   OPENKNEEBOARD_TraceLoggingScopedActivity(
     activity,
     "Vulkan::SpriteBatch::End",
-    TraceLoggingValue(mSprites.size(), "SpriteCount"));
-  if (mSprites.empty()) {
+    TraceLoggingValue(mBatch.GetInstances().size(), "SpriteCount"));
+  if (mBatch.IsEmpty()) {
     return;
   }
 
-  UniformBuffer batchData {
-    .mTargetDimensions =
-      {mTargetDimensions.Width<float>(), mTargetDimensions.Height<float>()},
-  };
-
-  std::vector<VkImageView> sources;
-  std::unordered_map<VkImageView, uint32_t> sourceIndices;
-  std::vector<Vertex> vertices;
-  vertices.reserve(mSprites.size() * VerticesPerSprite);
-
-  for (const auto& sprite: mSprites) {
-    if (!sourceIndices.contains(sprite.mSource)) {
-      sources.push_back(sprite.mSource);
-      const auto i = sources.size() - 1;
-      sourceIndices[sprite.mSource] = i;
-
-      batchData.mSourceDimensions[i] = {
-        sprite.mSourceSize.Width<float>(),
-        sprite.mSourceSize.Height<float>(),
-      };
-
-      batchData.mSourceClamp[i] = {
-        (sprite.mSourceRect.Left<float>() + 0.5f) / sprite.mSourceSize.Width(),
-        (sprite.mSourceRect.Top<float>() + 0.5f) / sprite.mSourceSize.Height(),
-        (sprite.mSourceRect.Right<float>() - 0.5f) / sprite.mSourceSize.Width(),
-        (sprite.mSourceRect.Bottom<float>() - 0.5f)
-          / sprite.mSourceSize.Height(),
-      };
-    }
-
-    using TexCoord = std::array<float, 2>;
-
-    const TexCoord srcTL =
-      sprite.mSourceRect.TopLeft().StaticCast<float, TexCoord>();
-    const TexCoord srcBR =
-      sprite.mSourceRect.BottomRight().StaticCast<float, TexCoord>();
-    const TexCoord srcBL {srcTL[0], srcBR[1]};
-    const TexCoord srcTR {srcBR[0], srcTL[1]};
-
-    using Position = Vertex::Position;
-
-    // Destination coordinates in real 3d coordinates
-    const Position dstTL =
-      sprite.mDestRect.TopLeft().StaticCast<float, Position>();
-    const Position dstBR =
-      sprite.mDestRect.BottomRight().StaticCast<float, Position>();
-    const Position dstTR {dstBR[0], dstTL[1]};
-    const Position dstBL {dstTL[0], dstBR[1]};
-
-    auto makeVertex = [=](const TexCoord& tc, const Position& pos) {
-      return Vertex {
-        .mPosition = pos,
-        .mColor = sprite.mColor,
-        .mTexCoord = tc,
-        .mTextureIndex = sourceIndices.at(sprite.mSource),
-      };
-    };
-
-    // A rectangle is two triangles
-
-    // First triangle: excludes top right
-    vertices.push_back(makeVertex(srcBL, dstBL));
-    vertices.push_back(makeVertex(srcTL, dstTL));
-    vertices.push_back(makeVertex(srcBR, dstBR));
-
-    // Second triangle: excludes bottom left
-    vertices.push_back(makeVertex(srcTL, dstTL));
-    vertices.push_back(makeVertex(srcTR, dstTR));
-    vertices.push_back(makeVertex(srcBR, dstBR));
-  }
-
+  // Sprites sharing a source image and source rect share a descriptor
+  const auto sources = mBatch.GetSources();
   if (sources.size() > MaxSpritesPerBatch) {
     fatal(
       "OpenKneeboard's Vulkan Spritebatch only supports up to {} source "
       "imeages",
       MaxSpritesPerBatch);
   }
+  const auto instances = mBatch.GetInstances();
+  if (instances.size() > MaxSpritesPerBatch) {
+    fatal(
+      "OpenKneeboard's Vulkan Spritebatch only supports up to {} sprites",
+      MaxSpritesPerBatch);
+  }
 
-  const size_t verticesByteSize = sizeof(vertices[0]) * vertices.size();
-  memcpy(mVertexBuffer.mMapping.get(), vertices.data(), verticesByteSize);
-  memcpy(mUniformBuffer.mMapping.get(), &batchData, sizeof(batchData));
+  const auto instanceCount = static_cast<uint32_t>(instances.size());
+
+  // The buffers are persistently mapped, so if nothing changed since the last
+  // batch, they already contain what we need
+  const auto unchanged = mBatch.IsSameAsPreviousBatch();
+  if (!unchanged) {
+    memcpy(
+      mVertexBuffer.mMapping.get(),
+      instances.data(),
+      sizeof(Instance) * instances.size());
+  }
+  if (mUploadedTargetDimensions != mTargetDimensions || !unchanged) {
+    const auto batchData
+      = SpriteBatchVertices::GetUniformBuffer(mBatch, mTargetDimensions);
+    memcpy(mUniformBuffer.mMapping.get(), &batchData, sizeof(batchData));
+    mUploadedTargetDimensions = mTargetDimensions;
+  }
 
   {
     VkRenderingAttachmentInfoKHR colorAttachmentInfo {
@@ -431,7 +377,7 @@ void SpriteBatch::End(const std::source_location& loc) {
     for (const auto& source: sources) {
       sourceInfos.push_back(
         VkDescriptorImageInfo {
-          .imageView = source,
+          .imageView = source.mSource,
           .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
         });
     }
@@ -509,11 +455,11 @@ void SpriteBatch::End(const std::source_location& loc) {
     mVK->CmdClearAttachments(mCommandBuffer, 1, &clear, 1, &clearRect);
   }
 
-  mVK->CmdDraw(mCommandBuffer, vertices.size(), 1, 0, 0);
+  mVK->CmdDraw(mCommandBuffer, VerticesPerSprite, instanceCount, 0, 0);
 
   mVK->CmdEndRenderingKHR(mCommandBuffer);
 
-  mSprites.clear();
+  mBatch.EndBatch();
   mCommandBuffer = {};
   mTarget = nullptr;
   mClearColor = {};
@@ -521,33 +467,34 @@ void SpriteBatch::End(const std::source_location& loc) {
 
 VkVertexInputBindingDescription SpriteBatch::GetVertexBindingDescription() {
   return VkVertexInputBindingDescription {
-    .stride = sizeof(Vertex),
-    .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
+    .stride = sizeof(Instance),
+    .inputRate = VK_VERTEX_INPUT_RATE_INSTANCE,
   };
 }
 
 std::array<VkVertexInputAttributeDescription, 4>
 SpriteBatch::GetVertexAttributeDescription() {
+  // Locations MUST match the VK_LOCATION() annotations in SpriteBatch.hlsl
   return {
     VkVertexInputAttributeDescription {
       .location = 0,
       .format = VK_FORMAT_R32G32B32A32_SFLOAT,
-      .offset = offsetof(Vertex, mPosition),
+      .offset = offsetof(Instance, mSourceRect),
     },
     VkVertexInputAttributeDescription {
       .location = 1,
       .format = VK_FORMAT_R32G32B32A32_SFLOAT,
-      .offset = offsetof(Vertex, mColor),
+      .offset = offsetof(Instance, mDestRect),
     },
     VkVertexInputAttributeDescription {
       .location = 2,
-      .format = VK_FORMAT_R32G32_SFLOAT,
-      .offset = offsetof(Vertex, mTexCoord),
+      .format = VK_FORMAT_R32G32B32A32_SFLOAT,
+      .offset = offsetof(Instance, mColor),
     },
     VkVertexInputAttributeDescription {
       .location = 3,
       .format = VK_FORMAT_R32_UINT,
-      .offset = offsetof(Vertex, mTextureIndex),
+      .offset = offsetof(Instance, mSourceIndex),
     },
   };
 }
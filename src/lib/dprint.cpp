@@ -27,6 +27,11 @@ auto& GetHistoryProvider() {
   return sProvider;
 }
 
+auto& GetLogFileFlusher() {
+  static DebugPrinter::LogFileFlusher sFlusher;
+  return sFlusher;
+}
+
 auto& GetSettings() {
   static DPrintSettings sSettings;
   return sSettings;
@@ -50,6 +55,20 @@ std::optional<std::string> DebugPrinter::MaybeGetHistory() {
   return std::nullopt;
 }
 
+void DebugPrinter::SetLogFileFlusher(const LogFileFlusher& flusher) {
+  GetLogFileFlusher() = flusher;
+}
+
+void DebugPrinter::FlushLogFile() noexcept {
+  const auto& flusher = GetLogFileFlusher();
+  if (!flusher) {
+    return;
+  }
+  try {
+    flusher();
+  } catch (...) {}
+}
+
 static std::wstring GetDPrintResourceName(std::wstring_view key) {
   // v2: explicit size added
   // v3: compatibility for 32-bit sender and 64-bit receiver
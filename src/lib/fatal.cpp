@@ -5,6 +5,7 @@
 // This program is open source; see the LICENSE file in the root of the
 // OpenKneeboard repository.
 
+#include <OpenKneeboard/BinaryTrace.hpp>
 #include <OpenKneeboard/Elevation.hpp>
 #include <OpenKneeboard/Filesystem.hpp>
 #include <OpenKneeboard/Win32.hpp>
@@ -149,6 +150,16 @@ struct CrashMeta {
     return mMiniDumpWriteDump;
   }
 
+  std::filesystem::path GetCrashFilePath(std::wstring_view extension) {
+    return Filesystem::GetCrashLogsDirectory()
+      / std::format(
+             L"{}-crash-{:%Y%m%dT%H%M%S}-{}.{}",
+             mModulePath.stem(),
+             mNow,
+             mPID,
+             extension);
+  }
+
  private:
   inline static std::filesystem::path GetModulePath() {
     HMODULE thisModule {nullptr};
@@ -162,16 +173,6 @@ struct CrashMeta {
     return {std::wstring_view {buf, charCount}};
   }
 
-  std::filesystem::path GetCrashFilePath(std::wstring_view extension) {
-    return Filesystem::GetCrashLogsDirectory()
-      / std::format(
-             L"{}-crash-{:%Y%m%dT%H%M%S}-{}.{}",
-             mModulePath.stem(),
-             mNow,
-             mPID,
-             extension);
-  }
-
   wil::unique_hmodule mDbgHelp;
   decltype(&MiniDumpWriteDump) mMiniDumpWriteDump {nullptr};
   bool mLoadedDbgHelp {false};
@@ -410,6 +411,10 @@ OPENKNEEBOARD_NOINLINE
   CrashMeta& meta,
   const FatalData& fatal,
   LPEXCEPTION_POINTERS dumpableExceptions) {
+  // The log file is written in batches; make sure it includes everything up
+  // to the crash, as it's all we get if writing the dump fails
+  dprint.FlushLogFile();
+
   const auto logContents = GetFatalLogContents(meta, fatal);
 
   {
@@ -417,6 +422,12 @@ OPENKNEEBOARD_NOINLINE
     f << logContents;
   }
 
+  if (BinaryTrace::IsEnabled()) {
+    // Stop recording so the dump shows what led up to the crash, not us
+    BinaryTrace::Disable();
+    BinaryTrace::DumpToFile(meta.GetCrashFilePath(L"oktrace"));
+  }
+
   if (meta.CanWriteDump()) {
     auto thisProcess = Filesystem::GetCurrentExecutablePath();
 
@@ -0,0 +1,152 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <OpenKneeboard/macros.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/** Portable, low-overhead in-process trace recorder.
+ *
+ * This is a complement to TraceLogging/ETW, for when capturing a trace with
+ * WPR isn't practical (e.g. on a tester's machine), or when the trace needs
+ * to be analyzed without Windows tools.
+ *
+ * Each thread writes fixed-size records into its own ring buffer without
+ * locking; names are interned once per call site. The most recent records
+ * can be dumped to a file at any time - including from a crash handler -
+ * and decoded with the `OpenKneeboard-Trace-Decoder` utility.
+ *
+ * Recording is disabled by default; when disabled, a scope costs a single
+ * relaxed atomic load.
+ */
+namespace OpenKneeboard::BinaryTrace {
+
+using NameID = uint32_t;
+
+enum class RecordKind : uint8_t {
+  Begin = 1,
+  End = 2,
+  Instant = 3,
+};
+
+/// The on-disk record; little-endian
+struct Record {
+  uint64_t mTimestampNS {};
+  NameID mName {};
+  RecordKind mKind {};
+  uint8_t mReserved[3] {};
+};
+static_assert(sizeof(Record) == 16);
+
+constexpr std::size_t DefaultRecordsPerThread = 64 * 1024;
+
+namespace detail {
+extern std::atomic<bool> gEnabled;
+void Write(NameID, RecordKind) noexcept;
+}// namespace detail
+
+[[nodiscard]]
+inline bool IsEnabled() noexcept {
+  return detail::gEnabled.load(std::memory_order_relaxed);
+}
+
+/// Start recording; the capacity is rounded up to a power of two
+void Enable(std::size_t recordsPerThread = DefaultRecordsPerThread);
+/// Stop recording; existing records are kept until the next `Enable()`
+void Disable();
+
+/** Get a stable ID for `name`.
+ *
+ * This takes a lock; call sites should cache the result, as the macros
+ * below do.
+ */
+NameID Intern(std::string_view name);
+
+inline void Write(NameID name, RecordKind kind) noexcept {
+  if (IsEnabled()) [[unlikely]] {
+    detail::Write(name, kind);
+  }
+}
+
+/// Records a Begin now, and an End on `Stop()` or destruction
+class Scope final {
+ public:
+  Scope() = delete;
+  explicit Scope(NameID name) noexcept : mName(name), mActive(IsEnabled()) {
+    if (mActive) [[unlikely]] {
+      detail::Write(mName, RecordKind::Begin);
+    }
+  }
+
+  ~Scope() noexcept { this->Stop(); }
+
+  void Stop() noexcept {
+    if (mActive) [[unlikely]] {
+      mActive = false;
+      detail::Write(mName, RecordKind::End);
+    }
+  }
+
+  Scope(const Scope&) = delete;
+  Scope(Scope&&) = delete;
+  Scope& operator=(const Scope&) = delete;
+  Scope& operator=(Scope&&) = delete;
+
+ private:
+  NameID mName {};
+  bool mActive {false};
+};
+
+/// Write the current contents of all buffers
+void Dump(std::ostream&);
+
+/** Write the current contents of all buffers to a file.
+ *
+ * This does not block on locks held by other threads, so is usable from
+ * crash handlers; if another thread is registering a buffer or name at the
+ * time, this returns false without writing anything.
+ */
+bool DumpToFile(const std::filesystem::path&) noexcept;
+
+struct ThreadRecords {
+  uint64_t mThreadID {};
+  std::vector<Record> mRecords {};
+};
+
+struct Trace {
+  std::vector<std::string> mNames;
+  std::vector<ThreadRecords> mThreads;
+  /// The input ended part-way through the records
+  bool mTruncated {false};
+};
+
+/** Read a file written by `Dump()`; returns `std::nullopt` if invalid.
+ *
+ * A dump can be cut short if the process is killed while writing it; if
+ * the input ends part-way through the records, the complete records are
+ * returned, and `mTruncated` is set.
+ */
+std::optional<Trace> Read(std::istream&);
+
+}// namespace OpenKneeboard::BinaryTrace
+
+/** Record a scope in the binary trace.
+ *
+ * @param OKBT_NAME the name of the scope (C string literal)
+ */
+#define OPENKNEEBOARD_BinaryTraceScope(OKBT_NAME) \
+  const ::OpenKneeboard::BinaryTrace::Scope OPENKNEEBOARD_CONCAT2( \
+    _okbts, __COUNTER__) { \
+    []() { \
+      static const auto id = ::OpenKneeboard::BinaryTrace::Intern(OKBT_NAME); \
+      return id; \
+    }()}
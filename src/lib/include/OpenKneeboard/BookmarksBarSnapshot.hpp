@@ -0,0 +1,125 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace OpenKneeboard {
+
+/** Immutable layout of a bookmarks bar: each button's rect, and its label's
+ * laid-out text.
+ *
+ * Building a snapshot lays out every label, so only build a new one when the
+ * `Key` changes; painting then uses the snapshot as-is.
+ *
+ * `TLabelLayout` is whatever the text measurer produces, e.g. an
+ * `IDWriteTextLayout`.
+ */
+template <class TLabelLayout>
+class BookmarksBarSnapshot final {
+ public:
+  struct Key {
+    /// Changes whenever the bookmarks or their titles change
+    uint64_t mBookmarksGeneration {};
+    float mDPI {};
+    /// Pixels
+    uint32_t mWidth {};
+    uint32_t mHeight {};
+
+    constexpr bool operator==(const Key&) const noexcept = default;
+  };
+
+  /// Pixels, relative to the top-left of the bar
+  struct Rect {
+    float mLeft {};
+    float mTop {};
+    float mRight {};
+    float mBottom {};
+
+    constexpr bool operator==(const Rect&) const noexcept = default;
+  };
+
+  struct Button {
+    Rect mRect {};
+    TLabelLayout mLabel {};
+  };
+
+  /// Which buttons are highlighted
+  struct PaintState {
+    std::optional<std::size_t> mHoverButton {};
+    std::optional<std::size_t> mCurrentPageButton {};
+
+    constexpr bool operator==(const PaintState&) const noexcept = default;
+  };
+
+  /** Lay out `buttonCount` buttons, one above the other.
+   *
+   * `measure(index, rect, fontSize)` lays out the label for the button at
+   * `index`, to fit in `rect`; it is called exactly once per button.
+   */
+  template <class Measure>
+    requires std::is_invocable_r_v<
+      TLabelLayout,
+      Measure&,
+      std::size_t,
+      const Rect&,
+      float>
+  static std::shared_ptr<const BookmarksBarSnapshot>
+  Build(const Key& key, std::size_t buttonCount, Measure&& measure) {
+    std::shared_ptr<BookmarksBarSnapshot> ret {new BookmarksBarSnapshot(key)};
+    if (buttonCount == 0 || key.mWidth == 0 || key.mHeight == 0) {
+      return ret;
+    }
+
+    const auto dpi = (key.mDPI > 0) ? key.mDPI : 96.0f;
+    const auto width = static_cast<float>(key.mWidth);
+    const auto height = static_cast<float>(key.mHeight);
+    // Vertical text, filling 3/4 of the bar's width
+    ret->mFontSize = (width * 0.75f * 96) / (2 * dpi);
+
+    const auto interval = height / buttonCount;
+    ret->mButtons.reserve(buttonCount);
+    for (std::size_t i = 0; i < buttonCount; ++i) {
+      const Rect rect {
+        0,
+        std::floor(interval * i),
+        width,
+        (i + 1 == buttonCount) ? height : std::floor(interval * (i + 1)),
+      };
+      ret->mButtons.push_back({rect, measure(i, rect, ret->mFontSize)});
+    }
+    return ret;
+  }
+
+  [[nodiscard]]
+  const Key& GetKey() const {
+    return mKey;
+  }
+
+  [[nodiscard]]
+  float GetFontSize() const {
+    return mFontSize;
+  }
+
+  [[nodiscard]]
+  std::span<const Button> GetButtons() const {
+    return mButtons;
+  }
+
+ private:
+  explicit BookmarksBarSnapshot(const Key& key) : mKey(key) {}
+
+  Key mKey;
+  float mFontSize {};
+  std::vector<Button> mButtons;
+};
+
+}// namespace OpenKneeboard
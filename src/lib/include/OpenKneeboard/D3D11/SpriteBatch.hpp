@@ -7,12 +7,14 @@
 #pragma once
 
 #include <OpenKneeboard/Pixels.hpp>
+#include <OpenKneeboard/SpriteBatchCore.hpp>
 
 #include <shims/winrt/base.h>
 
 #include <directxtk/CommonStates.h>
 
 #include <memory>
+#include <optional>
 
 #include <DirectXColors.h>
 #include <DirectXMath.h>
@@ -57,14 +59,17 @@ class SpriteBatch {
     struct Uniform {
       std::array<float, 2> mSourceDimensions;
       std::array<float, 2> mDestDimensions;
+
+      constexpr bool operator==(const Uniform&) const noexcept = default;
     };
 
-    struct Vertex {
-      std::array<float, 4> mPosition;
-      DirectX::XMVECTORF32 mColor;
-      std::array<float, 2> mTexCoord;
-      std::array<float, 2> mTexClampTL;
-      std::array<float, 2> mTexClampBR;
+    // Per-instance vertex data; one per sprite
+    struct Instance {
+      // All rects are {left, top, right, bottom}
+      std::array<float, 4> mSourceRect;
+      std::array<float, 4> mDestRect;
+      std::array<float, 4> mColor;
+      std::array<float, 4> mSourceClamp;
     };
   };
 
@@ -83,13 +88,23 @@ class SpriteBatch {
   ID3D11RenderTargetView* mTarget {nullptr};
   std::array<float, 2> mTargetDimensions;
 
-  // View is a rectangle, which needs two triangles, which each need 3 points
-  static constexpr size_t MaxVertices = 6 * MaxViewCount;
-  ID3D11ShaderResourceView* mPendingSource {nullptr};
-  D3D11_TEXTURE2D_DESC mPendingSourceDesc {};
-  std::vector<ShaderData::Vertex> mPendingVertices;
+  // View is a rectangle, which needs two triangles, which each need 3 points;
+  // these are expanded from the instance by the vertex shader
+  static constexpr UINT VerticesPerSprite = 6;
+  // Initial size; grown if needed
+  static constexpr size_t MinVertexBufferSprites = MaxViewCount;
+  size_t mVertexBufferSprites {0};
+
+  SpriteBatchCore<ID3D11ShaderResourceView*> mBatch;
+  // Avoid re-querying the size if we draw the same source repeatedly
+  ID3D11ShaderResourceView* mLastSource {nullptr};
+  PixelSize mLastSourceSize {};
+
+  std::vector<ShaderData::Instance> mInstances;
+  std::optional<ShaderData::Uniform> mUniform;
 
-  void DrawPendingVertices();
+  void CreateVertexBuffer(size_t spriteCount);
+  void DrawBatch();
 };
 
 }// namespace OpenKneeboard::D3D11
@@ -9,6 +9,7 @@
 #include <OpenKneeboard/D3D.hpp>
 #include <OpenKneeboard/Pixels.hpp>
 #include <OpenKneeboard/Shaders/SpriteBatch.hpp>
+#include <OpenKneeboard/SpriteBatchCore.hpp>
 
 #include <shims/winrt/base.h>
 
@@ -54,7 +55,7 @@ class SpriteBatch {
   void End();
 
  private:
-  using Vertex = Shaders::SpriteBatch::Vertex;
+  using Instance = Shaders::SpriteBatch::Instance;
   // "Uniform" is Vulkan terminology, "CBuffer" for D3D/HLSL
   using CBuffer = Shaders::SpriteBatch::UniformBuffer;
   static constexpr auto MaxInflightFrames = 2;
@@ -63,8 +64,6 @@ class SpriteBatch {
     Shaders::SpriteBatch::MaxSpritesPerBatch;
   static constexpr auto VerticesPerSprite =
     Shaders::SpriteBatch::VerticesPerSprite;
-  static constexpr auto MaxVerticesPerBatch =
-    Shaders::SpriteBatch::MaxVerticesPerBatch;
 
   ID3D12Device* mDevice {nullptr};
   ID3D12CommandQueue* mCommandQueue {nullptr};
@@ -76,23 +75,14 @@ class SpriteBatch {
   // Use modulo MaxInflightFrames for heap offset
   uint64_t mDrawCount {};
 
-  struct Sprite {
-    ID3D12Resource* mSource {nullptr};
-    PixelSize mSourceSize;
-    PixelRect mSourceRect;
-    PixelRect mDestRect;
-    DirectX::XMVECTORF32 mTint {};
-  };
-
   struct NextFrame {
     ID3D12GraphicsCommandList* mCommandList {nullptr};
     D3D12_CPU_DESCRIPTOR_HANDLE mRenderTargetView {};
     PixelSize mRenderTargetViewSize {};
-
-    std::vector<Sprite> mSprites;
   };
 
   std::optional<NextFrame> mNextFrame;
+  SpriteBatchCore<ID3D12Resource*> mBatch;
 };
 
 }// namespace OpenKneeboard::D3D12
@@ -0,0 +1,93 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace OpenKneeboard {
+
+/** The parts of a DCS mission that are shown in the briefing tab.
+ *
+ * Extracting these requires executing the mission's Lua files, which is slow
+ * for large missions; this is a compact copy that can be cached on disk and
+ * reloaded without Lua.
+ *
+ * Localized strings are already resolved via the mission's dictionary, and
+ * image resource keys via its map resources. Fields are empty if they were
+ * missing or invalid in the mission.
+ */
+struct DCSMissionDigest final {
+  struct Date {
+    int32_t mYear {};
+    uint32_t mMonth {};
+    uint32_t mDay {};
+
+    constexpr bool operator==(const Date&) const noexcept = default;
+  };
+
+  struct Wind {
+    /// Meters per second
+    float mSpeed {};
+    /// Degrees, as stored in the mission
+    int32_t mDirection {};
+
+    constexpr bool operator==(const Wind&) const noexcept = default;
+  };
+
+  struct Weather {
+    int32_t mTemperature {};
+    /// mmHg
+    float mQNH {};
+    int32_t mCloudBase {};
+    Wind mWindAtGround;
+    Wind mWindAt2000;
+    Wind mWindAt8000;
+
+    constexpr bool operator==(const Weather&) const noexcept = default;
+  };
+
+  struct Point {
+    double mX {};
+    double mY {};
+
+    constexpr bool operator==(const Point&) const noexcept = default;
+  };
+
+  struct Coalition {
+    /// Comma-separated
+    std::optional<std::string> mCountries;
+    std::optional<std::string> mTask;
+    /// File names relative to the mission's localized resource directory
+    std::vector<std::string> mImages;
+    std::optional<Point> mBullseye;
+
+    bool operator==(const Coalition&) const noexcept = default;
+  };
+
+  std::optional<std::string> mTitle;
+  std::optional<std::string> mSituation;
+  std::optional<Date> mStartDate;
+  /// Seconds since midnight
+  std::optional<uint32_t> mStartTime;
+  std::optional<Weather> mWeather;
+  /// Indexed by `DCSEvents::Coalition`: neutral, red, blue
+  std::array<Coalition, 3> mCoalitions {};
+
+  bool operator==(const DCSMissionDigest&) const noexcept = default;
+
+  /// Hash the contents of the files the digest is extracted from
+  static uint64_t HashContent(std::initializer_list<std::string_view> files);
+
+  /// Versioned binary encoding
+  std::string Serialize() const;
+  /// Returns nullopt if the data is invalid or from a different version
+  static std::optional<DCSMissionDigest> Deserialize(std::string_view);
+};
+
+}// namespace OpenKneeboard
@@ -0,0 +1,134 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace OpenKneeboard {
+
+/** Writes files on a background thread, coalescing rapid updates.
+ *
+ * Each file is written to a temporary file in the same directory, then
+ * renamed over the target, so a crash mid-write leaves either the old or the
+ * new contents - never a truncated file.
+ *
+ * If a file is updated several times before it's written, only the latest
+ * contents are written. Writes happen once a file has been left alone for
+ * `mDebounce`, or after `mMaxDelay` if it keeps changing.
+ */
+class DebouncedFileWriter final {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Options {
+    Clock::duration mDebounce {std::chrono::milliseconds(500)};
+    Clock::duration mMaxDelay {std::chrono::seconds(2)};
+  };
+
+  struct Statistics {
+    uint64_t mWrites {};
+    uint64_t mRemovals {};
+    /// Updates that replaced a pending update instead of being written
+    uint64_t mCoalesced {};
+    uint64_t mFailures {};
+    uint64_t mBytesWritten {};
+
+    /// Time from the first unwritten update to the update being on disk
+    Clock::duration mLastLatency {};
+    Clock::duration mMaxLatency {};
+    /// Time spent actually writing and renaming
+    Clock::duration mLastWriteDuration {};
+    Clock::duration mMaxWriteDuration {};
+  };
+
+  struct WriteResult {
+    bool mSucceeded {false};
+    /// Empty on success
+    std::string mError {};
+    /// 0 for removals
+    std::size_t mBytes {};
+    Clock::duration mLatency {};
+    Clock::duration mWriteDuration {};
+  };
+
+  /// Called on the worker thread after each write or removal
+  using WriteCallback = std::function<
+    void(const std::filesystem::path&, const WriteResult&)>;
+
+  DebouncedFileWriter();
+  explicit DebouncedFileWriter(const Options&, WriteCallback = {});
+  /// Flushes pending writes
+  ~DebouncedFileWriter();
+
+  DebouncedFileWriter(const DebouncedFileWriter&) = delete;
+  DebouncedFileWriter(DebouncedFileWriter&&) = delete;
+  DebouncedFileWriter& operator=(const DebouncedFileWriter&) = delete;
+  DebouncedFileWriter& operator=(DebouncedFileWriter&&) = delete;
+
+  void Write(const std::filesystem::path&, std::string contents);
+  /// Remove the file, replacing any pending write
+  void Remove(const std::filesystem::path&);
+
+  /// Write everything that's pending now, and wait for it to finish
+  void Flush();
+
+  /// Whether there's a write or removal for `path` that hasn't finished yet
+  [[nodiscard]]
+  bool IsPending(const std::filesystem::path&) const;
+
+  Statistics GetStatistics() const;
+
+  /** Replace `path` with `contents` via a temporary file and rename.
+   *
+   * Creates the parent directory if needed. Both the contents and the rename
+   * are flushed to disk before this returns.
+   *
+   * @throws std::filesystem::filesystem_error
+   */
+  static void WriteAtomically(
+    const std::filesystem::path& path,
+    std::string_view contents);
+
+ private:
+  struct Pending {
+    // `std::nullopt` to remove
+    std::optional<std::string> mContents;
+    Clock::time_point mFirstQueuedAt;
+    Clock::time_point mLastQueuedAt;
+  };
+
+  const Options mOptions;
+  const WriteCallback mWriteCallback;
+
+  mutable std::mutex mMutex;
+  std::condition_variable_any mWakeWorker;
+  std::condition_variable mWroteBatch;
+  std::map<std::filesystem::path, Pending> mPending;
+  // Taken from `mPending` by the worker thread, but not yet on disk
+  std::set<std::filesystem::path> mInFlight;
+  // Incremented for each update and each completed batch, so `Flush()` can
+  // wait until everything queued before it has been handled
+  uint64_t mQueuedGeneration {};
+  uint64_t mWrittenGeneration {};
+  bool mFlushRequested {false};
+  Statistics mStatistics;
+
+  std::jthread mThread;
+
+  void Enqueue(const std::filesystem::path&, std::optional<std::string>);
+  void Run(std::stop_token);
+  void WriteOne(const std::filesystem::path&, const Pending&);
+};
+
+}// namespace OpenKneeboard
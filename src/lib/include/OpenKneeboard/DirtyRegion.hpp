@@ -0,0 +1,73 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <OpenKneeboard/Pixels.hpp>
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+namespace OpenKneeboard {
+
+/** A small set of non-overlapping-ish rectangles that need to be updated.
+ *
+ * Rectangles are clamped to the bounds, and merged when merging them doesn't
+ * waste much area; if there are too many rectangles, the cheapest pair is
+ * merged. If most of the bounds are dirty, this collapses to a single
+ * rectangle covering everything, as a single large copy is cheaper than
+ * several nearly-as-large copies.
+ *
+ * This does not allocate.
+ */
+class DirtyRegion final {
+ public:
+  static constexpr std::size_t MaxRects = 8;
+
+  DirtyRegion() = default;
+  explicit DirtyRegion(const PixelSize& bounds);
+
+  /// Change the bounds; if they actually change, the entire region is dirty
+  void SetBounds(const PixelSize&);
+  PixelSize GetBounds() const noexcept { return mBounds; }
+
+  void Add(const PixelRect&);
+  void Add(const DirtyRegion&);
+  void AddAll();
+  void Clear() noexcept { mCount = 0; }
+
+  DirtyRegion& operator|=(const PixelRect& rect) {
+    this->Add(rect);
+    return *this;
+  }
+
+  DirtyRegion& operator|=(const DirtyRegion& other) {
+    this->Add(other);
+    return *this;
+  }
+
+  [[nodiscard]]
+  bool IsEmpty() const noexcept {
+    return mCount == 0;
+  }
+  [[nodiscard]]
+  bool IsAll() const noexcept;
+
+  std::span<const PixelRect> GetRects() const noexcept {
+    return {mRects.data(), mCount};
+  }
+
+  /// Total area of the rectangles; may be larger than the actual dirty area
+  uint64_t GetArea() const noexcept;
+
+ private:
+  PixelSize mBounds {};
+  std::array<PixelRect, MaxRects + 1> mRects {};
+  std::size_t mCount {0};
+
+  void Erase(std::size_t index) noexcept;
+  void MergeAdjacent() noexcept;
+  void MergeCheapestPair() noexcept;
+};
+
+}// namespace OpenKneeboard
@@ -7,6 +7,8 @@
 #pragma once
 
 #include <filesystem>
+#include <memory>
+#include <string_view>
 #include <thread>
 
 struct _GUID;
@@ -82,4 +84,29 @@ class TemporaryCopy final {
   std::filesystem::path mCopy;
 };
 
+/** A read-only view of a file's content, without reading all of it.
+ *
+ * Other processes can still read or delete the file, but not write to it, so
+ * the content can not change underneath a view. This also means that Open()
+ * fails if another process already has the file open for writing.
+ */
+class MappedFile final {
+ public:
+  /// Returns nullptr on failure
+  static std::unique_ptr<MappedFile> Open(const std::filesystem::path&);
+  ~MappedFile() noexcept;
+
+  MappedFile() = delete;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  std::string_view GetContent() const noexcept;
+
+ private:
+  struct Impl;
+  std::unique_ptr<Impl> p;
+
+  MappedFile(std::unique_ptr<Impl>);
+};
+
 }// namespace OpenKneeboard::Filesystem
@@ -0,0 +1,63 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace OpenKneeboard {
+
+/** Case-insensitive substring filtering over a list of entries.
+ *
+ * Each entry has one or more fields, e.g. a window's title and executable
+ * path; these are case-folded once, when the entry is added. An entry
+ * matches a query if each space-separated word in the query is in at least
+ * one of its fields.
+ *
+ * Filtering is incremental: while typing, each query usually extends the
+ * previous one, so only the previous matches need to be searched, and only
+ * for the words that changed.
+ *
+ * This class is not thread-safe.
+ */
+class FoldedStringIndex final {
+ public:
+  using EntryIndex = std::size_t;
+
+  /// Returns the index of the new entry
+  EntryIndex Add(std::initializer_list<std::string_view> fields);
+  void Clear();
+
+  [[nodiscard]]
+  std::size_t GetEntryCount() const;
+
+  /** Indices of the entries matching `query`, in the order they were added.
+   *
+   * An empty query matches all entries. The result is valid until the next
+   * call to a non-const member.
+   */
+  [[nodiscard]]
+  std::span<const EntryIndex> Filter(std::string_view query);
+
+ private:
+  struct Entry {
+    /// Folded fields, separated by '\0' so that words can't span fields
+    std::string mFolded;
+  };
+
+  std::vector<Entry> mEntries;
+
+  std::string mFoldBuffer;
+  /// Folded; `mMatches` is valid for this query
+  std::optional<std::string> mLastQuery;
+  std::vector<EntryIndex> mMatches;
+
+  void ResetMatches();
+};
+
+}// namespace OpenKneeboard
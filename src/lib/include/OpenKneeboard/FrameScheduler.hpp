@@ -0,0 +1,131 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+
+namespace OpenKneeboard {
+
+/** Decides when the app should wake up, and whether it should render.
+ *
+ * Consumers (VR layers, the viewer) report their frame times through
+ * `SHM::ActiveConsumers`; from these, this learns each consumer's frame
+ * period and phase, and schedules wake-ups so that rendering finishes just
+ * before the fastest consumer's next frame.
+ *
+ * - With no active consumer, it wakes at `mIdlePeriod` for housekeeping
+ * - While learning a consumer's cadence, it wakes at `mMinConsumerPeriod`
+ * - With recent repaint demand, it wakes for every frame of the fastest
+ *   consumer
+ * - Otherwise, it wakes at roughly `mQuietPeriod`, still aligned to
+ *   consumer frames, so polled sources (e.g. window capture) can notice
+ *   changes
+ *
+ * This is pure policy: it has no clock of its own, and all times are passed
+ * in, so that it can be simulated deterministically. It is not thread-safe.
+ */
+class FrameScheduler final {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using TimePoint = Clock::time_point;
+  using Duration = std::chrono::nanoseconds;
+  using ConsumerID = uint32_t;
+
+  struct Options {
+    /// For consumers without a known cadence, e.g. the app window
+    Duration mDefaultPeriod {std::chrono::nanoseconds(1'000'000'000 / 90)};
+    Duration mIdlePeriod {std::chrono::milliseconds(100)};
+    Duration mQuietPeriod {std::chrono::milliseconds(50)};
+    /// How long after the latest repaint request to keep full cadence
+    Duration mBusyWindow {std::chrono::milliseconds(500)};
+    /// Consumers are inactive if they haven't rendered for this long
+    Duration mConsumerTimeout {std::chrono::seconds(1)};
+    /// Larger frame intervals are treated as a pause, not a cadence
+    Duration mMaxConsumerPeriod {std::chrono::milliseconds(100)};
+    Duration mMinConsumerPeriod {
+      std::chrono::nanoseconds(1'000'000'000 / 240)};
+    /// Extra time to allow between finishing rendering and a consumer frame
+    Duration mRenderMargin {std::chrono::milliseconds(1)};
+  };
+
+  FrameScheduler();
+  explicit FrameScheduler(const Options&);
+
+  /** Record that a consumer rendered a frame at `frameTime`.
+   *
+   * It's fine to call this repeatedly with the same time; it's intended to
+   * be called with the latest values from `SHM::ActiveConsumers` on every
+   * tick.
+   */
+  void ObserveConsumerFrame(ConsumerID, TimePoint frameTime);
+
+  /// Set whether there is a consumer without a known cadence
+  void SetFreeRunningConsumerActive(bool);
+
+  void ObserveRenderDuration(Duration);
+
+  /** Record a request to repaint.
+   *
+   * Returns a new wake time if the current schedule should be brought
+   * forward to handle the request.
+   */
+  std::optional<TimePoint> NotifyRepaintNeeded(TimePoint now);
+
+  /// If false, there's no point rendering
+  bool HasActiveConsumer(TimePoint now) const;
+
+  /// Plan the next wake-up; call this once per tick
+  TimePoint ScheduleNextWake(TimePoint now);
+
+  /// The latest result of `ScheduleNextWake()` or `NotifyRepaintNeeded()`
+  TimePoint GetScheduledWake() const;
+
+  /// The learned frame period of a consumer, if known
+  std::optional<Duration> GetConsumerPeriod(ConsumerID) const;
+
+ private:
+  static constexpr std::size_t MaxIntervalSamples = 16;
+  static constexpr std::size_t MinIntervalSamples = 3;
+
+  struct Consumer {
+    TimePoint mLastFrame {};
+    std::array<Duration, MaxIntervalSamples> mIntervals {};
+    std::size_t mIntervalCount {0};
+    std::size_t mNextInterval {0};
+    std::optional<Duration> mPeriod;
+  };
+
+  struct Pacing {
+    TimePoint mLastFrame;
+    Duration mPeriod;
+  };
+
+  struct Plan {
+    TimePoint mWake;
+    std::optional<TimePoint> mTargetFrame {};
+  };
+
+  const Options mOptions;
+  std::map<ConsumerID, Consumer> mConsumers;
+  bool mFreeRunningConsumerActive {false};
+  Duration mRenderEstimate {};
+  std::optional<TimePoint> mLatestDemand;
+
+  TimePoint mScheduledWake {};
+  std::optional<TimePoint> mScheduledTargetFrame;
+  std::optional<TimePoint> mLatestTargetFrame;
+
+  bool IsActive(const Consumer&, TimePoint now) const;
+  bool IsBusy(TimePoint now) const;
+  bool IsLearning(TimePoint now) const;
+  std::optional<Pacing> GetPacing(TimePoint now) const;
+  Plan GetPlan(TimePoint now, bool busy) const;
+  static std::optional<Duration> EstimatePeriod(const Consumer&);
+};
+
+}// namespace OpenKneeboard
@@ -0,0 +1,110 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace OpenKneeboard {
+
+/** A fixed-size, lock-free histogram of unsigned integer values.
+ *
+ * Values are bucketed log-linearly, like HdrHistogram: each power of two is
+ * split into `SubBucketCount` equal-width buckets, so values below
+ * `2 * SubBucketCount` are exact, and larger values are reported within
+ * `1 / (2 * SubBucketCount)` of the recorded value. Values above `MaxValue`
+ * are clamped.
+ *
+ * `Record()` is wait-free for the common case and safe to call from any
+ * number of threads. The type is standard-layout, zero-initialized, and only
+ * contains lock-free atomics, so can be placed in shared memory.
+ */
+class Histogram final {
+ public:
+  static constexpr uint8_t SubBucketBits = 4;
+  static constexpr uint64_t SubBucketCount = 1ull << SubBucketBits;
+  // 2^36ns is a bit over a minute
+  static constexpr uint8_t MaxValueBits = 36;
+  static constexpr uint64_t MaxValue = (1ull << MaxValueBits) - 1;
+  static constexpr std::size_t BucketCount
+    = (MaxValueBits - SubBucketBits + 1) * SubBucketCount;
+
+  struct Summary {
+    uint64_t mCount {};
+    uint64_t mMin {};
+    uint64_t mMax {};
+    uint64_t mMean {};
+    uint64_t mP50 {};
+    uint64_t mP90 {};
+    uint64_t mP99 {};
+    uint64_t mP999 {};
+  };
+
+  Histogram() = default;
+
+  void Record(uint64_t value) noexcept {
+    value = (value > MaxValue) ? MaxValue : value;
+    mBuckets[GetBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    mSum.fetch_add(value, std::memory_order_relaxed);
+
+    // Stored as value + 1, so that zero-initialized means 'no values'
+    auto min = mMinPlusOne.load(std::memory_order_relaxed);
+    while ((min == 0 || value + 1 < min)
+           && !mMinPlusOne.compare_exchange_weak(
+             min, value + 1, std::memory_order_relaxed)) {
+    }
+    auto max = mMax.load(std::memory_order_relaxed);
+    while (value > max
+           && !mMax.compare_exchange_weak(
+             max, value, std::memory_order_relaxed)) {
+    }
+  }
+
+  /** Percentiles and other statistics.
+   *
+   * This is safe to call while other threads are recording, though values
+   * recorded during the call may or may not be included.
+   */
+  Summary GetSummary() const noexcept;
+
+  /// Not atomic with respect to concurrent `Record()` calls
+  void Reset() noexcept;
+
+  static constexpr std::size_t GetBucketIndex(uint64_t value) noexcept {
+    const auto width = std::bit_width(value);
+    const auto shift
+      = (width > SubBucketBits + 1) ? (width - (SubBucketBits + 1)) : 0;
+    return static_cast<std::size_t>(
+      (shift * SubBucketCount) + (value >> shift));
+  }
+
+  /// The smallest value that would be recorded in the same bucket
+  static constexpr uint64_t GetBucketLowerBound(std::size_t index) noexcept {
+    const auto shift
+      = (index < 2 * SubBucketCount) ? 0 : ((index / SubBucketCount) - 1);
+    return (index - (shift * SubBucketCount)) << shift;
+  }
+
+  /// The value reported for percentiles falling in the bucket
+  static constexpr uint64_t GetBucketMidpoint(std::size_t index) noexcept {
+    const auto shift
+      = (index < 2 * SubBucketCount) ? 0 : ((index / SubBucketCount) - 1);
+    return GetBucketLowerBound(index) + ((1ull << shift) >> 1);
+  }
+
+ private:
+  std::array<std::atomic<uint32_t>, BucketCount> mBuckets {};
+  std::atomic<uint64_t> mSum {0};
+  std::atomic<uint64_t> mMinPlusOne {0};
+  std::atomic<uint64_t> mMax {0};
+};
+static_assert(std::is_standard_layout_v<Histogram>);
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+static_assert(Histogram::GetBucketIndex(Histogram::MaxValue) + 1
+  == Histogram::BucketCount);
+
+}// namespace OpenKneeboard
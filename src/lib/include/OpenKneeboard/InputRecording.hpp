@@ -0,0 +1,113 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/** Record and replay external input.
+ *
+ * Bugs and performance problems with API events (e.g. bursts of radio
+ * messages from DCS) or tablet input (e.g. OpenTabletDriver floods) are hard
+ * to reproduce without a live game and a tablet. This records the raw,
+ * timestamped messages to a compact file, so they can be replayed later -
+ * at the original speed, faster, or as fast as possible - through the same
+ * entry points as live input.
+ *
+ * The file format and `Player` are platform-neutral, so recordings can also
+ * be used for benchmarks elsewhere.
+ */
+namespace OpenKneeboard::InputRecording {
+
+enum class Stream : uint8_t {
+  /// A serialized `APIEvent`, as received by `APIEventServer`
+  APIEvent = 1,
+  /// A complete OTD-IPC message, including its header
+  OTDIPC = 2,
+};
+
+struct Message {
+  Stream mStream {};
+  /// Time since the start of the recording
+  std::chrono::nanoseconds mOffset {};
+  std::string mPayload;
+};
+
+namespace detail {
+extern std::atomic<bool> gRecording;
+void Record(Stream, std::string_view payload) noexcept;
+}// namespace detail
+
+/** Start recording to `path`, replacing any existing file.
+ *
+ * Returns false if the file could not be created.
+ */
+bool StartRecording(const std::filesystem::path& path);
+void StopRecording();
+
+[[nodiscard]]
+inline bool IsRecording() noexcept {
+  return detail::gRecording.load(std::memory_order_relaxed);
+}
+
+/// Record a message now; this is thread-safe, and a no-op if not recording
+inline void Record(Stream stream, std::string_view payload) noexcept {
+  if (IsRecording()) [[unlikely]] {
+    detail::Record(stream, payload);
+  }
+}
+
+void WriteHeader(std::ostream&);
+/** Append a message after the header.
+ *
+ * Offsets are stored as deltas, so `previousOffset` must be the offset of
+ * the previous message written, or zero for the first.
+ */
+void WriteMessage(
+  std::ostream&,
+  const Message&,
+  std::chrono::nanoseconds previousOffset);
+
+/// Returns nullopt if the data is not a valid recording
+std::optional<std::vector<Message>> Read(std::istream&);
+std::optional<std::vector<Message>> Read(const std::filesystem::path&);
+
+/** Decides when recorded messages are due.
+ *
+ * This has no clock of its own: callers wait until the returned offset
+ * (relative to the start of playback) has passed, then call `Pop()`.
+ */
+class Player final {
+ public:
+  /** @param speed a multiplier for the original speed; 0 plays as fast as
+   *    possible
+   */
+  Player(std::vector<Message>, double speed = 1.0);
+
+  [[nodiscard]]
+  bool IsFinished() const noexcept;
+  /// Time relative to the start of playback that the next message is due
+  std::chrono::nanoseconds GetNextDueOffset() const;
+  Message Pop();
+
+  std::size_t GetMessageCount() const noexcept;
+
+ private:
+  std::vector<Message> mMessages;
+  double mSpeed {1.0};
+  std::size_t mNext {0};
+};
+
+/// Play all remaining messages on the current thread, sleeping as needed
+void PlayBlocking(Player&, const std::function<void(const Message&)>&);
+
+}// namespace OpenKneeboard::InputRecording
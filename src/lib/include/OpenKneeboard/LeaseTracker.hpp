@@ -0,0 +1,89 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace OpenKneeboard {
+
+/** Lifetime accounting for a keyed cache of shared, expensive objects.
+ *
+ * Each entry is leased by zero or more users. When the last lease is
+ * released, the entry is kept for a grace period in case it's needed again,
+ * e.g. when the same folders are selected after a respawn; after that, it's
+ * returned by `Expire()` for the caller to destroy.
+ *
+ * This only tracks keys; the caller owns the objects. It is not thread-safe.
+ */
+class LeaseTracker final {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using Key = std::string;
+
+  struct Acquisition {
+    /// If true, the caller must create the object
+    bool mIsNew {false};
+    /// The entry existed, but had no leases
+    bool mWasIdle {false};
+  };
+
+  struct Stats {
+    uint64_t mHits {};
+    uint64_t mMisses {};
+    /// Hits on entries that had no leases
+    uint64_t mIdleHits {};
+    uint64_t mExpirations {};
+
+    std::size_t mEntryCount {};
+    /// Included in `mEntryCount`
+    std::size_t mIdleCount {};
+  };
+
+  LeaseTracker() = delete;
+  explicit LeaseTracker(Clock::duration gracePeriod);
+
+  [[nodiscard]]
+  Acquisition Acquire(const Key&);
+  /// Returns false if the key has no leases
+  bool Release(const Key&, Clock::time_point now);
+
+  /** Remove entries that have been idle for at least the grace period.
+   *
+   * Returns the removed keys; the caller must destroy their objects.
+   */
+  [[nodiscard]]
+  std::vector<Key> Expire(Clock::time_point now);
+  /// When the next idle entry will expire, if any
+  [[nodiscard]]
+  std::optional<Clock::time_point> GetNextExpiry() const;
+
+  /// Forget an entry regardless of leases, e.g. because creating it failed
+  void Remove(const Key&);
+  /// Forget all entries, returning their keys
+  [[nodiscard]]
+  std::vector<Key> Clear();
+
+  [[nodiscard]]
+  std::size_t GetLeaseCount(const Key&) const;
+  [[nodiscard]]
+  Stats GetStats() const;
+
+ private:
+  struct Entry {
+    std::size_t mLeases {};
+    /// Set when `mLeases` drops to 0
+    std::optional<Clock::time_point> mIdleSince {};
+  };
+
+  Clock::duration mGracePeriod {};
+  std::unordered_map<Key, Entry> mEntries;
+  Stats mStats;
+};
+
+}// namespace OpenKneeboard
@@ -0,0 +1,214 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace OpenKneeboard {
+
+/** A bounded, thread-safe store of log messages.
+ *
+ * Entries are UTF-8, and numbered with an increasing sequence number;
+ * readers can keep the last sequence number they've seen, and just fetch
+ * newer entries.
+ *
+ * When either the entry count or the total message size would exceed its
+ * limit, the oldest entries are dropped.
+ *
+ * Entries are also indexed by source (executable and prefix) and level, so
+ * filtered queries don't need to scan unrelated entries.
+ */
+class LogRing final {
+ public:
+  using Clock = std::chrono::system_clock;
+  using Sequence = uint64_t;
+  using SourceID = uint32_t;
+
+  enum class Level : uint8_t {
+    Verbose,
+    Warning,
+    Error,
+  };
+  static constexpr std::size_t LevelCount = 3;
+
+  /** Readers give up after this, returning nothing.
+   *
+   * The fatal error handler reads the log; this stops it deadlocking if it
+   * was called while `Push()` held the lock.
+   */
+  static constexpr auto ReadLockTimeout = std::chrono::seconds(1);
+
+  struct Limits {
+    std::size_t mMaxEntries {10000};
+    std::size_t mMaxBytes {4 * 1024 * 1024};
+    /// Longer messages are truncated
+    std::size_t mMaxMessageBytes {16 * 1024};
+  };
+
+  struct Source {
+    std::string mExecutable;
+    std::string mPrefix;
+  };
+
+  struct Entry {
+    Sequence mSequence {};
+    Clock::time_point mWhen;
+    uint32_t mProcessID {};
+    SourceID mSource {};
+    Level mLevel {Level::Verbose};
+    std::string mMessage;
+  };
+
+  struct Filter {
+    std::optional<SourceID> mSource;
+    std::optional<Level> mLevel;
+  };
+
+  struct Statistics {
+    std::size_t mEntries {};
+    std::size_t mBytes {};
+    uint64_t mDropped {};
+    uint64_t mTruncated {};
+  };
+
+  LogRing();
+  explicit LogRing(const Limits&);
+
+  Sequence Push(
+    Clock::time_point when,
+    uint32_t processID,
+    std::string_view executable,
+    std::string_view prefix,
+    Level level,
+    std::string_view message);
+
+  /** Call `visitor(entry, source)` for up to `maxCount` entries matching
+   * `filter` with a sequence number greater than `after`, oldest first.
+   *
+   * Pass 0 to start from the oldest entry that's still stored.
+   *
+   * Entries are visited in place rather than copied; as writers are blocked
+   * while visiting, large reads should be split into batches by passing the
+   * return value as the next `after`.
+   *
+   * @returns the sequence number of the last visited entry, or `after` if
+   *   there were none; `std::nullopt` if the lock couldn't be acquired
+   *   within `ReadLockTimeout`
+   */
+  template <std::invocable<const Entry&, const Source&> F>
+  std::optional<Sequence> VisitSince(
+    Sequence after,
+    std::size_t maxCount,
+    const Filter& filter,
+    F&& visitor) const {
+    const auto lock = this->TryLockShared();
+    if (!lock) {
+      return std::nullopt;
+    }
+    if (mCount == 0) {
+      return after;
+    }
+
+    // Walk the smallest relevant index rather than every entry
+    if (const auto index = this->GetSmallestIndex(filter)) {
+      auto last = after;
+      std::size_t visited = 0;
+      for (auto it = std::ranges::upper_bound(*index, after);
+           it != index->end() && visited < maxCount;
+           ++it) {
+        const auto entry = this->Find(*it);
+        if (!(entry && Matches(filter, *entry))) {
+          continue;
+        }
+        visitor(*entry, mSources.at(entry->mSource));
+        last = *it;
+        ++visited;
+      }
+      return last;
+    }
+
+    const auto oldest = mEntries.at(mHead).mSequence;
+    const auto first = std::max(after + 1, oldest);
+    const auto end
+      = std::min<Sequence>(oldest + mCount, first + std::min(maxCount, mCount));
+    for (auto sequence = first; sequence < end; ++sequence) {
+      const auto& entry = *this->Find(sequence);
+      visitor(entry, mSources.at(entry.mSource));
+    }
+    return (first < end) ? (end - 1) : after;
+  }
+
+  template <std::invocable<const Entry&, const Source&> F>
+  std::optional<Sequence>
+  VisitSince(Sequence after, std::size_t maxCount, F&& visitor) const {
+    return this->VisitSince(
+      after, maxCount, Filter {}, std::forward<F>(visitor));
+  }
+
+  /** Copies of entries matching `filter` with a sequence number greater than
+   * `after`, oldest first.
+   *
+   * Pass 0 to get everything that's still stored.
+   */
+  std::vector<Entry> GetSince(Sequence after, const Filter& = {}) const;
+
+  /// The sequence number of the most recent `Push()`, or 0 if none
+  Sequence GetLatestSequence() const;
+
+  std::vector<Source> GetSources() const;
+  Source GetSource(SourceID) const;
+
+  /// The number of stored entries matching `filter`, without visiting them
+  std::size_t GetCount(const Filter& filter) const;
+
+  Statistics GetStatistics() const;
+
+ private:
+  const Limits mLimits;
+
+  mutable std::shared_timed_mutex mMutex;
+
+  // Ring buffer, with `mHead` the oldest entry
+  std::vector<Entry> mEntries;
+  std::size_t mHead {0};
+  std::size_t mCount {0};
+  std::size_t mBytes {0};
+  Sequence mNextSequence {1};
+
+  std::vector<Source> mSources;
+  std::map<std::pair<std::string, std::string>, SourceID> mSourceIDs;
+
+  // Sequence numbers; ascending, so they can be binary-searched
+  std::vector<std::deque<Sequence>> mSourceIndex;
+  std::array<std::deque<Sequence>, LevelCount> mLevelIndex;
+
+  uint64_t mDropped {0};
+  uint64_t mTruncated {0};
+
+  SourceID GetOrCreateSourceID(std::string_view executable, std::string_view);
+  std::shared_lock<std::shared_timed_mutex> TryLockShared() const;
+  void DropOldest();
+  const Entry* Find(Sequence) const;
+  /// `nullptr` if the filter is empty, so every entry is relevant
+  const std::deque<Sequence>* GetSmallestIndex(const Filter&) const;
+
+  static constexpr bool Matches(const Filter& filter, const Entry& entry) {
+    return (!filter.mSource || entry.mSource == *filter.mSource)
+      && (!filter.mLevel || entry.mLevel == *filter.mLevel);
+  }
+};
+
+}// namespace OpenKneeboard
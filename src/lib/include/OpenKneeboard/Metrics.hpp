@@ -0,0 +1,214 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <OpenKneeboard/Histogram.hpp>
+#include <OpenKneeboard/macros.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/** Cheap, always-on aggregate performance metrics.
+ *
+ * Unlike TraceLogging/BinaryTrace, these don't record individual events;
+ * they keep running histograms (timings, in nanoseconds) and counters that
+ * can be inspected at any time, e.g. from the help page.
+ *
+ * Each process has a single `Registry`; the injectables place theirs in
+ * shared memory (see `SHM/Metrics.hpp`) so the app can display them.
+ */
+namespace OpenKneeboard::Metrics {
+
+using Counter = std::atomic<uint64_t>;
+
+struct Snapshot {
+  struct HistogramEntry {
+    std::string mName;
+    Histogram::Summary mSummary;
+  };
+  struct CounterEntry {
+    std::string mName;
+    uint64_t mValue {};
+  };
+
+  std::vector<HistogramEntry> mHistograms;
+  std::vector<CounterEntry> mCounters;
+};
+
+/** Fixed-capacity metric storage.
+ *
+ * Standard-layout and zero-initialized, so it can be placed in shared memory
+ * and read by another process. Names are written before the count is
+ * incremented, so readers only need to look at the first `mHistogramCount`
+ * and `mCounterCount` entries.
+ */
+struct Block final {
+  /// Increment if the layout changes in any way other than its size
+  static constexpr uint32_t LayoutVersion = 2;
+  static constexpr std::size_t MaxHistograms = 64;
+  static constexpr std::size_t MaxCounters = 64;
+  static constexpr std::size_t MaxNameLength = 47;
+
+  using Name = std::array<char, MaxNameLength + 1>;
+
+  struct NamedHistogram {
+    Name mName {};
+    Histogram mHistogram;
+  };
+  struct NamedCounter {
+    Name mName {};
+    Counter mValue {0};
+  };
+
+  std::atomic<uint32_t> mHistogramCount {0};
+  std::atomic<uint32_t> mCounterCount {0};
+  std::array<NamedHistogram, MaxHistograms> mHistograms {};
+  std::array<NamedCounter, MaxCounters> mCounters {};
+
+  void Reset() noexcept;
+  Snapshot GetSnapshot() const;
+};
+static_assert(std::is_standard_layout_v<Block>);
+
+class Registry final {
+ public:
+  static Registry& Get();
+
+  /** Store metrics in `storage` instead of the process heap.
+   *
+   * Call sites cache the pointers they're given, so this fails (returning
+   * false) if any metrics have already been registered. `storage` must
+   * outlive the process' use of metrics.
+   */
+  bool SetStorage(Block* storage);
+
+  /// Returns nullptr if the registry is full
+  Histogram* GetHistogram(std::string_view name);
+  /// Returns nullptr if the registry is full
+  Counter* GetCounter(std::string_view name);
+
+  Snapshot GetSnapshot() const;
+
+ private:
+  Registry();
+
+  mutable std::mutex mMutex;
+  std::unique_ptr<Block> mOwnedBlock;
+  Block* mBlock {nullptr};
+  bool mHaveRegistrations {false};
+};
+
+/// Records the elapsed time in nanoseconds on `Stop()` or destruction
+class ScopedTimer final {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  ScopedTimer() = delete;
+  explicit ScopedTimer(Histogram* histogram) noexcept
+    : mHistogram(histogram) {
+    if (mHistogram) {
+      mStart = Clock::now();
+    }
+  }
+
+  ~ScopedTimer() noexcept { this->Stop(); }
+
+  void Stop() noexcept {
+    if (!mHistogram) {
+      return;
+    }
+    const auto elapsed = Clock::now() - mStart;
+    std::exchange(mHistogram, nullptr)
+      ->Record(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+          .count()));
+  }
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer(ScopedTimer&&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(ScopedTimer&&) = delete;
+
+ private:
+  Histogram* mHistogram {nullptr};
+  Clock::time_point mStart {};
+};
+
+/// Records the time between consecutive `Mark()` calls, in nanoseconds
+class IntervalRecorder final {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit IntervalRecorder(Histogram* histogram) noexcept
+    : mHistogram(histogram) {}
+
+  void Mark() noexcept {
+    if (!mHistogram) {
+      return;
+    }
+    const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       Clock::now().time_since_epoch())
+                       .count();
+    const auto previous = mPrevious.exchange(now, std::memory_order_relaxed);
+    if (previous != 0 && now > previous) {
+      mHistogram->Record(static_cast<uint64_t>(now - previous));
+    }
+  }
+
+ private:
+  Histogram* mHistogram {nullptr};
+  std::atomic<int64_t> mPrevious {0};
+};
+
+/// Human-readable table; histogram values are formatted as durations
+std::string FormatSnapshot(const Snapshot&);
+
+}// namespace OpenKneeboard::Metrics
+
+/** Record the duration of the current scope.
+ *
+ * @param OKM_NAME the name of the histogram (C string literal)
+ */
+#define OPENKNEEBOARD_MetricsScopedTimer(OKM_NAME) \
+  ::OpenKneeboard::Metrics::ScopedTimer OPENKNEEBOARD_CONCAT2( \
+    _okmst, __COUNTER__) { \
+    []() { \
+      static const auto histogram \
+        = ::OpenKneeboard::Metrics::Registry::Get().GetHistogram(OKM_NAME); \
+      return histogram; \
+    }()}
+
+/** Add to a counter.
+ *
+ * @param OKM_NAME the name of the counter (C string literal)
+ */
+#define OPENKNEEBOARD_MetricsCount(OKM_NAME, OKM_VALUE) \
+  do { \
+    static const auto _okmc \
+      = ::OpenKneeboard::Metrics::Registry::Get().GetCounter(OKM_NAME); \
+    if (_okmc) { \
+      _okmc->fetch_add(OKM_VALUE, std::memory_order_relaxed); \
+    } \
+  } while (false)
+
+/** Record the time since this line was last reached.
+ *
+ * Useful for frame pacing.
+ *
+ * @param OKM_NAME the name of the histogram (C string literal)
+ */
+#define OPENKNEEBOARD_MetricsInterval(OKM_NAME) \
+  do { \
+    static ::OpenKneeboard::Metrics::IntervalRecorder _okmir { \
+      ::OpenKneeboard::Metrics::Registry::Get().GetHistogram(OKM_NAME)}; \
+    _okmir.Mark(); \
+  } while (false)
@@ -0,0 +1,77 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <OpenKneeboard/PreferredSize.hpp>
+
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <unordered_map>
+
+namespace OpenKneeboard {
+
+/** Known sizes of a page source's pages.
+ *
+ * Sources fill this in whenever they learn a page's dimensions - e.g. when
+ * loading it - so that later size queries are lookups rather than decoding
+ * or rendering the page again.
+ *
+ * Only use this for pages whose size is fixed until the content changes;
+ * clear it, or erase the page, when that happens.
+ *
+ * This class is not thread-safe.
+ */
+template <class TPageID>
+class PageGeometryTable final {
+ public:
+  [[nodiscard]]
+  std::optional<PreferredSize> Find(TPageID pageID) const {
+    const auto it = mSizes.find(pageID);
+    if (it == mSizes.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+  void Set(TPageID pageID, const PreferredSize& size) {
+    mSizes.insert_or_assign(pageID, size);
+  }
+
+  /** The known size, or measure and store it.
+   *
+   * `measure` is only called if the size isn't already known; if it returns
+   * `std::nullopt`, nothing is stored, and it will be called again next time.
+   */
+  template <std::invocable Measure>
+  std::optional<PreferredSize> FindOrMeasure(
+    TPageID pageID,
+    Measure&& measure) {
+    if (const auto it = mSizes.find(pageID); it != mSizes.end()) {
+      return it->second;
+    }
+    const std::optional<PreferredSize> size = measure();
+    if (size) {
+      mSizes.emplace(pageID, *size);
+    }
+    return size;
+  }
+
+  void Erase(TPageID pageID) {
+    mSizes.erase(pageID);
+  }
+
+  void Clear() {
+    mSizes.clear();
+  }
+
+  [[nodiscard]]
+  std::size_t GetPageCount() const {
+    return mSizes.size();
+  }
+
+ private:
+  std::unordered_map<TPageID, PreferredSize> mSizes;
+};
+
+}// namespace OpenKneeboard
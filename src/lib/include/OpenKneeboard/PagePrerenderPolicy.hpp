@@ -0,0 +1,152 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace OpenKneeboard {
+
+/** Decides which pages to render ahead of time, and where to keep them.
+ *
+ * Pages are kept in a fixed number of equally-sized slots, which fit in
+ * `Options::mBudgetBytes`. In priority order, it keeps:
+ *
+ * - the current page
+ * - the next page in the direction the user last turned
+ * - the page in the other direction
+ * - the page after the next page
+ * - bookmarked pages, nearest first
+ *
+ * Work is only suggested after a quiet period without foreground activity,
+ * and if it is expected to finish before the caller's deadline. Slots are
+ * released entirely if the pages haven't been shown for a while.
+ *
+ * This is pure policy: it has no clock of its own, and doesn't know how pages
+ * are rendered or stored, so that it can be simulated deterministically. It
+ * is not thread-safe.
+ */
+class PagePrerenderPolicy final {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using TimePoint = Clock::time_point;
+  using Duration = std::chrono::nanoseconds;
+  /// e.g. `PageID::GetTemporaryValue()`
+  using PageKey = uint64_t;
+  using SlotIndex = std::size_t;
+
+  struct Options {
+    std::size_t mBudgetBytes {48 * 1024 * 1024};
+    std::size_t mMaxBookmarks {4};
+    /// Don't start work for this long after a page change or repaint
+    Duration mQuietPeriod {std::chrono::milliseconds(250)};
+    /// Release all slots if no page has been shown for this long
+    Duration mReleaseAfter {std::chrono::seconds(10)};
+  };
+
+  struct Lookup {
+    /// If set, `page` can be shown from this slot
+    std::optional<SlotIndex> mSlot;
+    /// False if the same page was shown last time
+    bool mIsPageChange {false};
+  };
+
+  struct Work {
+    PageKey mPage {};
+    /// The previous content of this slot has already been discarded
+    SlotIndex mSlot {};
+    uint64_t mGeneration {};
+  };
+
+  struct Stats {
+    uint64_t mHits {};
+    uint64_t mMisses {};
+    uint64_t mCompleted {};
+    /// Completed, but invalidated while in progress
+    uint64_t mDiscarded {};
+  };
+
+  PagePrerenderPolicy();
+  explicit PagePrerenderPolicy(const Options&);
+
+  /** Set the size of each slot.
+   *
+   * This discards all slots if the size changes; the slot count may change.
+   */
+  void SetSlotBytes(std::size_t);
+  [[nodiscard]]
+  std::size_t GetSlotCount() const;
+
+  /** Record that a page is being shown.
+   *
+   * Call this for every foreground render, whether or not it's a page change.
+   */
+  Lookup ObserveForegroundRender(PageKey, std::size_t pageIndex, TimePoint now);
+
+  /** Discard all slots, e.g. because content changed.
+   *
+   * Any work in progress will also be discarded when completed.
+   */
+  void Invalidate(TimePoint now);
+  /// Discard all slots and forget the slot size
+  void Clear();
+  [[nodiscard]]
+  bool ShouldRelease(TimePoint now) const;
+
+  /** Pick the next page to render, if any.
+   *
+   * There is at most one piece of work in progress; it must be finished
+   * with `CompleteWork()` before more work is suggested.
+   *
+   * @param pages all pages, in order
+   * @param bookmarks bookmarked pages in any order; ones that aren't in
+   *  `pages` are ignored
+   * @param stopAt the work should be done by this time
+   */
+  [[nodiscard]]
+  std::optional<Work> GetNextWork(
+    std::span<const PageKey> pages,
+    std::span<const PageKey> bookmarks,
+    TimePoint now,
+    TimePoint stopAt);
+  /// Returns true if the result should be kept
+  bool CompleteWork(const Work&, Duration elapsed, TimePoint now);
+
+  [[nodiscard]]
+  Stats GetStats() const;
+
+ private:
+  struct Slot {
+    std::optional<PageKey> mPage;
+    TimePoint mLastUsed {};
+  };
+
+  Options mOptions;
+  std::size_t mSlotBytes {};
+  std::vector<Slot> mSlots;
+  /// Incremented to discard work in progress
+  uint64_t mGeneration {};
+  bool mHaveWorkInProgress {false};
+
+  std::optional<PageKey> mCurrentPage;
+  std::size_t mCurrentPageIndex {};
+  /// +1 or -1
+  int mDirection {1};
+  TimePoint mLastForeground {};
+  TimePoint mLastActivity {};
+  /// Smoothed duration of recent work
+  std::optional<Duration> mWorkDuration;
+
+  Stats mStats;
+
+  std::vector<PageKey> GetWantedPages(
+    std::span<const PageKey> pages,
+    std::span<const PageKey> bookmarks) const;
+  std::optional<SlotIndex> FindSlot(PageKey) const;
+};
+
+}// namespace OpenKneeboard
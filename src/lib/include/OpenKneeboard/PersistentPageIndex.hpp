@@ -0,0 +1,121 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <OpenKneeboard/inttypes.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace OpenKneeboard {
+
+/** Identifies a page of a file across sessions.
+ *
+ * The serialized form is the JSON object `{"FileHash":N,"PageIndex":N}`,
+ * byte-for-byte what previous versions wrote, so saved bookmarks still
+ * match.
+ */
+struct PersistentPageID final {
+  uint64_t mFileHash {};
+  PageIndex mPageIndex {};
+
+  [[nodiscard]]
+  std::string Serialize() const;
+
+  /** Parse a serialized ID.
+   *
+   * The canonical form is parsed directly; anything else (e.g. hand-edited
+   * settings) falls back to a full JSON parser.
+   */
+  [[nodiscard]]
+  static std::optional<PersistentPageID> Parse(std::string_view);
+
+  constexpr bool operator==(const PersistentPageID&) const noexcept = default;
+};
+
+/** Bidirectional map between runtime page IDs and persistent page IDs.
+ *
+ * Runtime IDs are only valid until the content changes, so the index should
+ * be rebuilt for each generation of content rather than updated.
+ *
+ * Several pages can have the same persistent ID, e.g. copies of the same
+ * file in a folder; `FindPageID()` returns the first one inserted, matching a
+ * linear search, and `FindPageIDs()` returns all of them.
+ */
+template <class TPageID>
+class PersistentPageIndex final {
+ public:
+  void Clear() {
+    mPersistentIDs.clear();
+    mPageIDs.clear();
+  }
+
+  void Insert(TPageID pageID, std::string persistentID) {
+    const auto it = mPageIDs.try_emplace(std::move(persistentID)).first;
+    auto& pageIDs = it->second;
+    if (!std::ranges::contains(pageIDs, pageID)) {
+      pageIDs.push_back(pageID);
+    }
+    // Nodes are stable, so the key outlives this view until it's erased
+    mPersistentIDs.try_emplace(pageID, it->first);
+  }
+
+  [[nodiscard]]
+  std::optional<std::string_view> FindPersistentID(TPageID pageID) const {
+    const auto it = mPersistentIDs.find(pageID);
+    if (it == mPersistentIDs.end()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+  [[nodiscard]]
+  std::optional<TPageID> FindPageID(std::string_view persistentID) const {
+    const auto pageIDs = this->FindPageIDs(persistentID);
+    if (pageIDs.empty()) {
+      return std::nullopt;
+    }
+    return pageIDs.front();
+  }
+
+  /// In the order they were inserted
+  [[nodiscard]]
+  std::span<const TPageID> FindPageIDs(std::string_view persistentID) const {
+    const auto it = mPageIDs.find(persistentID);
+    if (it == mPageIDs.end()) {
+      return {};
+    }
+    return it->second;
+  }
+
+  [[nodiscard]]
+  std::size_t GetPageCount() const {
+    return mPersistentIDs.size();
+  }
+
+ private:
+  struct StringHash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view value) const noexcept {
+      return std::hash<std::string_view> {}(value);
+    }
+  };
+
+  std::unordered_map<
+    std::string,
+    std::vector<TPageID>,
+    StringHash,
+    std::equal_to<>>
+    mPageIDs;
+  std::unordered_map<TPageID, std::string_view> mPersistentIDs;
+};
+
+}// namespace OpenKneeboard
@@ -0,0 +1,140 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace OpenKneeboard {
+
+/** Splits UTF-8 text into pages of word-wrapped lines.
+ *
+ * Text is made of groups (separated by `\x1d`), which are made of paragraphs
+ * (separated by blank lines), which are made of lines. Groups and paragraphs
+ * are kept on a single page if they fit.
+ *
+ * Layout is incremental: each call to `LayOutNext()` does a bounded amount of
+ * work, so callers can lay out as far as they need, and do the rest later or
+ * in the background. Text can be appended without affecting existing pages.
+ *
+ * Only offsets are stored, so the text must be passed in to each call; this
+ * lets the text live anywhere, e.g. in a memory-mapped file.
+ *
+ * This class is not thread-safe.
+ */
+class PlainTextLayout final {
+ public:
+  struct SourceReference {
+    std::size_t mOffset {};
+    std::size_t mLength {};
+  };
+
+  struct Page {
+    SourceReference mSource;
+    /// Excluding delimiters
+    std::vector<SourceReference> mLines {};
+  };
+
+  PlainTextLayout() = delete;
+  PlainTextLayout(std::size_t columns, std::size_t rows);
+
+  /** Discard anything that may be affected by changing text at or after
+   * `offset`.
+   *
+   * The last page may be kept, but with fewer lines.
+   */
+  void Invalidate(std::size_t offset);
+  void Clear();
+
+  /** Lay out the next unit of `text` - usually a group, or a paragraph or
+   * line of a large group.
+   *
+   * Returns the number of bytes consumed; this is 0 if all of `text` has been
+   * laid out.
+   */
+  std::size_t LayOutNext(std::string_view text);
+
+  /// Returns the number of bytes consumed
+  std::size_t LayOutUntil(std::string_view text, std::size_t pageCount);
+
+  [[nodiscard]]
+  bool IsComplete(std::string_view text) const;
+
+  /** Start a new page at the current end of `text`, if the current page is
+   * not empty.
+   *
+   * This is kept if the layout is later invalidated after this point.
+   */
+  void EnsureNewPage(std::string_view text);
+
+  const std::vector<Page>& GetPages() const;
+
+ private:
+  /// Groups or paragraphs larger than this are laid out in parts
+  static constexpr std::size_t MaxUnitBytes = 64 * 1024;
+  /// e.g. a line break may be the start of a paragraph break (`\r\n\r\n`)
+  static constexpr std::size_t DelimiterLookaheadBytes = 3;
+
+  enum class State {
+    /// At the start of a group
+    Group,
+    /// At the start of a paragraph in a group larger than `MaxUnitBytes`
+    Paragraph,
+    /// At the start of a line in a paragraph larger than `MaxUnitBytes`
+    Line,
+  };
+
+  /// A position where layout can be resumed from
+  struct Checkpoint {
+    std::size_t mOffset {};
+    State mState {};
+    /// The state may depend on text after `mOffset`
+    std::size_t mDependsOnTextUntil {};
+    std::size_t mPageCount {};
+    std::size_t mLastPageLineCount {};
+  };
+
+  std::size_t mColumns {};
+  std::size_t mRows {};
+
+  std::vector<Page> mPages;
+  std::size_t mOffset {};
+  State mState {State::Group};
+  /// `Paragraph` and `Line` states are chosen by looking ahead
+  std::size_t mStateDependsOnTextUntil {};
+  /** After each delimiter.
+   *
+   * Units that are ended by the end of the text rather than a delimiter are
+   * not complete: appending text may extend them.
+   */
+  std::vector<Checkpoint> mCheckpoints;
+  /// Offsets of page breaks requested by `EnsureNewPage()`
+  std::vector<std::size_t> mPageBreaks;
+  std::size_t mAppliedPageBreaks {};
+
+  void Reset();
+  void ApplyPageBreaks(std::size_t offset);
+
+  std::size_t GetRemainingRows() const;
+  void PushPage(std::size_t offset);
+  void AddCheckpoint(std::string_view);
+
+  // These are templates so that the implementation details of the source
+  // structure can stay in the .cpp
+  template <class T>
+  void AppendLines(T&& sourceLines);
+  template <class T>
+  void AppendWrappedLines(const T& wrappedLines);
+  template <class TParagraph>
+  void LayOutParagraph(const TParagraph&);
+  template <class TLine>
+  void LayOutLine(const TLine&);
+
+  /// `end` is the end of the content, `next` is after any delimiter
+  void LayOutGroup(std::string_view, std::size_t end, std::size_t next);
+  void LayOutParagraphs(std::string_view, std::size_t end, std::size_t next);
+  void LayOutNextLine(std::string_view);
+};
+
+}// namespace OpenKneeboard
@@ -0,0 +1,152 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <OpenKneeboard/Metrics.hpp>
+#include <OpenKneeboard/Pixels.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace OpenKneeboard {
+
+/// Why something needs repainting; used for diagnostics
+enum class RepaintReason : uint8_t {
+  Other,
+  Settings,
+  ViewLayout,
+  ActiveView,
+  UserAction,
+  Visibility,
+  ConsumerResize,
+  TabContent,
+  UILayer,
+  Cursor,
+  AppWindow,
+};
+constexpr std::size_t RepaintReasonCount
+  = static_cast<std::size_t>(RepaintReason::AppWindow) + 1;
+
+std::string_view GetRepaintReasonName(RepaintReason) noexcept;
+
+enum class RepaintPriority : uint8_t {
+  /// Can wait for the next scheduled frame, e.g. a clock ticking
+  Background,
+  /// Should be shown in the next frame that a consumer displays
+  Normal,
+  /// A direct response to input, e.g. moving the cursor
+  Interactive,
+};
+
+struct RepaintRequest {
+  static constexpr uint64_t AllViews = 0;
+
+  /// `KneeboardViewID::GetTemporaryValue()`, or `AllViews`
+  uint64_t mView {AllViews};
+  /// Relative to the view; `std::nullopt` or empty means the whole view
+  std::optional<PixelRect> mRegion {};
+  RepaintPriority mPriority {RepaintPriority::Normal};
+  RepaintReason mReason {RepaintReason::Other};
+};
+
+/** Collects repaint requests until the renderer is ready for them.
+ *
+ * Requests are merged as they're posted, so however many arrive between two
+ * frames, the renderer gets at most one entry per view: the union of the
+ * requested regions, the highest priority, and every reason.
+ *
+ * For each reason, the number of requests, of requests that were coalesced
+ * into an already-pending repaint, and of frames that included the reason are
+ * recorded in the metrics registry, as 'Repaint requests: REASON' etc.
+ *
+ * This class is thread-safe.
+ */
+class RepaintRequestBus final {
+ public:
+  /// Bit `i` is set if `RepaintReason(i)` was requested
+  using ReasonMask = uint32_t;
+  static_assert(RepaintReasonCount <= sizeof(ReasonMask) * 8);
+
+  static constexpr ReasonMask GetReasonBit(RepaintReason reason) noexcept {
+    return ReasonMask {1} << static_cast<uint8_t>(reason);
+  }
+
+  struct ViewRepaint {
+    uint64_t mView {};
+    /// Bounding box of the requested regions; `std::nullopt` if the whole
+    /// view needs repainting
+    std::optional<PixelRect> mRegion {};
+    RepaintPriority mPriority {};
+    ReasonMask mReasons {};
+  };
+
+  /// Everything that was requested since the previous frame
+  struct Frame {
+    /// If set, every view needs repainting, whether or not it's in `mViews`
+    bool mAllViews {false};
+    /// `std::nullopt` if nothing was requested
+    std::optional<RepaintPriority> mPriority;
+    ReasonMask mReasons {};
+    /// In the order that views were first requested
+    std::vector<ViewRepaint> mViews;
+
+    [[nodiscard]]
+    bool IsEmpty() const noexcept {
+      return !mPriority;
+    }
+
+    [[nodiscard]]
+    const ViewRepaint* Find(uint64_t view) const noexcept;
+
+    /// Whether any part of `view` needs repainting
+    [[nodiscard]]
+    bool Includes(uint64_t view) const noexcept {
+      return mAllViews || this->Find(view);
+    }
+  };
+
+  /** Add a request to the pending frame.
+   *
+   * If this raised the pending frame's priority - including from nothing
+   * pending at all - returns the new priority; otherwise returns
+   * `std::nullopt`, as whoever raised it last has already been told.
+   */
+  [[nodiscard]]
+  std::optional<RepaintPriority> Post(const RepaintRequest&);
+
+  [[nodiscard]]
+  bool HasPending() const;
+
+  /** Move the pending requests into `frame`, and start a new frame.
+   *
+   * `frame`'s previous contents are discarded, but its storage is reused for
+   * the next frame's requests, so callers that keep their `Frame` around
+   * don't allocate in steady state.
+   */
+  void TakeFrame(Frame& frame);
+
+ private:
+  struct ReasonMetrics {
+    bool mRegistered {false};
+    /// Calls to `Post()`
+    Metrics::Counter* mRequests {nullptr};
+    /// Requests for views that already had a pending request
+    Metrics::Counter* mCoalesced {nullptr};
+    /// Frames taken that included this reason
+    Metrics::Counter* mFrames {nullptr};
+  };
+
+  mutable std::mutex mMutex;
+  Frame mPending;
+  std::array<ReasonMetrics, RepaintReasonCount> mMetrics {};
+
+  /// Callers must hold `mMutex`
+  ReasonMetrics& GetMetrics(RepaintReason);
+};
+
+}// namespace OpenKneeboard
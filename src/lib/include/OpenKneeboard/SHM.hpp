@@ -138,6 +138,8 @@ struct Frame : felly::non_copyable {
   int64_t mFenceIn {};
 
   uint8_t mIndex {};
+  /// Increases with each frame submitted by the feeder
+  uint64_t mFrameNumber {};
 };
 
 enum class ReaderState;
@@ -151,6 +153,8 @@ class Reader {
 
   operator bool() const;
   uint64_t GetFrameCountForMetricsOnly() const;
+  /// Only valid if the reader is valid, i.e. `operator bool()` is true
+  ConsumerKind GetConsumerKind() const;
 
   std::expected<Frame, Frame::Error> MaybeGet();
 
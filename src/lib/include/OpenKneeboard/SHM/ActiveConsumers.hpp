@@ -8,8 +8,10 @@
 
 #include <OpenKneeboard/Pixels.hpp>
 #include <OpenKneeboard/SHM.hpp>
+#include <OpenKneeboard/SHM/ConsumerTelemetry.hpp>
 
 #include <chrono>
+#include <optional>
 
 namespace OpenKneeboard::SHM {
 struct ActiveConsumers final {
@@ -40,6 +42,11 @@ struct ActiveConsumers final {
   static void SetNonVRPixelSize(PixelSize px);
   static void SetActiveInGameViewID(uint64_t);
 
+  /// Publish a frame from this process; see `ConsumerTelemetry`
+  static void RecordFrame(ConsumerKind, const ConsumerTelemetry::FrameSample&);
+  static std::optional<ConsumerTelemetry::Snapshot> GetTelemetry(
+    ConsumerKind);
+
  private:
   class Impl;
 };
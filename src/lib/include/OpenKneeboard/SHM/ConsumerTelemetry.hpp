@@ -0,0 +1,103 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <OpenKneeboard/Histogram.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+
+namespace OpenKneeboard::SHM {
+
+/** How one consumer (e.g. a game, or the viewer) is using the SHM frames.
+ *
+ * This lives in the `ActiveConsumers` shared memory segment, with one slot
+ * per `ConsumerKind`. It's standard-layout, zero-initialized - which means
+ * 'no data' - and only contains lock-free atomics, so it needs no locks
+ * across processes.
+ *
+ * Each slot has one writer at a time: the first process to record a frame
+ * owns the slot until it stops recording for `StaleAfter`; samples from
+ * other processes of the same kind are dropped until then.
+ *
+ * The scalar fields are published together under a sequence lock, so
+ * readers always see values from the same frame; the processing time
+ * histogram is updated independently.
+ */
+class ConsumerTelemetry final {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /// Bumped whenever the meaning of the fields changes
+  static constexpr uint32_t Version = 1;
+  static constexpr auto StaleAfter = std::chrono::seconds(1);
+
+  struct FrameSample {
+    /// When the consumer started processing the frame
+    Clock::time_point mStartTime {};
+    Clock::time_point mEndTime {};
+    /// `SHM::Frame::mFrameNumber`
+    uint64_t mSHMFrameNumber {};
+    /// Bit `i` is set if layer `i` of the SHM frame was displayed
+    uint32_t mVisibleLayers {};
+  };
+
+  struct Snapshot {
+    uint32_t mProcessID {};
+    uint64_t mFrameCount {};
+    Clock::time_point mLastFrameTime {};
+    /// Exponential moving average of the time between frames
+    std::chrono::nanoseconds mFrameInterval {};
+    uint64_t mLastSHMFrameNumber {};
+    /// Frames where the SHM had a new frame since the consumer's last frame
+    uint64_t mFetchedFrameCount {};
+    /// Frames where the consumer reused the previous SHM frame
+    uint64_t mReusedFrameCount {};
+    uint32_t mVisibleLayers {};
+    /// Nanoseconds
+    Histogram::Summary mProcessingTime {};
+  };
+
+  /** Publish a consumer's frame.
+   *
+   * Returns false if the sample was dropped, as another process owns this
+   * slot, or another thread is publishing at the same time.
+   */
+  bool RecordFrame(uint32_t processID, const FrameSample&) noexcept;
+
+  /** The most recently published data.
+   *
+   * Returns `std::nullopt` if nothing has been published, or it was
+   * published by an incompatible version.
+   */
+  [[nodiscard]]
+  std::optional<Snapshot> GetSnapshot() const noexcept;
+
+  /// Not atomic with respect to concurrent `RecordFrame()` calls
+  void Reset() noexcept;
+
+ private:
+  std::atomic<uint32_t> mVersion {0};
+  std::atomic<uint32_t> mProcessID {0};
+  /// Odd while a writer is updating the fields below
+  std::atomic<uint64_t> mSequence {0};
+
+  std::atomic<uint64_t> mFrameCount {0};
+  std::atomic<int64_t> mLastFrameTime {0};
+  std::atomic<int64_t> mFrameInterval {0};
+  std::atomic<uint64_t> mLastSHMFrameNumber {0};
+  std::atomic<uint64_t> mFetchedFrameCount {0};
+  std::atomic<uint64_t> mReusedFrameCount {0};
+  std::atomic<uint32_t> mVisibleLayers {0};
+
+  Histogram mProcessingTime;
+};
+static_assert(std::is_standard_layout_v<ConsumerTelemetry>);
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+static_assert(std::atomic<int64_t>::is_always_lock_free);
+
+}// namespace OpenKneeboard::SHM
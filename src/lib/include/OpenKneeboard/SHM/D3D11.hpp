@@ -22,6 +22,7 @@ struct Frame {
   ID3D11ShaderResourceView* mShaderResourceView {};
   ID3D11Fence* mFence {};
   uint64_t mFenceIn {};
+  uint64_t mFrameNumber {};
 };
 
 class Reader final : public SHM::Reader {
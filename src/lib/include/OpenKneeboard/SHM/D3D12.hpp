@@ -29,6 +29,7 @@ struct Frame {
 
   ID3D12Fence* mFence {};
   uint64_t mFenceIn {};
+  uint64_t mFrameNumber {};
 };
 
 class Reader final : public SHM::Reader {
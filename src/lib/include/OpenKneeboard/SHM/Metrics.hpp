@@ -0,0 +1,35 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <OpenKneeboard/Metrics.hpp>
+
+#include <Windows.h>
+
+#include <string>
+#include <vector>
+
+/** Share `Metrics` from other processes (e.g. games) with the app.
+ *
+ * The shared memory segment has a fixed number of slots; each publishing
+ * process claims one, reusing slots from processes that have exited.
+ */
+namespace OpenKneeboard::SHM::Metrics {
+
+struct ProcessMetrics {
+  DWORD mProcessID {};
+  std::string mExecutable;
+  OpenKneeboard::Metrics::Snapshot mSnapshot;
+};
+
+/** Store this process' metrics in shared memory.
+ *
+ * This must be called before any metrics are recorded; returns false if
+ * that's not the case, or no slot is available.
+ */
+bool Publish();
+
+/// Metrics from all live publishing processes
+std::vector<ProcessMetrics> GetPublished();
+
+}// namespace OpenKneeboard::SHM::Metrics
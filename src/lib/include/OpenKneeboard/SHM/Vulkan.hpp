@@ -25,6 +25,7 @@ struct Frame {
 
   VkSemaphore mSemaphore {};
   uint64_t mSemaphoreIn {};
+  uint64_t mFrameNumber {};
 };
 
 struct InstanceCreateInfo
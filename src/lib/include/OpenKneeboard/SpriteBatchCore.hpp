@@ -0,0 +1,198 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <OpenKneeboard/Pixels.hpp>
+#include <OpenKneeboard/Shaders/SpriteBatch.hpp>
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <vector>
+
+namespace OpenKneeboard {
+
+/** Graphics-API-neutral batching shared by the D3D11, D3D12, and Vulkan
+ * `SpriteBatch` classes.
+ *
+ * Each `Draw()` call becomes a single compact `Instance`; sprites that share
+ * a source texture *and* source rect share a `Source` slot, so backends with
+ * descriptor indexing only need one descriptor per distinct source.
+ *
+ * Sprites are never reordered: overlapping translucent sprites depend on
+ * submission order. Backends without descriptor indexing should use
+ * `ForEachSourceRun()` to get one draw call per consecutive run of sprites
+ * with the same source.
+ *
+ * The previous batch is kept, so backends can skip re-uploading buffers
+ * when a frame is identical to the previous one - this is common, as we
+ * usually redraw the same layout every frame.
+ */
+template <class TSource>
+class SpriteBatchCore final {
+ public:
+  using Color = std::array<float, 4>;
+
+  struct Source {
+    TSource mSource {};
+    PixelSize mSize {};
+    /// The source rect of every sprite using this slot; used for clamping
+    PixelRect mRect {};
+
+    constexpr bool operator==(const Source&) const noexcept = default;
+  };
+
+  /// Uploaded as-is as per-instance vertex data by the D3D12 and Vulkan
+  /// backends
+  using Instance = Shaders::SpriteBatch::Instance;
+
+  void Draw(
+    TSource source,
+    const PixelSize& sourceSize,
+    const PixelRect& sourceRect,
+    const PixelRect& destRect,
+    const Color& color) {
+    const Source slot {source, sourceSize, sourceRect};
+    auto it = std::ranges::find(mCurrent.mSources, slot);
+    if (it == mCurrent.mSources.end()) {
+      mCurrent.mSources.push_back(slot);
+      it = mCurrent.mSources.end() - 1;
+    }
+
+    mCurrent.mInstances.push_back({
+      .mSourceRect = ToFloatRect(sourceRect),
+      .mDestRect = ToFloatRect(destRect),
+      .mColor = color,
+      .mSourceIndex
+      = static_cast<uint32_t>(std::distance(mCurrent.mSources.begin(), it)),
+    });
+  }
+
+  [[nodiscard]]
+  bool IsEmpty() const noexcept {
+    return mCurrent.mInstances.empty();
+  }
+
+  std::span<const Source> GetSources() const noexcept {
+    return mCurrent.mSources;
+  }
+
+  std::span<const Instance> GetInstances() const noexcept {
+    return mCurrent.mInstances;
+  }
+
+  /// True if the current batch has the same sources and instances as the last
+  [[nodiscard]]
+  bool IsSameAsPreviousBatch() const noexcept {
+    return mCurrent.mSources == mPrevious.mSources
+      && mCurrent.mInstances == mPrevious.mInstances;
+  }
+
+  /// Finish the current batch, keeping it for `IsSameAsPreviousBatch()`
+  void EndBatch() noexcept {
+    std::swap(mCurrent, mPrevious);
+    mCurrent.mSources.clear();
+    mCurrent.mInstances.clear();
+  }
+
+  /// Forget the previous batch, e.g. if the GPU buffers were recreated
+  void InvalidatePreviousBatch() noexcept {
+    mPrevious.mSources.clear();
+    mPrevious.mInstances.clear();
+  }
+
+  /** Invoke `f(source, firstInstanceIndex, instanceCount)` for each run of
+   * consecutive instances with the same source texture.
+   */
+  template <std::invocable<const Source&, std::size_t, std::size_t> F>
+  void ForEachSourceRun(F&& f) const {
+    const auto& instances = mCurrent.mInstances;
+    const auto& sources = mCurrent.mSources;
+    std::size_t first = 0;
+    for (std::size_t i = 1; i <= instances.size(); ++i) {
+      if (
+        i < instances.size()
+        && sources.at(instances.at(i).mSourceIndex).mSource
+          == sources.at(instances.at(first).mSourceIndex).mSource) {
+        continue;
+      }
+      f(sources.at(instances.at(first).mSourceIndex), first, i - first);
+      first = i;
+    }
+  }
+
+ private:
+  struct Batch {
+    std::vector<Source> mSources;
+    std::vector<Instance> mInstances;
+  };
+  Batch mCurrent;
+  Batch mPrevious;
+
+  static constexpr std::array<float, 4> ToFloatRect(
+    const PixelRect& rect) noexcept {
+    return {
+      rect.Left<float>(),
+      rect.Top<float>(),
+      rect.Right<float>(),
+      rect.Bottom<float>(),
+    };
+  }
+};
+
+namespace SpriteBatchVertices {
+
+/// `{left, top, right, bottom}` texture clamp, in normalized coordinates
+constexpr std::array<float, 4> GetSourceClamp(
+  const PixelSize& sourceSize,
+  const PixelRect& sourceRect) noexcept {
+  return {
+    (sourceRect.Left<float>() + 0.5f) / sourceSize.Width(),
+    (sourceRect.Top<float>() + 0.5f) / sourceSize.Height(),
+    (sourceRect.Right<float>() - 0.5f) / sourceSize.Width(),
+    (sourceRect.Bottom<float>() - 0.5f) / sourceSize.Height(),
+  };
+}
+
+/** CPU equivalent of the corner selection in the vertex shaders.
+ *
+ * Returns `{x, y}` from a `{left, top, right, bottom}` rect for the
+ * `vertexIndex`th vertex of a sprite.
+ */
+constexpr std::array<float, 2> GetCorner(
+  const std::array<float, 4>& rect,
+  const std::size_t vertexIndex) noexcept {
+  const auto& corner = Shaders::SpriteBatch::SpriteCorners.at(vertexIndex);
+  return {
+    corner[0] ? rect[2] : rect[0],
+    corner[1] ? rect[3] : rect[1],
+  };
+}
+
+/// Build the uniform buffer for the `SpriteBatch.hlsl` shaders
+template <class TSource>
+Shaders::SpriteBatch::UniformBuffer GetUniformBuffer(
+  const SpriteBatchCore<TSource>& batch,
+  const PixelSize& targetSize) {
+  Shaders::SpriteBatch::UniformBuffer ret {
+    .mTargetDimensions
+    = {targetSize.Width<float>(), targetSize.Height<float>()},
+  };
+  const auto sources = batch.GetSources();
+  for (std::size_t i = 0; i < sources.size(); ++i) {
+    const auto& source = sources[i];
+    ret.mSourceDimensions[i] = {
+      source.mSize.template Width<float>(),
+      source.mSize.template Height<float>(),
+    };
+    ret.mSourceClamp[i] = GetSourceClamp(source.mSize, source.mRect);
+  }
+  return ret;
+}
+
+}// namespace SpriteBatchVertices
+
+}// namespace OpenKneeboard
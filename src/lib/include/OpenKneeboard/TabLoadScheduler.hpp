@@ -0,0 +1,89 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace OpenKneeboard {
+
+/** Decides which configured tabs to load next, and records when they loaded.
+ *
+ * Tabs are started in configuration order, with at most `maxConcurrency`
+ * loading at once; they may finish in any order. A tab that fails doesn't
+ * affect the others.
+ *
+ * This is pure policy: it has no clock of its own, and doesn't know how tabs
+ * are loaded, so that it can be simulated deterministically. It is not
+ * thread-safe.
+ */
+class TabLoadScheduler final {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using TimePoint = Clock::time_point;
+  using Index = std::size_t;
+
+  enum class State {
+    Queued,
+    Loading,
+    Loaded,
+    Failed,
+  };
+
+  struct Entry {
+    std::string mTitle;
+    std::string mType;
+
+    State mState {State::Queued};
+    TimePoint mStartedAt {};
+    TimePoint mFinishedAt {};
+    /// Only set for `State::Failed`
+    std::string mError {};
+  };
+
+  TabLoadScheduler() = delete;
+  TabLoadScheduler(
+    std::vector<Entry> tabs,
+    std::size_t maxConcurrency,
+    TimePoint now);
+
+  /// Returns nullopt if all tabs have started, or too many are loading
+  [[nodiscard]]
+  std::optional<Index> StartNext(TimePoint now);
+  /// Ignored if the tab isn't loading
+  void MarkLoaded(Index, TimePoint now);
+  void MarkFailed(Index, TimePoint now, std::string error);
+
+  [[nodiscard]]
+  bool IsComplete() const;
+  /// Indices of loaded tabs, in configuration order
+  [[nodiscard]]
+  std::vector<Index> GetLoaded() const;
+
+  [[nodiscard]]
+  std::span<const Entry> GetEntries() const;
+  [[nodiscard]]
+  std::size_t GetMaxConcurrency() const;
+  [[nodiscard]]
+  TimePoint GetCreatedAt() const;
+  /// When the last tab finished; nullopt if some are still queued or loading
+  [[nodiscard]]
+  std::optional<TimePoint> GetCompletedAt() const;
+
+ private:
+  std::vector<Entry> mEntries;
+  std::size_t mMaxConcurrency {};
+  TimePoint mCreatedAt {};
+
+  Index mNextIndex {0};
+  std::size_t mLoadingCount {0};
+  std::size_t mFinishedCount {0};
+
+  Entry& Finish(Index, TimePoint now, State);
+};
+
+}// namespace OpenKneeboard
@@ -0,0 +1,117 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstddef>
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace OpenKneeboard {
+
+/** An incrementally-maintained inverted index over lines of text.
+ *
+ * Lines are identified by (page, line), and must be added in order; this
+ * matches how text is laid out, so appending text never requires
+ * reindexing existing lines. If earlier text changes, callers discard the
+ * affected lines with `Truncate()`, then add the new lines.
+ *
+ * Tokenization and case folding are left to the caller, and must be the
+ * same for indexed text and queries.
+ *
+ * Phrases only match within a single line.
+ */
+class TextSearchIndex final {
+ public:
+  struct Location {
+    std::size_t mPage {};
+    std::size_t mLine {};
+
+    constexpr auto operator<=>(const Location&) const noexcept = default;
+  };
+
+  enum class LastTerm {
+    Exact,
+    /// Match any token starting with the last term, e.g. for search as you
+    /// type
+    Prefix,
+  };
+
+  /// `tokens` must already be folded
+  void AddLine(
+    std::size_t page,
+    std::size_t line,
+    std::span<const std::string_view> tokens);
+  /// Remove `first` and all later lines
+  void Truncate(const Location& first);
+  void Clear();
+
+  /** Find lines containing `terms` as a phrase, in document order.
+   *
+   * Each line is included at most once.
+   */
+  [[nodiscard]]
+  std::vector<Location> Find(
+    std::span<const std::string_view> terms,
+    LastTerm = LastTerm::Exact,
+    std::size_t maxResults = std::numeric_limits<std::size_t>::max()) const;
+
+ private:
+  using TokenID = uint32_t;
+  /// Index into `mOccurrences`
+  using OccurrenceID = uint32_t;
+
+  struct Line {
+    std::size_t mPage {};
+    std::size_t mLine {};
+    OccurrenceID mFirstOccurrence {};
+  };
+
+  struct StringHash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view s) const noexcept {
+      return std::hash<std::string_view> {}(s);
+    }
+  };
+
+  /// For exact lookups
+  std::unordered_map<std::string, TokenID, StringHash, std::equal_to<>>
+    mTokenIDs;
+  /// Sorted, for prefix lookups
+  std::map<std::string_view, TokenID> mVocabulary;
+  /// Indexed by TokenID; keys in `mTokenIDs`
+  std::vector<std::string_view> mTokenNames;
+  /// Indexed by TokenID; ascending
+  std::vector<std::vector<OccurrenceID>> mPostings;
+  /// Every indexed token, in document order
+  std::vector<TokenID> mOccurrences;
+  /// Lines that contain at least one token, in document order
+  std::vector<Line> mLines;
+
+  using LineIterator = std::vector<Line>::const_iterator;
+
+  TokenID GetOrAddToken(std::string_view);
+  /** Find the line containing an occurrence.
+   *
+   * Searches forward from `hint`, which must not be after the result; this
+   * makes walking occurrences in document order cheap.
+   */
+  LineIterator FindLine(OccurrenceID, LineIterator hint) const;
+  OccurrenceID GetLineEnd(LineIterator) const;
+
+  std::vector<Location> FindPrefix(std::string_view, std::size_t maxResults)
+    const;
+  std::vector<Location> FindPhrase(
+    std::span<const std::string_view> terms,
+    LastTerm,
+    std::size_t maxResults) const;
+};
+
+}// namespace OpenKneeboard
@@ -0,0 +1,113 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace OpenKneeboard {
+
+/** Accounting and eviction for a process-wide pool of cache textures.
+ *
+ * Each entry is a texture that's either in use by a cache, or free for
+ * reuse. Textures are bucketed into size classes, so that a free texture can
+ * be reused for any size that fits in it.
+ *
+ * When the pool is over budget, free entries are evicted first, then
+ * entries in use, least-recently-used first; it can go over budget if a
+ * single entry is larger than the budget.
+ *
+ * This only tracks IDs and sizes; the caller owns the textures. It is not
+ * thread-safe.
+ */
+class TexturePoolPolicy final {
+ public:
+  using EntryID = uint64_t;
+
+  struct SizeClass {
+    uint32_t mWidth {};
+    uint32_t mHeight {};
+
+    constexpr bool operator==(const SizeClass&) const noexcept = default;
+  };
+  static constexpr uint32_t SizeClassGranularity = 128;
+  /// Round up to a multiple of `SizeClassGranularity`
+  static SizeClass GetSizeClass(uint32_t width, uint32_t height);
+
+  struct Allocation {
+    EntryID mID {};
+    /// If false, this is a new entry, and the caller must create a texture
+    bool mIsReused {false};
+    /// The caller must destroy these; never includes `mID`
+    std::vector<EntryID> mEvicted;
+  };
+
+  struct Stats {
+    uint64_t mHits {};
+    uint64_t mMisses {};
+    /// Misses that reused a free texture
+    uint64_t mReuses {};
+    uint64_t mEvictions {};
+
+    std::size_t mEntryCount {};
+    std::size_t mUsedBytes {};
+    /// Included in `mUsedBytes`
+    std::size_t mFreeBytes {};
+  };
+
+  TexturePoolPolicy() = delete;
+  explicit TexturePoolPolicy(std::size_t budgetBytes);
+
+  /// Returns entries that the caller must destroy
+  [[nodiscard]]
+  std::vector<EntryID> SetBudget(std::size_t bytes);
+  [[nodiscard]]
+  std::size_t GetBudget() const;
+
+  /** Get a texture for a cache miss.
+   *
+   * @param bytes the size of a texture of this size class
+   */
+  [[nodiscard]]
+  Allocation Allocate(SizeClass, std::size_t bytes);
+
+  /** Mark an entry as recently used, for a cache hit.
+   *
+   * Returns false if the entry no longer exists, e.g. because it was
+   * evicted; this doesn't count as a hit.
+   */
+  bool Touch(EntryID);
+  /// The owner no longer needs the texture, but it can be reused
+  void Release(EntryID);
+  /// The texture has been destroyed, or creating it failed
+  void Remove(EntryID);
+
+  [[nodiscard]]
+  Stats GetStats() const;
+
+ private:
+  struct Entry {
+    EntryID mID {};
+    SizeClass mSizeClass {};
+    std::size_t mBytes {};
+    bool mIsFree {false};
+  };
+
+  std::size_t mBudget {};
+  EntryID mNextID {1};
+  /** Least-recently-used first.
+   *
+   * Free entries are always at the front, as they're moved to the front when
+   * released, and entries are moved to the back when used.
+   */
+  std::list<Entry> mEntries;
+  std::unordered_map<EntryID, std::list<Entry>::iterator> mEntriesByID;
+  Stats mStats;
+
+  std::vector<EntryID> EvictOverBudget(EntryID keep);
+};
+
+}// namespace OpenKneeboard
@@ -0,0 +1,111 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace OpenKneeboard {
+
+/** Small encoded images of pages, e.g. for navigation previews.
+ *
+ * There is at most one thumbnail per page and size; if the page's content
+ * hash doesn't match, the thumbnail is stale, and is discarded. When over
+ * budget, the least-recently-used thumbnails are evicted.
+ *
+ * The encoding is up to the caller; this only stores bytes. The store can be
+ * serialized to persist it between runs.
+ *
+ * This is not thread-safe.
+ */
+class ThumbnailStore final {
+ public:
+  using Bytes = std::vector<std::byte>;
+
+  struct Key {
+    /// A page identity that's stable between runs
+    std::string mPage;
+    /// Changes whenever the page's content changes
+    uint64_t mContentHash {};
+    uint32_t mWidth {};
+    uint32_t mHeight {};
+
+    bool operator==(const Key&) const noexcept = default;
+  };
+
+  struct Stats {
+    uint64_t mHits {};
+    uint64_t mMisses {};
+    /// Misses where the thumbnail existed, but for different content
+    uint64_t mStale {};
+    uint64_t mEvictions {};
+
+    std::size_t mEntryCount {};
+    std::size_t mBytes {};
+  };
+
+  ThumbnailStore() = delete;
+  explicit ThumbnailStore(std::size_t budgetBytes);
+
+  /// A content hash that is stable between runs, unlike `std::hash`
+  [[nodiscard]]
+  static uint64_t HashContent(std::string_view);
+
+  /// Returns nullptr if there's no thumbnail for this content
+  [[nodiscard]]
+  std::shared_ptr<const Bytes> Find(const Key&);
+  /// Replaces any existing thumbnail of the same page and size
+  void Insert(Key, Bytes);
+  void Clear();
+
+  [[nodiscard]]
+  Stats GetStats() const;
+  /// Incremented by every change that affects `Serialize()`
+  [[nodiscard]]
+  uint64_t GetGeneration() const;
+
+  [[nodiscard]]
+  std::string Serialize() const;
+  /** Replace the contents with previously-serialized data.
+   *
+   * Returns false and leaves the store empty if the data is invalid, or from
+   * an incompatible version.
+   */
+  bool Deserialize(std::string_view);
+
+ private:
+  // At most one thumbnail per page and size
+  struct Slot {
+    std::string mPage;
+    uint32_t mWidth {};
+    uint32_t mHeight {};
+
+    bool operator==(const Slot&) const noexcept = default;
+  };
+  struct SlotHash {
+    std::size_t operator()(const Slot&) const noexcept;
+  };
+  struct Entry {
+    Slot mSlot;
+    uint64_t mContentHash {};
+    std::shared_ptr<const Bytes> mBytes;
+  };
+
+  std::size_t mBudget {};
+  uint64_t mGeneration {};
+  Stats mStats;
+  /// Least-recently-used first
+  std::list<Entry> mEntries;
+  std::unordered_map<Slot, std::list<Entry>::iterator, SlotHash> mIndex;
+
+  void Erase(std::list<Entry>::iterator);
+  void EvictOverBudget();
+};
+
+}// namespace OpenKneeboard
@@ -0,0 +1,53 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <OpenKneeboard/DirtyRegion.hpp>
+#include <OpenKneeboard/Pixels.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace OpenKneeboard {
+
+/** Finds which parts of an image changed since the last call.
+ *
+ * The image is split into square tiles, and a hash is kept for each tile;
+ * tiles with a different hash to the previous image are reported as dirty.
+ * The hashes are calculated elsewhere, e.g. by `TileHash.hlsl` on the GPU, so
+ * that only the hashes need to be read back, not the image.
+ *
+ * This is a fallback for when the image source can't tell us what changed.
+ */
+class TileHashChangeDetector final {
+ public:
+  /// Must match `TILE_SIZE` in TileHash.hlsl
+  static constexpr uint32_t TileSize = 64;
+
+  /// Columns and rows of tiles needed to cover an image of `size`
+  static constexpr PixelSize GetTileGrid(const PixelSize& size) noexcept {
+    return {
+      (size.mWidth + TileSize - 1) / TileSize,
+      (size.mHeight + TileSize - 1) / TileSize,
+    };
+  }
+
+  /** Compare tile hashes with the previous call's, and return the tiles that
+   * changed.
+   *
+   * `hashes` are in row-major order, one per tile of `GetTileGrid(size)`.
+   *
+   * If the size changed, everything is dirty.
+   */
+  DirtyRegion Update(std::span<const uint64_t> hashes, const PixelSize& size);
+
+  /// Forget the previous image; the next `Update()` will be entirely dirty
+  void Reset();
+
+ private:
+  PixelSize mSize {};
+  std::vector<uint64_t> mHashes;
+};
+
+}// namespace OpenKneeboard
@@ -0,0 +1,97 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace OpenKneeboard {
+
+/** Decide which parts of each VR overlay need updating for a tick.
+ *
+ * Overlays that are backed by a copy of the SHM texture only need a new copy
+ * if the SHM frame or the layer's content parameters changed; if only the
+ * placement changed, updating the overlay transform is enough.
+ *
+ * This only compares values; the caller does the updates. It is not
+ * thread-safe.
+ */
+class VROverlayChangeTracker final {
+ public:
+  /// Identifies a frame produced by the SHM feeder
+  struct FrameID {
+    /// e.g. the address of the mapped texture
+    uint64_t mTexture {};
+    /// The fence value the feeder signals when the frame is ready
+    uint64_t mFenceValue {};
+
+    constexpr bool operator==(const FrameID&) const noexcept = default;
+  };
+
+  /// Anything other than the frame that changes the overlay's texture
+  struct LayerContent {
+    std::array<uint32_t, 4> mSourceRect {};
+    std::array<float, 4> mTint {};
+
+    constexpr bool operator==(const LayerContent&) const noexcept = default;
+  };
+
+  /// Overlay properties that can be changed without a new texture
+  struct LayerPlacement {
+    /// Row-major 3x4 matrix
+    std::array<float, 12> mTransform {};
+    float mWidthInMeters {};
+
+    constexpr bool operator==(const LayerPlacement&) const noexcept = default;
+  };
+
+  struct LayerUpdate {
+    bool mTexture {false};
+    bool mPlacement {false};
+  };
+
+  struct Stats {
+    uint64_t mTextureUpdates {};
+    uint64_t mSkippedTextureUpdates {};
+    uint64_t mPlacementUpdates {};
+    uint64_t mSkippedPlacementUpdates {};
+  };
+
+  VROverlayChangeTracker() = delete;
+  explicit VROverlayChangeTracker(std::size_t layerCount);
+
+  /** Compare a layer against what was last submitted, and record the new
+   * values as submitted.
+   *
+   * If the caller fails to apply the update, it must call `Invalidate()` or
+   * `InvalidateLayer()`.
+   */
+  [[nodiscard]]
+  LayerUpdate Update(
+    std::size_t layerIndex,
+    const FrameID&,
+    const LayerContent&,
+    const LayerPlacement&);
+
+  /// Force a full update of the layer, e.g. because its overlay was recreated
+  void InvalidateLayer(std::size_t layerIndex);
+  /// Force a full update of all layers
+  void Invalidate();
+
+  [[nodiscard]]
+  Stats GetStats() const;
+
+ private:
+  struct Submitted {
+    FrameID mFrame;
+    LayerContent mContent;
+    LayerPlacement mPlacement;
+  };
+  std::vector<std::optional<Submitted>> mLayers;
+  Stats mStats;
+};
+
+}// namespace OpenKneeboard
@@ -12,6 +12,7 @@
 
 #include <OpenKneeboard/Pixels.hpp>
 #include <OpenKneeboard/Shaders/SpriteBatch.hpp>
+#include <OpenKneeboard/SpriteBatchCore.hpp>
 #include <OpenKneeboard/Vulkan/ExtendedCreateInfo.hpp>
 
 namespace OpenKneeboard::Vulkan {
@@ -107,22 +108,17 @@ class SpriteBatch {
   static std::array<VkVertexInputAttributeDescription, 4>
   GetVertexAttributeDescription();
 
-  struct Sprite {
-    VkImageView mSource {nullptr};
-    PixelSize mSourceSize;
-    PixelRect mSourceRect;
-    PixelRect mDestRect;
-    Color mColor;
-  };
+  using UniformBuffer = Shaders::SpriteBatch::UniformBuffer;
+  using Instance = Shaders::SpriteBatch::Instance;
 
   static constexpr auto MaxSpritesPerBatch =
     Shaders::SpriteBatch::MaxSpritesPerBatch;
   static constexpr auto VerticesPerSprite =
     Shaders::SpriteBatch::VerticesPerSprite;
-  static constexpr auto MaxVerticesPerBatch =
-    Shaders::SpriteBatch::MaxVerticesPerBatch;
 
-  std::vector<Sprite> mSprites;
+  SpriteBatchCore<VkImageView> mBatch;
+  // Used to skip re-uploading the uniform buffer for an unchanged batch
+  PixelSize mUploadedTargetDimensions;
 
   void CreatePipeline();
 
@@ -143,10 +139,7 @@ class SpriteBatch {
     Buffer& operator=(Buffer<T>&&) = default;
   };
 
-  using UniformBuffer = Shaders::SpriteBatch::UniformBuffer;
-  using Vertex = Shaders::SpriteBatch::Vertex;
-
-  Buffer<Vertex> mVertexBuffer;
+  Buffer<Instance> mVertexBuffer;
   Buffer<UniformBuffer> mUniformBuffer;
 
   template <class T>
@@ -143,6 +143,16 @@ class DebugPrinter {
     deprecated(
       "Use TroubleshootingStore::GetDPrintDebugLogAsString() instead")]]
   static std::optional<std::string> MaybeGetHistory();
+
+  using LogFileFlusher = std::function<void()>;
+  static void SetLogFileFlusher(const LogFileFlusher&);
+
+  /** Write any buffered messages to the log file, if there is one.
+   *
+   * This exists so that lib/fatal can make sure that the log file is
+   * complete before the process exits.
+   */
+  static void FlushLogFile() noexcept;
 };
 
 namespace detail {
@@ -6,14 +6,18 @@
 // OpenKneeboard repository.
 #pragma once
 
+#include <OpenKneeboard/BinaryTrace.hpp>
 #include <OpenKneeboard/macros.hpp>
 #include <OpenKneeboard/scope_exit.hpp>
 
 #include <Windows.h>
 #include <winmeta.h>
 
+#include <concepts>
 #include <exception>
+#include <memory>
 #include <source_location>
+#include <type_traits>
 
 #include <TraceLoggingActivity.h>
 #include <TraceLoggingProvider.h>
@@ -31,6 +35,15 @@ enum class TraceLoggingEventKeywords {
 
 wchar_t* GetFullPathForCurrentExecutable();
 
+/** Start recording a BinaryTrace if enabled in the registry.
+ *
+ * Recording is enabled by a non-zero `BinaryTraceRecordsPerThread` DWORD in
+ * HKCU or HKLM; HKCU takes precedence. Does nothing if already recording.
+ *
+ * Don't call this from `DllMain()`, as it uses the registry.
+ */
+void EnableBinaryTraceFromRegistry();
+
 #define TraceLoggingThisExecutable() \
   TraceLoggingValue( \
     ::OpenKneeboard::GetFullPathForCurrentExecutable(), "Executable")
@@ -56,6 +69,34 @@ using UncategorizedTraceLoggingThreadActivity = TraceLoggingThreadActivity<
   std::to_underlying(TraceLoggingEventKeywords::Uncategorized),
   WINEVENT_LEVEL_INFO>;
 
+namespace detail {
+/** Non-owning reference to the callable that starts a scoped activity.
+ *
+ * This is only used for the duration of the activity's constructor, so
+ * unlike `std::function`, it never needs to allocate or copy the callable.
+ */
+class TraceLoggingActivityStarter final {
+ public:
+  using Activity = UncategorizedTraceLoggingThreadActivity;
+
+  template <std::invocable<Activity&> F>
+    requires(!std::same_as<std::remove_cvref_t<F>, TraceLoggingActivityStarter>)
+  TraceLoggingActivityStarter(F&& impl) noexcept
+    : mImpl(std::addressof(impl)),
+      mInvoke([](const void* erased, Activity& activity) {
+        (*static_cast<const std::remove_reference_t<F>*>(erased))(activity);
+      }) {}
+
+  void operator()(Activity& activity) const {
+    mInvoke(mImpl, activity);
+  }
+
+ private:
+  const void* mImpl {nullptr};
+  void (*mInvoke)(const void*, Activity&) {nullptr};
+};
+}// namespace detail
+
 /** Create and automatically start and stop a named activity.
  *
  * @param OKBTL_ACTIVITY the local variable to store the activity in
@@ -65,25 +106,16 @@ using UncategorizedTraceLoggingThreadActivity = TraceLoggingThreadActivity<
  *
  * This avoids templates and `auto` and generally jumps through hoops so that it
  * is valid both inside an implementation, and in a class definition.
+ *
+ * The activity is also recorded in the BinaryTrace, if enabled.
  */
 #define OPENKNEEBOARD_TraceLoggingScopedActivity( \
   OKBTL_ACTIVITY, OKBTL_NAME, ...) \
-  const std::function<void( \
-    OpenKneeboard::UncategorizedTraceLoggingThreadActivity&)> \
-    OPENKNEEBOARD_CONCAT2(_StartImpl, OKBTL_ACTIVITY) = \
-      [&, loc = std::source_location::current()]( \
-        OpenKneeboard::UncategorizedTraceLoggingThreadActivity& activity) { \
-        TraceLoggingWriteStart( \
-          activity, \
-          OKBTL_NAME, \
-          OPENKNEEBOARD_TraceLoggingSourceLocation(loc), \
-          ##__VA_ARGS__); \
-      }; \
   class OPENKNEEBOARD_CONCAT2(_Impl, OKBTL_ACTIVITY) final \
     : public OpenKneeboard::UncategorizedTraceLoggingThreadActivity { \
    public: \
     OPENKNEEBOARD_CONCAT2(_Impl, OKBTL_ACTIVITY) \
-    (decltype(OPENKNEEBOARD_CONCAT2(_StartImpl, OKBTL_ACTIVITY))& startImpl) { \
+    (::OpenKneeboard::detail::TraceLoggingActivityStarter startImpl) { \
       startImpl(*this); \
     } \
     OPENKNEEBOARD_CONCAT2(~_Impl, OKBTL_ACTIVITY)() { \
@@ -99,6 +131,7 @@ using UncategorizedTraceLoggingThreadActivity = TraceLoggingThreadActivity<
       } \
       mStopped = true; \
       mAutoStop = false; \
+      mBinaryTraceScope.Stop(); \
       const auto exceptionCount = std::uncaught_exceptions(); \
       if (exceptionCount) [[unlikely]] { \
         TraceLoggingWriteStop( \
@@ -116,9 +149,23 @@ using UncategorizedTraceLoggingThreadActivity = TraceLoggingThreadActivity<
    private: \
     bool mStopped {false}; \
     bool mAutoStop {true}; \
+    ::OpenKneeboard::BinaryTrace::Scope mBinaryTraceScope { \
+      GetBinaryTraceNameID()}; \
+\
+    static ::OpenKneeboard::BinaryTrace::NameID GetBinaryTraceNameID() { \
+      static const auto id = ::OpenKneeboard::BinaryTrace::Intern(OKBTL_NAME); \
+      return id; \
+    } \
   }; \
-  OPENKNEEBOARD_CONCAT2(_Impl, OKBTL_ACTIVITY) \
-  OKBTL_ACTIVITY {OPENKNEEBOARD_CONCAT2(_StartImpl, OKBTL_ACTIVITY)};
+  OPENKNEEBOARD_CONCAT2(_Impl, OKBTL_ACTIVITY) OKBTL_ACTIVITY { \
+    [&, loc = std::source_location::current()]( \
+      OpenKneeboard::UncategorizedTraceLoggingThreadActivity& activity) { \
+      TraceLoggingWriteStart( \
+        activity, \
+        OKBTL_NAME, \
+        OPENKNEEBOARD_TraceLoggingSourceLocation(loc), \
+        ##__VA_ARGS__); \
+    }};
 
 // Not using templates as they're not permitted in local classes
 #define _OPENKNEEBOARD_TRACELOGGING_IMPL_StopWithResult( \
@@ -131,6 +178,7 @@ using UncategorizedTraceLoggingThreadActivity = TraceLoggingThreadActivity<
     } \
     this->CancelAutoStop(); \
     mStopped = true; \
+    mBinaryTraceScope.Stop(); \
     TraceLoggingWriteStop( \
       *this, OKBTL_NAME, TraceLoggingValue(result, "Result")); \
   }
@@ -11,6 +11,7 @@
 #include <concepts>
 #include <filesystem>
 #include <string>
+#include <string_view>
 
 namespace OpenKneeboard {
 
@@ -35,6 +36,11 @@ constexpr std::string_view to_utf8(const char (&in)[N]) {
 }
 
 std::string fold_utf8(std::string_view);
+/** Case-fold into `buffer`, reusing its storage.
+ *
+ * Returns a view of `buffer`.
+ */
+std::string_view fold_utf8(std::string_view, std::string& buffer);
 
 std::string to_utf8(const std::wstring&);
 std::string to_utf8(std::wstring_view);
@@ -4,6 +4,8 @@
 //
 // This program is open source; see the LICENSE file in the root of the
 // OpenKneeboard repository.
+#include <OpenKneeboard/BinaryTrace.hpp>
+#include <OpenKneeboard/config.hpp>
 #include <OpenKneeboard/dprint.hpp>
 #include <OpenKneeboard/tracing.hpp>
 
@@ -52,4 +54,31 @@ wchar_t* GetFullPathForCurrentExecutable() {
   return sBuffer;
 }
 
+void EnableBinaryTraceFromRegistry() {
+  if (BinaryTrace::IsEnabled()) {
+    // `Enable()` would discard what's already been recorded
+    return;
+  }
+  for (auto hkey: {HKEY_CURRENT_USER, HKEY_LOCAL_MACHINE}) {
+    DWORD recordsPerThread {};
+    DWORD size = sizeof(recordsPerThread);
+    if (
+      RegGetValueW(
+        hkey,
+        RegistrySubKey,
+        L"BinaryTraceRecordsPerThread",
+        RRF_RT_REG_DWORD,
+        nullptr,
+        &recordsPerThread,
+        &size)
+      != ERROR_SUCCESS) {
+      continue;
+    }
+    if (recordsPerThread) {
+      BinaryTrace::Enable(recordsPerThread);
+    }
+    return;
+  }
+}
+
 }// namespace OpenKneeboard
@@ -8,6 +8,8 @@
 #include <OpenKneeboard/fatal.hpp>
 #include <OpenKneeboard/utf8.hpp>
 
+#include <algorithm>
+
 #include <icu.h>
 
 namespace OpenKneeboard {
@@ -101,27 +103,47 @@ std::string to_utf8(const wchar_t* in) {
 }
 
 std::string fold_utf8(std::string_view in) {
-  auto error = U_ZERO_ERROR;
-  const auto foldedLength = ucasemap_utf8FoldCase(
-    UTF8CaseMap::Get(),
-    nullptr,
-    0,
-    in.data(),
-    static_cast<int32_t>(in.size()),
-    &error);
-
-  std::string ret(static_cast<size_t>(foldedLength), '\0');
-  error = U_ZERO_ERROR;
-  ucasemap_utf8FoldCase(
-    UTF8CaseMap::Get(),
-    ret.data(),
-    static_cast<int32_t>(ret.size()),
-    in.data(),
-    static_cast<int32_t>(in.size()),
-    &error);
+  std::string ret;
+  fold_utf8(in, ret);
   return ret;
 }
 
+std::string_view fold_utf8(std::string_view in, std::string& buffer) {
+  // Reuses the existing allocation if it's large enough
+  buffer.resize(in.size());
+
+  const auto isASCII = std::ranges::all_of(
+    in, [](const char c) { return static_cast<unsigned char>(c) < 0x80; });
+  if (isASCII) {
+    // Equivalent to ICU's default case folding for ASCII
+    std::ranges::transform(in, buffer.begin(), [](const char c) {
+      return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    });
+    return buffer;
+  }
+
+  const auto fold = [&](UErrorCode* error) {
+    *error = U_ZERO_ERROR;
+    return ucasemap_utf8FoldCase(
+      UTF8CaseMap::Get(),
+      buffer.data(),
+      static_cast<int32_t>(buffer.size()),
+      in.data(),
+      static_cast<int32_t>(in.size()),
+      error);
+  };
+
+  // Folding rarely changes the length, so this is usually the only pass
+  auto error = U_ZERO_ERROR;
+  auto foldedLength = fold(&error);
+  if (error == U_BUFFER_OVERFLOW_ERROR) {
+    buffer.resize(static_cast<std::size_t>(foldedLength));
+    foldedLength = fold(&error);
+  }
+  buffer.resize(U_SUCCESS(error) ? static_cast<std::size_t>(foldedLength) : 0);
+  return buffer;
+}
+
 }// namespace OpenKneeboard
 
 NLOHMANN_JSON_NAMESPACE_BEGIN
@@ -4,7 +4,7 @@
 //
 // This program is open source; see the LICENSE file in the root of the OpenKneeboard repository.
 
-// Simplified version of SpriteBatch.hlsl to only support one sprite at a time,
+// Simplified version of SpriteBatch.hlsl to only support one texture at a time,
 // so that descriptor indexing is not required.
 // This means that Shader Model 5.0 is supported, so D3D11 is supported.
 
@@ -17,23 +17,44 @@ cbuffer UniformData: register(b0) {
     float2 destDimensions;
 };
 
+// {x, y} for each vertex; 0 is left/top, 1 is right/bottom
+// MUST match C++
+static const uint2 SpriteCorners[6] = {
+    // First triangle: excludes top right
+    uint2(0, 1), uint2(0, 0), uint2(1, 1),
+    // Second triangle: excludes bottom left
+    uint2(0, 0), uint2(1, 0), uint2(1, 1),
+};
+
+// Select rather than interpolate, so that the corners are exactly the
+// values passed in
+float2 GetCorner(float4 ltrb, uint2 corner) {
+    return float2(corner.x ? ltrb.z : ltrb.x, corner.y ? ltrb.w : ltrb.y);
+}
+
 void SpriteVertexShader(
-    inout float4 position   : SV_Position,
-    inout float4 color      : COLOR0,
-    inout float2 texCoord   : TEXCOORD0,
-    inout float2 clampTL    : TEXCOORD1,
-    inout float2 clampBR    : TEXCOORD2) {
+    uint vertexID             : SV_VertexID,
+    float4 sourceRect         : SOURCE_RECT,
+    float4 destRect           : DEST_RECT,
+    float4 instanceColor      : COLOR0,
+    float4 sourceClamp        : SOURCE_CLAMP,
+    out float4 position       : SV_Position,
+    out float4 color          : COLOR0,
+    out float2 texCoord       : TEXCOORD0,
+    out float2 clampTL        : TEXCOORD1,
+    out float2 clampBR        : TEXCOORD2) {
+    const uint2 corner = SpriteCorners[vertexID];
 
+    position = float4(GetCorner(destRect, corner), 0, 1);
     // Y axis is up in D3D, and that's all we care about for this shader; Vulkan
     // uses SpriteBatch instead.
     position.y = destDimensions.y - position.y;
     position.xy = (2 * (position.xy / destDimensions)) - 1;
-    position.zw = position.zw;
-    color = color;
+    color = instanceColor;
 
-    texCoord = texCoord / sourceDimensions;
-    clampTL = clampTL;
-    clampBR = clampBR;
+    texCoord = GetCorner(sourceRect, corner) / sourceDimensions;
+    clampTL = sourceClamp.xy;
+    clampBR = sourceClamp.zw;
 }
 
 float4 SpritePixelShader(
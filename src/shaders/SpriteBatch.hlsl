@@ -8,6 +8,7 @@
 // - use descriptor indexing
 // - take pixel coordinates and convert to normalized coordinates
 // - add VK annotations
+// - draw each sprite as an instance, expanding the corners from SV_VertexID
 //
 // This means the shader now requires Shader Model 5.1, which despite some
 // documentation to the contrary, is not supported by Direct3D 11.
@@ -17,8 +18,10 @@
 
 #ifdef VK
 #define VK_BINDING(N) [[vk::binding(N)]]
+#define VK_LOCATION(N) [[vk::location(N)]]
 #else
 #define VK_BINDING(N)
+#define VK_LOCATION(N)
 #endif
 
 VK_BINDING(0) sampler TextureSampler : register(s0);
@@ -32,11 +35,31 @@ VK_BINDING(2) cbuffer BatchData : register(b0) {
 
 static const float2 sourceDimensions[MaxSpritesPerBatch] = (float2[MaxSpritesPerBatch]) packedSourceDimensions;
 
+// {x, y} for each vertex; 0 is left/top, 1 is right/bottom
+// MUST match C++
+static const uint2 SpriteCorners[6] = {
+    // First triangle: excludes top right
+    uint2(0, 1), uint2(0, 0), uint2(1, 1),
+    // Second triangle: excludes bottom left
+    uint2(0, 0), uint2(1, 0), uint2(1, 1),
+};
+
+// Select rather than interpolate, so that the corners are exactly the
+// values passed in
+float2 GetCorner(float4 ltrb, uint2 corner) {
+    return float2(corner.x ? ltrb.z : ltrb.x, corner.y ? ltrb.w : ltrb.y);
+}
+
 void SpriteVertexShader(
-    inout float4 position   : SV_Position,
-    inout float4 color      : COLOR0,
-    inout float2 texCoord   : TEXCOORD0,
-    inout uint textureIndex : TEXTURE_INDEX) {
+    uint vertexID                            : SV_VertexID,
+    VK_LOCATION(0) float4 sourceRect         : SOURCE_RECT,
+    VK_LOCATION(1) float4 destRect           : DEST_RECT,
+    VK_LOCATION(2) float4 instanceColor      : COLOR0,
+    VK_LOCATION(3) uint instanceTextureIndex : TEXTURE_INDEX,
+    out float4 position                      : SV_Position,
+    out float4 color                         : COLOR0,
+    out float2 texCoord                      : TEXCOORD0,
+    out uint textureIndex                    : TEXTURE_INDEX) {
 
 #ifdef VK
 #define projection float2(1, 1);
@@ -44,12 +67,14 @@ void SpriteVertexShader(
 #define projection float2(1, -1);
 #endif
 
+    const uint2 corner = SpriteCorners[vertexID];
+
+    position = float4(GetCorner(destRect, corner), 0, 1);
     position.xy = ((2 * (position.xy / destDimensions)) - 1) * projection;
-    position.zw = position.zw;
-    color = color;
-    textureIndex = textureIndex;
+    color = instanceColor;
+    textureIndex = instanceTextureIndex;
 
-    texCoord = texCoord / sourceDimensions[textureIndex];
+    texCoord = GetCorner(sourceRect, corner) / sourceDimensions[textureIndex];
 }
 
 float4 SpritePixelShader(
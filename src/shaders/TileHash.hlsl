@@ -0,0 +1,86 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+// Hashes each tile of a texture, so that the CPU can find out which parts of
+// an image changed by reading back a few bytes per tile, instead of the
+// entire image.
+//
+// There is one thread group per tile. Each thread hashes a subset of the
+// tile's pixels, and the per-thread hashes are summed, so the result doesn't
+// depend on the order the threads run in.
+
+// Must match TileHashChangeDetector::TileSize
+#define TILE_SIZE 64
+#define THREADS_PER_AXIS 8
+#define THREADS_PER_GROUP (THREADS_PER_AXIS * THREADS_PER_AXIS)
+
+cbuffer TileHashInfo : register(b0) {
+    uint2 imageSize;
+    uint columns;
+    uint padding;
+};
+
+Texture2D<float4> source : register(t0);
+// One hash per tile, in row-major order
+RWStructuredBuffer<uint2> tileHashes : register(u0);
+
+groupshared uint2 partialHashes[THREADS_PER_GROUP];
+
+// 'lowbias32' by Chris Wellons; public domain
+uint Mix(uint x) {
+    x ^= x >> 16;
+    x *= 0x7feb352d;
+    x ^= x >> 15;
+    x *= 0x846ca68b;
+    x ^= x >> 16;
+    return x;
+}
+
+uint HashPixel(uint seed, uint4 bits) {
+    uint hash = Mix(seed ^ bits.x);
+    hash = Mix(hash ^ bits.y);
+    hash = Mix(hash ^ bits.z);
+    return Mix(hash ^ bits.w);
+}
+
+[numthreads(THREADS_PER_AXIS, THREADS_PER_AXIS, 1)]
+void TileHashComputeShader(
+    uint3 tile: SV_GroupID,
+    uint3 thread: SV_GroupThreadID,
+    uint threadIndex: SV_GroupIndex) {
+    const uint2 tileOrigin = tile.xy * TILE_SIZE;
+
+    uint2 hash = uint2(0, 0);
+    for (uint y = thread.y; y < TILE_SIZE; y += THREADS_PER_AXIS) {
+        for (uint x = thread.x; x < TILE_SIZE; x += THREADS_PER_AXIS) {
+            const uint2 position = tileOrigin + uint2(x, y);
+            if (position.x >= imageSize.x || position.y >= imageSize.y) {
+                continue;
+            }
+            // The exact bits, so that any change is detected, for both UNORM
+            // and float formats
+            const uint4 bits = asuint(source.Load(int3(position, 0)));
+            // Seeded by position, so that content moving within a tile
+            // changes the hash. The two halves are independent, so that
+            // the combined hash is 64 bits wide.
+            const uint seed = (y * TILE_SIZE) + x;
+            hash += uint2(
+                HashPixel(Mix(seed), bits),
+                HashPixel(Mix(seed ^ 0x9e3779b9), bits));
+        }
+    }
+
+    partialHashes[threadIndex] = hash;
+    GroupMemoryBarrierWithGroupSync();
+    [unroll]
+    for (uint stride = THREADS_PER_GROUP / 2; stride > 0; stride /= 2) {
+        if (threadIndex < stride) {
+            partialHashes[threadIndex] += partialHashes[threadIndex + stride];
+        }
+        GroupMemoryBarrierWithGroupSync();
+    }
+
+    if (threadIndex == 0) {
+        tileHashes[(tile.y * columns) + tile.x] = partialHashes[0];
+    }
+}
@@ -12,16 +12,33 @@
 namespace OpenKneeboard::Shaders::SpriteBatch {
 
 constexpr uint8_t MaxSpritesPerBatch = 16;
-constexpr uint8_t VerticesPerSprite = 8;
-constexpr uint8_t MaxVerticesPerBatch = VerticesPerSprite * MaxSpritesPerBatch;
+// Each sprite is one instance of two triangles; the vertex shader expands
+// the instance to its corners
+constexpr uint8_t VerticesPerSprite = 6;
+
+/** `{x, y}` corner for each vertex of a sprite; 0 is left/top, 1 is
+ * right/bottom.
+ *
+ * MUST match `SpriteCorners` in SpriteBatch.hlsl and Sprite.hlsl
+ */
+constexpr std::array<std::array<uint8_t, 2>, VerticesPerSprite> SpriteCorners {{
+  // First triangle: excludes top right
+  {0, 1},
+  {0, 0},
+  {1, 1},
+  // Second triangle: excludes bottom left
+  {0, 0},
+  {1, 0},
+  {1, 1},
+}};
 
 struct UniformBuffer {
   using SourceClamp = std::array<float, 4>;
   using SourceDimensions = std::array<float, 2>;
 
-  std::array<SourceClamp, MaxSpritesPerBatch> mSourceClamp;
-  std::array<SourceDimensions, MaxSpritesPerBatch> mSourceDimensions;
-  std::array<float, 2> mTargetDimensions;
+  std::array<SourceClamp, MaxSpritesPerBatch> mSourceClamp {};
+  std::array<SourceDimensions, MaxSpritesPerBatch> mSourceDimensions {};
+  std::array<float, 2> mTargetDimensions {};
 };
 // These offsets are included in both the SPIR-V and DXIL generated headers
 // Check they match if you change anything
@@ -29,19 +46,21 @@ static_assert(offsetof(UniformBuffer, mSourceClamp) == 0);
 static_assert(offsetof(UniformBuffer, mSourceDimensions) == 256);
 static_assert(offsetof(UniformBuffer, mTargetDimensions) == 384);
 
-struct Vertex {
-  class Position : public std::array<float, 4> {
-   public:
-    constexpr Position() = default;
-    constexpr Position(const std::array<float, 2>& pos_2d)
-      : std::array<float, 4> {pos_2d[0], pos_2d[0], 0, 1} {}
-
-    constexpr Position(float x, float y) : std::array<float, 4> {x, y, 0, 1} {}
-  };
-  Position mPosition;
+/// Per-instance vertex data; one per sprite
+struct Instance {
+  // All rects are {left, top, right, bottom}, in pixels
+  std::array<float, 4> mSourceRect {};
+  std::array<float, 4> mDestRect {};
   std::array<float, 4> mColor {};
-  std::array<float, 2> mTexCoord;
-  uint32_t mTextureIndex {~(0ui32)};
+  uint32_t mSourceIndex {};
+
+  constexpr bool operator==(const Instance&) const noexcept = default;
 };
+// The instance buffer is uploaded as-is; these are the input layout offsets
+static_assert(offsetof(Instance, mSourceRect) == 0);
+static_assert(offsetof(Instance, mDestRect) == 16);
+static_assert(offsetof(Instance, mColor) == 32);
+static_assert(offsetof(Instance, mSourceIndex) == 48);
+static_assert(sizeof(Instance) == 52);
 
 }// namespace OpenKneeboard::Shaders::SpriteBatch
@@ -0,0 +1,19 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <string>
+
+namespace OpenKneeboard::Shaders::TileHash::DXBC::Detail {
+
+#include <OpenKneeboard/Shaders/gen/OpenKneeboard-TileHash-DXBC-CS.hpp>
+
+}// namespace OpenKneeboard::Shaders::TileHash::DXBC::Detail
+
+namespace OpenKneeboard::Shaders::TileHash::DXBC {
+
+constexpr std::basic_string_view<unsigned char> CS {
+  Detail::g_TileHashComputeShader,
+  std::size(Detail::g_TileHashComputeShader)};
+
+}// namespace OpenKneeboard::Shaders::TileHash::DXBC
@@ -0,0 +1,230 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "check.hpp"
+
+#include <OpenKneeboard/BinaryTrace.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace OpenKneeboard;
+using namespace OpenKneeboard::BinaryTrace;
+
+namespace {
+
+std::string DumpToString() {
+  std::ostringstream out;
+  Dump(out);
+  return out.str();
+}
+
+std::optional<Trace> ReadString(const std::string& data) {
+  std::istringstream in(data);
+  return Read(in);
+}
+
+bool IsSameRecords(
+  const std::vector<Record>& a,
+  const std::vector<Record>& b) {
+  return std::ranges::equal(a, b, [](const auto& x, const auto& y) {
+    return x.mTimestampNS == y.mTimestampNS && x.mName == y.mName
+      && x.mKind == y.mKind;
+  });
+}
+
+/// The size of the dump header and name table for `names`
+std::size_t GetNamesSize(const std::vector<std::string>& names) {
+  // Magic, version, name count
+  std::size_t ret = 8 + 4 + 4;
+  for (auto&& name: names) {
+    ret += 4 + name.size();
+  }
+  return ret;
+}
+
+void TestRoundTrip() {
+  Enable(64);
+  const auto outer = Intern("outer");
+  const auto inner = Intern("inner");
+  OPENKNEEBOARD_CHECK(Intern("outer") == outer);
+
+  {
+    Scope outerScope(outer);
+    Scope innerScope(inner);
+    innerScope.Stop();
+    Write(inner, RecordKind::Instant);
+  }
+  std::thread([=] { Write(outer, RecordKind::Instant); }).join();
+
+  const auto trace = ReadString(DumpToString());
+  if (!OPENKNEEBOARD_CHECK(trace)) {
+    return;
+  }
+  OPENKNEEBOARD_CHECK(!trace->mTruncated);
+  OPENKNEEBOARD_CHECK(trace->mNames.at(outer) == "outer");
+  OPENKNEEBOARD_CHECK(trace->mNames.at(inner) == "inner");
+  if (!OPENKNEEBOARD_CHECK(trace->mThreads.size() == 2)) {
+    return;
+  }
+
+  const auto& records = trace->mThreads.at(0).mRecords;
+  const std::vector<std::pair<NameID, RecordKind>> expected {
+    {outer, RecordKind::Begin},
+    {inner, RecordKind::Begin},
+    {inner, RecordKind::End},
+    {inner, RecordKind::Instant},
+    {outer, RecordKind::End},
+  };
+  if (!OPENKNEEBOARD_CHECK(records.size() == expected.size())) {
+    return;
+  }
+  for (std::size_t i = 0; i < records.size(); ++i) {
+    OPENKNEEBOARD_CHECK(records.at(i).mName == expected.at(i).first);
+    OPENKNEEBOARD_CHECK(records.at(i).mKind == expected.at(i).second);
+    if (i > 0) {
+      OPENKNEEBOARD_CHECK(
+        records.at(i).mTimestampNS >= records.at(i - 1).mTimestampNS);
+    }
+  }
+
+  const auto& other = trace->mThreads.at(1);
+  OPENKNEEBOARD_CHECK(other.mThreadID != trace->mThreads.at(0).mThreadID);
+  OPENKNEEBOARD_CHECK(other.mRecords.size() == 1);
+}
+
+void TestDisabled() {
+  Enable(64);
+  Disable();
+  Write(Intern("disabled"), RecordKind::Instant);
+  { Scope scope(Intern("disabled")); }
+
+  const auto trace = ReadString(DumpToString());
+  OPENKNEEBOARD_CHECK(trace && trace->mThreads.empty());
+}
+
+/// Only the most recent records are kept
+void TestWrap() {
+  // Rounded up to a power of two
+  Enable(100);
+  const auto name = Intern("wrap");
+  for (int i = 0; i < 1000; ++i) {
+    Write(name, (i % 2) ? RecordKind::End : RecordKind::Begin);
+  }
+  const auto trace = ReadString(DumpToString());
+  if (!(OPENKNEEBOARD_CHECK(trace)
+        && OPENKNEEBOARD_CHECK(trace->mThreads.size() == 1))) {
+    return;
+  }
+  const auto& records = trace->mThreads.front().mRecords;
+  OPENKNEEBOARD_CHECK(records.size() == 128);
+  OPENKNEEBOARD_CHECK(records.back().mKind == RecordKind::End);
+}
+
+/// e.g. the process was killed while dumping
+void TestTruncated() {
+  Enable(64);
+  const auto name = Intern("truncated");
+  for (int i = 0; i < 10; ++i) {
+    Write(name, RecordKind::Instant);
+  }
+  std::thread([=] {
+    for (int i = 0; i < 5; ++i) {
+      Write(name, RecordKind::Instant);
+    }
+  }).join();
+
+  const auto data = DumpToString();
+  const auto full = ReadString(data);
+  if (!(OPENKNEEBOARD_CHECK(full)
+        && OPENKNEEBOARD_CHECK(full->mThreads.size() == 2))) {
+    return;
+  }
+
+  // Part-way through the last record
+  auto trace = ReadString(data.substr(0, data.size() - 5));
+  if (OPENKNEEBOARD_CHECK(trace)) {
+    OPENKNEEBOARD_CHECK(trace->mTruncated);
+    OPENKNEEBOARD_CHECK(trace->mThreads.size() == 2);
+    OPENKNEEBOARD_CHECK(trace->mThreads.back().mRecords.size() == 4);
+    OPENKNEEBOARD_CHECK(IsSameRecords(
+      trace->mThreads.front().mRecords, full->mThreads.front().mRecords));
+  }
+
+  // Exactly on a record boundary
+  trace = ReadString(data.substr(0, data.size() - sizeof(Record)));
+  OPENKNEEBOARD_CHECK(
+    trace && trace->mTruncated
+    && trace->mThreads.back().mRecords.size() == 4);
+
+  // Part-way through the second thread's header
+  const auto secondThread = GetNamesSize(full->mNames) + 4 + 8 + 8
+    + (10 * sizeof(Record));
+  trace = ReadString(data.substr(0, secondThread + 3));
+  OPENKNEEBOARD_CHECK(
+    trace && trace->mTruncated && trace->mThreads.size() == 1
+    && trace->mThreads.front().mRecords.size() == 10);
+
+  // Without the names, records can't be interpreted
+  OPENKNEEBOARD_CHECK(!ReadString(data.substr(0, 14)));
+}
+
+void TestInvalid() {
+  Enable(64);
+  Write(Intern("invalid"), RecordKind::Instant);
+  const auto data = DumpToString();
+
+  OPENKNEEBOARD_CHECK(!ReadString(""));
+  OPENKNEEBOARD_CHECK(!ReadString("garbage"));
+
+  auto badMagic = data;
+  badMagic[0] = 'X';
+  OPENKNEEBOARD_CHECK(!ReadString(badMagic));
+
+  auto badVersion = data;
+  badVersion[8] = 2;
+  OPENKNEEBOARD_CHECK(!ReadString(badVersion));
+
+  // The first name's length
+  auto badName = data;
+  const uint32_t hugeLength = 1 << 30;
+  std::memcpy(badName.data() + 16, &hugeLength, sizeof(hugeLength));
+  OPENKNEEBOARD_CHECK(!ReadString(badName));
+}
+
+void TestDumpToFile() {
+  Enable(64);
+  Write(Intern("file"), RecordKind::Instant);
+
+  const auto path
+    = std::filesystem::temp_directory_path() / "OpenKneeboard-test.oktrace";
+  OPENKNEEBOARD_CHECK(DumpToFile(path));
+  {
+    std::ifstream in(path, std::ios::binary);
+    const auto trace = Read(in);
+    OPENKNEEBOARD_CHECK(
+      trace && trace->mThreads.size() == 1
+      && trace->mThreads.front().mRecords.size() == 1);
+  }
+  std::filesystem::remove(path);
+}
+
+}// namespace
+
+int main() {
+  TestRoundTrip();
+  TestDisabled();
+  TestWrap();
+  TestTruncated();
+  TestInvalid();
+  TestDumpToFile();
+  return Tests::Finish();
+}
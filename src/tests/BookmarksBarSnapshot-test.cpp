@@ -0,0 +1,166 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "check.hpp"
+
+#include <OpenKneeboard/BookmarksBarSnapshot.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace OpenKneeboard;
+
+namespace {
+
+/// Stands in for an `IDWriteTextLayout`
+struct FakeLabel {
+  std::string mText;
+  float mFontSize {};
+  float mMaxWidth {};
+  float mMaxHeight {};
+};
+
+using Snapshot = BookmarksBarSnapshot<FakeLabel>;
+
+/// Records every label it's asked to lay out
+struct FakeTextMeasurer {
+  std::vector<std::size_t> mMeasured;
+
+  FakeLabel operator()(
+    const std::size_t index,
+    const Snapshot::Rect& rect,
+    const float fontSize) {
+    mMeasured.push_back(index);
+    return {
+      std::format("#{}", index + 1),
+      fontSize,
+      rect.mRight - rect.mLeft,
+      rect.mBottom - rect.mTop,
+    };
+  }
+};
+
+Snapshot::Key MakeKey(const uint32_t width, const uint32_t height) {
+  return {
+    .mBookmarksGeneration = 1,
+    .mDPI = 96,
+    .mWidth = width,
+    .mHeight = height,
+  };
+}
+
+void TestEmpty() {
+  FakeTextMeasurer measurer;
+  for (const auto& [key, count]: {
+         std::pair {MakeKey(40, 600), std::size_t {0}},
+         std::pair {MakeKey(0, 600), std::size_t {3}},
+         std::pair {MakeKey(40, 0), std::size_t {3}},
+       }) {
+    const auto snapshot = Snapshot::Build(key, count, measurer);
+    OPENKNEEBOARD_CHECK(snapshot->GetKey() == key);
+    OPENKNEEBOARD_CHECK(snapshot->GetButtons().empty());
+  }
+  OPENKNEEBOARD_CHECK(measurer.mMeasured.empty());
+}
+
+/// Buttons fill the bar, without gaps or overlaps, on whole pixels
+void TestGeometry() {
+  for (const uint32_t height: {1u, 599u, 600u, 1081u}) {
+    for (std::size_t count = 1; count < 200; ++count) {
+      FakeTextMeasurer measurer;
+      const auto snapshot
+        = Snapshot::Build(MakeKey(40, height), count, measurer);
+      const auto buttons = snapshot->GetButtons();
+      if (!OPENKNEEBOARD_CHECK(buttons.size() == count)) {
+        return;
+      }
+
+      float top = 0;
+      for (std::size_t i = 0; i < count; ++i) {
+        const auto& button = buttons[i];
+        const auto& rect = button.mRect;
+        const bool ok = OPENKNEEBOARD_CHECK(rect.mTop == top)
+          && OPENKNEEBOARD_CHECK(rect.mBottom >= rect.mTop)
+          && OPENKNEEBOARD_CHECK(rect.mTop == std::floor(rect.mTop))
+          && OPENKNEEBOARD_CHECK(rect.mLeft == 0 && rect.mRight == 40)
+          // Labels are laid out for their own button
+          && OPENKNEEBOARD_CHECK(
+            button.mLabel.mText == std::format("#{}", i + 1))
+          && OPENKNEEBOARD_CHECK(
+            button.mLabel.mMaxHeight == rect.mBottom - rect.mTop);
+        if (!ok) {
+          return;
+        }
+        top = rect.mBottom;
+      }
+      OPENKNEEBOARD_CHECK(top == static_cast<float>(height));
+    }
+  }
+}
+
+/// Laying out text is the expensive part, so each label is laid out once
+void TestMeasuredOnce() {
+  FakeTextMeasurer measurer;
+  const auto snapshot = Snapshot::Build(MakeKey(40, 600), 7, measurer);
+  const std::vector<std::size_t> expected {0, 1, 2, 3, 4, 5, 6};
+  OPENKNEEBOARD_CHECK(measurer.mMeasured == expected);
+
+  // Painting only reads the snapshot
+  for (int i = 0; i < 3; ++i) {
+    for (auto&& button: snapshot->GetButtons()) {
+      OPENKNEEBOARD_CHECK(!button.mLabel.mText.empty());
+    }
+  }
+  OPENKNEEBOARD_CHECK(measurer.mMeasured.size() == 7);
+}
+
+void TestFontSize() {
+  FakeTextMeasurer measurer;
+  auto key = MakeKey(40, 600);
+  const auto normal = Snapshot::Build(key, 2, measurer);
+  // Vertical text, filling 3/4 of the bar's width
+  OPENKNEEBOARD_CHECK(normal->GetFontSize() == 15);
+  OPENKNEEBOARD_CHECK(normal->GetButtons()[0].mLabel.mFontSize == 15);
+
+  key.mDPI = 192;
+  const auto highDPI = Snapshot::Build(key, 2, measurer);
+  OPENKNEEBOARD_CHECK(highDPI->GetFontSize() == 7.5f);
+
+  // Unknown DPI is treated as 96
+  key.mDPI = 0;
+  OPENKNEEBOARD_CHECK(Snapshot::Build(key, 2, measurer)->GetFontSize() == 15);
+
+  key.mDPI = 96;
+  key.mWidth = 80;
+  OPENKNEEBOARD_CHECK(Snapshot::Build(key, 2, measurer)->GetFontSize() == 30);
+}
+
+/// The snapshot must be rebuilt if any of these change
+void TestKey() {
+  const auto key = MakeKey(40, 600);
+  OPENKNEEBOARD_CHECK(key == MakeKey(40, 600));
+  auto changed = key;
+  changed.mBookmarksGeneration++;
+  OPENKNEEBOARD_CHECK(changed != key);
+  changed = key;
+  changed.mDPI = 120;
+  OPENKNEEBOARD_CHECK(changed != key);
+  OPENKNEEBOARD_CHECK(MakeKey(41, 600) != key);
+  OPENKNEEBOARD_CHECK(MakeKey(40, 601) != key);
+}
+
+}// namespace
+
+int main() {
+  TestEmpty();
+  TestGeometry();
+  TestMeasuredOnce();
+  TestFontSize();
+  TestKey();
+  return Tests::Finish();
+}
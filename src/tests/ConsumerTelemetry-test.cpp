@@ -0,0 +1,165 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "check.hpp"
+
+#include <OpenKneeboard/SHM/ConsumerTelemetry.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace OpenKneeboard;
+using namespace std::chrono_literals;
+
+using SHM::ConsumerTelemetry;
+
+namespace {
+
+const auto BaseTime = ConsumerTelemetry::Clock::time_point {} + 1000s;
+constexpr auto FrameInterval = 10ms;
+
+ConsumerTelemetry::Clock::time_point GetFrameTime(const uint64_t i) {
+  return BaseTime + (FrameInterval * static_cast<int64_t>(i));
+}
+
+ConsumerTelemetry::FrameSample Sample(const uint64_t i) {
+  const auto start = GetFrameTime(i);
+  const std::chrono::microseconds processingTime {
+    100 + static_cast<int64_t>(i % 50)};
+  return {
+    .mStartTime = start,
+    .mEndTime = start + processingTime,
+    .mSHMFrameNumber = i / 2,
+    .mVisibleLayers = static_cast<uint32_t>(i & 0xffff),
+  };
+}
+
+// Every field must come from the same `Sample()`
+bool IsConsistent(const ConsumerTelemetry::Snapshot& s) {
+  const auto i = s.mFrameCount - 1;
+  return s.mFrameCount == s.mFetchedFrameCount + s.mReusedFrameCount
+    && s.mVisibleLayers == (i & 0xffff) && s.mLastSHMFrameNumber == i / 2
+    && s.mLastFrameTime == GetFrameTime(i)
+    && s.mFetchedFrameCount == (i / 2) + 1;
+}
+
+// One writer, several readers
+void TestConcurrentReads() {
+  constexpr uint64_t FrameCount = 200000;
+
+  ConsumerTelemetry telemetry;
+  OPENKNEEBOARD_CHECK(!telemetry.GetSnapshot());
+
+  std::atomic<bool> done {false};
+  std::atomic<uint64_t> reads {0};
+  std::atomic<uint64_t> inconsistentReads {0};
+  std::atomic<uint64_t> outOfOrderReads {0};
+  {
+    std::vector<std::jthread> readers;
+    for (int i = 0; i < 4; ++i) {
+      readers.emplace_back([&] {
+        uint64_t lastFrameCount = 0;
+        while (!done.load()) {
+          const auto snapshot = telemetry.GetSnapshot();
+          if (!snapshot) {
+            continue;
+          }
+          ++reads;
+          if (!IsConsistent(*snapshot)) {
+            ++inconsistentReads;
+          }
+          if (snapshot->mFrameCount < lastFrameCount) {
+            ++outOfOrderReads;
+          }
+          lastFrameCount = snapshot->mFrameCount;
+        }
+      });
+    }
+
+    for (uint64_t i = 0; i < FrameCount; ++i) {
+      if (!OPENKNEEBOARD_CHECK(telemetry.RecordFrame(42, Sample(i)))) {
+        break;
+      }
+    }
+    done = true;
+  }
+  OPENKNEEBOARD_CHECK(reads > 0);
+  OPENKNEEBOARD_CHECK(inconsistentReads == 0);
+  OPENKNEEBOARD_CHECK(outOfOrderReads == 0);
+
+  const auto s = telemetry.GetSnapshot();
+  if (!OPENKNEEBOARD_CHECK(s.has_value())) {
+    return;
+  }
+  OPENKNEEBOARD_CHECK(s->mProcessID == 42);
+  OPENKNEEBOARD_CHECK(s->mFrameCount == FrameCount);
+  OPENKNEEBOARD_CHECK(IsConsistent(*s));
+  OPENKNEEBOARD_CHECK(s->mFrameInterval > 9ms && s->mFrameInterval < 11ms);
+  OPENKNEEBOARD_CHECK(s->mProcessingTime.mCount == FrameCount);
+  OPENKNEEBOARD_CHECK(s->mProcessingTime.mMin >= 100'000);
+  OPENKNEEBOARD_CHECK(s->mProcessingTime.mMax < 160'000);
+}
+
+// The first process owns the slot until it goes quiet
+void TestOwnership() {
+  ConsumerTelemetry telemetry;
+  OPENKNEEBOARD_CHECK(telemetry.RecordFrame(1, Sample(0)));
+  OPENKNEEBOARD_CHECK(telemetry.RecordFrame(1, Sample(1)));
+  OPENKNEEBOARD_CHECK(!telemetry.RecordFrame(2, Sample(2)));
+  OPENKNEEBOARD_CHECK(telemetry.GetSnapshot()->mFrameCount == 2);
+
+  // More than `StaleAfter` later
+  OPENKNEEBOARD_CHECK(telemetry.RecordFrame(2, Sample(200)));
+  const auto s = telemetry.GetSnapshot();
+  if (!OPENKNEEBOARD_CHECK(s.has_value())) {
+    return;
+  }
+  OPENKNEEBOARD_CHECK(s->mProcessID == 2);
+  OPENKNEEBOARD_CHECK(s->mFrameCount == 1);
+  OPENKNEEBOARD_CHECK(s->mFetchedFrameCount == 1);
+  OPENKNEEBOARD_CHECK(s->mReusedFrameCount == 0);
+  OPENKNEEBOARD_CHECK(s->mProcessingTime.mCount == 1);
+  OPENKNEEBOARD_CHECK(s->mFrameInterval == 0ns);
+
+  telemetry.Reset();
+  OPENKNEEBOARD_CHECK(!telemetry.GetSnapshot());
+  OPENKNEEBOARD_CHECK(telemetry.RecordFrame(3, Sample(0)));
+  OPENKNEEBOARD_CHECK(telemetry.GetSnapshot()->mProcessID == 3);
+}
+
+// Competing writers: samples are dropped rather than interleaved
+void TestConcurrentWrites() {
+  ConsumerTelemetry telemetry;
+  std::atomic<uint64_t> accepted {0};
+  {
+    std::vector<std::jthread> writers;
+    for (uint32_t processID = 1; processID <= 4; ++processID) {
+      writers.emplace_back([&, processID] {
+        for (uint64_t i = 0; i < 50000; ++i) {
+          if (telemetry.RecordFrame(processID, Sample(i))) {
+            ++accepted;
+          }
+        }
+      });
+    }
+  }
+  const auto s = telemetry.GetSnapshot();
+  if (!OPENKNEEBOARD_CHECK(s.has_value())) {
+    return;
+  }
+  OPENKNEEBOARD_CHECK(accepted >= s->mFrameCount);
+  OPENKNEEBOARD_CHECK(
+    s->mFrameCount == s->mFetchedFrameCount + s->mReusedFrameCount);
+}
+
+}// namespace
+
+int main() {
+  TestConcurrentReads();
+  TestOwnership();
+  TestConcurrentWrites();
+  return Tests::Finish();
+}
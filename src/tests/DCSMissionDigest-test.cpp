@@ -0,0 +1,134 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "check.hpp"
+
+#include <OpenKneeboard/DCSMissionDigest.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+using namespace OpenKneeboard;
+
+namespace {
+
+DCSMissionDigest MakeDigest() {
+  DCSMissionDigest ret {
+    .mTitle = "Operation Test",
+    .mSituation = std::string("Multi-line\nsituation, with a \0 byte", 35),
+    .mStartDate = DCSMissionDigest::Date {2011, 6, 1},
+    .mStartTime = 28800,
+    .mWeather = DCSMissionDigest::Weather {
+      .mTemperature = -5,
+      .mQNH = 760.0f,
+      .mCloudBase = 2500,
+      .mWindAtGround = {2.5f, 270},
+      .mWindAt2000 = {10.0f, 280},
+      .mWindAt8000 = {25.0f, 300},
+    },
+  };
+  auto& red = ret.mCoalitions.at(1);
+  red.mCountries = "Russia, Belarus";
+  red.mTask = "Defend";
+  red.mBullseye = DCSMissionDigest::Point {-281000.5, 647000.25};
+  auto& blue = ret.mCoalitions.at(2);
+  blue.mCountries = "USA";
+  blue.mTask = "Attack";
+  blue.mImages = {"briefing.png", "map/\xc3\xa9tape 2.jpg", ""};
+  return ret;
+}
+
+void TestRoundTrip() {
+  const auto digest = MakeDigest();
+  const auto loaded = DCSMissionDigest::Deserialize(digest.Serialize());
+  OPENKNEEBOARD_CHECK(loaded && *loaded == digest);
+
+  // Missing fields stay missing, rather than becoming empty values
+  const DCSMissionDigest empty;
+  const auto loadedEmpty = DCSMissionDigest::Deserialize(empty.Serialize());
+  if (OPENKNEEBOARD_CHECK(loadedEmpty && *loadedEmpty == empty)) {
+    OPENKNEEBOARD_CHECK(!loadedEmpty->mTitle);
+    OPENKNEEBOARD_CHECK(!loadedEmpty->mWeather);
+    OPENKNEEBOARD_CHECK(!loadedEmpty->mCoalitions.at(2).mBullseye);
+  }
+
+  auto emptyStrings = empty;
+  emptyStrings.mTitle = std::string {};
+  const auto loadedStrings
+    = DCSMissionDigest::Deserialize(emptyStrings.Serialize());
+  OPENKNEEBOARD_CHECK(
+    loadedStrings && loadedStrings->mTitle == std::string {});
+
+  // Stable output, so the cache can compare files
+  OPENKNEEBOARD_CHECK(digest.Serialize() == MakeDigest().Serialize());
+}
+
+/// e.g. written by a different build, or partially written
+void TestRejectsInvalid() {
+  const auto data = MakeDigest().Serialize();
+
+  OPENKNEEBOARD_CHECK(!DCSMissionDigest::Deserialize({}));
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    if (!OPENKNEEBOARD_CHECK(
+          !DCSMissionDigest::Deserialize(data.substr(0, i)))) {
+      break;
+    }
+  }
+  OPENKNEEBOARD_CHECK(!DCSMissionDigest::Deserialize(data + '\0'));
+
+  auto badMagic = data;
+  badMagic[0] = 'X';
+  OPENKNEEBOARD_CHECK(!DCSMissionDigest::Deserialize(badMagic));
+
+  // A stale format version
+  auto badVersion = data;
+  badVersion[4] = 0;
+  OPENKNEEBOARD_CHECK(!DCSMissionDigest::Deserialize(badVersion));
+  badVersion[4] = 2;
+  OPENKNEEBOARD_CHECK(!DCSMissionDigest::Deserialize(badVersion));
+
+  // The title's 'has value' flag must be 0 or 1
+  auto badFlag = data;
+  badFlag[8] = 2;
+  OPENKNEEBOARD_CHECK(!DCSMissionDigest::Deserialize(badFlag));
+
+  // The title's length, beyond the end of the data
+  auto badLength = data;
+  badLength[12] = '\x7f';
+  OPENKNEEBOARD_CHECK(!DCSMissionDigest::Deserialize(badLength));
+
+  // A huge image count must fail, not allocate without bound
+  const auto empty = DCSMissionDigest {}.Serialize();
+  // Magic, version, then 5 absent optionals, then the first coalition's
+  // absent countries and task
+  const std::size_t imageCountOffset = 8 + 5 + 2;
+  auto hugeCount = empty;
+  hugeCount.replace(imageCountOffset, 4, "\xff\xff\xff\xff");
+  OPENKNEEBOARD_CHECK(!DCSMissionDigest::Deserialize(hugeCount));
+}
+
+void TestHashContent() {
+  const auto hash = DCSMissionDigest::HashContent({"mission", "dictionary"});
+  OPENKNEEBOARD_CHECK(
+    hash == DCSMissionDigest::HashContent({"mission", "dictionary"}));
+  OPENKNEEBOARD_CHECK(
+    hash != DCSMissionDigest::HashContent({"mission", "dictionarY"}));
+  OPENKNEEBOARD_CHECK(
+    hash != DCSMissionDigest::HashContent({"dictionary", "mission"}));
+  // Moving bytes between files is a change
+  OPENKNEEBOARD_CHECK(
+    hash != DCSMissionDigest::HashContent({"missiond", "ictionary"}));
+  OPENKNEEBOARD_CHECK(
+    DCSMissionDigest::HashContent({"a", ""})
+    != DCSMissionDigest::HashContent({"", "a"}));
+}
+
+}// namespace
+
+int main() {
+  TestRoundTrip();
+  TestRejectsInvalid();
+  TestHashContent();
+  return Tests::Finish();
+}
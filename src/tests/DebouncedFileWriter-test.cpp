@@ -0,0 +1,220 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "check.hpp"
+
+#include <OpenKneeboard/DebouncedFileWriter.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <future>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace OpenKneeboard;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr std::string_view CrashChildArg {"--crash-child"};
+
+std::filesystem::path TestDirectory() {
+  return std::filesystem::temp_directory_path()
+    / "OpenKneeboard-DebouncedFileWriter-test";
+}
+
+std::string ReadFile(const std::filesystem::path& path) {
+  std::ifstream f(path, std::ios::binary);
+  std::stringstream ret;
+  ret << f.rdbuf();
+  return ret.str();
+}
+
+/** Contents for the `i`th write by the crash test.
+ *
+ * Sizes and contents vary, so a torn file is always detectable.
+ */
+std::string CrashTestContents(const std::size_t i) {
+  return std::string(
+    100'000 + ((i % 7) * 1000), static_cast<char>('A' + (i % 26)));
+}
+
+bool IsCompleteCrashTestFile(const std::string& contents) {
+  return contents.size() >= 100'000 && (contents.size() % 1000) == 0
+    && contents.find_first_not_of(contents.front()) == std::string::npos;
+}
+
+[[noreturn]]
+void RunCrashChild(const std::filesystem::path& path) {
+  for (std::size_t i = 0;; ++i) {
+    DebouncedFileWriter::WriteAtomically(path, CrashTestContents(i));
+  }
+}
+
+#ifdef _WIN32
+void StartAndKillWriter(
+  const std::filesystem::path& path,
+  const std::chrono::milliseconds delay) {
+  wchar_t exe[MAX_PATH] {};
+  GetModuleFileNameW(nullptr, exe, MAX_PATH);
+  auto commandLine = std::format(
+    L"\"{}\" {} \"{}\"",
+    exe,
+    std::wstring {CrashChildArg.begin(), CrashChildArg.end()},
+    path.wstring());
+
+  STARTUPINFOW startupInfo {sizeof(startupInfo)};
+  PROCESS_INFORMATION processInfo {};
+  if (!CreateProcessW(
+        exe,
+        commandLine.data(),
+        nullptr,
+        nullptr,
+        FALSE,
+        0,
+        nullptr,
+        nullptr,
+        &startupInfo,
+        &processInfo)) {
+    OPENKNEEBOARD_CHECK(!"CreateProcessW failed");
+    return;
+  }
+  std::this_thread::sleep_for(delay);
+  TerminateProcess(processInfo.hProcess, 1);
+  WaitForSingleObject(processInfo.hProcess, INFINITE);
+  CloseHandle(processInfo.hThread);
+  CloseHandle(processInfo.hProcess);
+}
+#else
+void StartAndKillWriter(
+  const std::filesystem::path& path,
+  const std::chrono::milliseconds delay) {
+  const auto pid = fork();
+  if (pid == 0) {
+    RunCrashChild(path);
+  }
+  if (!OPENKNEEBOARD_CHECK(pid > 0)) {
+    return;
+  }
+  std::this_thread::sleep_for(delay);
+  kill(pid, SIGKILL);
+  waitpid(pid, nullptr, 0);
+}
+#endif
+
+/// Kill a process while it's repeatedly replacing a file
+void TestCrashConsistency() {
+  const auto path = TestDirectory() / "crash" / "settings.json";
+  std::filesystem::remove_all(path.parent_path());
+  DebouncedFileWriter::WriteAtomically(path, CrashTestContents(0));
+
+  for (int round = 0; round < 20; ++round) {
+    StartAndKillWriter(path, std::chrono::milliseconds(20 + (round * 5)));
+    const auto contents = ReadFile(path);
+    // Either the previous or the new contents, never a mix or a truncation
+    OPENKNEEBOARD_CHECK(IsCompleteCrashTestFile(contents));
+  }
+
+  // A temporary file left by the crash doesn't stop later writes
+  DebouncedFileWriter::WriteAtomically(path, "after\n");
+  OPENKNEEBOARD_CHECK(ReadFile(path) == "after\n");
+  auto temporary = path;
+  temporary += ".tmp";
+  OPENKNEEBOARD_CHECK(!std::filesystem::exists(temporary));
+}
+
+void TestCoalescing() {
+  const auto dir = TestDirectory() / "coalesce";
+  std::filesystem::remove_all(dir);
+  const auto path = dir / "nested" / "file.json";
+
+  DebouncedFileWriter writer({.mDebounce = 1h, .mMaxDelay = 1h});
+  for (int i = 0; i < 100; ++i) {
+    writer.Write(path, std::to_string(i));
+  }
+  OPENKNEEBOARD_CHECK(writer.IsPending(path));
+  OPENKNEEBOARD_CHECK(!std::filesystem::exists(path));
+
+  writer.Flush();
+  OPENKNEEBOARD_CHECK(!writer.IsPending(path));
+  OPENKNEEBOARD_CHECK(ReadFile(path) == "99");
+
+  const auto stats = writer.GetStatistics();
+  OPENKNEEBOARD_CHECK(stats.mWrites == 1);
+  OPENKNEEBOARD_CHECK(stats.mCoalesced == 99);
+  OPENKNEEBOARD_CHECK(stats.mBytesWritten == 2);
+  OPENKNEEBOARD_CHECK(stats.mFailures == 0);
+
+  // A removal replaces a pending write
+  writer.Write(path, "replaced");
+  writer.Remove(path);
+  writer.Flush();
+  OPENKNEEBOARD_CHECK(!std::filesystem::exists(path));
+  OPENKNEEBOARD_CHECK(writer.GetStatistics().mRemovals == 1);
+}
+
+void TestDebounce() {
+  const auto path = TestDirectory() / "debounce.json";
+  std::filesystem::remove_all(path);
+
+  std::promise<void> written;
+  DebouncedFileWriter writer(
+    {.mDebounce = 10ms, .mMaxDelay = 1h},
+    [&](const auto&, const auto&) { written.set_value(); });
+  writer.Write(path, "debounced");
+  // No flush: the worker writes it once it's been left alone
+  OPENKNEEBOARD_CHECK(
+    written.get_future().wait_for(10s) == std::future_status::ready);
+  OPENKNEEBOARD_CHECK(ReadFile(path) == "debounced");
+}
+
+/// A write that has started but not finished is still pending
+void TestPendingWhileWriting() {
+  const auto path = TestDirectory() / "inflight.json";
+  std::filesystem::remove_all(path);
+
+  std::promise<void> started;
+  std::promise<void> release;
+  auto releaseFuture = release.get_future();
+  DebouncedFileWriter writer(
+    {.mDebounce = 0ms, .mMaxDelay = 0ms}, [&](const auto&, const auto&) {
+      started.set_value();
+      releaseFuture.wait();
+    });
+
+  writer.Write(path, "in flight");
+  started.get_future().wait();
+  // Blocked in the callback, so the worker is still handling the write
+  OPENKNEEBOARD_CHECK(writer.IsPending(path));
+
+  release.set_value();
+  writer.Flush();
+  OPENKNEEBOARD_CHECK(!writer.IsPending(path));
+}
+
+}// namespace
+
+int main(int argc, char** argv) {
+  if (argc == 3 && argv[1] == CrashChildArg) {
+    RunCrashChild(argv[2]);
+  }
+
+  TestCoalescing();
+  TestDebounce();
+  TestPendingWhileWriting();
+  TestCrashConsistency();
+
+  std::filesystem::remove_all(TestDirectory());
+  return Tests::Finish();
+}
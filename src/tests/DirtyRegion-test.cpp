@@ -0,0 +1,158 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "check.hpp"
+
+#include <OpenKneeboard/DirtyRegion.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace OpenKneeboard;
+
+namespace {
+
+PixelRect Rect(uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+  return {{x, y}, {width, height}};
+}
+
+const PixelSize Bounds {100, 80};
+
+void TestEmpty() {
+  DirtyRegion region(Bounds);
+  OPENKNEEBOARD_CHECK(region.IsEmpty());
+  OPENKNEEBOARD_CHECK(!region.IsAll());
+  OPENKNEEBOARD_CHECK(region.GetArea() == 0);
+
+  region.Add(Rect(10, 10, 0, 5));
+  OPENKNEEBOARD_CHECK(region.IsEmpty());
+  // Entirely outside the bounds
+  region.Add(Rect(200, 10, 10, 10));
+  OPENKNEEBOARD_CHECK(region.IsEmpty());
+
+  // No bounds, so nothing can be dirty
+  DirtyRegion unbounded;
+  unbounded.AddAll();
+  OPENKNEEBOARD_CHECK(unbounded.IsEmpty());
+}
+
+void TestClip() {
+  DirtyRegion region(Bounds);
+  region.Add(Rect(90, 70, 50, 50));
+  if (!OPENKNEEBOARD_CHECK(region.GetRects().size() == 1)) {
+    return;
+  }
+  OPENKNEEBOARD_CHECK(region.GetRects().front() == Rect(90, 70, 10, 10));
+}
+
+void TestUnion() {
+  DirtyRegion region(Bounds);
+  region.Add(Rect(0, 0, 10, 10));
+  // Contained
+  region.Add(Rect(2, 2, 5, 5));
+  OPENKNEEBOARD_CHECK(region.GetRects().size() == 1);
+
+  // Adjacent, so merging doesn't waste any area
+  region |= Rect(10, 0, 10, 10);
+  if (OPENKNEEBOARD_CHECK(region.GetRects().size() == 1)) {
+    OPENKNEEBOARD_CHECK(region.GetRects().front() == Rect(0, 0, 20, 10));
+  }
+
+  // Far away, so kept separate
+  region |= Rect(80, 60, 10, 10);
+  OPENKNEEBOARD_CHECK(region.GetRects().size() == 2);
+  OPENKNEEBOARD_CHECK(region.GetArea() == 300);
+
+  // Containing an existing rect replaces it
+  region |= Rect(70, 50, 30, 30);
+  OPENKNEEBOARD_CHECK(region.GetRects().size() == 2);
+  OPENKNEEBOARD_CHECK(region.GetArea() == 1100);
+
+  DirtyRegion other(Bounds);
+  other |= Rect(40, 40, 5, 5);
+  region |= other;
+  OPENKNEEBOARD_CHECK(region.GetRects().size() == 3);
+
+  // Different bounds: everything is dirty
+  DirtyRegion resized({50, 50});
+  resized |= Rect(0, 0, 1, 1);
+  region |= resized;
+  OPENKNEEBOARD_CHECK(region.IsAll());
+}
+
+void TestMostlyDirtyIsAll() {
+  DirtyRegion region(Bounds);
+  region.Add(Rect(0, 0, 100, 30));
+  region.Add(Rect(0, 50, 100, 30));
+  OPENKNEEBOARD_CHECK(region.IsAll());
+  OPENKNEEBOARD_CHECK(region.GetArea() == 8000);
+
+  // Already all dirty
+  region.Add(Rect(5, 5, 5, 5));
+  OPENKNEEBOARD_CHECK(region.IsAll());
+
+  region.Clear();
+  OPENKNEEBOARD_CHECK(region.IsEmpty());
+}
+
+void TestSetBounds() {
+  DirtyRegion region(Bounds);
+  region.SetBounds(Bounds);
+  OPENKNEEBOARD_CHECK(region.IsEmpty());
+  region.SetBounds({200, 200});
+  OPENKNEEBOARD_CHECK(region.IsAll());
+  OPENKNEEBOARD_CHECK(region.GetBounds() == PixelSize(200, 200));
+}
+
+// Every dirty pixel must be covered, without exceeding the bounds or the
+// rect limit
+void TestRandom() {
+  std::mt19937 rng(1);
+  for (int i = 0; i < 2000; ++i) {
+    DirtyRegion region(Bounds);
+    std::vector<bool> dirty(Bounds.mWidth * Bounds.mHeight);
+    const auto count = 1 + (rng() % 20);
+    for (std::size_t j = 0; j < count; ++j) {
+      const auto rect
+        = Rect(rng() % 110, rng() % 90, 1 + (rng() % 20), 1 + (rng() % 20));
+      region.Add(rect);
+      const auto clamped = rect.Clamped(Bounds);
+      for (auto y = clamped.Top(); y < clamped.Bottom(); ++y) {
+        for (auto x = clamped.Left(); x < clamped.Right(); ++x) {
+          dirty.at((y * Bounds.mWidth) + x) = true;
+        }
+      }
+    }
+
+    const auto rects = region.GetRects();
+    if (!OPENKNEEBOARD_CHECK(rects.size() <= DirtyRegion::MaxRects)) {
+      return;
+    }
+    for (auto&& rect: rects) {
+      if (!OPENKNEEBOARD_CHECK(rect.Clamped(Bounds) == rect)) {
+        return;
+      }
+      for (auto y = rect.Top(); y < rect.Bottom(); ++y) {
+        for (auto x = rect.Left(); x < rect.Right(); ++x) {
+          dirty.at((y * Bounds.mWidth) + x) = false;
+        }
+      }
+    }
+    if (!OPENKNEEBOARD_CHECK(std::ranges::find(dirty, true) == dirty.end())) {
+      return;
+    }
+  }
+}
+
+}// namespace
+
+int main() {
+  TestEmpty();
+  TestClip();
+  TestUnion();
+  TestMostlyDirtyIsAll();
+  TestSetBounds();
+  TestRandom();
+  return Tests::Finish();
+}
@@ -0,0 +1,189 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "check.hpp"
+
+#include <OpenKneeboard/FoldedStringIndex.hpp>
+#include <OpenKneeboard/utf8.hpp>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <random>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include <icu.h>
+
+using namespace OpenKneeboard;
+
+namespace {
+
+// ICU's default case folding, without `fold_utf8()`'s ASCII fast path or
+// buffer reuse
+std::string ReferenceFold(std::string_view in) {
+  static const std::unique_ptr<UCaseMap, decltype(&ucasemap_close)> map {
+    [] {
+      auto error = U_ZERO_ERROR;
+      return ucasemap_open("", U_FOLD_CASE_DEFAULT, &error);
+    }(),
+    &ucasemap_close,
+  };
+
+  const auto inLength = static_cast<int32_t>(in.size());
+  auto error = U_ZERO_ERROR;
+  const auto length = ucasemap_utf8FoldCase(
+    map.get(), nullptr, 0, in.data(), inLength, &error);
+  std::string ret(static_cast<std::size_t>(length), '\0');
+  error = U_ZERO_ERROR;
+  ucasemap_utf8FoldCase(
+    map.get(), ret.data(), length, in.data(), inLength, &error);
+  return U_SUCCESS(error) ? ret : std::string {};
+}
+
+using Entries = std::vector<std::pair<std::string, std::string>>;
+
+std::vector<FoldedStringIndex::EntryIndex> ReferenceFilter(
+  const Entries& entries,
+  std::string_view query) {
+  const auto folded = ReferenceFold(query);
+  std::vector<FoldedStringIndex::EntryIndex> ret;
+  for (std::size_t i = 0; i < entries.size(); ++i) {
+    const auto first = ReferenceFold(entries.at(i).first);
+    const auto second = ReferenceFold(entries.at(i).second);
+    const auto matches = std::ranges::all_of(
+      std::views::split(folded, ' '), [&](auto&& range) {
+        const std::string_view word {range.begin(), range.end()};
+        return first.contains(word) || second.contains(word);
+      });
+    if (matches) {
+      ret.push_back(i);
+    }
+  }
+  return ret;
+}
+
+void TestFold(std::mt19937& rng) {
+  OPENKNEEBOARD_CHECK(fold_utf8("Hello, WORLD [`@{]") == "hello, world [`@{]");
+  OPENKNEEBOARD_CHECK(fold_utf8("Größe") == "grösse");
+  OPENKNEEBOARD_CHECK(fold_utf8("ΣΑΣ ς") == "σασ σ");
+
+  // Mixed ASCII, characters whose folded form is a different length, and
+  // invalid UTF-8
+  constexpr std::string_view pieces[] {
+    "a",
+    "B",
+    "Z",
+    "z",
+    " ",
+    "ß",
+    "İ",
+    "Σ",
+    "ς",
+    "ﬁ",
+    "Ǆ",
+    "é",
+    "É",
+    "\xff",
+    "\xc3",
+    "1",
+    "@",
+    "[",
+    "`",
+    "{",
+    "ΐ",
+    "Ａ",
+    "\x7f",
+    "\t",
+  };
+  // The first few pieces are ASCII, to exercise the fast path
+  constexpr std::size_t ASCIIPieces = 5;
+
+  std::string buffer;
+  for (int i = 0; i < 20000; ++i) {
+    const auto pieceCount = rng() % 40;
+    const auto choices = (rng() % 2) ? ASCIIPieces : std::size(pieces);
+    std::string text;
+    for (std::size_t j = 0; j < pieceCount; ++j) {
+      text += pieces[rng() % choices];
+    }
+
+    const auto expected = ReferenceFold(text);
+    if (!(OPENKNEEBOARD_CHECK(fold_utf8(text) == expected)
+          && OPENKNEEBOARD_CHECK(fold_utf8(text, buffer) == expected))) {
+      return;
+    }
+  }
+}
+
+void TestIndex(std::mt19937& rng) {
+  constexpr std::string_view words[] {
+    "Note",
+    "pad",
+    " ",
+    "Σ",
+    "ß",
+    "ss",
+    "C:\\",
+    "Program Files",
+    "exe",
+    "DCS",
+    "é",
+    "E\xcc\x81",
+    "Ａ",
+  };
+  const auto randomText = [&](const std::size_t maxWords) {
+    std::string ret;
+    for (std::size_t i = 0, count = rng() % maxWords; i < count; ++i) {
+      ret += words[rng() % std::size(words)];
+    }
+    return ret;
+  };
+
+  for (int i = 0; i < 300; ++i) {
+    Entries entries;
+    FoldedStringIndex index;
+    for (std::size_t j = 0, count = rng() % 30; j < count; ++j) {
+      const auto& [first, second]
+        = entries.emplace_back(randomText(6), randomText(6));
+      OPENKNEEBOARD_CHECK(index.Add({first, second}) == j);
+    }
+    OPENKNEEBOARD_CHECK(index.GetEntryCount() == entries.size());
+
+    // Typing, deleting, and starting again
+    std::string query;
+    for (int step = 0; step < 20; ++step) {
+      if (rng() % 4 == 0 && !query.empty()) {
+        query.pop_back();
+      } else if (rng() % 8 == 0) {
+        query.clear();
+      } else {
+        query += words[rng() % std::size(words)];
+      }
+      const auto matches = index.Filter(query);
+      if (!OPENKNEEBOARD_CHECK(
+            std::ranges::equal(matches, ReferenceFilter(entries, query)))) {
+        return;
+      }
+    }
+  }
+
+  FoldedStringIndex index;
+  index.Add({"Notepad", "C:\\Windows\\notepad.exe"});
+  index.Add({"DCS World", "C:\\Program Files\\DCS.exe"});
+  OPENKNEEBOARD_CHECK(std::ranges::equal(
+    index.Filter("EXE dcs"), std::array<FoldedStringIndex::EntryIndex, 1> {1}));
+  index.Clear();
+  OPENKNEEBOARD_CHECK(index.GetEntryCount() == 0);
+  OPENKNEEBOARD_CHECK(index.Filter("").empty());
+}
+
+}// namespace
+
+int main() {
+  std::mt19937 rng(2);
+  TestFold(rng);
+  TestIndex(rng);
+  return Tests::Finish();
+}
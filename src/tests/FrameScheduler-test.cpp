@@ -0,0 +1,291 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "check.hpp"
+
+#include <OpenKneeboard/FrameScheduler.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <print>
+#include <vector>
+
+using namespace OpenKneeboard;
+using namespace std::chrono_literals;
+
+namespace {
+
+using TimePoint = FrameScheduler::TimePoint;
+using Duration = FrameScheduler::Duration;
+
+// Not the clock's epoch, as the scheduler treats that as 'no frame'
+const TimePoint Start {std::chrono::seconds(1000)};
+
+constexpr Duration Hz(const int64_t hz) {
+  return Duration {1'000'000'000 / hz};
+}
+
+/// A consumer rendering at a fixed rate from `mFirstFrame`
+struct FakeConsumer {
+  FrameScheduler::ConsumerID mID {};
+  Duration mPeriod {};
+  TimePoint mFirstFrame {Start};
+  std::optional<TimePoint> mStoppedAt {};
+
+  /// The latest frame at or before `now`, as reported through SHM
+  TimePoint GetLatestFrame(TimePoint now) const {
+    if (mStoppedAt) {
+      now = std::min(now, *mStoppedAt);
+    }
+    if (now < mFirstFrame) {
+      return {};
+    }
+    return mFirstFrame + (((now - mFirstFrame) / mPeriod) * mPeriod);
+  }
+};
+
+/** Drives a scheduler like `MainWindow::FrameLoop()`, with an injected clock.
+ *
+ * Time only advances when the loop sleeps or 'renders', so results are
+ * deterministic.
+ */
+class Simulation {
+ public:
+  explicit Simulation(const FrameScheduler::Options& options = {})
+    : mScheduler(options) {}
+
+  FrameScheduler mScheduler;
+  std::vector<FakeConsumer> mConsumers;
+  Duration mRenderDuration {2ms};
+  /// If set, repaints are requested every tick
+  bool mBusy {false};
+
+  TimePoint mNow {Start};
+  std::vector<TimePoint> mWakes;
+  /// When each render finished
+  std::vector<TimePoint> mRenders;
+
+  void RunUntil(const TimePoint end) {
+    while (mNow < end) {
+      for (auto&& consumer: mConsumers) {
+        mScheduler.ObserveConsumerFrame(
+          consumer.mID, consumer.GetLatestFrame(mNow));
+      }
+      mWakes.push_back(mNow);
+      const auto active = mScheduler.HasActiveConsumer(mNow);
+      mScheduler.ScheduleNextWake(mNow);
+
+      if (mBusy) {
+        mScheduler.NotifyRepaintNeeded(mNow);
+      }
+      if (active && mBusy) {
+        mNow += mRenderDuration;
+        mRenders.push_back(mNow);
+        mScheduler.ObserveRenderDuration(mRenderDuration);
+      }
+      mNow = std::max(mNow, mScheduler.GetScheduledWake());
+    }
+  }
+
+  std::size_t CountWakesSince(const TimePoint since) const {
+    return static_cast<std::size_t>(std::ranges::count_if(
+      mWakes, [since](const auto it) { return it >= since; }));
+  }
+};
+
+struct FrameCoverage {
+  std::size_t mFrames {};
+  /// Frames with a render finishing in the preceding frame interval
+  std::size_t mFresh {};
+  /// Renders beyond the first in the same frame interval
+  std::size_t mWasted {};
+};
+
+FrameCoverage GetCoverage(
+  const Simulation& simulation,
+  const FakeConsumer& consumer,
+  const TimePoint from,
+  const TimePoint to) {
+  FrameCoverage ret;
+  auto frame = consumer.GetLatestFrame(from) + consumer.mPeriod;
+  for (; frame <= to; frame += consumer.mPeriod) {
+    const auto count = std::ranges::count_if(
+      simulation.mRenders, [&](const auto render) {
+        return render > frame - consumer.mPeriod && render <= frame;
+      });
+    ++ret.mFrames;
+    if (count > 0) {
+      ++ret.mFresh;
+      ret.mWasted += static_cast<std::size_t>(count - 1);
+    }
+  }
+  return ret;
+}
+
+void TestIdle() {
+  Simulation simulation;
+  simulation.RunUntil(Start + 1s);
+  OPENKNEEBOARD_CHECK(
+    !simulation.mScheduler.HasActiveConsumer(simulation.mNow));
+  // Housekeeping only
+  OPENKNEEBOARD_CHECK(simulation.mWakes.size() == 10);
+  OPENKNEEBOARD_CHECK(simulation.mRenders.empty());
+}
+
+void TestLearnsPeriod() {
+  for (const auto hz: {72, 90, 120, 144}) {
+    Simulation simulation;
+    simulation.mConsumers.push_back({.mID = 1, .mPeriod = Hz(hz)});
+    simulation.RunUntil(Start + 500ms);
+
+    const auto period = simulation.mScheduler.GetConsumerPeriod(1);
+    if (!OPENKNEEBOARD_CHECK(period)) {
+      continue;
+    }
+    const auto error
+      = (*period > Hz(hz)) ? (*period - Hz(hz)) : (Hz(hz) - *period);
+    OPENKNEEBOARD_CHECK(error < 10us);
+  }
+}
+
+/// With continuous repaints, render once for every consumer frame, just
+/// before it
+void TestBusyPacing() {
+  Simulation simulation;
+  const FakeConsumer consumer {.mID = 1, .mPeriod = Hz(90)};
+  simulation.mConsumers.push_back(consumer);
+  simulation.mBusy = true;
+  simulation.RunUntil(Start + 2s);
+
+  const auto coverage
+    = GetCoverage(simulation, consumer, Start + 500ms, Start + 2s);
+  std::println(
+    "90Hz busy: {}/{} frames fresh, {} wasted renders",
+    coverage.mFresh,
+    coverage.mFrames,
+    coverage.mWasted);
+  OPENKNEEBOARD_CHECK(coverage.mFresh * 100 >= coverage.mFrames * 98);
+  OPENKNEEBOARD_CHECK(coverage.mWasted * 100 <= coverage.mFrames * 2);
+
+  // Renders finish just before the frame, not most of a frame early
+  for (auto&& render: simulation.mRenders) {
+    if (render < Start + 500ms) {
+      continue;
+    }
+    const auto nextFrame
+      = consumer.GetLatestFrame(render) + consumer.mPeriod;
+    OPENKNEEBOARD_CHECK(nextFrame - render < consumer.mPeriod / 2);
+  }
+}
+
+/// Without repaint demand, wake at roughly the quiet period
+void TestQuiet() {
+  Simulation simulation;
+  simulation.mConsumers.push_back({.mID = 1, .mPeriod = Hz(90)});
+  simulation.RunUntil(Start + 2s);
+
+  // Aligned to the next frame that's at least a quiet period after the
+  // previous one, and we wake `lead` before a frame
+  const FrameScheduler::Options options;
+  const auto& wakes = simulation.mWakes;
+  for (std::size_t i = 1; i < wakes.size(); ++i) {
+    if (wakes.at(i - 1) < Start + 1s) {
+      continue;
+    }
+    const auto interval = wakes.at(i) - wakes.at(i - 1);
+    OPENKNEEBOARD_CHECK(interval > options.mQuietPeriod - Hz(90));
+    OPENKNEEBOARD_CHECK(interval <= options.mQuietPeriod);
+  }
+  OPENKNEEBOARD_CHECK(simulation.mRenders.empty());
+
+  // A repaint request brings the next wake forward
+  const auto quietWake = simulation.mScheduler.GetScheduledWake();
+  const auto demandWake = simulation.mScheduler.NotifyRepaintNeeded(
+    simulation.mWakes.back() + 1ms);
+  OPENKNEEBOARD_CHECK(demandWake && *demandWake < quietWake);
+}
+
+/// Pace to the fastest consumer
+void TestMultipleConsumers() {
+  Simulation simulation;
+  const FakeConsumer fast {.mID = 2, .mPeriod = Hz(120)};
+  simulation.mConsumers.push_back({.mID = 1, .mPeriod = Hz(90)});
+  simulation.mConsumers.push_back(fast);
+  simulation.mBusy = true;
+  simulation.RunUntil(Start + 2s);
+
+  const auto coverage = GetCoverage(simulation, fast, Start + 1s, Start + 2s);
+  OPENKNEEBOARD_CHECK(coverage.mFresh * 100 >= coverage.mFrames * 95);
+}
+
+void TestConsumerStops() {
+  Simulation simulation;
+  simulation.mConsumers.push_back(
+    {.mID = 1, .mPeriod = Hz(90), .mStoppedAt = Start + 1s});
+  simulation.mBusy = true;
+  simulation.RunUntil(Start + 3s);
+
+  auto& scheduler = simulation.mScheduler;
+  OPENKNEEBOARD_CHECK(!scheduler.HasActiveConsumer(simulation.mNow));
+  // Back to housekeeping once the consumer times out
+  OPENKNEEBOARD_CHECK(simulation.CountWakesSince(Start + 2s + 100ms) <= 10);
+  OPENKNEEBOARD_CHECK(
+    std::ranges::none_of(simulation.mRenders, [](const auto it) {
+      return it > Start + 2s + 100ms;
+    }));
+}
+
+/// A long gap (e.g. a loading screen) resets the learned period
+void TestPause() {
+  FrameScheduler scheduler;
+  auto now = Start;
+  for (int i = 0; i < 10; ++i) {
+    scheduler.ObserveConsumerFrame(1, now);
+    now += Hz(90);
+  }
+  OPENKNEEBOARD_CHECK(scheduler.GetConsumerPeriod(1));
+
+  now += 1s;
+  scheduler.ObserveConsumerFrame(1, now);
+  OPENKNEEBOARD_CHECK(!scheduler.GetConsumerPeriod(1));
+
+  // Relearned, at the new rate
+  for (int i = 0; i < 10; ++i) {
+    now += Hz(60);
+    scheduler.ObserveConsumerFrame(1, now);
+  }
+  const auto period = scheduler.GetConsumerPeriod(1);
+  OPENKNEEBOARD_CHECK(period && *period == Hz(60));
+}
+
+/// Slow renders lead by at most half a frame
+void TestSlowRender() {
+  Simulation simulation;
+  const FakeConsumer consumer {.mID = 1, .mPeriod = Hz(90)};
+  simulation.mConsumers.push_back(consumer);
+  simulation.mBusy = true;
+  simulation.mRenderDuration = 8ms;
+  simulation.RunUntil(Start + 2s);
+
+  const auto coverage
+    = GetCoverage(simulation, consumer, Start + 1s, Start + 2s);
+  // Can't render every frame in time, but shouldn't fall to every other
+  // frame
+  OPENKNEEBOARD_CHECK(coverage.mFresh * 100 >= coverage.mFrames * 60);
+}
+
+}// namespace
+
+int main() {
+  TestIdle();
+  TestLearnsPeriod();
+  TestBusyPacing();
+  TestQuiet();
+  TestMultipleConsumers();
+  TestConsumerStops();
+  TestPause();
+  TestSlowRender();
+  return Tests::Finish();
+}
@@ -0,0 +1,167 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "check.hpp"
+
+#include <OpenKneeboard/InputRecording.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace OpenKneeboard::InputRecording;
+using namespace std::chrono_literals;
+
+namespace Tests = OpenKneeboard::Tests;
+
+namespace {
+
+std::string Payload(const std::size_t i) {
+  return std::string(40 + (i % 50), static_cast<char>('a' + (i % 26)));
+}
+
+bool Equals(
+  const std::optional<std::vector<Message>>& actual,
+  std::span<const Message> expected) {
+  return actual
+    && std::ranges::equal(*actual, expected, [](const auto& a, const auto& b) {
+         return a.mStream == b.mStream && a.mOffset == b.mOffset
+           && a.mPayload == b.mPayload;
+       });
+}
+
+std::vector<Message> SyntheticMessages() {
+  // A 200Hz pen, with occasional bursts of API events, and some varint edge
+  // cases for the offsets and sizes
+  std::vector<Message> ret;
+  for (std::size_t i = 0; i < 2000; ++i) {
+    ret.push_back({
+      Stream::OTDIPC,
+      std::chrono::nanoseconds {static_cast<int64_t>(i) * 5'000'000},
+      std::string(64, 'x'),
+    });
+    if (i % 100 == 0) {
+      for (std::size_t j = 0; j < 10; ++j) {
+        ret.push_back({Stream::APIEvent, ret.back().mOffset, Payload(j)});
+      }
+    }
+  }
+  ret.push_back({Stream::APIEvent, ret.back().mOffset + 127ns, {}});
+  ret.push_back(
+    {Stream::APIEvent, ret.back().mOffset + 128ns, std::string(128, 'y')});
+  ret.push_back({Stream::OTDIPC, ret.back().mOffset + 1h, Payload(0)});
+  return ret;
+}
+
+std::string Serialize(const std::vector<Message>& messages) {
+  std::stringstream out;
+  WriteHeader(out);
+  std::chrono::nanoseconds previous {};
+  for (auto&& message: messages) {
+    WriteMessage(out, message, previous);
+    previous = message.mOffset;
+  }
+  return out.str();
+}
+
+std::optional<std::vector<Message>> Deserialize(const std::string& data) {
+  std::stringstream in(data);
+  return Read(in);
+}
+
+void TestCodec() {
+  const auto messages = SyntheticMessages();
+  const auto data = Serialize(messages);
+  OPENKNEEBOARD_CHECK(Equals(Deserialize(data), messages));
+
+  // Truncated, e.g. by a crash: keep the complete messages
+  OPENKNEEBOARD_CHECK(Equals(
+    Deserialize(data.substr(0, data.size() - 10)),
+    std::span {messages}.first(messages.size() - 1)));
+  OPENKNEEBOARD_CHECK(Equals(Deserialize(Serialize({})), {}));
+
+  OPENKNEEBOARD_CHECK(!Deserialize({}));
+  OPENKNEEBOARD_CHECK(!Deserialize(data.substr(0, 4)));
+  auto badMagic = data;
+  badMagic[0] = 'X';
+  OPENKNEEBOARD_CHECK(!Deserialize(badMagic));
+  auto badVersion = data;
+  badVersion[8] = 2;
+  OPENKNEEBOARD_CHECK(!Deserialize(badVersion));
+}
+
+void TestRecording() {
+  const auto path = std::filesystem::temp_directory_path()
+    / "OpenKneeboard-InputRecording-test.okinput";
+
+  OPENKNEEBOARD_CHECK(!IsRecording());
+  Record(Stream::APIEvent, "dropped");
+  if (!OPENKNEEBOARD_CHECK(StartRecording(path))) {
+    return;
+  }
+  OPENKNEEBOARD_CHECK(IsRecording());
+  for (std::size_t i = 0; i < 1000; ++i) {
+    Record((i % 3) ? Stream::OTDIPC : Stream::APIEvent, Payload(i));
+  }
+  StopRecording();
+  OPENKNEEBOARD_CHECK(!IsRecording());
+  Record(Stream::APIEvent, "dropped");
+
+  const auto messages = Read(path);
+  std::filesystem::remove(path);
+  if (!OPENKNEEBOARD_CHECK(messages && messages->size() == 1000)) {
+    return;
+  }
+  for (std::size_t i = 0; i < messages->size(); ++i) {
+    const auto& message = messages->at(i);
+    OPENKNEEBOARD_CHECK(message.mPayload == Payload(i));
+    OPENKNEEBOARD_CHECK(
+      message.mStream == ((i % 3) ? Stream::OTDIPC : Stream::APIEvent));
+    if (i > 0) {
+      OPENKNEEBOARD_CHECK(message.mOffset >= messages->at(i - 1).mOffset);
+    }
+  }
+}
+
+void TestPlayer() {
+  const std::vector<Message> messages {
+    {Stream::APIEvent, 0ms, "a"},
+    {Stream::OTDIPC, 10ms, "b"},
+    {Stream::OTDIPC, 30ms, "c"},
+  };
+
+  Player realtime(messages);
+  OPENKNEEBOARD_CHECK(realtime.GetMessageCount() == 3);
+  OPENKNEEBOARD_CHECK(realtime.GetNextDueOffset() == 0ms);
+  OPENKNEEBOARD_CHECK(realtime.Pop().mPayload == "a");
+  OPENKNEEBOARD_CHECK(realtime.GetNextDueOffset() == 10ms);
+
+  Player fast(messages, 10);
+  (void)fast.Pop();
+  (void)fast.Pop();
+  OPENKNEEBOARD_CHECK(fast.GetNextDueOffset() == 3ms);
+  (void)fast.Pop();
+  OPENKNEEBOARD_CHECK(fast.IsFinished());
+
+  // As fast as possible
+  Player player(messages, 0);
+  OPENKNEEBOARD_CHECK(player.GetNextDueOffset() == 0ms);
+  std::string played;
+  PlayBlocking(
+    player, [&](const Message& message) { played += message.mPayload; });
+  OPENKNEEBOARD_CHECK(played == "abc");
+  OPENKNEEBOARD_CHECK(player.IsFinished());
+}
+
+}// namespace
+
+int main() {
+  TestCodec();
+  TestRecording();
+  TestPlayer();
+  return Tests::Finish();
+}
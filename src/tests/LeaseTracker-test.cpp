@@ -0,0 +1,136 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "check.hpp"
+
+#include <OpenKneeboard/LeaseTracker.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace OpenKneeboard;
+using namespace std::chrono_literals;
+
+namespace {
+
+using Clock = LeaseTracker::Clock;
+using Key = LeaseTracker::Key;
+
+constexpr auto GracePeriod = 60s;
+// Not the clock's epoch, to catch 'unset' being treated as 'now'
+const Clock::time_point Start {std::chrono::hours(1)};
+
+void TestLeases() {
+  LeaseTracker tracker {GracePeriod};
+  const auto first = tracker.Acquire("a");
+  OPENKNEEBOARD_CHECK(first.mIsNew && !first.mWasIdle);
+  const auto second = tracker.Acquire("a");
+  OPENKNEEBOARD_CHECK(!second.mIsNew && !second.mWasIdle);
+  OPENKNEEBOARD_CHECK(tracker.GetLeaseCount("a") == 2);
+  OPENKNEEBOARD_CHECK(tracker.GetLeaseCount("b") == 0);
+
+  // Still leased, so not idle
+  OPENKNEEBOARD_CHECK(tracker.Release("a", Start));
+  OPENKNEEBOARD_CHECK(!tracker.GetNextExpiry());
+  OPENKNEEBOARD_CHECK(tracker.Expire(Start + 1h).empty());
+
+  OPENKNEEBOARD_CHECK(tracker.Release("a", Start));
+  OPENKNEEBOARD_CHECK(tracker.GetLeaseCount("a") == 0);
+  // Unbalanced releases are rejected, rather than underflowing
+  OPENKNEEBOARD_CHECK(!tracker.Release("a", Start));
+  OPENKNEEBOARD_CHECK(!tracker.Release("b", Start));
+
+  const auto stats = tracker.GetStats();
+  OPENKNEEBOARD_CHECK(stats.mHits == 1);
+  OPENKNEEBOARD_CHECK(stats.mMisses == 1);
+  OPENKNEEBOARD_CHECK(stats.mEntryCount == 1);
+  OPENKNEEBOARD_CHECK(stats.mIdleCount == 1);
+}
+
+void TestExpiry() {
+  LeaseTracker tracker {GracePeriod};
+  std::ignore = tracker.Acquire("a");
+  std::ignore = tracker.Acquire("b");
+  tracker.Release("a", Start);
+  tracker.Release("b", Start + 10s);
+  OPENKNEEBOARD_CHECK(tracker.GetNextExpiry() == Start + GracePeriod);
+
+  OPENKNEEBOARD_CHECK(tracker.Expire(Start + GracePeriod - 1s).empty());
+  OPENKNEEBOARD_CHECK(
+    tracker.Expire(Start + GracePeriod) == std::vector<Key> {"a"});
+  OPENKNEEBOARD_CHECK(tracker.GetNextExpiry() == Start + 10s + GracePeriod);
+
+  // Reusing an idle entry cancels its expiry
+  const auto reused = tracker.Acquire("b");
+  OPENKNEEBOARD_CHECK(!reused.mIsNew && reused.mWasIdle);
+  OPENKNEEBOARD_CHECK(!tracker.GetNextExpiry());
+  OPENKNEEBOARD_CHECK(tracker.Expire(Start + 1h).empty());
+
+  // ... and the grace period restarts when it's released again
+  tracker.Release("b", Start + 1h);
+  OPENKNEEBOARD_CHECK(tracker.Expire(Start + 1h + 1s).empty());
+  OPENKNEEBOARD_CHECK(
+    tracker.Expire(Start + 1h + GracePeriod) == std::vector<Key> {"b"});
+
+  // Expired entries are new again
+  OPENKNEEBOARD_CHECK(tracker.Acquire("a").mIsNew);
+
+  const auto stats = tracker.GetStats();
+  OPENKNEEBOARD_CHECK(stats.mExpirations == 2);
+  OPENKNEEBOARD_CHECK(stats.mIdleHits == 1);
+  OPENKNEEBOARD_CHECK(stats.mEntryCount == 1);
+  OPENKNEEBOARD_CHECK(stats.mIdleCount == 0);
+}
+
+/// As `FolderPageSourceRegistry` does when loading a folder fails
+void TestRemove() {
+  LeaseTracker tracker {GracePeriod};
+  std::ignore = tracker.Acquire("leased");
+  std::ignore = tracker.Acquire("idle");
+  tracker.Release("idle", Start);
+
+  tracker.Remove("leased");
+  tracker.Remove("idle");
+  tracker.Remove("unknown");
+  OPENKNEEBOARD_CHECK(tracker.GetLeaseCount("leased") == 0);
+  OPENKNEEBOARD_CHECK(!tracker.Release("leased", Start));
+  OPENKNEEBOARD_CHECK(!tracker.GetNextExpiry());
+  OPENKNEEBOARD_CHECK(tracker.Expire(Start + 1h).empty());
+  // The next request retries, instead of sharing the failure
+  OPENKNEEBOARD_CHECK(tracker.Acquire("leased").mIsNew);
+
+  const auto stats = tracker.GetStats();
+  OPENKNEEBOARD_CHECK(stats.mExpirations == 0);
+  OPENKNEEBOARD_CHECK(stats.mEntryCount == 1);
+  OPENKNEEBOARD_CHECK(stats.mIdleCount == 0);
+}
+
+void TestClear() {
+  LeaseTracker tracker {GracePeriod};
+  std::ignore = tracker.Acquire("a");
+  std::ignore = tracker.Acquire("b");
+  tracker.Release("b", Start);
+
+  auto keys = tracker.Clear();
+  std::ranges::sort(keys);
+  OPENKNEEBOARD_CHECK((keys == std::vector<Key> {"a", "b"}));
+  OPENKNEEBOARD_CHECK(tracker.Clear().empty());
+  OPENKNEEBOARD_CHECK(!tracker.GetNextExpiry());
+
+  const auto stats = tracker.GetStats();
+  OPENKNEEBOARD_CHECK(stats.mEntryCount == 0);
+  OPENKNEEBOARD_CHECK(stats.mIdleCount == 0);
+}
+
+}// namespace
+
+int main() {
+  TestLeases();
+  TestExpiry();
+  TestRemove();
+  TestClear();
+  return Tests::Finish();
+}
@@ -0,0 +1,220 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "check.hpp"
+
+#include <OpenKneeboard/LogRing.hpp>
+
+#include <chrono>
+#include <optional>
+#include <print>
+#include <string>
+#include <vector>
+
+using namespace OpenKneeboard;
+
+namespace {
+
+using Level = LogRing::Level;
+
+constexpr LogRing::Filter ForLevel(const Level level) {
+  return {.mSource = std::nullopt, .mLevel = level};
+}
+
+constexpr LogRing::Filter ForSource(const LogRing::SourceID source) {
+  return {.mSource = source, .mLevel = std::nullopt};
+}
+
+const auto Now = LogRing::Clock::now();
+
+/// The level of the `i`th message pushed by `Fill()`
+Level LevelFor(const LogRing::Sequence i) {
+  if (i % 50 == 0) {
+    return Level::Error;
+  }
+  if (i % 10 == 0) {
+    return Level::Warning;
+  }
+  return Level::Verbose;
+}
+
+/// Push `count` messages, spread over three sources
+void Fill(LogRing& ring, const std::size_t count) {
+  for (std::size_t i = 1; i <= count; ++i) {
+    ring.Push(
+      Now,
+      1234,
+      (i % 3) ? "OpenKneeboardApp.exe" : "DCS.exe",
+      (i % 2) ? "app" : "client",
+      LevelFor(i),
+      std::format("message {}", i));
+  }
+}
+
+/// Everything with a sequence number greater than `after`, in batches
+std::vector<LogRing::Sequence> VisitAll(
+  const LogRing& ring,
+  const LogRing::Filter& filter,
+  const std::size_t batchSize,
+  LogRing::Sequence after = 0) {
+  std::vector<LogRing::Sequence> ret;
+  while (true) {
+    const auto next = ring.VisitSince(
+      after, batchSize, filter, [&](const auto& entry, const auto&) {
+        ret.push_back(entry.mSequence);
+      });
+    if (!OPENKNEEBOARD_CHECK(next)) {
+      return ret;
+    }
+    if (*next == after) {
+      return ret;
+    }
+    after = *next;
+  }
+}
+
+void TestEntryCap() {
+  LogRing ring({.mMaxEntries = 100});
+  Fill(ring, 1000);
+
+  const auto stats = ring.GetStatistics();
+  OPENKNEEBOARD_CHECK(stats.mEntries == 100);
+  OPENKNEEBOARD_CHECK(stats.mDropped == 900);
+  OPENKNEEBOARD_CHECK(ring.GetLatestSequence() == 1000);
+
+  // The newest entries are kept, in order, without gaps
+  const auto sequences = VisitAll(ring, {}, 7);
+  OPENKNEEBOARD_CHECK(sequences.size() == 100);
+  for (std::size_t i = 0; i < sequences.size(); ++i) {
+    OPENKNEEBOARD_CHECK(sequences.at(i) == 901 + i);
+  }
+
+  // Resuming from a dropped sequence number starts at the oldest entry
+  OPENKNEEBOARD_CHECK(VisitAll(ring, {}, 1000, 5).front() == 901);
+  // ... and resuming from the latest finds nothing
+  OPENKNEEBOARD_CHECK(VisitAll(ring, {}, 1000, 1000).empty());
+}
+
+void TestByteCap() {
+  LogRing ring({
+    .mMaxEntries = 1000,
+    .mMaxBytes = 1000,
+    .mMaxMessageBytes = 50,
+  });
+  for (std::size_t i = 0; i < 1000; ++i) {
+    ring.Push(Now, 1, "a.exe", "", Level::Verbose, std::string(i % 40, 'x'));
+  }
+  const auto stats = ring.GetStatistics();
+  OPENKNEEBOARD_CHECK(stats.mBytes <= 1000);
+  OPENKNEEBOARD_CHECK(stats.mEntries < 1000);
+  OPENKNEEBOARD_CHECK(stats.mEntries + stats.mDropped == 1000);
+  OPENKNEEBOARD_CHECK(stats.mTruncated == 0);
+
+  // A multi-byte sequence straddling the limit is dropped, not split
+  const std::string message = std::string(49, 'y') + "\xC3\xA9" + "tail";
+  const auto sequence
+    = ring.Push(Now, 1, "a.exe", "", Level::Verbose, message);
+  OPENKNEEBOARD_CHECK(ring.GetStatistics().mTruncated == 1);
+  const auto entries = ring.GetSince(sequence - 1);
+  if (OPENKNEEBOARD_CHECK(entries.size() == 1)) {
+    OPENKNEEBOARD_CHECK(entries.front().mMessage == std::string(49, 'y'));
+  }
+}
+
+void TestFilters() {
+  // Small enough that the indices have to drop entries too
+  LogRing ring({.mMaxEntries = 500});
+  Fill(ring, 2000);
+
+  const auto sources = ring.GetSources();
+  OPENKNEEBOARD_CHECK(sources.size() == 4);
+  OPENKNEEBOARD_CHECK(ring.GetSource(99).mExecutable.empty());
+
+  const auto all = ring.GetSince(0);
+  std::vector<LogRing::Filter> filters {
+    ForLevel(Level::Error),
+    ForLevel(Level::Warning),
+    ForLevel(Level::Verbose),
+  };
+  for (LogRing::SourceID id = 0; id < sources.size(); ++id) {
+    filters.push_back(ForSource(id));
+    filters.push_back({.mSource = id, .mLevel = Level::Error});
+  }
+
+  for (auto&& filter: filters) {
+    // Brute force over every entry
+    std::vector<LogRing::Sequence> expected;
+    for (auto&& entry: all) {
+      OPENKNEEBOARD_CHECK(entry.mLevel == LevelFor(entry.mSequence));
+      if (
+        (!filter.mSource || entry.mSource == *filter.mSource)
+        && (!filter.mLevel || entry.mLevel == *filter.mLevel)) {
+        expected.push_back(entry.mSequence);
+      }
+    }
+
+    std::vector<LogRing::Sequence> copied;
+    for (auto&& entry: ring.GetSince(0, filter)) {
+      copied.push_back(entry.mSequence);
+    }
+    OPENKNEEBOARD_CHECK(copied == expected);
+    OPENKNEEBOARD_CHECK(VisitAll(ring, filter, 3) == expected);
+    OPENKNEEBOARD_CHECK(ring.GetCount(filter) == expected.size());
+  }
+
+  OPENKNEEBOARD_CHECK(ring.GetCount({}) == 500);
+  OPENKNEEBOARD_CHECK(ring.GetSince(0, ForSource(99)).empty());
+  OPENKNEEBOARD_CHECK(VisitAll(ring, ForSource(99), 10).empty());
+}
+
+/// Not a pass/fail check; printed so regressions show up in CI logs
+void TestThroughput() {
+  constexpr std::size_t Count = 1'000'000;
+  LogRing ring;
+  const std::string message(120, 'x');
+
+  const auto pushStart = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < Count; ++i) {
+    ring.Push(Now, 1, "a.exe", "app", LevelFor(i), message);
+  }
+  const auto pushEnd = std::chrono::steady_clock::now();
+
+  std::size_t bytes = 0;
+  LogRing::Sequence after = 0;
+  while (true) {
+    const auto next = ring.VisitSince(
+      after, 1024, [&](const auto& entry, const auto&) {
+        bytes += entry.mMessage.size();
+      });
+    if (!(next && *next != after)) {
+      break;
+    }
+    after = *next;
+  }
+  const auto visitEnd = std::chrono::steady_clock::now();
+
+  const auto stats = ring.GetStatistics();
+  OPENKNEEBOARD_CHECK(stats.mEntries + stats.mDropped == Count);
+  OPENKNEEBOARD_CHECK(bytes == stats.mBytes);
+  OPENKNEEBOARD_CHECK(ring.GetCount({}) == stats.mEntries);
+
+  using namespace std::chrono;
+  const auto perSecond = [](const std::size_t n, const auto elapsed) {
+    const auto seconds = duration_cast<duration<double>>(elapsed).count();
+    return static_cast<uint64_t>(n / std::max(seconds, 1e-9));
+  };
+  std::println(
+    "Push: {} messages/s; VisitSince: {} messages/s",
+    perSecond(Count, pushEnd - pushStart),
+    perSecond(stats.mEntries, visitEnd - pushEnd));
+}
+
+}// namespace
+
+int main() {
+  TestEntryCap();
+  TestByteCap();
+  TestFilters();
+  TestThroughput();
+  return Tests::Finish();
+}
@@ -0,0 +1,209 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "check.hpp"
+
+#include <OpenKneeboard/Histogram.hpp>
+#include <OpenKneeboard/Metrics.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace OpenKneeboard;
+
+namespace {
+
+/// Whether `reported` is within the documented error of `actual`
+bool IsAccurate(const uint64_t reported, const uint64_t actual) {
+  const auto error
+    = (reported > actual) ? (reported - actual) : (actual - reported);
+  // Midpoints round down, so allow for that on top of the relative error
+  return error * 2 * Histogram::SubBucketCount <= actual + 1;
+}
+
+void TestBucketBoundaries() {
+  // Small values are exact
+  for (uint64_t value = 0; value < 2 * Histogram::SubBucketCount; ++value) {
+    OPENKNEEBOARD_CHECK(Histogram::GetBucketIndex(value) == value);
+    OPENKNEEBOARD_CHECK(Histogram::GetBucketLowerBound(value) == value);
+    OPENKNEEBOARD_CHECK(Histogram::GetBucketMidpoint(value) == value);
+  }
+
+  // Every bucket is contiguous with the next, and covers the values between
+  for (std::size_t i = 0; i + 1 < Histogram::BucketCount; ++i) {
+    const auto lower = Histogram::GetBucketLowerBound(i);
+    const auto next = Histogram::GetBucketLowerBound(i + 1);
+    if (!OPENKNEEBOARD_CHECK(next > lower)) {
+      return;
+    }
+    OPENKNEEBOARD_CHECK(Histogram::GetBucketIndex(lower) == i);
+    OPENKNEEBOARD_CHECK(Histogram::GetBucketIndex(next - 1) == i);
+    OPENKNEEBOARD_CHECK(Histogram::GetBucketIndex(next) == i + 1);
+
+    const auto midpoint = Histogram::GetBucketMidpoint(i);
+    OPENKNEEBOARD_CHECK(midpoint >= lower && midpoint < next);
+    OPENKNEEBOARD_CHECK(IsAccurate(midpoint, lower));
+    OPENKNEEBOARD_CHECK(IsAccurate(midpoint, next - 1));
+  }
+
+  const auto last = Histogram::BucketCount - 1;
+  OPENKNEEBOARD_CHECK(Histogram::GetBucketIndex(Histogram::MaxValue) == last);
+  OPENKNEEBOARD_CHECK(
+    Histogram::GetBucketLowerBound(last) <= Histogram::MaxValue);
+}
+
+void TestEmpty() {
+  Histogram histogram;
+  const auto summary = histogram.GetSummary();
+  OPENKNEEBOARD_CHECK(summary.mCount == 0);
+  OPENKNEEBOARD_CHECK(summary.mMax == 0);
+  OPENKNEEBOARD_CHECK(summary.mP999 == 0);
+}
+
+void TestExactPercentiles() {
+  Histogram histogram;
+  // Min, max, and mean are exact, regardless of bucketing
+  for (uint64_t value = 0; value < 100; ++value) {
+    histogram.Record(value);
+  }
+  auto summary = histogram.GetSummary();
+  OPENKNEEBOARD_CHECK(summary.mCount == 100);
+  OPENKNEEBOARD_CHECK(summary.mMin == 0);
+  OPENKNEEBOARD_CHECK(summary.mMax == 99);
+  OPENKNEEBOARD_CHECK(summary.mMean == 49);
+
+  histogram.Reset();
+  OPENKNEEBOARD_CHECK(histogram.GetSummary().mCount == 0);
+
+  for (uint64_t value = 1; value <= 20; ++value) {
+    histogram.Record(value);
+  }
+  summary = histogram.GetSummary();
+  // Small values have their own buckets, so these are exact nearest-rank
+  // percentiles: the 10th, 18th, and 20th of 20 values
+  OPENKNEEBOARD_CHECK(summary.mP50 == 10);
+  OPENKNEEBOARD_CHECK(summary.mP90 == 18);
+  OPENKNEEBOARD_CHECK(summary.mP99 == 20);
+  OPENKNEEBOARD_CHECK(summary.mP999 == 20);
+}
+
+/// Compare against percentiles of the exact values
+void TestApproximatePercentiles() {
+  std::mt19937_64 random(1234);
+  // Roughly frame-time shaped: mostly ~11ms, with a long tail
+  std::lognormal_distribution<double> distribution(16.2, 0.4);
+
+  Histogram histogram;
+  std::vector<uint64_t> values;
+  for (int i = 0; i < 100'000; ++i) {
+    const auto value = static_cast<uint64_t>(distribution(random));
+    values.push_back(value);
+    histogram.Record(value);
+  }
+  std::ranges::sort(values);
+  const auto exact = [&](const uint64_t perMille) {
+    const auto rank = ((values.size() * perMille) + 999) / 1000;
+    return values.at(rank - 1);
+  };
+
+  const auto summary = histogram.GetSummary();
+  OPENKNEEBOARD_CHECK(summary.mMin == values.front());
+  OPENKNEEBOARD_CHECK(summary.mMax == values.back());
+  OPENKNEEBOARD_CHECK(IsAccurate(summary.mP50, exact(500)));
+  OPENKNEEBOARD_CHECK(IsAccurate(summary.mP90, exact(900)));
+  OPENKNEEBOARD_CHECK(IsAccurate(summary.mP99, exact(990)));
+  OPENKNEEBOARD_CHECK(IsAccurate(summary.mP999, exact(999)));
+}
+
+void TestClamping() {
+  Histogram histogram;
+  histogram.Record(Histogram::MaxValue + 1000);
+  histogram.Record(UINT64_MAX);
+  const auto summary = histogram.GetSummary();
+  OPENKNEEBOARD_CHECK(summary.mCount == 2);
+  OPENKNEEBOARD_CHECK(summary.mMax == Histogram::MaxValue);
+  OPENKNEEBOARD_CHECK(summary.mP999 == Histogram::MaxValue);
+}
+
+void TestConcurrentRecording() {
+  constexpr uint64_t PerThread = 100'000;
+  Histogram histogram;
+  std::vector<std::jthread> threads;
+  for (uint64_t i = 0; i < 4; ++i) {
+    threads.emplace_back([&histogram, i] {
+      for (uint64_t value = 1; value <= PerThread; ++value) {
+        histogram.Record(value + i);
+      }
+    });
+  }
+  threads.clear();
+
+  const auto summary = histogram.GetSummary();
+  OPENKNEEBOARD_CHECK(summary.mCount == 4 * PerThread);
+  OPENKNEEBOARD_CHECK(summary.mMin == 1);
+  OPENKNEEBOARD_CHECK(summary.mMax == PerThread + 3);
+}
+
+void TestBlock() {
+  const auto block = std::make_unique<Metrics::Block>();
+  auto& registry = Metrics::Registry::Get();
+  OPENKNEEBOARD_CHECK(registry.SetStorage(block.get()));
+
+  const auto frames = registry.GetHistogram("Frames");
+  OPENKNEEBOARD_CHECK(frames && registry.GetHistogram("Frames") == frames);
+  // Too late to move the storage
+  OPENKNEEBOARD_CHECK(!registry.SetStorage(nullptr));
+
+  frames->Record(1000);
+  registry.GetCounter("Dropped")->fetch_add(3);
+
+  // Long names are truncated, and still deduplicated
+  const std::string longName(100, 'x');
+  const auto truncated = registry.GetCounter(longName);
+  OPENKNEEBOARD_CHECK(
+    truncated
+    && registry.GetCounter(longName.substr(0, Metrics::Block::MaxNameLength))
+      == truncated);
+
+  // Read from the block directly, as another process would
+  const auto snapshot = block->GetSnapshot();
+  if (OPENKNEEBOARD_CHECK(snapshot.mHistograms.size() == 1)) {
+    OPENKNEEBOARD_CHECK(snapshot.mHistograms.front().mName == "Frames");
+    OPENKNEEBOARD_CHECK(snapshot.mHistograms.front().mSummary.mP50 == 1000);
+  }
+  if (OPENKNEEBOARD_CHECK(snapshot.mCounters.size() == 2)) {
+    OPENKNEEBOARD_CHECK(snapshot.mCounters.front().mValue == 3);
+    OPENKNEEBOARD_CHECK(
+      snapshot.mCounters.back().mName.size() == Metrics::Block::MaxNameLength);
+  }
+  const auto formatted = Metrics::FormatSnapshot(snapshot);
+  OPENKNEEBOARD_CHECK(formatted.contains("Frames"));
+  OPENKNEEBOARD_CHECK(formatted.contains("1.0µs"));
+
+  // Full registries return nullptr rather than overwriting
+  for (std::size_t i = 1; i < Metrics::Block::MaxHistograms; ++i) {
+    OPENKNEEBOARD_CHECK(registry.GetHistogram(std::to_string(i)));
+  }
+  OPENKNEEBOARD_CHECK(!registry.GetHistogram("overflow"));
+
+  block->Reset();
+  OPENKNEEBOARD_CHECK(block->GetSnapshot().mHistograms.empty());
+}
+
+}// namespace
+
+int main() {
+  TestBucketBoundaries();
+  TestEmpty();
+  TestExactPercentiles();
+  TestApproximatePercentiles();
+  TestClamping();
+  TestConcurrentRecording();
+  TestBlock();
+  return Tests::Finish();
+}
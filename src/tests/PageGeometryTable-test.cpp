@@ -0,0 +1,98 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "check.hpp"
+
+#include <OpenKneeboard/PageGeometryTable.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+
+using namespace OpenKneeboard;
+
+namespace {
+
+PreferredSize MakeBitmapSize(const uint32_t width, const uint32_t height) {
+  return {{width, height}, ScalingKind::Bitmap, std::nullopt};
+}
+
+// Stands in for e.g. an image source, where measuring a page is expensive
+struct FakeSource {
+  std::unordered_map<uint64_t, PreferredSize> mActual;
+  PageGeometryTable<uint64_t> mGeometry;
+  int mMeasurements {};
+
+  std::optional<PreferredSize> GetPreferredSize(const uint64_t id) {
+    return mGeometry.FindOrMeasure(id, [&]() -> std::optional<PreferredSize> {
+      ++mMeasurements;
+      const auto it = mActual.find(id);
+      if (it == mActual.end()) {
+        return std::nullopt;
+      }
+      return it->second;
+    });
+  }
+};
+
+void TestMeasure() {
+  FakeSource source;
+  source.mActual[1] = MakeBitmapSize(100, 200);
+  source.mActual[2] = {
+    {300, 400},
+    ScalingKind::Vector,
+    PhysicalSize {PhysicalSize::Direction::Vertical, 0.2f},
+  };
+
+  OPENKNEEBOARD_CHECK(
+    source.GetPreferredSize(1)->mPixelSize == (PixelSize {100, 200}));
+  OPENKNEEBOARD_CHECK(
+    source.GetPreferredSize(1)->mPixelSize == (PixelSize {100, 200}));
+  OPENKNEEBOARD_CHECK(source.mMeasurements == 1);
+
+  const auto two = source.GetPreferredSize(2);
+  OPENKNEEBOARD_CHECK(two && two->mScalingKind == ScalingKind::Vector);
+  OPENKNEEBOARD_CHECK(
+    two && two->mPhysicalSize && two->mPhysicalSize->mLength == 0.2f);
+
+  // Failed measurements aren't cached
+  OPENKNEEBOARD_CHECK(!source.GetPreferredSize(3));
+  OPENKNEEBOARD_CHECK(!source.GetPreferredSize(3));
+  OPENKNEEBOARD_CHECK(source.mMeasurements == 4);
+  source.mActual[3] = MakeBitmapSize(5, 6);
+  OPENKNEEBOARD_CHECK(source.GetPreferredSize(3));
+  OPENKNEEBOARD_CHECK(source.mGeometry.GetPageCount() == 3);
+}
+
+void TestUpdates() {
+  FakeSource source;
+  source.mActual[1] = MakeBitmapSize(100, 200);
+  OPENKNEEBOARD_CHECK(source.GetPreferredSize(1));
+
+  // Filled in when the page is loaded, e.g. rendered
+  source.mGeometry.Set(4, MakeBitmapSize(7, 8));
+  const auto measurements = source.mMeasurements;
+  OPENKNEEBOARD_CHECK(
+    source.GetPreferredSize(4)->mPixelSize == (PixelSize {7, 8}));
+  OPENKNEEBOARD_CHECK(source.mMeasurements == measurements);
+
+  // Content changed: stale until the source erases the page
+  source.mActual[1] = MakeBitmapSize(1, 1);
+  OPENKNEEBOARD_CHECK(
+    source.GetPreferredSize(1)->mPixelSize == (PixelSize {100, 200}));
+  source.mGeometry.Erase(1);
+  OPENKNEEBOARD_CHECK(
+    source.GetPreferredSize(1)->mPixelSize == (PixelSize {1, 1}));
+
+  source.mGeometry.Clear();
+  OPENKNEEBOARD_CHECK(source.mGeometry.GetPageCount() == 0);
+  OPENKNEEBOARD_CHECK(!source.mGeometry.Find(4));
+}
+
+}// namespace
+
+int main() {
+  TestMeasure();
+  TestUpdates();
+  return Tests::Finish();
+}
@@ -0,0 +1,259 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "check.hpp"
+
+#include <OpenKneeboard/PagePrerenderPolicy.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <print>
+#include <vector>
+
+using namespace OpenKneeboard;
+using namespace std::chrono_literals;
+
+namespace {
+
+using Policy = PagePrerenderPolicy;
+using PageKey = Policy::PageKey;
+using TimePoint = Policy::TimePoint;
+
+constexpr std::size_t MiB = 1024 * 1024;
+// Not the clock's epoch, so that 'never' is in the past
+const TimePoint Start {std::chrono::seconds(1000)};
+/// A frame's worth of idle time
+constexpr auto FrameBudget = 8ms;
+
+/// Pages 100, 101, ...; keys are distinct from indices to catch mixups
+std::vector<PageKey> MakePages(const std::size_t count) {
+  std::vector<PageKey> ret;
+  for (std::size_t i = 0; i < count; ++i) {
+    ret.push_back(100 + i);
+  }
+  return ret;
+}
+
+/** A policy with an injected clock, driven like `PagePrerenderer`.
+ *
+ * Time only advances when asked to, so results are deterministic.
+ */
+struct Harness {
+  Policy mPolicy;
+  std::vector<PageKey> mPages {MakePages(20)};
+  std::vector<PageKey> mBookmarks;
+  TimePoint mNow {Start};
+  /// How long each pre-render takes
+  Policy::Duration mRenderDuration {2ms};
+
+  explicit Harness(const Policy::Options& options = {})
+    : mPolicy(options) {
+    // 6 slots in the default budget
+    mPolicy.SetSlotBytes(8 * MiB);
+  }
+
+  Policy::Lookup Show(const std::size_t index) {
+    return mPolicy.ObserveForegroundRender(mPages.at(index), index, mNow);
+  }
+
+  std::optional<Policy::Work> GetNextWork() {
+    return mPolicy.GetNextWork(mPages, mBookmarks, mNow, mNow + FrameBudget);
+  }
+
+  /// Run idle work until there's none left; returns the pages rendered
+  std::vector<PageKey> RunIdle() {
+    std::vector<PageKey> ret;
+    while (const auto work = this->GetNextWork()) {
+      mNow += mRenderDuration;
+      if (mPolicy.CompleteWork(*work, mRenderDuration, mNow)) {
+        ret.push_back(work->mPage);
+      }
+    }
+    return ret;
+  }
+};
+
+void TestSlots() {
+  Policy policy;
+  OPENKNEEBOARD_CHECK(policy.GetSlotCount() == 0);
+  policy.SetSlotBytes(8 * MiB);
+  OPENKNEEBOARD_CHECK(policy.GetSlotCount() == 6);
+  policy.SetSlotBytes(100 * MiB);
+  OPENKNEEBOARD_CHECK(policy.GetSlotCount() == 0);
+  policy.SetSlotBytes(16 * MiB);
+  OPENKNEEBOARD_CHECK(policy.GetSlotCount() == 3);
+  policy.Clear();
+  OPENKNEEBOARD_CHECK(policy.GetSlotCount() == 0);
+}
+
+/// Nothing is suggested until the user has settled on a page
+void TestQuietPeriod() {
+  Harness harness;
+  OPENKNEEBOARD_CHECK(!harness.GetNextWork());
+
+  harness.Show(5);
+  OPENKNEEBOARD_CHECK(!harness.GetNextWork());
+  harness.mNow += 249ms;
+  OPENKNEEBOARD_CHECK(!harness.GetNextWork());
+  harness.mNow += 1ms;
+  OPENKNEEBOARD_CHECK(harness.GetNextWork().has_value());
+
+  // A repaint restarts the quiet period, and discards work in progress
+  Harness invalidated;
+  invalidated.Show(5);
+  invalidated.mNow += 1s;
+  const auto work = invalidated.GetNextWork();
+  if (!OPENKNEEBOARD_CHECK(work)) {
+    return;
+  }
+  // Only one piece of work at a time
+  OPENKNEEBOARD_CHECK(!invalidated.GetNextWork());
+  invalidated.mPolicy.Invalidate(invalidated.mNow);
+  OPENKNEEBOARD_CHECK(
+    !invalidated.mPolicy.CompleteWork(*work, 2ms, invalidated.mNow));
+  OPENKNEEBOARD_CHECK(invalidated.mPolicy.GetStats().mDiscarded == 1);
+  OPENKNEEBOARD_CHECK(!invalidated.GetNextWork());
+  invalidated.mNow += 250ms;
+  OPENKNEEBOARD_CHECK(invalidated.GetNextWork().has_value());
+}
+
+void TestPriority() {
+  Harness harness;
+  harness.mBookmarks = {harness.mPages.at(15), harness.mPages.at(1)};
+  harness.Show(4);
+  harness.mNow += 1s;
+  harness.Show(5);
+  harness.mNow += 1s;
+
+  // Next, previous, after next, then bookmarks nearest first
+  const std::vector<PageKey> forwards {106, 104, 107, 101, 115};
+  OPENKNEEBOARD_CHECK(harness.RunIdle() == forwards);
+
+  // Turning back reverses the direction; 105 wasn't wanted before, and
+  // replaces 106 as it's the least-recently used
+  harness.Show(4);
+  OPENKNEEBOARD_CHECK(harness.mPolicy.GetStats().mHits == 1);
+  harness.mNow += 1s;
+  const std::vector<PageKey> backwards {103, 105, 102};
+  OPENKNEEBOARD_CHECK(harness.RunIdle() == backwards);
+}
+
+void TestHits() {
+  Harness harness;
+  harness.Show(0);
+  harness.mNow += 1s;
+  harness.RunIdle();
+
+  const auto next = harness.Show(1);
+  OPENKNEEBOARD_CHECK(next.mIsPageChange && next.mSlot);
+  // Repeated renders of the same page aren't page changes
+  const auto again = harness.Show(1);
+  OPENKNEEBOARD_CHECK(!again.mIsPageChange && again.mSlot == next.mSlot);
+
+  const auto far = harness.Show(10);
+  OPENKNEEBOARD_CHECK(far.mIsPageChange && !far.mSlot);
+
+  const auto stats = harness.mPolicy.GetStats();
+  OPENKNEEBOARD_CHECK(stats.mHits == 1);
+  // The first page shown, and the far one
+  OPENKNEEBOARD_CHECK(stats.mMisses == 2);
+
+  harness.mPolicy.Invalidate(harness.mNow);
+  OPENKNEEBOARD_CHECK(!harness.Show(1).mSlot);
+}
+
+/// Only unwanted pages are evicted, least-recently-used first
+void TestEviction() {
+  Harness harness;
+  harness.mPolicy.SetSlotBytes(16 * MiB);
+  harness.Show(0);
+  harness.mNow += 1s;
+  // Next, and the one after; there's no previous page
+  const std::vector<PageKey> first {101, 102};
+  OPENKNEEBOARD_CHECK(harness.RunIdle() == first);
+
+  harness.Show(1);
+  harness.mNow += 1s;
+  // 102 is already there, 101 is current, so 100 is evicted to make room
+  const std::vector<PageKey> second {100};
+  OPENKNEEBOARD_CHECK(harness.RunIdle() == second);
+  OPENKNEEBOARD_CHECK(harness.Show(2).mSlot.has_value());
+  OPENKNEEBOARD_CHECK(harness.Show(1).mSlot.has_value());
+}
+
+/// Work isn't started if it's not expected to finish in time
+void TestDeadline() {
+  Harness harness;
+  harness.mRenderDuration = 20ms;
+  harness.Show(0);
+  harness.mNow += 1s;
+  // Unknown duration, so try once, and learn that it's too slow
+  OPENKNEEBOARD_CHECK(harness.RunIdle().size() == 1);
+  OPENKNEEBOARD_CHECK(!harness.GetNextWork());
+  const auto longer = harness.mPolicy.GetNextWork(
+    harness.mPages, {}, harness.mNow, harness.mNow + 100ms);
+  OPENKNEEBOARD_CHECK(longer.has_value());
+}
+
+void TestRelease() {
+  Harness harness;
+  harness.Show(0);
+  harness.mNow += 1s;
+  OPENKNEEBOARD_CHECK(!harness.RunIdle().empty());
+  OPENKNEEBOARD_CHECK(!harness.mPolicy.ShouldRelease(harness.mNow));
+  harness.mNow += 11s;
+  OPENKNEEBOARD_CHECK(harness.mPolicy.ShouldRelease(harness.mNow));
+  OPENKNEEBOARD_CHECK(!harness.GetNextWork());
+
+  harness.mPolicy.Clear();
+  OPENKNEEBOARD_CHECK(!harness.mPolicy.ShouldRelease(harness.mNow));
+}
+
+/** Read through a document at a steady pace, with idle ticks every frame.
+ *
+ * Every page after the first should be a hit.
+ */
+void TestReading() {
+  constexpr auto FramePeriod = 11ms;
+  Harness harness;
+  harness.mPages = MakePages(50);
+  for (std::size_t page = 0; page < harness.mPages.size(); ++page) {
+    harness.Show(page);
+    const auto turnAt = harness.mNow + 2s;
+    while (harness.mNow < turnAt) {
+      harness.Show(page);
+      if (const auto work = harness.GetNextWork()) {
+        const auto done = harness.mNow + harness.mRenderDuration;
+        harness.mPolicy.CompleteWork(*work, harness.mRenderDuration, done);
+      }
+      harness.mNow += FramePeriod;
+    }
+  }
+
+  const auto stats = harness.mPolicy.GetStats();
+  std::println(
+    "Reading 50 pages: {} hits, {} misses, {} pre-renders",
+    stats.mHits,
+    stats.mMisses,
+    stats.mCompleted);
+  OPENKNEEBOARD_CHECK(stats.mMisses == 1);
+  OPENKNEEBOARD_CHECK(stats.mHits == harness.mPages.size() - 1);
+  // Next, previous, and after-next for the first page, then mostly one
+  // new page per turn
+  OPENKNEEBOARD_CHECK(stats.mCompleted <= 2 * harness.mPages.size());
+}
+
+}// namespace
+
+int main() {
+  TestSlots();
+  TestQuietPeriod();
+  TestPriority();
+  TestHits();
+  TestEviction();
+  TestDeadline();
+  TestRelease();
+  TestReading();
+  return Tests::Finish();
+}
@@ -0,0 +1,136 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "check.hpp"
+
+#include <OpenKneeboard/PersistentPageIndex.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace OpenKneeboard;
+
+namespace {
+
+void TestRoundTrip() {
+  // Byte-for-byte what previous versions wrote
+  const PersistentPageID id {.mFileHash = 1234567890123, .mPageIndex = 42};
+  OPENKNEEBOARD_CHECK(
+    id.Serialize() == R"({"FileHash":1234567890123,"PageIndex":42})");
+
+  std::mt19937_64 rng(1);
+  for (int i = 0; i < 10'000; ++i) {
+    const PersistentPageID random {
+      .mFileHash = rng(),
+      .mPageIndex = static_cast<PageIndex>(rng()),
+    };
+    if (!OPENKNEEBOARD_CHECK(
+          PersistentPageID::Parse(random.Serialize()) == random)) {
+      return;
+    }
+  }
+
+  constexpr auto max = std::numeric_limits<uint64_t>::max();
+  const PersistentPageID largest {
+    .mFileHash = max,
+    .mPageIndex = std::numeric_limits<PageIndex>::max(),
+  };
+  OPENKNEEBOARD_CHECK(PersistentPageID::Parse(largest.Serialize()) == largest);
+}
+
+/// Anything else valid is still accepted, e.g. hand-edited settings
+void TestNonCanonical() {
+  const PersistentPageID expected {.mFileHash = 123, .mPageIndex = 4};
+  for (const auto input: {
+         R"({"PageIndex":4,"FileHash":123})",
+         R"( { "FileHash" : 123, "PageIndex" : 4 } )",
+         R"({"FileHash":123,"PageIndex":4,"Extra":true})",
+       }) {
+    OPENKNEEBOARD_CHECK(PersistentPageID::Parse(input) == expected);
+  }
+
+  for (const auto input: {
+         "",
+         "{}",
+         "[123, 4]",
+         "___OKB_FIRST_PAGE___",
+         R"({"FileHash":123})",
+         R"({"FileHash":-1,"PageIndex":4})",
+         R"({"FileHash":123,"PageIndex":4.5})",
+         R"({"FileHash":"123","PageIndex":4})",
+         R"({"FileHash":123,"PageIndex":4294967296})",
+         R"({"FileHash":18446744073709551616,"PageIndex":4})",
+         R"({"FileHash":123,"PageIndex":4)",
+         R"({"FileHash":123,"PageIndex":4}})",
+       }) {
+    OPENKNEEBOARD_CHECK(!PersistentPageID::Parse(input));
+  }
+}
+
+void TestIndex() {
+  PersistentPageIndex<uint64_t> index;
+  OPENKNEEBOARD_CHECK(!index.FindPageID("a"));
+  OPENKNEEBOARD_CHECK(index.FindPageIDs("a").empty());
+
+  index.Insert(1, "a");
+  index.Insert(2, "b");
+  OPENKNEEBOARD_CHECK(index.FindPageID("a") == 1);
+  OPENKNEEBOARD_CHECK(index.FindPersistentID(2) == "b");
+  OPENKNEEBOARD_CHECK(!index.FindPersistentID(3));
+  OPENKNEEBOARD_CHECK(index.GetPageCount() == 2);
+
+  // Identical files: each page is kept, in order
+  index.Insert(3, "a");
+  index.Insert(3, "a");
+  OPENKNEEBOARD_CHECK(index.FindPageID("a") == 1);
+  OPENKNEEBOARD_CHECK(
+    std::ranges::equal(index.FindPageIDs("a"), std::vector<uint64_t> {1, 3}));
+  OPENKNEEBOARD_CHECK(index.FindPersistentID(3) == "a");
+  OPENKNEEBOARD_CHECK(index.GetPageCount() == 3);
+
+  index.Clear();
+  OPENKNEEBOARD_CHECK(index.GetPageCount() == 0);
+  OPENKNEEBOARD_CHECK(!index.FindPageID("a"));
+  OPENKNEEBOARD_CHECK(!index.FindPersistentID(1));
+}
+
+/// Page -> persistent ID -> pages, as when saving then restoring bookmarks
+void TestIndexRoundTrip() {
+  std::mt19937 rng(2);
+  PersistentPageIndex<uint64_t> index;
+  std::vector<std::string> persistentIDs;
+  for (uint64_t pageID = 0; pageID < 1000; ++pageID) {
+    // Some duplicates, as with copies of the same file
+    const PersistentPageID id {
+      .mFileHash = rng() % 50,
+      .mPageIndex = static_cast<PageIndex>(rng() % 20),
+    };
+    persistentIDs.push_back(id.Serialize());
+    index.Insert(pageID, persistentIDs.back());
+  }
+
+  for (uint64_t pageID = 0; pageID < persistentIDs.size(); ++pageID) {
+    const auto persistentID = index.FindPersistentID(pageID);
+    if (!OPENKNEEBOARD_CHECK(persistentID == persistentIDs.at(pageID))) {
+      return;
+    }
+    const auto pageIDs = index.FindPageIDs(*persistentID);
+    OPENKNEEBOARD_CHECK(std::ranges::contains(pageIDs, pageID));
+    OPENKNEEBOARD_CHECK(std::ranges::is_sorted(pageIDs));
+    OPENKNEEBOARD_CHECK(index.FindPageID(*persistentID) == pageIDs.front());
+  }
+}
+
+}// namespace
+
+int main() {
+  TestRoundTrip();
+  TestNonCanonical();
+  TestIndex();
+  TestIndexRoundTrip();
+  return Tests::Finish();
+}
@@ -0,0 +1,393 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "check.hpp"
+
+#include <OpenKneeboard/PlainTextLayout.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <print>
+#include <random>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+
+#include <Psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include <icu.h>
+
+using namespace OpenKneeboard;
+
+namespace {
+
+constexpr std::size_t Columns = 58;
+constexpr std::size_t Rows = 36;
+
+using Pages = std::vector<std::vector<std::string_view>>;
+
+Pages GetPages(const PlainTextLayout& layout, std::string_view text) {
+  Pages ret;
+  for (auto&& page: layout.GetPages()) {
+    auto& lines = ret.emplace_back();
+    for (auto&& line: page.mLines) {
+      lines.push_back(text.substr(line.mOffset, line.mLength));
+    }
+  }
+  return ret;
+}
+
+Pages LayOutAll(std::string_view text) {
+  PlainTextLayout layout(Columns, Rows);
+  while (layout.LayOutNext(text)) {
+  }
+  return GetPages(layout, text);
+}
+
+/// Checklist-like text, with CRLF line endings and some non-ASCII
+std::string GenerateText(const std::size_t bytes, const uint32_t seed) {
+  constexpr std::string_view words[] {
+    "the",
+    "checklist",
+    "altitude",
+    "heading",
+    "waypoint",
+    "frequency",
+    "TACAN",
+    "fuel",
+    "approach",
+    "runway",
+    "ILS",
+    "bearing",
+    "channel",
+    "\xc3\xa9l\xc3\xa8ve",
+  };
+  std::mt19937 rng(seed);
+  std::string ret;
+  ret.reserve(bytes + 256);
+  while (ret.size() < bytes) {
+    for (std::size_t i = 0, count = 3 + (rng() % 14); i < count; ++i) {
+      ret += words[rng() % std::size(words)];
+      ret += ' ';
+    }
+    ret += (rng() % 8 == 0) ? "\r\n\r\n" : "\r\n";
+    if (rng() % 200 == 0) {
+      // Group separator
+      ret += '\x1d';
+    }
+  }
+  return ret;
+}
+
+/// Laying out a prefix, then the rest, gives the same result as all at once
+void TestIncremental() {
+  const auto text = GenerateText(256 * 1024, 1);
+  const auto expected = LayOutAll(text);
+  OPENKNEEBOARD_CHECK(expected.size() > 10);
+  for (auto&& page: expected) {
+    OPENKNEEBOARD_CHECK(page.size() <= Rows);
+  }
+
+  std::mt19937 rng(2);
+  for (int i = 0; i < 20; ++i) {
+    PlainTextLayout layout(Columns, Rows);
+    std::vector<std::size_t> cuts;
+    for (int j = 0; j < 4; ++j) {
+      cuts.push_back(rng() % text.size());
+    }
+    std::ranges::sort(cuts);
+    for (auto&& cut: cuts) {
+      // As if the text was appended to, e.g. a log file
+      const auto prefix = std::string_view {text}.substr(0, cut);
+      layout.Invalidate(cut);
+      layout.LayOutUntil(prefix, rng() % 50);
+    }
+    layout.Invalidate(cuts.back());
+    while (layout.LayOutNext(text)) {
+    }
+    OPENKNEEBOARD_CHECK(GetPages(layout, text) == expected);
+  }
+}
+
+/// Only lay out as far as the requested page
+void TestLazy() {
+  const auto text = GenerateText(4 * 1024 * 1024, 3);
+  PlainTextLayout layout(Columns, Rows);
+  const auto consumed = layout.LayOutUntil(text, 1);
+  OPENKNEEBOARD_CHECK(consumed > 0);
+  OPENKNEEBOARD_CHECK(consumed < text.size() / 16);
+  OPENKNEEBOARD_CHECK(!layout.IsComplete(text));
+  OPENKNEEBOARD_CHECK(layout.GetPages().size() >= 1);
+
+  layout.LayOutUntil(text, 10);
+  OPENKNEEBOARD_CHECK(layout.GetPages().size() >= 10);
+  OPENKNEEBOARD_CHECK(!layout.IsComplete(text));
+}
+
+void TestEmpty() {
+  PlainTextLayout layout(Columns, Rows);
+  OPENKNEEBOARD_CHECK(layout.LayOutNext({}) == 0);
+  OPENKNEEBOARD_CHECK(layout.IsComplete({}));
+}
+
+/** Word wrap one line as the layout engine did before it reused ICU state
+ * and had an ASCII path: a new break iterator for every line, and ICU for
+ * every grapheme.
+ */
+std::vector<std::string_view> ReferenceWrap(
+  const std::string_view line,
+  const std::size_t columns) {
+  if (line.size() <= columns) {
+    return {line};
+  }
+  UErrorCode status = U_ZERO_ERROR;
+  const std::unique_ptr<UText, decltype(&utext_close)> text {
+    utext_openUTF8(nullptr, line.data(), line.size(), &status), &utext_close};
+  const std::unique_ptr<UBreakIterator, decltype(&ubrk_close)> iterator {
+    ubrk_open(UBRK_CHARACTER, "", nullptr, 0, &status), &ubrk_close};
+  const auto it = iterator.get();
+  ubrk_setUText(it, text.get(), &status);
+
+  std::vector<std::string_view> ret;
+  ubrk_first(it);
+  while (static_cast<std::size_t>(ubrk_current(it)) < line.size()) {
+    const std::size_t offset = ubrk_current(it);
+    auto wrapped = line.substr(offset);
+    if (wrapped.size() <= columns) {
+      ret.push_back(wrapped);
+      break;
+    }
+    std::size_t graphemeCount {};
+    std::optional<std::size_t> lastWhitespace;
+    while (ubrk_next(it) != UBRK_DONE) {
+      if (++graphemeCount > columns) {
+        break;
+      }
+      const std::size_t next = ubrk_current(it);
+      const auto cp = utext_next32From(text.get(), next);
+      if (cp == U_SENTINEL || u_isUWhiteSpace(cp)) {
+        lastWhitespace = next;
+      }
+    }
+    if (graphemeCount > columns) {
+      if (lastWhitespace) {
+        std::ignore = ubrk_isBoundary(it, *lastWhitespace);
+      } else {
+        ubrk_previous(it);
+      }
+      wrapped = line.substr(offset, ubrk_current(it) - offset);
+      if (lastWhitespace) {
+        ubrk_next(it);
+      }
+    }
+    ret.push_back(wrapped);
+  }
+  return ret;
+}
+
+/// Lines of mixed ASCII and other text, without blank lines
+std::vector<std::string> GenerateLines(
+  const std::size_t count,
+  std::mt19937& rng) {
+  constexpr std::string_view pieces[] {
+    "a",
+    "word",
+    "TACAN",
+    " ",
+    "  ",
+    "\t",
+    // Precomposed, and combining: e + COMBINING ACUTE ACCENT
+    "\xc3\xa9",
+    "e\xcc\x81",
+    // Wide
+    "\xe6\xbc\xa2\xe5\xad\x97",
+    // THUMBS UP SIGN + skin tone modifier: one grapheme cluster
+    "\xf0\x9f\x91\x8d\xf0\x9f\x8f\xbd",
+    // NO-BREAK SPACE and IDEOGRAPHIC SPACE are both Unicode whitespace
+    "\xc2\xa0",
+    "\xe3\x80\x80",
+  };
+  std::vector<std::string> ret;
+  for (std::size_t i = 0; i < count; ++i) {
+    auto& line = ret.emplace_back(pieces[rng() % 3]);
+    // Half are entirely ASCII; the rest have long ASCII runs between other
+    // text
+    const bool ascii = (rng() % 2) == 0;
+    for (std::size_t j = 0, pieceCount = rng() % 40; j < pieceCount; ++j) {
+      const bool other = !ascii && (rng() % 4) == 0;
+      line += other ? pieces[6 + (rng() % 6)] : pieces[rng() % 6];
+    }
+  }
+  return ret;
+}
+
+/// Wrapped lines match the previous engine, regardless of the ASCII path
+void TestWordWrapParity() {
+  std::mt19937 rng(5);
+  for (int i = 0; i < 500; ++i) {
+    const auto lines = GenerateLines(1 + (rng() % 20), rng);
+    const auto columns = 2 + (rng() % 30);
+
+    std::string text;
+    std::vector<std::string_view> expected;
+    for (auto&& line: lines) {
+      text += line;
+      text += (rng() % 2) ? "\n" : "\r\n";
+    }
+    // After building `text`, so the views are into it
+    std::size_t offset = 0;
+    for (auto&& line: lines) {
+      const auto view = std::string_view {text}.substr(offset, line.size());
+      std::ranges::copy(
+        ReferenceWrap(view, columns), std::back_inserter(expected));
+      offset = text.find('\n', offset) + 1;
+    }
+
+    PlainTextLayout layout(columns, Rows);
+    while (layout.LayOutNext(text)) {
+    }
+    std::vector<std::string_view> actual;
+    for (auto&& page: GetPages(layout, text)) {
+      std::ranges::copy(page, std::back_inserter(actual));
+    }
+    if (!OPENKNEEBOARD_CHECK(actual == expected)) {
+      std::println("Word wrap mismatch with {} columns", columns);
+      return;
+    }
+  }
+}
+
+/// Not pass/fail; the speed of the engine, relative to `ReferenceWrap()`
+void BenchmarkWordWrap(const std::string_view name, const std::string& text) {
+  using Clock = std::chrono::steady_clock;
+  using Milliseconds = std::chrono::duration<double, std::milli>;
+
+  auto start = Clock::now();
+  std::size_t referenceLineCount = 0;
+  for (std::size_t offset = 0; offset < text.size();) {
+    const auto end = text.find('\n', offset);
+    referenceLineCount
+      += ReferenceWrap(
+           std::string_view {text}.substr(offset, end - offset), Columns)
+           .size();
+    offset = end + 1;
+  }
+  const auto referenceTime = Milliseconds(Clock::now() - start);
+
+  start = Clock::now();
+  PlainTextLayout layout(Columns, Rows);
+  while (layout.LayOutNext(text)) {
+  }
+  const auto layoutTime = Milliseconds(Clock::now() - start);
+
+  const auto megabytes = static_cast<double>(text.size()) / (1024 * 1024);
+  std::println(
+    "Word wrap, {}: {:.0f} MiB/s, per-line ICU: {:.0f} MiB/s ({} lines)",
+    name,
+    megabytes / (layoutTime.count() / 1000),
+    megabytes / (referenceTime.count() / 1000),
+    referenceLineCount);
+}
+
+void BenchmarkWordWrap() {
+  std::mt19937 rng(6);
+  std::string unicode;
+  for (auto&& line: GenerateLines(100'000, rng)) {
+    unicode += line;
+    unicode += '\n';
+  }
+  BenchmarkWordWrap("mixed", unicode);
+
+  // Mostly ASCII, with occasional non-ASCII words
+  std::string checklists;
+  for (const auto c: GenerateText(4 * 1024 * 1024, 7)) {
+    if (c != '\r' && c != '\x1d') {
+      checklists += c;
+    }
+  }
+  BenchmarkWordWrap("checklists", checklists);
+}
+
+std::size_t GetPeakMemoryBytes() {
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters {sizeof(counters)};
+  GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+  return counters.PeakWorkingSetSize;
+#else
+  rusage usage {};
+  getrusage(RUSAGE_SELF, &usage);
+  // Kilobytes on Linux
+  return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+#endif
+}
+
+std::size_t GetLayoutBytes(const PlainTextLayout& layout) {
+  const auto& pages = layout.GetPages();
+  std::size_t ret = pages.capacity() * sizeof(PlainTextLayout::Page);
+  for (auto&& page: pages) {
+    ret += page.mLines.capacity() * sizeof(PlainTextLayout::SourceReference);
+  }
+  return ret;
+}
+
+/** Not pass/fail; printed so regressions show up in CI logs.
+ *
+ * The text is generated in memory, standing in for a mapped file; only the
+ * layout's own memory is attributable to the layout.
+ */
+void Benchmark(const std::size_t megabytes) {
+  using Clock = std::chrono::steady_clock;
+  const auto text = GenerateText(megabytes * 1024 * 1024, 4);
+
+  const auto start = Clock::now();
+  PlainTextLayout layout(Columns, Rows);
+  layout.LayOutUntil(text, 1);
+  const auto firstPage = Clock::now();
+  while (layout.LayOutNext(text)) {
+  }
+  const auto complete = Clock::now();
+  OPENKNEEBOARD_CHECK(layout.IsComplete(text));
+
+  using Milliseconds = std::chrono::duration<double, std::milli>;
+  std::println(
+    "{:>4} MiB: first page in {:.3f}ms; all {} pages in {:.1f}ms; layout "
+    "uses {} KiB; peak process memory {} MiB",
+    megabytes,
+    Milliseconds(firstPage - start).count(),
+    layout.GetPages().size(),
+    Milliseconds(complete - start).count(),
+    GetLayoutBytes(layout) / 1024,
+    GetPeakMemoryBytes() / (1024 * 1024));
+}
+
+}// namespace
+
+int main(int argc, char** argv) {
+  TestEmpty();
+  TestIncremental();
+  TestLazy();
+  TestWordWrapParity();
+
+  // The larger sizes take a while, so they're opt-in
+  if (argc == 2 && std::string_view {argv[1]} == "--benchmark") {
+    for (const auto megabytes: {1, 10, 100}) {
+      Benchmark(megabytes);
+    }
+  } else {
+    Benchmark(1);
+  }
+  BenchmarkWordWrap();
+
+  return Tests::Finish();
+}
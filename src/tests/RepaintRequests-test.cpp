@@ -0,0 +1,236 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "check.hpp"
+
+#include <OpenKneeboard/RepaintRequests.hpp>
+
+#include <atomic>
+#include <format>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace OpenKneeboard;
+
+using Bus = RepaintRequestBus;
+using enum RepaintReason;
+using enum RepaintPriority;
+
+namespace {
+
+PixelRect Rect(uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+  return {{x, y}, {width, height}};
+}
+
+// Counters are process-wide, so tests compare against a baseline
+uint64_t GetCounter(std::string_view name) {
+  for (auto&& it: Metrics::Registry::Get().GetSnapshot().mCounters) {
+    if (it.mName == name) {
+      return it.mValue;
+    }
+  }
+  return 0;
+}
+
+void TestEmpty() {
+  Bus bus;
+  OPENKNEEBOARD_CHECK(!bus.HasPending());
+  Bus::Frame frame;
+  bus.TakeFrame(frame);
+  OPENKNEEBOARD_CHECK(frame.IsEmpty());
+  OPENKNEEBOARD_CHECK(!frame.Includes(1));
+}
+
+// `Post()` returns the new priority if it raised the pending frame's
+// priority, so the caller knows whether to wake the renderer sooner
+void TestPriorities() {
+  Bus bus;
+  OPENKNEEBOARD_CHECK(
+    bus.Post({.mView = 1, .mPriority = Background, .mReason = UILayer})
+    == Background);
+  OPENKNEEBOARD_CHECK(bus.HasPending());
+  OPENKNEEBOARD_CHECK(
+    !bus.Post({.mView = 2, .mPriority = Background, .mReason = UILayer}));
+  OPENKNEEBOARD_CHECK(
+    bus.Post({.mView = 2, .mPriority = Normal, .mReason = TabContent})
+    == Normal);
+  OPENKNEEBOARD_CHECK(
+    !bus.Post({.mView = 1, .mPriority = Normal, .mReason = TabContent}));
+  OPENKNEEBOARD_CHECK(
+    bus.Post({.mView = 1, .mPriority = Interactive, .mReason = Cursor})
+    == Interactive);
+
+  Bus::Frame frame;
+  bus.TakeFrame(frame);
+  OPENKNEEBOARD_CHECK(!bus.HasPending());
+  OPENKNEEBOARD_CHECK(frame.mPriority == Interactive);
+  OPENKNEEBOARD_CHECK(!frame.mAllViews);
+  if (!OPENKNEEBOARD_CHECK(frame.mViews.size() == 2)) {
+    return;
+  }
+  const auto& first = frame.mViews.at(0);
+  const auto& second = frame.mViews.at(1);
+  OPENKNEEBOARD_CHECK(first.mView == 1 && second.mView == 2);
+  OPENKNEEBOARD_CHECK(first.mPriority == Interactive);
+  OPENKNEEBOARD_CHECK(second.mPriority == Normal);
+  OPENKNEEBOARD_CHECK(
+    first.mReasons
+    == (Bus::GetReasonBit(UILayer) | Bus::GetReasonBit(TabContent)
+        | Bus::GetReasonBit(Cursor)));
+  OPENKNEEBOARD_CHECK(
+    frame.Includes(1) && frame.Includes(2) && !frame.Includes(3));
+
+  // Once the frame is taken, the next request raises the priority again
+  OPENKNEEBOARD_CHECK(
+    bus.Post({.mView = 3, .mPriority = Background}) == Background);
+}
+
+void TestRegions() {
+  Bus bus;
+  (void)bus.Post({.mView = 1, .mRegion = Rect(10, 10, 10, 10)});
+  (void)bus.Post({.mView = 1, .mRegion = Rect(30, 5, 10, 10)});
+  // No region means the whole view, which absorbs any regions
+  (void)bus.Post({.mView = 2, .mRegion = Rect(0, 0, 5, 5)});
+  (void)bus.Post({.mView = 2});
+  (void)bus.Post({.mView = 2, .mRegion = Rect(0, 0, 5, 5)});
+  // Empty regions are treated as the whole view
+  (void)bus.Post({.mView = 3, .mRegion = Rect(1, 1, 0, 0)});
+
+  Bus::Frame frame;
+  bus.TakeFrame(frame);
+  const auto one = frame.Find(1);
+  const auto two = frame.Find(2);
+  const auto three = frame.Find(3);
+  if (!OPENKNEEBOARD_CHECK(one && two && three)) {
+    return;
+  }
+  OPENKNEEBOARD_CHECK(one->mRegion == Rect(10, 5, 30, 15));
+  OPENKNEEBOARD_CHECK(!two->mRegion);
+  OPENKNEEBOARD_CHECK(!three->mRegion);
+}
+
+void TestAllViewsAndMetrics() {
+  const auto cursorRequests = GetCounter("Repaint requests: Cursor");
+  const auto cursorCoalesced = GetCounter("Repaint coalesced: Cursor");
+  const auto cursorFrames = GetCounter("Repaint frames: Cursor");
+  const auto settingsRequests = GetCounter("Repaint requests: Settings");
+  const auto settingsCoalesced = GetCounter("Repaint coalesced: Settings");
+  const auto settingsFrames = GetCounter("Repaint frames: Settings");
+
+  Bus bus;
+  (void)bus.Post({.mView = 1, .mReason = Cursor});
+  (void)bus.Post({.mReason = Settings});
+  (void)bus.Post({.mView = 2, .mReason = Cursor});
+  (void)bus.Post({.mReason = Settings});
+
+  Bus::Frame frame;
+  bus.TakeFrame(frame);
+  OPENKNEEBOARD_CHECK(frame.mAllViews);
+  OPENKNEEBOARD_CHECK(frame.Includes(42));
+  OPENKNEEBOARD_CHECK(
+    frame.mReasons
+    == (Bus::GetReasonBit(Cursor) | Bus::GetReasonBit(Settings)));
+
+  OPENKNEEBOARD_CHECK(
+    GetCounter("Repaint requests: Cursor") - cursorRequests == 2);
+  OPENKNEEBOARD_CHECK(
+    GetCounter("Repaint coalesced: Cursor") - cursorCoalesced == 1);
+  OPENKNEEBOARD_CHECK(GetCounter("Repaint frames: Cursor") - cursorFrames == 1);
+  OPENKNEEBOARD_CHECK(
+    GetCounter("Repaint requests: Settings") - settingsRequests == 2);
+  OPENKNEEBOARD_CHECK(
+    GetCounter("Repaint coalesced: Settings") - settingsCoalesced == 1);
+  OPENKNEEBOARD_CHECK(
+    GetCounter("Repaint frames: Settings") - settingsFrames == 1);
+}
+
+// `TakeFrame()` swaps storage with the bus, so steady-state frames don't
+// allocate
+void TestStorageReuse() {
+  Bus bus;
+  Bus::Frame frame;
+  (void)bus.Post({.mView = 4});
+  bus.TakeFrame(frame);
+  const auto storage = frame.mViews.data();
+
+  // The previous frame's storage goes to the bus...
+  (void)bus.Post({.mView = 5});
+  bus.TakeFrame(frame);
+  // ... then back to the next frame
+  (void)bus.Post({.mView = 6});
+  Bus::Frame next;
+  bus.TakeFrame(next);
+  OPENKNEEBOARD_CHECK(next.mViews.data() == storage);
+  OPENKNEEBOARD_CHECK(next.mViews.size() == 1 && next.mViews[0].mView == 6);
+  OPENKNEEBOARD_CHECK(!next.mAllViews);
+}
+
+void TestReasonNames() {
+  for (std::size_t i = 0; i < RepaintReasonCount; ++i) {
+    OPENKNEEBOARD_CHECK(
+      GetRepaintReasonName(static_cast<RepaintReason>(i)) != "Invalid");
+  }
+}
+
+// No requests are lost when posting from several threads while taking frames
+void TestConcurrency() {
+  constexpr std::size_t ThreadCount = 4;
+  constexpr uint64_t RequestsPerThread = 20000;
+  static_assert(ThreadCount <= RepaintReasonCount);
+
+  std::vector<uint64_t> baselines;
+  for (std::size_t i = 0; i < ThreadCount; ++i) {
+    baselines.push_back(GetCounter(std::format(
+      "Repaint requests: {}",
+      GetRepaintReasonName(static_cast<RepaintReason>(i)))));
+  }
+
+  Bus bus;
+  std::atomic<bool> stop {false};
+  std::jthread taker([&] {
+    Bus::Frame frame;
+    while (!stop) {
+      bus.TakeFrame(frame);
+      for (auto&& view: frame.mViews) {
+        OPENKNEEBOARD_CHECK(view.mView >= 1 && view.mView <= 4);
+      }
+    }
+  });
+  {
+    std::vector<std::jthread> posters;
+    for (std::size_t i = 0; i < ThreadCount; ++i) {
+      posters.emplace_back([&bus, reason = static_cast<RepaintReason>(i)] {
+        for (uint64_t j = 0; j < RequestsPerThread; ++j) {
+          (void)bus.Post({
+            .mView = 1 + (j % 4),
+            .mPriority = static_cast<RepaintPriority>(j % 3),
+            .mReason = reason,
+          });
+        }
+      });
+    }
+  }
+  stop = true;
+  taker.join();
+
+  for (std::size_t i = 0; i < ThreadCount; ++i) {
+    const auto requests = GetCounter(std::format(
+      "Repaint requests: {}",
+      GetRepaintReasonName(static_cast<RepaintReason>(i))));
+    OPENKNEEBOARD_CHECK(requests - baselines.at(i) == RequestsPerThread);
+  }
+}
+
+}// namespace
+
+int main() {
+  TestEmpty();
+  TestPriorities();
+  TestRegions();
+  TestAllViewsAndMetrics();
+  TestStorageReuse();
+  TestReasonNames();
+  TestConcurrency();
+  return Tests::Finish();
+}
@@ -0,0 +1,421 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "check.hpp"
+
+#include <OpenKneeboard/SpriteBatchCore.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <print>
+#include <random>
+#include <tuple>
+#include <vector>
+
+using namespace OpenKneeboard;
+
+namespace {
+
+// Stand-in for a texture/image view handle
+using Batch = SpriteBatchCore<int>;
+using Point = std::array<float, 2>;
+
+constexpr Batch::Color White {1, 1, 1, 1};
+constexpr Batch::Color Red {1, 0, 0, 1};
+
+const PixelSize SourceSize {100, 50};
+
+PixelRect Rect(uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
+  return {{x, y}, {width, height}};
+}
+
+/// The vertices as the CPU built them before sprites were instanced
+std::vector<std::pair<Point, Point>> ReferenceVertices(
+  const Batch::Instance& instance) {
+  const auto& src = instance.mSourceRect;
+  const auto& dst = instance.mDestRect;
+  const auto bl = [](const auto& r) { return Point {r[0], r[3]}; };
+  const auto tl = [](const auto& r) { return Point {r[0], r[1]}; };
+  const auto br = [](const auto& r) { return Point {r[2], r[3]}; };
+  const auto tr = [](const auto& r) { return Point {r[2], r[1]}; };
+  return {
+    {bl(src), bl(dst)},
+    {tl(src), tl(dst)},
+    {br(src), br(dst)},
+    {tl(src), tl(dst)},
+    {tr(src), tr(dst)},
+    {br(src), br(dst)},
+  };
+}
+
+/// A vertex as the CPU built them before sprites were instanced
+struct ReferenceVertex {
+  std::array<float, 4> mPosition;
+  Batch::Color mColor;
+  std::array<float, 2> mTexCoord;
+  std::array<float, 2> mTexClampTL;
+  std::array<float, 2> mTexClampBR;
+};
+
+/// The six vertices that `D3D11::SpriteBatch::Draw()` used to append
+std::array<ReferenceVertex, 6> ReferenceExpand(
+  const PixelSize& sourceSize,
+  const PixelRect& sourceRect,
+  const PixelRect& destRect,
+  const Batch::Color& tint) {
+  using TexCoord = std::array<float, 2>;
+  const TexCoord texClampTL {
+    (sourceRect.Left() + 0.5f) / sourceSize.Width(),
+    (sourceRect.Top() + 0.5f) / sourceSize.Height(),
+  };
+  const TexCoord texClampBR {
+    (sourceRect.Right() - 0.5f) / sourceSize.Width(),
+    (sourceRect.Bottom() - 0.5f) / sourceSize.Height(),
+  };
+
+  const TexCoord srcTL {sourceRect.Left<float>(), sourceRect.Top<float>()};
+  const TexCoord srcBR {
+    sourceRect.Right<float>(), sourceRect.Bottom<float>()};
+  const TexCoord srcBL {srcTL[0], srcBR[1]};
+  const TexCoord srcTR {srcBR[0], srcTL[1]};
+
+  using Position = std::array<float, 4>;
+  const Position dstTL {destRect.Left<float>(), destRect.Top<float>(), 0, 1};
+  const Position dstBR {
+    destRect.Right<float>(), destRect.Bottom<float>(), 0, 1};
+  const Position dstBL {destRect.Left<float>(), destRect.Bottom<float>(), 0, 1};
+  const Position dstTR {destRect.Right<float>(), destRect.Top<float>(), 0, 1};
+
+  const auto makeVertex = [=](const auto& src, const auto& dst) {
+    return ReferenceVertex {
+      .mPosition = dst,
+      .mColor = tint,
+      .mTexCoord = src,
+      .mTexClampTL = texClampTL,
+      .mTexClampBR = texClampBR,
+    };
+  };
+  return {
+    makeVertex(srcBL, dstBL),
+    makeVertex(srcTL, dstTL),
+    makeVertex(srcBR, dstBR),
+    makeVertex(srcTL, dstTL),
+    makeVertex(srcTR, dstTR),
+    makeVertex(srcBR, dstBR),
+  };
+}
+
+/// What the vertex shaders compute from an instance and the uniform buffer
+ReferenceVertex ShaderExpand(
+  const Shaders::SpriteBatch::UniformBuffer& uniform,
+  const Batch::Instance& instance,
+  const std::size_t vertexIndex) {
+  const auto position
+    = SpriteBatchVertices::GetCorner(instance.mDestRect, vertexIndex);
+  const auto& clamp = uniform.mSourceClamp.at(instance.mSourceIndex);
+  return {
+    .mPosition = {position[0], position[1], 0, 1},
+    .mColor = instance.mColor,
+    .mTexCoord
+    = SpriteBatchVertices::GetCorner(instance.mSourceRect, vertexIndex),
+    .mTexClampTL = {clamp[0], clamp[1]},
+    .mTexClampBR = {clamp[2], clamp[3]},
+  };
+}
+
+struct RandomSprite {
+  int mSource {};
+  PixelSize mSourceSize {};
+  PixelRect mSourceRect {};
+  PixelRect mDestRect {};
+  Batch::Color mColor {};
+};
+
+/// A few textures of different sizes, e.g. tab content, header, and cursor
+std::vector<RandomSprite> MakeRandomSprites(
+  std::mt19937& rng,
+  const std::size_t count) {
+  constexpr std::array<PixelSize, 4> SourceSizes {{
+    {1024, 768},
+    {4096, 4096},
+    {37, 53},
+    {1, 1},
+  }};
+  std::uniform_real_distribution<float> unit(0, 1);
+  std::vector<RandomSprite> ret;
+  for (std::size_t i = 0; i < count; ++i) {
+    const auto source = static_cast<int>(rng() % SourceSizes.size());
+    const auto size = SourceSizes.at(source);
+    const auto x = rng() % size.Width();
+    const auto y = rng() % size.Height();
+    ret.push_back({
+      .mSource = source,
+      .mSourceSize = size,
+      .mSourceRect = Rect(
+        x,
+        y,
+        1 + (rng() % (size.Width() - x)),
+        1 + (rng() % (size.Height() - y))),
+      .mDestRect = Rect(rng() % 3840, rng() % 2160, rng() % 2048, rng() % 2048),
+      .mColor = {unit(rng), unit(rng), unit(rng), unit(rng)},
+    });
+  }
+  return ret;
+}
+
+/// Byte-for-byte the same vertices as before, for random sprites
+void TestRandomMatchesReference() {
+  std::mt19937 rng(1);
+  for (int i = 0; i < 1000; ++i) {
+    const auto sprites = MakeRandomSprites(
+      rng, 1 + (rng() % Shaders::SpriteBatch::MaxSpritesPerBatch));
+    Batch batch;
+    std::vector<ReferenceVertex> expected;
+    for (auto&& sprite: sprites) {
+      batch.Draw(
+        sprite.mSource,
+        sprite.mSourceSize,
+        sprite.mSourceRect,
+        sprite.mDestRect,
+        sprite.mColor);
+      std::ranges::copy(
+        ReferenceExpand(
+          sprite.mSourceSize,
+          sprite.mSourceRect,
+          sprite.mDestRect,
+          sprite.mColor),
+        std::back_inserter(expected));
+    }
+
+    const auto uniform
+      = SpriteBatchVertices::GetUniformBuffer(batch, PixelSize {3840, 2160});
+    std::vector<ReferenceVertex> actual;
+    for (auto&& instance: batch.GetInstances()) {
+      for (std::size_t v = 0; v < Shaders::SpriteBatch::VerticesPerSprite;
+           ++v) {
+        actual.push_back(ShaderExpand(uniform, instance, v));
+      }
+    }
+    const auto bytes = expected.size() * sizeof(ReferenceVertex);
+    if (!OPENKNEEBOARD_CHECK(
+          actual.size() == expected.size()
+          && std::memcmp(actual.data(), expected.data(), bytes) == 0)) {
+      return;
+    }
+  }
+}
+
+/** Not pass/fail; CPU time and upload size per frame, old and new.
+ *
+ * The same sprites are drawn every frame, as when nothing changes.
+ */
+void Benchmark(const std::size_t spriteCount) {
+  using Clock = std::chrono::steady_clock;
+  using Microseconds = std::chrono::duration<double, std::micro>;
+  constexpr int Frames = 1000;
+  constexpr auto BatchSize = Shaders::SpriteBatch::MaxSpritesPerBatch;
+
+  std::mt19937 rng(2);
+  const auto sprites = MakeRandomSprites(rng, spriteCount);
+
+  std::vector<ReferenceVertex> vertices;
+  std::size_t referenceBytes = 0;
+  auto start = Clock::now();
+  for (int frame = 0; frame < Frames; ++frame) {
+    for (auto&& sprite: sprites) {
+      std::ranges::copy(
+        ReferenceExpand(
+          sprite.mSourceSize,
+          sprite.mSourceRect,
+          sprite.mDestRect,
+          sprite.mColor),
+        std::back_inserter(vertices));
+    }
+    referenceBytes += vertices.size() * sizeof(ReferenceVertex);
+    vertices.clear();
+  }
+  const auto referenceTime = Microseconds(Clock::now() - start) / Frames;
+
+  // One batch per flush, as the backends do
+  std::vector<Batch> batches((spriteCount + BatchSize - 1) / BatchSize);
+  std::size_t instanceBytes = 0;
+  start = Clock::now();
+  for (int frame = 0; frame < Frames; ++frame) {
+    for (std::size_t i = 0; i < sprites.size(); ++i) {
+      const auto& sprite = sprites[i];
+      batches[i / BatchSize].Draw(
+        sprite.mSource,
+        sprite.mSourceSize,
+        sprite.mSourceRect,
+        sprite.mDestRect,
+        sprite.mColor);
+    }
+    for (auto&& batch: batches) {
+      if (!batch.IsSameAsPreviousBatch()) {
+        instanceBytes += batch.GetInstances().size_bytes();
+      }
+      batch.EndBatch();
+    }
+  }
+  const auto batchTime = Microseconds(Clock::now() - start) / Frames;
+
+  std::println(
+    "{:>4} sprites: vertices {:.2f}us and {} bytes/frame; instances "
+    "{:.2f}us and {} bytes/frame ({} bytes if changed)",
+    spriteCount,
+    referenceTime.count(),
+    referenceBytes / Frames,
+    batchTime.count(),
+    instanceBytes / Frames,
+    spriteCount * sizeof(Batch::Instance));
+  OPENKNEEBOARD_CHECK(
+    spriteCount * sizeof(Batch::Instance) < referenceBytes / Frames);
+}
+
+void TestCornersMatchReference() {
+  Batch batch;
+  batch.Draw(1, SourceSize, Rect(10, 20, 30, 15), Rect(100, 200, 60, 45), Red);
+  batch.Draw(2, SourceSize, Rect(0, 0, 100, 50), Rect(7, 3, 1, 1), White);
+
+  for (auto&& instance: batch.GetInstances()) {
+    const auto expected = ReferenceVertices(instance);
+    OPENKNEEBOARD_CHECK(
+      expected.size() == Shaders::SpriteBatch::VerticesPerSprite);
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+      const auto texCoord
+        = SpriteBatchVertices::GetCorner(instance.mSourceRect, i);
+      const auto position
+        = SpriteBatchVertices::GetCorner(instance.mDestRect, i);
+      OPENKNEEBOARD_CHECK(texCoord == expected.at(i).first);
+      OPENKNEEBOARD_CHECK(position == expected.at(i).second);
+    }
+  }
+}
+
+void TestSourceSharing() {
+  Batch batch;
+  OPENKNEEBOARD_CHECK(batch.IsEmpty());
+
+  batch.Draw(1, SourceSize, Rect(0, 0, 10, 10), Rect(0, 0, 10, 10), White);
+  // Same texture and source rect: shares the slot
+  batch.Draw(1, SourceSize, Rect(0, 0, 10, 10), Rect(20, 0, 10, 10), Red);
+  // Same texture, different source rect: needs its own clamp, so a new slot
+  batch.Draw(1, SourceSize, Rect(10, 0, 10, 10), Rect(40, 0, 10, 10), White);
+  batch.Draw(2, SourceSize, Rect(0, 0, 10, 10), Rect(60, 0, 10, 10), White);
+
+  OPENKNEEBOARD_CHECK(!batch.IsEmpty());
+  const auto sources = batch.GetSources();
+  const auto instances = batch.GetInstances();
+  OPENKNEEBOARD_CHECK(sources.size() == 3);
+  OPENKNEEBOARD_CHECK(instances.size() == 4);
+  if (sources.size() != 3 || instances.size() != 4) {
+    return;
+  }
+
+  OPENKNEEBOARD_CHECK(instances[0].mSourceIndex == 0);
+  OPENKNEEBOARD_CHECK(instances[1].mSourceIndex == 0);
+  OPENKNEEBOARD_CHECK(instances[2].mSourceIndex == 1);
+  OPENKNEEBOARD_CHECK(instances[3].mSourceIndex == 2);
+  OPENKNEEBOARD_CHECK(sources[1].mRect == Rect(10, 0, 10, 10));
+  OPENKNEEBOARD_CHECK(sources[2].mSource == 2);
+
+  // Submission order is kept, even though slots are shared
+  OPENKNEEBOARD_CHECK(instances[1].mColor == Red);
+  OPENKNEEBOARD_CHECK(
+    (instances[3].mDestRect == std::array<float, 4> {60, 0, 70, 10}));
+}
+
+void TestSourceRuns() {
+  Batch batch;
+  const auto draw = [&](int source, uint32_t x) {
+    batch.Draw(source, SourceSize, Rect(x, 0, 1, 1), Rect(x, 0, 1, 1), White);
+  };
+  // Runs are by texture, not by slot: 0 and 1 are different slots of the
+  // same texture
+  draw(1, 0);
+  draw(1, 1);
+  draw(2, 0);
+  draw(1, 0);
+
+  std::vector<std::tuple<int, std::size_t, std::size_t>> runs;
+  batch.ForEachSourceRun(
+    [&](const auto& source, std::size_t first, std::size_t count) {
+      runs.emplace_back(source.mSource, first, count);
+    });
+  OPENKNEEBOARD_CHECK(
+    (runs
+     == std::vector<std::tuple<int, std::size_t, std::size_t>> {
+       {1, 0, 2},
+       {2, 2, 1},
+       {1, 3, 1},
+     }));
+}
+
+void TestUniformBuffer() {
+  Batch batch;
+  batch.Draw(1, SourceSize, Rect(10, 20, 30, 10), Rect(0, 0, 30, 10), White);
+  batch.Draw(2, {64, 32}, Rect(0, 0, 64, 32), Rect(0, 0, 64, 32), White);
+
+  const auto uniform
+    = SpriteBatchVertices::GetUniformBuffer(batch, PixelSize {800, 600});
+  OPENKNEEBOARD_CHECK(
+    (uniform.mTargetDimensions == std::array<float, 2> {800, 600}));
+  OPENKNEEBOARD_CHECK(
+    (uniform.mSourceDimensions[0] == std::array<float, 2> {100, 50}));
+  OPENKNEEBOARD_CHECK(
+    (uniform.mSourceDimensions[1] == std::array<float, 2> {64, 32}));
+
+  // Half a texel in from each edge, so linear filtering doesn't bleed in
+  // neighbouring pixels from an atlas
+  OPENKNEEBOARD_CHECK(
+    (uniform.mSourceClamp[0]
+     == std::array<float, 4> {
+       10.5f / 100,
+       20.5f / 50,
+       39.5f / 100,
+       29.5f / 50,
+     }));
+  OPENKNEEBOARD_CHECK(
+    (uniform.mSourceClamp[1]
+     == std::array<float, 4> {0.5f / 64, 0.5f / 32, 63.5f / 64, 31.5f / 32}));
+}
+
+void TestPreviousBatch() {
+  Batch batch;
+  const auto draw = [&](const Batch::Color& color) {
+    batch.Draw(1, SourceSize, Rect(0, 0, 10, 10), Rect(5, 5, 10, 10), color);
+  };
+
+  draw(White);
+  OPENKNEEBOARD_CHECK(!batch.IsSameAsPreviousBatch());
+  batch.EndBatch();
+  OPENKNEEBOARD_CHECK(batch.IsEmpty());
+
+  draw(White);
+  OPENKNEEBOARD_CHECK(batch.IsSameAsPreviousBatch());
+  batch.EndBatch();
+
+  draw(Red);
+  OPENKNEEBOARD_CHECK(!batch.IsSameAsPreviousBatch());
+  batch.EndBatch();
+
+  draw(Red);
+  batch.InvalidatePreviousBatch();
+  OPENKNEEBOARD_CHECK(!batch.IsSameAsPreviousBatch());
+}
+
+}// namespace
+
+int main() {
+  TestCornersMatchReference();
+  TestSourceSharing();
+  TestSourceRuns();
+  TestUniformBuffer();
+  TestPreviousBatch();
+  TestRandomMatchesReference();
+  for (const auto spriteCount: {8, 64, 512}) {
+    Benchmark(spriteCount);
+  }
+  return Tests::Finish();
+}
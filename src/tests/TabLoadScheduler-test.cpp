@@ -0,0 +1,166 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "check.hpp"
+
+#include <OpenKneeboard/TabLoadScheduler.hpp>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace OpenKneeboard;
+using namespace std::chrono_literals;
+
+using Scheduler = TabLoadScheduler;
+using Index = Scheduler::Index;
+
+namespace {
+
+struct SyntheticTab {
+  std::chrono::milliseconds mDuration {};
+  bool mFails {false};
+};
+
+struct SimulationResult {
+  Scheduler mScheduler;
+  std::chrono::milliseconds mDuration {};
+  std::vector<Index> mFinishOrder {};
+};
+
+// Discrete-event simulation of loading tabs that take a fixed time each
+SimulationResult Simulate(
+  const std::vector<SyntheticTab>& tabs,
+  const std::size_t maxConcurrency) {
+  std::vector<Scheduler::Entry> entries;
+  for (std::size_t i = 0; i < tabs.size(); ++i) {
+    entries.push_back({.mTitle = std::to_string(i), .mType = "Synthetic"});
+  }
+  const Scheduler::TimePoint start {};
+  SimulationResult ret {Scheduler {entries, maxConcurrency, start}};
+  auto& scheduler = ret.mScheduler;
+
+  std::multimap<Scheduler::TimePoint, Index> loading;
+  auto now = start;
+  std::size_t maxLoading = 0;
+  const auto startTabs = [&] {
+    while (const auto i = scheduler.StartNext(now)) {
+      loading.emplace(now + tabs.at(*i).mDuration, *i);
+    }
+    maxLoading = std::max(maxLoading, loading.size());
+  };
+
+  startTabs();
+  while (!loading.empty()) {
+    const auto [finishedAt, i] = *loading.begin();
+    loading.erase(loading.begin());
+    now = finishedAt;
+    if (tabs.at(i).mFails) {
+      scheduler.MarkFailed(i, now, "synthetic failure");
+    } else {
+      scheduler.MarkLoaded(i, now);
+    }
+    ret.mFinishOrder.push_back(i);
+    OPENKNEEBOARD_CHECK(std::ranges::is_sorted(scheduler.GetLoaded()));
+    startTabs();
+  }
+
+  OPENKNEEBOARD_CHECK(maxLoading <= std::max<std::size_t>(maxConcurrency, 1));
+  OPENKNEEBOARD_CHECK(scheduler.IsComplete());
+  if (const auto completedAt = scheduler.GetCompletedAt();
+      OPENKNEEBOARD_CHECK(completedAt.has_value())) {
+    ret.mDuration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      *completedAt - start);
+  }
+  return ret;
+}
+
+std::vector<SyntheticTab> MakeTabs(
+  std::initializer_list<int> durations,
+  std::initializer_list<Index> failures = {}) {
+  std::vector<SyntheticTab> ret;
+  for (auto&& duration: durations) {
+    ret.push_back({std::chrono::milliseconds {duration}});
+  }
+  for (auto&& i: failures) {
+    ret.at(i).mFails = true;
+  }
+  return ret;
+}
+
+void TestConcurrency() {
+  const auto tabs = MakeTabs({400, 100, 100, 300, 50, 50});
+
+  const auto serial = Simulate(tabs, 1);
+  OPENKNEEBOARD_CHECK(serial.mDuration == 1000ms);
+  OPENKNEEBOARD_CHECK(std::ranges::is_sorted(serial.mFinishOrder));
+
+  const auto parallel = Simulate(tabs, 3);
+  OPENKNEEBOARD_CHECK(parallel.mDuration == 400ms);
+  OPENKNEEBOARD_CHECK(parallel.mFinishOrder.front() == 1);
+  // Configuration order, not completion order
+  OPENKNEEBOARD_CHECK(
+    (parallel.mScheduler.GetLoaded() == std::vector<Index> {0, 1, 2, 3, 4, 5}));
+
+  // Zero is treated as one
+  OPENKNEEBOARD_CHECK(Simulate(tabs, 0).mDuration == 1000ms);
+}
+
+void TestFailures() {
+  const auto result
+    = Simulate(MakeTabs({400, 100, 100, 300, 50, 50}, {1, 4}), 2);
+  const auto& scheduler = result.mScheduler;
+  OPENKNEEBOARD_CHECK(
+    (scheduler.GetLoaded() == std::vector<Index> {0, 2, 3, 5}));
+  const auto entries = scheduler.GetEntries();
+  OPENKNEEBOARD_CHECK(entries[1].mState == Scheduler::State::Failed);
+  OPENKNEEBOARD_CHECK(entries[1].mError == "synthetic failure");
+  OPENKNEEBOARD_CHECK(entries[0].mState == Scheduler::State::Loaded);
+  OPENKNEEBOARD_CHECK(entries[0].mError.empty());
+  OPENKNEEBOARD_CHECK(entries[0].mFinishedAt - entries[0].mStartedAt == 400ms);
+}
+
+void TestEmpty() {
+  Scheduler scheduler({}, 4, {});
+  OPENKNEEBOARD_CHECK(scheduler.IsComplete());
+  OPENKNEEBOARD_CHECK(!scheduler.StartNext({}));
+  OPENKNEEBOARD_CHECK(scheduler.GetCompletedAt() == Scheduler::TimePoint {});
+}
+
+void TestRandom() {
+  std::mt19937 rng(1);
+  for (int i = 0; i < 2000; ++i) {
+    std::vector<SyntheticTab> tabs(rng() % 20);
+    std::vector<Index> expected;
+    for (std::size_t j = 0; j < tabs.size(); ++j) {
+      tabs[j] = {
+        std::chrono::milliseconds {static_cast<int64_t>(rng() % 500)},
+        (rng() % 5) == 0,
+      };
+      if (!tabs[j].mFails) {
+        expected.push_back(j);
+      }
+    }
+
+    auto result = Simulate(tabs, 1 + (rng() % 6));
+    if (!tabs.empty()) {
+      // Finishing a tab twice is ignored
+      result.mScheduler.MarkLoaded(0, {});
+    }
+    if (!OPENKNEEBOARD_CHECK(result.mScheduler.GetLoaded() == expected)) {
+      return;
+    }
+  }
+}
+
+}// namespace
+
+int main() {
+  TestConcurrency();
+  TestFailures();
+  TestEmpty();
+  TestRandom();
+  return Tests::Finish();
+}
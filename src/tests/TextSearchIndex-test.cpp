@@ -0,0 +1,186 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "check.hpp"
+
+#include <OpenKneeboard/TextSearchIndex.hpp>
+
+#include <algorithm>
+#include <random>
+#include <ranges>
+#include <string>
+#include <vector>
+
+using namespace OpenKneeboard;
+
+using Location = TextSearchIndex::Location;
+using LastTerm = TextSearchIndex::LastTerm;
+
+namespace {
+
+// Tokenization and folding are the caller's job; the tests use lowercase
+// ASCII words
+std::vector<std::string_view> Tokenize(std::string_view text) {
+  std::vector<std::string_view> ret;
+  for (auto&& range: std::views::split(text, ' ')) {
+    const std::string_view token {range.begin(), range.end()};
+    if (!token.empty()) {
+      ret.push_back(token);
+    }
+  }
+  return ret;
+}
+
+struct Line {
+  Location mLocation;
+  std::string mText;
+};
+
+std::vector<Location> ReferenceFind(
+  const std::vector<Line>& lines,
+  std::span<const std::string_view> terms,
+  const LastTerm lastTerm) {
+  const auto matches
+    = [&](const std::string_view token, const std::size_t termIndex) {
+        const auto term = terms[termIndex];
+        if (lastTerm == LastTerm::Prefix && termIndex + 1 == terms.size()) {
+          return token.starts_with(term);
+        }
+        return token == term;
+      };
+
+  std::vector<Location> ret;
+  for (auto&& line: lines) {
+    const auto tokens = Tokenize(line.mText);
+    for (std::size_t start = 0; start + terms.size() <= tokens.size();
+         ++start) {
+      std::size_t i = 0;
+      while (i < terms.size() && matches(tokens[start + i], i)) {
+        ++i;
+      }
+      if (i == terms.size()) {
+        ret.push_back(line.mLocation);
+        break;
+      }
+    }
+  }
+  return ret;
+}
+
+void TestBasics() {
+  TextSearchIndex index;
+  index.AddLine(0, 0, Tokenize("enfield 1 1 bingo fuel"));
+  index.AddLine(0, 1, Tokenize("copy bingo"));
+  index.AddLine(0, 2, {});
+  index.AddLine(1, 0, Tokenize("fuel bingo fuel bingo fuel"));
+
+  const auto find = [&](std::string_view query, const LastTerm lastTerm) {
+    return index.Find(Tokenize(query), lastTerm);
+  };
+  OPENKNEEBOARD_CHECK(
+    (find("bingo", LastTerm::Exact)
+     == std::vector<Location> {{0, 0}, {0, 1}, {1, 0}}));
+  // Phrases, and each line only once
+  OPENKNEEBOARD_CHECK(
+    (find("bingo fuel", LastTerm::Exact)
+     == std::vector<Location> {{0, 0}, {1, 0}}));
+  OPENKNEEBOARD_CHECK(find("fuel copy", LastTerm::Exact).empty());
+  OPENKNEEBOARD_CHECK(find("bin", LastTerm::Exact).empty());
+  OPENKNEEBOARD_CHECK(
+    (find("1 bin", LastTerm::Prefix) == std::vector<Location> {{0, 0}}));
+  OPENKNEEBOARD_CHECK(find("zzz", LastTerm::Prefix).empty());
+  OPENKNEEBOARD_CHECK(
+    (index.Find(Tokenize("fuel"), LastTerm::Exact, 1)
+     == std::vector<Location> {{0, 0}}));
+
+  // Replace page 0 line 1 onwards
+  index.Truncate({0, 1});
+  index.AddLine(0, 1, Tokenize("bingo"));
+  OPENKNEEBOARD_CHECK(
+    (find("bingo", LastTerm::Exact) == std::vector<Location> {{0, 0}, {0, 1}}));
+  OPENKNEEBOARD_CHECK(find("copy", LastTerm::Prefix).empty());
+
+  index.Clear();
+  OPENKNEEBOARD_CHECK(find("bingo", LastTerm::Prefix).empty());
+}
+
+// Random text, compared with a brute-force search
+void TestRandom() {
+  constexpr std::string_view words[] {
+    "copy",
+    "tally",
+    "bandit",
+    "bingo",
+    "fuel",
+    "fox",
+    "three",
+    "two",
+    "tower",
+    "cleared",
+    "clean",
+    "1",
+    "12",
+  };
+  constexpr std::string_view queries[] {
+    "copy",
+    "bingo fuel",
+    "fox three",
+    "c",
+    "cle",
+    "fuel bingo fuel",
+    "1",
+    "two t",
+    "tally bandit bingo",
+  };
+
+  std::mt19937 rng(42);
+  std::vector<Line> lines;
+  TextSearchIndex index;
+  const auto addPage = [&](const std::size_t page) {
+    for (std::size_t i = 0, lineCount = rng() % 40; i < lineCount; ++i) {
+      std::string text;
+      for (std::size_t j = 0, count = rng() % 8; j < count; ++j) {
+        text += words[rng() % std::size(words)];
+        text += ' ';
+      }
+      const auto& line = lines.emplace_back(Location {page, i}, text);
+      index.AddLine(page, i, Tokenize(line.mText));
+    }
+  };
+
+  for (std::size_t page = 0; page < 200; ++page) {
+    addPage(page);
+    // Sometimes re-layout the last few pages
+    if (page > 2 && rng() % 10 == 0) {
+      const auto first = page - (rng() % 3);
+      index.Truncate({first, 0});
+      std::erase_if(
+        lines, [first](const Line& it) { return it.mLocation.mPage >= first; });
+      for (auto i = first; i <= page; ++i) {
+        addPage(i);
+      }
+    }
+  }
+
+  for (auto&& query: queries) {
+    for (auto&& lastTerm: {LastTerm::Exact, LastTerm::Prefix}) {
+      const auto terms = Tokenize(query);
+      const auto expected = ReferenceFind(lines, terms, lastTerm);
+      OPENKNEEBOARD_CHECK(index.Find(terms, lastTerm) == expected);
+
+      const auto capped = index.Find(terms, lastTerm, 5);
+      OPENKNEEBOARD_CHECK(
+        capped.size() == std::min<std::size_t>(5, expected.size()));
+      OPENKNEEBOARD_CHECK(std::ranges::equal(
+        capped, expected | std::views::take(capped.size())));
+    }
+  }
+}
+
+}// namespace
+
+int main() {
+  TestBasics();
+  TestRandom();
+  return Tests::Finish();
+}
@@ -0,0 +1,119 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "check.hpp"
+
+#include <OpenKneeboard/TexturePoolPolicy.hpp>
+
+#include <algorithm>
+#include <random>
+
+using namespace OpenKneeboard;
+
+using Policy = TexturePoolPolicy;
+
+namespace {
+
+void TestSizeClasses() {
+  OPENKNEEBOARD_CHECK(
+    (Policy::GetSizeClass(1, 129) == Policy::SizeClass {128, 256}));
+  OPENKNEEBOARD_CHECK(
+    (Policy::GetSizeClass(256, 0) == Policy::SizeClass {256, 128}));
+  OPENKNEEBOARD_CHECK(
+    (Policy::GetSizeClass(128, 128) == Policy::SizeClass {128, 128}));
+}
+
+void TestEviction() {
+  Policy p(300);
+  const auto a = p.Allocate({128, 128}, 100);
+  OPENKNEEBOARD_CHECK(!a.mIsReused && a.mEvicted.empty());
+  const auto b = p.Allocate({128, 256}, 100);
+  const auto c = p.Allocate({128, 128}, 100);
+  // LRU order: b, c, a
+  OPENKNEEBOARD_CHECK(p.Touch(a.mID));
+
+  // Over budget: evict b
+  const auto d = p.Allocate({256, 256}, 100);
+  OPENKNEEBOARD_CHECK(d.mEvicted.size() == 1 && d.mEvicted.front() == b.mID);
+  OPENKNEEBOARD_CHECK(!p.Touch(b.mID));
+
+  // c is free, so it's reused for a texture of the same size class
+  p.Release(c.mID);
+  const auto e = p.Allocate({128, 128}, 100);
+  OPENKNEEBOARD_CHECK(e.mIsReused && e.mID == c.mID && e.mEvicted.empty());
+
+  // Free entries are evicted before entries in use
+  p.Release(a.mID);
+  p.Release(d.mID);
+  const auto f = p.Allocate({512, 512}, 100);
+  OPENKNEEBOARD_CHECK(!f.mIsReused);
+  OPENKNEEBOARD_CHECK(f.mEvicted.size() == 1 && f.mEvicted.front() == d.mID);
+
+  auto stats = p.GetStats();
+  OPENKNEEBOARD_CHECK(stats.mEntryCount == 3);
+  OPENKNEEBOARD_CHECK(stats.mUsedBytes == 300 && stats.mFreeBytes == 100);
+
+  // a is free, then c is the least-recently-used in use
+  const auto evicted = p.SetBudget(100);
+  OPENKNEEBOARD_CHECK(
+    evicted.size() == 2 && evicted[0] == a.mID && evicted[1] == c.mID);
+
+  // A single entry can exceed the budget
+  const auto g = p.Allocate({1024, 1024}, 1000);
+  OPENKNEEBOARD_CHECK(g.mEvicted.size() == 1 && g.mEvicted.front() == f.mID);
+  stats = p.GetStats();
+  OPENKNEEBOARD_CHECK(stats.mEntryCount == 1 && stats.mUsedBytes == 1000);
+
+  p.Remove(g.mID);
+  stats = p.GetStats();
+  OPENKNEEBOARD_CHECK(stats.mEntryCount == 0);
+  OPENKNEEBOARD_CHECK(stats.mUsedBytes == 0 && stats.mFreeBytes == 0);
+}
+
+// Random operations, checking the accounting against a list of live entries
+void TestRandom() {
+  constexpr std::size_t Budget = 5000;
+  constexpr std::size_t MaxEntryBytes = 500;
+
+  Policy p(Budget);
+  std::vector<Policy::EntryID> live;
+  std::mt19937 rng(1);
+  for (int i = 0; i < 100000; ++i) {
+    const auto op = rng() % 4;
+    if (op == 0 || live.empty()) {
+      const auto allocation = p.Allocate(
+        {128 * (1 + static_cast<uint32_t>(rng() % 3)), 128},
+        100 * (1 + (rng() % 5)));
+      for (auto&& id: allocation.mEvicted) {
+        std::erase(live, id);
+      }
+      if (!allocation.mIsReused) {
+        live.push_back(allocation.mID);
+      }
+    } else if (op == 1) {
+      p.Touch(live.at(rng() % live.size()));
+    } else if (op == 2) {
+      p.Release(live.at(rng() % live.size()));
+    } else {
+      const auto id = live.at(rng() % live.size());
+      p.Remove(id);
+      std::erase(live, id);
+    }
+
+    const auto stats = p.GetStats();
+    if (!(OPENKNEEBOARD_CHECK(stats.mEntryCount == live.size())
+          && OPENKNEEBOARD_CHECK(stats.mUsedBytes <= Budget + MaxEntryBytes)
+          && OPENKNEEBOARD_CHECK(stats.mFreeBytes <= stats.mUsedBytes))) {
+      return;
+    }
+  }
+}
+
+}// namespace
+
+int main() {
+  TestSizeClasses();
+  TestEviction();
+  TestRandom();
+  return Tests::Finish();
+}
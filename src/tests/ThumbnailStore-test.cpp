@@ -0,0 +1,192 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "check.hpp"
+
+#include <OpenKneeboard/ThumbnailStore.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+using namespace OpenKneeboard;
+
+namespace {
+
+using Key = ThumbnailStore::Key;
+using Bytes = ThumbnailStore::Bytes;
+
+Key MakeKey(std::string page, const uint64_t contentHash = 1) {
+  return {std::move(page), contentHash, 64, 48};
+}
+
+Bytes MakeBytes(const std::size_t size, const uint8_t value = 0) {
+  return Bytes(size, static_cast<std::byte>(value));
+}
+
+bool HasBytes(ThumbnailStore& store, const Key& key, const Bytes& expected) {
+  const auto bytes = store.Find(key);
+  return bytes && *bytes == expected;
+}
+
+void TestFind() {
+  ThumbnailStore store {1024};
+  OPENKNEEBOARD_CHECK(!store.Find(MakeKey("a")));
+
+  store.Insert(MakeKey("a"), MakeBytes(10, 1));
+  OPENKNEEBOARD_CHECK(HasBytes(store, MakeKey("a"), MakeBytes(10, 1)));
+
+  // Sizes are separate thumbnails
+  auto larger = MakeKey("a");
+  larger.mWidth *= 2;
+  OPENKNEEBOARD_CHECK(!store.Find(larger));
+  store.Insert(larger, MakeBytes(20, 2));
+  OPENKNEEBOARD_CHECK(HasBytes(store, MakeKey("a"), MakeBytes(10, 1)));
+  OPENKNEEBOARD_CHECK(HasBytes(store, larger, MakeBytes(20, 2)));
+
+  // Replacing a thumbnail doesn't leak its bytes
+  store.Insert(MakeKey("a"), MakeBytes(5, 3));
+  auto stats = store.GetStats();
+  OPENKNEEBOARD_CHECK(stats.mEntryCount == 2);
+  OPENKNEEBOARD_CHECK(stats.mBytes == 25);
+
+  // Changed content: stale, and discarded
+  OPENKNEEBOARD_CHECK(!store.Find(MakeKey("a", 2)));
+  OPENKNEEBOARD_CHECK(!store.Find(MakeKey("a", 1)));
+  stats = store.GetStats();
+  OPENKNEEBOARD_CHECK(stats.mStale == 1);
+  OPENKNEEBOARD_CHECK(stats.mEntryCount == 1);
+  OPENKNEEBOARD_CHECK(stats.mBytes == 20);
+  OPENKNEEBOARD_CHECK(stats.mHits == 3);
+}
+
+void TestEviction() {
+  ThumbnailStore store {100};
+  store.Insert(MakeKey("a"), MakeBytes(40));
+  store.Insert(MakeKey("b"), MakeBytes(40));
+  // Now most-recently used
+  OPENKNEEBOARD_CHECK(store.Find(MakeKey("a")));
+  store.Insert(MakeKey("c"), MakeBytes(40));
+
+  OPENKNEEBOARD_CHECK(!store.Find(MakeKey("b")));
+  OPENKNEEBOARD_CHECK(store.Find(MakeKey("a")));
+  OPENKNEEBOARD_CHECK(store.Find(MakeKey("c")));
+  auto stats = store.GetStats();
+  OPENKNEEBOARD_CHECK(stats.mEvictions == 1);
+  OPENKNEEBOARD_CHECK(stats.mBytes == 80);
+
+  // A single thumbnail over budget is kept, rather than storing nothing
+  store.Insert(MakeKey("huge"), MakeBytes(500));
+  OPENKNEEBOARD_CHECK(store.Find(MakeKey("huge")));
+  stats = store.GetStats();
+  OPENKNEEBOARD_CHECK(stats.mEntryCount == 1);
+}
+
+void TestGeneration() {
+  ThumbnailStore store {1024};
+  const auto initial = store.GetGeneration();
+  OPENKNEEBOARD_CHECK(!store.Find(MakeKey("a")));
+  OPENKNEEBOARD_CHECK(store.GetGeneration() == initial);
+
+  store.Insert(MakeKey("a"), MakeBytes(10));
+  const auto inserted = store.GetGeneration();
+  OPENKNEEBOARD_CHECK(inserted != initial);
+  // Hits reorder entries, but that doesn't need to be saved
+  OPENKNEEBOARD_CHECK(store.Find(MakeKey("a")));
+  OPENKNEEBOARD_CHECK(store.GetGeneration() == inserted);
+  // Removing stale entries does
+  OPENKNEEBOARD_CHECK(!store.Find(MakeKey("a", 2)));
+  OPENKNEEBOARD_CHECK(store.GetGeneration() != inserted);
+}
+
+void TestRoundTrip() {
+  ThumbnailStore store {100};
+  store.Insert(MakeKey("a"), MakeBytes(30, 1));
+  store.Insert(MakeKey("b"), MakeBytes(30, 2));
+  store.Insert(MakeKey(""), {});
+  OPENKNEEBOARD_CHECK(store.Find(MakeKey("a")));
+
+  ThumbnailStore loaded {100};
+  if (!OPENKNEEBOARD_CHECK(loaded.Deserialize(store.Serialize()))) {
+    return;
+  }
+  OPENKNEEBOARD_CHECK(loaded.GetGeneration() == 0);
+  OPENKNEEBOARD_CHECK(loaded.GetStats().mEntryCount == 3);
+  OPENKNEEBOARD_CHECK(loaded.GetStats().mBytes == 60);
+  OPENKNEEBOARD_CHECK(HasBytes(loaded, MakeKey(""), {}));
+
+  // Least-recently-used order is preserved: 'b' is evicted first
+  loaded.Insert(MakeKey("c"), MakeBytes(50, 3));
+  OPENKNEEBOARD_CHECK(!loaded.Find(MakeKey("b")));
+  OPENKNEEBOARD_CHECK(HasBytes(loaded, MakeKey("a"), MakeBytes(30, 1)));
+
+  // A smaller budget keeps the most-recently-used
+  ThumbnailStore smaller {40};
+  OPENKNEEBOARD_CHECK(smaller.Deserialize(store.Serialize()));
+  OPENKNEEBOARD_CHECK(HasBytes(smaller, MakeKey("a"), MakeBytes(30, 1)));
+  OPENKNEEBOARD_CHECK(!smaller.Find(MakeKey("b")));
+
+  // As `ThumbnailCache` does once loading finishes
+  ThumbnailStore moved {100};
+  moved.Insert(MakeKey("discarded"), MakeBytes(10));
+  moved = std::move(loaded);
+  OPENKNEEBOARD_CHECK(!moved.Find(MakeKey("discarded")));
+  OPENKNEEBOARD_CHECK(moved.Find(MakeKey("a")));
+  moved.Insert(MakeKey("d"), MakeBytes(30));
+  OPENKNEEBOARD_CHECK(moved.GetStats().mBytes <= 100);
+}
+
+void TestInvalid() {
+  ThumbnailStore store {1024};
+  store.Insert(MakeKey("a"), MakeBytes(10));
+  store.Insert(MakeKey("b"), MakeBytes(10));
+  const auto data = store.Serialize();
+
+  const auto rejects = [](const std::string& input) {
+    ThumbnailStore loaded {1024};
+    loaded.Insert(MakeKey("existing"), MakeBytes(1));
+    // Rejected data leaves the store empty
+    return !loaded.Deserialize(input) && loaded.GetStats().mEntryCount == 0
+      && !loaded.Find(MakeKey("existing"));
+  };
+
+  OPENKNEEBOARD_CHECK(rejects({}));
+  OPENKNEEBOARD_CHECK(rejects("garbage"));
+  for (std::size_t i = 1; i < data.size(); ++i) {
+    if (!OPENKNEEBOARD_CHECK(rejects(data.substr(0, i)))) {
+      break;
+    }
+  }
+  OPENKNEEBOARD_CHECK(rejects(data + "x"));
+
+  auto badMagic = data;
+  badMagic[0] = 'X';
+  OPENKNEEBOARD_CHECK(rejects(badMagic));
+  auto badVersion = data;
+  badVersion[4] = 2;
+  OPENKNEEBOARD_CHECK(rejects(badVersion));
+  // The first page name's length
+  auto badLength = data;
+  badLength[15] = '\x7f';
+  OPENKNEEBOARD_CHECK(rejects(badLength));
+}
+
+void TestHashContent() {
+  // Stable between runs and platforms
+  OPENKNEEBOARD_CHECK(ThumbnailStore::HashContent({}) == 0xcbf29ce484222325);
+  OPENKNEEBOARD_CHECK(
+    ThumbnailStore::HashContent("a") != ThumbnailStore::HashContent("b"));
+}
+
+}// namespace
+
+int main() {
+  TestFind();
+  TestEviction();
+  TestGeneration();
+  TestRoundTrip();
+  TestInvalid();
+  TestHashContent();
+  return Tests::Finish();
+}
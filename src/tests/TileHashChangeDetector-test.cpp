@@ -0,0 +1,142 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "check.hpp"
+
+#include <OpenKneeboard/TileHashChangeDetector.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace OpenKneeboard;
+
+namespace {
+
+constexpr auto TileSize = TileHashChangeDetector::TileSize;
+
+// Not a multiple of the tile size, so the last row and column are partial
+const PixelSize Size {(TileSize * 4) + 10, (TileSize * 3) + 1};
+
+std::vector<uint64_t> Hashes(const PixelSize& size) {
+  const auto grid = TileHashChangeDetector::GetTileGrid(size);
+  std::vector<uint64_t> ret(grid.mWidth * grid.mHeight);
+  for (std::size_t i = 0; i < ret.size(); ++i) {
+    ret[i] = i * 1000;
+  }
+  return ret;
+}
+
+void TestGrid() {
+  using Detector = TileHashChangeDetector;
+  OPENKNEEBOARD_CHECK(Detector::GetTileGrid({0, 0}) == PixelSize(0, 0));
+  OPENKNEEBOARD_CHECK(Detector::GetTileGrid({1, 1}) == PixelSize(1, 1));
+  OPENKNEEBOARD_CHECK(
+    Detector::GetTileGrid({TileSize, TileSize}) == PixelSize(1, 1));
+  OPENKNEEBOARD_CHECK(Detector::GetTileGrid(Size) == PixelSize(5, 4));
+}
+
+void TestUnchanged() {
+  TileHashChangeDetector detector;
+  auto hashes = Hashes(Size);
+  OPENKNEEBOARD_CHECK(detector.Update(hashes, Size).IsAll());
+  OPENKNEEBOARD_CHECK(detector.Update(hashes, Size).IsEmpty());
+  OPENKNEEBOARD_CHECK(detector.Update(hashes, Size).IsEmpty());
+}
+
+void TestChangedTiles() {
+  TileHashChangeDetector detector;
+  auto hashes = Hashes(Size);
+  (void)detector.Update(hashes, Size);
+
+  // Row 1, column 2
+  ++hashes.at(7);
+  auto dirty = detector.Update(hashes, Size);
+  if (OPENKNEEBOARD_CHECK(dirty.GetRects().size() == 1)) {
+    OPENKNEEBOARD_CHECK(
+      dirty.GetRects().front()
+      == PixelRect({TileSize * 2, TileSize}, {TileSize, TileSize}));
+  }
+  // Compared to the previous call, not the first
+  OPENKNEEBOARD_CHECK(detector.Update(hashes, Size).IsEmpty());
+
+  // The last tile is partial, and clipped to the image
+  ++hashes.back();
+  dirty = detector.Update(hashes, Size);
+  if (OPENKNEEBOARD_CHECK(dirty.GetRects().size() == 1)) {
+    OPENKNEEBOARD_CHECK(
+      dirty.GetRects().front()
+      == PixelRect({TileSize * 4, TileSize * 3}, {10, 1}));
+  }
+}
+
+void TestResize() {
+  TileHashChangeDetector detector;
+  (void)detector.Update(Hashes(Size), Size);
+
+  // Same number of tiles, but a different size
+  const PixelSize resized {Size.mWidth - 1, Size.mHeight};
+  OPENKNEEBOARD_CHECK(detector.Update(Hashes(resized), resized).IsAll());
+  OPENKNEEBOARD_CHECK(detector.Update(Hashes(resized), resized).IsEmpty());
+
+  // Wrong number of hashes
+  const auto hashes = Hashes(resized);
+  OPENKNEEBOARD_CHECK(
+    detector.Update(std::span {hashes}.first(hashes.size() - 1), resized)
+      .IsAll());
+  OPENKNEEBOARD_CHECK(detector.Update(hashes, resized).IsAll());
+
+  detector.Reset();
+  OPENKNEEBOARD_CHECK(detector.Update(hashes, resized).IsAll());
+  OPENKNEEBOARD_CHECK(detector.Update(hashes, resized).IsEmpty());
+}
+
+// Changed tiles must always be covered, and unchanged areas shouldn't be
+// reported unless several changes are close enough to merge
+void TestRandom() {
+  std::mt19937 rng(1);
+  const PixelSize size {1920, 1080};
+  const auto grid = TileHashChangeDetector::GetTileGrid(size);
+  TileHashChangeDetector detector;
+  auto hashes = Hashes(size);
+  (void)detector.Update(hashes, size);
+
+  for (int i = 0; i < 1000; ++i) {
+    std::vector<std::size_t> changed(1 + (rng() % 3));
+    for (auto&& index: changed) {
+      index = rng() % hashes.size();
+      hashes.at(index) = rng();
+    }
+    const auto dirty = detector.Update(hashes, size);
+    for (auto&& index: changed) {
+      const auto column = static_cast<uint32_t>(index % grid.mWidth);
+      const auto row = static_cast<uint32_t>(index / grid.mWidth);
+      const PixelRect tile = PixelRect {
+        {column * TileSize, row * TileSize},
+        {TileSize, TileSize},
+      }.Clamped(size);
+      const auto covered = std::ranges::any_of(
+        dirty.GetRects(), [&](const PixelRect& rect) {
+          return rect.Left() <= tile.Left() && rect.Top() <= tile.Top()
+            && rect.Right() >= tile.Right() && rect.Bottom() >= tile.Bottom();
+        });
+      if (!OPENKNEEBOARD_CHECK(covered)) {
+        return;
+      }
+    }
+    if (changed.size() == 1) {
+      OPENKNEEBOARD_CHECK(dirty.GetArea() <= TileSize * TileSize);
+    }
+  }
+}
+
+}// namespace
+
+int main() {
+  TestGrid();
+  TestUnchanged();
+  TestChangedTiles();
+  TestResize();
+  TestRandom();
+  return Tests::Finish();
+}
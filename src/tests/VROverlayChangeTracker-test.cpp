@@ -0,0 +1,235 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+#include "check.hpp"
+
+#include <OpenKneeboard/VROverlayChangeTracker.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <vector>
+
+using namespace OpenKneeboard;
+
+namespace {
+
+using Tracker = VROverlayChangeTracker;
+
+/// What a layer should show for a tick
+struct LayerState {
+  Tracker::LayerContent mContent {};
+  Tracker::LayerPlacement mPlacement {};
+};
+
+/// Stands in for an OpenVR overlay: only changes when updated
+struct FakeOverlay {
+  /// Unset if the overlay has been (re)created, but has no texture
+  std::optional<Tracker::FrameID> mFrame {};
+  Tracker::LayerContent mContent {};
+  Tracker::LayerPlacement mPlacement {};
+
+  std::size_t mTextureUpdates {};
+  std::size_t mPlacementUpdates {};
+};
+
+/// Drives the tracker and fake overlays like `SteamVRKneeboard::Tick()`
+struct Harness {
+  explicit Harness(const std::size_t layerCount)
+    : mTracker(layerCount),
+      mOverlays(layerCount),
+      mLayers(layerCount) {}
+
+  Tracker mTracker;
+  std::vector<FakeOverlay> mOverlays;
+  std::vector<LayerState> mLayers;
+  Tracker::FrameID mFrame {.mTexture = 0x1000, .mFenceValue = 1};
+  /// If set, the next texture update of this layer fails
+  std::optional<std::size_t> mFailNextTextureUpdate;
+
+  void Tick() {
+    for (std::size_t i = 0; i < mLayers.size(); ++i) {
+      const auto& layer = mLayers.at(i);
+      auto& overlay = mOverlays.at(i);
+      const auto update
+        = mTracker.Update(i, mFrame, layer.mContent, layer.mPlacement);
+      if (update.mTexture) {
+        if (mFailNextTextureUpdate == i) {
+          mFailNextTextureUpdate.reset();
+          mTracker.InvalidateLayer(i);
+          continue;
+        }
+        overlay.mFrame = mFrame;
+        overlay.mContent = layer.mContent;
+        ++overlay.mTextureUpdates;
+      }
+      if (update.mPlacement) {
+        overlay.mPlacement = layer.mPlacement;
+        ++overlay.mPlacementUpdates;
+      }
+    }
+  }
+
+  /// As when SteamVR restarts, or the overlay is recreated
+  void RecreateOverlay(const std::size_t i) {
+    mOverlays.at(i) = {};
+    mTracker.InvalidateLayer(i);
+  }
+
+  /// Whether every overlay shows what it should
+  bool IsCurrent() const {
+    for (std::size_t i = 0; i < mLayers.size(); ++i) {
+      const auto& overlay = mOverlays.at(i);
+      const auto& layer = mLayers.at(i);
+      if (
+        overlay.mFrame != mFrame || overlay.mContent != layer.mContent
+        || overlay.mPlacement != layer.mPlacement) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+void TestSteadyState() {
+  Harness harness(2);
+  harness.mLayers.at(1).mPlacement.mWidthInMeters = 0.25f;
+  harness.Tick();
+  OPENKNEEBOARD_CHECK(harness.IsCurrent());
+
+  for (int i = 0; i < 100; ++i) {
+    harness.Tick();
+  }
+  OPENKNEEBOARD_CHECK(harness.IsCurrent());
+  for (auto&& overlay: harness.mOverlays) {
+    OPENKNEEBOARD_CHECK(overlay.mTextureUpdates == 1);
+    OPENKNEEBOARD_CHECK(overlay.mPlacementUpdates == 1);
+  }
+
+  const auto stats = harness.mTracker.GetStats();
+  OPENKNEEBOARD_CHECK(stats.mTextureUpdates == 2);
+  OPENKNEEBOARD_CHECK(stats.mSkippedTextureUpdates == 200);
+  OPENKNEEBOARD_CHECK(stats.mPlacementUpdates == 2);
+  OPENKNEEBOARD_CHECK(stats.mSkippedPlacementUpdates == 200);
+}
+
+void TestChanges() {
+  Harness harness(2);
+  harness.Tick();
+  auto& first = harness.mOverlays.at(0);
+  auto& second = harness.mOverlays.at(1);
+
+  // Head movement only needs a new transform
+  harness.mLayers.at(0).mPlacement.mTransform.at(3) = 1.0f;
+  harness.Tick();
+  OPENKNEEBOARD_CHECK(harness.IsCurrent());
+  OPENKNEEBOARD_CHECK(first.mTextureUpdates == 1);
+  OPENKNEEBOARD_CHECK(first.mPlacementUpdates == 2);
+  OPENKNEEBOARD_CHECK(second.mPlacementUpdates == 1);
+
+  // A new frame needs a new copy for every layer
+  ++harness.mFrame.mFenceValue;
+  harness.Tick();
+  OPENKNEEBOARD_CHECK(harness.IsCurrent());
+  OPENKNEEBOARD_CHECK(first.mTextureUpdates == 2);
+  OPENKNEEBOARD_CHECK(second.mTextureUpdates == 2);
+  OPENKNEEBOARD_CHECK(first.mPlacementUpdates == 2);
+
+  // ... as does a different texture with the same fence value
+  harness.mFrame.mTexture = 0x2000;
+  harness.Tick();
+  OPENKNEEBOARD_CHECK(first.mTextureUpdates == 3);
+
+  // The tint and source rect are baked into the copy
+  harness.mLayers.at(1).mContent.mTint.at(3) = 0.5f;
+  harness.Tick();
+  OPENKNEEBOARD_CHECK(first.mTextureUpdates == 3);
+  OPENKNEEBOARD_CHECK(second.mTextureUpdates == 4);
+  harness.mLayers.at(1).mContent.mSourceRect.at(2) = 512;
+  harness.Tick();
+  OPENKNEEBOARD_CHECK(second.mTextureUpdates == 5);
+  OPENKNEEBOARD_CHECK(harness.IsCurrent());
+}
+
+void TestInvalidation() {
+  Harness harness(2);
+  harness.Tick();
+
+  harness.RecreateOverlay(1);
+  OPENKNEEBOARD_CHECK(!harness.IsCurrent());
+  harness.Tick();
+  OPENKNEEBOARD_CHECK(harness.IsCurrent());
+  OPENKNEEBOARD_CHECK(harness.mOverlays.at(0).mTextureUpdates == 1);
+  OPENKNEEBOARD_CHECK(harness.mOverlays.at(1).mTextureUpdates == 1);
+  OPENKNEEBOARD_CHECK(harness.mOverlays.at(1).mPlacementUpdates == 1);
+
+  // A failed update is retried on the next tick, even without changes
+  ++harness.mFrame.mFenceValue;
+  harness.mFailNextTextureUpdate = 0;
+  harness.Tick();
+  OPENKNEEBOARD_CHECK(!harness.IsCurrent());
+  harness.Tick();
+  OPENKNEEBOARD_CHECK(harness.IsCurrent());
+
+  harness.mTracker.Invalidate();
+  harness.Tick();
+  for (auto&& overlay: harness.mOverlays) {
+    OPENKNEEBOARD_CHECK(overlay.mTextureUpdates == 3);
+  }
+}
+
+/// Random changes; the overlays must always end up current
+void TestRandom() {
+  std::mt19937 rng(1234);
+  Harness harness(3);
+  std::size_t expectedTextureUpdates = 0;
+  std::size_t actualTextureUpdates = 0;
+  for (int tick = 0; tick < 10'000; ++tick) {
+    if ((rng() % 500) == 0) {
+      harness.RecreateOverlay(rng() % harness.mOverlays.size());
+    }
+    const auto before = harness.mOverlays;
+    if ((rng() % 4) == 0) {
+      ++harness.mFrame.mFenceValue;
+    }
+    for (auto&& layer: harness.mLayers) {
+      if ((rng() % 10) == 0) {
+        layer.mContent.mTint.at(rng() % 4) = static_cast<float>(rng() % 3);
+      }
+      if ((rng() % 3) == 0) {
+        layer.mPlacement.mTransform.at(rng() % 12)
+          = static_cast<float>(rng() % 5);
+      }
+    }
+
+    harness.Tick();
+    if (!OPENKNEEBOARD_CHECK(harness.IsCurrent())) {
+      return;
+    }
+    for (std::size_t i = 0; i < harness.mOverlays.size(); ++i) {
+      const auto& overlay = harness.mOverlays.at(i);
+      const auto& previous = before.at(i);
+      actualTextureUpdates
+        += overlay.mTextureUpdates - previous.mTextureUpdates;
+      // Random changes can revert a value, which doesn't need a copy
+      if (
+        previous.mFrame != overlay.mFrame
+        || previous.mContent != overlay.mContent) {
+        ++expectedTextureUpdates;
+      }
+    }
+  }
+  // No unnecessary copies
+  OPENKNEEBOARD_CHECK(actualTextureUpdates == expectedTextureUpdates);
+}
+
+}// namespace
+
+int main() {
+  TestSteadyState();
+  TestChanges();
+  TestInvalidation();
+  TestRandom();
+  return Tests::Finish();
+}
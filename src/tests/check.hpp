@@ -0,0 +1,51 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+#include <print>
+#include <source_location>
+#include <string_view>
+
+/** Minimal assertions for the tests in this directory.
+ *
+ * Unlike `assert()`, these are also checked in release builds, and a failure
+ * doesn't stop the test, so that one run reports every failure.
+ *
+ * Each test is its own executable; return `Finish()` from `main()`.
+ */
+namespace OpenKneeboard::Tests {
+
+inline std::atomic<int> gFailures {0};
+
+inline bool Check(
+  const bool ok,
+  const std::string_view expression,
+  const std::source_location& location = std::source_location::current()) {
+  if (!ok) {
+    gFailures.fetch_add(1, std::memory_order_relaxed);
+    std::println(
+      stderr,
+      "{}:{}: check failed: {}",
+      location.file_name(),
+      location.line(),
+      expression);
+  }
+  return ok;
+}
+
+[[nodiscard]]
+inline int Finish() {
+  const auto failures = gFailures.load();
+  if (failures) {
+    std::println(stderr, "{} checks failed", failures);
+    return 1;
+  }
+  return 0;
+}
+
+}// namespace OpenKneeboard::Tests
+
+#define OPENKNEEBOARD_CHECK(x) \
+  ::OpenKneeboard::Tests::Check(static_cast<bool>(x), #x)
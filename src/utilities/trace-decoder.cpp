@@ -0,0 +1,210 @@
+// Copyright 2026 Fred Emmott <fred@fredemmott.com>
+// SPDX-License-Identifier: MIT
+
+// Convert a BinaryTrace dump (`.oktrace`) to the Chrome trace event format
+// (for chrome://tracing, Perfetto, or Speedscope), and print per-scope
+// latency histograms.
+
+#include <OpenKneeboard/BinaryTrace.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace OpenKneeboard::BinaryTrace;
+
+namespace {
+
+std::string EscapeJSON(std::string_view in) {
+  std::string ret;
+  ret.reserve(in.size());
+  for (const auto c: in) {
+    switch (c) {
+      case '"':
+        ret += "\\\"";
+        break;
+      case '\\':
+        ret += "\\\\";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          constexpr char hex[] = "0123456789abcdef";
+          ret += "\\u00";
+          ret += hex[(c >> 4) & 0xf];
+          ret += hex[c & 0xf];
+        } else {
+          ret += c;
+        }
+    }
+  }
+  return ret;
+}
+
+std::string_view GetName(const Trace& trace, NameID id) {
+  if (id < trace.mNames.size()) {
+    return trace.mNames.at(id);
+  }
+  return "[unknown]";
+}
+
+uint64_t GetFirstTimestamp(const Trace& trace) {
+  auto ret = UINT64_MAX;
+  for (auto&& thread: trace.mThreads) {
+    if (!thread.mRecords.empty()) {
+      ret = std::min(ret, thread.mRecords.front().mTimestampNS);
+    }
+  }
+  return ret == UINT64_MAX ? 0 : ret;
+}
+
+void WriteChromeTrace(const Trace& trace, std::ostream& out) {
+  const auto origin = GetFirstTimestamp(trace);
+
+  out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool first = true;
+  for (auto&& thread: trace.mThreads) {
+    for (auto&& record: thread.mRecords) {
+      const char* phase = nullptr;
+      switch (record.mKind) {
+        case RecordKind::Begin:
+          phase = "B";
+          break;
+        case RecordKind::End:
+          phase = "E";
+          break;
+        case RecordKind::Instant:
+          phase = "i";
+          break;
+      }
+      if (!phase) {
+        continue;
+      }
+
+      if (!std::exchange(first, false)) {
+        out << ',';
+      }
+      const auto ns = record.mTimestampNS - origin;
+      out << "\n{\"name\":\"" << EscapeJSON(GetName(trace, record.mName))
+          << "\",\"ph\":\"" << phase << "\",\"ts\":" << (ns / 1000) << '.'
+          << std::setw(3) << std::setfill('0') << (ns % 1000)
+          << ",\"pid\":1,\"tid\":" << thread.mThreadID;
+      if (record.mKind == RecordKind::Instant) {
+        out << ",\"s\":\"t\"";
+      }
+      out << '}';
+    }
+  }
+  out << "\n]}\n";
+}
+
+/// Durations of completed scopes, by name
+std::map<std::string_view, std::vector<uint64_t>> GetDurations(
+  const Trace& trace) {
+  std::map<std::string_view, std::vector<uint64_t>> ret;
+  for (auto&& thread: trace.mThreads) {
+    std::vector<const Record*> stack;
+    for (auto&& record: thread.mRecords) {
+      if (record.mKind == RecordKind::Begin) {
+        stack.push_back(&record);
+        continue;
+      }
+      if (record.mKind != RecordKind::End) {
+        continue;
+      }
+      // The ring buffer may have dropped the Begin, or an inner End;
+      // match the innermost Begin with the same name, if any.
+      const auto it = std::ranges::find_if(
+        stack.rbegin(), stack.rend(), [name = record.mName](auto begin) {
+          return begin->mName == name;
+        });
+      if (it == stack.rend()) {
+        continue;
+      }
+      ret[GetName(trace, record.mName)].push_back(
+        record.mTimestampNS - (*it)->mTimestampNS);
+      stack.erase(std::prev(it.base()), stack.end());
+    }
+  }
+  return ret;
+}
+
+void PrintHistograms(const Trace& trace, std::ostream& out) {
+  const auto percentile = [](const std::vector<uint64_t>& sorted, double p) {
+    const auto index = static_cast<std::size_t>(p * (sorted.size() - 1));
+    return sorted.at(index) / 1000.0;
+  };
+
+  out << std::fixed << std::setprecision(1);
+  for (auto&& [name, durations]: GetDurations(trace)) {
+    std::ranges::sort(durations);
+    out << name << '\n'
+        << "  count " << durations.size() << "; µs: min "
+        << (durations.front() / 1000.0) << ", p50 "
+        << percentile(durations, 0.5) << ", p90 "
+        << percentile(durations, 0.9) << ", p99 "
+        << percentile(durations, 0.99) << ", max "
+        << (durations.back() / 1000.0) << '\n';
+
+    // Power-of-two microsecond buckets
+    std::map<int, std::size_t> buckets;
+    for (const auto ns: durations) {
+      ++buckets[std::bit_width(ns / 1000)];
+    }
+    for (auto&& [bucket, count]: buckets) {
+      const auto lower = bucket == 0 ? 0 : (1ull << (bucket - 1));
+      out << "  " << std::setw(10) << lower << "µs+ " << std::setw(8) << count
+          << ' ' << std::string((count * 40) / durations.size(), '#') << '\n';
+    }
+  }
+}
+
+}// namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 3) {
+    std::cerr << "Usage: " << argv[0] << " TRACE.oktrace [OUTPUT.json]\n";
+    return 1;
+  }
+
+  const std::filesystem::path input {argv[1]};
+  std::ifstream in(input, std::ios::binary);
+  if (!in) {
+    std::cerr << "Failed to open " << input.string() << '\n';
+    return 1;
+  }
+  const auto trace = Read(in);
+  if (!trace) {
+    std::cerr << input.string() << " is not a valid trace\n";
+    return 1;
+  }
+  if (trace->mTruncated) {
+    std::cerr << input.string()
+              << " is truncated; decoding the complete records\n";
+  }
+
+  const auto output = (argc == 3)
+    ? std::filesystem::path {argv[2]}
+    : std::filesystem::path {input}.replace_extension(".json");
+  {
+    std::ofstream out(output, std::ios::binary | std::ios::trunc);
+    WriteChromeTrace(*trace, out);
+    if (!out) {
+      std::cerr << "Failed to write " << output.string() << '\n';
+      return 1;
+    }
+  }
+  std::cerr << "Wrote " << output.string() << '\n';
+
+  PrintHistograms(*trace, std::cout);
+  return 0;
+}
@@ -848,6 +848,7 @@ class TestViewerWindow final : private D3D11Resources {
   }
 
   void PaintContent() {
+    const auto startTime = SHM::ConsumerTelemetry::Clock::now();
     const auto clientSize = GetClientSize();
 
     auto frame = mRenderer->GetSHM().MaybeGet();
@@ -903,6 +904,7 @@ class TestViewerWindow final : private D3D11Resources {
 
     check_hresult(ctx->Signal(mFence.get(), ++mFenceValue));
 
+    const auto shmFrameNumber = frame->mFrameNumber;
     mFenceValue = mRenderer->Render(
       *std::move(frame),
       sourceRect,
@@ -916,6 +918,15 @@ class TestViewerWindow final : private D3D11Resources {
 
     ctx->CopySubresourceRegion(
       mWindowTexture.get(), 0, 0, 0, 0, mRendererTexture.get(), 0, &box);
+
+    ActiveConsumers::RecordFrame(
+      SHM::ConsumerKind::Viewer,
+      {
+        .mStartTime = startTime,
+        .mEndTime = SHM::ConsumerTelemetry::Clock::now(),
+        .mSHMFrameNumber = shmFrameNumber,
+        .mVisibleLayers = 1ui32 << mLayerIndex,
+      });
   }
 
   PixelRect GetDestRect(